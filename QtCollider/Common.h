@@ -49,6 +49,7 @@ namespace QtCollider {
     Event_ScMethodCall,
     Event_Refresh,
     Event_Proxy_SetProperty,
+    Event_Proxy_SetProperties,
     Event_Proxy_Destroy,
     Event_Proxy_BringFront,
     Event_Proxy_SetFocus,
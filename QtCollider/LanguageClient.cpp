@@ -99,11 +99,15 @@ void LangClient::tick()
   double secs;
   lock();
   bool haveNext = tickLocked( &secs );
+  mSchedNotifyPending = false;
   unlock();
 
   flush();
 
   if( haveNext ) {
+    // wake on the frame grid so all tasks due within the same frame run
+    // in a single language lock acquisition (see SC_TerminalClient::tick).
+    secs = std::ceil( secs / kSchedFramePeriod ) * kSchedFramePeriod;
     secs -= elapsedTime();
     secs *= 1000;
     int ti = qMax(0, qCeil(secs));
@@ -287,6 +287,14 @@ bool QObjectProxy::setPropertyEvent( SetPropertyEvent *e )
   return setProperty( e->property->name, e->value );
 }
 
+void QObjectProxy::applySetProperties( QtCollider::SetPropertiesEvent *e )
+{
+  for( const SetPropertiesEvent::Entry & entry : e->entries ) {
+    if( entry.proxy )
+      entry.proxy->setProperty( entry.property->name, entry.value );
+  }
+}
+
 QVariant QObjectProxy::property( const char *property )
 {
   return qObject ? qObject->property( property ) : QVariant();
@@ -25,6 +25,7 @@
 #include "Common.h"
 
 #include <QObject>
+#include <QPointer>
 #include <QString>
 #include <QVariant>
 #include <QVector>
@@ -44,6 +45,7 @@ class QcFunctionSignalHandler;
 
 namespace QtCollider {
   struct SetPropertyEvent;
+  struct SetPropertiesEvent;
   class DestroyEvent;
   struct ScMethodCallEvent;
 
@@ -107,6 +109,10 @@ class QObjectProxy : public QObject
     bool setProperty( const char *property, const QVariant & val );
     QVariant property( const char *property );
 
+    // Applies a batch of property updates posted to the application object
+    // in a single cross-thread hop. Runs on the Qt thread.
+    static void applySetProperties( QtCollider::SetPropertiesEvent * );
+
     bool connectObject( const char *signal, PyrObject *object, Qt::ConnectionType );
     bool connectMethod( const char *signal, PyrSymbol *method, Qt::ConnectionType );
     bool disconnectObject( const char *signal, PyrObject *object );
@@ -170,6 +176,20 @@ struct SetPropertyEvent : public QEvent
   QVariant value;
 };
 
+struct SetPropertiesEvent : public QEvent
+{
+  struct Entry {
+    // guarded: a proxy may be deleted between posting and delivery
+    QPointer<QObjectProxy> proxy;
+    PyrSymbol *property;
+    QVariant value;
+  };
+
+  SetPropertiesEvent() : QEvent( (QEvent::Type) QtCollider::Event_Proxy_SetProperties ) {}
+
+  QVector<Entry> entries;
+};
+
 class DestroyEvent : public QEvent
 {
 public:
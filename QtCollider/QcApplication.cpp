@@ -20,6 +20,7 @@
 ************************************************************************/
 
 #include "QcApplication.h"
+#include "QObjectProxy.h"
 #include "widgets/QcTreeWidget.h"
 
 #include <PyrLexer.h>
@@ -122,7 +123,7 @@ void QcApplication::interpret( const QString &str, bool print )
 
 bool QcApplication::event( QEvent *event )
 {
-    switch (event->type()) {
+    switch ((int) event->type()) {
     case QEvent::FileOpen: {
         // open the file dragged onto the application icon on Mac
         QFileOpenEvent *fe = static_cast<QFileOpenEvent*>(event);
@@ -130,6 +131,12 @@ bool QcApplication::event( QEvent *event )
         event->accept();
         return true;
     }
+    case QtCollider::Event_Proxy_SetProperties: {
+        // one queued hop carrying property updates for many proxies
+        QObjectProxy::applySetProperties( static_cast<QtCollider::SetPropertiesEvent*>(event) );
+        event->accept();
+        return true;
+    }
     default:
         break;
     }
@@ -3,6 +3,9 @@
 
 namespace QtCollider {
   void initPrimitives ();
+  // creates the application object only; cheap enough to run at startup
+  void initApplication();
+  // full GUI initialization; runs lazily when the first Qt primitive is called
   void init();
   int exec(int argc, char** argv);
 }
@@ -46,15 +46,15 @@ inline void initResources() { Q_INIT_RESOURCE(resources); }
 static QPalette gSystemPalette;
 QPalette QtCollider::systemPalette() { return gSystemPalette; }
 
-void QtCollider::init() {
+// the application object has to exist before the language client enters its
+// command loop (LangClient runs the Qt event loop and posts events to it),
+// so it is created at primitive registration time. everything only GUI code
+// needs - resources, widget factories, metatypes, WebKit settings - is
+// deferred to init(), which runs when the first Qt primitive is called.
+// headless sclang never pays for it.
+void QtCollider::initApplication() {
   if( !QApplication::instance() ) {
-    qcDebugMsg( 1, "Initializing QtCollider" );
-
-    initResources();
-
-    QtCollider::loadFactories();
-
-    QtCollider::MetaType::initAll();
+    qcDebugMsg( 1, "Initializing QtCollider application" );
 
     QLocale::setDefault( QLocale::c() );
 
@@ -78,15 +78,32 @@ void QtCollider::init() {
 
     gSystemPalette = qcApp->palette();
 
-    // Enable javascript localStorage for WebViews
-    QWebSettings::globalSettings()->setAttribute( QWebSettings::LocalStorageEnabled, true );
-
     // NOTE: Qt may tamper with the C language locale, affecting POSIX number-string conversions.
     // Revert the locale to default:
     setlocale( LC_NUMERIC, "C" );
   }
 }
 
+void QtCollider::init() {
+  initApplication();
+
+  static bool initialized = false;
+  if( !initialized ) {
+    initialized = true;
+
+    qcDebugMsg( 1, "Initializing QtCollider" );
+
+    initResources();
+
+    QtCollider::loadFactories();
+
+    QtCollider::MetaType::initAll();
+
+    // Enable javascript localStorage for WebViews
+    QWebSettings::globalSettings()->setAttribute( QWebSettings::LocalStorageEnabled, true );
+  }
+}
+
 int QtCollider::exec( int argc, char** argv ) {
   QtCollider::init();
   Q_ASSERT( qApp );
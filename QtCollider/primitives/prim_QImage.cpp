@@ -43,6 +43,7 @@
 #include <QtNetwork/QNetworkReply>
 
 #include <cassert>
+#include <cstring>
 
 namespace QC = QtCollider;
 
@@ -420,26 +421,104 @@ QC_LANG_PRIMITIVE( QImage_TransferPixels, 4, PyrSlot *r, PyrSlot *a, VMGlobals *
     int size = width * height;
     int x = rect.x();
     int y = rect.y();
-    int max_x = width + x;
     int max_y = height + y;
 
     if( array->size - start < size )
         return errIndexOutOfRange;
 
+    // copy whole scanline spans at once; the array holds rows contiguously
+    size_t spanBytes = width * sizeof(QRgb);
+
     if(store) {
         for( int iy = y; iy < max_y; ++iy ) {
             QRgb *line = reinterpret_cast<QRgb*>( image.scanLine(iy) );
-            for( int ix = x; ix < max_x; ++ix ) {
-                line[ix] = *pixelData;
-                ++pixelData;
+            memcpy( line + x, pixelData, spanBytes );
+            pixelData += width;
+        }
+    } else {
+        for( int iy = y; iy < max_y; ++iy ) {
+            const QRgb *line = reinterpret_cast<const QRgb*>( image.constScanLine(iy) );
+            memcpy( pixelData, line + x, spanBytes );
+            pixelData += width;
+        }
+    }
+
+    return errNone;
+}
+
+QC_LANG_PRIMITIVE( QImage_TransferFloatPixels, 4, PyrSlot *r, PyrSlot *a, VMGlobals *g )
+{
+    if( !QcApplication::compareThread() ) return QtCollider::wrongThreadError();
+
+    if( NotObj(a) || slotRawObject(a)->classptr != class_floatarray ) {
+        qcErrorMsg("QImage: array argument is not a FloatArray");
+        return errWrongType;
+    }
+
+    if( NotInt(a+2) ) return errWrongType;
+    int start = QC::read<int>(a+2);
+
+    if( !(IsTrue(a+3) || IsFalse(a+3)) ) return errWrongType;
+    bool store = IsTrue(a+3); // t/f g/s
+
+    QImage &image = to_image(r)->image();
+    QRect rect;
+
+    if( IsNil(a+1) ) {
+        rect = image.rect();
+    }
+    else {
+        if (!isKindOfSlot(a+1, SC_CLASS(Rect)))
+            return errWrongType;
+        rect = QC::read<QRect>(a+1);
+        if (rect.isEmpty())
+            return errNone;
+        if( !image.rect().contains(rect) ) {
+            qcErrorMsg("QImage: source rectangle out of image bounds");
+            return errFailed;
+        }
+    }
+
+    PyrFloatArray *array = reinterpret_cast<PyrFloatArray*>( slotRawObject(a) );
+    float *channelData = array->f + start;
+
+    int width = rect.width();
+    int height = rect.height();
+    int size = width * height * 4; // interleaved r,g,b,a per pixel
+    int x = rect.x();
+    int y = rect.y();
+    int max_y = height + y;
+
+    if( array->size - start < size )
+        return errIndexOutOfRange;
+
+    // Converts between normalized, non-premultiplied rgba components and the
+    // image's premultiplied pixels in whole scanline spans, so full-frame
+    // updates from the language avoid a primitive call per pixel.
+    if(store) {
+        for( int iy = y; iy < max_y; ++iy ) {
+            QRgb *line = reinterpret_cast<QRgb*>( image.scanLine(iy) ) + x;
+            for( int ix = 0; ix < width; ++ix, channelData += 4 ) {
+                float fa = qBound( 0.f, channelData[3], 1.f );
+                float k = fa * 255.f;
+                int pa = int( k + 0.5f );
+                int pr = int( qBound( 0.f, channelData[0], 1.f ) * k + 0.5f );
+                int pg = int( qBound( 0.f, channelData[1], 1.f ) * k + 0.5f );
+                int pb = int( qBound( 0.f, channelData[2], 1.f ) * k + 0.5f );
+                line[ix] = (pa << 24) | (pr << 16) | (pg << 8) | pb;
             }
         }
     } else {
         for( int iy = y; iy < max_y; ++iy ) {
-            QRgb *line = reinterpret_cast<QRgb*>( image.scanLine(iy) );
-            for( int ix = x; ix < max_x; ++ix ) {
-                *pixelData = line[ix];
-                ++pixelData;
+            const QRgb *line = reinterpret_cast<const QRgb*>( image.constScanLine(iy) ) + x;
+            for( int ix = 0; ix < width; ++ix, channelData += 4 ) {
+                QRgb pixel = line[ix];
+                int pa = qAlpha(pixel);
+                float k = pa > 0 ? 1.f / pa : 0.f;
+                channelData[0] = qRed(pixel) * k;
+                channelData[1] = qGreen(pixel) * k;
+                channelData[2] = qBlue(pixel) * k;
+                channelData[3] = pa / 255.f;
             }
         }
     }
@@ -447,6 +526,56 @@ QC_LANG_PRIMITIVE( QImage_TransferPixels, 4, PyrSlot *r, PyrSlot *a, VMGlobals *
     return errNone;
 }
 
+QC_LANG_PRIMITIVE( QImage_Composite, 5, PyrSlot *r, PyrSlot *a, VMGlobals *g )
+{
+    if( !QcApplication::compareThread() ) return QtCollider::wrongThreadError();
+
+    SharedImage sourceImage = QC::get(a);
+    if( !sourceImage ) return errWrongType;
+
+    Image *targetImage = to_image(r);
+    if( targetImage->isPainting() || sourceImage->isPainting() ) {
+        qcErrorMsg("QImage: can not composite while being painted.");
+        return errFailed;
+    }
+    if( sourceImage.data() == targetImage ) {
+        qcErrorMsg("QImage: can not composite an image onto itself.");
+        return errFailed;
+    }
+
+    QRectF source;
+    if( IsNil(a+2) )
+        source = QRectF( sourceImage->rect() );
+    else if( isKindOfSlot(a+2, SC_CLASS(Rect)) )
+        source = QC::read<QRectF>(a+2);
+    else
+        return errWrongType;
+
+    QRectF target;
+    if( IsNil(a+1) )
+        target = source;
+    else if( isKindOfSlot(a+1, SC_CLASS(Rect)) )
+        target = QC::read<QRectF>(a+1);
+    else
+        return errWrongType;
+
+    if( NotInt(a+3) ) return errWrongType;
+    int composition = QC::read<int>(a+3);
+    float opacity = QC::get(a+4);
+
+    // One blend pass over premultiplied pixels; scaling quality follows the
+    // source image's transformation mode.
+    QPainter painter( &targetImage->image() );
+    painter.setCompositionMode( (QPainter::CompositionMode) composition );
+    painter.setRenderHint( QPainter::SmoothPixmapTransform,
+                           sourceImage->transformationMode == Qt::SmoothTransformation );
+    painter.setOpacity( opacity );
+    painter.drawImage( target, sourceImage->image(), source );
+    painter.end();
+
+    return errNone;
+}
+
 QC_LANG_PRIMITIVE( QImage_Fill, 1, PyrSlot *r, PyrSlot *a, VMGlobals *g )
 {
     if( !QcApplication::compareThread() ) return QtCollider::wrongThreadError();
@@ -522,6 +651,8 @@ void defineQImagePrimitives()
   definer.define<QImage_SetPixel>();
   definer.define<QImage_SetColor>();
   definer.define<QImage_TransferPixels>();
+  definer.define<QImage_TransferFloatPixels>();
+  definer.define<QImage_Composite>();
   definer.define<QImage_Fill>();
   definer.define<QImage_Formats>();
   definer.define<QImage_PixelToColor>();
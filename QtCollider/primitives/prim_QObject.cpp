@@ -316,6 +316,52 @@ QC_LANG_PRIMITIVE( QObject_SetProperty, 3, PyrSlot *r, PyrSlot *a, VMGlobals *g
   return errNone;
 }
 
+QC_LANG_PRIMITIVE( QObject_SetProperties, 1, PyrSlot *r, PyrSlot *a, VMGlobals *g )
+{
+  // Argument: a flat array of [object, property, value] triples. All updates
+  // travel to the Qt thread in a single queued event and are applied in one
+  // GUI-thread pass, instead of one cross-thread hop per property.
+  if( !isKindOfSlot( a, class_array ) ) return errWrongType;
+
+  PyrObject *array = slotRawObject( a );
+  if( array->size % 3 ) return errWrongType;
+
+  qcDebugMsg( 1, QStringLiteral("SET BATCH: %1 properties").arg(array->size / 3) );
+
+  SetPropertiesEvent *e = new SetPropertiesEvent();
+  e->entries.reserve( array->size / 3 );
+
+  for( int i = 0; i < array->size; i += 3 ) {
+    PyrSlot *objSlot  = array->slots + i;
+    PyrSlot *propSlot = array->slots + i + 1;
+    PyrSlot *valSlot  = array->slots + i + 2;
+
+    if( !isKindOfSlot( objSlot, SC_CLASS(QObject) ) || NotSym( propSlot ) ) {
+      delete e;
+      return errWrongType;
+    }
+
+    // skip objects already destroyed
+    if( IS_OBJECT_NIL( objSlot ) ) continue;
+
+    QObjectProxy *proxy = QOBJECT_FROM_SLOT( objSlot );
+    if( !proxy->compareThread() ) {
+      delete e;
+      return QtCollider::wrongThreadError();
+    }
+
+    SetPropertiesEvent::Entry entry;
+    entry.proxy = proxy;
+    entry.property = slotRawSymbol( propSlot );
+    entry.value = QtCollider::get( valSlot );
+    e->entries.append( entry );
+  }
+
+  QApplication::postEvent( qApp, e );
+
+  return errNone;
+}
+
 QC_LANG_PRIMITIVE( QObject_GetProperty, 1, PyrSlot *r, PyrSlot *a, VMGlobals *g )
 {
   QObjectProxy *proxy = QOBJECT_FROM_SLOT( r );
@@ -618,6 +664,7 @@ void defineQObjectPrimitives()
   definer.define<QObject_GetProperties>();
   definer.define<QObject_GetMethods>();
   definer.define<QObject_SetProperty>();
+  definer.define<QObject_SetProperties>();
   definer.define<QObject_GetProperty>();
   definer.define<QObject_SetEventHandler>();
   definer.define<QObject_SetEventHandlerEnabled>();
@@ -43,7 +43,9 @@ void defineQImagePrimitives();
 #endif
 
 void initPrimitives () {
-  QtCollider::init();
+  // only make sure the application object exists here; the rest of the GUI
+  // initialization happens on first primitive use (LangPrimitive::mediate)
+  QtCollider::initApplication();
 
   qcDebugMsg(1,"initializing QtGUI primitives");
 
@@ -19,6 +19,8 @@
 *
 ************************************************************************/
 
+#include "../QtCollider.h"
+
 #include <PyrPrimitive.h>
 #include <VMGlobals.h>
 #include <PyrSlot.h>
@@ -60,6 +62,7 @@ private:
   template<> struct LangPrimitive <NAME> { \
       static int implementation ( RECEIVER, ARGS, GLOBAL ); \
       static int mediate( VMGlobals *g, int i ) { \
+          QtCollider::init(); \
           PyrSlot *stack = g->sp - i + 1; \
           return implementation( stack, i > 1 ? stack+1 : 0, g ); \
       } \
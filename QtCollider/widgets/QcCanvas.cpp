@@ -30,6 +30,8 @@ QcCanvas::QcCanvas( QWidget *parent )
 : QWidget( parent ),
   _paint( false ),
   _repaintNeeded( true ),
+  _retained( false ),
+  _pictureValid( false ),
   _clearOnRefresh( true ),
   _clearOnce( false ),
   _resize( false ),
@@ -84,6 +86,7 @@ void QcCanvas::setBackgroundImage( const QtCollider::SharedImage & image, const
 void QcCanvas::refresh()
 {
   _repaintNeeded = true;
+  _pictureValid = false;
   update();
 }
 
@@ -147,7 +150,20 @@ void QcCanvas::paintEvent( QPaintEvent *e )
     bool opaque_before = testAttribute(Qt::WA_OpaquePaintEvent);
 
     QPainter pixPainter( &_pixmap );
-    Q_EMIT( painting(&pixPainter) );
+    if( _retained ) {
+      // Re-enter the language only when the recording has been invalidated;
+      // animation frames in between replay the display list natively.
+      if( !_pictureValid ) {
+        QPainter recorder( &_picture );
+        Q_EMIT( painting(&recorder) );
+        recorder.end();
+        _pictureValid = true;
+      }
+      pixPainter.drawPicture( 0, 0, _picture );
+    }
+    else {
+      Q_EMIT( painting(&pixPainter) );
+    }
     _repaintNeeded = false;
 
     bool opaque_after = testAttribute(Qt::WA_OpaquePaintEvent);
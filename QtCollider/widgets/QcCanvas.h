@@ -26,6 +26,7 @@
 
 #include <QWidget>
 #include <QPixmap>
+#include <QPicture>
 #include <QBasicTimer>
 #include <QTime>
 #include <QPalette>
@@ -34,6 +35,7 @@ class QcCanvas : public QWidget
 {
   Q_PROPERTY( bool clearOnRefresh READ clearOnRefresh WRITE setClearOnRefresh );
   Q_PROPERTY( bool drawingEnabled READ drawingEnabled WRITE setDrawingEnabled );
+  Q_PROPERTY( bool retainedDrawing READ retainedDrawing WRITE setRetainedDrawing );
   Q_PROPERTY( float frameRate READ frameRate WRITE setFrameRate );
   Q_PROPERTY( int frameCount READ frameCount );
   Q_PROPERTY( QColor background READ background WRITE setBackground );
@@ -44,6 +46,11 @@ public:
   void setDrawingEnabled( bool b ) { _paint = b; }
   bool clearOnRefresh() const { return _clearOnRefresh; }
   void setClearOnRefresh( bool b ) { _clearOnRefresh = b; }
+  // In retained mode the drawing signal records into a display list, which
+  // later repaints replay without re-entering the language. refresh()
+  // invalidates the recording.
+  bool retainedDrawing() const { return _retained; }
+  void setRetainedDrawing( bool b ) { _retained = b; _pictureValid = false; }
   float frameRate() const;
   void setFrameRate( float rate );
   int frameCount() const { return _frameCount; }
@@ -70,8 +77,11 @@ protected:
 
 private:
   QPixmap _pixmap;
+  QPicture _picture;
   bool _paint;
   bool _repaintNeeded;
+  bool _retained;
+  bool _pictureValid;
   bool _clearOnRefresh;
   bool _clearOnce;
   bool _resize;
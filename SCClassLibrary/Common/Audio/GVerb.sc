@@ -1,10 +1,11 @@
 GVerb : MultiOutUGen {
 
 	*ar { arg in, roomsize = 10, revtime = 3, damping = 0.5, inputbw =  0.5, spread = 15,
-			drylevel = 1, earlyreflevel = 0.7, taillevel = 0.5, maxroomsize = 300, mul = 1,
-			add = 0;
+			drylevel = 1, earlyreflevel = 0.7, taillevel = 0.5, maxroomsize = 300,
+			downsample = 0, mul = 1, add = 0;
+		// downsample: 0 = full rate, 1 = half rate core, 2 = quarter rate core
 		^this.multiNew('audio', in, roomsize, revtime, damping, inputbw, spread, drylevel,
-			earlyreflevel, taillevel, maxroomsize).madd(mul, add);
+			earlyreflevel, taillevel, maxroomsize, downsample).madd(mul, add);
 	}
 
 	init {arg ... theInputs;
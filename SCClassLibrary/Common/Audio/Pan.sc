@@ -134,6 +134,28 @@ DecodeB2 : MultiOutUGen {
 	checkInputs { ^this.checkNInputs(3) }
 }
 
+// dense matrix mixer. the coefficients come from a buffer laid out one row
+// per output (numOutputs * inputArray.size entries); change them while the
+// synth runs and each coefficient ramps linearly over one block.
+MatrixMix : MultiOutUGen {
+	*ar { arg numOutputs, matrixBuf, inputArray;
+		^this.multiNew('audio', numOutputs, matrixBuf, *inputArray.asArray)
+	}
+	init { arg numOutputs ... theInputs;
+		inputs = theInputs;
+		channels = Array.fill(numOutputs, { arg i; OutputProxy(rate, this, i) });
+		^channels
+	}
+	checkInputs {
+		inputs.drop(1).do { arg input, i;
+			if (input.rate != \audio) {
+				^"input % is not audio rate: %".format(i + 1, input)
+			}
+		};
+		^this.checkValidInputs
+	}
+}
+
 PanAz : MultiOutUGen {
 	*ar { arg numChans, in, pos = 0.0, level = 1.0, width = 2.0, orientation = 0.5;
 		^this.multiNew('audio', numChans, in, pos, level, width, orientation )
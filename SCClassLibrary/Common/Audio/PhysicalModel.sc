@@ -9,6 +9,26 @@ Spring : UGen {
 
 }
 
+// a bank of independent Spring voices in one unit. all voices share the
+// input force and their output forces are summed; the server integrates
+// the whole bank with one vectorized update per sample, which scales much
+// better than one Spring unit per voice.
+SpringBank : UGen {
+	*ar { arg in = 0.0, springs = #[1], dampings = #[0];
+		^this.multiNewList(['audio', in] ++ this.prPairs(springs, dampings))
+	}
+
+	*kr { arg in = 0.0, springs = #[1], dampings = #[0];
+		^this.multiNewList(['control', in] ++ this.prPairs(springs, dampings))
+	}
+
+	*prPairs { arg springs, dampings;
+		springs = springs.asArray;
+		dampings = dampings.asArray.wrapExtend(springs.size);
+		^[springs, dampings].flop.flatten
+	}
+}
+
 //Friction : UGen {
 //	*ar { arg in=0.0, spring=1, thresh=0.5;
 //		^this.multiNew('audio', in, spring, thresh)
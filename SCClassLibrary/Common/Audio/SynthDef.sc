@@ -586,6 +586,9 @@ SynthDef {
 
 	doSend { |server, completionMsg|
 		var bytes = this.asBytes;
+		if (server.hasShmInterface and: { server.sendSynthDefViaShm(bytes, completionMsg) }) {
+			^this
+		};
 		if (bytes.size < (65535 div: 4)) {
 			server.sendMsg("/d_recv", bytes, completionMsg)
 		} {
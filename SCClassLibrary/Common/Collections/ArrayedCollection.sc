@@ -8,6 +8,19 @@ ArrayedCollection : SequenceableCollection {
 		// object.
 	}
 
+	*series { arg size, start=0, step=1;
+		// numeric series are filled in place by a primitive;
+		// non-numeric arguments take the generic path
+		if (start.isNumber and: { step.isNumber }) {
+			^this.newClear(size).prFillSeries(start, step)
+		};
+		^super.series(size, start, step)
+	}
+	prFillSeries { arg start, step;
+		_ArrayFillSeries
+		this.size.do { |i| this.put(i, start + (step * i)) };
+	}
+
 	// ArrayedCollections are vectors which have a
 	// fixed maximum capacity.
 
@@ -281,11 +294,24 @@ ArrayedCollection : SequenceableCollection {
 		^(this * this.sum.reciprocal)
 	}
 	normalize { arg min=0.0, max=1.0;
-		var minItem = this.minItem;
-		var maxItem = this.maxItem;
+		// one pass in C for all-numeric arrays; the primitive fails over to
+		// the generic element-wise mapping for anything else
+		var minItem, maxItem;
+		_ArrayNormalize
+		minItem = this.minItem;
+		maxItem = this.maxItem;
 		^this.collect { |el| el.linlin(minItem, maxItem, min, max) };
 	}
 
+	sum { | function |
+		if (function.isNil) { ^this.prSum };
+		^super.sum(function)
+	}
+	prSum {
+		_ArraySum
+		^super.sum
+	}
+
 	asciiPlot {
 		// draw the waveform down the page as asterisks
 		var lo = this.minItem;
@@ -473,6 +499,12 @@ Int8Array[int8] : RawArray {
 	readFromStream { |stream|
 		super.readFromStream(stream, \getInt8);
 	}
+
+	// decode big endian 32 bit floats (e.g. the blob of a /b_setb reply)
+	asFloatArray {
+		_Int8Array_AsFloatArray
+		^this.primitiveFailed
+	}
 }
 
 Int16Array[int16] : RawArray {
@@ -491,6 +523,12 @@ FloatArray[float] : RawArray {
 	readFromStream { |stream|
 		super.readFromStream(stream, \getFloat);
 	}
+
+	// this array as big endian 32 bit floats - the blob format of /b_setb
+	asOSCBlob {
+		_FloatArray_OSCBlob
+		^this.primitiveFailed
+	}
 }
 
 DoubleArray[double] : RawArray {
@@ -155,6 +155,10 @@ Collection {
 		^this.includes(item)
 	}
 
+	lazy {
+		// fused collect/select/reject chains: see LazySequence
+		^LazySequence.new(this)
+	}
 	collect { | function |
 		^this.collectAs(function, this.species);
 	}
@@ -0,0 +1,59 @@
+/*
+A LazySequence is a lightweight view over a collection that fuses chained
+collect / select / reject stages. Elements are pulled from the source once and
+flow through every stage in turn, so a chain of five transforms touches each
+element once and never materializes an intermediate collection. Any terminal
+operation built on do (inject, sum, as, asArray, maxItem ...) allocates at
+most the one result it returns.
+
+	result = data.lazy.collect(f).select(g).collect(h).asArray;
+*/
+
+LazySequence : Collection {
+	var <source, <stages;
+
+	*new { arg source, stages;
+		^super.newCopyArgs(source, stages ?? { [] })
+	}
+
+	collect { arg function;
+		^this.class.new(source, stages ++ [\collect, function])
+	}
+	select { arg function;
+		^this.class.new(source, stages ++ [\select, function])
+	}
+	reject { arg function;
+		^this.class.new(source, stages ++ [\reject, function])
+	}
+
+	do { arg function;
+		// one counter per stage plus one for the output: each stage function
+		// receives the index of the element within that stage's input, which
+		// matches what the eager chain would have passed it.
+		var counters = Array.fill((stages.size div: 2) + 1, 0);
+		source.do { arg item;
+			var value = item, keep = true, stageIndex = 0;
+			stages.pairsDo { arg type, func;
+				var i;
+				if (keep) {
+					i = counters[stageIndex];
+					counters[stageIndex] = i + 1;
+					switch (type,
+						\collect, { value = func.value(value, i) },
+						\select, { if (func.value(value, i).not) { keep = false } },
+						\reject, { if (func.value(value, i)) { keep = false } }
+					);
+				};
+				stageIndex = stageIndex + 1;
+			};
+			if (keep) {
+				function.value(value, counters[stageIndex]);
+				counters[stageIndex] = counters[stageIndex] + 1;
+			}
+		}
+	}
+
+	species { ^source.species }
+
+	storeArgs { ^[source, stages] }
+}
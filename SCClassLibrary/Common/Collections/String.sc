@@ -162,7 +162,13 @@ String[char] : RawArray {
 	scatArgs { arg ... items; ^this.scatList(items) }
 	ccatArgs { arg ... items; ^this.ccatList(items) }
 	catList { arg list;
-		// concatenate this with a list as a string
+		// concatenate this with a list as a string.
+		// done in one pass when every element is already a string;
+		// anything else falls through to the ++ loop, which coerces.
+		_String_CatList
+		^this.prCatListLoop(list)
+	}
+	prCatListLoop { arg list;
 		var string = this.copy;
 		list.do({ arg item, i;
 			string = string ++ item;
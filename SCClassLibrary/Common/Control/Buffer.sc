@@ -77,6 +77,24 @@ Buffer {
 		^["/b_allocReadChannel", bufnum, path, startFrame, (numFrames ? -1).asInt] ++ channels ++ [completionMessage.value(this)]
 	}
 
+	// like allocRead, but the server converts the file to its own sample
+	// rate while loading. quality: 0 linear, 1 medium, 2 best.
+	// startFrame/numFrames address frames of the file, before conversion.
+	allocReadResample { arg argpath, startFrame = 0, numFrames = -1, quality = 2, completionMessage;
+		path = argpath;
+		this.startFrame = startFrame;
+		server.listSendMsg(this.allocReadResampleMsg(argpath, startFrame, numFrames, quality,
+			completionMessage))
+	}
+
+	allocReadResampleMsg { arg argpath, startFrame = 0, numFrames = -1, quality = 2, completionMessage;
+		this.cache;
+		path = argpath;
+		this.startFrame = startFrame;
+		^["/b_allocReadResample", bufnum, path, startFrame, (numFrames ? -1).asInt, quality,
+			completionMessage.value(this)]
+	}
+
 	// read whole file into memory for PlayBuf etc.
 	// adds a query as a completion message
 	*read { arg server, path, startFrame = 0, numFrames = -1, action, bufnum;
@@ -87,6 +105,15 @@ Buffer {
 					.allocRead(path, startFrame, numFrames, {|buf|["/b_query", buf.bufnum] })
 	}
 
+	// read whole file into memory, converted to the server's sample rate
+	*readResample { arg server, path, startFrame = 0, numFrames = -1, quality = 2, action, bufnum;
+		server = server ? Server.default;
+		bufnum ?? { bufnum = server.nextBufferNumber(1) };
+		^super.newCopyArgs(server, bufnum)
+					.doOnInfo_(action).cache
+					.allocReadResample(path, startFrame, numFrames, quality, {|buf|["/b_query", buf.bufnum] })
+	}
+
 	read { arg argpath, fileStartFrame = 0, numFrames = -1, bufStartFrame = 0, leaveOpen = false, action;
 		this.cache;
 		doOnInfo = action;
@@ -433,6 +460,50 @@ Buffer {
 		^[\b_getn, bufnum, index, count]
 	}
 
+	// bulk variants of setn/getn: the samples travel as one float32 blob,
+	// which the server memcpys instead of decoding value by value
+	setnBlob { arg index = 0, values;
+		server.listSendMsg(this.setnBlobMsg(index, values))
+	}
+
+	setnBlobMsg { arg index = 0, values;
+		^[\b_setb, bufnum, index, values.as(FloatArray).asOSCBlob]
+	}
+
+	getnBlob { arg index, count, action;
+		OSCFunc({ |message|
+			// The server replies with [/b_setb, bufnum, starting index, blob].
+			action.value(message[3].asFloatArray);
+		}, \b_setb, server.addr, argTemplate: [bufnum, index]).oneShot;
+		server.listSendMsg(this.getnBlobMsg(index, count));
+	}
+
+	getnBlobMsg { arg index, count;
+		^[\b_getb, bufnum, index, count]
+	}
+
+	// server-side decimation for waveform display: /b_peaks builds (or
+	// partially refreshes) a min/max/rms pyramid over the buffer on the
+	// server, /b_getPeaks returns one zoom level of it, so plotting never
+	// round-trips the sample data itself
+	updatePeaks { arg startFrame = 0, numFrames = -1;
+		server.listSendMsg(this.updatePeaksMsg(startFrame, numFrames))
+	}
+
+	updatePeaksMsg { arg startFrame = 0, numFrames = -1;
+		^[\b_peaks, bufnum, startFrame, numFrames.asInt]
+	}
+
+	getPeaks { arg startFrame = 0, numFrames = -1, numBins = 512, action;
+		OSCFunc({ |message|
+			// The server replies with [/b_peaksData, bufnum, firstFrame,
+			// framesPerBin, numBins, numChannels, blob]; the blob holds
+			// (min, max, rms) per bin and channel, bin-major.
+			action.value(message[6].asFloatArray, message[3], message[4], message[2]);
+		}, \b_peaksData, server.addr, argTemplate: [bufnum]).oneShot;
+		server.listSendMsg([\b_getPeaks, bufnum, startFrame, numFrames.asInt, numBins]);
+	}
+
 	fill { arg startAt, numFrames, value ... more;
 		server.listSendMsg(["/b_fill", bufnum, startAt, numFrames.asInt, value] ++ more)
 	}
@@ -529,6 +600,17 @@ Buffer {
 			++ amplitudes
 	}
 
+	// crossfade two cached tables into this buffer server-side:
+	// this = (1 - fraction) * bufA + fraction * bufB.
+	// works for plain and wavetable-format buffers alike.
+	morph { arg bufA, bufB, fraction = 0.0;
+		server.listSendMsg(this.morphMsg(bufA, bufB, fraction))
+	}
+
+	morphMsg { arg bufA, bufB, fraction = 0.0;
+		^["/b_gen", bufnum, "morph", bufA.bufnum, bufB.bufnum, fraction]
+	}
+
 	copyData { arg buf, dstStartAt = 0, srcStartAt = 0, numSamples = -1;
 		server.listSendMsg(
 			this.copyMsg(buf, dstStartAt, srcStartAt, numSamples)
@@ -60,6 +60,13 @@ HID {
 		this.addDevFunc( function );
 	}
 
+	*coalesce { |interval = 0.005, latestOnly = true|
+		// buffer element data on the device polling threads and deliver it in
+		// batches at most every interval seconds; latestOnly keeps only the
+		// newest value per element. an interval of 0 restores per-event delivery.
+		^this.prSetCoalesce( interval, latestOnly )
+	}
+
 	*findAvailable {
 		var devlist;
 		if ( running.not ) { this.initializeHID }; // start eventloop if not yet running
@@ -215,6 +222,11 @@ HID {
 		^this.primitiveFailed
 	}
 
+	*prSetCoalesce { |interval, latestOnly|
+		_HID_API_SetCoalesce
+		^this.primitiveFailed
+	}
+
 	*prbuildDeviceList {
 		_HID_API_BuildDeviceList
 		^this.primitiveFailed
@@ -1,11 +1,27 @@
 NetAddr {
 	var <addr=0, <>port, <hostname, <socket;
 	classvar connections;
+	classvar resolveActions;
 
 	*initClass {
 		connections = IdentityDictionary.new;
 	}
 
+	*resolve { | hostname, action |
+		// resolve hostname without blocking the interpreter; action is
+		// called with (addr, hostname) where addr is an Integer, or nil if
+		// resolution failed. results are cached for the session, but even
+		// cached results arrive asynchronously.
+		var key = hostname.asSymbol;
+		resolveActions = resolveActions ?? { IdentityDictionary.new };
+		if(resolveActions[key].isNil) {
+			resolveActions[key] = List[action];
+			this.prResolveAsync(hostname);
+		} {
+			resolveActions[key].add(action);
+		}
+	}
+
 	*new { arg hostname, port;
 		var addr;
 		addr = if (hostname.notNil,{ hostname.gethostbyname },{ 0 });
@@ -79,6 +95,13 @@ NetAddr {
 		^this.primitiveFailed;
 	}
 
+	// as sendBundle, but takes the messages as one Array so a large batch
+	// need not be expanded onto the stack
+	sendBundleArray { arg time, msgs;
+		_NetAddr_SendBundleArray
+		^this.primitiveFailed;
+	}
+
 	sendStatusMsg {
 		this.sendMsg("/status");
 	}
@@ -137,9 +160,11 @@ NetAddr {
 		^socket.notNil
 	}
 
-	connect { | disconnectHandler |
+	connect { | disconnectHandler, timeout = 10 |
+		// timeout bounds the TCP connect attempt in seconds; nil falls back
+		// to the OS default, which can block for minutes on a dead host.
 		if (this.isConnected.not) {
-			this.prConnect;
+			this.prConnect(timeout);
 			connections.put(this, disconnectHandler);
 		}
 	}
@@ -225,7 +250,18 @@ NetAddr {
 	}
 
 	// PRIVATE
-	prConnect {
+	*prResolveAsync { | hostname |
+		_NetAddr_ResolveAsync
+		^this.primitiveFailed;
+	}
+
+	*prHostResolved { | hostname, addr |
+		// called from C++ when an async resolution completes
+		var actions = resolveActions !? { resolveActions.removeAt(hostname.asSymbol) };
+		actions.do { | action | action.value(addr, hostname) };
+	}
+
+	prConnect { | timeout |
 		_NetAddr_Connect
 		^this.primitiveFailed;
 	}
@@ -96,6 +96,31 @@ SerialPort {
 		};
 		^byte
 	}
+	// deliver whole frames instead of single bytes. mode is one of
+	// \none (any received batch), \delimiter (frames end at the given
+	// byte, which is stripped), \length (fixed size frames of the given
+	// length). with framing enabled the receive thread only wakes the
+	// language when a complete frame is waiting.
+	framing { | mode = \none, value = 0 |
+		var modeIndex = ( none: 0, delimiter: 1, length: 2 ).at(mode);
+		if (modeIndex.isNil) {
+			Error("SerialPort: unknown framing mode '%'".format(mode)).throw;
+		};
+		this.prSetFraming(modeIndex, value);
+	}
+	// non-blocking: the next complete frame as an Int8Array, or nil
+	nextFrame {
+		_SerialPort_ReadFrame
+		^this.primitiveFailed
+	}
+	// blocking read of one frame
+	readFrame {
+		var frame;
+		while { (frame = this.nextFrame).isNil } {
+			semaphore.wait;
+		};
+		^frame
+	}
 	// rx errors since last query
 	rxErrors {
 		_SerialPort_RXErrors
@@ -143,6 +168,10 @@ SerialPort {
 		_SerialPort_Put
 		^this.primitiveFailed
 	}
+	prSetFraming { | mode, value |
+		_SerialPort_SetFraming
+		^this.primitiveFailed
+	}
 	prDataAvailable {
 		// callback
 		semaphore.signal;
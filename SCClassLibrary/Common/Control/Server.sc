@@ -256,6 +256,13 @@ ServerShmInterface {
 		_ServerShmInterface_setControlBusValues
 		^this.primitiveFailed
 	}
+
+	writeSynthDef {
+		// writes the def bytes into a shared memory transfer slot and
+		// returns the slot index for /d_recvSHM, or -1 if no slot is free
+		_ServerShmInterface_writeSynthDef
+		^this.primitiveFailed
+	}
 }
 
 
@@ -1059,6 +1066,17 @@ Server {
 	archiveAsCompileString { ^true }
 	archiveAsObject { ^true }
 
+	sendSynthDefViaShm {|bytes, completionMsg|
+		// hands the def over through shared memory and sends only the tiny
+		// /d_recvSHM trigger; answers whether the fast path was taken
+		var slot;
+		if(serverInterface.isNil) { ^false };
+		slot = serverInterface.writeSynthDef(bytes);
+		if(slot < 0) { ^false };
+		this.sendMsg("/d_recvSHM", slot, completionMsg);
+		^true
+	}
+
 	getControlBusValue {|busIndex|
 		if(serverInterface.isNil) {
 			Error("Server-getControlBusValue only supports local servers").throw;
@@ -45,6 +45,7 @@ SystemClock : Clock {
 
 AppClock : Clock {
 	classvar scheduler;
+	classvar <>frameRate = 60;
 	*initClass {
 		scheduler = Scheduler.new(this, drift:true, recursive:false);
 	}
@@ -55,6 +56,14 @@ AppClock : Clock {
 		scheduler.sched(delta, item);
 		this.prSchedNotify;
 	}
+	// frame-aligned scheduling for UI code: the deadline is rounded up to
+	// the next frame boundary, so dense animation tasks all land on the
+	// same tick and the clock driver enters the interpreter once per
+	// frame instead of once per task.
+	*schedFrame { arg delta = 0, item;
+		scheduler.schedAbs(roundUp(Main.elapsedTime + delta, frameRate.reciprocal), item);
+		this.prSchedNotify;
+	}
 	*tick {
 		var saveClock = thisThread.clock;
 		thisThread.clock = this;
@@ -407,6 +407,8 @@ FunctionDef {
 	numArgs { _FunDef_NumArgs }		// return number of arguments to the function
 	numVars { _FunDef_NumVars }		// return number of variables in the function
 	varArgs { _FunDef_VarArgs }		// return boolean whether function has ellipsis argument
+	callCount { _FunDef_CallCount }	// number of times executed; saturates at 65535
+	resetCallCount { _FunDef_ResetCallCount }
 
 	shallowCopy { ^this }
 
@@ -561,6 +563,14 @@ Interpreter {
 
 	var <>codeDump, <>preProcessor;
 
+	// compiled-function cache for repeated evaluations of the same code
+	// string (live coding setups re-trigger stored snippets constantly).
+	// a String key hashes by content, and recompiling the class library
+	// rebuilds the object space, which empties the cache exactly when the
+	// compiled functions would go stale.
+	classvar compileCacheMaxSize = 64;
+	var compileCache, compileCacheKeys;
+
 	*new { ^this.shouldNotImplement(thisMethod) }
 
 	interpretCmdLine {
@@ -595,6 +605,29 @@ Interpreter {
 		^this.compile(string).valueArray(args).postln;
 	}
 	compile { arg string;
+		// compiles string and returns a Function, reusing the compiled
+		// function when the same code string was compiled before.
+		var func, key;
+		compileCache ?? {
+			compileCache = Dictionary.new;
+			compileCacheKeys = Array.new;
+		};
+		func = compileCache.at(string);
+		func ?? {
+			func = this.prCompile(string);
+			if (func.notNil) {
+				if (compileCacheKeys.size >= compileCacheMaxSize) {
+					compileCache.removeAt(compileCacheKeys.removeAt(0));
+				};
+				key = string.copy; // callers reuse and mutate cmdLine
+				compileCache.put(key, func);
+				compileCacheKeys = compileCacheKeys.add(key);
+			};
+		};
+		^func
+	}
+
+	prCompile { arg string;
 		_CompileExpression
 		// compiles string and returns a Function.
 		// the string must be a valid expression.
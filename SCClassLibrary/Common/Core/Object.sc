@@ -33,6 +33,15 @@ Object  {
 	gcDumpSet { arg set; _GCDumpSet }
 	gcInfo { _GCInfo }
 	gcSanity { _GCSanity }
+	// sampling allocation profiler: records one in interval allocations
+	// per class. cheap enough to leave running during a performance.
+	gcProfileStart { arg interval = 64; _GCProfileStart ^this.primitiveFailed }
+	gcProfileStop { _GCProfileStop }
+	gcProfileClear { _GCProfileClear }
+	// posts collapsed flame-graph lines ("ClassName sampledBytes")
+	gcProfileDump { _GCProfileDump }
+	// answers [[class name, sample count, sampled bytes], ...] or nil
+	gcProfileReport { _GCProfileReport ^this.primitiveFailed }
 	canCallOS { _CanCallOS }
 
 
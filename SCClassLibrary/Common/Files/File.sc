@@ -1,10 +1,13 @@
 File : UnixFILE {
 
 	classvar <openDialogs, <systemIsCaseSensitive;
+	classvar readAllStringActions, writeAllStringActions;
 
 	*initClass {
 		var f = this.filenameSymbol.asString;
 		systemIsCaseSensitive = not(File.exists(f.toLower) and: {File.exists(f.toUpper)});
+		readAllStringActions = IdentityDictionary.new;
+		writeAllStringActions = IdentityDictionary.new;
 	}
 
 	*new { arg pathName, mode;
@@ -28,6 +31,34 @@ File : UnixFILE {
 		this.use(pathName, "r", { |file| string = file.readAllSignal });
 		^string
 	}
+	// reads the whole file on a background thread; action is called on
+	// AppClock with the contents, or nil if the file could not be read.
+	*readAllStringAsync { arg pathName, action;
+		var id = this.prReadAllStringAsync(pathName);
+		readAllStringActions.put(id, action);
+	}
+	// writes string to the file on a background thread; action is called
+	// on AppClock with true on success, false otherwise.
+	*writeAllStringAsync { arg pathName, string, action;
+		var id = this.prWriteAllStringAsync(pathName, string);
+		writeAllStringActions.put(id, action);
+	}
+	*doReadAllStringAction { arg id, string;
+		var action = readAllStringActions.removeAt(id);
+		if(action.notNil) { AppClock.sched(0, { action.value(string); nil }) };
+	}
+	*doWriteAllStringAction { arg id, success;
+		var action = writeAllStringActions.removeAt(id);
+		if(action.notNil) { AppClock.sched(0, { action.value(success); nil }) };
+	}
+	*prReadAllStringAsync { arg pathName;
+		_FileReadAllStringAsync
+		^this.primitiveFailed
+	}
+	*prWriteAllStringAsync { arg pathName, string;
+		_FileWriteAllStringAsync
+		^this.primitiveFailed
+	}
 	*readAllStringHTML { arg pathName;
 		var string;
 		this.use(pathName, "r", { |file| string = file.readAllStringHTML });
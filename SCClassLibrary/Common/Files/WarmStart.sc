@@ -0,0 +1,67 @@
+// a launch-time cache for expensive session state. startup files that
+// build large structures (tuning tables, corpus indexes) wrap the
+// construction in WarmStart.cache; the result is dumped to a binary
+// archive and restored on the next launch instead of being recomputed.
+// a cache entry goes stale when any of its dependency files (by default
+// the startup files themselves) is newer than the archive.
+//
+// only archivable state can be cached: windows, servers, open files and
+// routines are rebuilt by the wrapped function as usual.
+
+WarmStart {
+	classvar <>dir;
+
+	*initClass {
+		dir = Platform.userAppSupportDir +/+ "warmstart";
+	}
+
+	*path { arg key;
+		^dir +/+ key.asString ++ ".scar"
+	}
+
+	// restore the object cached under key, or build it with func and
+	// cache the result for the next launch
+	*cache { arg key, func, dependsOn;
+		var obj;
+		if (this.isFresh(key, dependsOn)) {
+			obj = try { Object.readBinaryArchive(this.path(key)) } { nil };
+			if (obj.notNil) { ^obj };
+		};
+		obj = func.value;
+		if (obj.notNil) { this.store(key, obj) };
+		^obj
+	}
+
+	*isFresh { arg key, dependsOn;
+		var path, mtime;
+		path = this.path(key);
+		if (File.exists(path).not) { ^false };
+		mtime = File.mtime(path);
+		dependsOn = dependsOn ?? { thisProcess.platform.startupFiles };
+		^dependsOn.asArray.every { |dep|
+			dep = dep.asString.standardizePath;
+			File.exists(dep).not or: { File.mtime(dep) <= mtime }
+		}
+	}
+
+	*store { arg key, obj;
+		if (File.exists(dir).not) { File.mkdir(dir) };
+		obj.writeBinaryArchive(this.path(key));
+	}
+
+	*load { arg key;
+		var path = this.path(key);
+		^if (File.exists(path)) {
+			try { Object.readBinaryArchive(path) } { nil }
+		}
+	}
+
+	*clear { arg key;
+		var path = this.path(key);
+		if (File.exists(path)) { File.delete(path) };
+	}
+
+	*clearAll {
+		(dir +/+ "*.scar").pathMatch.do { |path| File.delete(path) };
+	}
+}
@@ -246,6 +246,30 @@ Image {
 		this.prTransferPixels(array, region, start, true);
 	}
 
+	// interleaved r,g,b,a components, normalized (0..1), 4 per pixel
+	floatPixels {
+		var pixelArray;
+		if(this.width == 0 or: { this.height == 0 }, { ^nil });
+		pixelArray = FloatArray.newClear(this.width * this.height * 4);
+		this.loadFloatPixels(pixelArray);
+		^pixelArray;
+	}
+
+	loadFloatPixels { arg array, region = nil, start = 0;
+		this.prTransferFloatPixels(array, region, start, false);
+		^this;
+	}
+
+	setFloatPixels { arg array, region = nil, start = 0;
+		this.prTransferFloatPixels(array, region, start, true);
+	}
+
+	// blend another image into this one without a Pen drawing pass
+	composite { arg image, rect, fromRect, operation = 'sourceOver', opacity = 1.0;
+		operation = compositingOperations.indexOf(operation) ? 0;
+		this.prComposite(image, rect, fromRect, operation, opacity);
+	}
+
 	fill { arg color;
 		_QImage_Fill
 		^this.primitiveFailed
@@ -415,4 +439,14 @@ Image {
 		_QImage_TransferPixels
 		^this.primitiveFailed
 	}
+
+	prTransferFloatPixels { arg array, region, start, store = false;
+		_QImage_TransferFloatPixels
+		^this.primitiveFailed
+	}
+
+	prComposite { arg image, rect, fromRect, operation, opacity;
+		_QImage_Composite
+		^this.primitiveFailed
+	}
 }
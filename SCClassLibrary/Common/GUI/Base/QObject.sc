@@ -98,6 +98,13 @@ QObject {
 		^this.primitiveFailed
 	}
 
+	// triples: a flat array of [object, property, value] sequences,
+	// applied on the GUI thread in a single batch
+	*setProperties { arg triples;
+		_QObject_SetProperties
+		^this.primitiveFailed
+	}
+
 	setEventHandler{ arg event, method, direct=false, enabled=true;
 		_QObject_SetEventHandler
 		^this.primitiveFailed
@@ -23,6 +23,12 @@ UserView : View {
 	clearOnRefresh { ^this.getProperty( \clearOnRefresh ); }
 	clearOnRefresh_ { arg boolean; this.setProperty( \clearOnRefresh, boolean ); }
 
+	// When enabled, drawFunc records into a display list which later repaints
+	// and animation frames replay natively; drawFunc is re-invoked only after
+	// refresh (or a resize).
+	retainedDrawing { ^this.getProperty( \retainedDrawing ); }
+	retainedDrawing_ { arg boolean; this.setProperty( \retainedDrawing, boolean ); }
+
 	clearDrawing { this.invokeMethod( \clear ); }
 
 	drawFunc_ { arg aFunction;
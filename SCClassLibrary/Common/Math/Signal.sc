@@ -120,6 +120,22 @@ Signal[float] : FloatArray {
 		// if the other signal is too long only the first part is overwritten
 		^this.primitiveFailed
 	}
+	addInPlace { arg aSignal;
+		_SignalAddInPlace
+		// add a signal into myself without allocating a result signal.
+		// only use this when no one else holds a reference to the receiver.
+		^this.primitiveFailed
+	}
+	subInPlace { arg aSignal;
+		_SignalSubInPlace
+		// subtract a signal from myself without allocating a result signal
+		^this.primitiveFailed
+	}
+	mulInPlace { arg aSignal;
+		_SignalMulInPlace
+		// multiply a signal into myself without allocating a result signal
+		^this.primitiveFailed
+	}
 
 	play { arg loop=false, mul=0.2, numChannels=1, server;
 		var buf;
@@ -503,6 +503,12 @@ LID {
 	ungrab {
 		this.grab(false)
 	}
+	coalesce { | interval = 0.005, latestOnly = true |
+		// buffer events on the reader thread and deliver them in one batch
+		// at most every interval seconds; latestOnly keeps only the newest
+		// value per (type, code). an interval of 0 restores per-event delivery.
+		^this.prSetCoalesce( interval, latestOnly )
+	}
 
 	*debug_{ |onoff = true|
 		if ( onoff ){
@@ -653,6 +659,10 @@ LID {
 		_LID_SetMscState
 		^this.primitiveFailed
 	}
+	prSetCoalesce { |interval, latestOnly|
+		_LID_SetCoalesce
+		^this.primitiveFailed
+	}
 }
 
 LIDSlot {
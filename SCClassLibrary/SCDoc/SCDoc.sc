@@ -400,6 +400,14 @@ SCDoc {
 		^this.primitiveFailed
 	}
 
+	// ask the helper thread to parse a document ahead of time, so the next
+	// prParseFile call for the same path finds the tree already built.
+	// fire-and-forget: returns nil if a prefetch is already in flight.
+	*prPrefetchFile {|path, mode|
+		_SCDoc_PrefetchFile
+		^nil
+	}
+
 	*indexOldHelp {
 		var f = {|x,cat="Old Helpfiles",indent=0|
 			var a,b,doc;
@@ -435,7 +443,10 @@ SCDoc {
 		var nonHelpFiles;
 		var undocClasses = Class.allClasses.reject(_.isMetaClass).collectAs({|c|c.name},IdentitySet);
 		var additions = Dictionary();
-		this.checkVersion(clearCache);
+		var oldCache, newCache = Dictionary(), numParsed = 0;
+		if(this.checkVersion(clearCache).not) {
+			oldCache = this.prReadCache(this.cachePath);
+		};
 		this.postMsg("Indexing help-files...",0);
 		documents = Dictionary(); // or use IdDict and symbols as keys?
 		helpSourceDirs = nil; // force re-scan of HelpSource folders
@@ -448,9 +459,16 @@ SCDoc {
 					additions[key] = additions[key].add(f);
 				}
 				{f.extension=="schelp"} {
-					doc = this.parseFileMetaData(dir, f.fullPath.drop(dir.size+1));
+					doc = this.prCachedEntry(oldCache, f.fullPath);
+					if(doc.notNil) {
+						doc.isExtension = (dir != this.helpSourceDir);
+					} {
+						doc = this.parseFileMetaData(dir, f.fullPath.drop(dir.size+1));
+						numParsed = numParsed + 1;
+					};
 					doc !? {
 						documents[doc.path] = doc;
+						newCache[doc.fullPath] = doc;
 						if(doc.isClassDoc) {
 							undocClasses.remove(doc.title.asSymbol);
 						}
@@ -462,6 +480,11 @@ SCDoc {
 				};
 			}
 		};
+		// snapshot the entries before additions and undocumented-method scans
+		// mutate them; cached entries are restored to this same state on reuse
+		if(numParsed > 0 or: {oldCache.isNil} or: {oldCache.size != newCache.size}) {
+			this.prWriteCache(newCache, this.cachePath);
+		};
 		this.postMsg("Handling"+additions.size+"document additions...",1);
 		additions.pairsDo {|key, val|
 			doc = documents[key];
@@ -688,15 +711,68 @@ SCDoc {
 		^false;
 	}
 
+	*cachePath {
+		^this.helpTargetDir +/+ "scdoc_cache";
+	}
+
+	*prReadCache {|path|
+		var cache;
+		if(File.exists(path).not) { ^nil };
+		try {
+			cache = Object.readArchive(path);
+		} {
+			this.postMsg("could not read document cache, re-indexing",1);
+			^nil;
+		};
+		if(cache.isKindOf(Dictionary).not) { ^nil };
+		^cache;
+	}
+
+	*prWriteCache {|cache, path|
+		// class objects archive as compile strings referring to the current
+		// class library, so strip them and recompute on read instead
+		cache.do {|doc|
+			doc.klass = nil;
+			doc.implKlass = nil;
+			doc.implements = nil;
+		};
+		try {
+			File.mkdir(this.helpTargetDir);
+			cache.writeArchive(path);
+		} {
+			this.postMsg("could not write document cache",1);
+		};
+		cache.do {|doc|
+			if(doc.isClassDoc) { doc.klass = doc.title.asSymbol.asClass };
+		};
+	}
+
+	*prCachedEntry {|cache, fullPath|
+		var entry = cache !? { cache[fullPath] };
+		entry !? {
+			if(entry.mtime == File.mtime(fullPath)) {
+				if(entry.isClassDoc) { entry.klass = entry.title.asSymbol.asClass };
+				^entry;
+			}
+		};
+		^nil;
+	}
+
 	*renderAll {|includeExtensions=true|
+		var docs;
 		this.postMsg("Rendering all documents");
-		this.documents.do {|doc|
-			if(doc.oldHelp.isNil and: {includeExtensions or: {doc.isExtension.not}}) {
-				if(doc.isUndocumentedClass) {
-					this.renderUndocClass(doc);
-				} {
-					this.parseAndRender(doc);
-				}
+		docs = this.documents.asArray.select {|doc|
+			doc.oldHelp.isNil and: {includeExtensions or: {doc.isExtension.not}}
+		};
+		docs.do {|doc, i|
+			// parse the next document on the helper thread while this one renders
+			docs[i+1] !? {|next|
+				if(next.isUndocumentedClass.not) { this.prPrefetchFile(next.fullPath, 0) }
+			};
+			if(doc.isUndocumentedClass) {
+				this.renderUndocClass(doc);
+			} {
+				this.parseAndRender(doc);
 			}
 		};
 		this.postMsg("Done!");
@@ -29,12 +29,84 @@
 #include <stdarg.h>
 #include <cerrno>
 
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
 //extern "C" {
 #include "SCDoc.h"
 //}
 
 PyrSymbol *s_scdoc_node;
 
+// Parse-ahead worker. The schelp parser keeps global state (non-reentrant
+// flex scanner), so only one parse may run at a time, but it does not need
+// the language thread: while sclang renders one document, a helper thread
+// can already parse the next. _SCDoc_ParseFile picks up the prefetched tree
+// when the paths match and parses inline (with the worker idle) otherwise.
+
+namespace {
+
+enum PrefetchState { kPrefetchIdle, kPrefetchRequested, kPrefetchParsing, kPrefetchReady };
+
+std::mutex gPrefetchMutex;
+std::condition_variable gPrefetchAvailable;
+std::condition_variable gPrefetchDone;
+PrefetchState gPrefetchState = kPrefetchIdle;
+std::string gPrefetchPath;
+int gPrefetchMode = 0;
+DocNode *gPrefetchResult = NULL;
+bool gPrefetchWorkerRunning = false;
+
+void prefetch_worker_loop()
+{
+    std::unique_lock<std::mutex> lock(gPrefetchMutex);
+    for (;;) {
+        gPrefetchAvailable.wait(lock, []{ return gPrefetchState == kPrefetchRequested; });
+        std::string path = gPrefetchPath;
+        int mode = gPrefetchMode;
+        gPrefetchState = kPrefetchParsing;
+
+        lock.unlock();
+        DocNode *n = scdoc_parse_file(path.c_str(), mode);
+        lock.lock();
+
+        gPrefetchResult = n;
+        gPrefetchState = kPrefetchReady;
+        gPrefetchDone.notify_all();
+    }
+}
+
+// take the prefetched tree if it matches, or wait the worker into idleness
+// so the caller may use the parser itself. called with gPrefetchMutex held.
+DocNode *prefetch_claim(std::unique_lock<std::mutex> & lock, const char *path, int mode, bool & matched)
+{
+    matched = false;
+    if (gPrefetchState == kPrefetchIdle)
+        return NULL;
+
+    bool sameFile = (gPrefetchPath == path) && (gPrefetchMode == mode);
+    if (!sameFile && gPrefetchState == kPrefetchRequested) {
+        // not started yet: cancel, the parser is free
+        gPrefetchState = kPrefetchIdle;
+        return NULL;
+    }
+
+    gPrefetchDone.wait(lock, []{ return gPrefetchState == kPrefetchReady; });
+    if (gPrefetchPath == path && gPrefetchMode == mode) {
+        DocNode *n = gPrefetchResult;
+        gPrefetchResult = NULL;
+        gPrefetchState = kPrefetchIdle;
+        matched = true;
+        return n;
+    }
+    // a result for some other file: leave it for its own request
+    return NULL;
+}
+
+} // namespace
+
 static void _doc_traverse(struct VMGlobals* g, DocNode *n, PyrObject *parent, PyrSlot *slot)
 {
     PyrObject *result = instantiateObject( g->gc, s_scdoc_node->u.classobj, 0, false, true );
@@ -85,7 +157,14 @@ int prSCDoc_ParseFile(struct VMGlobals* g, int numArgsPushed)
     err = slotIntVal(c, &mode);
     if (err) return err;
 
-    DocNode *n = scdoc_parse_file(filename, mode);
+    DocNode *n;
+    {
+        std::unique_lock<std::mutex> lock(gPrefetchMutex);
+        bool matched;
+        n = prefetch_claim(lock, filename, mode, matched);
+        if(!matched)
+            n = scdoc_parse_file(filename, mode);
+    }
     if(n) {
 //        doc_node_dump(n);
         _doc_traverse(g, n, NULL, a);
@@ -96,15 +175,46 @@ int prSCDoc_ParseFile(struct VMGlobals* g, int numArgsPushed)
     return errNone;
 }
 
+int prSCDoc_PrefetchFile(struct VMGlobals* g, int numArgsPushed)
+{
+    PyrSlot *b, *c;
+    char filename[PATH_MAX];
+    int mode, err;
+
+    b = g->sp - 1;
+    c = g->sp;
+
+    err = slotStrVal(b, filename, PATH_MAX);
+    if (err) return err;
+
+    err = slotIntVal(c, &mode);
+    if (err) return err;
+
+    std::unique_lock<std::mutex> lock(gPrefetchMutex);
+    if(gPrefetchState != kPrefetchIdle) // single-slot queue; a prefetch is in flight
+        return errNone;
+
+    gPrefetchPath = filename;
+    gPrefetchMode = mode;
+    gPrefetchState = kPrefetchRequested;
+    if(!gPrefetchWorkerRunning) {
+        gPrefetchWorkerRunning = true;
+        std::thread(prefetch_worker_loop).detach();
+    }
+    gPrefetchAvailable.notify_one();
+    return errNone;
+}
+
 void initSCDocPrimitives()
 {
 	int base, index = 0;
-	
+
 	s_scdoc_node = getsym("SCDocNode");
 
 	base = nextPrimitiveIndex();
 
 	definePrimitive(base, index++, "_SCDoc_ParseFile", prSCDoc_ParseFile, 3, 0);
+	definePrimitive(base, index++, "_SCDoc_PrefetchFile", prSCDoc_PrefetchFile, 3, 0);
 
 }
 
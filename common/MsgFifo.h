@@ -32,6 +32,11 @@ namespace SCMsgFifo {
 using std::memory_order_relaxed;
 using std::memory_order_release;
 
+// head indices are padded out to their own cache lines so the producer's
+// write head and the consumer's read head don't false-share; otherwise every
+// store from one side invalidates the line the other side is spinning on.
+const int kFifoCacheLineSize = 64;
+
 template <class MsgType, int N>
 class MsgFifo
 {
@@ -68,6 +73,17 @@ public:
 			mReadHead.store(next, memory_order_release);
 		}
 	}
+	void PerformAll() // drain everything published at entry, one claim for the whole batch
+	{
+		unsigned int pos = mReadHead.load(memory_order_relaxed);
+		unsigned int end = mWriteHead.load(std::memory_order_acquire);
+		if (pos == end) return;
+		do {
+			pos = NextPos(pos);
+			mItems[pos].Perform();
+		} while (pos != end);
+		mReadHead.store(pos, memory_order_release);
+	}
 	void Free() // reclaim messages
 	{
 		while (NeedsFree()) {
@@ -80,7 +96,12 @@ public:
 private:
 	int NextPos(int inPos) { return (inPos + 1) & (N - 1); }
 
-	std::atomic<int> mReadHead, mWriteHead, mFreeHead;
+	std::atomic<int> mReadHead;
+	char mPadding0[kFifoCacheLineSize - sizeof(std::atomic<int>)];
+	std::atomic<int> mWriteHead;
+	char mPadding1[kFifoCacheLineSize - sizeof(std::atomic<int>)];
+	std::atomic<int> mFreeHead;
+	char mPadding2[kFifoCacheLineSize - sizeof(std::atomic<int>)];
 	MsgType mItems[N];
 };
 
@@ -117,11 +138,137 @@ public:
 			mReadHead.store(next, memory_order_release);
 		}
 	}
+	void PerformAll() // drain everything published at entry, one claim for the whole batch
+	{
+		unsigned int pos = mReadHead.load(memory_order_relaxed);
+		unsigned int end = mWriteHead.load(std::memory_order_acquire);
+		if (pos == end) return;
+		do {
+			pos = NextPos(pos);
+			mItems[pos].Perform();
+		} while (pos != end);
+		mReadHead.store(pos, memory_order_release);
+	}
 
 private:
 	int NextPos(int inPos) { return (inPos + 1) & (N - 1); }
 
-	std::atomic<int> mReadHead, mWriteHead;
+	std::atomic<int> mReadHead;
+	char mPadding0[kFifoCacheLineSize - sizeof(std::atomic<int>)];
+	std::atomic<int> mWriteHead;
+	char mPadding1[kFifoCacheLineSize - sizeof(std::atomic<int>)];
+	MsgType mItems[N];
+};
+
+/////////////////////////////////////////////////////////////////////
+
+/** Multiple-writer variant of MsgFifo.
+ *
+ *  Writers claim a slot by CAS on the write head and publish it via a
+ *  per-slot sequence number, so several socket listener threads can push
+ *  concurrently without a mutex. Perform() stays single-consumer and only
+ *  advances over fully published slots. Free() may be called from any
+ *  writer thread; reclamation is serialized with a try-lock so a busy
+ *  writer simply skips it and leaves the work for the next caller.
+ */
+template <class MsgType, int N>
+class MsgFifoMultiWriter
+{
+public:
+	MsgFifoMultiWriter()
+		: mReadHead(0), mWriteHead(0), mFreeHead(0), mFreeGuard(false)
+	{
+		for (int i = 0; i != N; ++i)
+			mSequence[i].store(i, memory_order_relaxed);
+	}
+
+	void MakeEmpty() {
+		unsigned int writeHead = mWriteHead.load();
+		mReadHead.store(writeHead, memory_order_relaxed);
+		mFreeHead.store(writeHead, memory_order_release);
+	}
+	bool IsEmpty() { return mReadHead.load(memory_order_relaxed) == mWriteHead.load(memory_order_relaxed); }
+	bool HasData() { return mReadHead.load(memory_order_relaxed) != mWriteHead.load(memory_order_relaxed); }
+	bool NeedsFree() { return mFreeHead.load(memory_order_relaxed) != mReadHead.load(memory_order_relaxed); }
+
+	bool Write(MsgType& data)
+	{
+		unsigned int pos = mWriteHead.load(memory_order_relaxed);
+		for (;;) {
+			unsigned int index = pos & (N - 1);
+			unsigned int seq = mSequence[index].load(std::memory_order_acquire);
+			int dif = (int)seq - (int)pos;
+			if (dif == 0) {
+				if (mWriteHead.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+					break;
+			} else if (dif < 0)
+				return false; // fifo is full
+			else
+				pos = mWriteHead.load(memory_order_relaxed);
+		}
+		unsigned int index = pos & (N - 1);
+		mItems[index] = data;
+		mSequence[index].store(pos + 1, memory_order_release);
+		return true;
+	}
+
+	void Perform() // get next and advance
+	{
+		for (;;) {
+			unsigned int pos = mReadHead.load(memory_order_relaxed);
+			if (pos == mWriteHead.load(std::memory_order_acquire))
+				return;
+			unsigned int index = pos & (N - 1);
+			// a writer has claimed this slot but not yet published it
+			if (mSequence[index].load(std::memory_order_acquire) != pos + 1)
+				return;
+			mItems[index].Perform();
+			mReadHead.store(pos + 1, memory_order_release);
+		}
+	}
+	void PerformAll() // drain all published slots, one claim for the whole batch
+	{
+		unsigned int pos = mReadHead.load(memory_order_relaxed);
+		unsigned int start = pos;
+		unsigned int end = mWriteHead.load(std::memory_order_acquire);
+		while (pos != end) {
+			unsigned int index = pos & (N - 1);
+			// a writer has claimed this slot but not yet published it
+			if (mSequence[index].load(std::memory_order_acquire) != pos + 1)
+				break;
+			mItems[index].Perform();
+			++pos;
+		}
+		if (pos != start)
+			mReadHead.store(pos, memory_order_release);
+	}
+	void Free() // reclaim messages
+	{
+		bool expected = false;
+		if (!mFreeGuard.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			return; // another writer is reclaiming; it will pick up our garbage
+		while (NeedsFree()) {
+			unsigned int pos = mFreeHead.load(memory_order_relaxed);
+			unsigned int index = pos & (N - 1);
+			mItems[index].Free();
+			// make the slot available to writers again, one lap ahead
+			mSequence[index].store(pos + N, memory_order_release);
+			mFreeHead.store(pos + 1, memory_order_release);
+		}
+		mFreeGuard.store(false, memory_order_release);
+	}
+
+private:
+	static_assert((N & (N - 1)) == 0, "MsgFifoMultiWriter size must be a power of two");
+
+	std::atomic<unsigned int> mReadHead;
+	char mPadding0[kFifoCacheLineSize - sizeof(std::atomic<unsigned int>)];
+	std::atomic<unsigned int> mWriteHead;
+	char mPadding1[kFifoCacheLineSize - sizeof(std::atomic<unsigned int>)];
+	std::atomic<unsigned int> mFreeHead;
+	char mPadding2[kFifoCacheLineSize - sizeof(std::atomic<unsigned int>)];
+	std::atomic<bool> mFreeGuard;
+	std::atomic<unsigned int> mSequence[N];
 	MsgType mItems[N];
 };
 
@@ -129,6 +276,7 @@ private:
 
 using SCMsgFifo::MsgFifo;
 using SCMsgFifo::MsgFifoNoFree;
+using SCMsgFifo::MsgFifoMultiWriter;
 
 /////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,129 @@
+//  CoreAudio os_workgroup helpers
+//
+//  Copyright (c) 2017 SuperCollider contributors.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; see the file COPYING.  If not, write to
+//  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+//  Boston, MA 02111-1307, USA.
+
+#ifndef SC_AUDIOWORKGROUP_HPP_INCLUDED
+#define SC_AUDIOWORKGROUP_HPP_INCLUDED
+
+// on macOS 11 and later the HAL exposes the os_workgroup of a device's IO
+// thread. realtime threads that participate in rendering a callback should
+// join that workgroup, otherwise the scheduler treats them as unrelated
+// background work and power-throttles them on asymmetric cores, which shows
+// up as dropouts at small buffer sizes. joining is only for threads that do
+// dsp for the device; non-realtime threads must stay out.
+//
+// everything here degrades gracefully: with an older SDK the feature macro
+// stays undefined, with an older OS at runtime the lookups return NULL and
+// the join helpers become no-ops.
+
+#ifdef __APPLE__
+
+#include <AvailabilityMacros.h>
+
+#if defined(MAC_OS_VERSION_11_0) && MAC_OS_X_VERSION_MAX_ALLOWED >= MAC_OS_VERSION_11_0
+#define SC_AUDIO_WORKGROUP_AVAILABLE 1
+#endif
+
+#ifdef SC_AUDIO_WORKGROUP_AVAILABLE
+
+#include <os/workgroup.h>
+#include <CoreAudio/AudioHardware.h>
+
+// returns the IO thread workgroup of a device at +1 retain count, or NULL
+// (pre macOS 11 at runtime, aggregate devices without a common workgroup,
+// errors). release with sc_release_audio_workgroup.
+static inline os_workgroup_t sc_device_audio_workgroup(AudioDeviceID inDevice)
+{
+	if (__builtin_available(macOS 11.0, *)) {
+		os_workgroup_t workgroup = NULL;
+		UInt32 size = sizeof(workgroup);
+		AudioObjectPropertyAddress addr = {
+			kAudioDevicePropertyIOThreadOSWorkgroup,
+			kAudioObjectPropertyScopeGlobal,
+			kAudioObjectPropertyElementMaster
+		};
+		OSStatus err = AudioObjectGetPropertyData(inDevice, &addr, 0, NULL, &size, &workgroup);
+		if (err != kAudioHardwareNoError)
+			return NULL;
+		return workgroup;
+	}
+	return NULL;
+}
+
+// workgroup of the default output device; for backends that sit behind an
+// abstraction (portaudio) which opens the default device but does not expose
+// its AudioDeviceID.
+static inline os_workgroup_t sc_default_output_audio_workgroup()
+{
+	AudioDeviceID device = kAudioObjectUnknown;
+	UInt32 size = sizeof(device);
+	AudioObjectPropertyAddress addr = {
+		kAudioHardwarePropertyDefaultOutputDevice,
+		kAudioObjectPropertyScopeGlobal,
+		kAudioObjectPropertyElementMaster
+	};
+	OSStatus err = AudioObjectGetPropertyData(kAudioObjectSystemObject, &addr, 0, NULL, &size, &device);
+	if (err != kAudioHardwareNoError || device == kAudioObjectUnknown)
+		return NULL;
+	return sc_device_audio_workgroup(device);
+}
+
+static inline void sc_release_audio_workgroup(os_workgroup_t inWorkgroup)
+{
+	if (inWorkgroup)
+		os_release(inWorkgroup);
+}
+
+// joins the calling thread to a workgroup for the lifetime of the object.
+// keep one instance per thread (e.g. in thread-local storage); the join
+// token must be handed back by the same thread that obtained it.
+class SC_AudioWorkgroupMembership
+{
+public:
+	explicit SC_AudioWorkgroupMembership(os_workgroup_t inWorkgroup)
+		: mWorkgroup(NULL)
+	{
+		if (!inWorkgroup)
+			return;
+		if (__builtin_available(macOS 11.0, *)) {
+			if (os_workgroup_join(inWorkgroup, &mToken) == 0)
+				mWorkgroup = inWorkgroup;
+		}
+	}
+
+	~SC_AudioWorkgroupMembership()
+	{
+		if (!mWorkgroup)
+			return;
+		if (__builtin_available(macOS 11.0, *))
+			os_workgroup_leave(mWorkgroup, &mToken);
+	}
+
+	bool Joined() const { return mWorkgroup != NULL; }
+
+private:
+	SC_AudioWorkgroupMembership(SC_AudioWorkgroupMembership const &);
+	SC_AudioWorkgroupMembership & operator=(SC_AudioWorkgroupMembership const &);
+
+	os_workgroup_t mWorkgroup;
+	os_workgroup_join_token_s mToken;
+};
+
+#endif // SC_AUDIO_WORKGROUP_AVAILABLE
+#endif // __APPLE__
+#endif // SC_AUDIOWORKGROUP_HPP_INCLUDED
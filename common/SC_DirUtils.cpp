@@ -23,6 +23,11 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdexcept>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "SC_Lock.h"
 
 #ifdef __APPLE__
 #import <Foundation/Foundation.h>
@@ -559,6 +564,106 @@ bool sc_ReadDir(SC_DirHandle* dir, const char* dirname, char* path, bool& skipEn
 }
 
 
+// Parallel traversal
+
+namespace {
+
+struct SC_DirWalkState
+{
+	bool mSkipCompilationDirs;
+	SC_EnterDirFunc mEnterDir;
+	SC_FileFunc mOnFile;
+	void *mUserData;
+
+	SC_Lock mMutex;
+	condition_variable_any mAvailable;
+	std::deque<std::string> mQueue;
+	int mPending; // directories queued or currently being scanned
+};
+
+void sc_DirWalkOne(SC_DirWalkState *state, const char *dirname)
+{
+	SC_DirHandle *dir = sc_OpenDir(dirname);
+	if (!dir)
+		return;
+
+	for (;;) {
+		char diritem[PATH_MAX];
+		bool skipItem = state->mSkipCompilationDirs;
+		bool validItem = sc_ReadDir(dir, dirname, diritem, skipItem);
+		if (!validItem) break;
+		if (skipItem) continue;
+
+		if (sc_DirectoryExists(diritem)) {
+			if (!state->mEnterDir || (*state->mEnterDir)(diritem, state->mUserData)) {
+				lock_guard<SC_Lock> lock(state->mMutex);
+				state->mQueue.push_back(diritem);
+				state->mPending++;
+				state->mAvailable.notify_one();
+			}
+		} else {
+			(*state->mOnFile)(diritem, state->mUserData);
+		}
+	}
+
+	sc_CloseDir(dir);
+}
+
+void sc_DirWalkLoop(SC_DirWalkState *state)
+{
+	unique_lock<SC_Lock> lock(state->mMutex);
+	for (;;) {
+		while (state->mQueue.empty()) {
+			if (state->mPending == 0)
+				return;
+			state->mAvailable.wait(lock);
+		}
+		std::string dirname = state->mQueue.front();
+		state->mQueue.pop_front();
+		lock.unlock();
+		sc_DirWalkOne(state, dirname.c_str());
+		lock.lock();
+		state->mPending--;
+		if (state->mPending == 0)
+			state->mAvailable.notify_all();
+	}
+}
+
+} // namespace
+
+bool sc_ParallelWalkDirectory(const char *dirname, bool skipCompilationDirectories,
+	SC_EnterDirFunc enterDir, SC_FileFunc onFile, void *userData)
+{
+	// probe the root up front so callers get a definite failure for it;
+	// unreadable subdirectories are silently skipped, as with sc_ReadDir.
+	SC_DirHandle *rootDir = sc_OpenDir(dirname);
+	if (!rootDir)
+		return false;
+	sc_CloseDir(rootDir);
+
+	SC_DirWalkState state;
+	state.mSkipCompilationDirs = skipCompilationDirectories;
+	state.mEnterDir = enterDir;
+	state.mOnFile = onFile;
+	state.mUserData = userData;
+	state.mPending = 1;
+	state.mQueue.push_back(dirname);
+
+	unsigned int numThreads = std::thread::hardware_concurrency();
+	if (numThreads < 2) numThreads = 2;
+	if (numThreads > 8) numThreads = 8;
+
+	std::vector<SC_Thread> threads;
+	for (unsigned int i = 1; i < numThreads; ++i)
+		threads.push_back(SC_Thread(sc_DirWalkLoop, &state));
+	sc_DirWalkLoop(&state);
+	for (size_t i = 0; i < threads.size(); ++i)
+		threads[i].join();
+
+	return true;
+}
+
+
 // Globbing
 
 struct SC_GlobHandle
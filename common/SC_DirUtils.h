@@ -126,6 +126,24 @@ void sc_CloseDir(SC_DirHandle *dir);
 // Return TRUE in 'skipEntry' iff entry should be skipped.
 bool sc_ReadDir(SC_DirHandle *dir, const char *dirname, char *path, bool &skipEntry);
 
+// Parallel recursive traversal.
+//
+// Walk the tree below 'dirname' on a small pool of worker threads, which
+// overlaps the per-directory read and per-entry stat round trips and makes a
+// large difference when the tree lives on network storage. 'enterDir' is
+// called once per subdirectory before it is descended into and may return
+// FALSE to skip it (pass NULL to descend into everything); 'onFile' is called
+// once per non-directory entry with its resolved path. Both callbacks may be
+// invoked concurrently from several threads and must do their own locking.
+// Entries are delivered in no particular order; callers that need a stable
+// order should collect paths and sort afterwards. Compilation directories are
+// skipped iff 'skipCompilationDirectories' is TRUE, as with sc_ReadDir.
+// Return FALSE iff 'dirname' itself cannot be opened.
+typedef bool (*SC_EnterDirFunc)(const char *dirname, void *userData);
+typedef void (*SC_FileFunc)(const char *path, void *userData);
+bool sc_ParallelWalkDirectory(const char *dirname, bool skipCompilationDirectories,
+		SC_EnterDirFunc enterDir, SC_FileFunc onFile, void *userData);
+
 
 // Globbing
 
@@ -21,10 +21,64 @@
 
 #include "SC_Reply.h"
 #include "SC_ReplyImpl.hpp"
+#include "SC_Endian.h"
+
+#include <stdint.h>
 
 void null_reply_func(struct ReplyAddress *addr, char* msg, int size)
 {}
 
+// "#bundle" with the immediate time tag
+static const char kBundleHeader[16] = { '#','b','u','n','d','l','e','\0', 0,0,0,0,0,0,0,1 };
+
+// stay below the maximum UDP datagram size
+static const size_t kMaxBatchedReplySize = 65000;
+
+void ReplyBatcher::BeginBatch(Batch& ioBatch, ReplyAddress *inReplyAddr)
+{
+	ioBatch.mAddr = *inReplyAddr;
+	ioBatch.mData.insert(ioBatch.mData.end(), kBundleHeader, kBundleHeader + sizeof(kBundleHeader));
+}
+
+void ReplyBatcher::Add(struct ReplyAddress *inReplyAddr, char* inBuf, int inSize)
+{
+	Batch& batch = mBatches[*inReplyAddr];
+	if (batch.mData.empty())
+		BeginBatch(batch, inReplyAddr);
+	else if (batch.mData.size() + sizeof(int32_t) + inSize > kMaxBatchedReplySize) {
+		FlushBatch(batch);
+		BeginBatch(batch, inReplyAddr);
+	}
+
+	int32_t elementSize = sc_htonl(inSize);
+	const char *sizeBytes = (const char*)&elementSize;
+	batch.mData.insert(batch.mData.end(), sizeBytes, sizeBytes + sizeof(int32_t));
+	batch.mData.insert(batch.mData.end(), inBuf, inBuf + inSize);
+	batch.mCount++;
+}
+
+void ReplyBatcher::FlushBatch(Batch& ioBatch)
+{
+	const size_t elementOffset = sizeof(kBundleHeader) + sizeof(int32_t);
+
+	if (ioBatch.mCount == 1)
+		// don't burden a lone message with the bundle wrapping
+		SendReply(&ioBatch.mAddr, ioBatch.mData.data() + elementOffset,
+				  (int)(ioBatch.mData.size() - elementOffset));
+	else if (ioBatch.mCount > 1)
+		SendReply(&ioBatch.mAddr, ioBatch.mData.data(), (int)ioBatch.mData.size());
+
+	ioBatch.mData.clear();
+	ioBatch.mCount = 0;
+}
+
+void ReplyBatcher::Flush()
+{
+	for (auto & item : mBatches)
+		FlushBatch(item.second);
+	mBatches.clear();
+}
+
 bool operator==(const ReplyAddress& a, const ReplyAddress& b)
 {
 	return     a.mAddress  == b.mAddress
@@ -26,6 +26,9 @@
 
 #include <boost/asio.hpp>
 
+#include <map>
+#include <vector>
+
 enum Protocol {
 	kUDP,
 	kTCP
@@ -53,4 +56,31 @@ inline void SendReply(struct ReplyAddress *inReplyAddr, char* inBuf, int inSize)
 	(inReplyAddr->mReplyFunc)(inReplyAddr, inBuf, inSize);
 }
 
+/** Coalesces replies added within one batching window into a single OSC
+ *  bundle per destination, so high-rate telemetry like /tr costs one socket
+ *  write per window instead of one per message. A destination with a single
+ *  pending message is sent unwrapped, keeping the wire format of sparse
+ *  traffic unchanged. Not thread safe: Add() and Flush() must be called from
+ *  the same thread.
+ */
+class ReplyBatcher
+{
+public:
+	void Add(struct ReplyAddress *inReplyAddr, char* inBuf, int inSize);
+	void Flush();
+
+private:
+	struct Batch
+	{
+		ReplyAddress mAddr;
+		int mCount = 0;
+		std::vector<char> mData;	// bundle header followed by size-prefixed elements
+	};
+
+	void BeginBatch(Batch& ioBatch, ReplyAddress *inReplyAddr);
+	void FlushBatch(Batch& ioBatch);
+
+	std::map<ReplyAddress, Batch> mBatches;
+};
+
 #endif // SC_REPLYIMPL_HPP
@@ -0,0 +1,131 @@
+//  polyphase sample rate conversion for buffer loading
+//
+//  Copyright (c) 2002 James McCartney. All rights reserved.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; see the file COPYING.  If not, write to
+//  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+//  Boston, MA 02111-1307, USA.
+
+#ifndef SC_SAMPLERATECONVERTER_HPP_INCLUDED
+#define SC_SAMPLERATECONVERTER_HPP_INCLUDED
+
+#include <math.h>
+#include <stdlib.h>
+
+// quality presets for SC_ResampleBuffer
+enum {
+	kResampleLinear = 0,	// two point linear interpolation, no filtering
+	kResampleMedium = 1,	// 16 tap windowed sinc, 64 phases
+	kResampleBest = 2		// 32 tap windowed sinc, 128 phases
+};
+
+// output frames produced when converting inFrames from inRate to outRate
+static inline long SC_ResampledFrames(long inFrames, double inRate, double outRate)
+{
+	return (long)((double)inFrames * outRate / inRate);
+}
+
+// polyphase windowed sinc sample rate conversion of one interleaved block.
+// the phase tables are linearly interpolated, so arbitrary (including
+// irrational) ratios are handled without drift; when downsampling the
+// filter also band limits to the new Nyquist. out must hold
+// SC_ResampledFrames(inFrames, inRate, outRate) frames. the tap loop is
+// branch free over the interior of the block, so the compiler can
+// vectorize it. returns false if the filter table cannot be allocated.
+static inline bool SC_ResampleBuffer(const float *in, long inFrames, int numChannels,
+	double inRate, float *out, long outFrames, double outRate, int quality)
+{
+	const double kPi = 3.14159265358979323846;
+	double ratio = inRate / outRate;
+
+	if (quality <= kResampleLinear) {
+		for (long i = 0; i < outFrames; ++i) {
+			double pos = (double)i * ratio;
+			long j = (long)pos;
+			double frac = pos - (double)j;
+			long j1 = j + 1 < inFrames ? j + 1 : inFrames - 1;
+			const float *a = in + j * numChannels;
+			const float *b = in + j1 * numChannels;
+			float *o = out + i * numChannels;
+			for (int ch = 0; ch < numChannels; ++ch)
+				o[ch] = (float)(a[ch] + frac * (b[ch] - a[ch]));
+		}
+		return true;
+	}
+
+	const int taps = quality >= kResampleBest ? 32 : 16;
+	const int phases = quality >= kResampleBest ? 128 : 64;
+	const int half = taps / 2;
+
+	double cutoff = outRate < inRate ? outRate / inRate : 1.0;
+	cutoff *= 0.945;	// transition band margin below Nyquist
+
+	float *table = (float*)malloc((phases + 1) * taps * sizeof(float));
+	if (!table) return false;
+
+	for (int p = 0; p <= phases; ++p) {
+		double frac = (double)p / (double)phases;
+		float *h = table + p * taps;
+		double sum = 0.;
+		for (int t = 0; t < taps; ++t) {
+			double x = (double)(t - half + 1) - frac;
+			double sinc = x == 0. ? cutoff : sin(kPi * cutoff * x) / (kPi * x);
+			// blackman window over the tap span
+			double u = (x + (double)half) / (double)taps;
+			double w = 0.42 - 0.5 * cos(2. * kPi * u) + 0.08 * cos(4. * kPi * u);
+			h[t] = (float)(sinc * w);
+			sum += h[t];
+		}
+		// normalizing each phase to unity DC gain removes amplitude ripple
+		float norm = (float)(1. / sum);
+		for (int t = 0; t < taps; ++t) h[t] *= norm;
+	}
+
+	for (long i = 0; i < outFrames; ++i) {
+		double pos = (double)i * ratio;
+		long j = (long)pos;
+		double frac = pos - (double)j;
+		double pfrac = frac * (double)phases;
+		int p = (int)pfrac;
+		float pblend = (float)(pfrac - (double)p);
+		const float *h0 = table + p * taps;
+		const float *h1 = h0 + taps;
+		float *o = out + i * numChannels;
+		for (int ch = 0; ch < numChannels; ++ch) o[ch] = 0.f;
+		if (j >= half && j + half < inFrames) {
+			// interior: all taps in range
+			const float *s = in + (j - half + 1) * numChannels;
+			for (int t = 0; t < taps; ++t) {
+				float coef = h0[t] + pblend * (h1[t] - h0[t]);
+				for (int ch = 0; ch < numChannels; ++ch)
+					o[ch] += coef * s[t * numChannels + ch];
+			}
+		} else {
+			// block edges: out of range input is taken as zero
+			for (int t = 0; t < taps; ++t) {
+				long k = j + t - half + 1;
+				if (k < 0 || k >= inFrames) continue;
+				float coef = h0[t] + pblend * (h1[t] - h0[t]);
+				const float *s = in + k * numChannels;
+				for (int ch = 0; ch < numChannels; ++ch)
+					o[ch] += coef * s[ch];
+			}
+		}
+	}
+
+	free(table);
+	return true;
+}
+
+#endif // SC_SAMPLERATECONVERTER_HPP_INCLUDED
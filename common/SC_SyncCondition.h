@@ -22,6 +22,120 @@
 #ifndef _SC_SyncCondition_
 #define _SC_SyncCondition_
 
+#ifdef __linux__
+
+#include <algorithm>
+#include <atomic>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Futex-based eventcount. The RT thread signals with one atomic increment
+   and only pays the wake syscall when the NRT thread is actually asleep,
+   so repeated signals within one callback coalesce into a single wake.
+   The waiter spins briefly before sleeping; the spin budget adapts so an
+   idle server falls straight through to the futex instead of burning CPU.
+
+   Same external behaviour as the mutex/condvar version below: one
+   signaller, one waiter, a counter pair instead of a condition. */
+
+class SC_SyncCondition
+{
+public:
+	SC_SyncCondition()
+		: read(0), write(0), sleeping(false), spinBudget(kMaxSpins)
+	{}
+
+	~SC_SyncCondition()
+	{}
+
+	void WaitEach()
+	{
+		// waits if it has caught up.
+		// not very friendly, may be trying in vain to keep up.
+		int r = read;
+		WaitForChange(r);
+		read = r + 1;
+	}
+
+	void WaitOnce()
+	{
+		// waits if not signaled since last time.
+		// if only a little late then can still go.
+		int writeSnapshot = write.load(std::memory_order_acquire);
+		if (read == writeSnapshot)
+			WaitForChange(writeSnapshot);
+		read = writeSnapshot;
+	}
+
+	void WaitNext()
+	{
+		// will wait for the next signal after the read = write statement
+		// this is the friendliest to other tasks, because if it is
+		// late upon entry, then it has to lose a turn.
+		read = write.load(std::memory_order_acquire);
+		WaitForChange(read);
+	}
+
+	void Signal()
+	{
+		write.fetch_add(1, std::memory_order_seq_cst);
+		// only syscall when the waiter is actually parked
+		if (sleeping.load(std::memory_order_seq_cst))
+			Futex(FUTEX_WAKE_PRIVATE, 1);
+	}
+
+private:
+	enum { kMaxSpins = 4096 };
+
+	long Futex(int op, int val)
+	{
+		return syscall(SYS_futex, reinterpret_cast<int*>(&write), op, val, (void*)0, (void*)0, 0);
+	}
+
+	static void SpinPause()
+	{
+#if defined(__i386__) || defined(__x86_64__)
+		__asm__ __volatile__("pause");
+#endif
+	}
+
+	void WaitForChange(int snapshot)
+	{
+		// spin first: under load the next signal arrives within a callback
+		// period and sleeping would just add wakeup latency.
+		for (int i = 0; i < spinBudget; ++i) {
+			if (write.load(std::memory_order_acquire) != snapshot) {
+				spinBudget = std::min((int)kMaxSpins, spinBudget * 2 + 1);
+				return;
+			}
+			SpinPause();
+		}
+		spinBudget = spinBudget >> 1;
+
+		for (;;) {
+			sleeping.store(true, std::memory_order_seq_cst);
+			if (write.load(std::memory_order_seq_cst) != snapshot)
+				break;
+			// the kernel rechecks write == snapshot under its own lock,
+			// so a signal racing with this call cannot be lost
+			Futex(FUTEX_WAIT_PRIVATE, snapshot);
+			if (write.load(std::memory_order_acquire) != snapshot)
+				break;
+		}
+		sleeping.store(false, std::memory_order_seq_cst);
+	}
+
+	static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex needs a plain int");
+
+	int read; // only touched by the waiter
+	std::atomic<int> write;
+	std::atomic<bool> sleeping;
+	int spinBudget;
+};
+
+#else // !__linux__
+
 #include "SC_Lock.h"
 
 class SC_SyncCondition
@@ -82,4 +196,6 @@ private:
 	int read, write;
 };
 
+#endif // __linux__
+
 #endif
@@ -26,6 +26,7 @@ For speed we keep this global, although this makes the code non-thread-safe.
 */
 
 #include "clz.h"
+#include <atomic>
 #include <stdlib.h>
 #include <cmath>
 #include <stdio.h>
@@ -88,8 +89,9 @@ extern "C" {
 typedef struct scfft {
 	unsigned int nfull, nwin, log2nfull, log2nwin; // Lengths of full FFT frame, and the (possibly shorter) windowed data frame
 	short wintype;
-	float *indata, *outdata, *trbuf;
+	float *indata, *outdata;
 	float scalefac; // Used to rescale the data to unity gain
+	float *scaledwin; // Shared window pre-multiplied by scalefac, so windowing and rescaling fuse into one pass. NULL if not applicable.
 } scfft;
 
 
@@ -240,24 +242,148 @@ static size_t scfft_trbufsize(unsigned int fullsize)
 static int largest_log2n = SC_FFT_LOG2_MAXSIZE;
 static int largest_fftsize = 1 << largest_log2n;
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Shared plan data and scratch cache.
+//
+// Every plan with the same (winsize, wintype, scalefac) uses an identical scaled window, and the
+// transform staging buffer only lives for the duration of a single scfft_dofft/scfft_doifft call.
+// Both used to be allocated per plan, which duplicated identical data across instances (dozens of
+// convolvers at the same FFT size) and made plan creation a sized allocation plus a fill pass.
+// Now scaled windows are cached process-wide like the plain windows above, and staging buffers are
+// checked out of a free list per transform, so concurrent graph threads each get their own while
+// a single-threaded server reuses one buffer for everything.
+//
+// The lock is a spin mutex: critical sections are a handful of pointer operations, and the only
+// contention is between graph threads at transform time.
+
+static std::atomic_flag gFFTCacheLock = ATOMIC_FLAG_INIT;
+
+static inline void scfft_cache_lock()	{ while (gFFTCacheLock.test_and_set(std::memory_order_acquire)) {} }
+static inline void scfft_cache_unlock()	{ gFFTCacheLock.clear(std::memory_order_release); }
+
+struct ScaledWindowEntry {
+	ScaledWindowEntry *next;
+	short wintype;
+	unsigned short log2nwin;
+	float scalefac;
+	float *data;
+};
+
+struct ScratchEntry {
+	ScratchEntry *next;
+	size_t bytes;
+	float *data;
+};
+
+static ScaledWindowEntry *gScaledWindows = NULL;
+static ScratchEntry *gScratchFree = NULL;
+
+static float* scfft_get_scaledwin(short wintype, unsigned short log2nwin, size_t winsize, float scalefac)
+{
+	scfft_cache_lock();
+	for (ScaledWindowEntry *e = gScaledWindows; e; e = e->next) {
+		if (e->wintype == wintype && e->log2nwin == log2nwin && e->scalefac == scalefac) {
+			scfft_cache_unlock();
+			return e->data;
+		}
+	}
+	scfft_cache_unlock();
+
+	// build outside the lock; losing a race merely caches one redundant copy
+	float *win = fftWindow[wintype][log2nwin];
+	if (!win)
+		win = fftWindow[wintype][log2nwin] = scfft_create_fftwindow(wintype, log2nwin);
+	if (!win)
+		return NULL;
+
+	float *scaled = (float*)nova::malloc_aligned(winsize * sizeof(float));
+	if (!scaled)
+		return NULL;
+	for (size_t i=0; i<winsize; ++i)
+		scaled[i] = win[i] * scalefac;
+
+	ScaledWindowEntry *e = (ScaledWindowEntry*)malloc(sizeof(ScaledWindowEntry));
+	if (!e) {
+		nova::free_aligned(scaled);
+		return NULL;
+	}
+	e->wintype = wintype;
+	e->log2nwin = log2nwin;
+	e->scalefac = scalefac;
+	e->data = scaled;
+
+	scfft_cache_lock();
+	e->next = gScaledWindows;
+	gScaledWindows = e;
+	scfft_cache_unlock();
+	return scaled;
+}
+
+static ScratchEntry* scfft_checkout_scratch(size_t bytes)
+{
+	scfft_cache_lock();
+	ScratchEntry **prev = &gScratchFree;
+	for (ScratchEntry *e = gScratchFree; e; prev = &e->next, e = e->next) {
+		if (e->bytes >= bytes) {
+			*prev = e->next;
+			scfft_cache_unlock();
+			return e;
+		}
+	}
+	scfft_cache_unlock();
+
+	// nothing big enough free: make a new one (first use of a size, or deeper
+	// concurrency than seen before; after that the buffer stays in the pool)
+	ScratchEntry *e = (ScratchEntry*)malloc(sizeof(ScratchEntry));
+	if (!e)
+		return NULL;
+	e->bytes = bytes;
+	e->data = (float*)nova::malloc_aligned(bytes);
+	if (!e->data) {
+		free(e);
+		return NULL;
+	}
+	memset(e->data, 0, bytes);
+	return e;
+}
+
+static void scfft_checkin_scratch(ScratchEntry *e)
+{
+	scfft_cache_lock();
+	e->next = gScratchFree;
+	gScratchFree = e;
+	scfft_cache_unlock();
+}
+
 scfft * scfft_create(size_t fullsize, size_t winsize, SCFFT_WindowFunction wintype,
 					 float *indata, float *outdata, SCFFT_Direction forward, SCFFT_Allocator & alloc)
 {
 	if ( (fullsize > SC_FFT_ABSOLUTE_MAXSIZE) || (fullsize < SC_FFT_MINSIZE) )
 		return NULL;
 
-	const int alignment = 128; // in bytes
-	char * chunk = (char*) alloc.alloc(sizeof(scfft) + scfft_trbufsize(fullsize) + alignment);
-	if (!chunk)
-		return NULL;
+	// The scale factors rescale the data to unity gain. The old Green lib did this itself, meaning scalefacs would here be 1...
+	float scalefac;
+	if (forward) {
+#if SC_FFT_VDSP
+		scalefac = 0.5f;
+#else // forward FFTW and Green factor
+		scalefac = 1.f;
+#endif
+	} else { // backward FFTW and VDSP factor
+#if SC_FFT_GREEN
+		scalefac = 1.f;
+#else  // fftw, vdsp
+		scalefac = 1.f / fullsize;
+#endif
+	}
 
-	scfft * f = (scfft*)chunk;
-	float *trbuf = (float*)(chunk + sizeof(scfft));
-	trbuf = (float*) ((size_t)((char*)trbuf + (alignment - 1)) & -alignment); // FIXME: should be intptr_t instead of size_t once we use c++11
+	// When both a window and a rescale are needed, bake the scale factor into a shared
+	// copy of the window so each transform does a single multiply pass over the frame.
+	const bool fusewindow = (wintype != kRectWindow) && (scalefac != 1.f);
 
-#ifdef NOVA_SIMD
-	assert(nova::vec<float>::is_aligned(trbuf));
-#endif
+	scfft * f = (scfft*) alloc.alloc(sizeof(scfft));
+	if (!f)
+		return NULL;
 
 	f->nfull = fullsize;
 	f->nwin  =  winsize;
@@ -266,29 +392,24 @@ scfft * scfft_create(size_t fullsize, size_t winsize, SCFFT_WindowFunction winty
 	f->wintype = wintype;
 	f->indata  = indata;
 	f->outdata = outdata;
-	f->trbuf   = trbuf;
+	f->scalefac = scalefac;
+	f->scaledwin = NULL;
 
 	// Buffer is larger than the range of sizes we provide for at startup; we can get ready just-in-time though
 	if (fullsize > largest_fftsize){
 		scfft_ensurewindow(f->log2nfull, f->log2nwin, wintype);
 	}
 
-	// The scale factors rescale the data to unity gain. The old Green lib did this itself, meaning scalefacs would here be 1...
-	if (forward) {
-#if SC_FFT_VDSP
-		f->scalefac = 0.5f;
-#else // forward FFTW and Green factor
-		f->scalefac = 1.f;
-#endif
-	} else { // backward FFTW and VDSP factor
-#if SC_FFT_GREEN
-		f->scalefac = 1.f;
-#else  // fftw, vdsp
-		f->scalefac = 1.f / fullsize;
-#endif
-	}
+	if (fusewindow)
+		f->scaledwin = scfft_get_scaledwin(wintype, f->log2nwin, winsize, scalefac);
 
-	memset(trbuf, 0, scfft_trbufsize(fullsize));
+	// warm the scratch pool now, so the first transform doesn't have to allocate
+	ScratchEntry *scratch = scfft_checkout_scratch(scfft_trbufsize(fullsize));
+	if (!scratch) {
+		alloc.free(f);
+		return NULL;
+	}
+	scfft_checkin_scratch(scratch);
 
 	return f;
 }
@@ -343,8 +464,27 @@ void scfft_ensurewindow(unsigned short log2_fullsize, unsigned short log2_winsiz
 
 // these do the main jobs.
 static void scfft_dowindowing(float *data, unsigned int winsize, unsigned int fullsize, unsigned short log2_winsize,
-							  short wintype, float scalefac)
+							  short wintype, float scalefac, const float *scaledwin)
 {
+	// Fused path: the scale factor is already baked into the window, one multiply pass suffices
+	if (scaledwin) {
+#if SC_FFT_VDSP
+		vDSP_vmul(data, 1, (float*)scaledwin, 1, data, 1, winsize);
+#elif defined (NOVA_SIMD)
+		using namespace nova;
+		if (((vec<float>::objects_per_cacheline & winsize) == 0) && vec<float>::is_aligned(data))
+			times_vec_simd(data, data, scaledwin, winsize);
+		else
+			times_vec(data, data, scaledwin, winsize);
+#else
+		for (unsigned int i=0; i<winsize; ++i)
+			data[i] *= scaledwin[i];
+#endif
+		// Zero-padding:
+		memset(data + winsize, 0, (fullsize - winsize) * sizeof(float));
+		return;
+	}
+
 	if (wintype != kRectWindow) {
 		float *win = fftWindow[wintype][log2_winsize];
 		if (!win){
@@ -372,6 +512,14 @@ static void scfft_dowindowing(float *data, unsigned int winsize, unsigned int fu
 	if (scalefac != 1.f) {
 #if SC_FFT_VDSP
 		vDSP_vsmul(data, 1, &scalefac, data, 1, winsize);
+#elif defined (NOVA_SIMD)
+		using namespace nova;
+		if (((vec<float>::objects_per_cacheline & winsize) == 0) && vec<float>::is_aligned(data))
+			times_vec_simd(data, data, scalefac, winsize);
+		else {
+			for(unsigned int i=0; i<winsize; ++i)
+				data[i] *= scalefac;
+		}
 #else
 		for(unsigned int i=0; i<winsize; ++i)
 			data[i] *= scalefac;
@@ -384,35 +532,44 @@ static void scfft_dowindowing(float *data, unsigned int winsize, unsigned int fu
 
 void scfft_dofft(scfft * f)
 {
+	ScratchEntry *scratch = scfft_checkout_scratch(scfft_trbufsize(f->nfull));
+	if (!scratch)
+		return;
+	float *trbuf = scratch->data;
+
 	// Data goes to transform buf
-	memcpy(f->trbuf, f->indata, f->nwin * sizeof(float));
-	scfft_dowindowing(f->trbuf, f->nwin, f->nfull, f->log2nwin, f->wintype, f->scalefac);
+	memcpy(trbuf, f->indata, f->nwin * sizeof(float));
+	scfft_dowindowing(trbuf, f->nwin, f->nfull, f->log2nwin, f->wintype, f->scalefac, f->scaledwin);
 #if SC_FFT_FFTW
 	// forward transformation is in-place
-	fftwf_execute_dft_r2c(precompiledForwardPlansInPlace[f->log2nfull], f->trbuf, (fftwf_complex*)f->trbuf);
+	fftwf_execute_dft_r2c(precompiledForwardPlansInPlace[f->log2nfull], trbuf, (fftwf_complex*)trbuf);
 
 	// Rearrange output data onto public buffer
-	memcpy(f->outdata, f->trbuf, f->nfull * sizeof(float));
-	f->outdata[1] = f->trbuf[f->nfull]; // Pack nyquist val in
+	memcpy(f->outdata, trbuf, f->nfull * sizeof(float));
+	f->outdata[1] = trbuf[f->nfull]; // Pack nyquist val in
 #elif SC_FFT_VDSP
 	// Perform even-odd split
-	vDSP_ctoz((COMPLEX*) f->trbuf, 2, &splitBuf, 1, f->nfull >> 1);
+	vDSP_ctoz((COMPLEX*) trbuf, 2, &splitBuf, 1, f->nfull >> 1);
 	// Now the actual FFT
 	vDSP_fft_zrip(fftSetup[f->log2nfull], &splitBuf, 1, f->log2nfull, FFT_FORWARD);
 	// Copy the data to the public output buf, transforming it back out of "split" representation
 	vDSP_ztoc(&splitBuf, 1, (DSPComplex*) f->outdata, 2, f->nfull >> 1);
 #elif SC_FFT_GREEN
 	// Green FFT is in-place
-	rffts(f->trbuf, f->log2nfull, 1, cosTable[f->log2nfull]);
+	rffts(trbuf, f->log2nfull, 1, cosTable[f->log2nfull]);
 	// Copy to public buffer
-	memcpy(f->outdata, f->trbuf, f->nfull * sizeof(float));
+	memcpy(f->outdata, trbuf, f->nfull * sizeof(float));
 #endif
+	scfft_checkin_scratch(scratch);
 }
 
 void scfft_doifft(scfft * f)
 {
+	ScratchEntry *scratch = scfft_checkout_scratch(scfft_trbufsize(f->nfull));
+	if (!scratch)
+		return;
 #if SC_FFT_FFTW
-	float *trbuf = f->trbuf;
+	float *trbuf = scratch->data;
 	size_t bytesize = f->nfull * sizeof(float);
 	memcpy(trbuf, f->indata, bytesize);
 	trbuf[1] = 0.f;
@@ -426,7 +583,7 @@ void scfft_doifft(scfft * f)
 	vDSP_fft_zrip(fftSetup[f->log2nfull], &splitBuf, 1, f->log2nfull, FFT_INVERSE);
 	vDSP_ztoc(&splitBuf, 1, (DSPComplex*) f->outdata, 2, f->nfull >> 1);
 #elif SC_FFT_GREEN
-	float *trbuf = f->trbuf;
+	float *trbuf = scratch->data;
 	size_t bytesize = f->nfull * sizeof(float);
 	memcpy(trbuf, f->indata, bytesize);
 	// Green FFT is in-place
@@ -434,7 +591,24 @@ void scfft_doifft(scfft * f)
 	// Copy to public buffer
 	memcpy(f->outdata, trbuf, f->nwin * sizeof(float));
 #endif
-	scfft_dowindowing(f->outdata, f->nwin, f->nfull, f->log2nwin, f->wintype, f->scalefac);
+	scfft_dowindowing(f->outdata, f->nwin, f->nfull, f->log2nwin, f->wintype, f->scalefac, f->scaledwin);
+	scfft_checkin_scratch(scratch);
+}
+
+// Batched transforms: run a group of plans back-to-back in one call. The plans may differ
+// in size and direction. Per-transform overhead is lower than separate calls since the
+// plan tables, windows and the shared staging buffer stay hot in cache (and, for vDSP,
+// the shared split buffer is reused immediately).
+void scfft_dofft_batch(scfft **ffts, size_t count)
+{
+	for (size_t i=0; i<count; ++i)
+		scfft_dofft(ffts[i]);
+}
+
+void scfft_doifft_batch(scfft **ffts, size_t count)
+{
+	for (size_t i=0; i<count; ++i)
+		scfft_doifft(ffts[i]);
 }
 
 void scfft_destroy(scfft *f, SCFFT_Allocator & alloc)
@@ -25,7 +25,9 @@
 #include "SC_Types.h"
 #include <stdexcept>
 #include <cstring>
+#include <cstdlib>
 #include <string>
+#include <mutex>
 
 template <int MaxPacketSize = 8192>
 struct scpacket {
@@ -113,6 +115,20 @@ struct scpacket {
 		memcpy(wrpos, src, len);
 		wrpos += len4;
 	}
+	// a blob whose content is encoded in place: reserve the length word, write
+	// the content directly into the packet, then patch the length. the content
+	// must be written in whole int32 words, which OSC messages always are.
+	int32* OpenBlob()
+	{
+		if (wrpos >= endpos) throw_overflow_exception();
+		int32* sizepos = wrpos;
+		*wrpos++ = 0;
+		return sizepos;
+	}
+	void CloseBlob(int32* sizepos)
+	{
+		*sizepos = sc_htonl((int32)((wrpos - sizepos - 1) * sizeof(int32)));
+	}
 	void addtag(char c) { *tagwrpos++ = c; }
 	void skip(int n)
 	{
@@ -153,11 +169,324 @@ struct scpacket {
 			*msgsizepos = sc_htonl(((wrpos - msgsizepos) - 1) * sizeof(int32));
 		}
 	}
+
+	// nested encodes (blobs holding whole messages) save and restore the
+	// enclosing message's write state around themselves; see pooled_scpacket
+	// for why this is a struct and not individual members
+	typedef int32* blobref;
+	struct msgstate { int32 *msgsizepos; char *tagwrpos; int inbundle; };
+	msgstate save_msg_state()
+	{
+		msgstate s = { msgsizepos, tagwrpos, inbundle };
+		return s;
+	}
+	void restore_msg_state(const msgstate& s)
+	{
+		msgsizepos = s.msgsizepos;
+		tagwrpos = s.tagwrpos;
+		inbundle = s.inbundle;
+	}
 };
 
 typedef scpacket<> small_scpacket;
 typedef scpacket<65516> big_scpacket;
 
+/*	A packet builder for large bundles. big_scpacket puts a ~64KB buffer on
+	the stack of every send path; pooled_scpacket instead chains fixed size
+	segments drawn from a process wide free list, so building a 60KB scene
+	change bundle touches neither the stack nor (in the steady state) the
+	heap, and the packet can grow past 64KB. The segments never move, so
+	size words are patched in place like in scpacket; sizes are tracked as
+	byte offsets because pointer differences don't work across segments.
+	Send the result without linearizing it by passing the segments to a
+	scatter/gather socket write (forEachChunk), or use copyTo for consumers
+	that need contiguous bytes. Not for the RT thread: the pool locks. */
+
+struct scpacket_segment
+{
+	static const int kWords = 2046;	// just under 8KB per segment
+	static const int kBytes = kWords * sizeof(int32);
+	scpacket_segment *next;
+	int32 data[kWords];
+};
+
+class scpacket_segment_pool
+{
+public:
+	static scpacket_segment_pool& instance()
+	{
+		static scpacket_segment_pool pool;	// one per process, lazily built
+		return pool;
+	}
+
+	scpacket_segment* acquire()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mLock);
+			if (mFreeList) {
+				scpacket_segment *seg = mFreeList;
+				mFreeList = seg->next;
+				--mNumFree;
+				seg->next = 0;
+				return seg;
+			}
+		}
+		scpacket_segment *seg = (scpacket_segment*)malloc(sizeof(scpacket_segment));
+		if (!seg) throw std::runtime_error(std::string("scpacket_segment_pool: out of memory"));
+		seg->next = 0;
+		return seg;
+	}
+
+	void release(scpacket_segment *chain)
+	{
+		while (chain) {
+			scpacket_segment *next = chain->next;
+			{
+				std::lock_guard<std::mutex> lock(mLock);
+				if (mNumFree < kMaxFree) {
+					chain->next = mFreeList;
+					mFreeList = chain;
+					++mNumFree;
+					chain = 0;
+				}
+			}
+			if (chain) free(chain);
+			chain = next;
+		}
+	}
+
+private:
+	scpacket_segment_pool() : mFreeList(0), mNumFree(0) {}
+	scpacket_segment_pool(const scpacket_segment_pool&);	// = delete
+	scpacket_segment_pool& operator=(const scpacket_segment_pool&);
+
+	enum { kMaxFree = 32 };	// ~256KB kept warm across sends
+	std::mutex mLock;
+	scpacket_segment *mFreeList;
+	int mNumFree;
+};
+
+struct pooled_scpacket
+{
+	scpacket_segment *head, *tail;
+	char *wrposb, *endposb;	// write window within the tail segment
+	int32 *msgsizepos;
+	size_t msgsizestart;
+	scpacket_segment *tagseg;	// tag area walker; the area may span segments
+	char *tagwrpos;
+	int inbundle;
+	size_t totalsize;	// bytes written over all segments
+	int nsegments;
+
+	pooled_scpacket()
+	{
+		head = tail = scpacket_segment_pool::instance().acquire();
+		wrposb = (char*)tail->data;
+		endposb = wrposb + scpacket_segment::kBytes;
+		msgsizepos = 0;
+		msgsizestart = 0;
+		tagseg = 0;
+		tagwrpos = 0;
+		inbundle = 0;
+		totalsize = 0;
+		nsegments = 1;
+	}
+	~pooled_scpacket()
+	{
+		scpacket_segment_pool::instance().release(head);
+	}
+
+	// low level writers. every OSC item is a whole number of int32 words,
+	// so the write position is word aligned whenever an item starts and a
+	// single word never straddles a segment boundary.
+	void grow()
+	{
+		scpacket_segment *seg = scpacket_segment_pool::instance().acquire();
+		tail->next = seg;
+		tail = seg;
+		wrposb = (char*)seg->data;
+		endposb = wrposb + scpacket_segment::kBytes;
+		nsegments++;
+	}
+	int32* addword(int32 v)
+	{
+		if (wrposb >= endposb) grow();
+		int32 *pos = (int32*)wrposb;
+		*pos = v;
+		wrposb += sizeof(int32);
+		totalsize += sizeof(int32);
+		return pos;
+	}
+	void addbytes(const char *src, size_t len)
+	{
+		while (len) {
+			if (wrposb >= endposb) grow();
+			size_t room = endposb - wrposb;
+			size_t n = len < room ? len : room;
+			memcpy(wrposb, src, n);
+			wrposb += n; src += n; len -= n; totalsize += n;
+		}
+	}
+	void addzeros(size_t len)
+	{
+		while (len) {
+			if (wrposb >= endposb) grow();
+			size_t room = endposb - wrposb;
+			size_t n = len < room ? len : room;
+			memset(wrposb, 0, n);
+			wrposb += n; len -= n; totalsize += n;
+		}
+	}
+
+	// the scpacket builder interface
+	void addi(int i) { addword(sc_htonl(i)); }
+	void addii(int64 ii)
+	{
+		addi((int)(ii >> 32));
+		addi((int)ii);
+	}
+	void addf(float f)
+	{
+		elem32 slot;
+		slot.f = f;
+		addword(sc_htonl(slot.i));
+	}
+	void addd(double f)
+	{
+		elem64 slot;
+		slot.f = f;
+		addword(sc_htonl(slot.i >> 32));
+		addword(sc_htonl(slot.i & 0x00000000FFFFFFFF));
+	}
+	void adds(const char *src)
+	{
+		adds(src, strlen(src));
+	}
+	void adds(const char *src, size_t len)
+	{
+		addbytes(src, len);
+		addzeros(4 - (len & 3));	// at least one terminating zero
+	}
+	void adds_slpre(const char *src) // prepends a slash
+	{
+		size_t len = strlen(src);
+		addbytes("/", 1);
+		addbytes(src, len);
+		addzeros(4 - ((len + 1) & 3));
+	}
+	void addb(uint8 *src, size_t len)
+	{
+		addi((int32)len);
+		addbytes((const char*)src, len);
+		addzeros((4 - (len & 3)) & 3);	// blobs pad only to alignment
+	}
+	void skip(int n)	// zero filled, unlike scpacket
+	{
+		addzeros(n * sizeof(int32));
+	}
+	void maketags(int n)
+	{
+		int size4 = (n + 4) >> 2;
+		tagseg = tail;
+		tagwrpos = wrposb;
+		skip(size4);
+	}
+	void addtag(char c)
+	{
+		if (tagwrpos >= (char*)tagseg->data + scpacket_segment::kBytes) {
+			tagseg = tagseg->next;	// the area was written by maketags, so next exists
+			tagwrpos = (char*)tagseg->data;
+		}
+		*tagwrpos++ = c;
+	}
+
+	size_t size() const { return totalsize; }
+	int numchunks() const { return nsegments; }
+
+	// hand each segment to a gathering socket write, in packet order
+	template <typename Func> void forEachChunk(Func func) const
+	{
+		for (const scpacket_segment *seg = head; seg; seg = seg->next) {
+			size_t bytes = seg == tail ? wrposb - (const char*)seg->data
+			                           : (size_t)scpacket_segment::kBytes;
+			if (bytes) func((const char*)seg->data, bytes);
+		}
+	}
+	// linearize for consumers that need contiguous bytes; dst must hold size()
+	void copyTo(char *dst) const
+	{
+		for (const scpacket_segment *seg = head; seg; seg = seg->next) {
+			size_t bytes = seg == tail ? wrposb - (const char*)seg->data
+			                           : (size_t)scpacket_segment::kBytes;
+			memcpy(dst, seg->data, bytes);
+			dst += bytes;
+		}
+	}
+
+	void OpenBundle(int64 time)
+	{
+		inbundle++;
+		adds("#bundle");
+		addii(time);
+	}
+	void CloseBundle()
+	{
+		if (inbundle) inbundle--;
+	}
+
+	void BeginMsg()
+	{
+		if (inbundle) {
+			msgsizepos = addword(0);
+			msgsizestart = totalsize;
+		}
+	}
+	void EndMsg()
+	{
+		if (inbundle) {
+			*msgsizepos = sc_htonl((int32)(totalsize - msgsizestart));
+		}
+	}
+
+	// size words are patched through pointers (segments never move), but the
+	// written span must be measured in byte offsets, so a blob reference and
+	// the saved message state carry both
+	struct blobref { int32 *sizepos; size_t start; };
+	blobref OpenBlob()
+	{
+		blobref ref;
+		ref.sizepos = addword(0);
+		ref.start = totalsize;
+		return ref;
+	}
+	void CloseBlob(blobref ref)
+	{
+		*ref.sizepos = sc_htonl((int32)(totalsize - ref.start));
+	}
+
+	struct msgstate {
+		int32 *msgsizepos; size_t msgsizestart;
+		scpacket_segment *tagseg; char *tagwrpos; int inbundle;
+	};
+	msgstate save_msg_state()
+	{
+		msgstate s = { msgsizepos, msgsizestart, tagseg, tagwrpos, inbundle };
+		return s;
+	}
+	void restore_msg_state(const msgstate& s)
+	{
+		msgsizepos = s.msgsizepos;
+		msgsizestart = s.msgsizestart;
+		tagseg = s.tagseg;
+		tagwrpos = s.tagwrpos;
+		inbundle = s.inbundle;
+	}
+
+private:
+	pooled_scpacket(const pooled_scpacket&);	// = delete
+	pooled_scpacket& operator=(const pooled_scpacket&);
+};
+
 
 #endif
 
@@ -22,6 +22,8 @@
 
 #include "scope_buffer.hpp"
 
+#include <cstring>
+
 #include <boost/version.hpp>
 #include <boost/foreach.hpp>
 #include <boost/ref.hpp>
@@ -43,23 +45,66 @@ static inline string make_shmem_name(unsigned int port_number)
 	return string("SuperColliderServer_") + boost::lexical_cast<string>(port_number);
 }
 
+/** per-bus meter slot, written once per block by the server's driver loop
+ *  when metering is enabled. plain stores, same rationale as
+ *  set_control_bus: a torn read mixes two adjacent blocks, which is
+ *  harmless for metering. the overview ring holds the last
+ *  overview_frames block peaks as a decimated mip-map level for waveform
+ *  overviews; overview_index is the slot written next. */
+struct bus_meter
+{
+	static const int overview_frames = 64; // power of two
+
+	float peak;         // peak magnitude of the last block
+	float rms;          // root mean square of the last block
+	int overview_index; // next slot of the overview ring
+	float overview[overview_frames];
+};
+
+/** synthdef transfer slot: a local client writes a serialized def file into
+ *  a free slot once and triggers parsing with /d_recvSHM <index>, skipping
+ *  the OSC blob encoding, the socket hop and the datagram size limit. state
+ *  is a plain int handshake - the stores are ordered by the OSC message that
+ *  names the slot, same rationale as set_control_bus. the server hands the
+ *  slot back by resetting state after parsing. */
+struct def_transfer_slot
+{
+	static const int slot_size = 131072;
+	enum { slot_free = 0, slot_filled = 1 };
+
+	int state;
+	int size;
+	char data[slot_size];
+};
+
 class server_shared_memory
 {
 public:
+	static const int num_def_slots = 8;
+
 	typedef offset_ptr<float> sh_float_ptr;
+	typedef offset_ptr<bus_meter> bus_meter_ptr;
 	typedef offset_ptr<scope_buffer> scope_buffer_ptr;
+	typedef offset_ptr<def_transfer_slot> def_transfer_slot_ptr;
 
 	typedef bi::allocator<scope_buffer_ptr, managed_shared_memory::segment_manager> scope_buffer_ptr_allocator;
 	typedef bi::vector<scope_buffer_ptr, scope_buffer_ptr_allocator> scope_buffer_vector;
 
-	server_shared_memory(managed_shared_memory & segment, int control_busses, int num_scope_buffers = 128):
-		num_control_busses(control_busses),
+	server_shared_memory(managed_shared_memory & segment, int control_busses, int audio_busses,
+						 int num_scope_buffers = 128):
+		num_control_busses(control_busses), num_bus_meters(audio_busses),
 
 		scope_buffers(scope_buffer_ptr_allocator(segment.get_segment_manager()))
 	{
 		control_busses_ = (float*)segment.allocate(control_busses * sizeof(float));
 		std::fill(control_busses_.get(), control_busses_.get() + control_busses, 0.f);
 
+		bus_meters_ = (bus_meter*)segment.allocate(audio_busses * sizeof(bus_meter));
+		std::memset(bus_meters_.get(), 0, audio_busses * sizeof(bus_meter));
+
+		def_slots_ = (def_transfer_slot*)segment.allocate(num_def_slots * sizeof(def_transfer_slot));
+		std::memset(def_slots_.get(), 0, num_def_slots * sizeof(def_transfer_slot));
+
 		for (int i = 0; i != num_scope_buffers; ++i) {
 			scope_buffer * raw_scope_ptr = (scope_buffer*)segment.allocate(sizeof(scope_buffer));
 			new(raw_scope_ptr) scope_buffer();
@@ -71,6 +116,8 @@ public:
 	void destroy(managed_shared_memory & segment)
 	{
 		segment.deallocate(control_busses_.get());
+		segment.deallocate(bus_meters_.get());
+		segment.deallocate(def_slots_.get());
 
 		for (size_t i = 0; i != scope_buffers.size(); ++i)
 			segment.deallocate(scope_buffers[i].get());
@@ -78,7 +125,9 @@ public:
 
 	void set_control_bus(int bus, float value)
 	{
-		// TODO: we need to set the control busses via a work queue
+		// plain store: concurrent writes race with the dsp thread exactly
+		// like a /c_set does, and a torn float cannot occur on our targets
+		control_busses_[bus] = value;
 	}
 
 	float * get_control_busses(void)
@@ -86,6 +135,16 @@ public:
 		return control_busses_.get();
 	}
 
+	bus_meter * get_bus_meters(void)
+	{
+		return bus_meters_.get();
+	}
+
+	int get_num_bus_meters(void) const
+	{
+		return num_bus_meters;
+	}
+
 	scope_buffer * get_scope_buffer(unsigned int index)
 	{
 		if (index < scope_buffers.size())
@@ -94,17 +153,29 @@ public:
 			return 0;
 	}
 
+	def_transfer_slot * get_def_slot(unsigned int index)
+	{
+		if (index < num_def_slots)
+			return def_slots_.get() + index;
+		else
+			return 0;
+	}
+
 private:
 	string shmem_name;
 	int num_control_busses;
+	int num_bus_meters;
 	sh_float_ptr control_busses_; // control busses
+	bus_meter_ptr bus_meters_;    // per audio bus meter slots
 	scope_buffer_vector scope_buffers;
+	def_transfer_slot_ptr def_slots_; // synthdef transfer slots
 };
 
 class server_shared_memory_creator
 {
 public:
-	server_shared_memory_creator(unsigned int port_number, unsigned int control_busses):
+	server_shared_memory_creator(unsigned int port_number, unsigned int control_busses,
+								 unsigned int audio_busses = 0):
 		shmem_name(detail_server_shm::make_shmem_name(port_number)),
 		segment(bi::open_or_create, shmem_name.c_str(), 8192 * 1024)
 	{
@@ -118,7 +189,7 @@ public:
 		scope_pool.init(memory_for_scope_pool, scope_pool_size);
 
 		shm = segment.construct<server_shared_memory>(shmem_name.c_str())(ref(segment), control_busses,
-																		  num_scope_buffers);
+																		  audio_busses, num_scope_buffers);
 	}
 
 	static void cleanup(unsigned int port_number)
@@ -145,6 +216,11 @@ public:
 		return shm->get_control_busses();
 	}
 
+	bus_meter * get_bus_meters(void)
+	{
+		return shm->get_bus_meters();
+	}
+
 	scope_buffer_writer get_scope_buffer_writer(unsigned int index, unsigned int channels, unsigned int size)
 	{
 		scope_buffer *buf = shm->get_scope_buffer(index);
@@ -159,6 +235,11 @@ public:
 		writer.release( scope_pool );
 	}
 
+	def_transfer_slot * get_def_slot(unsigned int index)
+	{
+		return shm->get_def_slot(index);
+	}
+
 private:
 	string shmem_name;
 	managed_shared_memory segment;
@@ -187,12 +268,42 @@ public:
 		return shm->get_control_busses();
 	}
 
+	bus_meter * get_bus_meters(void)
+	{
+		return shm->get_bus_meters();
+	}
+
+	int get_num_bus_meters(void) const
+	{
+		return shm->get_num_bus_meters();
+	}
+
 	scope_buffer_reader get_scope_buffer_reader(unsigned int index)
 	{
 		scope_buffer *buf = shm->get_scope_buffer(index);
 		return scope_buffer_reader(buf);
 	}
 
+	/** write a serialized def file into a free transfer slot.
+	 *  returns the slot index to pass to /d_recvSHM, or -1 if the def does
+	 *  not fit or all slots are still in flight. */
+	int write_def(const char * data, size_t size)
+	{
+		if (size > (size_t)def_transfer_slot::slot_size)
+			return -1;
+
+		for (int i = 0; i != server_shared_memory::num_def_slots; ++i) {
+			def_transfer_slot * slot = shm->get_def_slot(i);
+			if (slot->state == def_transfer_slot::slot_free) {
+				std::memcpy(slot->data, data, size);
+				slot->size = (int)size;
+				slot->state = def_transfer_slot::slot_filled;
+				return i;
+			}
+		}
+		return -1;
+	}
+
 private:
 	string shmem_name;
 	managed_shared_memory segment;
@@ -204,7 +315,9 @@ private:
 using detail_server_shm::server_shared_memory_client;
 using detail_server_shm::server_shared_memory_creator;
 using detail_server_shm::scope_buffer_writer;
+using detail_server_shm::def_transfer_slot;
 using detail_server_shm::scope_buffer_reader;
 using detail_server_shm::scope_buffer;
+using detail_server_shm::bus_meter;
 
 #endif /* SERVER_SHM_HPP */
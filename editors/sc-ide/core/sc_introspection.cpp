@@ -29,6 +29,7 @@
 #include <QDebug>
 #include <QHash>
 #include <QObject>
+#include <QStringList>
 
 namespace ScIDE {
 namespace ScLanguage {
@@ -38,10 +39,10 @@ Introspection::Introspection()
     initPaths();
 }
 
-Introspection::Introspection( QString const & yamlString )
+Introspection::Introspection( QString const & yamlString, Introspection const * previous )
 {
     initPaths();
-    bool parsingSuccessful = parse(yamlString);
+    bool parsingSuccessful = parse(yamlString, previous);
     if (!parsingSuccessful)
         throw std::runtime_error("Introspection parse error");
 }
@@ -50,6 +51,7 @@ Introspection & Introspection::operator =(Introspection && rhs)
 {
     mClassMap           = std::move( rhs.mClassMap           );
     mMethodMap          = std::move( rhs.mMethodMap          );
+    mChunkMap           = std::move( rhs.mChunkMap           );
     mClassLibraryPath   = std::move( rhs.mClassLibraryPath   );
     mUserExtensionDir   = std::move( rhs.mUserExtensionDir   );
     mSystemExtensionDir = std::move( rhs.mSystemExtensionDir );
@@ -62,7 +64,221 @@ void Introspection::initPaths()
     mSystemExtensionDir = standardDirectory(ScExtensionSystemDir) + QStringLiteral("/");
 }
 
-bool Introspection::parse(const QString & yamlString )
+struct PendingSuperclassLink
+{
+    Class * klass;
+    QString metaClassName;
+    QString superClassName;
+};
+
+// The introspection dump is a block-style yaml sequence, so every class entry
+// starts a line with '-' at column zero and spans the indented lines below it.
+static QStringList splitIntrospectionDump(const QString & yamlString)
+{
+    QStringList chunks;
+    const int length = yamlString.length();
+    int chunkStart = -1;
+    int position = 0;
+
+    while (position < length) {
+        if (yamlString[position] == QChar('-')) {
+            if (chunkStart != -1)
+                chunks.append( yamlString.mid(chunkStart, position - chunkStart) );
+            chunkStart = position;
+        }
+        int lineEnd = yamlString.indexOf(QChar('\n'), position);
+        if (lineEnd == -1)
+            break;
+        position = lineEnd + 1;
+    }
+    if (chunkStart != -1)
+        chunks.append( yamlString.mid(chunkStart) );
+
+    return chunks;
+}
+
+bool Introspection::parse(const QString & yamlString, Introspection const * previous )
+{
+    clear();
+
+    QStringList chunks = splitIntrospectionDump(yamlString);
+    if (chunks.isEmpty()) {
+        MainWindow::instance()->showStatusMessage("no YAML document");
+        return false;
+    }
+
+    std::vector<PendingSuperclassLink> pendingLinks;
+    std::vector<Class*> clonedClasses;
+    pendingLinks.reserve(chunks.size());
+
+    try {
+        for (QString const & chunk : chunks)
+        {
+            // a chunk that is byte-identical to one from the previous dump
+            // describes a class whose files did not change since the last
+            // recompile; its parsed data is cloned instead of re-parsed.
+            // cloning (rather than sharing) keeps the previous snapshot
+            // untouched for anyone still reading it.
+            if (previous) {
+                QHash<QString, QSharedPointer<Class> >::const_iterator cached =
+                        previous->mChunkMap.constFind(chunk);
+                if (cached != previous->mChunkMap.constEnd()) {
+                    clonedClasses.push_back( cloneClass(*cached.value(), chunk) );
+                    continue;
+                }
+            }
+
+            const YAML::Node doc = YAML::Load( chunk.toStdString() );
+            if (!doc || !doc.IsSequence() || doc.size() != 1) {
+                // unexpected dump layout: fall back to one monolithic parse
+                clear();
+                return parseWholeDocument(yamlString);
+            }
+            parseClassNode(doc[0], chunk, pendingLinks);
+        }
+    } catch (YAML::Exception const &) {
+        clear();
+        return parseWholeDocument(yamlString);
+    }
+
+    for (PendingSuperclassLink const & pending : pendingLinks) {
+        ClassMap::iterator class_it = mClassMap.find(pending.metaClassName);
+        assert(class_it != mClassMap.end());
+        pending.klass->metaClass = class_it->second.data();
+
+        if (pending.superClassName.isNull())
+            pending.klass->superClass = 0;
+        else {
+            class_it = mClassMap.find(pending.superClassName);
+            assert(class_it != mClassMap.end());
+            pending.klass->superClass = class_it->second.data();
+        }
+    }
+
+    // cloned classes still point into the previous snapshot; relink them to
+    // this one (their meta or superclass may have been re-parsed)
+    for (Class * klass : clonedClasses) {
+        ClassMap::iterator class_it = mClassMap.find(klass->metaClass->name);
+        assert(class_it != mClassMap.end());
+        klass->metaClass = class_it->second.data();
+
+        if (klass->superClass) {
+            class_it = mClassMap.find(klass->superClass->name);
+            assert(class_it != mClassMap.end());
+            klass->superClass = class_it->second.data();
+        }
+    }
+
+    inferClassLibraryPath();
+
+    return true;
+}
+
+Class * Introspection::cloneClass(Class const & source, QString const & chunk)
+{
+    using std::make_pair;
+
+    Class * klass = new Class;
+    klass->name = source.name;
+    klass->definition = source.definition;
+    // pointers into the previous snapshot; only their names are read before
+    // the link pass in parse() replaces them
+    klass->metaClass = source.metaClass;
+    klass->superClass = source.superClass;
+
+    klass->methods.reserve(source.methods.size());
+    for (Method * sourceMethod : source.methods) {
+        Method * method = new Method(*sourceMethod);
+        method->ownerClass = klass;
+        klass->methods.append(method);
+        mMethodMap.insert(make_pair(method->name, QSharedPointer<Method>(method)));
+    }
+
+    QSharedPointer<Class> klassPtr(klass);
+    mClassMap.insert(make_pair(klass->name, klassPtr));
+    mChunkMap.insert(chunk, klassPtr);
+    return klass;
+}
+
+void Introspection::parseClassNode(const YAML::Node & node, QString const & chunk,
+                                   std::vector<PendingSuperclassLink> & pendingLinks)
+{
+    using std::make_pair;
+
+    QString name = node[0].as<std::string>().c_str();
+    Class *klass = new Class;
+    klass->name = name;
+    klass->metaClass = 0;
+    klass->superClass = 0;
+
+    QSharedPointer<Class> klassPtr(klass);
+    mClassMap.insert(make_pair(klass->name, klassPtr));
+    mChunkMap.insert(chunk, klassPtr);
+
+    PendingSuperclassLink pending;
+    pending.klass = klass;
+    pending.metaClassName = node[1].as<std::string>().c_str();
+    if (!node[2].IsNull())
+        pending.superClassName = node[2].as<std::string>().c_str();
+    pendingLinks.push_back(pending);
+
+    klass->definition.path = node[3].as<std::string>().c_str();
+    klass->definition.position = node[4].as<int>();
+
+    const YAML::Node &methodSeq = node[5];
+    if (methodSeq.Type() != YAML::NodeType::Sequence)
+        return;
+
+    for( const YAML::Node &methodNode : methodSeq )
+    {
+        assert(methodNode.Type() == YAML::NodeType::Sequence);
+        assert(methodNode.size() >= 2);
+
+        assert(methodNode[0].Type() == YAML::NodeType::Scalar);
+        assert(methodNode[1].Type() == YAML::NodeType::Scalar);
+
+        Method *method = new Method;
+        method->ownerClass = klass;
+        method->name = methodNode[1].as<std::string>().c_str();
+        method->definition.path = methodNode[2].as<std::string>().c_str();
+        method->definition.position = methodNode[3].as<int>();
+
+        const YAML::Node &argNode = methodNode[4];
+        assert(argNode.Type() == YAML::NodeType::Sequence);
+        auto arg = argNode.begin();
+        while (arg != argNode.end())
+        {
+            Argument argument;
+
+            // get arg name
+            assert(arg->Type() == YAML::NodeType::Scalar);
+            argument.name = arg->as<std::string>().c_str();
+
+            // get arg default value
+            ++arg;
+            if (arg == argNode.end())
+                break;
+            if(!arg->IsNull()) {
+                assert(arg->Type() == YAML::NodeType::Scalar);
+                argument.defaultValue = arg->as<std::string>().c_str();
+            }
+
+            method->arguments.append(argument);
+
+            // next arg
+            ++arg;
+        }
+
+        klass->methods.append(method);
+        mMethodMap.insert(make_pair(method->name, QSharedPointer<Method>(method)));
+    }
+
+    qSort(klass->methods.begin(), klass->methods.end(), [](Method * lhs, Method * rhs) {
+        return lhs->name.get() < rhs->name.get();
+    });
+}
+
+bool Introspection::parseWholeDocument(const QString & yamlString )
 {
     using std::make_pair;
 
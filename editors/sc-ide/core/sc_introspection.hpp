@@ -31,6 +31,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include <boost/flyweight.hpp>
 
@@ -40,6 +41,8 @@ static inline std::size_t hash_value(QString const& b)
     return qHash(b);
 }
 
+namespace YAML { class Node; }
+
 namespace ScIDE {
 namespace ScLanguage {
 
@@ -108,12 +111,14 @@ static inline QString makeFullMethodName(QString const & className, QString cons
     return ret;
 }
 
+struct PendingSuperclassLink;
+
 class Introspection
 {
 public:
     Introspection();
     Introspection( Introspection const & rhs) = default;
-    explicit Introspection( QString const & yamlString );
+    explicit Introspection( QString const & yamlString, Introspection const * previous = nullptr );
 
     Introspection & operator=( Introspection const & rhs) = default;
     Introspection & operator=( Introspection && rhs);
@@ -153,7 +158,11 @@ public:
 
 private:
     void initPaths();
-    bool parse(const QString & yamlString );
+    bool parse(const QString & yamlString, Introspection const * previous );
+    bool parseWholeDocument(const QString & yamlString );
+    void parseClassNode(const YAML::Node & node, QString const & chunk,
+                        std::vector<PendingSuperclassLink> & pendingLinks);
+    Class * cloneClass(Class const & source, QString const & chunk);
     void inferClassLibraryPath();
     bool ensureIntrospectionData() const;
 
@@ -161,11 +170,15 @@ private:
     {
         mClassMap.clear();
         mMethodMap.clear();
+        mChunkMap.clear();
         mClassLibraryPath.clear();
     }
 
     ClassMap mClassMap;
     MethodMap mMethodMap;
+    // maps the raw yaml of a class entry to its parsed class, to recognize
+    // unchanged classes in the next introspection dump
+    QHash<QString, QSharedPointer<Class> > mChunkMap;
     QString mClassLibraryPath;
     QString mUserExtensionDir;
     QString mSystemExtensionDir;
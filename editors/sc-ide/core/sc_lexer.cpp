@@ -38,39 +38,44 @@ void ScLexer::initLexicalRules()
 
     */
 
-    mLexicalRules << LexicalRule( Token::WhiteSpace, "^\\s+" );
+    mLexicalRules << LexicalRule( Token::WhiteSpace, "^\\s+", LexicalRule::SpaceChar );
 
     initKeywordsRules();
     initBuiltinsRules();
 
-    mLexicalRules << LexicalRule( Token::RadixFloat, "^\\b\\d+r[0-9a-zA-Z]*(\\.[0-9A-Z]*)?" );
+    mLexicalRules << LexicalRule( Token::RadixFloat, "^\\b\\d+r[0-9a-zA-Z]*(\\.[0-9A-Z]*)?",
+                                  LexicalRule::DigitChar );
 
     // do not include leading "-" in Float, as left-to-right algorithm does
     // not know whether it is not rather a binary operator
-    mLexicalRules << LexicalRule( Token::Float, "^\\b((\\d+(\\.\\d+)?([eE][-+]?\\d+)?(pi)?)|pi)\\b" );
+    mLexicalRules << LexicalRule( Token::Float, "^\\b((\\d+(\\.\\d+)?([eE][-+]?\\d+)?(pi)?)|pi)\\b",
+                                  LexicalRule::DigitChar, "p" );
 
-    mLexicalRules << LexicalRule( Token::HexInt, "^\\b0(x|X)(\\d|[a-f]|[A-F])+" );
+    mLexicalRules << LexicalRule( Token::HexInt, "^\\b0(x|X)(\\d|[a-f]|[A-F])+",
+                                  LexicalRule::DigitChar );
 
-    mLexicalRules << LexicalRule( Token::SymbolArg, "^\\b[A-Za-z_]\\w*\\:" );
+    mLexicalRules << LexicalRule( Token::SymbolArg, "^\\b[A-Za-z_]\\w*\\:",
+                                  LexicalRule::LowerChar | LexicalRule::UpperChar, "_" );
 
-    mLexicalRules << LexicalRule( Token::Name, "^[a-z]\\w*" );
+    mLexicalRules << LexicalRule( Token::Name, "^[a-z]\\w*", LexicalRule::LowerChar );
 
-    mLexicalRules << LexicalRule( Token::Class, "^\\b[A-Z]\\w*" );
+    mLexicalRules << LexicalRule( Token::Class, "^\\b[A-Z]\\w*", LexicalRule::UpperChar );
 
-    mLexicalRules << LexicalRule( Token::Primitive, "^\\b_\\w+" );
+    mLexicalRules << LexicalRule( Token::Primitive, "^\\b_\\w+", LexicalRule::NoClass, "_" );
 
-    mLexicalRules << LexicalRule( Token::Symbol, "^\\\\\\w*" );
+    mLexicalRules << LexicalRule( Token::Symbol, "^\\\\\\w*", LexicalRule::NoClass, "\\" );
 
-    mLexicalRules << LexicalRule( Token::Char, "^\\$\\\\?." );
+    mLexicalRules << LexicalRule( Token::Char, "^\\$\\\\?.", LexicalRule::NoClass, "$" );
 
-    mLexicalRules << LexicalRule( Token::EnvVar, "^~\\w+" );
+    mLexicalRules << LexicalRule( Token::EnvVar, "^~\\w+", LexicalRule::NoClass, "~" );
 
 
-    mLexicalRules << LexicalRule( Token::SingleLineComment, "^//[^\r\n]*" );
+    mLexicalRules << LexicalRule( Token::SingleLineComment, "^//[^\r\n]*", LexicalRule::NoClass, "/" );
 
-    mLexicalRules << LexicalRule( Token::MultiLineCommentStart, "^/\\*" );
+    mLexicalRules << LexicalRule( Token::MultiLineCommentStart, "^/\\*", LexicalRule::NoClass, "/" );
 
-    mLexicalRules << LexicalRule( Token::Operator, "^[\\+-\\*/&\\|\\^%<>=]+" );
+    mLexicalRules << LexicalRule( Token::Operator, "^[\\+-\\*/&\\|\\^%<>=]+",
+                                  LexicalRule::NoClass, "+-*/&|^%<>=" );
 }
 
 void ScLexer::initKeywordsRules()
@@ -84,7 +89,7 @@ void ScLexer::initKeywordsRules()
              << "var";
 
     QString keywordPattern = QStringLiteral("^\\b(%1)\\b").arg(keywords.join("|"));
-    mLexicalRules << LexicalRule(Token::Keyword, keywordPattern);
+    mLexicalRules << LexicalRule(Token::Keyword, keywordPattern, LexicalRule::LowerChar);
 }
 
 void ScLexer::initBuiltinsRules()
@@ -104,7 +109,7 @@ void ScLexer::initBuiltinsRules()
                 ;
 
     QString builtinsPattern = QStringLiteral("^\\b(%1)\\b").arg(builtins.join("|"));
-    mLexicalRules << LexicalRule(Token::Builtin, builtinsPattern);
+    mLexicalRules << LexicalRule(Token::Builtin, builtinsPattern, LexicalRule::LowerChar);
 }
 
 Token::Type ScLexer::nextToken ( int & lengthResult )
@@ -160,6 +165,8 @@ Token::Type ScLexer::nextTokenInCode( int & lengthResult )
 
         for (; it != end; ++it) {
             LexicalRule const & rule = *it;
+            if (!rule.canStartWith(currentChar))
+                continue;
             int matchIndex = rule.expr.indexIn(mText, mOffset, QRegExp::CaretAtOffset);
             // a guard to ensure all regexps match only at beginning of string:
             Q_ASSERT(matchIndex <= mOffset);
@@ -47,11 +47,34 @@ public:
 private:
     struct LexicalRule
     {
-        LexicalRule(): type(Token::Unknown) {}
-        LexicalRule( Token::Type t, const QString &s ): type(t), expr(s) {}
+        // character classes a rule's regexp can start matching at; checking
+        // them is much cheaper than running the regexp, so rules that cannot
+        // possibly match at the current offset are skipped entirely
+        enum StartClass {
+            NoClass    = 0,
+            SpaceChar  = 1,
+            DigitChar  = 2,
+            LowerChar  = 4,
+            UpperChar  = 8
+        };
+
+        LexicalRule(): type(Token::Unknown), startClasses(NoClass) {}
+        LexicalRule( Token::Type t, const QString &s, int classes, const QString & chars = QString() ):
+            type(t), expr(s), startClasses(classes), startChars(chars) {}
+
+        bool canStartWith( QChar c ) const
+        {
+            if ( (startClasses & SpaceChar) && c.isSpace() ) return true;
+            if ( (startClasses & DigitChar) && c.isDigit() ) return true;
+            if ( (startClasses & LowerChar) && c.isLower() ) return true;
+            if ( (startClasses & UpperChar) && c.isUpper() ) return true;
+            return startChars.contains(c);
+        }
 
         Token::Type type;
         QRegExp expr;
+        int startClasses;
+        QString startChars;
     };
 
     static void initKeywordsRules();
@@ -367,10 +367,12 @@ void ScProcess::onResponse( const QString & selector, const QString & data )
             watcher->deleteLater();
         });
 
-        // Start the computation.
-        QFuture<Introspection> future = QtConcurrent::run( [] (QString data) {
-            return ScLanguage::Introspection(data);
-        }, data );
+        // Start the computation. The current introspection is passed along as
+        // a shared snapshot, so classes whose files did not change since the
+        // last recompile are reused instead of re-parsed.
+        QFuture<Introspection> future = QtConcurrent::run( [] (QString data, Introspection previous) {
+            return ScLanguage::Introspection(data, &previous);
+        }, data, mIntrospection );
         watcher->setFuture(future);
     }
 
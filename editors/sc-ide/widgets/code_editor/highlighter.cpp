@@ -27,6 +27,7 @@
 #include "../../core/settings/theme.hpp"
 
 #include <QApplication>
+#include <QTimer>
 
 namespace ScIDE {
 
@@ -74,7 +75,44 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent):
 {
     mGlobals = SyntaxHighlighterGlobals::instance();
 
-    connect(mGlobals, SIGNAL(syntaxFormatsChanged()), this, SLOT(rehighlight()));
+    connect(mGlobals, SIGNAL(syntaxFormatsChanged()), this, SLOT(rehighlightChunked()));
+}
+
+void SyntaxHighlighter::rehighlightChunked()
+{
+    QTextDocument *doc = document();
+    if (!doc)
+        return;
+
+    // formats can only be applied on the GUI thread, so a bulk re-highlight
+    // cannot move to a worker; instead large documents are processed in
+    // event-loop sized chunks, keeping the editor responsive throughout
+    static const int chunkedRehighlightThreshold = 2000; // blocks
+
+    if (doc->blockCount() <= chunkedRehighlightThreshold) {
+        rehighlight();
+        return;
+    }
+
+    mPendingRehighlightBlock = doc->firstBlock();
+    QTimer::singleShot(0, this, SLOT(rehighlightNextChunk()));
+}
+
+void SyntaxHighlighter::rehighlightNextChunk()
+{
+    if (!document())
+        return;
+
+    static const int rehighlightChunkSize = 500; // blocks per event-loop pass
+
+    int remaining = rehighlightChunkSize;
+    while (mPendingRehighlightBlock.isValid() && remaining--) {
+        rehighlightBlock(mPendingRehighlightBlock);
+        mPendingRehighlightBlock = mPendingRehighlightBlock.next();
+    }
+
+    if (mPendingRehighlightBlock.isValid())
+        QTimer::singleShot(0, this, SLOT(rehighlightNextChunk()));
 }
 
 void SyntaxHighlighter::highlightBlockInCode(ScLexer & lexer)
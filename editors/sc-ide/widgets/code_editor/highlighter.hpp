@@ -24,6 +24,7 @@
 #include "../../core/sc_lexer.hpp"
 
 #include <QSyntaxHighlighter>
+#include <QTextBlock>
 #include <QVector>
 
 namespace ScIDE {
@@ -93,6 +94,12 @@ class SyntaxHighlighter:
 public:
     SyntaxHighlighter(QTextDocument *parent = 0);
 
+private Q_SLOTS:
+    // bulk re-highlights (theme or settings changes) are processed in chunks
+    // on the event loop, so a large document does not freeze the GUI thread
+    void rehighlightChunked();
+    void rehighlightNextChunk();
+
 private:
     void highlightBlock(const QString &text);
     void highlightBlockInCode(ScLexer & lexer);
@@ -101,6 +108,7 @@ private:
     void highlightBlockInComment(ScLexer & lexer);
 
     const SyntaxHighlighterGlobals *mGlobals;
+    QTextBlock mPendingRehighlightBlock;
 };
 
 }
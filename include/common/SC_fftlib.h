@@ -72,6 +72,11 @@ scfft * scfft_create(size_t fullsize, size_t winsize, SCFFT_WindowFunction winty
 void scfft_dofft(scfft *f);
 void scfft_doifft(scfft *f);
 
+// Batched versions of the above: perform "count" transforms in one call. Useful when a unit
+// owns several plans per block (stereo pairs, convolution partitions, PV chains).
+void scfft_dofft_batch(scfft **ffts, size_t count);
+void scfft_doifft_batch(scfft **ffts, size_t count);
+
 // destroy any resources held internally.
 void scfft_destroy(scfft *f, SCFFT_Allocator & alloc);
 
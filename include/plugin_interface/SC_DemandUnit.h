@@ -46,10 +46,21 @@ inline float DemandInput(Unit* unit, int index)
 
 inline float DemandInputA(Unit* unit, int index, int offset)
 {
-	Unit* fromUnit = unit->mInput[index]->mFromUnit;
+	Wire* wire = unit->mInput[index];
+	Unit* fromUnit = wire->mFromUnit;
 	if(!fromUnit) { return IN0(index); }
 	if (fromUnit->mCalcRate == calc_DemandRate) {
-		(fromUnit->mCalcFunc)(fromUnit, offset);
+		// a demand unit pulled by several consumers (a diamond in the demand
+		// graph) runs only once per sample position: later pulls at the same
+		// position reuse the value stamped on its output wires. resetting a
+		// unit clears the stamps (see ResetInput), so a re-pull after a
+		// child stream has ended and been reset evaluates again.
+		int64 stamp = ((int64)unit->mWorld->mBufCounter << 32) | (int64)offset;
+		if (wire->mDemandStamp != stamp) {
+			(fromUnit->mCalcFunc)(fromUnit, offset);
+			for (uint32 o = 0; o < fromUnit->mNumOutputs; ++o)
+				fromUnit->mOutput[o]->mDemandStamp = stamp;
+		}
 		return IN0(index);
 	} else if (fromUnit->mCalcRate == calc_FullRate) {
 		return IN(index)[offset - 1];
@@ -61,8 +72,12 @@ inline float DemandInputA(Unit* unit, int index, int offset)
 inline void ResetInput(Unit* unit, int index)
 {
 	Unit* fromUnit = unit->mInput[index]->mFromUnit;
-	if (fromUnit && fromUnit->mCalcRate == calc_DemandRate)
+	if (fromUnit && fromUnit->mCalcRate == calc_DemandRate) {
 		(fromUnit->mCalcFunc)(fromUnit, 0);
+		// the next pull after a reset must evaluate (see DemandInputA)
+		for (uint32 o = 0; o < fromUnit->mNumOutputs; ++o)
+			fromUnit->mOutput[o]->mDemandStamp = -1;
+	}
 }
 
 #define ISDEMANDINPUT(index) IsDemandInput(unit, (index))
@@ -25,6 +25,17 @@
 #include "SC_Rate.h"
 #include "SC_SndBuf.h"
 
+// how many distinct input bus ranges a graph tracks for auto-bypass
+const int32 kGraphMaxWatchedInputs = 8;
+
+// per calc unit timing accumulators, allocated while /n_profile is active
+struct UnitProfile
+{
+	double mTotalSeconds;
+	float mPeakSeconds;
+};
+typedef struct UnitProfile UnitProfile;
+
 struct Graph
 {
 	Node mNode;
@@ -36,6 +47,11 @@ struct Graph
 	float *mControls;
 	float **mMapControls;
 
+	// per-block snapshot of all control values. mMapControls is dereferenced
+	// once per graph per block into this contiguous array, so control units
+	// read sequentially instead of chasing one pointer per channel.
+	float *mControlSnapshot;
+
 	// try this for setting the rate of a control
 	int *mControlRates;
 
@@ -56,7 +72,52 @@ struct Graph
 	SndBuf *mLocalSndBufs;
 	int localBufNum;
 	int localMaxBufNum;
+
+	struct UnitProfile *mProfile; // non-zero while profiling is enabled
+	int mProfileTicks;
+
+	// index of the dsp thread currently running this graph. always 0 in
+	// scsynth; in supernova the queue interpreter stores it before each run,
+	// so bus writers can address their thread's shadow busses.
+	int32 mDspThreadIndex;
+
+	int mControlBatchSize; // >1: control-rate units run every Nth block (see Graph_CalcBatched)
+	int mControlBatchPhase;
+
+	// auto-bypass state (/n_run with run == 2). audio input units record the
+	// bus ranges they read as (bus, numChannels) pairs; Graph_CalcAuto skips
+	// the whole graph once those buses have stayed untouched long enough.
+	// mNumWatchedInputs == -1 means too many distinct inputs to track: the
+	// graph then always runs.
+	int32 mWatchedInputs[2 * kGraphMaxWatchedInputs];
+	int32 mNumWatchedInputs;
+	int32 mQuietBlocks;
+	bool mAutoBypass;
+	bool mBypassed;
 };
 typedef struct Graph Graph;
 
+// called by audio input units when their bus selection settles or changes,
+// to tell an auto-bypassed graph which touched-epochs to probe.
+inline void Graph_WatchAudioInput(Graph *inGraph, int32 inBus, int32 inNumChannels)
+{
+	if (!inGraph->mAutoBypass || inGraph->mNumWatchedInputs < 0)
+		return;
+	int32 *watch = inGraph->mWatchedInputs;
+	for (int32 i = 0; i < inGraph->mNumWatchedInputs; ++i) {
+		if (watch[2*i] == inBus) {
+			if (watch[2*i+1] < inNumChannels)
+				watch[2*i+1] = inNumChannels;
+			return;
+		}
+	}
+	if (inGraph->mNumWatchedInputs == kGraphMaxWatchedInputs) {
+		inGraph->mNumWatchedInputs = -1; // give up; never bypass
+		return;
+	}
+	watch[2 * inGraph->mNumWatchedInputs] = inBus;
+	watch[2 * inGraph->mNumWatchedInputs + 1] = inNumChannels;
+	inGraph->mNumWatchedInputs++;
+}
+
 #endif
@@ -221,6 +221,19 @@ inline float32 sc_softclip(float32 x)
 	else return (absx - (float32)0.25) / x;
 }
 
+// rational (Pade) approximation of tanh for the fast-math server mode.
+// |error| < 1e-4 everywhere; the input is clamped where the approximant
+// reaches +-1 (about 4.9717) so large arguments saturate exactly instead of
+// diverging. branch-free, so the compiler can vectorize the sample loop.
+inline float32 sc_tanh_fast(float32 x)
+{
+	x = x < (float32)-4.9717 ? (float32)-4.9717 : (x > (float32)4.9717 ? (float32)4.9717 : x);
+	float32 x2 = x * x;
+	float32 num = x * ((float32)135135. + x2 * ((float32)17325. + x2 * ((float32)378. + x2)));
+	float32 den = (float32)135135. + x2 * ((float32)62370. + x2 * ((float32)3150. + (float32)28. * x2));
+	return num / den;
+}
+
 // Taylor expansion out to x**9/9! factored  into multiply-adds
 // from Phil Burk.
 inline float32 taylorsin(float32 x)
@@ -486,6 +499,15 @@ inline float64 sc_softclip(float64 x)
 	else return (absx - (float64)0.25) / x;
 }
 
+inline float64 sc_tanh_fast(float64 x)
+{
+	x = x < (float64)-4.9717 ? (float64)-4.9717 : (x > (float64)4.9717 ? (float64)4.9717 : x);
+	float64 x2 = x * x;
+	float64 num = x * ((float64)135135. + x2 * ((float64)17325. + x2 * ((float64)378. + x2)));
+	float64 den = (float64)135135. + x2 * ((float64)62370. + x2 * ((float64)3150. + (float64)28. * x2));
+	return num / den;
+}
+
 // Taylor expansion out to x**9/9! factored  into multiply-adds
 // from Phil Burk.
 inline float64 taylorsin(float64 x)
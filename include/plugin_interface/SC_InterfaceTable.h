@@ -21,7 +21,9 @@
 #ifndef _SC_SynthInterfaceTable_
 #define _SC_SynthInterfaceTable_
 
-static const int sc_api_version = 2;
+// bumped to 3: Node/Wire/World/InterfaceTable layouts changed, so plugins
+// compiled against older headers must be refused
+static const int sc_api_version = 3;
 
 #include "SC_Types.h"
 #include "SC_SndBuf.h"
@@ -160,11 +162,50 @@ struct InterfaceTable
 	bool (*fGetScopeBuffer)(World *inWorld, int index, int channels, int maxFrames, ScopeBufferHnd &);
 	void (*fPushScopeBuffer)(World *inWorld, ScopeBufferHnd &, int frames);
 	void (*fReleaseScopeBuffer)(World *inWorld, ScopeBufferHnd &);
+
+	// Batched FFT transforms, see SC_fftlib.h
+	void (*fSCfftDoFFTBatch)(struct scfft **ffts, size_t count);
+	void (*fSCfftDoIFFTBatch)(struct scfft **ffts, size_t count);
+
+	// real time safe printing. unlike fPrint this never blocks on stdio:
+	// the message is formatted into a preallocated slot and printed from the
+	// non real time thread. messages are truncated to a few hundred bytes
+	// and may be dropped when the queue is full (returns -1 in that case).
+	// safe to call from calc functions and unit constructors.
+	int (*fRTPrint)(World *inWorld, const char *fmt, ...);
+
+	// shared read-only analysis data (/ad_load): look up a named float array
+	// in a named segment. every unit instance gets a pointer into the same
+	// mapped pages, so large constant tables exist once per server. returns
+	// 0 when the segment or entry is absent; the pointer stays valid until
+	// the segment is freed or replaced. safe to call from unit constructors.
+	const float * (*fGetAnalysisData)(World *inWorld, const char *inSegmentName,
+			const char *inEntryName, uint32 *outNumFloats);
+
+	// seed an RGen owned by the unit as a pure function of
+	// (world seed, node id, unit index). A unit-local generator avoids the
+	// contention of the shared world generators under parallel dsp, and
+	// makes non real time renders bit-reproducible. call from the unit
+	// constructor.
+	void (*fInitUnitRGen)(struct Unit *inUnit, struct RGen *inRGen);
+
+	// per-thread block scratch: bump-allocate a transient workspace that is
+	// implicitly reclaimed at the start of the next block. much cheaper than
+	// an RTAlloc/RTFree pair per calc call, and the arena exists once per
+	// dsp thread rather than once per unit. pointers are only valid until
+	// the end of the current block and must never be freed. returns 0 when
+	// the arena is exhausted; fall back to RTAlloc in that case. call from
+	// calc functions only (unit constructors should use RTAlloc).
+	void* (*fScratchAlloc)(struct World *inWorld, size_t inNumBytes);
 };
 
 typedef struct InterfaceTable InterfaceTable;
 
 #define Print (*ft->fPrint)
+#define RTPrint (*ft->fRTPrint)
+#define GetAnalysisData (*ft->fGetAnalysisData)
+#define InitUnitRGen (*ft->fInitUnitRGen)
+#define ScratchAlloc (*ft->fScratchAlloc)
 #define RanSeed (*ft->fRanSeed)
 #define NodeEnd (*ft->fNodeEnd)
 #define NodeRun (*ft->fNodeRun)
@@ -238,6 +279,8 @@ typedef enum {
 #define scfft_create (*ft->fSCfftCreate)
 #define scfft_dofft (*ft->fSCfftDoFFT)
 #define scfft_doifft (*ft->fSCfftDoIFFT)
+#define scfft_dofft_batch (*ft->fSCfftDoFFTBatch)
+#define scfft_doifft_batch (*ft->fSCfftDoIFFTBatch)
 #define scfft_destroy (*ft->fSCfftDestroy)
 
 
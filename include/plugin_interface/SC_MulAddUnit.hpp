@@ -0,0 +1,207 @@
+/*
+ *    SuperCollider real time audio synthesis system
+ *    Copyright (c) 2002 James McCartney. All rights reserved.
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef SC_MULADDUNIT_HPP
+#define SC_MULADDUNIT_HPP
+
+#include "SC_PlugIn.hpp"
+
+/* compile-time specialized mul/add processing
+ *
+ * A UGen with mul/add inputs would otherwise either branch per block on the
+ * input rates inside its calc function, or hand-write a calc function per
+ * (mul rate x add rate) combination. MulAddUnit instantiates the whole
+ * matrix from a single calc function template and selects the right
+ * instance once, at construction time:
+ *
+ *   struct MyOsc:
+ *       public MulAddUnit
+ *   {
+ *       MyOsc(void)
+ *       {
+ *           set_muladd_calc_function<MyOsc>(1, 2); // inputs carrying mul and add
+ *       }
+ *
+ *       template <typename MulAdd>
+ *       void next(int inNumSamples, MulAdd & muladd)
+ *       {
+ *           float * outBuf = out(0);
+ *           for (int i = 0; i != inNumSamples; ++i)
+ *               outBuf[i] = muladd.consume( computeSample() );
+ *       }
+ *   };
+ *
+ * Each instantiation carries its mul/add terms as the signal wrapper types
+ * from SCUnit, so the inner loop is free of per-sample dispatch; constant
+ * identity arguments (mul: 1, add: 0) compile to no work at all. Control
+ * rate arguments are slope-interpolated over the block.
+ */
+
+enum MulAddRate
+{
+	kMulAddNone,
+	kMulAddScalar,
+	kMulAddAudio
+};
+
+namespace detail {
+
+/** placeholder for an absent mul or add input */
+struct NoSignal
+{};
+
+template <MulAddRate Rate>
+struct MulAddRateTag
+{};
+
+template <MulAddRate Rate> struct MulAddSignalType;
+template <> struct MulAddSignalType<kMulAddNone>   { typedef NoSignal type;                    };
+template <> struct MulAddSignalType<kMulAddScalar> { typedef SCUnit::SlopeSignal<float> type;  };
+template <> struct MulAddSignalType<kMulAddAudio>  { typedef SCUnit::AudioSignal<float> type;  };
+
+inline float applyMul(float sample, NoSignal &)
+{
+	return sample;
+}
+
+template <typename SignalType>
+inline float applyMul(float sample, SignalType & mul)
+{
+	return sample * mul.consume();
+}
+
+inline float applyAdd(float sample, NoSignal &)
+{
+	return sample;
+}
+
+template <typename SignalType>
+inline float applyAdd(float sample, SignalType & add)
+{
+	return sample + add.consume();
+}
+
+} /* namespace detail */
+
+
+class MulAddUnit:
+	public SCUnit
+{
+public:
+	/// mul/add term of one calc function instance. consume() maps a raw sample to the scaled sample
+	template <typename MulSignal, typename AddSignal>
+	struct MulAddOperator
+	{
+		MulAddOperator(MulSignal const & mul, AddSignal const & add):
+			mul(mul), add(add)
+		{}
+
+		float consume(float sample)
+		{
+			return detail::applyAdd(detail::applyMul(sample, mul), add);
+		}
+
+		MulSignal mul;
+		AddSignal add;
+	};
+
+	/** classify an input for the mul/add matrix. a missing input or a
+	 *  scalar-rate identity argument requires no work at all */
+	MulAddRate muladdRate(int index, float identity) const
+	{
+		if (index >= numInputs())
+			return kMulAddNone;
+		if (isAudioRateIn(index))
+			return kMulAddAudio;
+		if (isScalarRateIn(index) && in0(index) == identity)
+			return kMulAddNone;
+		return kMulAddScalar;
+	}
+
+	/** examine the rates of the mul and add inputs, install the matching
+	 *  instantiation of UnitType::next & compute initial sample */
+	template <typename UnitType>
+	void set_muladd_calc_function(int mulIndex, int addIndex)
+	{
+		mMulIndex = mulIndex;
+		mAddIndex = addIndex;
+		mPrevMul = (mulIndex < numInputs()) ? in0(mulIndex) : 1.f;
+		mPrevAdd = (addIndex < numInputs()) ? in0(addIndex) : 0.f;
+
+		mCalcFunc = selectMulAddCalcFunction<UnitType>(muladdRate(mulIndex, 1.f),
+													   muladdRate(addIndex, 0.f));
+		(mCalcFunc)(this, 1);
+	}
+
+private:
+	detail::NoSignal makeMulAddSignal(detail::MulAddRateTag<kMulAddNone>, int, float &) const
+	{
+		return detail::NoSignal();
+	}
+
+	SlopeSignal<float> makeMulAddSignal(detail::MulAddRateTag<kMulAddScalar>, int index, float & prev)
+	{
+		float next = in0(index);
+		SlopeSignal<float> signal = makeSlope(next, prev);
+		prev = next;
+		return signal;
+	}
+
+	AudioSignal<float> makeMulAddSignal(detail::MulAddRateTag<kMulAddAudio>, int index, float &) const
+	{
+		return makeSignal(index);
+	}
+
+	template <typename UnitType, MulAddRate MulRate, MulAddRate AddRate>
+	HOT static void run_muladd_calc(struct Unit * unit, int inNumSamples)
+	{
+		UnitType * realUnit = static_cast<UnitType*>(unit);
+
+		MulAddOperator<typename detail::MulAddSignalType<MulRate>::type,
+					   typename detail::MulAddSignalType<AddRate>::type>
+			muladd(realUnit->makeMulAddSignal(detail::MulAddRateTag<MulRate>(), realUnit->mMulIndex, realUnit->mPrevMul),
+				   realUnit->makeMulAddSignal(detail::MulAddRateTag<AddRate>(), realUnit->mAddIndex, realUnit->mPrevAdd));
+
+		realUnit->next(inNumSamples, muladd);
+	}
+
+	template <typename UnitType>
+	static UnitCalcFunc selectMulAddCalcFunction(MulAddRate mulRate, MulAddRate addRate)
+	{
+		switch (mulRate * 3 + addRate) {
+		case kMulAddNone   * 3 + kMulAddNone:	return &run_muladd_calc<UnitType, kMulAddNone,   kMulAddNone>;
+		case kMulAddNone   * 3 + kMulAddScalar:	return &run_muladd_calc<UnitType, kMulAddNone,   kMulAddScalar>;
+		case kMulAddNone   * 3 + kMulAddAudio:	return &run_muladd_calc<UnitType, kMulAddNone,   kMulAddAudio>;
+		case kMulAddScalar * 3 + kMulAddNone:	return &run_muladd_calc<UnitType, kMulAddScalar, kMulAddNone>;
+		case kMulAddScalar * 3 + kMulAddScalar:	return &run_muladd_calc<UnitType, kMulAddScalar, kMulAddScalar>;
+		case kMulAddScalar * 3 + kMulAddAudio:	return &run_muladd_calc<UnitType, kMulAddScalar, kMulAddAudio>;
+		case kMulAddAudio  * 3 + kMulAddNone:	return &run_muladd_calc<UnitType, kMulAddAudio,  kMulAddNone>;
+		case kMulAddAudio  * 3 + kMulAddScalar:	return &run_muladd_calc<UnitType, kMulAddAudio,  kMulAddScalar>;
+		default:								return &run_muladd_calc<UnitType, kMulAddAudio,  kMulAddAudio>;
+		}
+	}
+
+	int mMulIndex = 0;
+	int mAddIndex = 0;
+	float mPrevMul = 1.f;
+	float mPrevAdd = 0.f;
+};
+
+
+#endif /* SC_MULADDUNIT_HPP */
@@ -26,19 +26,23 @@
 
 typedef void (*NodeCalcFunc)(struct Node *inNode);
 
+// field order is deliberate: the scheduler's traversal loop only reads
+// mCalcFunc and mNext, so the hot link/calc fields lead the struct and the
+// first 32 bytes land in one cache line per node (the RT pool hands out
+// 64-byte-aligned chunks with a 32-byte header). bookkeeping fields that
+// are only touched when nodes are created, freed or addressed follow.
 struct Node
 {
+	NodeCalcFunc mCalcFunc;
+	struct Node *mNext, *mPrev;
+	struct Group *mParent;
+
 	int32 mID;
 	int32 mHash;
+	int32 mIsGroup;
 
 	struct World *mWorld;
 	struct NodeDef *mDef;
-	NodeCalcFunc mCalcFunc;
-
-	struct Node *mPrev, *mNext;
-	struct Group *mParent;
-
-	int32 mIsGroup;
 };
 typedef struct Node Node;
 
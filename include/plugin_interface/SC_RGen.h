@@ -58,6 +58,7 @@
 struct RGen
 {
 	void init(uint32 seed);
+	void init_stream(uint32 seed, uint32 stream1, uint32 stream2);
 
 	uint32 trand();
 
@@ -98,6 +99,20 @@ inline void RGen::init(uint32 seed)
 	s3 = 1821928721U ^ seed; if (s3 < 16) s3 = 1821928721U;
 }
 
+inline void RGen::init_stream(uint32 seed, uint32 stream1, uint32 stream2)
+{
+	// seed one of many independent streams, as a pure function of
+	// (seed, stream1, stream2). Each component gets its own hash chain so
+	// streams with neighbouring coordinates are decorrelated.
+	uint32 h1 = (uint32)Hash((int)(seed ^ stream1));
+	uint32 h2 = (uint32)Hash((int)(h1 ^ stream2));
+	uint32 h3 = (uint32)Hash((int)(h2 ^ 0x9e3779b9U));
+
+	s1 = 1243598713U ^ h1; if (s1 <  2) s1 = 1243598713U;
+	s2 = 3093459404U ^ h2; if (s2 <  8) s2 = 3093459404U;
+	s3 = 1821928721U ^ h3; if (s3 < 16) s3 = 1821928721U;
+}
+
 inline uint32 trand( uint32& s1, uint32& s2, uint32& s3 )
 {
 	// This function is provided for speed in inner loops where the
@@ -306,6 +321,97 @@ inline float fcoin( uint32& s1, uint32& s2, uint32& s3 )
 }
 
 
+//----------------------------------------------------------------------------//
+// RGen4: four independent taus88 streams advanced in lockstep.
+//----------------------------------------------------------------------------//
+//
+// The state is laid out structure-of-arrays so optimizing compilers can turn
+// the lane loop in trand() into SSE2/NEON integer code. Consecutive variates
+// of a single taus88 stream depend serially on each other, so sample loops
+// built on RGen cannot be vectorized; four lockstep lanes can. Lanes are
+// decorrelated by seeding each from a separate draw of the seeding generator,
+// so a unit seeded from its graph's RGen stays deterministic for a given
+// graph seed.
+
+struct RGen4
+{
+	void init(RGen & seeder);
+
+	void trand(uint32 out[4]);
+	void frand(float out[4]);	// [ 0.0, 1.0)
+	void frand2(float out[4]);	// [-1.0, 1.0)
+	void frand8(float out[4]);	// [-0.125, 0.125)
+	void fcoin(float out[4]);	// -1.0 or +1.0
+
+	uint32 s1[4], s2[4], s3[4];	// random generator state, one slot per lane
+};
+
+inline void RGen4::init(RGen & seeder)
+{
+	for (int i=0; i<4; ++i) {
+		// same state requirements as RGen::init; the seeds are already well
+		// mixed, so no extra hashing is needed
+		uint32 seed = seeder.trand();
+		s1[i] = 1243598713U ^ seed; if (s1[i] <  2) s1[i] = 1243598713U;
+		s2[i] = 3093459404U ^ seed; if (s2[i] <  8) s2[i] = 3093459404U;
+		s3[i] = 1821928721U ^ seed; if (s3[i] < 16) s3[i] = 1821928721U;
+	}
+}
+
+inline void RGen4::trand(uint32 out[4])
+{
+	for (int i=0; i<4; ++i) {
+		s1[i] = ((s1[i] &  (uint32)-2) << 12) ^ (((s1[i] << 13) ^ s1[i]) >> 19);
+		s2[i] = ((s2[i] &  (uint32)-8) <<  4) ^ (((s2[i] <<  2) ^ s2[i]) >> 25);
+		s3[i] = ((s3[i] & (uint32)-16) << 17) ^ (((s3[i] <<  3) ^ s3[i]) >> 11);
+		out[i] = s1[i] ^ s2[i] ^ s3[i];
+	}
+}
+
+inline void RGen4::frand(float out[4])
+{
+	uint32 r[4];
+	trand(r);
+	for (int i=0; i<4; ++i) {
+		union { uint32 i; float f; } u;
+		u.i = 0x3F800000 | (r[i] >> 9);
+		out[i] = u.f - 1.f;
+	}
+}
+
+inline void RGen4::frand2(float out[4])
+{
+	uint32 r[4];
+	trand(r);
+	for (int i=0; i<4; ++i) {
+		union { uint32 i; float f; } u;
+		u.i = 0x40000000 | (r[i] >> 9);
+		out[i] = u.f - 3.f;
+	}
+}
+
+inline void RGen4::frand8(float out[4])
+{
+	uint32 r[4];
+	trand(r);
+	for (int i=0; i<4; ++i) {
+		union { uint32 i; float f; } u;
+		u.i = 0x3E800000 | (r[i] >> 9);
+		out[i] = u.f - 0.375f;
+	}
+}
+
+inline void RGen4::fcoin(float out[4])
+{
+	uint32 r[4];
+	trand(r);
+	for (int i=0; i<4; ++i) {
+		union { uint32 i; float f; } u;
+		u.i = 0x3F800000 | (0x80000000 & r[i]);
+		out[i] = u.f;
+	}
+}
+
 
 #endif
 
@@ -56,7 +56,14 @@ struct Unit
 typedef struct Unit Unit;
 
 enum {
-	kUnitDef_CantAliasInputsToOutputs = 1
+	kUnitDef_CantAliasInputsToOutputs = 1,
+	// the unit's ctor can handle N parallel instances of itself collapsed
+	// into a single unit: ports are concatenated instance-major (all ports
+	// of instance 0, then instance 1, ...), so the ctor derives N from
+	// mNumOutputs and its own per-instance output count. the memory after
+	// the Unit-derived struct holds N-1 further copies of the per-instance
+	// state. see GraphDef_VectorizeUnits in scsynth.
+	kUnitDef_Vectorizable = 2
 };
 
 #ifdef _WIN32
@@ -347,6 +354,18 @@ struct buffer_lock
 	rgen.s2 = s2; \
 	rgen.s3 = s3;
 
+// variant for units owning their generator: declare `RGen mRGen;` in the
+// unit struct and seed it in the constructor with
+// InitUnitRGen(unit, &unit->mRGen). unlike the world generators, a
+// unit-local stream is free of sharing between units (data races under
+// parallel dsp) and is reproducible in non real time renders. RPUT works
+// for both variants.
+#define RGET_UNIT \
+	RGen& rgen = unit->mRGen; \
+	uint32 s1 = rgen.s1; \
+	uint32 s2 = rgen.s2; \
+	uint32 s3 = rgen.s3;
+
 typedef void (*UnitCmdFunc)(struct Unit *unit, struct sc_msg_iter *args);
 typedef void (*PlugInCmdFunc)(World *inWorld, void* inUserData, struct sc_msg_iter *args, void *replyAddr);
 
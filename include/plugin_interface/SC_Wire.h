@@ -30,6 +30,7 @@ struct Wire
 	int32 mCalcRate;
 	float32 *mBuffer;
 	float32 mScalarValue;
+	int64 mDemandStamp;	// position of the last demand pull that filled this wire (see SC_DemandUnit.h)
 };
 typedef struct Wire Wire;
 
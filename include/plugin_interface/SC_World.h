@@ -63,6 +63,10 @@ struct World
 	// these tell if a bus has been written to during a control period
 	// if the value is equal to mBufCounter then the buss has been touched
 	// this control period.
+	// a bus with a stale epoch is logically zero: readers (the In family,
+	// the driver output paths) must treat its contents as silence and never
+	// rely on the memory itself being cleared. nothing memsets bus memory
+	// per callback -- writers bump the epoch, readers compare it.
 	int32 *mAudioBusTouched;
 	int32 *mControlBusTouched;
 
@@ -102,9 +106,22 @@ struct World
 
 	const char* mRestrictedPath; // OSC commands to read/write data can only do it within this path, if specified
 
+	bool mFastMath; // unary saturation ops (tanh) use bounded-error approximations instead of libm
+
+	uint32 mRandSeed; // base seed for per-unit random streams (see InitUnitRGen); fixed in NRT mode
+
 #ifdef SUPERNOVA
 	nova::padded_rw_spinlock * mAudioBusLocks;
 	nova::spin_lock * mControlBusLock;
+
+	// accumulate-and-combine bus mixing (--bus-shadows): when mAudioBusShadows
+	// is non-null, audio-rate bus writers mix into a per-dsp-thread shadow of
+	// the bus instead of serializing on its write lock. a shadow holds data
+	// for the current block when its tag equals mBufCounter; readers fold
+	// pending shadows into the bus before locking it.
+	float *mAudioBusShadows;       // [thread][channel][frame]
+	int32 *mAudioBusShadowTouched; // [thread][channel]
+	uint32 mNumDspThreads;
 #endif
 };
 
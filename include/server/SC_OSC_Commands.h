@@ -112,7 +112,32 @@ enum {
 
 	cmd_version = 64,
 
-	NUMBER_OF_COMMANDS = 65
+	cmd_s_newBundle = 65,
+
+	cmd_n_profile = 66,
+
+	cmd_b_setb = 67,
+	cmd_b_getb = 68,
+
+	cmd_c_allocRange = 69,
+	cmd_c_freeRange = 70,
+	cmd_a_allocRange = 71,
+	cmd_a_freeRange = 72,
+
+	cmd_b_peaks = 73,
+	cmd_b_getPeaks = 74,
+	cmd_b_allocReadResample = 75,
+	cmd_d_recvSHM = 76,
+
+	cmd_ad_load = 77,
+	cmd_ad_free = 78,
+
+	cmd_n_move = 79,
+
+	cmd_rtap_start = 80,
+	cmd_rtap_stop = 81,
+
+	NUMBER_OF_COMMANDS = 82
 };
 
 #endif /* _SC_OSC_Commands_ */
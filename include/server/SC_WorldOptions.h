@@ -78,6 +78,33 @@ struct WorldOptions
 	const char *mRestrictedPath;
 
 	int mSharedMemoryID;
+
+	bool mSharedMemoryMetering;
+
+	uint32 mControlBatchSize;
+
+	const char *mOscJournalFilename;
+
+	uint32 mNumParallelWorkers;
+	bool mSharedBufCache;
+
+	// unary saturation ops (tanh) use bounded-error rational approximations
+	// instead of libm
+	bool mFastMath;
+
+	// back the real time pool with TLSF (O(1) bounded alloc/free) instead of
+	// the binned free list allocator
+	bool mTLSFMemory;
+
+	// back the real time pool and the bus memory with explicit hugepages and
+	// lock them in core: fewer TLB misses on large working sets, and paging
+	// can never stall the audio thread. falls back step by step (transparent
+	// hugepages, then plain allocation) when the system has none configured.
+	bool mHugePages;
+
+	// scrub NaN/Inf/denormal samples from the hardware output buses once per
+	// block, replacing them with zero
+	bool mSanitizeOutputs;
 };
 
 const struct WorldOptions kDefaultWorldOptions =
@@ -96,6 +123,15 @@ const struct WorldOptions kDefaultWorldOptions =
 	,0
 	,0
 	,0
+	,false
+	,1
+	,0
+	,0
+	,false
+	,false
+	,false
+	,false
+	,false
 };
 
 struct SndBuf;
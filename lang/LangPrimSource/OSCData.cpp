@@ -28,6 +28,8 @@
 #include <math.h>
 #include <stdexcept>
 #include <new>
+#include <map>
+#include <utility>
 #include <vector>
 #include <iostream>
 
@@ -92,11 +94,44 @@ const int ivxNetAddr_PortID = 1;
 const int ivxNetAddr_Hostname = 2;
 const int ivxNetAddr_Socket = 3;
 
-static int makeSynthMsgWithTags(big_scpacket *packet, PyrSlot *slots, int size);
+// the builders are templated over the packet type: message construction is
+// shared between the stack based scpacket (small replies, size queries) and
+// pooled_scpacket (the send paths, built in pooled segments and sent with a
+// gathering write instead of through a ~64KB stack buffer)
+template <typename Packet>
+static int makeSynthMsgWithTags(Packet *packet, PyrSlot *slots, int size);
+
+template <typename Packet>
+int makeSynthBundle(Packet *packet, PyrSlot *slots, int size, bool useElapsed);
+
+// encode a nested message or bundle as a blob directly into the enclosing
+// packet, instead of through a scratch packet that is copied in afterwards.
+// the enclosing message's write state is saved around the nested encode,
+// since the nested message manages its own tags and size words.
+template <typename Packet>
+static int addNestedMsgBlob(Packet *packet, PyrObject *arrayObj)
+{
+	typename Packet::blobref sizepos = packet->OpenBlob();
+	typename Packet::msgstate saved = packet->save_msg_state();
+	packet->inbundle = 0;
 
-int makeSynthBundle(big_scpacket *packet, PyrSlot *slots, int size, bool useElapsed);
+	int error;
+	if (arrayObj->size > 1 && isKindOfSlot(arrayObj->slots+1, class_array)) {
+		error = makeSynthBundle(packet, arrayObj->slots, arrayObj->size, true);
+	} else {
+		error = makeSynthMsgWithTags(packet, arrayObj->slots, arrayObj->size);
+	}
 
-static int addMsgSlot(big_scpacket *packet, PyrSlot *slot)
+	packet->restore_msg_state(saved);
+	if (error != errNone)
+		return error;
+
+	packet->CloseBlob(sizepos);
+	return errNone;
+}
+
+template <typename Packet>
+static int addMsgSlot(Packet *packet, PyrSlot *slot)
 {
 	switch (GetTag(slot)) {
 		case tagInt :
@@ -113,16 +148,9 @@ static int addMsgSlot(big_scpacket *packet, PyrSlot *slot)
 				PyrInt8Array *arrayObj = slotRawInt8Array(slot);
 				packet->addb(arrayObj->b, arrayObj->size);
 			} else if (isKindOf(slotRawObject(slot), class_array)) {
-				PyrObject *arrayObj = slotRawObject(slot);
-				big_scpacket packet2;
-				if (arrayObj->size > 1 && isKindOfSlot(arrayObj->slots+1, class_array)) {
-					makeSynthBundle(&packet2, arrayObj->slots, arrayObj->size, true);
-				} else {
-					int error = makeSynthMsgWithTags(&packet2, arrayObj->slots, arrayObj->size);
-					if (error != errNone)
-						return error;
-				}
-				packet->addb((uint8*)packet2.data(), packet2.size());
+				int error = addNestedMsgBlob(packet, slotRawObject(slot));
+				if (error != errNone)
+					return error;
 			}
 			break;
 		case tagNil :
@@ -139,7 +167,8 @@ static int addMsgSlot(big_scpacket *packet, PyrSlot *slot)
 	return errNone;
 }
 
-static int addMsgSlotWithTags(big_scpacket *packet, PyrSlot *slot)
+template <typename Packet>
+static int addMsgSlotWithTags(Packet *packet, PyrSlot *slot)
 {
 	switch (GetTag(slot)) {
 		case tagInt :
@@ -163,15 +192,9 @@ static int addMsgSlotWithTags(big_scpacket *packet, PyrSlot *slot)
 				PyrObject *arrayObj = slotRawObject(slot);
 				if (arrayObj->size) {
 					packet->addtag('b');
-					big_scpacket packet2;
-					if (arrayObj->size > 1 && isKindOfSlot(arrayObj->slots+1, class_array)) {
-						makeSynthBundle(&packet2, arrayObj->slots, arrayObj->size, true);
-					} else {
-						int error = makeSynthMsgWithTags(&packet2, arrayObj->slots, arrayObj->size);
-						if (error != errNone)
-							return error;
-					}
-					packet->addb((uint8*)packet2.data(), packet2.size());
+					int error = addNestedMsgBlob(packet, arrayObj);
+					if (error != errNone)
+						return error;
 				} else {
 					packet->addtag('i');
 					packet->addi(0);
@@ -204,7 +227,8 @@ static int addMsgSlotWithTags(big_scpacket *packet, PyrSlot *slot)
 	return errNone;
 }
 
-static int makeSynthMsgWithTags(big_scpacket *packet, PyrSlot *slots, int size)
+template <typename Packet>
+static int makeSynthMsgWithTags(Packet *packet, PyrSlot *slots, int size)
 {
 	packet->BeginMsg();
 
@@ -262,7 +286,8 @@ static void localServerReplyFunc(struct ReplyAddress *inReplyAddr, char* inBuf,
 
 }
 
-int makeSynthBundle(big_scpacket *packet, PyrSlot *slots, int size, bool useElapsed)
+template <typename Packet>
+int makeSynthBundle(Packet *packet, PyrSlot *slots, int size, bool useElapsed)
 {
 	double time;
 	int err;
@@ -292,10 +317,19 @@ int makeSynthBundle(big_scpacket *packet, PyrSlot *slots, int size, bool useElap
 	return errNone;
 }
 
-static int netAddrSend(PyrObject *netAddrObj, int msglen, char *bufptr, bool sendMsgLen = true)
+// scatter variant for pooled packets: the chained segments go to the socket
+// layer as one gathering write, so a large bundle is sent without first being
+// linearized into a contiguous buffer. the internal server still needs
+// contiguous bytes and linearizes into a scratch vector.
+static int netAddrSend(PyrObject *netAddrObj, pooled_scpacket& packet, bool sendMsgLen = true)
 {
 	using namespace boost::asio;
 
+	int msglen = (int)packet.size();
+	std::vector<const_buffer> buffers;
+	buffers.reserve(packet.numchunks() + 1);
+	int32 sizebuf = sc_htonl(msglen);
+
 	if (IsPtr(netAddrObj->slots + ivxNetAddr_Socket)) {
 		SC_TcpClientPort* comPort = (SC_TcpClientPort*)slotRawPtr(netAddrObj->slots + ivxNetAddr_Socket);
 
@@ -305,12 +339,81 @@ static int netAddrSend(PyrObject *netAddrObj, int msglen, char *bufptr, bool sen
 		boost::system::error_code errc;
 
 		if (sendMsgLen) {
-			// send length of message in network byte-order
-			int32 sizebuf = sc_htonl(msglen);
-			write( socket, buffer(&sizebuf, sizeof(int32)), errc );
+			// gather length prefix and message into one write, so the four
+			// byte prefix can never be flushed as a tcp segment of its own
+			buffers.push_back(buffer(&sizebuf, sizeof(int32)));
+		}
+		packet.forEachChunk([&](const char *data, size_t bytes) {
+			buffers.push_back(buffer(data, bytes));
+		});
+		write( socket, buffers, errc );
+
+		if (errc)
+		{
+			::error("Error in netAddrSend: %s\n", errc.message().c_str());
+			return errFailed;
 		}
 
-		if (!errc)
+		return errNone;
+
+	} else {
+		if (gUDPport == 0) return errFailed;
+
+		// send UDP
+		int addr;
+		int err = slotIntVal(netAddrObj->slots + ivxNetAddr_Hostaddr, &addr);
+		if (err) return err;
+
+		if (addr == 0) {
+#ifndef NO_INTERNAL_SERVER
+			if (gInternalSynthServer.mWorld) {
+				std::vector<char> linear(msglen);
+				packet.copyTo(linear.data());
+				World_SendPacket(gInternalSynthServer.mWorld, msglen, linear.data(), &localServerReplyFunc);
+			}
+#endif
+			return errNone;
+		}
+
+		int port;
+		err = slotIntVal(netAddrObj->slots + ivxNetAddr_PortID, &port);
+		if (err) return err;
+
+		unsigned long ulAddress = (unsigned int)addr;
+
+		ip::udp::endpoint address(ip::address_v4(ulAddress), port);
+
+		packet.forEachChunk([&](const char *data, size_t bytes) {
+			buffers.push_back(buffer(data, bytes));
+		});
+		gUDPport->Socket().send_to( buffers, address );
+	}
+
+	return errNone;
+}
+
+static int netAddrSend(PyrObject *netAddrObj, int msglen, char *bufptr, bool sendMsgLen = true)
+{
+	using namespace boost::asio;
+
+	if (IsPtr(netAddrObj->slots + ivxNetAddr_Socket)) {
+		SC_TcpClientPort* comPort = (SC_TcpClientPort*)slotRawPtr(netAddrObj->slots + ivxNetAddr_Socket);
+
+		// send TCP
+		ip::tcp::socket & socket = comPort->Socket();
+
+		boost::system::error_code errc;
+
+		if (sendMsgLen) {
+			// gather length prefix and message into one write, so the four
+			// byte prefix can never be flushed as a tcp segment of its own
+			int32 sizebuf = sc_htonl(msglen);
+			boost::array<const_buffer, 2> buffers = {{
+				buffer(&sizebuf, sizeof(int32)),
+				buffer(bufptr, msglen)
+			}};
+			write( socket, buffers, errc );
+		} else
 			write( socket, buffer(bufptr, msglen), errc );
 
 		if (errc)
@@ -363,8 +466,6 @@ inline size_t OSCStrLen(char *str)
 }
 
 
-int makeSynthBundle(big_scpacket *packet, PyrSlot *slots, int size, bool useElapsed);
-
 static void netAddrTcpClientNotifyFunc(void *clientData)
 {
 	extern bool compiledOK;
@@ -381,11 +482,23 @@ static void netAddrTcpClientNotifyFunc(void *clientData)
 	gLangMutex.unlock();
 }
 
+// tcp connections shared by all NetAddr instances pointing at the same
+// host:port. Only touched from primitives, which run with gLangMutex held.
+typedef std::map<std::pair<unsigned long, int>, SC_TcpClientPort*> TcpClientPool;
+static TcpClientPool gTcpClientPool;
+
 static int prNetAddr_Connect(VMGlobals *g, int numArgsPushed)
 {
-	PyrSlot* netAddrSlot = g->sp;
+	PyrSlot* netAddrSlot = g->sp - 1;
+	PyrSlot* timeoutSlot = g->sp;
 	PyrObject* netAddrObj = slotRawObject(netAddrSlot);
 
+	double timeout = 0.;
+	if (NotNil(timeoutSlot)) {
+		int err = slotDoubleVal(timeoutSlot, &timeout);
+		if (err) return err;
+	}
+
 	int err, port, addr;
 
 	err = slotIntVal(netAddrObj->slots + ivxNetAddr_PortID, &port);
@@ -396,9 +509,22 @@ static int prNetAddr_Connect(VMGlobals *g, int numArgsPushed)
 
 	unsigned long ulAddress = (unsigned int)addr;
 
+	TcpClientPool::iterator pooled = gTcpClientPool.find(std::make_pair(ulAddress, port));
+	if (pooled != gTcpClientPool.end()) {
+		SC_TcpClientPort *comPort = pooled->second;
+		if (comPort->ConnectionLost())
+			gTcpClientPool.erase(pooled);
+		else {
+			comPort->AddClient(netAddrTcpClientNotifyFunc, netAddrObj);
+			SetPtr(netAddrObj->slots + ivxNetAddr_Socket, comPort);
+			return errNone;
+		}
+	}
+
 	try {
-		SC_TcpClientPort *comPort = new SC_TcpClientPort(ulAddress, port, netAddrTcpClientNotifyFunc, netAddrObj);
+		SC_TcpClientPort *comPort = new SC_TcpClientPort(ulAddress, port, netAddrTcpClientNotifyFunc, netAddrObj, timeout);
 		SetPtr(netAddrObj->slots + ivxNetAddr_Socket, comPort);
+		gTcpClientPool[std::make_pair(ulAddress, port)] = comPort;
 	} catch (std::exception const & e) {
 		printf("NetAddr-Connect failed with exception: %s\n", e.what());
 		return errFailed;
@@ -409,14 +535,23 @@ static int prNetAddr_Connect(VMGlobals *g, int numArgsPushed)
 
 static int prNetAddr_Disconnect(VMGlobals *g, int numArgsPushed)
 {
-	int err;
+	int err = errNone;
 
 	PyrSlot* netAddrSlot = g->sp;
 	PyrObject* netAddrObj = slotRawObject(netAddrSlot);
 
 	SC_TcpClientPort *comPort = (SC_TcpClientPort*)slotRawPtr(netAddrObj->slots + ivxNetAddr_Socket);
 	if (comPort) {
-		err = comPort->Close();
+		// the connection stays open as long as other NetAddr instances use it
+		if (comPort->RemoveClient(netAddrObj)) {
+			err = comPort->Close();
+			for (TcpClientPool::iterator it = gTcpClientPool.begin(); it != gTcpClientPool.end(); ++it) {
+				if (it->second == comPort) {
+					gTcpClientPool.erase(it);
+					break;
+				}
+			}
+		}
 		SetPtr(netAddrObj->slots + ivxNetAddr_Socket, NULL);
 	}
 
@@ -428,14 +563,14 @@ static int prNetAddr_SendMsg(VMGlobals *g, int numArgsPushed)
 {
 	PyrSlot* netAddrSlot = g->sp - numArgsPushed + 1;
 	PyrSlot* args = netAddrSlot + 1;
-	big_scpacket packet;
+	pooled_scpacket packet;
 
 	int numargs = numArgsPushed - 1;
 	int error = makeSynthMsgWithTags(&packet, args, numargs);
 	if (error != errNone)
 		return error;
 
-	return netAddrSend(slotRawObject(netAddrSlot), packet.size(), (char*)packet.buf);
+	return netAddrSend(slotRawObject(netAddrSlot), packet);
 }
 
 
@@ -443,7 +578,7 @@ static int prNetAddr_SendBundle(VMGlobals *g, int numArgsPushed)
 {
 	PyrSlot* netAddrSlot = g->sp - numArgsPushed + 1;
 	PyrSlot* args = netAddrSlot + 1;
-	big_scpacket packet;
+	pooled_scpacket packet;
 
 	double time;
 	int err = slotDoubleVal(args, &time);
@@ -454,9 +589,46 @@ static int prNetAddr_SendBundle(VMGlobals *g, int numArgsPushed)
 	int numargs = numArgsPushed - 1;
 	makeSynthBundle(&packet, args, numargs, true);
 
-	//for (int i=0; i<packet.size()/4; i++) post("%d %p\n", i, packet.buf[i]);
+	return netAddrSend(slotRawObject(netAddrSlot), packet);
+}
+
+// like _NetAddr_SendBundle, but takes the messages as one Array instead of
+// varargs, so a caller holding a list of messages can hand it over without
+// expanding it onto the stack. everything is encoded into one packet in one
+// pass; nested messages become blobs in place (see addNestedMsgBlob).
+static int prNetAddr_SendBundleArray(VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot* netAddrSlot = g->sp - 2;
+	PyrSlot* timeSlot = g->sp - 1;
+	PyrSlot* arraySlot = g->sp;
+
+	if (!isKindOfSlot(arraySlot, class_array)) return errWrongType;
+	PyrObject *array = slotRawObject(arraySlot);
+
+	pooled_scpacket packet;
 
-	return netAddrSend(slotRawObject(netAddrSlot), packet.size(), (char*)packet.buf);
+	double time;
+	int64 oscTime;
+	int err = slotDoubleVal(timeSlot, &time);
+	if (!err) {
+		time += slotRawFloat(&g->thread->seconds);
+		oscTime = ElapsedTimeToOSC(time);
+	} else {
+		oscTime = 1;	// immediate
+	}
+	packet.OpenBundle(oscTime);
+
+	for (int i=0; i<array->size; ++i) {
+		if (isKindOfSlot(array->slots+i, class_array)) {
+			PyrObject *obj = slotRawObject(array->slots+i);
+			int error = makeSynthMsgWithTags(&packet, obj->slots, obj->size);
+			if (error != errNone)
+				return error;
+		}
+	}
+	packet.CloseBundle();
+
+	return netAddrSend(slotRawObject(netAddrSlot), packet);
 }
 
 static int prNetAddr_SendRaw(VMGlobals *g, int numArgsPushed)
@@ -511,7 +683,7 @@ static int prNetAddr_SetBroadcastFlag(VMGlobals *g, int numArgsPushed)
 static int prNetAddr_BundleSize(VMGlobals *g, int numArgsPushed)
 {
 	PyrSlot* args = g->sp;
-	big_scpacket packet;
+	pooled_scpacket packet;
 	int numargs = slotRawObject(args)->size;
 	if (numargs < 1) return errFailed;
 	makeSynthBundle(&packet, slotRawObject(args)->slots, numargs, true);
@@ -522,7 +694,7 @@ static int prNetAddr_BundleSize(VMGlobals *g, int numArgsPushed)
 static int prNetAddr_MsgSize(VMGlobals *g, int numArgsPushed)
 {
 	PyrSlot* args = g->sp;
-	big_scpacket packet;
+	pooled_scpacket packet;
 
 	int numargs = slotRawObject(args)->size;
 	if (numargs < 1) return errFailed;
@@ -551,7 +723,7 @@ static int prArray_OSCBytes(VMGlobals *g, int numArgsPushed)
 	PyrSlot* args = array->slots;
 	int numargs = array->size;
 	if (numargs < 1) return errFailed;
-	big_scpacket packet;
+	pooled_scpacket packet;
 
 	if (IsFloat(args) || IsNil(args) || IsInt(args)) {
 		makeSynthBundle(&packet, args, numargs, false);
@@ -566,13 +738,59 @@ static int prArray_OSCBytes(VMGlobals *g, int numArgsPushed)
 	int size = packet.size();
 	PyrInt8Array* obj = newPyrInt8Array(g->gc, size, 0, true);
 	obj->size = size;
-	memcpy(obj->b, packet.data(), size);
+	packet.copyTo((char*)obj->b);
 	SetObject(a, (PyrObject*)obj);
-	//for (int i=0; i<packet.size()/4; i++) post("%d %p\n", i, packet.buf[i]);
 
 	return errNone;
 }
 
+// convert a FloatArray to an Int8Array holding the samples as network order
+// float32 - the blob format of /b_setb - without going through per-element
+// OSC tag encoding.
+int prFloatArray_OSCBlob(VMGlobals *g, int numArgsPushed);
+int prFloatArray_OSCBlob(VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot* a = g->sp;
+	if (!isKindOfSlot(a, class_floatarray)) return errWrongType;
+
+	PyrObject *array = slotRawObject(a);
+	int numSamples = array->size;
+	PyrInt8Array* obj = newPyrInt8Array(g->gc, numSamples * sizeof(float), 0, true);
+	obj->size = numSamples * sizeof(float);
+	const float* src = ((PyrFloatArray*)array)->f;
+	int32* dst = (int32*)obj->b;
+	for (int i=0; i<numSamples; ++i) {
+		union { float f; int32 i; } u;
+		u.f = src[i];
+		dst[i] = sc_htonl(u.i);
+	}
+	SetObject(a, (PyrObject*)obj);
+	return errNone;
+}
+
+// the reverse: decode an Int8Array of network order float32 (e.g. the blob
+// of a /b_setb reply) into a FloatArray.
+int prInt8Array_AsFloatArray(VMGlobals *g, int numArgsPushed);
+int prInt8Array_AsFloatArray(VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot* a = g->sp;
+	if (!isKindOfSlot(a, class_int8array)) return errWrongType;
+
+	PyrInt8Array *blob = (PyrInt8Array*)slotRawObject(a);
+	int numSamples = blob->size / sizeof(float);
+	PyrObject* array = instantiateObject(g->gc, class_floatarray, numSamples, false, true);
+	array->size = numSamples;
+	const int32* src = (const int32*)blob->b;
+	float* dst = ((PyrFloatArray*)array)->f;
+	for (int i=0; i<numSamples; ++i) {
+		union { float f; int32 i; } u;
+		u.i = sc_ntohl(src[i]);
+		dst[i] = u.f;
+	}
+	SetObject(a, array);
+	return errNone;
+}
+
 // Create a new <PyrInt8Array> object and copy data from `msg.getb'.
 // Bytes are properly untyped, but there is no <UInt8Array> type.
 
@@ -731,18 +949,20 @@ void FreeOSCPacket(OSC_Packet *inPacket)
 {
 	//post("->FreeOSCPacket %p\n", inPacket);
 	if (inPacket) {
+		if (FreeDatagramPacket(inPacket))
+			return;
 		free(inPacket->mData);
 		free(inPacket);
 	}
 }
 
-// takes ownership of inPacket
-void ProcessOSCPacket(OSC_Packet* inPacket, int inPortNum, double time)
+// takes ownership of inPacket. the caller must hold gLangMutex; the receive
+// handlers use this to hand over a whole burst of packets under one lock.
+void ProcessOSCPacketLocked(OSC_Packet* inPacket, int inPortNum, double time)
 {
 	//post("recv '%s' %d\n", inPacket->mData, inPacket->mSize);
 	inPacket->mIsBundle = IsBundle(inPacket->mData);
 
-	gLangMutex.lock();
 	if (compiledOK) {
 		PyrObject *replyObj = ConvertReplyAddress(&inPacket->mReplyAddr);
 		if (compiledOK) {
@@ -753,11 +973,18 @@ void ProcessOSCPacket(OSC_Packet* inPacket, int inPortNum, double time)
 			}
 		}
 	}
-	gLangMutex.unlock();
 
 	FreeOSCPacket(inPacket);
 }
 
+// takes ownership of inPacket
+void ProcessOSCPacket(OSC_Packet* inPacket, int inPortNum, double time)
+{
+	gLangMutex.lock();
+	ProcessOSCPacketLocked(inPacket, inPortNum, time);
+	gLangMutex.unlock();
+}
+
 void startAsioThread();
 void stopAsioThread();
 
@@ -828,6 +1055,117 @@ void cleanup_OSC()
 
 extern boost::asio::io_service ioService;
 
+// Session-lifetime cache of resolved hostnames, shared by the blocking and
+// the asynchronous lookup path. Repeat lookups of an address must never hang
+// the interpreter on a slow or dead resolver again.
+static SC_Lock gHostCacheLock;
+static std::map<std::string, int> gHostAddrCache;
+
+static bool lookupHostCache(const char *hostname, int & addr)
+{
+	lock_guard<SC_Lock> lock(gHostCacheLock);
+	std::map<std::string, int>::const_iterator it = gHostAddrCache.find(hostname);
+	if (it == gHostAddrCache.end())
+		return false;
+	addr = it->second;
+	return true;
+}
+
+static void storeHostCache(const char *hostname, int addr)
+{
+	lock_guard<SC_Lock> lock(gHostCacheLock);
+	gHostAddrCache[hostname] = addr;
+}
+
+static PyrSymbol *s_hostResolved;
+
+// deliver a resolution result to NetAddr.prHostResolved. runs on the io
+// thread, like the tcp notifications above.
+static void netAddrDeliverResolved(const std::string & hostname, int addr, bool success)
+{
+	gLangMutex.lock();
+	if (compiledOK) {
+		VMGlobals* g = gMainVMGlobals;
+		g->canCallOS = false;
+		++g->sp; SetObject(g->sp, s_netaddr->u.classobj);
+		++g->sp; SetObject(g->sp, newPyrString(g->gc, hostname.c_str(), 0, true));
+		++g->sp;
+		if (success)
+			SetInt(g->sp, addr);
+		else
+			SetNil(g->sp);
+		runInterpreter(g, s_hostResolved, 3);
+		g->canCallOS = false;
+	}
+	gLangMutex.unlock();
+}
+
+namespace {
+
+struct HostResolveRequest
+{
+	std::string hostname;
+	boost::asio::ip::udp::resolver resolver;
+
+	explicit HostResolveRequest(const char *name):
+		hostname(name), resolver(ioService)
+	{}
+};
+
+} // namespace
+
+static void netAddrAsyncResolved(HostResolveRequest *request, const boost::system::error_code &ec,
+	boost::asio::ip::udp::resolver::iterator iterator)
+{
+	bool success = false;
+	int addr = 0;
+	if (!ec) {
+		boost::asio::ip::udp::resolver::iterator end;
+		for (; iterator != end; ++iterator) {
+			if (iterator->endpoint().address().is_v4()) {
+				addr = (int)iterator->endpoint().address().to_v4().to_ulong();
+				success = true;
+				break;
+			}
+		}
+	}
+
+	if (success)
+		storeHostCache(request->hostname.c_str(), addr);
+	else
+		error("NetAddr: could not resolve \"%s\"%s%s\n", request->hostname.c_str(),
+			ec ? ": " : "", ec ? ec.message().c_str() : "");
+
+	netAddrDeliverResolved(request->hostname, addr, success);
+	delete request;
+}
+
+static int prNetAddr_ResolveAsync(VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *b = g->sp;
+	char hostname[256];
+
+	int err = slotStrVal(b, hostname, 255);
+	if (err) return err;
+
+	int addr;
+	if (lookupHostCache(hostname, addr)) {
+		// deliver through the io thread anyway, so the callback never runs
+		// from inside this primitive
+		std::string name(hostname);
+		ioService.post([=] { netAddrDeliverResolved(name, addr, true); });
+		return errNone;
+	}
+
+	HostResolveRequest *request = new HostResolveRequest(hostname);
+	boost::asio::ip::udp::resolver::query query(request->hostname, "");
+	request->resolver.async_resolve(query,
+		[request](const boost::system::error_code &ec, boost::asio::ip::udp::resolver::iterator iterator) {
+			netAddrAsyncResolved(request, ec, iterator);
+		});
+	return errNone;
+}
+
 static int prGetHostByName(VMGlobals *g, int numArgsPushed)
 {
 	PyrSlot *a = g->sp;
@@ -836,6 +1174,12 @@ static int prGetHostByName(VMGlobals *g, int numArgsPushed)
 	int err = slotStrVal(a, hostname, 255);
 	if (err) return err;
 
+	int cached;
+	if (lookupHostCache(hostname, cached)) {
+		SetInt(a, cached);
+		return errNone;
+	}
+
 #if 1
 	struct hostent *he = gethostbyname(hostname);
 	if (!he) {
@@ -847,6 +1191,7 @@ static int prGetHostByName(VMGlobals *g, int numArgsPushed)
 		return errFailed;
 	}
 
+	storeHostCache(hostname, sc_ntohl(*(int*)he->h_addr));
 	SetInt(a, sc_ntohl(*(int*)he->h_addr));
 
 	return errNone;
@@ -1368,6 +1713,32 @@ int prSetControlBusValues(VMGlobals *g, int numArgsPushed)
 	return errNone;
 }
 
+int prWriteSynthDef(VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a = g->sp - 1;
+	PyrSlot *b = g->sp;
+
+	assert(IsObj(a));
+	PyrObject * self = slotRawObject(a);
+	int ptrIndex       = 0;
+	PyrSlot * ptrSlot = self->slots + ptrIndex;
+	if (NotPtr(ptrSlot))
+		return errFailed;
+
+	if (!isKindOfSlot(b, class_int8array))
+		return errWrongType;
+
+	PyrInt8Array * bytes = slotRawInt8Array(b);
+
+	server_shared_memory_client * client = (server_shared_memory_client*)slotRawPtr(ptrSlot);
+
+	// -1 means the def does not fit or all slots are in flight; the caller
+	// falls back to /d_recv over the socket
+	int slotIndex = client->write_def((const char*)bytes->b, bytes->size);
+	SetInt(a, slotIndex);
+	return errNone;
+}
+
 void init_OSC_primitives();
 void init_OSC_primitives()
 {
@@ -1376,10 +1747,12 @@ void init_OSC_primitives()
 	base = nextPrimitiveIndex();
 	index = 0;
 
-	definePrimitive(base, index++, "_NetAddr_Connect", prNetAddr_Connect, 1, 0);
+	definePrimitive(base, index++, "_NetAddr_Connect", prNetAddr_Connect, 2, 0);
+	definePrimitive(base, index++, "_NetAddr_ResolveAsync", prNetAddr_ResolveAsync, 2, 0);
 	definePrimitive(base, index++, "_NetAddr_Disconnect", prNetAddr_Disconnect, 1, 0);
 	definePrimitive(base, index++, "_NetAddr_SendMsg", prNetAddr_SendMsg, 1, 1);
 	definePrimitive(base, index++, "_NetAddr_SendBundle", prNetAddr_SendBundle, 2, 1);
+	definePrimitive(base, index++, "_NetAddr_SendBundleArray", prNetAddr_SendBundleArray, 3, 0);
 	definePrimitive(base, index++, "_NetAddr_SendRaw", prNetAddr_SendRaw, 2, 0);
 	definePrimitive(base, index++, "_NetAddr_GetBroadcastFlag", prNetAddr_GetBroadcastFlag, 1, 0);
 	definePrimitive(base, index++, "_NetAddr_SetBroadcastFlag", prNetAddr_SetBroadcastFlag, 2, 0);
@@ -1388,6 +1761,8 @@ void init_OSC_primitives()
 
 	definePrimitive(base, index++, "_NetAddr_UseDoubles", prNetAddr_UseDoubles, 2, 0);
 	definePrimitive(base, index++, "_Array_OSCBytes", prArray_OSCBytes, 1, 0);
+	definePrimitive(base, index++, "_FloatArray_OSCBlob", prFloatArray_OSCBlob, 1, 0);
+	definePrimitive(base, index++, "_Int8Array_AsFloatArray", prInt8Array_AsFloatArray, 1, 0);
 	definePrimitive(base, index++, "_GetHostByName", prGetHostByName, 1, 0);
 	definePrimitive(base, index++, "_GetLangPort", prGetLangPort, 1, 0);
     definePrimitive(base, index++, "_MatchLangIP", prMatchLangIP, 2, 0);
@@ -1409,6 +1784,7 @@ void init_OSC_primitives()
 
 	definePrimitive(base, index++, "_ServerShmInterface_setControlBusValue", prSetControlBusValue, 3, 0);
 	definePrimitive(base, index++, "_ServerShmInterface_setControlBusValues", prSetControlBusValues, 3, 0);
+	definePrimitive(base, index++, "_ServerShmInterface_writeSynthDef", prWriteSynthDef, 2, 0);
 
 	//post("initOSCRecs###############\n");
 	s_call = getsym("call");
@@ -1416,4 +1792,5 @@ void init_OSC_primitives()
 	s_recvoscmsg = getsym("recvOSCmessage");
 	s_recvoscbndl = getsym("recvOSCbundle");
 	s_netaddr = getsym("NetAddr");
+	s_hostResolved = getsym("prHostResolved");
 }
@@ -83,6 +83,7 @@ int prWriteArchive(struct VMGlobals *g, int numArgsPushed)
 	FILE *file = fopen(pathname, "wb");
 	int err = errNone;
 	if (file) {
+		setvbuf(file, NULL, _IOFBF, 65536); // stream large archives in big blocks
 		err = arch.prepareToWriteArchive(a);
 		if (!err) {
 			arch.setStream(file);
@@ -113,6 +114,7 @@ int prReadArchive(struct VMGlobals *g, int numArgsPushed)
 
 	int err;
 	if (file) {
+		setvbuf(file, NULL, _IOFBF, 65536);
 		arch.setStream(file);
 		err = arch.readArchive(a);
 		fclose(file);
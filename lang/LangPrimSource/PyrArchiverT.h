@@ -38,9 +38,37 @@ An object archiving system for SuperCollider.
 #include "ReadWriteMacros.h"
 #include "SCBase.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 const int32 kArchHdrSize = 12;
 const int32 kObjectArrayInitialCapacity = 32;
 
+/* archive file versions:
+ * 2 - every symbol is stored as length + name at each occurrence, raw
+ *     arrays are stored element by element.
+ * 3 - symbols are interned into a table as they are first written; later
+ *     occurrences store a 4 byte table index. raw arrays are written in
+ *     bulk. readers accept both versions.
+ */
+const int32 kArchVersion = 3;
+
+inline uint16 PyrArchiver_swap16(uint16 x)
+{
+	return (uint16)((x << 8) | (x >> 8));
+}
+
+inline uint32 PyrArchiver_swap32(uint32 x)
+{
+	return (x << 24) | ((x << 8) & 0x00ff0000) | ((x >> 8) & 0x0000ff00) | (x >> 24);
+}
+
+inline uint64 PyrArchiver_swap64(uint64 x)
+{
+	return ((uint64)PyrArchiver_swap32((uint32)x) << 32) | PyrArchiver_swap32((uint32)(x >> 32));
+}
+
 template <class S>
 class PyrArchiver
 {
@@ -63,6 +91,12 @@ public:
 
 	int32 calcArchiveSize()
 		{
+			/* the per-symbol cost depends on whether the symbol is already
+			 * interned, but the sum over all occurrences does not depend on
+			 * the order, so the total matches the write pass even though it
+			 * interleaves headers and slots differently. */
+			mSymbolIndices.clear();
+
 			PyrSlot *slot;
 			int32 size = kArchHdrSize;
 			if (mNumObjects == 0) {
@@ -71,7 +105,7 @@ public:
 				// object table size
 				for (int i=0; i<mNumObjects; ++i) {
 					PyrObject* obj = mObjectArray[i];
-					size += slotRawSymbol(&obj->classptr->name)->length + 1; // class name symbol
+					size += symbolRefSize(slotRawSymbol(&obj->classptr->name)) + 1; // class name symbol
 					size += sizeof(int32); // size
 					if (obj->obj_format <= obj_slot) {
 						size += obj->size; // tags
@@ -82,7 +116,7 @@ public:
 					} else if (obj->obj_format == obj_symbol) {
 						PyrSymbol **symbol = ((PyrSymbolArray*)obj)->symbols;
 						for (int j=0; j<obj->size; ++j, ++symbol) {
-							size += (**symbol).length + 1;
+							size += symbolRefSize(*symbol) + 1;
 						}
 					} else {
 						size += obj->size * gFormatElemSize[obj->obj_format];
@@ -111,6 +145,8 @@ public:
 			long err = errNone;
 
 			try {
+				mSymbolIndices.clear();
+
 				writeArchiveHeader();
 
 				if (mNumObjects == 0) {
@@ -170,7 +206,7 @@ private:
 	void writeArchiveHeader()
 		{
 			mStream.writeInt32_be(('!'<<24)|('S'<<16)|('C'<<8)|'a' /*'!SCa'*/);
-			mStream.writeInt32_be(2); // file version
+			mStream.writeInt32_be(kArchVersion); // file version
 			mStream.writeInt32_be(mNumObjects);
 		}
 
@@ -258,13 +294,64 @@ private:
 			}
 		}
 
+	/** size of a symbol reference, excluding any slot tag byte.
+	 *  the first occurrence stores length + name and interns the symbol,
+	 *  later occurrences store a table index.
+	 */
+	int32 symbolRefSize(PyrSymbol *symbol)
+		{
+			if (mSymbolIndices.find(symbol) != mSymbolIndices.end())
+				return sizeof(int32);
+
+			mSymbolIndices[symbol] = (int32)mSymbolIndices.size();
+			return symbol->length + 1;
+		}
+
+	void writeSymbolRef(PyrSymbol *symbol)
+		{
+			std::unordered_map<PyrSymbol*, int32>::const_iterator it = mSymbolIndices.find(symbol);
+			if (it != mSymbolIndices.end()) {
+				mStream.writeInt8('y');
+				mStream.writeInt32_be(it->second);
+			} else {
+				mSymbolIndices[symbol] = (int32)mSymbolIndices.size();
+				mStream.writeInt8('s');
+				mStream.writeSymbol(symbol->name);
+			}
+		}
+
+	PyrSymbol* readSymbolTableEntry()
+		{
+			int32 index = mStream.readInt32_be();
+			if (index < 0 || index >= (int32)mReadSymbolTable.size())
+				throw std::runtime_error("corrupt archive: symbol table index out of range.\n");
+			return mReadSymbolTable[index];
+		}
+
+	PyrSymbol* readSymbolRef()
+		{
+			if (mReadArchiveVersion < 3)
+				return readSymbolID();
+
+			char tag = mStream.readInt8();
+			if (tag == 'y')
+				return readSymbolTableEntry();
+			if (tag != 's')
+				throw std::runtime_error("corrupt archive: bad symbol tag.\n");
+			PyrSymbol *symbol = readSymbolID();
+			mReadSymbolTable.push_back(symbol);
+			return symbol;
+		}
+
 	int32 sizeOfElem(PyrSlot *slot)
 		{
 			//postfl("writeSlot %08X\n", GetTag(slot));
 			switch (GetTag(slot)) {
 				case tagObj :
 					if (isKindOf(slotRawObject(slot), class_class)) {
-						return slotRawSymbol(&slotRawClass(slot)->name)->length + 1;
+						// 'C' slot tag is counted by the caller, the symbol
+						// reference carries its own tag byte
+						return symbolRefSize(slotRawSymbol(&slotRawClass(slot)->name)) + 1;
 					} else if (isKindOf(slotRawObject(slot), class_process)) {
 						return 0;
 					} else if (isKindOf(slotRawObject(slot), class_frame)) {
@@ -278,7 +365,7 @@ private:
 				case tagInt :
 					return sizeof(int32);
 				case tagSym :
-					return slotRawSymbol(slot)->length + 1;
+					return symbolRefSize(slotRawSymbol(slot));
 				case tagChar :
 					return sizeof(int32);
 				case tagNil :
@@ -315,14 +402,14 @@ private:
 			obj->ClearMark();
 
 			//postfl("writeObjectHeader %s\n", slotRawSymbol(&obj->classptr->name)->name);
-			mStream.writeSymbol(slotRawSymbol(&obj->classptr->name)->name);
+			writeSymbolRef(slotRawSymbol(&obj->classptr->name));
 
 			mStream.writeInt32_be(obj->size);
 		}
 
 	PyrObject* readObjectHeader()
 		{
-			PyrSymbol* classname = readSymbolID();
+			PyrSymbol* classname = readSymbolRef();
 			//post("readObjectHeader %s\n", classname->name);
 			PyrObject *obj;
 			int32 size = mStream.readInt32_be();
@@ -384,7 +471,7 @@ private:
 					obj = slotRawObject(slot);
 					if (isKindOf(obj, class_class)) {
 						mStream.writeInt8('C');
-						mStream.writeSymbol(slotRawSymbol(&slotRawClass(slot)->name)->name);
+						writeSymbolRef(slotRawSymbol(&slotRawClass(slot)->name));
 					} else if (isKindOf(obj, class_process)) {
 						mStream.writeInt8('P');
 					} else if (isKindOf(obj, s_interpreter->u.classobj)) {
@@ -399,8 +486,8 @@ private:
 					mStream.writeInt32_be(slotRawInt(slot));
 					break;
 				case tagSym :
-					mStream.writeInt8('s');
-					mStream.writeSymbol(slotRawSymbol(slot)->name);
+					// the symbol reference tag ('s' or 'y') doubles as the slot tag
+					writeSymbolRef(slotRawSymbol(slot));
 					break;
 				case tagChar :
 					mStream.writeInt8('c');
@@ -436,7 +523,7 @@ private:
 					SetObject(slot, (PyrObject*)(size_t)mStream.readInt32_be()); // FIXME: fix 64bit safety
 					break;
 				case 'C' :
-					SetObject(slot, (PyrObject*)readSymbolID()->u.classobj);
+					SetObject(slot, (PyrObject*)readSymbolRef()->u.classobj);
 					break;
 				case 'P' :
 					SetObject(slot, (PyrObject*)g->process);
@@ -447,8 +534,14 @@ private:
 				case 'i' :
 					SetInt(slot, mStream.readInt32_be());
 					break;
-				case 's' :
-					SetSymbol(slot, readSymbolID());
+				case 's' : {
+					PyrSymbol *symbol = readSymbolID();
+					if (mReadArchiveVersion >= 3)
+						mReadSymbolTable.push_back(symbol);
+					SetSymbol(slot, symbol);
+				} break;
+				case 'y' :
+					SetSymbol(slot, readSymbolTableEntry());
 					break;
 				case 'c' :
 					SetChar(slot, mStream.readInt32_be());
@@ -469,6 +562,56 @@ private:
 			}
 		}
 
+	/* raw arrays are stored big endian. on little endian hosts the data is
+	 * byteswapped into a chunk buffer and written in bulk, instead of going
+	 * through the stream one byte at a time. */
+	static const int32 kRawArrayChunkSize = 1024;
+
+	void writeSwapped16(const uint16 *data, int32 size)
+		{
+#if BYTE_ORDER == BIG_ENDIAN
+			mStream.writeData((char*)data, size * sizeof(uint16));
+#else
+			uint16 chunk[kRawArrayChunkSize];
+			for (int32 i=0; i<size; i+=kRawArrayChunkSize) {
+				int32 n = std::min(size - i, int32(kRawArrayChunkSize));
+				for (int32 j=0; j<n; ++j)
+					chunk[j] = PyrArchiver_swap16(data[i+j]);
+				mStream.writeData((char*)chunk, n * sizeof(uint16));
+			}
+#endif
+		}
+
+	void writeSwapped32(const uint32 *data, int32 size)
+		{
+#if BYTE_ORDER == BIG_ENDIAN
+			mStream.writeData((char*)data, size * sizeof(uint32));
+#else
+			uint32 chunk[kRawArrayChunkSize];
+			for (int32 i=0; i<size; i+=kRawArrayChunkSize) {
+				int32 n = std::min(size - i, int32(kRawArrayChunkSize));
+				for (int32 j=0; j<n; ++j)
+					chunk[j] = PyrArchiver_swap32(data[i+j]);
+				mStream.writeData((char*)chunk, n * sizeof(uint32));
+			}
+#endif
+		}
+
+	void writeSwapped64(const uint64 *data, int32 size)
+		{
+#if BYTE_ORDER == BIG_ENDIAN
+			mStream.writeData((char*)data, size * sizeof(uint64));
+#else
+			uint64 chunk[kRawArrayChunkSize];
+			for (int32 i=0; i<size; i+=kRawArrayChunkSize) {
+				int32 n = std::min(size - i, int32(kRawArrayChunkSize));
+				for (int32 j=0; j<n; ++j)
+					chunk[j] = PyrArchiver_swap64(data[i+j]);
+				mStream.writeData((char*)chunk, n * sizeof(uint64));
+			}
+#endif
+		}
+
 	void writeRawArray(PyrObject *obj)
 		{
 			int32 size = obj->size;
@@ -480,28 +623,19 @@ private:
 					mStream.writeData(data, size);
 				} break;
 				case obj_int16 : {
-					int16 *data = (int16*)obj->slots;
-					for (int i=0; i<size; ++i) {
-						mStream.writeInt16_be(data[i]);
-					}
+					writeSwapped16((uint16*)obj->slots, size);
 				} break;
 				case obj_int32 :
 				case obj_float : {
-					int32 *data = (int32*)obj->slots;
-					for (int i=0; i<size; ++i) {
-						mStream.writeInt32_be(data[i]);
-					}
+					writeSwapped32((uint32*)obj->slots, size);
 				} break;
 				case obj_double : {
-					double *data = (double*)obj->slots;
-					for (int i=0; i<size; ++i) {
-						mStream.writeDouble_be(data[i]);
-					}
+					writeSwapped64((uint64*)obj->slots, size);
 				} break;
 				case obj_symbol : {
 					PyrSymbol **data = (PyrSymbol**)obj->slots;
 					for (int i=0; i<size; ++i) {
-						mStream.writeSymbol(data[i]->name);
+						writeSymbolRef(data[i]);
 					}
 				} break;
 			}
@@ -514,34 +648,37 @@ private:
 			switch (obj->obj_format) {
 				case obj_char :
 				case obj_int8 : {
-					int8 *data = (int8*)obj->slots;
-					for (int i=0; i<size; ++i) {
-						data[i] = mStream.readInt8();
-					}
+					mStream.readData((char*)obj->slots, size);
 				} break;
 				case obj_int16 : {
-					int16 *data = (int16*)obj->slots;
-					for (int i=0; i<size; ++i) {
-						data[i] = mStream.readInt16_be();
-					}
+					uint16 *data = (uint16*)obj->slots;
+					mStream.readData((char*)data, size * sizeof(uint16));
+#if BYTE_ORDER == LITTLE_ENDIAN
+					for (int i=0; i<size; ++i)
+						data[i] = PyrArchiver_swap16(data[i]);
+#endif
 				} break;
 				case obj_int32 :
 				case obj_float : {
-					int32 *data = (int32*)obj->slots;
-					for (int i=0; i<size; ++i) {
-						data[i] = mStream.readInt32_be();
-					}
+					uint32 *data = (uint32*)obj->slots;
+					mStream.readData((char*)data, size * sizeof(uint32));
+#if BYTE_ORDER == LITTLE_ENDIAN
+					for (int i=0; i<size; ++i)
+						data[i] = PyrArchiver_swap32(data[i]);
+#endif
 				} break;
 				case obj_double : {
-					double *data = (double*)obj->slots;
-					for (int i=0; i<size; ++i) {
-						data[i] = mStream.readDouble_be();
-					}
+					uint64 *data = (uint64*)obj->slots;
+					mStream.readData((char*)data, size * sizeof(uint64));
+#if BYTE_ORDER == LITTLE_ENDIAN
+					for (int i=0; i<size; ++i)
+						data[i] = PyrArchiver_swap64(data[i]);
+#endif
 				} break;
 				case obj_symbol : {
 					PyrSymbol **data = (PyrSymbol**)obj->slots;
 					for (int i=0; i<size; ++i) {
-						data[i] = readSymbolID();
+						data[i] = readSymbolRef();
 					}
 				} break;
 			}
@@ -558,6 +695,9 @@ private:
 	SC_IOStream<S> mStream;
 	int32 mReadArchiveVersion;
 
+	std::unordered_map<PyrSymbol*, int32> mSymbolIndices; /* writing: symbol -> table index */
+	std::vector<PyrSymbol*> mReadSymbolTable;             /* reading: table index -> symbol */
+
 	PyrObject *mInitialObjectArray[kObjectArrayInitialCapacity];
 };
 
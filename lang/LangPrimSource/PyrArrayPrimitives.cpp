@@ -29,6 +29,8 @@ Primitives for Arrays.
 #include "SC_InlineBinaryOp.h"
 #include "SC_Constants.h"
 #include <string.h>
+#include <stdint.h>
+#include <limits>
 
 int basicSize(VMGlobals *g, int numArgsPushed);
 int basicMaxSize(VMGlobals *g, int numArgsPushed);
@@ -2116,6 +2118,174 @@ int prArrayNormalizeSum(struct VMGlobals *g, int numArgsPushed)
 	return errNone;
 }
 
+// bulk numeric kernels. these exist so that Array.series, sum and normalize
+// run as tight loops over the raw storage instead of one full message send
+// per element. each one bails out with errFailed for formats or contents it
+// does not handle, so the sclang fallback keeps the generic behaviour.
+
+int prArrayFillSeries(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a, *b, *c;
+	PyrObject *obj;
+	double start, step;
+	int i, size, err;
+
+	a = g->sp - 2;
+	b = g->sp - 1;
+	c = g->sp;
+
+	obj = slotRawObject(a);
+	err = slotDoubleVal(b, &start);
+	if (err) return errFailed;
+	err = slotDoubleVal(c, &step);
+	if (err) return errFailed;
+
+	size = obj->size;
+	switch (obj->obj_format) {
+		case obj_slot : {
+			PyrSlot *slots = obj->slots;
+			if (IsInt(b) && IsInt(c)) {
+				int istart = slotRawInt(b);
+				int istep = slotRawInt(c);
+				for (i=0; i<size; ++i) SetInt(slots + i, istart + i * istep);
+			} else {
+				for (i=0; i<size; ++i) SetFloat(slots + i, start + i * step);
+			}
+		} break;
+		case obj_double : {
+			double *p = (double*)obj->slots;
+			for (i=0; i<size; ++i) p[i] = start + i * step;
+		} break;
+		case obj_float : {
+			float *p = (float*)obj->slots;
+			for (i=0; i<size; ++i) p[i] = (float)(start + i * step);
+		} break;
+		case obj_int32 : {
+			int32 *p = (int32*)obj->slots;
+			if (IsInt(b) && IsInt(c)) {
+				int istart = slotRawInt(b);
+				int istep = slotRawInt(c);
+				for (i=0; i<size; ++i) p[i] = istart + i * istep;
+			} else {
+				for (i=0; i<size; ++i) p[i] = (int32)(start + i * step);
+			}
+		} break;
+		default :
+			return errFailed;
+	}
+	// leave the receiver on the stack as the result
+	return errNone;
+}
+
+int prArraySum(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a;
+	PyrObject *obj;
+	int i, size;
+
+	a = g->sp;
+	obj = slotRawObject(a);
+	size = obj->size;
+	switch (obj->obj_format) {
+		case obj_slot : {
+			PyrSlot *slots = obj->slots;
+			double sum = 0.;
+			bool isInt = true;
+			for (i=0; i<size; ++i) {
+				if (IsInt(slots + i)) {
+					sum += slotRawInt(slots + i);
+				} else if (IsFloat(slots + i)) {
+					sum += slotRawFloat(slots + i);
+					isInt = false;
+				} else {
+					return errFailed;
+				}
+			}
+			if (isInt && sum >= INT32_MIN && sum <= INT32_MAX) SetInt(a, (int)sum);
+			else SetFloat(a, sum);
+		} break;
+		case obj_double : {
+			double *p = (double*)obj->slots;
+			double sum = 0.;
+			for (i=0; i<size; ++i) sum += p[i];
+			SetFloat(a, sum);
+		} break;
+		case obj_float : {
+			float *p = (float*)obj->slots;
+			double sum = 0.;
+			for (i=0; i<size; ++i) sum += p[i];
+			SetFloat(a, sum);
+		} break;
+		case obj_int32 : {
+			int32 *p = (int32*)obj->slots;
+			double sum = 0.;
+			for (i=0; i<size; ++i) sum += p[i];
+			if (sum >= INT32_MIN && sum <= INT32_MAX) SetInt(a, (int)sum);
+			else SetFloat(a, sum);
+		} break;
+		default :
+			return errFailed;
+	}
+	return errNone;
+}
+
+int prArrayNormalize(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a, *b, *c;
+	PyrObject *obj1, *obj2;
+	double outMin, outMax, w, lo, hi, scale;
+	int i, size, format, err;
+
+	a = g->sp - 2;
+	b = g->sp - 1;
+	c = g->sp;
+
+	obj1 = slotRawObject(a);
+	err = slotDoubleVal(b, &outMin);
+	if (err) return errFailed;
+	err = slotDoubleVal(c, &outMax);
+	if (err) return errFailed;
+
+	size = obj1->size;
+	format = obj1->obj_format;
+	if (format != obj_slot && format != obj_double && format != obj_float)
+		return errFailed;
+
+	lo = std::numeric_limits<double>::infinity();
+	hi = -std::numeric_limits<double>::infinity();
+	for (i=0; i<size; ++i) {
+		err = getIndexedDouble(obj1, i, &w);
+		if (err) return errFailed;
+		if (w < lo) lo = w;
+		if (w > hi) hi = w;
+	}
+	scale = hi > lo ? (outMax - outMin) / (hi - lo) : 0.;
+
+	obj2 = instantiateObject(g->gc, obj1->classptr, size, false, true);
+	switch (format) {
+		case obj_slot : {
+			PyrSlot *slots2 = obj2->slots;
+			for (i=0; i<size; ++i) {
+				getIndexedDouble(obj1, i, &w);
+				SetFloat(slots2 + i, (w - lo) * scale + outMin);
+			}
+		} break;
+		case obj_double : {
+			double *p1 = (double*)obj1->slots;
+			double *p2 = (double*)obj2->slots;
+			for (i=0; i<size; ++i) p2[i] = (p1[i] - lo) * scale + outMin;
+		} break;
+		case obj_float : {
+			float *p1 = (float*)obj1->slots;
+			float *p2 = (float*)obj2->slots;
+			for (i=0; i<size; ++i) p2[i] = (float)((p1[i] - lo) * scale + outMin);
+		} break;
+	}
+	obj2->size = size;
+	SetRaw(a, obj2);
+	return errNone;
+}
+
 
 
 
@@ -2406,6 +2576,9 @@ void initArrayPrimitives()
 	definePrimitive(base, index++, "_ArrayIndexOf", prArrayIndexOf, 2, 0);
 
 	definePrimitive(base, index++, "_ArrayNormalizeSum", prArrayNormalizeSum, 1, 0);
+	definePrimitive(base, index++, "_ArrayFillSeries", prArrayFillSeries, 3, 0);
+	definePrimitive(base, index++, "_ArraySum", prArraySum, 1, 0);
+	definePrimitive(base, index++, "_ArrayNormalize", prArrayNormalize, 3, 0);
 	definePrimitive(base, index++, "_ArrayWIndex", prArrayWIndex, 1, 0);
 	definePrimitive(base, index++, "_ArrayReverse", prArrayReverse, 1, 0);
 	definePrimitive(base, index++, "_ArrayScramble", prArrayScramble, 1, 0);
@@ -37,19 +37,32 @@ An object archiving system for SuperCollider.
 
 const int32 kDeepCopierObjectArrayInitialCapacity = 32;
 
+// template hierarchies (e.g. the Event prototypes copied for every pattern
+// spawn) are deep-copied over and over at much the same size; remembering
+// the high-water object count sizes the visitation table once up front
+// instead of growing and copying it several times per copy.
+static int32 gDeepCopierCapacityHint = kDeepCopierObjectArrayInitialCapacity;
+
 class PyrDeepCopier
 {
 public:
 	PyrDeepCopier(VMGlobals *inG)
 		: g(inG), objectArray(initialObjectArray), numObjects(0),
 		objectArrayCapacity( kDeepCopierObjectArrayInitialCapacity )
-	{}
+	{
+		if (gDeepCopierCapacityHint > kDeepCopierObjectArrayInitialCapacity) {
+			objectArray = (PyrObject**)g->allocPool->Alloc(gDeepCopierCapacityHint * sizeof(PyrObject*));
+			objectArrayCapacity = gDeepCopierCapacityHint;
+		}
+	}
 
 	~PyrDeepCopier()
 	{
 		if (objectArrayCapacity > kDeepCopierObjectArrayInitialCapacity) {
 			g->allocPool->Free(objectArray);
 		}
+		if (numObjects > gDeepCopierCapacityHint)
+			gDeepCopierCapacityHint = objectArrayCapacity;
 	}
 
 	long doDeepCopy(PyrSlot *objectSlot)
@@ -33,6 +33,10 @@ Primitives for File i/o.
 #include "SCBase.h"
 #include "SC_DirUtils.h"
 #include "sc_popen.h"
+#include "PyrSched.h"
+#include "SC_Lock.h"
+
+#include <functional>
 
 #include <stdlib.h>
 #include <string.h>
@@ -1727,6 +1731,163 @@ int prSFHeaderInfoString(struct VMGlobals *g, int numArgsPushed)
 
 /////////////
 
+// Asynchronous whole-file reads and writes. The work happens on a detached
+// worker thread (same scheme as unixCmd); on completion the thread grabs
+// gLangMutex and calls a File class method with the request id, which hands
+// the result to the registered action on AppClock. Bulk file scans can this
+// way keep interpreting while the disk is busy.
+
+extern bool compiledOK;
+
+PyrSymbol *s_doReadAllStringAction;
+PyrSymbol *s_doWriteAllStringAction;
+static PyrSymbol *s_fileclass;
+
+static int32 gFileAsyncID = 0; // primitives run under gLangMutex
+
+struct sc_file_read_request
+{
+	int32 id;
+	char path[PATH_MAX];
+};
+
+struct sc_file_write_request
+{
+	int32 id;
+	char path[PATH_MAX];
+	char *data;
+	size_t size;
+};
+
+static void file_read_all_thread_func(sc_file_read_request *request)
+{
+	char *data = NULL;
+	size_t size = 0;
+
+	FILE *file = fopen(request->path, "rb");
+	if (file) {
+		if (fseek(file, 0, SEEK_END) == 0) {
+			long length = ftell(file);
+			if (length >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+				data = (char*)malloc(length ? length : 1);
+				if (data) {
+					size = fread(data, 1, length, file);
+					if (size != (size_t)length) {
+						free(data);
+						data = NULL;
+					}
+				}
+			}
+		}
+		fclose(file);
+	}
+
+	gLangMutex.lock();
+	if (compiledOK) {
+		VMGlobals *g = gMainVMGlobals;
+		g->canCallOS = true;
+		++g->sp; SetObject(g->sp, s_fileclass->u.classobj);
+		++g->sp; SetInt(g->sp, request->id);
+		if (data) {
+			PyrString *string = newPyrStringN(g->gc, size, 0, true);
+			memcpy(string->s, data, size);
+			++g->sp; SetObject(g->sp, string);
+		} else {
+			++g->sp; SetNil(g->sp);
+		}
+		runInterpreter(g, s_doReadAllStringAction, 3);
+		g->canCallOS = false;
+	}
+	gLangMutex.unlock();
+
+	free(data);
+	delete request;
+}
+
+static void file_write_all_thread_func(sc_file_write_request *request)
+{
+	bool success = false;
+
+	FILE *file = fopen(request->path, "wb");
+	if (file) {
+		success = fwrite(request->data, 1, request->size, file) == request->size;
+		if (fclose(file)) success = false;
+	}
+
+	gLangMutex.lock();
+	if (compiledOK) {
+		VMGlobals *g = gMainVMGlobals;
+		g->canCallOS = true;
+		++g->sp; SetObject(g->sp, s_fileclass->u.classobj);
+		++g->sp; SetInt(g->sp, request->id);
+		++g->sp; SetBool(g->sp, success);
+		runInterpreter(g, s_doWriteAllStringAction, 3);
+		g->canCallOS = false;
+	}
+	gLangMutex.unlock();
+
+	free(request->data);
+	delete request;
+}
+
+int prFileReadAllStringAsync(struct VMGlobals *g, int numArgsPushed);
+int prFileReadAllStringAsync(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a = g->sp - 1;
+	PyrSlot *b = g->sp;
+
+	sc_file_read_request *request = new sc_file_read_request;
+	int err = slotStrVal(b, request->path, PATH_MAX);
+	if (err) {
+		delete request;
+		return err;
+	}
+	request->id = ++gFileAsyncID;
+
+	SC_Thread thread(std::bind(file_read_all_thread_func, request));
+	thread.detach();
+
+	SetInt(a, request->id);
+	return errNone;
+}
+
+int prFileWriteAllStringAsync(struct VMGlobals *g, int numArgsPushed);
+int prFileWriteAllStringAsync(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a = g->sp - 2;
+	PyrSlot *b = g->sp - 1;
+	PyrSlot *c = g->sp;
+
+	if (!isKindOfSlot(c, class_string)) return errWrongType;
+
+	sc_file_write_request *request = new sc_file_write_request;
+	int err = slotStrVal(b, request->path, PATH_MAX);
+	if (err) {
+		delete request;
+		return err;
+	}
+
+	// the string is copied out before the primitive returns; the worker must
+	// not touch GC memory.
+	PyrString *string = slotRawString(c);
+	request->size = string->size;
+	request->data = (char*)malloc(request->size ? request->size : 1);
+	if (!request->data) {
+		delete request;
+		return errFailed;
+	}
+	memcpy(request->data, string->s, request->size);
+	request->id = ++gFileAsyncID;
+
+	SC_Thread thread(std::bind(file_write_all_thread_func, request));
+	thread.detach();
+
+	SetInt(a, request->id);
+	return errNone;
+}
+
+/////////////
+
 void initFilePrimitives()
 {
 	int base, index;
@@ -1734,6 +1895,13 @@ void initFilePrimitives()
 	base = nextPrimitiveIndex();
 	index = 0;
 
+	s_doReadAllStringAction = getsym("doReadAllStringAction");
+	s_doWriteAllStringAction = getsym("doWriteAllStringAction");
+	s_fileclass = getsym("File");
+
+	definePrimitive(base, index++, "_FileReadAllStringAsync", prFileReadAllStringAsync, 2, 0);
+	definePrimitive(base, index++, "_FileWriteAllStringAsync", prFileWriteAllStringAsync, 3, 0);
+
 	definePrimitive(base, index++, "_SFOpenRead", prSFOpenRead, 2, 0);
 	definePrimitive(base, index++, "_SFOpenWrite", prSFOpenWrite, 2, 0);
 	definePrimitive(base, index++, "_SFClose", prSFClose, 1, 0);
@@ -178,6 +178,51 @@ int arrayAtIdentityHashInPairs(PyrObject *array, PyrSlot *key)
 }
 
 
+// layout hint cache for symbol keys in identity dictionaries. dictionaries
+// built from the same key set - every Event a pattern streams shares the same
+// dozen keys - place each key at the same index in their pair arrays, since
+// the probe sequence only depends on the cached symbol hashes and the array
+// capacity. remembering (symbol, capacity) -> index therefore serves whole
+// families of dictionaries at once. entries are hints, not truth: a hit is
+// verified against the array before use, so stale entries merely fall back
+// to the normal probe.
+struct IdentDictLayoutHint
+{
+	PyrSymbol *symbol;
+	int arraySize;
+	int index;
+};
+
+const int kLayoutHintTableSize = 1024; // power of two
+static IdentDictLayoutHint gLayoutHints[kLayoutHintTableSize];
+
+static inline IdentDictLayoutHint* identDictLayoutHint(PyrSymbol *symbol, int arraySize)
+{
+	unsigned int h = (unsigned int)symbol->hash ^ ((unsigned int)arraySize * 2654435761u);
+	return gLayoutHints + (h & (kLayoutHintTableSize - 1));
+}
+
+// returns the key's index in the pair array, or -1 when the hint misses.
+static inline int identDictLayoutHintLookup(PyrObject *array, PyrSlot *key)
+{
+	if (!IsSym(key)) return -1;
+	IdentDictLayoutHint *hint = identDictLayoutHint(slotRawSymbol(key), array->size);
+	int index = hint->index;
+	if (hint->symbol == slotRawSymbol(key) && hint->arraySize == array->size
+			&& index < array->size && SlotEq(array->slots + index, key))
+		return index;
+	return -1;
+}
+
+static inline void identDictLayoutHintStore(PyrObject *array, PyrSlot *key, int index)
+{
+	if (!IsSym(key)) return;
+	IdentDictLayoutHint *hint = identDictLayoutHint(slotRawSymbol(key), array->size);
+	hint->symbol = slotRawSymbol(key);
+	hint->arraySize = array->size;
+	hint->index = index;
+}
+
 int arrayAtIdentityHashInPairsWithHash(PyrObject *array, PyrSlot *key, int hash)
 {
 	PyrSlot *slots, *test;
@@ -226,7 +271,12 @@ int identDictPut(struct VMGlobals *g, PyrObject *dict, PyrSlot *key, PyrSlot *va
 	if (array->IsImmutable()) return errImmutableObject;
 	if (!isKindOf((PyrObject*)array, class_array)) return errFailed;
 
-	index = arrayAtIdentityHashInPairs(array, key);
+	index = identDictLayoutHintLookup(array, key);
+	if (index < 0) {
+		index = arrayAtIdentityHashInPairs(array, key);
+		if (index >= 0)
+			identDictLayoutHintStore(array, key, index);
+	}
 	slot = array->slots + index;
 	slotCopy(&slot[1],value);
 	g->gc->GCWrite(array, value);
@@ -351,8 +401,15 @@ again:
 	if (isKindOfSlot(arraySlot, class_array)) {
 		PyrObject *array = slotRawObject(arraySlot);
 
-		int index = arrayAtIdentityHashInPairsWithHash(array, key, hash);
+		int index = identDictLayoutHintLookup(array, key);
+		if (index >= 0) {
+			slotCopy(result,&array->slots[index + 1]);
+			return true;
+		}
+
+		index = arrayAtIdentityHashInPairsWithHash(array, key, hash);
 		if (SlotEq(key, array->slots + index)) {
+			identDictLayoutHintStore(array, key, index);
 			slotCopy(result,&array->slots[index + 1]);
 			return true;
 		}
@@ -388,8 +445,15 @@ again:
 	if (isKindOfSlot(arraySlot, class_array)) {
 		PyrObject *array = slotRawObject(arraySlot);
 
-		int index = arrayAtIdentityHashInPairsWithHash(array, key, hash);
+		int index = identDictLayoutHintLookup(array, key);
+		if (index >= 0) {
+			slotCopy(result,&array->slots[index + 1]);
+			return true;
+		}
+
+		index = arrayAtIdentityHashInPairsWithHash(array, key, hash);
 		if (SlotEq(key, array->slots + index)) {
+			identDictLayoutHintStore(array, key, index);
 			slotCopy(result,&array->slots[index + 1]);
 			return true;
 		}
@@ -2033,6 +2033,76 @@ int prGCSanity(struct VMGlobals *g, int numArgsPushed)
 	return errNone;
 }
 
+int prGCProfileStart(struct VMGlobals *g, int numArgsPushed);
+int prGCProfileStart(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *b = g->sp;
+	int interval;
+	int err = slotIntVal(b, &interval);
+	if (err) return err;
+
+	if (!g->gc->ProfileStart(interval)) return errFailed;
+	return errNone;
+}
+
+int prGCProfileStop(struct VMGlobals *g, int numArgsPushed);
+int prGCProfileStop(struct VMGlobals *g, int numArgsPushed)
+{
+	g->gc->ProfileStop();
+	return errNone;
+}
+
+int prGCProfileClear(struct VMGlobals *g, int numArgsPushed);
+int prGCProfileClear(struct VMGlobals *g, int numArgsPushed)
+{
+	g->gc->ProfileClear();
+	return errNone;
+}
+
+int prGCProfileDump(struct VMGlobals *g, int numArgsPushed);
+int prGCProfileDump(struct VMGlobals *g, int numArgsPushed)
+{
+	g->gc->DumpProfile();
+	return errNone;
+}
+
+// returns an array of [class name, sample count, sampled bytes] triples,
+// or nil when the profiler was never started.
+int prGCProfileReport(struct VMGlobals *g, int numArgsPushed);
+int prGCProfileReport(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a = g->sp;
+	PyrGC *gc = g->gc;
+
+	const PyrGC::ProfileEntry *table = gc->ProfileTable();
+	if (!table) {
+		SetNil(a);
+		return errNone;
+	}
+
+	int used = 0;
+	for (int i=0; i<PyrGC::kProfileTableSize; ++i) {
+		if (table[i].mClass) used++;
+	}
+
+	PyrObject *result = newPyrArray(gc, used, 0, true);
+	SetObject(a, result);
+	for (int i=0; i<PyrGC::kProfileTableSize && result->size < used; ++i) {
+		// the profiler may still be running: entries never move, but new ones
+		// can appear while the rows below are allocated, hence the size guard
+		if (!table[i].mClass) continue;
+		PyrObject *row = newPyrArray(gc, 3, 0, true);
+		SetSymbol(row->slots+0, slotRawSymbol(&table[i].mClass->name));
+		SetInt(row->slots+1, table[i].mNumSamples);
+		SetFloat(row->slots+2, (double)table[i].mSampledBytes);
+		row->size = 3;
+		SetObject(result->slots + result->size, row);
+		g->gc->GCWriteNew(result, row); // we know row is white so we can use GCWriteNew
+		result->size++;
+	}
+	return errNone;
+}
+
 #if GCDEBUG
 int prTraceAllPathsTo(struct VMGlobals *g, int numArgsPushed);
 int prTraceAllPathsTo(struct VMGlobals *g, int numArgsPushed)
@@ -2504,6 +2574,30 @@ int prFunDef_VarArgs(struct VMGlobals *g, int numArgsPushed)
 	return errNone;
 }
 
+int prFunDef_CallCount(struct VMGlobals *g, int numArgsPushed);
+int prFunDef_CallCount(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a;
+	PyrMethodRaw *methraw;
+
+	a = g->sp;
+	methraw = METHRAW(slotRawBlock(a));
+	SetInt(a, methraw->callCount);
+	return errNone;
+}
+
+int prFunDef_ResetCallCount(struct VMGlobals *g, int numArgsPushed);
+int prFunDef_ResetCallCount(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a;
+	PyrMethodRaw *methraw;
+
+	a = g->sp;
+	methraw = METHRAW(slotRawBlock(a));
+	methraw->callCount = 0;
+	return errNone;
+}
+
 
 int undefinedPrimitive(struct VMGlobals *g, int numArgsPushed)
 {
@@ -2552,7 +2646,6 @@ int prObjectRespondsTo(struct VMGlobals *g, int numArgsPushed)
 {
 	PyrSlot *a, *b;
 	PyrClass *classobj;
-	PyrMethod *meth;
 	PyrSymbol *selector;
 	int index;
 
@@ -2565,8 +2658,7 @@ int prObjectRespondsTo(struct VMGlobals *g, int numArgsPushed)
 
 		selector = slotRawSymbol(b);
 		index = slotRawInt(&classobj->classIndex) + selector->u.index;
-		meth = gRowTable[index];
-		if (slotRawSymbol(&meth->name) != selector) {
+		if (gRowTable[index].selector != selector) {
 			slotCopy(a,&o_false);
 		} else {
 			slotCopy(a,&o_true);
@@ -2580,8 +2672,7 @@ int prObjectRespondsTo(struct VMGlobals *g, int numArgsPushed)
 
 			selector = slotRawSymbol(slot);
 			index = slotRawInt(&classobj->classIndex) + selector->u.index;
-			meth = gRowTable[index];
-			if (slotRawSymbol(&meth->name) != selector) {
+			if (gRowTable[index].selector != selector) {
 				slotCopy(a,&o_false);
 				return errNone;
 			}
@@ -2607,8 +2698,8 @@ PyrMethod* GetFunctionCompileContext(VMGlobals* g)
 	// lookup functionCompileContext method
 	contextsym = getsym("functionCompileContext");
 	int index = slotRawInt(&classobj->classIndex) + contextsym->u.index;
-	meth = gRowTable[index];
-	if (!meth || slotRawSymbol(&meth->name) != contextsym) {
+	meth = gRowTable[index].method;
+	if (!meth || gRowTable[index].selector != contextsym) {
 		error("compile context method 'functionCompileContext' not found.\n");
 		return 0;
 	}
@@ -2875,10 +2966,14 @@ void switchToThread(VMGlobals *g, PyrThread *newthread, int oldstate, int *numAr
 	//gcDumpInfo(g->gc);
 	gc = g->gc;
 
-	// save environment in oldthread
+	// save environment in oldthread. almost always unchanged when bouncing
+	// between a pattern stream and its parent, so skip the store and the
+	// write barrier in that case.
 	PyrSlot* currentEnvironmentSlot = &g->classvars->slots[1];
-	slotCopy(&oldthread->environment,currentEnvironmentSlot);
-	gc->GCWrite(oldthread, currentEnvironmentSlot);
+	if (!SlotEq(&oldthread->environment, currentEnvironmentSlot)) {
+		slotCopy(&oldthread->environment,currentEnvironmentSlot);
+		gc->GCWrite(oldthread, currentEnvironmentSlot);
+	}
 
 	SetRaw(&oldthread->state, oldstate);
 
@@ -2981,8 +3076,10 @@ void switchToThread(VMGlobals *g, PyrThread *newthread, int oldstate, int *numAr
 
 
         // set new environment
-        slotCopy(currentEnvironmentSlot,&g->thread->environment);
-        g->gc->GCWrite(g->classvars, currentEnvironmentSlot);
+        if (!SlotEq(currentEnvironmentSlot, &g->thread->environment)) {
+            slotCopy(currentEnvironmentSlot,&g->thread->environment);
+            g->gc->GCWrite(g->classvars, currentEnvironmentSlot);
+        }
 
 	//post("old thread %p stack %p\n", oldthread, slotRawObject(&oldthread->stack));
 	//post("new thread %p stack %p\n", g->thread, slotRawObject(&g->thread->stack));
@@ -3255,6 +3352,20 @@ int prRoutineAlwaysYield(struct VMGlobals *g, int numArgsPushed)
 	return errNone;
 }
 
+// Every stream `next` comes through prRoutineResume, for pattern playback
+// typically thousands of times per second, so the per-resume bookkeeping is
+// kept minimal: beats and seconds are float slots and need no write barrier,
+// and the clock slot rarely changes between resumes of the same routine.
+static inline void routineInheritTime(VMGlobals *g, PyrThread *thread)
+{
+	slotCopy(&thread->beats, &g->thread->beats);
+	slotCopy(&thread->seconds, &g->thread->seconds);
+	if (!SlotEq(&thread->clock, &g->thread->clock)) {
+		slotCopy(&thread->clock, &g->thread->clock);
+		g->gc->GCWrite(thread, &g->thread->clock);
+	}
+}
+
 int prRoutineResume(struct VMGlobals *g, int numArgsPushed);
 int prRoutineResume(struct VMGlobals *g, int numArgsPushed)
 {
@@ -3282,12 +3393,7 @@ int prRoutineResume(struct VMGlobals *g, int numArgsPushed)
 		SetObject(&thread->parent, g->thread);
 		g->gc->GCWrite(thread, g->thread);
 
-		slotCopy(&thread->beats, &g->thread->beats);
-		slotCopy(&thread->seconds, &g->thread->seconds);
-		slotCopy(&thread->clock, &g->thread->clock);
-		g->gc->GCWrite(thread, &g->thread->beats);
-		g->gc->GCWrite(thread, &g->thread->seconds);
-		g->gc->GCWrite(thread, &g->thread->clock);
+		routineInheritTime(g, thread);
 
 		//postfl("start into thread %p from parent %p\n", thread, g->thread);
 		switchToThread(g, thread, tSuspended, &numArgsPushed);
@@ -3304,15 +3410,10 @@ int prRoutineResume(struct VMGlobals *g, int numArgsPushed)
 
 		if (IsNil(&thread->parent)) {
 			SetObject(&thread->parent, g->thread);
+			g->gc->GCWrite(thread, g->thread);
 		}
-		g->gc->GCWrite(thread, g->thread);
 
-		slotCopy(&thread->beats, &g->thread->beats);
-		slotCopy(&thread->seconds, &g->thread->seconds);
-		slotCopy(&thread->clock,&g->thread->clock);
-		g->gc->GCWrite(thread, &g->thread->beats);
-		g->gc->GCWrite(thread, &g->thread->seconds);
-		g->gc->GCWrite(thread, &g->thread->clock);
+		routineInheritTime(g, thread);
 
 		slotCopy(&value,b);
 	//debugf("resume into thread %p from parent %p\n", thread, g->thread);
@@ -3782,6 +3883,44 @@ int nextPrimitiveIndex()
 }
 
 
+#if defined(__GNUC__)
+#define PRIM_LIKELY(x)       __builtin_expect((x),1)
+#define PRIM_UNLIKELY(x)     __builtin_expect((x),0)
+#else
+#define PRIM_LIKELY(x)   x
+#define PRIM_UNLIKELY(x) x
+#endif
+
+// arity correction for calls that did not push exactly the declared number
+// of arguments. kept out of line so the common exact-arity call runs
+// straight through doPrimitive.
+static int prFixupArgCount(VMGlobals* g, PyrMethod* meth, PrimitiveDef* def, int numArgsNeeded, int numArgsPushed)
+{
+	int diff = numArgsNeeded - numArgsPushed;
+	if (diff > 0) {  // not enough args
+		PyrSlot* pslot = g->sp;
+		PyrSlot* qslot = slotRawObject(&meth->prototypeFrame)->slots + numArgsPushed - 1;
+		for (int m=0; m<diff; ++m) slotCopy(++pslot, ++qslot);
+
+		g->sp += diff;
+	} else if (def->varArgs) { // has var args
+		numArgsNeeded = numArgsPushed;
+	} else {
+		g->sp += diff; // remove excess args
+	}
+	return numArgsNeeded;
+}
+
+// failure path: record the error on the thread and run the method body as
+// the fallback implementation. out of line for the same reason as above.
+static void prFailed(VMGlobals* g, PyrMethod* meth, int err, int numArgsNeeded)
+{
+	//post("primitive failed %s:%s\n", slotRawSymbol(&slotRawClass(&meth->ownerclass)->name)->name, slotRawSymbol(&meth->name)->name);
+	SetInt(&g->thread->primitiveIndex, METHRAW(meth)->specialIndex);
+	SetInt(&g->thread->primitiveError, err);
+	executeMethod(g, meth, numArgsNeeded);
+}
+
 void doPrimitive(VMGlobals* g, PyrMethod* meth, int numArgsPushed)
 {
 
@@ -3797,21 +3936,10 @@ void doPrimitive(VMGlobals* g, PyrMethod* meth, int numArgsPushed)
 
 	PrimitiveDef *def = gPrimitiveTable.table + primIndex;
 	int numArgsNeeded = def->numArgs;
-	int diff = numArgsNeeded - numArgsPushed;
 
-	if (diff != 0) { // incorrect num of args
-		if (diff > 0) {  // not enough args
-			PyrSlot* pslot = g->sp;
-			PyrSlot* qslot = slotRawObject(&meth->prototypeFrame)->slots + numArgsPushed - 1;
-			for (int m=0; m<diff; ++m) slotCopy(++pslot, ++qslot);
+	if (PRIM_UNLIKELY(numArgsNeeded != numArgsPushed)) // incorrect num of args
+		numArgsNeeded = prFixupArgCount(g, meth, def, numArgsNeeded, numArgsPushed);
 
-			g->sp += diff;
-		} else if (def->varArgs) { // has var args
-			numArgsNeeded = numArgsPushed;
-		} else {
-			g->sp += diff; // remove excess args
-		}
-	}
 	g->numpop = numArgsNeeded - 1;
 	g->primitiveIndex = primIndex - def->base;
 	g->primitiveMethod = meth;
@@ -3832,13 +3960,8 @@ void doPrimitive(VMGlobals* g, PyrMethod* meth, int numArgsPushed)
 		g->lastExceptions[g->thread] = std::make_pair(nullptr, meth);
 		err = errException;
 	}
-	if (err <= errNone) g->sp -= g->numpop;
-	else {
-		//post("primitive failed %s:%s\n", slotRawSymbol(&slotRawClass(&meth->ownerclass)->name)->name, slotRawSymbol(&meth->name)->name);
-		SetInt(&g->thread->primitiveIndex, methraw->specialIndex);
-		SetInt(&g->thread->primitiveError, err);
-		executeMethod(g, meth, numArgsNeeded);
-	}
+	if (PRIM_LIKELY(err <= errNone)) g->sp -= g->numpop;
+	else prFailed(g, meth, err, numArgsNeeded);
 #ifdef GC_SANITYCHECK
 	g->gc->SanityCheck();
 #endif
@@ -4116,6 +4239,11 @@ void initPrimitives()
 	definePrimitive(base, index++, "_GCDumpGrey", dumpGCdumpGrey, 1, 0);
 	definePrimitive(base, index++, "_GCDumpSet", dumpGCdumpSet, 2, 0);
 	definePrimitive(base, index++, "_GCSanity", prGCSanity, 1, 0);
+	definePrimitive(base, index++, "_GCProfileStart", prGCProfileStart, 2, 0);
+	definePrimitive(base, index++, "_GCProfileStop", prGCProfileStop, 1, 0);
+	definePrimitive(base, index++, "_GCProfileClear", prGCProfileClear, 1, 0);
+	definePrimitive(base, index++, "_GCProfileDump", prGCProfileDump, 1, 0);
+	definePrimitive(base, index++, "_GCProfileReport", prGCProfileReport, 1, 0);
 #if GCDEBUG
 	definePrimitive(base, index++, "_TraceAllPathsTo", prTraceAllPathsTo, 1, 0);
 	definePrimitive(base, index++, "_TraceAnyPathsTo", prTraceAnyPathsTo, 1, 0);
@@ -4178,6 +4306,8 @@ void initPrimitives()
 	definePrimitive(base, index++, "_FunDef_NumArgs", prFunDef_NumArgs, 1, 0);
 	definePrimitive(base, index++, "_FunDef_NumVars", prFunDef_NumVars, 1, 0);
 	definePrimitive(base, index++, "_FunDef_VarArgs", prFunDef_VarArgs, 1, 0);
+	definePrimitive(base, index++, "_FunDef_CallCount", prFunDef_CallCount, 1, 0);
+	definePrimitive(base, index++, "_FunDef_ResetCallCount", prFunDef_ResetCallCount, 1, 0);
 
 	definePrimitive(base, index++, "_Thread_Init", prThreadInit, 3, 0);
 	definePrimitive(base, index++, "_Thread_RandSeed", prThreadRandSeed, 2, 0);
@@ -233,12 +233,15 @@ const double fSECONDS_FROM_1900_to_1970 = 2208988800.; /* 17 leap years */
 static void syncOSCOffsetWithTimeOfDay();
 void resyncThread();
 
-// Use the highest resolution clock available for monotonic clock time
+// Use the highest resolution clock available for monotonic clock time.
+// all scheduler arithmetic and waits run on this clock: where
+// high_resolution_clock is an alias of the (adjustable) system clock, an
+// NTP step would otherwise stall or rush every pending task.
 using monotonic_clock = std::conditional<std::chrono::high_resolution_clock::is_steady,
 										  std::chrono::high_resolution_clock,
 										  std::chrono::steady_clock>::type;
 
-static std::chrono::high_resolution_clock::time_point hrTimeOfInitialization;
+static monotonic_clock::time_point hrTimeOfInitialization;
 
 template <typename DurationType>
 inline double DurToFloat(DurationType dur)
@@ -253,7 +256,7 @@ inline double DurToFloat(DurationType dur)
 SCLANG_DLLEXPORT_C void schedInit()
 {
 	using namespace std::chrono;
-	hrTimeOfInitialization     = high_resolution_clock::now();
+	hrTimeOfInitialization     = monotonic_clock::now();
 
 	syncOSCOffsetWithTimeOfDay();
 	gResyncThread = std::thread(resyncThread);
@@ -270,7 +273,7 @@ SCLANG_DLLEXPORT_C void schedCleanup()
 
 double elapsedTime()
 {
-return DurToFloat(std::chrono::high_resolution_clock::now() - hrTimeOfInitialization);
+return DurToFloat(monotonic_clock::now() - hrTimeOfInitialization);
 }
 
 double monotonicClockTime()
@@ -329,9 +332,9 @@ void syncOSCOffsetWithTimeOfDay()
 	const int numberOfTries = 8;
 	int64 newOffset = gHostOSCoffset;
 	for (int i=0; i<numberOfTries; ++i) {
-		systemTimeBefore = high_resolution_clock::now().time_since_epoch();
+		systemTimeBefore = monotonic_clock::now().time_since_epoch();
 		gettimeofday(&tv, 0);
-		systemTimeAfter = high_resolution_clock::now().time_since_epoch();
+		systemTimeAfter = monotonic_clock::now().time_since_epoch();
 
 		diff = (systemTimeAfter - systemTimeBefore).count();
 		if (diff < minDiff) {
@@ -361,7 +364,14 @@ void schedAdd(VMGlobals *g, PyrObject* inQueue, double inSeconds, PyrSlot* inTas
 		if (isKindOfSlot(inTask, class_thread)) {
 			SetFloat(&slotRawThread(inTask)->nextBeat, inSeconds);
 		}
-		if (slotRawFloat(inQueue->slots + 1) != prevTime) {
+		// only wake the scheduler thread when the head of the queue moved,
+		// and never from the scheduler thread itself: its run loop re-reads
+		// the head after every awake, and a notify from under the language
+		// mutex would just make it block again immediately. tempo-heavy
+		// patches reschedule thousands of tasks per drain, so these futile
+		// wakeups add up.
+		if (slotRawFloat(inQueue->slots + 1) != prevTime
+				&& std::this_thread::get_id() != gSchedThread.get_id()) {
 			gSchedCond.notify_all();
 		}
 	}
@@ -442,11 +452,11 @@ static void schedRunFunc()
 		//postfl("wait until an event is ready\n");
 
 		// wait until an event is ready
-		high_resolution_clock::duration schedSecs;
-		high_resolution_clock::time_point now, schedPoint;
+		monotonic_clock::duration schedSecs;
+		monotonic_clock::time_point now, schedPoint;
 		do {
-			now = high_resolution_clock::now();
-			schedSecs = duration_cast<high_resolution_clock::duration>(duration<double>(slotRawFloat(inQueue->slots + 1)));
+			now = monotonic_clock::now();
+			schedSecs = duration_cast<monotonic_clock::duration>(duration<double>(slotRawFloat(inQueue->slots + 1)));
 			schedPoint = hrTimeOfInitialization + schedSecs;
 			if(now >= schedPoint) break;
 			//postfl("wait until an event is ready\n");
@@ -459,7 +469,7 @@ static void schedRunFunc()
 
 		// perform all events that are ready
 		//postfl("perform all events that are ready\n");
-		while ((inQueue->size > 1) && now >= hrTimeOfInitialization + duration_cast<high_resolution_clock::duration>(duration<double>(slotRawFloat(inQueue->slots + 1)))) {
+		while ((inQueue->size > 1) && now >= hrTimeOfInitialization + duration_cast<monotonic_clock::duration>(duration<double>(slotRawFloat(inQueue->slots + 1)))) {
 			double schedtime, delta;
 			PyrSlot task;
 
@@ -699,6 +709,11 @@ public:
 		{ return (beats - mBaseBeats) * mBeatDur + mBaseSeconds; }
 	double SecsToBeats(double secs) const
 		{ return (secs - mBaseSeconds) * mTempo + mBaseBeats; }
+	// wake the clock thread to recompute its next wakeup time, unless we
+	// are the clock thread: the run loop re-reads the queue head anyway,
+	// and self-notifies during a reschedule drain are pure overhead.
+	void WakeThread()
+		{ if (std::this_thread::get_id() != mThread.get_id()) mCondition.notify_one(); }
 	void Dump();
 
 //protected:
@@ -812,7 +827,7 @@ void TempoClock::SetAll(double inTempo, double inBeats, double inSeconds)
 	mBaseBeats = inBeats;
 	mTempo = inTempo;
 	mBeatDur = 1. / mTempo;
-	mCondition.notify_one();
+	WakeThread();
 }
 
 void TempoClock::SetTempoAtBeat(double inTempo, double inBeats)
@@ -821,7 +836,7 @@ void TempoClock::SetTempoAtBeat(double inTempo, double inBeats)
 	mBaseBeats = inBeats;
 	mTempo = inTempo;
 	mBeatDur = 1. / mTempo;
-	mCondition.notify_one();
+	WakeThread();
 }
 
 void TempoClock::SetTempoAtTime(double inTempo, double inSeconds)
@@ -830,7 +845,7 @@ void TempoClock::SetTempoAtTime(double inTempo, double inSeconds)
 	mBaseSeconds = inSeconds;
 	mTempo = inTempo;
 	mBeatDur = 1. / mTempo;
-	mCondition.notify_one();
+	WakeThread();
 }
 
 double TempoClock::ElapsedBeats()
@@ -859,8 +874,8 @@ void* TempoClock::Run()
 
 		// wait until an event is ready
 		double elapsedBeats;
-		high_resolution_clock::duration schedSecs;
-		high_resolution_clock::time_point schedPoint;
+		monotonic_clock::duration schedSecs;
+		monotonic_clock::time_point schedPoint;
 		do {
 			elapsedBeats = ElapsedBeats();
 			if (elapsedBeats >= slotRawFloat(mQueue->slots)) break;
@@ -868,7 +883,7 @@ void* TempoClock::Run()
 			//printf("event ready at %g . elapsed beats %g\n", mQueue->slots->uf, elapsedBeats);
 			double wakeTime = BeatsToSecs(slotRawFloat(mQueue->slots));
 
-			schedSecs = duration_cast<high_resolution_clock::duration>(duration<double>(wakeTime));
+			schedSecs = duration_cast<monotonic_clock::duration>(duration<double>(wakeTime));
 			schedPoint = hrTimeOfInitialization + schedSecs;
 
 			//printf("wait until an event is ready. wake %g  now %g\n", wakeTime, elapsedTime());
@@ -950,7 +965,7 @@ void TempoClock::Add(double inBeats, PyrSlot* inTask)
 			SetFloat(&slotRawThread(inTask)->nextBeat, inBeats);
 		}
 		if (slotRawFloat(mQueue->slots) != prevBeats)
-			mCondition.notify_one();
+			WakeThread();
 	}
 }
 
@@ -958,7 +973,7 @@ void TempoClock::Clear()
 {
 	if (mRun) {
 		mQueue->size = 1;
-		mCondition.notify_one();
+		WakeThread();
 	}
 }
 
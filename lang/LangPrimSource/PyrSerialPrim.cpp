@@ -84,6 +84,18 @@ public:
 	static const int kBufferSize = 8192;
 	static const int kReadTimeoutMs = 1000;
 
+	// byte-wise delivery (the classic `next`) wakes the language per select
+	// batch and then pays one primitive call per byte. With framing enabled
+	// the rx thread only wakes the language when a whole frame (or, with
+	// kNoFraming, any batch) is available, and `nextFrame` hands it over in
+	// one call.
+	enum FramingMode
+	{
+		kNoFraming,		// any received batch is a delivery
+		kDelimiterFraming,	// frames end at a delimiter byte
+		kLengthFraming		// fixed length frames
+	};
+
 	typedef SC_FIFO<uint8_t,kBufferSize> FIFO;
 
 	struct Error : std::runtime_error
@@ -115,6 +127,9 @@ public:
 	bool get(uint8_t* byte);
 	int rxErrors();
 
+	void setFraming(FramingMode mode, int param);
+	const uint8_t* nextFrame(int& outSize);
+
 	void stop();
 	void cleanup();
 	bool isCurrentThread() const;
@@ -143,6 +158,18 @@ private:
 	FIFO			m_rxfifo;
 	uint8_t			m_rxbuffer[kBufferSize];
 
+	// framing. the rx thread reads mode/param and counts bytes and
+	// delimiters as it fills the fifo, so it can decide whether a wakeup is
+	// due without scanning; the pending buffer on the reader side is only
+	// ever touched with the language lock held.
+	std::atomic<int>	m_framingMode;
+	std::atomic<int>	m_framingParam;
+	std::atomic<int>	m_rxAvailable;
+	std::atomic<int>	m_framesAvailable;
+	uint8_t			m_pending[2*kBufferSize];
+	int			m_pendingSize;
+	int			m_consumePending;
+
 	// rx thread
 	std::atomic<bool>	m_running;
 	SC_Thread				m_thread;
@@ -339,6 +366,13 @@ SerialPort::SerialPort(PyrObject* obj, const char* serialport, const Options& op
 
 	m_rxErrors[0] = m_rxErrors[1] = 0;
 
+	m_framingMode = kNoFraming;
+	m_framingParam = 0;
+	m_rxAvailable = 0;
+	m_framesAvailable = 0;
+	m_pendingSize = 0;
+	m_consumePending = 0;
+
 	try {
 		SC_Thread thread(std::bind(&SerialPort::threadLoop, this));
 		m_thread = std::move(thread);
@@ -398,9 +432,91 @@ bool SerialPort::get(uint8_t* byte)
 	if (m_rxfifo.IsEmpty())
 		return false;
 	*byte = m_rxfifo.Get() & 0xFF;
+	m_rxAvailable--;
+	if ((m_framingMode == kDelimiterFraming) && (*byte == (uint8_t)m_framingParam.load())
+			&& (m_framesAvailable > 0))
+		m_framesAvailable--;
 	return true;
 }
 
+void SerialPort::setFraming(FramingMode mode, int param)
+{
+	m_framingParam = param;
+	m_framingMode = mode;
+	// delimiters are counted as bytes arrive; what is already buffered is
+	// not rescanned, so a frame completed before the call is delivered with
+	// the next wakeup
+	if (mode != kDelimiterFraming)
+		m_framesAvailable = 0;
+}
+
+// deliver the next complete frame (or, without framing, the whole batch)
+// from the rx ring. returns a pointer into the internal pending buffer,
+// valid until the next call, or 0 when no complete frame is there yet.
+// called with the language lock held, like all primitives, so only the
+// language thread touches the pending buffer. don't mix with byte-wise get:
+// bytes drained in here are no longer visible to it.
+const uint8_t* SerialPort::nextFrame(int& outSize)
+{
+	outSize = 0;
+
+	// drop the frame handed out by the previous call
+	if (m_consumePending) {
+		memmove(m_pending, m_pending + m_consumePending, m_pendingSize - m_consumePending);
+		m_pendingSize -= m_consumePending;
+		m_consumePending = 0;
+	}
+
+	// drain the ring
+	while ((m_pendingSize < (int)sizeof(m_pending)) && !m_rxfifo.IsEmpty()) {
+		uint8_t byte = m_rxfifo.Get() & 0xFF;
+		m_rxAvailable--;
+		if ((m_framingMode == kDelimiterFraming) && (byte == (uint8_t)m_framingParam.load())
+				&& (m_framesAvailable > 0))
+			m_framesAvailable--;
+		m_pending[m_pendingSize++] = byte;
+	}
+
+	if (m_pendingSize == 0)
+		return 0;
+
+	switch (m_framingMode.load()) {
+		case kDelimiterFraming: {
+			uint8_t delimiter = (uint8_t)m_framingParam.load();
+			for (int i = 0; i < m_pendingSize; ++i) {
+				if (m_pending[i] == delimiter) {
+					outSize = i;	// the delimiter itself is not delivered
+					m_consumePending = i + 1;
+					return m_pending;
+				}
+			}
+			if (m_pendingSize == (int)sizeof(m_pending)) {
+				// no delimiter in a full pending buffer: hand it out as a
+				// batch so the stream cannot stall, and count an error
+				m_rxErrors[1]++;
+				outSize = m_pendingSize;
+				m_consumePending = m_pendingSize;
+				return m_pending;
+			}
+			return 0;
+		}
+		case kLengthFraming: {
+			int length = m_framingParam.load();
+			if (length <= 0) length = 1;
+			if (m_pendingSize < length)
+				return 0;
+			outSize = length;
+			m_consumePending = length;
+			return m_pending;
+		}
+		default: {
+			outSize = m_pendingSize;
+			m_consumePending = m_pendingSize;
+			return m_pending;
+		}
+	}
+}
+
 int SerialPort::rxErrors()
 {
 	// errors since last query
@@ -488,6 +604,10 @@ void SerialPort::threadLoop()
 								m_rxErrors[1]++;
 								break;
 							}
+							m_rxAvailable++;
+							if ((m_framingMode == kDelimiterFraming)
+									&& (m_rxbuffer[i] == (uint8_t)m_framingParam.load()))
+								m_framesAvailable++;
 						}
 						nr += n2;
 					} else if ((n2 == 0) && (n == 1) ) { // added by nescivi, to check for disconnected device. In this case the read is 0 all the time and otherwise eats up the CPU
@@ -509,7 +629,21 @@ void SerialPort::threadLoop()
 					goto done;
 				}
 				if (nr > 0) {
-					dataAvailable();
+					// with framing enabled, only wake the language when a
+					// whole frame is waiting
+					bool wake;
+					switch (m_framingMode.load()) {
+						case kDelimiterFraming:
+							wake = m_framesAvailable.load() > 0;
+							break;
+						case kLengthFraming:
+							wake = m_rxAvailable.load() >= m_framingParam.load();
+							break;
+						default:
+							wake = true;
+							break;
+					}
+					if (wake) dataAvailable();
 				}
 			} else if (n == -1) {
 				goto done;
@@ -648,6 +782,59 @@ static int prSerialPort_Next(struct VMGlobals *g, int numArgsPushed)
 	return errNone;
 }
 
+static int prSerialPort_SetFraming(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *args = g->sp - 2;
+
+	PyrSlot* self = args+0;
+	SerialPort* port = (SerialPort*)getSerialPort(self);
+	if (port == 0) return errFailed;
+
+	int mode;
+	int err = slotIntVal(args+1, &mode);
+	if (err) return err;
+	if (mode < SerialPort::kNoFraming || mode > SerialPort::kLengthFraming)
+		return errIndexOutOfRange;
+
+	PyrSlot* paramSlot = args+2;
+	int param;
+	if (IsChar(paramSlot)) {
+		param = slotRawChar(paramSlot);
+	} else {
+		err = slotIntVal(paramSlot, &param);
+		if (err) return err;
+	}
+
+	if (mode == SerialPort::kDelimiterFraming && (param < 0 || param > 255))
+		return errIndexOutOfRange;
+	if (mode == SerialPort::kLengthFraming
+			&& (param < 1 || param > SerialPort::kBufferSize))
+		return errIndexOutOfRange;
+
+	port->setFraming((SerialPort::FramingMode)mode, param);
+	return errNone;
+}
+
+static int prSerialPort_ReadFrame(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot* self = g->sp;
+	SerialPort* port = (SerialPort*)getSerialPort(self);
+	if (port == 0) return errFailed;
+
+	int size;
+	const uint8_t* frame = port->nextFrame(size);
+	if (frame) {
+		PyrInt8Array* array = newPyrInt8Array(g->gc, size, 0, true);
+		array->size = size;
+		memcpy(array->b, frame, size);
+		SetObject(self, (PyrObject*)array);
+	} else {
+		SetNil(self);
+	}
+
+	return errNone;
+}
+
 static int prSerialPort_Put(struct VMGlobals *g, int numArgsPushed)
 {
 	PyrSlot *args = g->sp - 1;
@@ -691,6 +878,8 @@ void initSerialPrimitives()
 	definePrimitive(base, index++, "_SerialPort_Open",     prSerialPort_Open, 2+SerialPort::kNumOptions, 0);
 	definePrimitive(base, index++, "_SerialPort_Close",    prSerialPort_Close, 1, 0);
 	definePrimitive(base, index++, "_SerialPort_Next",     prSerialPort_Next, 1, 0);
+	definePrimitive(base, index++, "_SerialPort_SetFraming", prSerialPort_SetFraming, 3, 0);
+	definePrimitive(base, index++, "_SerialPort_ReadFrame", prSerialPort_ReadFrame, 1, 0);
 	definePrimitive(base, index++, "_SerialPort_Put",      prSerialPort_Put, 2, 0);
 	definePrimitive(base, index++, "_SerialPort_RXErrors", prSerialPort_RXErrors, 1, 0);
 	definePrimitive(base, index++, "_SerialPort_Cleanup",    prSerialPort_Cleanup, 1, 0);
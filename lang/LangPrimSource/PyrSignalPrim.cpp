@@ -261,6 +261,45 @@ int prSignalOverWrite(struct VMGlobals *g, int numArgsPushed)
 	return errNone;
 }
 
+int prSignalAddInPlace(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a, *b;
+
+	a = g->sp - 1;
+	b = g->sp;
+
+	if (NotObj(b) || !isKindOf(slotRawObject(b), class_signal)) return errWrongType;
+
+	signal_add_ds_xx(g, slotRawObject(a), slotRawObject(b));
+	return errNone;
+}
+
+int prSignalSubInPlace(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a, *b;
+
+	a = g->sp - 1;
+	b = g->sp;
+
+	if (NotObj(b) || !isKindOf(slotRawObject(b), class_signal)) return errWrongType;
+
+	signal_sub_ds_xx(g, slotRawObject(a), slotRawObject(b));
+	return errNone;
+}
+
+int prSignalMulInPlace(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a, *b;
+
+	a = g->sp - 1;
+	b = g->sp;
+
+	if (NotObj(b) || !isKindOf(slotRawObject(b), class_signal)) return errWrongType;
+
+	signal_mul_ds_xx(g, slotRawObject(a), slotRawObject(b));
+	return errNone;
+}
+
 int prSignalFade(struct VMGlobals *g, int numArgsPushed)
 {
 	PyrSlot *a, *b, *c, *d, *e;
@@ -623,6 +662,9 @@ void initSignalPrimitives()
 	definePrimitive(base, index++, "_SignalOffset", prSignalOffset, 2, 0);
 	definePrimitive(base, index++, "_SignalOverDub", prSignalOverDub, 3, 0);
 	definePrimitive(base, index++, "_SignalOverWrite", prSignalOverWrite, 3, 0);
+	definePrimitive(base, index++, "_SignalAddInPlace", prSignalAddInPlace, 2, 0);
+	definePrimitive(base, index++, "_SignalSubInPlace", prSignalSubInPlace, 2, 0);
+	definePrimitive(base, index++, "_SignalMulInPlace", prSignalMulInPlace, 2, 0);
 	definePrimitive(base, index++, "_SignalFade", prSignalFade, 5, 0);
 	definePrimitive(base, index++, "_SignalAddHarmonic", prSignalAddHarmonic, 4, 0);
 	definePrimitive(base, index++, "_SignalAddChebyshev", prSignalAddChebyshev, 3, 0);
@@ -123,6 +123,40 @@ int prString_AsCompileString(struct VMGlobals *g, int numArgsPushed)
 	return errNone;
 }
 
+// one-pass concatenation of a string with an array of strings, sized up
+// front so a ++ reduction over n items costs one allocation instead of n.
+// any non-string element fails the primitive; String:catList then falls
+// back to its ++ loop, which coerces via asString.
+int prString_CatList(struct VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot *a = g->sp - 1;
+	PyrSlot *b = g->sp;
+
+	if (!isKindOfSlot(b, class_array)) return errFailed;
+
+	int asize = slotRawObject(a)->size;
+	int bsize = slotRawObject(b)->size;
+	PyrSlot *slots = slotRawObject(b)->slots;
+
+	int csize = asize;
+	for (int i=0; i<bsize; ++i) {
+		PyrSlot *slot = slots + i;
+		if (!isKindOfSlot(slot, class_string)) return errFailed;
+		csize += slotRawString(slot)->size;
+	}
+	PyrString *newString = newPyrStringN(g->gc, csize, 0, true);
+	char *buf = newString->s;
+	memcpy(buf, slotRawString(a)->s, asize);
+	int k = asize;
+	for (int i=0; i<bsize; ++i) {
+		PyrString *bstring = slotRawString(slots + i);
+		memcpy(buf+k, bstring->s, bstring->size);
+		k += bstring->size;
+	}
+	SetObject(a, newString);
+	return errNone;
+}
+
 int prString_Format(struct VMGlobals *g, int numArgsPushed)
 {
 	PyrSlot *a = g->sp - 1;
@@ -1105,6 +1139,7 @@ void initStringPrimitives()
 	definePrimitive(base, index++, "_String_Find", prString_Find, 4, 0);
 	definePrimitive(base, index++, "_String_FindBackwards", prString_FindBackwards, 4, 0);
 	definePrimitive(base, index++, "_String_Format", prString_Format, 2, 0);
+	definePrimitive(base, index++, "_String_CatList", prString_CatList, 2, 0);
 	definePrimitive(base, index++, "_String_Regexp", prString_Regexp, 4, 0);
 	definePrimitive(base, index++, "_String_FindRegexp", prString_FindRegexp, 3, 0);
 	definePrimitive(base, index++, "_String_FindRegexpAt", prString_FindRegexpAt, 3, 0);
@@ -40,6 +40,8 @@
 #include "SC_LanguageClient.h"
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 PyrSymbol* s_midiin;
@@ -96,6 +98,73 @@ struct SC_AlsaMidiPacket
 	uint8 data[kAlsaMaxPacketSize];
 };
 
+static const size_t kAlsaInputRingSize = 1024;	// power of two
+
+// Decoded events cross from the ALSA input thread to the delivery thread
+// through this single-writer single-reader ring. The delivery thread drains
+// a whole burst under one language lock acquisition, so a dense controller
+// sweep no longer costs one lock handoff per event, and the input thread
+// keeps reading from the sequencer even while the interpreter is busy.
+struct SC_AlsaInputRing
+{
+	struct Entry
+	{
+		snd_seq_event_t	evt;
+		uint8*			extData;	// deep copy of variable-length payloads (sysex)
+	};
+
+	Entry					mEntries[kAlsaInputRingSize];
+	std::atomic<uint32_t>	mWritePos { 0 };
+	std::atomic<uint32_t>	mReadPos { 0 };
+
+	bool HasData() const
+	{
+		return mReadPos.load(std::memory_order_acquire)
+			!= mWritePos.load(std::memory_order_acquire);
+	}
+
+	// called by the input thread only; fails when the ring is full
+	bool Write(const snd_seq_event_t* evt)
+	{
+		uint32_t writePos = mWritePos.load(std::memory_order_relaxed);
+		uint32_t readPos = mReadPos.load(std::memory_order_acquire);
+		if (writePos - readPos >= kAlsaInputRingSize) return false;
+		Entry& entry = mEntries[writePos & (kAlsaInputRingSize-1)];
+		entry.evt = *evt;
+		entry.extData = 0;
+		// the sequencer frees the event after this call, so variable-length
+		// payloads have to be copied out
+		if ((evt->flags & SND_SEQ_EVENT_LENGTH_MASK) == SND_SEQ_EVENT_LENGTH_VARIABLE
+				&& evt->data.ext.len > 0) {
+			entry.extData = (uint8*)malloc(evt->data.ext.len);
+			if (!entry.extData) return false;
+			memcpy(entry.extData, evt->data.ext.ptr, evt->data.ext.len);
+			entry.evt.data.ext.ptr = entry.extData;
+		}
+		mWritePos.store(writePos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// called by the delivery thread only
+	snd_seq_event_t* Front()
+	{
+		uint32_t readPos = mReadPos.load(std::memory_order_relaxed);
+		if (readPos == mWritePos.load(std::memory_order_acquire)) return 0;
+		return &mEntries[readPos & (kAlsaInputRingSize-1)].evt;
+	}
+
+	void Pop()
+	{
+		uint32_t readPos = mReadPos.load(std::memory_order_relaxed);
+		Entry& entry = mEntries[readPos & (kAlsaInputRingSize-1)];
+		if (entry.extData) {
+			free(entry.extData);
+			entry.extData = 0;
+		}
+		mReadPos.store(readPos + 1, std::memory_order_release);
+	}
+};
+
 // MIDI client state
 struct SC_AlsaMidiClient
 {
@@ -108,12 +177,20 @@ struct SC_AlsaMidiClient
 	snd_midi_event_t*	mEventToMidi;
 	snd_midi_event_t*	mMidiToEvent;
 	std::thread			mInputThread;
+	std::thread			mDeliveryThread;
 	std::atomic_bool	mShouldBeRunning { false };
+	SC_AlsaInputRing	mInputRing;
+	std::mutex				mDeliveryMutex;		// guards the wakeup only, never the ring
+	std::condition_variable	mDeliveryCond;
 
 	int startInputThread()
 	{
 		mShouldBeRunning = true;
 		try {
+			std::thread deliveryThread ( [this] {
+				deliveryThreadFunc();
+			});
+			mDeliveryThread = std::move( deliveryThread );
 			std::thread inputThread ( [this] {
 				inputThreadFunc();
 			});
@@ -121,6 +198,7 @@ struct SC_AlsaMidiClient
 			return errNone;
 		} catch (...) {
 			post("MIDI (ALSA): could not start input thread\n");
+			joinInputThread();
 			return errFailed;
 		}
 	}
@@ -128,12 +206,16 @@ struct SC_AlsaMidiClient
 	void joinInputThread()
 	{
 		mShouldBeRunning = false;
+		mDeliveryCond.notify_one();
 		if( mInputThread.joinable() )
 			mInputThread.join();
+		if( mDeliveryThread.joinable() )
+			mDeliveryThread.join();
 	}
 
 	void inputThreadFunc();
-	void processEvent(snd_seq_event_t* evt);
+	void deliveryThreadFunc();
+	void deliverEvent(snd_seq_event_t* evt);
 
 	int connectInput(int inputIndex, int uid, int (*action)(snd_seq_t*, snd_seq_port_subscribe_t*), const char* actionName);
 	int connectOutput(int outputIndex, int uid, int (*action)(snd_seq_t*, snd_seq_port_subscribe_t*), const char* actionName);
@@ -171,17 +253,10 @@ static inline void SC_AlsaParseUID(int uid, int& clientID, int& portID)
 	portID = uid & 0xFFFF;
 }
 
-void SC_AlsaMidiClient::processEvent(snd_seq_event_t* evt)
+// runs on the delivery thread with the language lock already held
+void SC_AlsaMidiClient::deliverEvent(snd_seq_event_t* evt)
 {
-	int status = lockLanguageOrQuit(mShouldBeRunning);
-	if (status == EINTR)
-		return;
-	if (status) {
-		postfl("error when locking language (%d)\n", status);
-		return;
-	}
-
-	if (compiledOK) {
+	{
 		VMGlobals* g = gMainVMGlobals;
 		PyrInt8Array* sysexArray;
 
@@ -335,7 +410,38 @@ void SC_AlsaMidiClient::processEvent(snd_seq_event_t* evt)
 		}
 		g->canCallOS = false;
 	}
-	gLangMutex.unlock();
+}
+
+void SC_AlsaMidiClient::deliveryThreadFunc()
+{
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mDeliveryMutex);
+			mDeliveryCond.wait(lock, [this] {
+				return mInputRing.HasData()
+					|| !mShouldBeRunning.load(std::memory_order_relaxed);
+			});
+		}
+		if (!mShouldBeRunning.load(std::memory_order_relaxed)) break;
+
+		// one language lock acquisition per burst, not per event
+		int status = lockLanguageOrQuit(mShouldBeRunning);
+		if (status == EINTR)
+			break;
+		if (status) {
+			postfl("error when locking language (%d)\n", status);
+			continue;
+		}
+		while (snd_seq_event_t* evt = mInputRing.Front()) {
+			if (compiledOK) deliverEvent(evt);
+			mInputRing.Pop();
+		}
+		gLangMutex.unlock();
+	}
+
+	// release any payloads still queued
+	while (mInputRing.Front())
+		mInputRing.Pop();
 }
 
 void SC_AlsaMidiClient::inputThreadFunc()
@@ -349,15 +455,20 @@ void SC_AlsaMidiClient::inputThreadFunc()
 		if (poll(pfd, npfd, 2000) > 0) { // 2s timeout
 			for (int i=0; i < npfd; i++) {
 				if (pfd[i].revents > 0) {
+					int dropped = 0;
 					do {
 						snd_seq_event_t* evt = nullptr;
 						int status = snd_seq_event_input(mHandle, &evt);
 						if( status > 0 ) {
 							assert( evt );
-							processEvent(evt);
+							if (!mInputRing.Write(evt))
+								dropped++;
 							snd_seq_free_event(evt);
 						}
 					} while (snd_seq_event_input_pending(mHandle, 0) > 0);
+					if (dropped)
+						post("MIDI (ALSA): input ring full, dropped %d events\n", dropped);
+					mDeliveryCond.notify_one();
 				}
 			}
 		}
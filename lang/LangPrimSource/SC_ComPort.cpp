@@ -21,7 +21,10 @@
 #include "SC_BoundsMacros.h"
 #include "SC_ComPort.h"
 #include "SC_Endian.h"
+#include <chrono>
 #include <ctype.h>
+#include <future>
+#include <memory>
 #include <stdexcept>
 #include <stdarg.h>
 #include "SCBase.h"
@@ -41,6 +44,55 @@
 #undef scprintf
 
 void ProcessOSCPacket(OSC_Packet *inPacket, int inPortNum, double time);
+void ProcessOSCPacketLocked(OSC_Packet *inPacket, int inPortNum, double time);
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Pool of fixed-size datagram packets shared by all UDP ports. Each slot is
+// one allocation holding the OSC_Packet envelope and a kTextBufSize payload,
+// so receiving a datagram costs neither a malloc pair nor a copy: the socket
+// reads into the slot and the same slot is handed to the language. Installs
+// with dozens of ports recycle a handful of slots instead of hammering the
+// allocator once per datagram.
+
+const int kDatagramPoolMaxFree = 16;
+
+static SC_Lock gDatagramPoolLock;
+static OSC_Packet *gDatagramPoolFreeList = 0; // linked through the payload
+static int gDatagramPoolNumFree = 0;
+
+OSC_Packet* AllocDatagramPacket()
+{
+	OSC_Packet *packet;
+	{
+		lock_guard<SC_Lock> lock(gDatagramPoolLock);
+		packet = gDatagramPoolFreeList;
+		if (packet) {
+			gDatagramPoolFreeList = *(OSC_Packet**)(packet + 1);
+			--gDatagramPoolNumFree;
+		}
+	}
+	if (!packet)
+		packet = (OSC_Packet*)malloc(sizeof(OSC_Packet) + kTextBufSize);
+	packet->mData = (char*)(packet + 1);
+	return packet;
+}
+
+bool FreeDatagramPacket(OSC_Packet *inPacket)
+{
+	if (inPacket->mData != (char*)(inPacket + 1))
+		return false;
+
+	lock_guard<SC_Lock> lock(gDatagramPoolLock);
+	if (gDatagramPoolNumFree >= kDatagramPoolMaxFree) {
+		free(inPacket);
+		return true;
+	}
+	*(OSC_Packet**)(inPacket + 1) = gDatagramPoolFreeList;
+	gDatagramPoolFreeList = inPacket;
+	++gDatagramPoolNumFree;
+	return true;
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -69,7 +121,7 @@ void stopAsioThread()
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 SC_UdpInPort::SC_UdpInPort(int inPortNum, int portsToCheck):
-	mPortNum(inPortNum), udpSocket(ioService)
+	mPortNum(inPortNum), mInPacket(0), udpSocket(ioService)
 {
 	using namespace boost::asio;
 
@@ -95,13 +147,18 @@ SC_UdpInPort::SC_UdpInPort(int inPortNum, int portsToCheck):
 }
 
 SC_UdpInPort::~SC_UdpInPort()
-{}
+{
+	if (mInPacket)
+		FreeDatagramPacket(mInPacket);
+}
 
 
 void SC_UdpInPort::startReceiveUDP()
 {
 	using namespace boost;
-	udpSocket.async_receive_from(asio::buffer(recvBuffer), remoteEndpoint,
+	if (!mInPacket)
+		mInPacket = AllocDatagramPacket();
+	udpSocket.async_receive_from(asio::buffer(mInPacket->mData, kTextBufSize), remoteEndpoint,
 								 boost::bind(&SC_UdpInPort::handleReceivedUDP, this,
 											 asio::placeholders::error, asio::placeholders::bytes_transferred));
 }
@@ -125,19 +182,39 @@ void SC_UdpInPort::handleReceivedUDP(const boost::system::error_code& error,
 		return;
 	}
 
-	OSC_Packet * packet = (OSC_Packet*)malloc(sizeof(OSC_Packet));
+	OSC_Packet * packet = mInPacket;
+	mInPacket = 0;
 
 	packet->mReplyAddr.mProtocol  = kUDP;
 	packet->mReplyAddr.mAddress   = remoteEndpoint.address();
 	packet->mReplyAddr.mPort      = remoteEndpoint.port();
 	packet->mReplyAddr.mSocket    = udpSocket.native_handle();
-
-	char *data = (char*)malloc(bytesTransferred);
 	packet->mSize = bytesTransferred;
-	packet->mData = data;
-	memcpy(data, recvBuffer.data(), bytesTransferred);
 
-	ProcessOSCPacket(packet, mPortNum, timeReceived);
+	gLangMutex.lock();
+	ProcessOSCPacketLocked(packet, mPortNum, timeReceived);
+
+	// drain datagrams that piled up on this socket while the language was
+	// busy, so a burst costs one wakeup and one lock round trip instead of
+	// one of each per datagram.
+	boost::system::error_code ec;
+	while (udpSocket.available(ec) > 0 && !ec) {
+		packet = AllocDatagramPacket();
+		size_t bytes = udpSocket.receive_from(boost::asio::buffer(packet->mData, kTextBufSize),
+											  remoteEndpoint, 0, ec);
+		if (ec || bytes == 0) {
+			FreeDatagramPacket(packet);
+			break;
+		}
+		packet->mReplyAddr.mProtocol  = kUDP;
+		packet->mReplyAddr.mAddress   = remoteEndpoint.address();
+		packet->mReplyAddr.mPort      = remoteEndpoint.port();
+		packet->mReplyAddr.mSocket    = udpSocket.native_handle();
+		packet->mSize = bytes;
+		ProcessOSCPacketLocked(packet, mPortNum, elapsedTime());
+	}
+	gLangMutex.unlock();
+
 	startReceiveUDP();
 }
 
@@ -228,23 +305,75 @@ void SC_TcpConnection::handleMsgReceived(const boost::system::error_code &error,
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-SC_TcpClientPort::SC_TcpClientPort(unsigned long inAddress, int inPort, ClientNotifyFunc notifyFunc, void *clientData):
+SC_TcpClientPort::SC_TcpClientPort(unsigned long inAddress, int inPort, ClientNotifyFunc notifyFunc, void *clientData,
+	double connectTimeout):
 	socket(ioService),
 	endpoint(boost::asio::ip::address_v4(inAddress), inPort),
-	mClientNotifyFunc(notifyFunc),
-	mClientData(clientData)
+	mConnectionLost(false)
 {
 	using namespace boost::asio;
 
+	if (notifyFunc)
+		mClients.push_back(std::make_pair(notifyFunc, clientData));
+
+	if (connectTimeout > 0.) {
+		// bounded connect: run the connect asynchronously on the io thread
+		// and give up after the timeout instead of waiting out the OS's
+		// (potentially minutes-long) default
+		auto connectResult = std::make_shared<std::promise<boost::system::error_code>>();
+		std::future<boost::system::error_code> connected = connectResult->get_future();
+		socket.async_connect(endpoint, [connectResult](const boost::system::error_code & ec) {
+			connectResult->set_value(ec);
+		});
+
+		std::chrono::microseconds timeout((long long)(connectTimeout * 1e6));
+		if (connected.wait_for(timeout) != std::future_status::ready) {
+			boost::system::error_code ignored;
+			socket.close(ignored); // cancels the pending connect
+			connected.wait(); // the aborted handler must finish before the socket goes away
+			throw std::runtime_error("connection attempt timed out");
+		}
+
+		boost::system::error_code ec = connected.get();
+		if (ec)
+			throw boost::system::system_error(ec);
+	} else
+		socket.connect(endpoint);
+
+	// the socket only exists after connect, so the option has to be set here:
+	// setting it on the unopened socket is silently discarded
 	boost::system::error_code error;
 	ip::tcp::no_delay noDelayOption(true);
 	socket.set_option(noDelayOption, error);
 
-	socket.connect(endpoint);
-
 	startReceive();
 }
 
+void SC_TcpClientPort::AddClient(ClientNotifyFunc notifyFunc, void *clientData)
+{
+	lock_guard<SC_Lock> lock(mClientsMutex);
+	mClients.push_back(std::make_pair(notifyFunc, clientData));
+}
+
+bool SC_TcpClientPort::RemoveClient(void *clientData)
+{
+	lock_guard<SC_Lock> lock(mClientsMutex);
+	for (size_t i = 0; i != mClients.size(); ++i) {
+		if (mClients[i].second == clientData) {
+			mClients.erase(mClients.begin() + i);
+			break;
+		}
+	}
+	return mClients.empty();
+}
+
+void SC_TcpClientPort::notifyClients()
+{
+	lock_guard<SC_Lock> lock(mClientsMutex);
+	for (size_t i = 0; i != mClients.size(); ++i)
+		(*mClients[i].first)(mClients[i].second);
+}
+
 void SC_TcpClientPort::startReceive()
 {
 	namespace ba = boost::asio;
@@ -257,8 +386,8 @@ void SC_TcpClientPort::startReceive()
 void SC_TcpClientPort::handleLengthReceived(const boost::system::error_code &error, size_t bytes_transferred)
 {
 	if (error == boost::asio::error::connection_aborted) {
-		if (mClientNotifyFunc)
-			(*mClientNotifyFunc)(mClientData);
+		mConnectionLost = true;
+		notifyClients();
 	}
 
 	if (error)
@@ -279,8 +408,8 @@ void SC_TcpClientPort::handleMsgReceived(const boost::system::error_code &error,
 {
 	double timeReceived = elapsedTime(); // get time now to minimize jitter due to lang load
     if (error == boost::asio::error::connection_aborted) {
-		if (mClientNotifyFunc)
-			(*mClientNotifyFunc)(mClientData);
+		mConnectionLost = true;
+		notifyClients();
 	}
 
 	if (error) {
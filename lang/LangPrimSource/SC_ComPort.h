@@ -22,11 +22,15 @@
 #define _SC_ComPort_
 
 #include "SC_Types.h"
+#include "SC_Lock.h"
 
 #include <boost/array.hpp>
 #include <boost/asio.hpp>
 #include <boost/enable_shared_from_this.hpp>
 
+#include <utility>
+#include <vector>
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 const int kTextBufSize = 65536;
@@ -34,7 +38,10 @@ const int kTextBufSize = 65536;
 class SC_UdpInPort
 {
 	int mPortNum;
-	boost::array<char, kTextBufSize> recvBuffer;
+	// in-flight receive slot from the shared datagram pool; the socket
+	// reads straight into its payload, so a datagram reaches the language
+	// without being copied.
+	struct OSC_Packet *mInPacket;
 
 	boost::asio::ip::udp::endpoint remoteEndpoint;
 
@@ -106,17 +113,30 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+// A tcp client port may be shared by several NetAddr instances pointing at the
+// same host:port (see the connection pool in OSCData.cpp). Each instance
+// registers a notify callback; all of them are called when the peer closes
+// the connection.
 class SC_TcpClientPort
 {
 public:
 	typedef void (*ClientNotifyFunc)(void* clientData);
 
 public:
-	SC_TcpClientPort(unsigned long inAddress, int inPort, ClientNotifyFunc notifyFunc=0, void* clientData=0);
+	// connectTimeout > 0 bounds the connect attempt to that many seconds;
+	// 0 keeps the OS default (which can block for minutes on a dead host)
+	SC_TcpClientPort(unsigned long inAddress, int inPort, ClientNotifyFunc notifyFunc=0, void* clientData=0,
+		double connectTimeout=0.);
 	int Close();
 
 	boost::asio::ip::tcp::socket & Socket () { return socket; }
 
+	void AddClient(ClientNotifyFunc notifyFunc, void* clientData);
+	// returns true when the last client has been removed
+	bool RemoveClient(void* clientData);
+
+	bool ConnectionLost() const { return mConnectionLost; }
+
 private:
 	int32 OSCMsgLength;
 	char * data;
@@ -128,11 +148,14 @@ private:
 	void handleMsgReceived(const boost::system::error_code& error,
 						   size_t bytes_transferred);
 
+	void notifyClients();
+
 	boost::asio::ip::tcp::socket socket;
 	boost::asio::ip::tcp::endpoint endpoint;
 
-	ClientNotifyFunc	mClientNotifyFunc;
-	void*				mClientData;
+	SC_Lock mClientsMutex;
+	std::vector< std::pair<ClientNotifyFunc, void*> > mClients;
+	bool mConnectionLost;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -70,6 +70,7 @@ static inline void trace(...)
 #include <hidapi_parser.h>
 
 #include <map>
+#include <vector>
 
 typedef std::map<int, hid_dev_desc* > hid_map_t;
 
@@ -101,6 +102,32 @@ static PyrSymbol* s_hidElementData = nullptr;
 static PyrSymbol* s_hidDeviceData = nullptr;
 static PyrSymbol* s_hidClosed = nullptr;
 
+// Optional rate coalescing: instead of taking the language lock for every
+// element callback, each polling thread can buffer element snapshots and
+// deliver a whole batch under one lock acquisition, at most once per
+// configured interval. The element values (and their mapped ranges) are
+// captured at callback time since the parser reuses its element structs.
+struct SC_HID_ElementSnapshot
+{
+	int joy_idx;
+	int index;
+	int usage_page;
+	int usage;
+	int value;
+	int array_value;
+	float mapped_logical;
+	float mapped_physical;
+};
+
+static const size_t kHIDMaxBatchedElements = 512;
+
+// per polling thread; only ever touched from that thread
+static thread_local std::vector<SC_HID_ElementSnapshot> gElementBatch;
+static thread_local double gLastElementFlush = 0.;
+static thread_local bool gPollingThread = false;
+
+static void hid_flush_element_batch( bool force = false );
+
 
 class SC_HID_API_Threadpool
 {
@@ -117,6 +144,8 @@ public:
 
 		std::thread deviceThread( [=, &shouldBeRunning] {
 			trace("start polling thread for %d\n", desc);
+			gPollingThread = true;
+			gLastElementFlush = elapsedTime();
 
 			while( true ) {
 				unsigned char buf[256];
@@ -124,11 +153,16 @@ public:
 				int res = hid_read_timeout( desc->device, buf, sizeof(buf), 250);
 				if ( res > 0 ) {
 					hid_parse_input_report( buf, res, desc );
+					hid_flush_element_batch();
 				} else if (res == -1) {
 					trace("device thread interrupted \n");
+					hid_flush_element_batch( true );
 					hid_throw_readerror( desc );
 					trace("device thread closed device \n");
 					return;
+				} else {
+					// read timed out; deliver whatever is still pending
+					hid_flush_element_batch( true );
 				}
 			}
 			std::lock_guard<std::mutex> lock_(guard);
@@ -193,12 +227,16 @@ public:
 	void deviceData( int, struct hid_dev_desc * );
 	void deviceRepetitiveReadError( int, struct hid_dev_desc * );
 
+	void setCoalesce( double interval, bool latestOnly );
+	void flushElements( bool force ); // called from the polling threads
+
 	struct hid_device_info *devinfos;
 
 protected:
 	void handleDevice( int, struct hid_dev_desc *, std::atomic<bool> const & shouldBeRunning);
 	void handleElement( int, struct hid_device_element *, std::atomic<bool> const & shouldBeRunning);
 	void deviceClosed( int, struct hid_dev_desc *, std::atomic<bool> const & shouldBeRunning);
+	void queueElement( int, struct hid_device_element * );
 
 private:
 	hid_map_t hiddevices;    // declares a vector of hiddevices
@@ -209,6 +247,8 @@ private:
 
 	std::atomic<bool>	m_running;
 	std::atomic<bool>	mShouldBeRunning;
+	std::atomic<double>	mCoalesceInterval;
+	std::atomic<bool>	mCoalesceLatest;
 	SC_HID_API_Threadpool mThreads;
 };
 
@@ -235,9 +275,85 @@ void SC_HID_APIManager::deviceData( int id, struct hid_dev_desc * dd ){
 
 void SC_HID_APIManager::elementData( int id, struct hid_device_element * ele )
 {
+	if ( gPollingThread && mCoalesceInterval.load(std::memory_order_relaxed) > 0. ) {
+		queueElement( id, ele );
+		return;
+	}
 	handleElement( id, ele, mShouldBeRunning );
 }
 
+void SC_HID_APIManager::setCoalesce( double interval, bool latestOnly )
+{
+	mCoalesceLatest.store(latestOnly, std::memory_order_relaxed);
+	mCoalesceInterval.store(interval, std::memory_order_relaxed);
+}
+
+void SC_HID_APIManager::queueElement( int joy_idx, struct hid_device_element * ele )
+{
+	if ( mCoalesceLatest.load(std::memory_order_relaxed) ) {
+		// keep only the newest value per element
+		for ( SC_HID_ElementSnapshot & e : gElementBatch ) {
+			if ( e.joy_idx == joy_idx && e.index == ele->index ) {
+				e.value = ele->value;
+				e.array_value = ele->array_value;
+				e.mapped_logical = hid_element_map_logical( ele );
+				e.mapped_physical = hid_element_map_physical( ele );
+				return;
+			}
+		}
+	}
+	SC_HID_ElementSnapshot e = { joy_idx, ele->index, ele->usage_page, ele->usage,
+		ele->value, ele->array_value,
+		hid_element_map_logical( ele ), hid_element_map_physical( ele ) };
+	gElementBatch.push_back( e );
+}
+
+void SC_HID_APIManager::flushElements( bool force )
+{
+	if ( gElementBatch.empty() )
+		return;
+
+	double interval = mCoalesceInterval.load(std::memory_order_relaxed);
+	if ( !force && interval > 0.
+			&& (elapsedTime() - gLastElementFlush) < interval
+			&& gElementBatch.size() < kHIDMaxBatchedElements )
+		return;
+	gLastElementFlush = elapsedTime();
+
+	int status = lockLanguageOrQuit(mShouldBeRunning);
+	if (status == EINTR)
+		return;
+	if (status) {
+		postfl("error when locking language (%d)\n", status);
+		return;
+	}
+
+	if (compiledOK) {
+		VMGlobals* g = gMainVMGlobals;
+		g->canCallOS = false;
+		for ( SC_HID_ElementSnapshot const & e : gElementBatch ) {
+			++g->sp; SetObject(g->sp, s_hidapi->u.classobj ); // set the class HID_API
+			++g->sp; SetInt(g->sp, e.joy_idx );
+			++g->sp; SetInt(g->sp, e.index );
+			++g->sp; SetInt(g->sp, e.usage_page );
+			++g->sp; SetInt(g->sp, e.usage );
+			++g->sp; SetInt(g->sp, e.value );
+			++g->sp; SetFloat(g->sp, e.mapped_logical );
+			++g->sp; SetFloat(g->sp, e.mapped_physical );
+			++g->sp; SetInt(g->sp, e.array_value );
+			runInterpreter(g, s_hidElementData, 9 );
+		}
+		g->canCallOS = false;
+	}
+	gLangMutex.unlock();
+	gElementBatch.clear();
+}
+
+static void hid_flush_element_batch( bool force )
+{
+	SC_HID_APIManager::instance().flushElements( force );
+}
+
 void SC_HID_APIManager::deviceRepetitiveReadError( int id, struct hid_dev_desc * dd ){
 	deviceClosed( id, dd, mShouldBeRunning );
 // 	hiddevices.erase( id );
@@ -336,7 +452,7 @@ SC_HID_APIManager& SC_HID_APIManager::instance()
 }
 
 SC_HID_APIManager::SC_HID_APIManager()
-	: m_running(false)
+	: m_running(false), mCoalesceInterval(0.), mCoalesceLatest(true)
 {
 	number_of_hids = 0;
 }
@@ -959,6 +1075,23 @@ int prHID_API_SetElementRepeat( VMGlobals* g, int numArgsPushed ){
 	return errNone;
 }
 
+int prHID_API_SetCoalesce( VMGlobals* g, int numArgsPushed ){
+	PyrSlot *args = g->sp - numArgsPushed + 1;
+	PyrSlot* arg1  = args + 1;
+	PyrSlot* arg2  = args + 2;
+
+	int err;
+	double interval;
+
+	err = slotDoubleVal( arg1, &interval );
+	if ( err != errNone ) return err;
+
+	bool latestOnly = IsTrue( arg2 );
+
+	SC_HID_APIManager::instance().setCoalesce( interval, latestOnly );
+	return errNone;
+}
+
 void close_HID_API_Devices(){
 	SC_HID_APIManager::instance().closeAll();
 }
@@ -991,6 +1124,8 @@ void initHIDAPIPrimitives()
 	definePrimitive(base, index++, "_HID_API_SetElementOutput", prHID_API_SetElementOutput, 3, 0); // sets the output value of a specific device element, and sends the report
 	definePrimitive(base, index++, "_HID_API_SetElementRepeat", prHID_API_SetElementRepeat, 3, 0); // sets the repeat property of a specific device element
 
+	definePrimitive(base, index++, "_HID_API_SetCoalesce", prHID_API_SetCoalesce, 3, 0); // batches element callbacks on the polling threads
+
 	s_hidElementData = getsym("prHIDElementData"); // send back element data
 	s_hidDeviceData = getsym("prHIDDeviceData"); // send back device data
 	s_hidClosed = getsym("prHIDDeviceClosed"); // send back that device was closed
@@ -27,6 +27,7 @@
 */
 
 #include <atomic>
+#include <vector>
 
 #include "SCBase.h"
 #include "VMGlobals.h"
@@ -94,6 +95,14 @@ struct SC_LID
 	void handleEvent(struct input_event& evt, std::atomic<bool> const & shouldBeRunning);
 	void readError(std::atomic<bool> const & shouldBeRunning);
 
+	// coalesced delivery. all of these run on the event loop thread, so the
+	// pending buffer needs no locking; only the flush takes the language
+	// lock, once per batch instead of once per event.
+	void setCoalesce(double interval, bool latestOnly, std::atomic<bool> const & shouldBeRunning);
+	void queueEvent(struct input_event& evt, std::atomic<bool> const & shouldBeRunning);
+	double flushDeadline() const;
+	void flushPending(std::atomic<bool> const & shouldBeRunning);
+
 	static PyrObject* getObject(PyrSlot* slot)
 	{
 		return isKindOfSlot(slot, s_inputDeviceClass->u.classobj) ? slotRawObject(slot) : 0;
@@ -111,8 +120,18 @@ struct SC_LID
 	unsigned long		m_eventTypeCaps[NBITS(EV_MAX)];
 	unsigned long		m_eventCodeCaps[NBITS(KEY_MAX)];
 	unsigned long		m_keyState[NBITS(KEY_MAX)];
+
+	bool			m_coalesce;
+	bool			m_coalesceLatest;
+	double			m_coalesceInterval;
+	double			m_lastFlushTime;
+	std::vector<struct input_event> m_pending;
 };
 
+// pending events are force-flushed beyond this count, so a stalled language
+// thread cannot make the buffer grow without bound
+static const size_t kLIDMaxPendingEvents = 512;
+
 // =====================================================================
 // SC_LIDManager
 
@@ -126,6 +145,7 @@ public:
 
 	int add(SC_LID *dev);
 	int remove(SC_LID *dev);
+	int setCoalesce(SC_LID *dev, double interval, bool latestOnly);
 
 private:
 	SC_LIDManager();
@@ -135,7 +155,8 @@ private:
 	{
 		kStop,
 		kAdd,
-		kRemove
+		kRemove,
+		kSetCoalesce
 	};
 
 	struct Command
@@ -144,6 +165,12 @@ private:
 		union
 		{
 			SC_LID*	dev;
+			struct
+			{
+				SC_LID*	dev;
+				double	interval;
+				int	latestOnly;
+			}	coalesce;
 		}	arg;
 	};
 
@@ -151,6 +178,8 @@ private:
 	void devicesChanged();
 	bool asyncAddDevice(SC_LID *dev);
 	bool asyncRemoveDevice(SC_LID *dev);
+	bool isDevice(SC_LID *dev);
+	struct timeval* flushDueDevices(struct timeval& tv);
 	void loop();
 
 	static void* threadFunc(void*);
@@ -172,7 +201,11 @@ SC_LID::SC_LID(PyrObject* obj)
 	: m_next(0),
 	  m_obj(obj),
 	  m_fd(-1),
-	  m_lastEventType(-1)
+	  m_lastEventType(-1),
+	  m_coalesce(false),
+	  m_coalesceLatest(true),
+	  m_coalesceInterval(0.),
+	  m_lastFlushTime(0.)
 {
 	SetPtr(obj->slots+0, this);
 }
@@ -299,8 +332,73 @@ int SC_LID::grab(int flag)
 	return errNone;
 }
 
+void SC_LID::setCoalesce(double interval, bool latestOnly, std::atomic<bool> const & shouldBeRunning)
+{
+	if (!m_pending.empty())
+		flushPending(shouldBeRunning);
+	m_coalesce = interval > 0.;
+	m_coalesceLatest = latestOnly;
+	m_coalesceInterval = interval;
+	m_lastFlushTime = elapsedTime();
+}
+
+void SC_LID::queueEvent(struct input_event& evt, std::atomic<bool> const & shouldBeRunning)
+{
+	if (m_coalesceLatest) {
+		// latest-value snapshot: one pending entry per (type, code)
+		for (size_t i = 0; i < m_pending.size(); ++i) {
+			if (m_pending[i].type == evt.type && m_pending[i].code == evt.code) {
+				m_pending[i].value = evt.value;
+				return;
+			}
+		}
+	}
+	m_pending.push_back(evt);
+	if (m_pending.size() >= kLIDMaxPendingEvents)
+		flushPending(shouldBeRunning);
+}
+
+double SC_LID::flushDeadline() const
+{
+	return m_lastFlushTime + m_coalesceInterval;
+}
+
+void SC_LID::flushPending(std::atomic<bool> const & shouldBeRunning)
+{
+	m_lastFlushTime = elapsedTime();
+	if (m_pending.empty())
+		return;
+
+	int status = lockLanguageOrQuit(shouldBeRunning);
+	if (status == EINTR)
+		return;
+	if (status) {
+		postfl("error when locking language (%d)\n", status);
+		return;
+	}
+
+	if (compiledOK) {
+		VMGlobals* g = gMainVMGlobals;
+		for (size_t i = 0; i < m_pending.size(); ++i) {
+			g->canCallOS = false;
+			++g->sp; SetObject(g->sp, m_obj);
+			++g->sp; SetInt(g->sp, m_pending[i].type);
+			++g->sp; SetInt(g->sp, m_pending[i].code);
+			++g->sp; SetInt(g->sp, m_pending[i].value);
+			runInterpreter(g, s_handleEvent, 4);
+			g->canCallOS = false;
+		}
+	}
+	gLangMutex.unlock();
+	m_pending.clear();
+}
+
 void SC_LID::handleEvent(struct input_event& evt, std::atomic<bool> const & shouldBeRunning)
 {
+	if (evt.type != EV_SYN && m_coalesce) {
+		queueEvent(evt, shouldBeRunning);
+		return;
+	}
 	if (evt.type != EV_SYN) {
 		int status = lockLanguageOrQuit(shouldBeRunning);
 		if (status == EINTR)
@@ -411,6 +509,16 @@ int SC_LIDManager::remove(SC_LID* dev)
 	return sendCommand(cmd);
 }
 
+int SC_LIDManager::setCoalesce(SC_LID* dev, double interval, bool latestOnly)
+{
+	Command cmd;
+	cmd.id = kSetCoalesce;
+	cmd.arg.coalesce.dev = dev;
+	cmd.arg.coalesce.interval = interval;
+	cmd.arg.coalesce.latestOnly = latestOnly;
+	return sendCommand(cmd);
+}
+
 int SC_LIDManager::sendCommand(const Command& cmd)
 {
 	return write(m_cmdFifo[1], &cmd, sizeof(cmd)) == sizeof(cmd) ? errNone : errFailed;
@@ -465,6 +573,40 @@ bool SC_LIDManager::asyncRemoveDevice(SC_LID* dev)
 	return false;
 }
 
+bool SC_LIDManager::isDevice(SC_LID* dev)
+{
+	for (SC_LID *cur = m_devices; cur; cur = cur->m_next)
+		if (cur == dev) return true;
+	return false;
+}
+
+// flush devices whose coalescing interval has elapsed and compute how long
+// select() may sleep before the next pending flush is due. returns NULL
+// (sleep indefinitely) when nothing is buffered.
+struct timeval* SC_LIDManager::flushDueDevices(struct timeval& tv)
+{
+	double wait = -1.;
+	double now = elapsedTime();
+
+	for (SC_LID *dev = m_devices; dev; dev = dev->m_next) {
+		if (dev->m_pending.empty())
+			continue;
+		double due = dev->flushDeadline() - now;
+		if (due <= 0.) {
+			dev->flushPending(mShouldBeRunning);
+			continue;
+		}
+		if (wait < 0. || due < wait)
+			wait = due;
+	}
+
+	if (wait < 0.)
+		return 0;
+	tv.tv_sec = (time_t)wait;
+	tv.tv_usec = (suseconds_t)((wait - (double)tv.tv_sec) * 1e6);
+	return &tv;
+}
+
 void* SC_LIDManager::threadFunc(void* arg)
 {
 	((SC_LIDManager*)arg)->loop();
@@ -478,8 +620,10 @@ void SC_LIDManager::loop()
 
 	while (true) {
 		fd_set fds;
+		struct timeval tv;
+		struct timeval* timeout = flushDueDevices(tv);
 		memcpy(&fds, &m_fds, sizeof(fd_set));
-		int n = select(m_nfds, &fds, 0, 0, 0);
+		int n = select(m_nfds, &fds, 0, 0, timeout);
 		if (n == -1) {
 			if( errno == EINTR ) continue;
 			post("LID: error in input handler: %s\n", strerror(errno));
@@ -513,6 +657,14 @@ void SC_LIDManager::loop()
 								post("LID: couldn't remove device\n");
 							}
 							break;
+						case kSetCoalesce:
+							if (isDevice(cmd.arg.coalesce.dev)) {
+								cmd.arg.coalesce.dev->setCoalesce(
+									cmd.arg.coalesce.interval,
+									cmd.arg.coalesce.latestOnly != 0,
+									mShouldBeRunning);
+							}
+							break;
 						default:
 							post("LID: unknown command in input handler\n");
 					}
@@ -792,6 +944,26 @@ int prLID_SetMscState(VMGlobals *g, int numArgsPushed)
 	return errNone;
 }
 
+int prLID_SetCoalesce(VMGlobals *g, int numArgsPushed)
+{
+	PyrSlot* args = g->sp - 2;
+	double interval;
+	int err;
+
+	PyrObject* obj = SC_LID::getObject(args+0);
+	if (!obj) return errWrongType;
+
+	err = slotDoubleVal(args+1, &interval);
+	if (err) return err;
+
+	bool latestOnly = IsTrue(args+2);
+
+	SC_LID* dev = SC_LID::getDevice(obj);
+	if (!dev) return errFailed;
+
+	return SC_LIDManager::instance().setCoalesce(dev, interval, latestOnly);
+}
+
 void SC_LIDInit()
 {
 	int base, index;
@@ -817,6 +989,7 @@ void SC_LIDInit()
 	definePrimitive(base, index++, "_LID_Stop", prLID_Stop, 1, 0);
 	definePrimitive(base, index++, "_LID_SetLedState", prLID_SetLedState, 3, 0); // added by Marije Baalman
 	definePrimitive(base, index++, "_LID_SetMscState", prLID_SetMscState, 3, 0);
+	definePrimitive(base, index++, "_LID_SetCoalesce", prLID_SetCoalesce, 3, 0);
 }
 
 #else // !HAVE_LID
@@ -50,4 +50,11 @@ struct OSC_Packet
 
 void FreeOSCPacket(OSC_Packet *inPacket);
 
+// pooled packets for the receive threads (SC_ComPort.cpp): one allocation
+// with the payload inline, recycled across datagrams.
+OSC_Packet* AllocDatagramPacket();
+// returns the packet to the pool; false if it is not a pooled packet
+// (the caller frees it itself).
+bool FreeDatagramPacket(OSC_Packet *inPacket);
+
 #endif
@@ -102,6 +102,35 @@ void AdvancingAllocPool::FreeAll()
 	//assert(SanityCheck());
 }
 
+AdvancingAllocPoolRegion AdvancingAllocPool::BeginRegion()
+{
+	AdvancingAllocPoolRegion region;
+	region.mChunks = mChunks;
+	region.mFatties = mFatties;
+	region.mCurSize = mCurSize;
+	return region;
+}
+
+void AdvancingAllocPool::EndRegion(const AdvancingAllocPoolRegion& inRegion)
+{
+	//assert(SanityCheck());
+	AdvancingAllocPoolChunk *chunk, *next;
+	for (chunk = mChunks; chunk != inRegion.mChunks; chunk = next) {
+		next = chunk->mNext;
+		mAllocPool->Free(chunk);
+	}
+	mChunks = inRegion.mChunks;
+	for (chunk = mFatties; chunk != inRegion.mFatties; chunk = next) {
+		next = chunk->mNext;
+		mAllocPool->Free(chunk);
+	}
+	mFatties = inRegion.mFatties;
+	// chunks are only ever pushed, so after unwinding to the snapshot head
+	// the saved offset is valid again
+	mCurSize = inRegion.mCurSize;
+	//assert(SanityCheck());
+}
+
 bool AdvancingAllocPool::SanityCheck()
 {
 	AdvancingAllocPoolChunk *chunk, *next;
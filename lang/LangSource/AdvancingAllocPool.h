@@ -20,8 +20,8 @@
 /*
 
 AdvancingAllocPool implements a simple advancing pointer allocation scheme.
-There is no Free(). All objects in the pool are freed at once with FreeAll().
-Thus it is very fast.
+There is no Free(). All objects in the pool are freed at once with FreeAll(),
+or in scoped groups with BeginRegion()/EndRegion(). Thus it is very fast.
 
 */
 
@@ -54,6 +54,15 @@ struct AdvancingAllocPoolChunk {
 	char mSpace[16];
 };
 
+/* a snapshot of the pool's position. everything allocated after BeginRegion()
+   is discarded in bulk by EndRegion(). regions must be ended in reverse order
+   of creation and must not straddle a FreeAll(). */
+struct AdvancingAllocPoolRegion {
+	AdvancingAllocPoolChunk *mChunks;
+	AdvancingAllocPoolChunk *mFatties;
+	size_t mCurSize;
+};
+
 class AdvancingAllocPool
 {
 public:
@@ -65,6 +74,9 @@ public:
 	void *Alloc(size_t inBytes);
 	void FreeAll();
 
+	AdvancingAllocPoolRegion BeginRegion();
+	void EndRegion(const AdvancingAllocPoolRegion& inRegion);
+
 	bool SanityCheck();
 
 private:
@@ -28,19 +28,40 @@
 ByteCodes gCompilingByteCodes;
 long totalByteCodes = 0;
 
+// peephole fusion state: offset of a just-emitted one-byte push (temp zero
+// var or constant) in the current array, or -1 when the previous emission
+// cannot be fused. every raw compileByte resets it, so only opcodes emitted
+// back to back through compileOpcode into the same array ever fuse, and jump
+// targets (which always fall on sub-array boundaries) stay valid.
+static long gFusablePushOffset = -1;
+
 void initByteCodes()
 {
 	if (gCompilingByteCodes) {
 		freeByteCodes(gCompilingByteCodes);
 		gCompilingByteCodes = NULL;
 	}
+	gFusablePushOffset = -1;
 }
 
 int compileOpcode(long opcode, long operand1)
 {
 	int retc;
 	if (operand1 <= 15) {
+		if (opcode == opSendSpecialBinaryArithMsg && gFusablePushOffset >= 0) {
+			// rewrite the push and this operator as one superinstruction:
+			// 15, opgFused..., (push index << 4) | operator
+			Byte push = gCompilingByteCodes->bytes[gFusablePushOffset];
+			long fusedOp = (push >> 4) == opPushTempZeroVar ?
+				opgFusedPushTempZeroVarBinaryOp : opgFusedPushConstantBinaryOp;
+			gCompilingByteCodes->bytes[gFusablePushOffset] = opSpecialOpcode;
+			compileByte(fusedOp);
+			compileByte(((push & 15) << 4) | operand1);
+			return 2;
+		}
 		compileByte((opcode<<4) | operand1);
+		if (opcode == opPushTempZeroVar || opcode == opPushLiteral)
+			gFusablePushOffset = (gCompilingByteCodes->ptr - gCompilingByteCodes->bytes) - 1;
 		retc = 1;
 	} else {
 		compileByte(opcode);
@@ -63,6 +84,7 @@ void compileJump(long opcode, long jumplen)
 
 void compileByte(long byte)
 {
+	gFusablePushOffset = -1;
 	if (gCompilingByteCodes == NULL) {
 		gCompilingByteCodes = allocByteCodes();
 	}
@@ -109,6 +131,7 @@ ByteCodes getByteCodes()
 
   curByteCodes = gCompilingByteCodes;
   gCompilingByteCodes = NULL;
+  gFusablePushOffset = -1;
 
   return curByteCodes;
 }
@@ -119,12 +142,14 @@ ByteCodes saveByteCodeArray()
 
 	curByteCodes = gCompilingByteCodes;
 	gCompilingByteCodes = NULL;
+	gFusablePushOffset = -1;
 
 	return curByteCodes;
 }
 
 void restoreByteCodeArray(ByteCodes byteCodes)
 {
+	gFusablePushOffset = -1;
 	gCompilingByteCodes = byteCodes;
 }
 
@@ -24,9 +24,14 @@
 #include "PyrObjectProto.h"
 #include "PyrSymbol.h"
 #include "InitAlloc.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdexcept>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
 #define PAUSETIMES 0
 
 
@@ -257,6 +262,12 @@ PyrGC::PyrGC(VMGlobals *g, AllocPool *inPool, PyrClass *mainProcessClass, long p
 	mNumPartialScans = 0;
 	mSlotsScanned = 0;
 
+	mMajorFlipInterval = kMinMajorFlipInterval;
+	mMinorFlips = kMinMajorFlipInterval - 1; // the first flip is a major flip
+	mScansAtLastFlip = 0;
+	mMinorScanAvg = 0;
+	mFullTracePending = false;
+
 	mGreyColor = 3<<2;
 	mBlackColor = 2<<2;
 	mWhiteColor = 1<<2;
@@ -269,6 +280,14 @@ PyrGC::PyrGC(VMGlobals *g, AllocPool *inPool, PyrClass *mainProcessClass, long p
 	mPartialScanSlot = 0;
 	mUncollectedAllocations = 0;
 
+	mProfileTable = NULL;
+	mProfilePending = NULL;
+	mProfilePendingSizeclass = 0;
+	mProfileInterval = 0;
+	mProfileCountdown = 0;
+	mProfileNumSamples = 0;
+	mProfileNumDropped = 0;
+
 	mGrey.classptr = NULL;
 	mGrey.obj_sizeclass = 0;
 	mGrey.size = 0;
@@ -368,7 +387,13 @@ HOT PyrObject *PyrGC::New(size_t inNumBytes, long inFlags, long inFormat, bool i
 	mAllocTotal += credit;
 	mNumAllocs++;
 
-	mNumToScan += credit;
+	// raw data formats are never scanned (see ScanSize), so a big audio or
+	// analysis array should not buy a megabyte-sized scan burst - it only
+	// needs enough credit to keep sweeping paced.
+	if (inFormat > obj_slot && sizeclass > kMaxPoolSet)
+		mNumToScan += 1L << kMaxPoolSet;
+	else
+		mNumToScan += credit;
 	obj = Allocate(inNumBytes, sizeclass, inRunCollection);
 
 	obj->obj_format = inFormat;
@@ -377,6 +402,9 @@ HOT PyrObject *PyrGC::New(size_t inNumBytes, long inFlags, long inFormat, bool i
 	obj->classptr = class_object;
 	obj->gc_color = mWhiteColor;
 
+	if (mProfileInterval && --mProfileCountdown <= 0)
+		ProfileSample(obj, sizeclass);
+
 #ifdef GC_SANITYCHECK
 	SanityCheck();
 #endif
@@ -481,8 +509,36 @@ PyrObject *PyrGC::NewFinalizer(ObjFuncPtr finalizeFunc, PyrObject *inObject, boo
 }
 
 
+// large-object space. every object of kLargeObjSizeClass and above gets its
+// own mapping, sized from its size class, so the length never needs to be
+// stored: freed blocks go straight back to the system instead of lingering
+// in the pool. the treadmill itself is unchanged - large objects keep their
+// headers on the regular lists and are never moved.
+void* PyrGC::LargeObjAlloc(int32 inSizeclass)
+{
+	size_t allocSize = sizeof(PyrObjectHdr) + (sizeof(PyrSlot) << inSizeclass);
+#ifdef _WIN32
+	return malloc(allocSize);
+#else
+	void* ptr = mmap(0, allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+	return ptr == MAP_FAILED ? 0 : ptr;
+#endif
+}
+
+void PyrGC::LargeObjFree(void* inPtr, int32 inSizeclass)
+{
+#ifdef _WIN32
+	free(inPtr);
+#else
+	size_t allocSize = sizeof(PyrObjectHdr) + (sizeof(PyrSlot) << inSizeclass);
+	munmap(inPtr, allocSize);
+#endif
+}
+
 void PyrGC::SweepBigObjects()
 {
+	if (mProfilePending) ProfileResolvePending();	// before any memory is released
+
 	if (!mCanSweep) return;
 
 	for (int i=kMaxPoolSet+1; i<kNumGCSizeClasses; ++i) {
@@ -497,7 +553,10 @@ void PyrGC::SweepBigObjects()
 			do {
 				PyrObjectHdr *nextobj = obj->next;
 				void* ptr = (void*)obj;
-				mPool->Free(ptr);
+				if (i >= kLargeObjSizeClass)
+					LargeObjFree(ptr, i);
+				else
+					mPool->Free(ptr);
 				obj = nextobj;
 			} while (!IsMarker(obj));
 		}
@@ -625,8 +684,28 @@ void PyrGC::Flip()
 
 	ScanFinalizers();
 
+	// adapt the major flip interval. the cycle that follows a major flip
+	// retraces the entire live set, while a minor cycle only traces objects
+	// allocated, or written to, since the previous flip. when the full
+	// retrace is much more expensive than an average minor cycle the
+	// tenured set dominates, so retrace it less often.
+	int32 cycleScans = mScans - mScansAtLastFlip;
+	if (mFullTracePending) {
+		mFullTracePending = false;
+		if (mMinorScanAvg > 0) {
+			if (cycleScans > (mMinorScanAvg << 3))
+				mMajorFlipInterval = sc_min(mMajorFlipInterval << 1, kMaxMajorFlipInterval);
+			else if (cycleScans < (mMinorScanAvg << 2))
+				mMajorFlipInterval = sc_max(mMajorFlipInterval >> 1, kMinMajorFlipInterval);
+		}
+	} else {
+		// running average of the tracing work of a minor cycle
+		mMinorScanAvg = ((mMinorScanAvg << 1) + mMinorScanAvg + cycleScans) >> 2;
+	}
+	mScansAtLastFlip = mScans;
+
 	GCSet *gcs = mSets;
-	if ((mFlips & 3) == 0) {
+	if (mMinorFlips >= mMajorFlipInterval - 1) {
 		// major flip
 		for (int i=0; i<kNumGCSets; ++i, ++gcs) {
 			gcs->MajorFlip();
@@ -637,11 +716,15 @@ void PyrGC::Flip()
 		mWhiteColor += 4;
 		mGreyColor += 4;
 		mFreeColor += 4;
+
+		mMinorFlips = 0;
+		mFullTracePending = true;
 	} else {
 		// minor flip
 		for (int i=0; i<kNumGCSets; ++i, ++gcs) {
 			gcs->MinorFlip();
 		}
+		mMinorFlips++;
 	}
 	// move root to grey area
 	mNumGrey = 0;
@@ -664,6 +747,7 @@ void PyrGC::Flip()
 
 void PyrGC::FullCollection()
 {
+	mMinorFlips = mMajorFlipInterval - 1;	// force a major flip so tenured garbage is reclaimed
 	Collect(100000000);	// collect space
 	SweepBigObjects();
 }
@@ -676,6 +760,8 @@ void PyrGC::Collect(int32 inNumToScan)
 
 HOT void PyrGC::Collect()
 {
+	if (mProfilePending) ProfileResolvePending();	// before anything may be freed
+
 	BEGINPAUSE
 	bool stackScanned = false;
 	mCollects++;
@@ -1149,7 +1235,8 @@ void PyrGC::DumpInfo()
 	int totblack, totgrey, totwhite, totfree, totref, total, siztotal;
 
 	REPORTPAUSE
-	post("flips %d  collects %d   nalloc %d   alloc %d   grey %d\n", mFlips, mCollects, mNumAllocs, mAllocTotal, mNumGrey);
+	post("flips %d (major every %d)  collects %d   nalloc %d   alloc %d   grey %d\n",
+		mFlips, mMajorFlipInterval, mCollects, mNumAllocs, mAllocTotal, mNumGrey);
 
 	totblack = 0;
 	totgrey = 0;
@@ -1277,3 +1364,91 @@ void PyrGC::throwMemfailed(size_t inNumBytes)
 	post("alloc failed. size = %d\n", inNumBytes);
 	MEMFAILED;
 }
+
+// ---- sampling allocation profiler ----
+
+bool PyrGC::ProfileStart(int32 inInterval)
+{
+	if (inInterval < 1) inInterval = 1;
+	if (!mProfileTable) {
+		mProfileTable = (ProfileEntry*)calloc(kProfileTableSize, sizeof(ProfileEntry));
+		if (!mProfileTable) return false;
+	}
+	mProfileInterval = inInterval;
+	mProfileCountdown = inInterval;
+	return true;
+}
+
+void PyrGC::ProfileStop()
+{
+	if (mProfilePending) ProfileResolvePending();
+	mProfileInterval = 0;
+	// the table is kept so the run can still be reported after stopping
+}
+
+void PyrGC::ProfileClear()
+{
+	mProfilePending = NULL;
+	mProfileNumSamples = 0;
+	mProfileNumDropped = 0;
+	mProfileCountdown = mProfileInterval;
+	if (mProfileTable)
+		memset(mProfileTable, 0, kProfileTableSize * sizeof(ProfileEntry));
+}
+
+void PyrGC::ProfileSample(PyrObject *inObj, int32 inSizeclass)
+{
+	if (mProfilePending) ProfileResolvePending();
+	mProfileCountdown = mProfileInterval;
+	mProfilePending = inObj;
+	mProfilePendingSizeclass = inSizeclass;
+}
+
+/*	Attribute the previously sampled object to its class. New() returns before
+	the allocating primitive has stored the real class pointer, so attribution
+	is deferred: this runs at the next sample, the next collection and the next
+	big-object sweep, all of which happen strictly after the allocation site
+	finished with the object and before its memory can be released. A sample
+	whose object was recycled from the free list in the meantime is attributed
+	to the recycler's class, which at sampling rates is noise. */
+void PyrGC::ProfileResolvePending()
+{
+	PyrObject *obj = mProfilePending;
+	mProfilePending = NULL;
+
+	PyrClass *classobj = obj->classptr;
+	int32 index = (int32)((size_t)classobj >> 4) & (kProfileTableSize - 1);
+	for (int32 probe = 0; probe < kProfileTableSize; ++probe) {
+		ProfileEntry *entry = mProfileTable + index;
+		if (entry->mClass == classobj || entry->mClass == NULL) {
+			entry->mClass = classobj;
+			entry->mNumSamples++;
+			entry->mSampledBytes += sizeof(PyrObjectHdr)
+				+ (sizeof(PyrSlot) << mProfilePendingSizeclass);
+			entry->mSizeClassCounts[mProfilePendingSizeclass]++;
+			mProfileNumSamples++;
+			return;
+		}
+		index = (index + 1) & (kProfileTableSize - 1);
+	}
+	mProfileNumDropped++;	// table full; one counter beats growing in a hot path
+}
+
+void PyrGC::DumpProfile()
+{
+	if (!mProfileTable) {
+		post("allocation profiler has not been started\n");
+		return;
+	}
+	post("allocation profile: 1 in %d sampled, %lld samples, %d dropped\n",
+		mProfileInterval ? mProfileInterval : 0, (long long)mProfileNumSamples,
+		mProfileNumDropped);
+	// collapsed flame-graph format: "name value" per line, value = sampled
+	// bytes, so the output feeds straight into flamegraph.pl
+	for (int32 i = 0; i < kProfileTableSize; ++i) {
+		ProfileEntry *entry = mProfileTable + i;
+		if (!entry->mClass) continue;
+		post("%s %lld\n", slotRawSymbol(&entry->mClass->name)->name,
+			(long long)entry->mSampledBytes);
+	}
+}
@@ -36,10 +36,24 @@ void DumpSimpleBackTrace(VMGlobals *g);
 
 const int kMaxPoolSet = 7;
 const int kNumGCSizeClasses = 28;
+// objects of this size class and above (1 MB of slot space) live in the
+// large-object space: each gets its own page-aligned mapping which is
+// returned to the system when swept, so megabyte-sized audio and analysis
+// arrays neither pass through nor fragment the pools.
+const int kLargeObjSizeClass = 16;
 const int kFinalizerSet = kNumGCSizeClasses;
 const int kNumGCSets = kNumGCSizeClasses + 1;
 const int kScanThreshold =  256;
 
+// bounds on the number of flips between major flips. minor flips leave
+// surviving (black) objects in place, so long-lived data is only retraced
+// during the cycle that follows a major flip. the interval adapts to the
+// cost of that full retrace relative to an average minor cycle, so a large
+// tenured set (e.g. the compiled class library) is rescanned less often.
+// kMinMajorFlipInterval matches the collector's historic fixed period.
+const int kMinMajorFlipInterval = 4;
+const int kMaxMajorFlipInterval = 32;
+
 
 class GCSet
 {
@@ -171,6 +185,29 @@ public:
 	void DumpGrey();
 	void DumpSet(int set);
 
+	// ---- sampling allocation profiler ----
+	// records every mProfileInterval-th New() into a per-class table. the
+	// off state costs one predictable branch per allocation, so the profiler
+	// can be switched on in production when a show stutters. driven by the
+	// _GCProfile* primitives (Object: gcProfileStart etc.).
+	struct ProfileEntry {
+		PyrClass *mClass;
+		int32 mNumSamples;
+		int64 mSampledBytes;	// header + slot space of the sampled allocations
+		int32 mSizeClassCounts[kNumGCSizeClasses];
+	};
+	static const int kProfileTableSize = 256;	// power of two, open addressing
+
+	bool ProfileStart(int32 inInterval);	// false if the table can't be allocated
+	void ProfileStop();
+	void ProfileClear();
+	void DumpProfile();	// posts one collapsed flame-graph line per class
+	bool ProfileRunning() const { return mProfileInterval != 0; }
+	int32 ProfileInterval() const { return mProfileInterval; }
+	int64 ProfileNumSamples() const { return mProfileNumSamples; }
+	int32 ProfileNumDropped() const { return mProfileNumDropped; }
+	const ProfileEntry* ProfileTable() const { return mProfileTable; }
+
 	void BecomePermanent(PyrObject *inObject);
 	void BecomeImmutable(PyrObject *inObject);
 
@@ -181,6 +218,12 @@ private:
 	inline PyrObject * Allocate(size_t inNumBytes, int32 sizeclass, bool inCollect);
 	static void throwMemfailed(size_t inNumBytes);
 
+	static void* LargeObjAlloc(int32 inSizeclass);
+	static void LargeObjFree(void* inPtr, int32 inSizeclass);
+
+	void ProfileSample(PyrObject *inObj, int32 inSizeclass);
+	void ProfileResolvePending();
+
 	void ScanSlots(PyrSlot *inSlots, long inNumToScan);
 	void SweepBigObjects();
 	void DoPartialScan(int32 inObjSize);
@@ -214,6 +257,17 @@ private:
 	int32 mCurSet;
 
 	int32 mFlips, mCollects, mAllocTotal, mScans, mNumAllocs, mStackScans, mNumPartialScans, mSlotsScanned, mUncollectedAllocations;
+	int32 mMajorFlipInterval, mMinorFlips, mScansAtLastFlip, mMinorScanAvg;
+	bool mFullTracePending;
+
+	// profiler state. mProfilePending is the last sampled object, waiting
+	// for its class pointer to be attributed (see ProfileResolvePending).
+	ProfileEntry *mProfileTable;	// calloc'd on first ProfileStart
+	PyrObject *mProfilePending;
+	int32 mProfilePendingSizeclass;
+	int32 mProfileInterval, mProfileCountdown;
+	int64 mProfileNumSamples;
+	int32 mProfileNumDropped;
 
 	unsigned char mBlackColor, mGreyColor, mWhiteColor, mFreeColor;
 	bool mCanSweep;
@@ -306,7 +360,10 @@ inline void PyrGC::ToGrey(PyrObjectHdr* obj)
 	/* set grey list pointer to obj */
 	obj->gc_color = mGreyColor;
 	mNumGrey ++ ;
-	mNumToScan += 1L << obj->obj_sizeclass;
+	int32 scanclass = obj->obj_sizeclass;
+	if (obj->obj_format > obj_slot && scanclass > kMaxPoolSet)
+		scanclass = kMaxPoolSet; // raw data is never scanned
+	mNumToScan += 1L << scanclass;
 }
 
 inline void PyrGC::ToGrey2(PyrObjectHdr* obj)
@@ -342,7 +399,10 @@ inline PyrObject * PyrGC::Allocate(size_t inNumBytes, int32 sizeclass, bool inRu
 		gcs->mFree = obj->next;
 		assert(obj->obj_sizeclass == sizeclass);
 	} else {
-		if (sizeclass > kMaxPoolSet) {
+		if (sizeclass >= kLargeObjSizeClass) {
+			SweepBigObjects();
+			obj = (PyrObject*)LargeObjAlloc(sizeclass);
+		} else if (sizeclass > kMaxPoolSet) {
 			SweepBigObjects();
 			size_t allocSize = sizeof(PyrObjectHdr) + (sizeof(PyrSlot) << sizeclass);
 			obj = (PyrObject*)mPool->Alloc(allocSize);
@@ -347,7 +347,12 @@ enum {
 	//opgAudioClock,
 	//opgLogicalClock,
 
-	opgNumPseudoVars
+	opgNumPseudoVars,
+
+	// fused superinstructions, emitted by the peephole in compileOpcode().
+	// the operand byte packs (push index << 4) | (binary opcode & 15).
+	opgFusedPushTempZeroVarBinaryOp = 16,
+	opgFusedPushConstantBinaryOp
 };
 
 /* selector types */
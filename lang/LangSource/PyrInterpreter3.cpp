@@ -81,7 +81,15 @@ void debugf(char *fmt, ...) ;
 
 #define DEBUGINTERPRETER 0
 #define METHODMETER 0
+// opt-in opcode/send counters for the interpreter benchmark suite
+// (testsuite/sclang/bench): configure with -DSC_VM_COUNTERS=ON to count
+// executed opcodes, opcode pairs and dispatched sends per selector, dumped
+// to a "bcstat" file in the working directory when the process exits.
+#ifdef SC_VM_COUNTERS
+#define BCSTAT 1
+#else
 #define BCSTAT 0
+#endif
 #define CHECK_MAX_STACK_USE 0
 
 
@@ -208,8 +216,8 @@ PyrProcess* newPyrProcess(VMGlobals *g, PyrClass *procclassobj)
 
 	PyrSymbol * contextsym = getsym("functionCompileContext");
 	size_t index = slotRawInt(&class_interpreter->classIndex) + contextsym->u.index;
-	PyrMethod * meth = gRowTable[index];
-	if (!meth || slotRawSymbol(&meth->name) != contextsym) {
+	PyrMethod * meth = gRowTable[index].method;
+	if (!meth || gRowTable[index].selector != contextsym) {
 		error("compile context method 'functionCompileContext' not found.\n");
 		//SetNil(&proc->interpreter);
 	} else {
@@ -244,6 +252,25 @@ int prevop = 0;
 int bcstat[256];
 int bcpair[256][256];
 
+// dispatched sends by selector. symbols are interned and never freed, so
+// an open addressed table keyed on the symbol pointer is enough.
+enum { kSendStatSize = 4096 }; // power of two
+PyrSymbol *sendstatsym[kSendStatSize];
+int sendstat[kSendStatSize];
+
+void countsend(PyrSymbol *selector);
+void countsend(PyrSymbol *selector)
+{
+	int i = (int)(((size_t)selector >> 4) & (kSendStatSize - 1));
+	int probes = kSendStatSize;
+	while (sendstatsym[i] && sendstatsym[i] != selector) {
+		if (--probes == 0) return; // table full; drop the count
+		i = (i + 1) & (kSendStatSize - 1);
+	}
+	sendstatsym[i] = selector;
+	++sendstat[i];
+}
+
 void clearbcstat();
 void clearbcstat()
 {
@@ -287,9 +314,29 @@ void dumpbcstat()
 				}
 			}
 		}
+		fprintf(file, "-----sends-----\n");
+		total = 0;
+		for (i=0; i<kSendStatSize; ++i) total += sendstat[i];
+		// selection sort the table in place; it only runs at exit
+		for (i=0; i<kSendStatSize; ++i) {
+			int best = i;
+			for (j=i+1; j<kSendStatSize; ++j) {
+				if (sendstat[j] > sendstat[best]) best = j;
+			}
+			if (sendstat[best] == 0) break;
+			if (best != i) {
+				int n = sendstat[i]; sendstat[i] = sendstat[best]; sendstat[best] = n;
+				PyrSymbol *sym = sendstatsym[i]; sendstatsym[i] = sendstatsym[best]; sendstatsym[best] = sym;
+			}
+			fprintf(file, "%8d  %s\n", sendstat[i], sendstatsym[i]->name);
+		}
+		fprintf(file, "\ntotal sends %d\n", total);
 	}
 	fclose(file);
 }
+
+// dump the accumulated counts when the process exits
+static struct BCStatDumper { ~BCStatDumper() { dumpbcstat(); } } gBCStatDumper;
 #endif
 
 void initPatterns();
@@ -497,6 +544,55 @@ static inline void handleSendSpecialBinaryArithMsg(VMGlobals* g, PyrSlot *& sp,
 	sp = g->sp; ip = g->ip;
 }
 
+// type-speculated fast path for the comparison opcodes. two numeric
+// operands are by far the common case in loop conditions, and handling
+// them here avoids syncing the interpreter registers and running the
+// full type dispatch in doSpecialBinaryArithMsg. the opcode argument is
+// a literal at every call site, so the switches fold away. returns
+// false when the operands need the generic path.
+static inline bool compareInline(PyrSlot *& sp, int opcode)
+{
+	PyrSlot *a = sp - 1;
+	PyrSlot *b = sp;
+	double fa, fb;
+	if (IsInt(a)) {
+		if (IsInt(b)) {
+			int ia = slotRawInt(a), ib = slotRawInt(b);
+			bool res = false;
+			switch (opcode) {
+				case opEQ : res = ia == ib; break;
+				case opNE : res = ia != ib; break;
+				case opLT : res = ia <  ib; break;
+				case opGT : res = ia >  ib; break;
+				case opLE : res = ia <= ib; break;
+				case opGE : res = ia >= ib; break;
+			}
+			--sp; SetBool(sp, res);
+			return true;
+		}
+		if (!IsFloat(b)) return false;
+		fa = slotRawInt(a); fb = slotRawFloat(b);
+	} else if (IsFloat(a)) {
+		fa = slotRawFloat(a);
+		if (IsFloat(b)) fb = slotRawFloat(b);
+		else if (IsInt(b)) fb = slotRawInt(b);
+		else return false;
+	} else
+		return false;
+
+	bool res = false;
+	switch (opcode) {
+		case opEQ : res = fa == fb; break;
+		case opNE : res = fa != fb; break;
+		case opLT : res = fa <  fb; break;
+		case opGT : res = fa >  fb; break;
+		case opLE : res = fa <= fb; break;
+		case opGE : res = fa >= fb; break;
+	}
+	--sp; SetBool(sp, res);
+	return true;
+}
+
 static inline bool checkStackOverflow(VMGlobals* g, PyrSlot * sp)
 {
 	PyrObject * stack = g->gc->Stack();
@@ -520,12 +616,26 @@ static inline void checkStackDepth(VMGlobals* g, PyrSlot * sp)
 #endif
 
 #ifdef LABELS_AS_VALUES
+#if BCSTAT
+// computed gotos skip the loop head, so the counters live in the dispatch
+// macro itself when counting is on
+#define dispatch_opcode \
+	op1 = ip[1];		\
+	++ip;				\
+	++bcstat[op1];		\
+	++bcpair[prevop][op1]; \
+	prevop = op1;		\
+	checkStackDepth(g, sp); \
+	assert(checkStackOverflow(g, sp)); \
+	goto *opcode_labels[op1]
+#else
 #define dispatch_opcode \
 	op1 = ip[1];		\
 	++ip;				\
 	checkStackDepth(g, sp); \
 	assert(checkStackOverflow(g, sp)); \
 	goto *opcode_labels[op1]
+#endif
 #else
 #define dispatch_opcode break
 #endif
@@ -1105,6 +1215,28 @@ HOT void Interpret(VMGlobals *g)
 					++sp; SetObject(sp, closure);
 					break;
 				}
+				case opgFusedPushTempZeroVarBinaryOp : {
+					int op3 = ip[1]; ++ip; // (temp var index << 4) | binary operator
+					slotCopy(++sp, &g->frame->vars[op3 >> 4]);
+					op1 = (opSendSpecialBinaryArithMsg << 4) | (op3 & 15);
+					switch (op3 & 15) {
+						case opAdd : goto handle_op_224;
+						case opSub : goto handle_op_225;
+						case opMul : goto handle_op_226;
+						default : goto handle_op_227;
+					}
+				}
+				case opgFusedPushConstantBinaryOp : {
+					int op3 = ip[1]; ++ip; // (constant index << 4) | binary operator
+					slotCopy(++sp, &slotRawObject(&g->block->constants)->slots[op3 >> 4]);
+					op1 = (opSendSpecialBinaryArithMsg << 4) | (op3 & 15);
+					switch (op3 & 15) {
+						case opAdd : goto handle_op_224;
+						case opSub : goto handle_op_225;
+						case opMul : goto handle_op_226;
+						default : goto handle_op_227;
+					}
+				}
 				default :
 					slotCopy(++sp, &gSpecialValues[svNil]); break;
 			}
@@ -2249,6 +2381,12 @@ HOT void Interpret(VMGlobals *g)
 					--sp; SetRaw(sp, slotRawInt(sp) + slotRawInt(sp + 1));
 #if TAILCALLOPTIMIZE
 					g->tailCall = 0;
+#endif
+				} else if (IsFloat(sp)) {
+					double res = slotRawInt(sp - 1) + slotRawFloat(sp);
+					--sp; SetFloat(sp, res);
+#if TAILCALLOPTIMIZE
+					g->tailCall = 0;
 #endif
 				} else {
 					g->sp = sp; g->ip = ip;
@@ -2256,6 +2394,24 @@ HOT void Interpret(VMGlobals *g)
 					prAddInt(g, -1);
 					sp = g->sp; ip = g->ip;
 				}
+			} else if (IsFloat(sp - 1)) {
+				if (IsFloat(sp)) {
+					--sp; SetRaw(sp, slotRawFloat(sp) + slotRawFloat(sp + 1));
+#if TAILCALLOPTIMIZE
+					g->tailCall = 0;
+#endif
+				} else if (IsInt(sp)) {
+					double res = slotRawFloat(sp - 1) + slotRawInt(sp);
+					--sp; SetRaw(sp, res);
+#if TAILCALLOPTIMIZE
+					g->tailCall = 0;
+#endif
+				} else {
+					g->sp = sp; g->ip = ip;
+					g->primitiveIndex = opAdd;
+					prAddFloat(g, -1);
+					sp = g->sp; ip = g->ip;
+				}
 			} else {
 				g->sp = sp; g->ip = ip;
 				g->primitiveIndex = opAdd;
@@ -2270,6 +2426,12 @@ HOT void Interpret(VMGlobals *g)
 					--sp; SetRaw(sp, slotRawInt(sp) - slotRawInt(sp + 1));
 #if TAILCALLOPTIMIZE
 					g->tailCall = 0;
+#endif
+				} else if (IsFloat(sp)) {
+					double res = slotRawInt(sp - 1) - slotRawFloat(sp);
+					--sp; SetFloat(sp, res);
+#if TAILCALLOPTIMIZE
+					g->tailCall = 0;
 #endif
 				} else {
 					g->sp = sp; g->ip = ip;
@@ -2277,6 +2439,24 @@ HOT void Interpret(VMGlobals *g)
 					prSubInt(g, -1);
 					sp = g->sp; ip = g->ip;
 				}
+			} else if (IsFloat(sp - 1)) {
+				if (IsFloat(sp)) {
+					--sp; SetRaw(sp, slotRawFloat(sp) - slotRawFloat(sp + 1));
+#if TAILCALLOPTIMIZE
+					g->tailCall = 0;
+#endif
+				} else if (IsInt(sp)) {
+					double res = slotRawFloat(sp - 1) - slotRawInt(sp);
+					--sp; SetRaw(sp, res);
+#if TAILCALLOPTIMIZE
+					g->tailCall = 0;
+#endif
+				} else {
+					g->sp = sp; g->ip = ip;
+					g->primitiveIndex = opSub;
+					prSubFloat(g, -1);
+					sp = g->sp; ip = g->ip;
+				}
 			} else {
 				g->sp = sp; g->ip = ip;
 				g->primitiveIndex = opSub;
@@ -2291,6 +2471,12 @@ HOT void Interpret(VMGlobals *g)
 					--sp; SetRaw(sp, slotRawInt(sp) * slotRawInt(sp + 1));
 #if TAILCALLOPTIMIZE
 					g->tailCall = 0;
+#endif
+				} else if (IsFloat(sp)) {
+					double res = slotRawInt(sp - 1) * slotRawFloat(sp);
+					--sp; SetFloat(sp, res);
+#if TAILCALLOPTIMIZE
+					g->tailCall = 0;
 #endif
 				} else {
 					g->sp = sp; g->ip = ip;
@@ -2298,6 +2484,24 @@ HOT void Interpret(VMGlobals *g)
 					prMulInt(g, -1);
 					sp = g->sp; ip = g->ip;
 				}
+			} else if (IsFloat(sp - 1)) {
+				if (IsFloat(sp)) {
+					--sp; SetRaw(sp, slotRawFloat(sp) * slotRawFloat(sp + 1));
+#if TAILCALLOPTIMIZE
+					g->tailCall = 0;
+#endif
+				} else if (IsInt(sp)) {
+					double res = slotRawFloat(sp - 1) * slotRawInt(sp);
+					--sp; SetRaw(sp, res);
+#if TAILCALLOPTIMIZE
+					g->tailCall = 0;
+#endif
+				} else {
+					g->sp = sp; g->ip = ip;
+					g->primitiveIndex = opMul;
+					prMulFloat(g, -1);
+					sp = g->sp; ip = g->ip;
+				}
 			} else {
 				g->sp = sp; g->ip = ip;
 				g->primitiveIndex = opMul;
@@ -2308,22 +2512,71 @@ HOT void Interpret(VMGlobals *g)
 
 		case 227 : handle_op_227:
 			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
-		case 228 : handle_op_228:
-			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
+		case 228 : handle_op_228: // float division
+			if (IsFloat(sp - 1) && IsFloat(sp)) {
+				--sp; SetRaw(sp, slotRawFloat(sp) / slotRawFloat(sp + 1));
+#if TAILCALLOPTIMIZE
+				g->tailCall = 0;
+#endif
+			} else if (IsInt(sp - 1) && IsInt(sp)) {
+				double res = (double)slotRawInt(sp - 1) / (double)slotRawInt(sp);
+				--sp; SetFloat(sp, res);
+#if TAILCALLOPTIMIZE
+				g->tailCall = 0;
+#endif
+			} else
+				handleSendSpecialBinaryArithMsg(g, sp, ip, op1);
+			dispatch_opcode;
 		case 229 : handle_op_229:
 			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
-		case 230 : handle_op_230:
-			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
-		case 231 : handle_op_231:
-			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
-		case 232 : handle_op_232:
-			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
-		case 233 : handle_op_233:
-			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
-		case 234 : handle_op_234:
-			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
-		case 235 : handle_op_235:
-			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
+		case 230 : handle_op_230: // ==
+			if (compareInline(sp, opEQ)) {
+#if TAILCALLOPTIMIZE
+				g->tailCall = 0;
+#endif
+			} else
+				handleSendSpecialBinaryArithMsg(g, sp, ip, op1);
+			dispatch_opcode;
+		case 231 : handle_op_231: // !=
+			if (compareInline(sp, opNE)) {
+#if TAILCALLOPTIMIZE
+				g->tailCall = 0;
+#endif
+			} else
+				handleSendSpecialBinaryArithMsg(g, sp, ip, op1);
+			dispatch_opcode;
+		case 232 : handle_op_232: // <
+			if (compareInline(sp, opLT)) {
+#if TAILCALLOPTIMIZE
+				g->tailCall = 0;
+#endif
+			} else
+				handleSendSpecialBinaryArithMsg(g, sp, ip, op1);
+			dispatch_opcode;
+		case 233 : handle_op_233: // >
+			if (compareInline(sp, opGT)) {
+#if TAILCALLOPTIMIZE
+				g->tailCall = 0;
+#endif
+			} else
+				handleSendSpecialBinaryArithMsg(g, sp, ip, op1);
+			dispatch_opcode;
+		case 234 : handle_op_234: // <=
+			if (compareInline(sp, opLE)) {
+#if TAILCALLOPTIMIZE
+				g->tailCall = 0;
+#endif
+			} else
+				handleSendSpecialBinaryArithMsg(g, sp, ip, op1);
+			dispatch_opcode;
+		case 235 : handle_op_235: // >=
+			if (compareInline(sp, opGE)) {
+#if TAILCALLOPTIMIZE
+				g->tailCall = 0;
+#endif
+			} else
+				handleSendSpecialBinaryArithMsg(g, sp, ip, op1);
+			dispatch_opcode;
 		case 236 : handle_op_236:
 			handleSendSpecialBinaryArithMsg(g, sp, ip, op1); dispatch_opcode;
 		case 237 : handle_op_237:
@@ -2489,9 +2742,18 @@ HOT void Interpret(VMGlobals *g)
 
 			// message sends handled here:
 		msg_lookup: {
-			size_t index = slotRawInt(&classobj->classIndex) + selector->u.index;
+			size_t index;
 			PyrMethod *meth = NULL;
-			if( UNLIKELY( ( selector->flags & sym_Class ) != 0 ) )
+#if BCSTAT
+			countsend(selector);
+#endif
+			if (selector->cacheClass == classobj)
+			  {
+			    // monomorphic send: this selector resolved for the same lookup
+			    // class last time, skip the row table entirely.
+			    meth = selector->cacheMethod;
+			  }
+			else if( UNLIKELY( ( selector->flags & sym_Class ) != 0 ) )
 			  {
 			    // You have sent a message which is a class name. This is a bad thing.
 			    // There are two cases. It is either an illegitimate classname like
@@ -2503,11 +2765,17 @@ HOT void Interpret(VMGlobals *g)
 			  }
 			else
 			  {
-			    meth = gRowTable[index];
+			    PyrDispatchEntry *entry = gRowTable + slotRawInt(&classobj->classIndex) + selector->u.index;
+			    if (LIKELY(entry->selector == selector)) {
+			      meth = entry->method;
+			      selector->cacheClass = classobj;
+			      selector->cacheMethod = meth;
+			    } else
+			      meth = NULL;
 			  }
 
 			// and now if meth is null, bail out just like if I don't understand it
-			if (UNLIKELY(meth == NULL || ( slotRawSymbol(&meth->name) != selector))) {
+			if (UNLIKELY(meth == NULL)) {
 				g->sp = sp; g->ip = ip;
 				doesNotUnderstand(g, selector, numArgsPushed);
 				sp = g->sp; ip = g->ip;
@@ -2644,10 +2912,24 @@ HOT void Interpret(VMGlobals *g)
 
 			// message sends handled here:
 		key_msg_lookup: {
-			size_t index = slotRawInt(&classobj->classIndex) + selector->u.index;
-			PyrMethod *meth = gRowTable[index];
+			size_t index;
+			PyrMethod *meth;
+#if BCSTAT
+			countsend(selector);
+#endif
+			if (selector->cacheClass == classobj) {
+				meth = selector->cacheMethod;
+			} else {
+				PyrDispatchEntry *entry = gRowTable + slotRawInt(&classobj->classIndex) + selector->u.index;
+				if (LIKELY(entry->selector == selector)) {
+					meth = entry->method;
+					selector->cacheClass = classobj;
+					selector->cacheMethod = meth;
+				} else
+					meth = NULL;
+			}
 
-			if (UNLIKELY(slotRawSymbol(&meth->name) != selector)) {
+			if (UNLIKELY(meth == NULL)) {
 				g->sp = sp; g->ip = ip;
 				doesNotUnderstandWithKeys(g, selector, numArgsPushed, numKeyArgsPushed);
 				sp = g->sp; ip = g->ip;
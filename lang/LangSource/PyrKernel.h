@@ -130,7 +130,7 @@ struct PyrMethodRaw
 #ifdef PYR_SLOTS_GENERIC
 	long padding; // used for the tag in the generic pyrslot implementation
 #endif
-	unsigned short unused1;
+	unsigned short callCount;	// saturating invocation counter, see Method.callCount
 	unsigned short specialIndex;
 	unsigned short methType;
 	unsigned short frameSize;
@@ -27,7 +27,15 @@
 #include <ctype.h>
 #include <cerrno>
 #include <limits>
+#include <algorithm>
 #include <set>
+#include <map>
+#include <string>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
 
 #ifdef _WIN32
 # include <direct.h>
@@ -67,6 +75,7 @@
 #include "SC_LanguageConfig.hpp"
 
 #include "SC_DirUtils.h"
+#include "SC_Lock.h"
 #include "SC_TextUtils.hpp"
 
 int yyparse();
@@ -117,6 +126,24 @@ int parseFailed = 0;
 bool compiledOK = false;
 std::set<std::string> compiledDirectories;
 
+/* recompile avoidance.
+ *
+ * sclang cannot recompile a subset of the class library - the whole runtime
+ * and class table are torn down by shutdownLibrary() - but live sessions
+ * trigger many recompiles where no source file has changed at all. passOne
+ * records the (path, mtime) of every compiled source file; compileLibrary
+ * rescans the class path against that manifest and skips the recompile
+ * entirely when nothing changed.
+ */
+static std::map<std::string, time_t> gCompiledFileMTimes;
+static std::string gCompiledConfigPath;
+static time_t gCompiledConfigMTime = 0;
+static bool gCompiledStandalone = false;
+
+// source files discovered by the class path walk, scanned in discovery order
+// once the walk completes
+static std::vector<PyrSymbol*> gPassOneFiles;
+
 /* so the text editor's dumb paren matching will work */
 #define OPENPAREN '('
 #define OPENCURLY '{'
@@ -214,6 +241,42 @@ static bool getFileText(char* filename, char **text, int *length)
 	return true;
 }
 
+// worker thread variant of getFileText: reads into a malloc'd buffer,
+// because pyr_pool_compile may only be touched from the main thread
+static bool getFileTextMalloc(char* filename, char **text, int *length)
+{
+	FILE *file;
+	char *ltext;
+	int llength;
+
+#ifdef _WIN32
+	file = fopen(filename, "rb");
+#else
+	file = fopen(filename, "r");
+#endif
+	if (!file) return false;
+
+	fseek(file, 0L, SEEK_END);
+	llength = ftell(file);
+	fseek(file, 0L, SEEK_SET);
+	ltext = (char*)malloc((llength+1) * sizeof(char));
+#ifdef _WIN32
+	memset(ltext,0,(llength+1) * sizeof(char));
+#endif //_WIN32
+	MEMFAIL(ltext);
+
+	size_t size = fread(ltext, 1, llength, file);
+	fclose(file);
+	if (size != llength) {
+		free(ltext);
+		return false;
+	}
+	ltext[llength] = 0;
+	*length = llength;
+	*text = ltext;
+	return true;
+}
+
 
 int bugctr = 0;
 
@@ -1919,6 +1982,8 @@ void initPassOne()
 	numClassDeps = 0;
 	compiledOK = false;
 	compiledDirectories.clear();
+	gPassOneFiles.clear();
+	gCompiledFileMTimes.clear();
 	sc_InitCompileDirectory();
 	post("initPassOne done\n");
 }
@@ -1930,6 +1995,41 @@ void finiPassOne()
 	//postfl("<-finiPassOne\n");
 }
 
+/* the class path is walked on a thread pool (see sc_ParallelWalkDirectory),
+ * which hides the directory and stat latency of network mounted extension
+ * folders. the walker hands back directories and files from worker threads;
+ * everything that touches compiler globals stays on this thread, so workers
+ * only filter directories and collect file paths under a lock. */
+struct PassOneWalkState
+{
+	SC_Lock mMutex;
+	std::vector<std::string> mFiles;
+	std::vector<std::string> mExcludedDirs;
+};
+
+static bool passOne_EnterDir(const char *dirname, void *userData)
+{
+	PassOneWalkState *state = (PassOneWalkState*)userData;
+	lock_guard<SC_Lock> lock(state->mMutex);
+	if (compiledDirectories.find(std::string(dirname)) != compiledDirectories.end())
+		// already compiled
+		return false;
+	if (gLanguageConfig && gLanguageConfig->pathIsExcluded(dirname)) {
+		// post() is not safe from worker threads; report after the walk
+		state->mExcludedDirs.push_back(std::string(dirname));
+		return false;
+	}
+	compiledDirectories.insert(std::string(dirname));
+	return true;
+}
+
+static void passOne_CollectFile(const char *path, void *userData)
+{
+	PassOneWalkState *state = (PassOneWalkState*)userData;
+	lock_guard<SC_Lock> lock(state->mMutex);
+	state->mFiles.push_back(std::string(path));
+}
+
 static bool passOne_ProcessDir(const char *dirname, int level)
 {
 	if (!sc_DirectoryExists(dirname))
@@ -1948,30 +2048,99 @@ static bool passOne_ProcessDir(const char *dirname, int level)
 
 	if (level == 0) post("\tcompiling dir: '%s'\n", dirname);
 
-	SC_DirHandle *dir = sc_OpenDir(dirname);
-	if (!dir) {
+	PassOneWalkState state;
+	if (!sc_ParallelWalkDirectory(dirname, true, passOne_EnterDir, passOne_CollectFile, &state)) {
 		error("open directory failed '%s'\n", dirname); fflush(stdout);
 		return false;
 	}
 
-	for (;;) {
-		char diritem[MAXPATHLEN];
-		bool skipItem = true;
-		bool validItem = sc_ReadDir(dir, dirname, diritem, skipItem);
-		if (!validItem) break;
-		if (skipItem) continue;
+	for (size_t i = 0; i < state.mExcludedDirs.size(); ++i)
+		post("\texcluding dir: '%s'\n", state.mExcludedDirs[i].c_str());
 
-		if (sc_DirectoryExists(diritem)) {
-			success = passOne_ProcessDir(diritem, level + 1);
-		} else {
-			success = passOne_ProcessOneFile(diritem, level + 1);
-		}
+	// walk order depends on thread scheduling; sort for a stable compile order
+	std::sort(state.mFiles.begin(), state.mFiles.end());
 
+	for (size_t i = 0; i < state.mFiles.size(); ++i) {
+		success = passOne_ProcessOneFile(state.mFiles[i].c_str(), level + 1);
 		if (!success) break;
 	}
 
 	compiledDirectories.insert(std::string(dirname));
-	sc_CloseDir(dir);
+	return success;
+}
+
+/* Reading and decoding the source files is the I/O bound part of pass one
+ * and is independent per file, so it runs on a pool of worker threads. The
+ * lexer keeps its state in globals and cannot be made reentrant cheaply, so
+ * the class declaration scan stays on this thread, pipelined behind the
+ * reads: each file is scanned as soon as its prefetch completes. Workers
+ * read into malloc'd buffers and the main thread moves each one into
+ * pyr_pool_compile before scanning it, so the pool stays single threaded.
+ */
+static bool passOne_ScanCollectedFiles()
+{
+	size_t numFiles = gPassOneFiles.size();
+	if (numFiles == 0) return true;
+
+	std::vector<char*> prefetchedTexts(numFiles, (char*)NULL);
+	std::vector<int> prefetchedLengths(numFiles, 0);
+	std::unique_ptr<std::atomic<bool>[]> fileReady(new std::atomic<bool>[numFiles]);
+	for (size_t i=0; i<numFiles; ++i)
+		fileReady[i].store(false, std::memory_order_relaxed);
+	std::atomic<size_t> nextFile(0);
+
+	unsigned int numThreads = std::thread::hardware_concurrency();
+	if (numThreads < 2) numThreads = 2;
+	if ((size_t)numThreads > numFiles) numThreads = (unsigned int)numFiles;
+
+	std::vector<SC_Thread> workers;
+	for (unsigned int t=0; t<numThreads; ++t) {
+		workers.push_back(SC_Thread([&]() {
+			for (;;) {
+				size_t i = nextFile.fetch_add(1, std::memory_order_relaxed);
+				if (i >= numFiles) break;
+				char *filetext;
+				int filelength;
+				if (getFileTextMalloc(gPassOneFiles[i]->name, &filetext, &filelength)) {
+					rtf2txt(filetext);
+					prefetchedTexts[i] = filetext;
+					prefetchedLengths[i] = filelength;
+				}
+				fileReady[i].store(true, std::memory_order_release);
+			}
+		}));
+	}
+
+	bool success = true;
+	for (size_t i=0; i<numFiles; ++i) {
+		while (!fileReady[i].load(std::memory_order_acquire))
+			std::this_thread::yield();
+
+		PyrSymbol *fileSym = gPassOneFiles[i];
+		if (prefetchedTexts[i]) {
+			int length = prefetchedLengths[i];
+			char *pooltext = (char*)pyr_pool_compile->Alloc((length+1) * sizeof(char));
+			MEMFAIL(pooltext);
+			memcpy(pooltext, prefetchedTexts[i], length+1);
+			free(prefetchedTexts[i]);
+			prefetchedTexts[i] = NULL;
+			fileSym->u.source = pooltext;
+		}
+		// after a failed prefetch u.source stays NULL and startLexer retries
+		// the read here, reproducing the old error behavior
+		if (startLexer(fileSym, -1, -1, -1)) {
+			while (parseOneClass(fileSym)) { };
+			finiLexer();
+		} else {
+			error("file '%s' open failed\n", fileSym->name);
+			success = false;
+			break;
+		}
+	}
+
+	for (size_t t=0; t<workers.size(); ++t) workers[t].join();
+	for (size_t i=0; i<numFiles; ++i) free(prefetchedTexts[i]);
+	gPassOneFiles.clear();
 	return success;
 }
 
@@ -1987,6 +2156,9 @@ bool passOne()
 		if (!gLanguageConfig->forEachIncludedDirectory(passOne_ProcessDir))
 			return false;
 
+	if (!passOne_ScanCollectedFiles())
+		return false;
+
 	finiPassOne();
 	return true;
 }
@@ -2030,15 +2202,11 @@ bool passOne_ProcessOneFile(const char * filenamearg, int level)
 
 	if (isValidSourceFileName(filename)) {
 		gNumCompiledFiles++;
+		struct stat statbuf;
+		gCompiledFileMTimes[filename] = (stat(filename, &statbuf) == 0) ? statbuf.st_mtime : 0;
 		PyrSymbol * fileSym = getsym(filename);
 		fileSym->u.source = NULL;
-		if (startLexer(fileSym, -1, -1, -1)) {
-			while (parseOneClass(fileSym)) { };
-			finiLexer();
-		} else {
-			error("file '%s' open failed\n", filename);
-			success = false;
-		}
+		gPassOneFiles.push_back(fileSym);
 	} else {
 		if (sc_DirectoryExists(filename))
 			success = passOne_ProcessDir(filename, level);
@@ -2046,6 +2214,107 @@ bool passOne_ProcessOneFile(const char * filenamearg, int level)
 	return success;
 }
 
+// rescan of the class path against the manifest of the previous compile
+static std::set<std::string> gScanVisitedDirs;
+static size_t gScanMatchCount;
+static bool gScanMismatch;
+
+static bool classSources_ScanDir(const char *dirname, int level)
+{
+	if (!sc_DirectoryExists(dirname))
+		return true;
+
+	if (!gScanVisitedDirs.insert(std::string(dirname)).second)
+		return true; // already scanned
+
+	if (gLanguageConfig && gLanguageConfig->pathIsExcluded(dirname))
+		return true;
+
+	SC_DirHandle *dir = sc_OpenDir(dirname);
+	if (!dir) {
+		gScanMismatch = true;
+		return false;
+	}
+
+	for (;;) {
+		char diritem[MAXPATHLEN];
+		bool skipItem = true;
+		bool validItem = sc_ReadDir(dir, dirname, diritem, skipItem);
+		if (!validItem) break;
+		if (skipItem) continue;
+
+		if (sc_DirectoryExists(diritem)) {
+			if (!classSources_ScanDir(diritem, level + 1)) {
+				sc_CloseDir(dir);
+				return false;
+			}
+		} else {
+			bool isAlias = false;
+			char filename[MAXPATHLEN];
+			if (sc_ResolveIfAlias(diritem, filename, isAlias, MAXPATHLEN) < 0)
+				continue;
+			if (gLanguageConfig && gLanguageConfig->pathIsExcluded(filename))
+				continue;
+			if (!isValidSourceFileName(filename))
+				continue;
+
+			std::map<std::string, time_t>::iterator it = gCompiledFileMTimes.find(filename);
+			struct stat statbuf;
+			if (it == gCompiledFileMTimes.end()
+				|| stat(filename, &statbuf) != 0
+				|| statbuf.st_mtime != it->second) {
+				gScanMismatch = true; // new or modified file
+				sc_CloseDir(dir);
+				return false;
+			}
+			++gScanMatchCount;
+		}
+	}
+
+	sc_CloseDir(dir);
+	return true;
+}
+
+// true if every source file of the previous successful compile is still
+// present and unchanged, and no source file has been added or removed
+static bool classLibraryUpToDate(bool standalone)
+{
+	if (!compiledOK || gCompiledFileMTimes.empty())
+		return false;
+	if (standalone != gCompiledStandalone)
+		return false;
+
+	// a changed include/exclude configuration invalidates everything
+	const char *configPath = gLanguageConfig ? gLanguageConfig->getCurrentConfigPath() : "";
+	if (!configPath) configPath = "";
+	if (gCompiledConfigPath != configPath)
+		return false;
+	if (!gCompiledConfigPath.empty()) {
+		struct stat statbuf;
+		time_t configMTime = (stat(gCompiledConfigPath.c_str(), &statbuf) == 0) ? statbuf.st_mtime : 0;
+		if (configMTime != gCompiledConfigMTime)
+			return false;
+	}
+
+	gScanVisitedDirs.clear();
+	gScanMatchCount = 0;
+	gScanMismatch = false;
+
+	bool complete;
+	if (sc_IsStandAlone())
+		complete = classSources_ScanDir(gCompileDir, 0);
+	else
+		complete = gLanguageConfig && gLanguageConfig->forEachIncludedDirectory(classSources_ScanDir);
+
+	gScanVisitedDirs.clear();
+
+	if (!complete || gScanMismatch)
+		return false;
+
+	// a removed file leaves the match count short of the manifest
+	return gScanMatchCount == gCompiledFileMTimes.size();
+}
+
 void schedRun();
 
 void compileSucceeded();
@@ -2128,6 +2397,11 @@ void shutdownLibrary()
 SCLANG_DLLEXPORT_C bool compileLibrary(bool standalone)
 {
 	//printf("->compileLibrary\n");
+	if (classLibraryUpToDate(standalone)) {
+		postfl("class library unchanged, skipping recompile\n");
+		return compiledOK;
+	}
+
 	shutdownLibrary();
 
 	gLangMutex.lock();
@@ -2136,6 +2410,15 @@ SCLANG_DLLEXPORT_C bool compileLibrary(bool standalone)
 
 	SC_LanguageConfig::readLibraryConfig(standalone);
 
+	gCompiledStandalone = standalone;
+	{
+		const char *configPath = gLanguageConfig ? gLanguageConfig->getCurrentConfigPath() : "";
+		gCompiledConfigPath = configPath ? configPath : "";
+		struct stat statbuf;
+		gCompiledConfigMTime = (!gCompiledConfigPath.empty() && stat(gCompiledConfigPath.c_str(), &statbuf) == 0)
+			? statbuf.st_mtime : 0;
+	}
+
 	compileStartTime = elapsedTime();
 
 	totalByteCodes = 0;
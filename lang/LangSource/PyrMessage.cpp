@@ -34,7 +34,7 @@
 #define DEBUGMETHODS 0
 #define METHODMETER 0
 
-PyrMethod **gRowTable;
+PyrDispatchEntry *gRowTable;
 
 PyrSlot keywordstack[MAXKEYSLOTS];
 bool gKeywordError = true;
@@ -70,10 +70,20 @@ HOT void sendMessageWithKeys(VMGlobals *g, PyrSymbol *selector, long numArgsPush
 	classobj = classOfSlot(recvrSlot);
 
 	lookup_again:
-	index = slotRawInt(&classobj->classIndex) + selector->u.index;
-	meth = gRowTable[index];
+	if (selector->cacheClass == classobj) {
+		meth = selector->cacheMethod;
+	} else {
+		index = slotRawInt(&classobj->classIndex) + selector->u.index;
+		PyrDispatchEntry *entry = gRowTable + index;
+		if (entry->selector == selector) {
+			meth = entry->method;
+			selector->cacheClass = classobj;
+			selector->cacheMethod = meth;
+		} else
+			meth = NULL;
+	}
 
-	if (slotRawSymbol(&meth->name) != selector) {
+	if (meth == NULL) {
 		doesNotUnderstandWithKeys(g, selector, numArgsPushed, numKeyArgsPushed);
 	} else {
 		methraw = METHRAW(meth);
@@ -203,10 +213,20 @@ HOT void sendMessage(VMGlobals *g, PyrSymbol *selector, long numArgsPushed)
 	classobj = classOfSlot(recvrSlot);
 
 	lookup_again:
-	index = slotRawInt(&classobj->classIndex) + selector->u.index;
-	meth = gRowTable[index];
+	if (selector->cacheClass == classobj) {
+		meth = selector->cacheMethod;
+	} else {
+		index = slotRawInt(&classobj->classIndex) + selector->u.index;
+		PyrDispatchEntry *entry = gRowTable + index;
+		if (entry->selector == selector) {
+			meth = entry->method;
+			selector->cacheClass = classobj;
+			selector->cacheMethod = meth;
+		} else
+			meth = NULL;
+	}
 
-	if (slotRawSymbol(&meth->name) != selector) {
+	if (meth == NULL) {
 		doesNotUnderstand(g, selector, numArgsPushed);
 	} else {
 		methraw = METHRAW(meth);
@@ -389,10 +409,20 @@ HOT void sendSuperMessageWithKeys(VMGlobals *g, PyrSymbol *selector, long numArg
 	//assert(isKindOfSlot(recvrSlot, classobj));
 
 	lookup_again:
-	index = slotRawInt(&classobj->classIndex) + selector->u.index;
-	meth = gRowTable[index];
+	if (selector->cacheClass == classobj) {
+		meth = selector->cacheMethod;
+	} else {
+		index = slotRawInt(&classobj->classIndex) + selector->u.index;
+		PyrDispatchEntry *entry = gRowTable + index;
+		if (entry->selector == selector) {
+			meth = entry->method;
+			selector->cacheClass = classobj;
+			selector->cacheMethod = meth;
+		} else
+			meth = NULL;
+	}
 
-	if (slotRawSymbol(&meth->name) != selector) {
+	if (meth == NULL) {
 		doesNotUnderstandWithKeys(g, selector, numArgsPushed, numKeyArgsPushed);
 	} else {
 		methraw = METHRAW(meth);
@@ -523,10 +553,20 @@ HOT void sendSuperMessage(VMGlobals *g, PyrSymbol *selector, long numArgsPushed)
 	//assert(isKindOfSlot(recvrSlot, classobj));
 
 	lookup_again:
-	index = slotRawInt(&classobj->classIndex) + selector->u.index;
-	meth = gRowTable[index];
+	if (selector->cacheClass == classobj) {
+		meth = selector->cacheMethod;
+	} else {
+		index = slotRawInt(&classobj->classIndex) + selector->u.index;
+		PyrDispatchEntry *entry = gRowTable + index;
+		if (entry->selector == selector) {
+			meth = entry->method;
+			selector->cacheClass = classobj;
+			selector->cacheMethod = meth;
+		} else
+			meth = NULL;
+	}
 
-	if (slotRawSymbol(&meth->name) != selector) {
+	if (meth == NULL) {
 		doesNotUnderstand(g, selector, numArgsPushed);
 	} else {
 		methraw = METHRAW(meth);
@@ -718,7 +758,7 @@ void doesNotUnderstandWithKeys(VMGlobals *g, PyrSymbol *selector,
 	classobj = classOfSlot(recvrSlot);
 
 	index = slotRawInt(&classobj->classIndex) + s_doesNotUnderstand->u.index;
-	meth = gRowTable[index];
+	meth = gRowTable[index].method;
 
 
 	if (slotRawClass(&meth->ownerclass) == class_object) {
@@ -791,7 +831,7 @@ void doesNotUnderstand(VMGlobals *g, PyrSymbol *selector,
 	classobj = classOfSlot(recvrSlot);
 
 	index = slotRawInt(&classobj->classIndex) + s_doesNotUnderstand->u.index;
-	meth = gRowTable[index];
+	meth = gRowTable[index].method;
 
 
 	if (slotRawClass(&meth->ownerclass) == class_object) {
@@ -882,6 +922,7 @@ HOT void executeMethodWithKeys(VMGlobals *g, PyrMethod *meth, long allArgsPushed
 
 	proto = slotRawObject(&meth->prototypeFrame);
 	methraw = METHRAW(meth);
+	methraw->callCount += (methraw->callCount != USHRT_MAX);
 	numtemps = methraw->numtemps;
 	numargs = methraw->numargs;
 	caller = g->frame;
@@ -1038,6 +1079,7 @@ HOT void executeMethod(VMGlobals *g, PyrMethod *meth, long numArgsPushed)
 
 	proto = slotRawObject(&meth->prototypeFrame);
 	methraw = METHRAW(meth);
+	methraw->callCount += (methraw->callCount != USHRT_MAX);
 	numtemps = methraw->numtemps;
 	numargs = methraw->numargs;
 
@@ -1276,7 +1318,10 @@ HOT void returnFromMethod(VMGlobals *g)
 				methraw = METHRAW(meth);
 				PyrFrame *nextFrame = slotRawFrame(&tempFrame->caller);
 				if (!methraw->needsHeapContext) {
-					SetInt(&tempFrame->caller, 0);
+					// the compiler proved nothing captures this frame, so it can go straight
+					// back on the free list instead of waiting for the collector, just as
+					// returnFromBlock does for block frames.
+					g->gc->Free(tempFrame);
 				} else {
 					if (tempFrame != homeContext)
 						SetInt(&tempFrame->caller, 0);
@@ -27,7 +27,18 @@
 #define MAXKEYSLOTS 128
 extern PyrSlot keywordstack[MAXKEYSLOTS];
 extern bool gKeywordError;
-extern PyrMethod **gRowTable;
+
+// one slot of the compressed dispatch table built by buildBigMethodMatrix.
+// the selector is stored next to the method so a send can verify the hit
+// (the row displacement scheme lets columns overlap) against the entry
+// itself instead of loading the method's name - one cache line touched
+// instead of two on the lookup path.
+struct PyrDispatchEntry {
+	PyrSymbol *selector;
+	PyrMethod *method;
+};
+
+extern PyrDispatchEntry *gRowTable;
 
 void initUniqueMethods();
 
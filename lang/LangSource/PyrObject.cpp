@@ -1165,6 +1165,19 @@ void buildBigMethodMatrix()
 	const size_t numClasses = gNumClasses;
 	//post("allocate arrays\n");
 
+	// the row table is about to be rebuilt and all methods reallocated, so the
+	// send caches stored in the selector symbols must not survive this point.
+	{
+		SymbolTable* symbolTable = gMainVMGlobals->symbolTable;
+		for (int i = 0, imax = symbolTable->TableSize(); i < imax; ++i) {
+			PyrSymbol *sym = symbolTable->Get(i);
+			if (sym) {
+				sym->cacheClass = NULL;
+				sym->cacheMethod = NULL;
+			}
+		}
+	}
+
 #if CHECK_METHOD_LOOKUP_TABLE_BUILD_TIME
 	double t0 = elapsedTime();
 #endif
@@ -1304,13 +1317,15 @@ void buildBigMethodMatrix()
 		//	sels[i].rowWidth, rowOffset, freeIndex);
 	}
 	//post("alloc row table %d\n", freeIndex);
-	rowTableSize = (freeIndex + numClasses)  * sizeof(PyrMethod*);
-	gRowTable = (PyrMethod**)pyr_pool_runtime->Alloc(rowTableSize);
+	rowTableSize = (freeIndex + numClasses)  * sizeof(PyrDispatchEntry);
+	gRowTable = (PyrDispatchEntry*)pyr_pool_runtime->Alloc(rowTableSize);
 	MEMFAIL(gRowTable);
 
 	// having the method ptr always be valid saves a branch in SendMessage()
-	for (int i=0; i<freeIndex + numClasses; ++i)
-		gRowTable[i] = gNullMethod;
+	for (int i=0; i<freeIndex + numClasses; ++i) {
+		gRowTable[i].selector = NULL;
+		gRowTable[i].method = gNullMethod;
+	}
 
 	//post("fill compressed table\n");
 	//{ FILE* fp;
@@ -1321,17 +1336,19 @@ void buildBigMethodMatrix()
 		offset = sels[i].rowOffset + sels[i].minClassIndex;
 		maxwidth = offset + sels[i].rowWidth;
 		row = bigTable + sels[i].minClassIndex * numSelectors + i;
-		PyrMethod ** table = gRowTable;
+		PyrDispatchEntry * table = gRowTable;
 		for (j=offset,k=0; j<maxwidth; ++j, k+=numSelectors) {
-			if (row[k])
-				table[j] = row[k];
+			if (row[k]) {
+				table[j].selector = sels[i].selector;
+				table[j].method = row[k];
+			}
 		}
 	}
 	//fclose(fp);
 	//}
 
 	for (int i=0; i<freeIndex + numClasses; ++i)
-		assert(gRowTable[i]);
+		assert(gRowTable[i].method);
 
 
 	//post("freeIndex %d\n", freeIndex);
@@ -1342,11 +1359,11 @@ void buildBigMethodMatrix()
 	post("building table took %.3g seconds\n", elapsedTime() - t0);
 	{
 		int numFilled = 0;
-		for (int i=0; i<rowTableSize/sizeof(PyrMethod*); ++i) {
-			if (gRowTable[i] != gNullMethod) numFilled++;
+		for (int i=0; i<rowTableSize/sizeof(PyrDispatchEntry); ++i) {
+			if (gRowTable[i].method != gNullMethod) numFilled++;
 		}
-		post("Filled %d of %d = %f percent\n", numFilled, rowTableSize/sizeof(PyrMethod*),
-			100. * (double)numFilled/(rowTableSize/sizeof(PyrMethod*)));
+		post("Filled %d of %d = %f percent\n", numFilled, rowTableSize/sizeof(PyrDispatchEntry),
+			100. * (double)numFilled/(rowTableSize/sizeof(PyrDispatchEntry)));
 	}
 #endif
 	post("\t%d method selectors, %d classes\n", numSelectors, numClasses);
@@ -2333,14 +2350,12 @@ void DumpDetailedFrame(PyrFrame *frame)
 bool respondsTo(PyrSlot *slot, PyrSymbol *selector)
 {
 	PyrClass *classobj;
-	PyrMethod *meth;
 	int index;
 
 	classobj = classOfSlot(slot);
 
 	index = slotRawInt(&classobj->classIndex) + selector->u.index;
-	meth = gRowTable[index];
-	return slotRawSymbol(&meth->name) == selector;
+	return gRowTable[index].selector == selector;
 }
 
 PyrMethod* methodLookup(PyrSlot *slot, PyrSymbol *selector);
@@ -2353,7 +2368,7 @@ PyrMethod* methodLookup(PyrSlot *slot, PyrSymbol *selector)
 	classobj = classOfSlot(slot);
 
 	index = slotRawInt(&classobj->classIndex) + selector->u.index;
-	meth = gRowTable[index];
+	meth = gRowTable[index].method;
 	return meth;
 }
 
@@ -38,6 +38,8 @@
 #include "SimpleStack.h"
 #include "PyrPrimitive.h"
 #include "SC_Win32Utils.h"
+#include "Hash.h"
+#include <unordered_map>
 
 AdvancingAllocPool gParseNodePool;
 
@@ -154,8 +156,11 @@ void finiParser()
 {
 }
 
+void clearLiteralArrayCache();
+
 void initParseNodes()
 {
+	clearLiteralArrayCache();
 }
 
 void initParserPool()
@@ -608,7 +613,7 @@ void fillClassPrototypes(PyrClassNode *node, PyrClass *classobj, PyrClass *super
 						// create getter method
 						method = newPyrMethod();
 						methraw = METHRAW(method);
-                                                methraw->unused1 = 0;
+                                                methraw->callCount = 0;
                                                 methraw->unused2 = 0;
 						methraw->numargs = 1;
 						methraw->numvars = 0;
@@ -637,7 +642,7 @@ void fillClassPrototypes(PyrClassNode *node, PyrClass *classobj, PyrClass *super
 						// create setter method
 						method = newPyrMethod();
 						methraw = METHRAW(method);
-                                                methraw->unused1 = 0;
+                                                methraw->callCount = 0;
                                                 methraw->unused2 = 0;
 						methraw->numargs = 2;
 						methraw->numvars = 0;
@@ -672,7 +677,7 @@ void fillClassPrototypes(PyrClassNode *node, PyrClass *classobj, PyrClass *super
 						// create getter method
 						method = newPyrMethod();
 						methraw = METHRAW(method);
-                                                methraw->unused1 = 0;
+                                                methraw->callCount = 0;
                                                 methraw->unused2 = 0;
 						methraw->numargs = 1;
 						methraw->numvars = 0;
@@ -737,7 +742,7 @@ void fillClassPrototypes(PyrClassNode *node, PyrClass *classobj, PyrClass *super
 						// create getter method
 						method = newPyrMethod();
 						methraw = METHRAW(method);
-                                                methraw->unused1 = 0;
+                                                methraw->callCount = 0;
                                                 methraw->unused2 = 0;
 						methraw->numargs = 1;
 						methraw->numvars = 0;
@@ -1262,7 +1267,7 @@ void PyrMethodNode::compile(PyrSlot *result)
 	SetObject(&method->ownerclass, gCompilingClass);
 
 	methraw = METHRAW(method);
-	methraw->unused1 = 0;
+	methraw->callCount = 0;
 	methraw->unused2 = 0;
 
 	//postfl("method %p raw %p\n", method, methraw);
@@ -1803,7 +1808,7 @@ void PyrCallNodeBase::compilePartialApplication(int numCurryArgs, PyrSlot *resul
 	gPartiallyAppliedFunction = block;
 
 	PyrMethodRaw* methraw = METHRAW(block);
-	methraw->unused1 = 0;
+	methraw->callCount = 0;
 	methraw->unused2 = 0;
 
 	methraw->needsHeapContext = 0;
@@ -3175,7 +3180,8 @@ void compilePushConstant(PyrParseNode* node, PyrSlot *slot)
 {
 	int index = conjureConstantIndex(node, gCompilingBlock, slot);
 	if (index < (1<<4)) {
-		compileByte((opPushLiteral << 4) | index);
+		// through compileOpcode so the peephole can fuse a following binary op
+		compileOpcode(opPushLiteral, index);
 	} else if (index < (1<<8)) {
 		compileByte(40);
 		compileByte(index & 0xFF);
@@ -3728,6 +3734,45 @@ PyrLitListNode* newPyrLitListNode(PyrParseNode *classname, PyrParseNode *elems)
 	return node;
 }
 
+// hash-cons cache for compiled literal arrays. generated class files can
+// repeat the same literal array thousands of times; literal arrays are
+// immutable, so all occurrences compiled during a class library compile can
+// share one permanent object instead of each allocating a copy. keyed by a
+// hash of the element slots; elements are compared with SlotEq (exact bit
+// equality), and nested literal arrays cons as well because their elements
+// are interned bottom-up, making pointer comparison sufficient for them.
+// cleared by initParseNodes at the start of each library compile, when the
+// runtime pool holding the cached objects is torn down.
+static std::unordered_multimap<int, PyrObject*> gLiteralArrayCache;
+
+void clearLiteralArrayCache()
+{
+	gLiteralArrayCache.clear();
+}
+
+static PyrObject* conjureSharedLiteralArray(PyrObject *array)
+{
+	int hash = Hash(array->size);
+	for (int i=0; i<array->size; ++i)
+		hash = Hash(hash + calcHash(array->slots + i));
+
+	auto range = gLiteralArrayCache.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it) {
+		PyrObject *candidate = it->second;
+		if (candidate->size != array->size) continue;
+		bool equal = true;
+		for (int i=0; i<array->size; ++i) {
+			if (!SlotEq(candidate->slots + i, array->slots + i)) {
+				equal = false;
+				break;
+			}
+		}
+		if (equal) return candidate;
+	}
+	gLiteralArrayCache.insert(std::make_pair(hash, array));
+	return array;
+}
+
 void PyrLitListNode::compile(PyrSlot* result)
 {
 	PyrSlot *resultSlot;
@@ -3751,6 +3796,17 @@ void PyrLitListNode::compile(PyrSlot* result)
 		array->slots[i] = itemSlot;
 	}
 	array->size = numItems;
+
+	// objects compiled for the command line are garbage collected, so only
+	// permanent class library literals may enter (or be handed out of) the
+	// shared cache.
+	if (!compilingCmdLine) {
+		PyrObject *shared = conjureSharedLiteralArray(array);
+		if (shared != array) {
+			freePyrObject(array);
+			array = shared;
+		}
+	}
 	SetObject(resultSlot, array);
 	//postfl("<-compilePyrLitListNode\n");
 }
@@ -3887,7 +3943,7 @@ void PyrBlockNode::compile(PyrSlot* slotResult)
 	gPartiallyAppliedFunction = NULL;
 
 	methraw = METHRAW(block);
-	methraw->unused1 = 0;
+	methraw->callCount = 0;
 	methraw->unused2 = 0;
 
 	int endCharNo = linestarts[mLineno] + mCharno;
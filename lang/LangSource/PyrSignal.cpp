@@ -165,6 +165,27 @@ PyrObject* signal_mul_xx(VMGlobals *g, PyrObject* ina, PyrObject* inb)
 	BINOP_LOOP1(*);
 }
 
+PyrObject* signal_add_ds_xx(VMGlobals *g, PyrObject* ina, PyrObject* inb)
+{
+	BINOP_LOOP2_DS(
+		*++c = *++a + *++b;
+	);
+}
+
+PyrObject* signal_sub_ds_xx(VMGlobals *g, PyrObject* ina, PyrObject* inb)
+{
+	BINOP_LOOP2_DS(
+		*++c = *++a - *++b;
+	);
+}
+
+PyrObject* signal_mul_ds_xx(VMGlobals *g, PyrObject* ina, PyrObject* inb)
+{
+	BINOP_LOOP2_DS(
+		*++c = *++a * *++b;
+	);
+}
+
 PyrObject* signal_sub_xx(VMGlobals *g, PyrObject* ina, PyrObject* inb)
 {
 	BINOP_LOOP2(
@@ -110,49 +110,56 @@ PyrObject* newPyrSignal(VMGlobals *g, long size);
 
 #else
 
+// plain counted loops: the hand scheduled Duff's device these used to be
+// defeated the compiler's auto-vectorizer, which turns the simple kernels
+// into SIMD code on its own when the trip count is visible.
+
 #define BINOP_LOOP1(OP)	\
-	float *a, *b, *c, *endptr;	\
+	float *a, *b, *c;	\
 	PyrObject *outc;	\
-	long size;	\
+	long size, tempi;	\
 	a = (float*)(ina->slots) - 1;	\
 	b = (float*)(inb->slots) - 1;	\
 	size = sc_min(ina->size, inb->size);	\
 	outc = newPyrSignal(g, size);	\
 	c = (float*)(outc->slots) - 1;	\
-	endptr = c + size;	\
-	switch (size & 3) {	\
-		while (c < endptr) {	\
-			         *++c = *++a OP *++b;	\
-			case 3 : *++c = *++a OP *++b;		\
-			case 2 : *++c = *++a OP *++b;		\
-			case 1 : *++c = *++a OP *++b;		\
-			case 0 : ;			\
-		}						\
+	for (tempi=0; tempi<size; ++tempi) {	\
+		*++c = *++a OP *++b;	\
 	}	\
 	return outc;	\
 
 
 #define BINOP_LOOP2(STMT1)	\
-	float *a, *b, *c, *endptr;	\
+	float *a, *b, *c;	\
 	PyrObject *outc;	\
-	long size;	\
+	long size, tempi;	\
 	a = (float*)(ina->slots) - 1;	\
 	b = (float*)(inb->slots) - 1;	\
 	size = sc_min(ina->size, inb->size);	\
 	outc = newPyrSignal(g, size);	\
 	c = (float*)(outc->slots) - 1;	\
-	endptr = c + size;	\
-	switch (size & 3) {	\
-		while (c < endptr) {	\
-			        STMT1;		\
-			case 3 :STMT1;		\
-			case 2 :STMT1;		\
-			case 1 :STMT1;		\
-			case 0 : ;			\
-		}						\
+	for (tempi=0; tempi<size; ++tempi) {	\
+		STMT1;	\
 	}	\
 	return outc;	\
 
+// in-place counterpart: overwrites the receiver instead of allocating a
+// result object. the tracing GC keeps no reference counts, so callers assert
+// uniqueness by choosing the destructive method explicitly (Signal:addInPlace
+// and friends), following the overDub/overWrite precedent.
+
+#define BINOP_LOOP2_DS(STMT1)	\
+	float *a, *b, *c;	\
+	long size, tempi;	\
+	a = (float*)(ina->slots) - 1;	\
+	b = (float*)(inb->slots) - 1;	\
+	size = sc_min(ina->size, inb->size);	\
+	c = (float*)(ina->slots) - 1;	\
+	for (tempi=0; tempi<size; ++tempi) {	\
+		STMT1;	\
+	}	\
+	return ina;	\
+
 #endif
 
 /*
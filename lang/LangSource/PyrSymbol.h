@@ -41,6 +41,10 @@ struct PyrSymbol {
 		char *source; // source code for sym_Filename; used only during compilation.
 	} u;
 	struct classdep *classdep;
+	// monomorphic send cache: the last lookup class and method this symbol
+	// resolved to as a selector. cleared whenever the method table is rebuilt.
+	struct PyrClass *cacheClass;
+	struct PyrMethod *cacheMethod;
 };
 
 enum {
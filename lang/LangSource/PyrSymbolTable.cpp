@@ -23,6 +23,7 @@
 #include "clz.h"
 #include <stdlib.h>
 #include <string.h>
+#include <new>
 #include "InitAlloc.h"
 #include "VMGlobals.h"
 #include "Hash.h"
@@ -51,11 +52,16 @@ SCLANG_DLLEXPORT_C PyrSymbol* findsym(const char *name)
 	return symbol;
 }
 
-SymbolSpace::SymbolSpace(AllocPool *inPool)
+SymbolSpace::SymbolSpace()
+	: mPool(NULL)
+{
+}
+
+void SymbolSpace::Init(AllocPool *inPool, size_t inStringChunk, size_t inSymbolChunk)
 {
 	mPool = inPool;
-	mStringPool.Init(inPool, STRINGCHUNK, STRINGCHUNK, STRINGCHUNK/5);
-	mSymbolPool.Init(inPool, SYMBOLCHUNK, SYMBOLCHUNK, SYMBOLCHUNK/5);
+	mStringPool.Init(inPool, inStringChunk, inStringChunk, inStringChunk/5);
+	mSymbolPool.Init(inPool, inSymbolChunk, inSymbolChunk, inSymbolChunk/5);
 }
 
 
@@ -76,23 +82,55 @@ PyrSymbol* SymbolSpace::NewSymbol(const char *inName, int inHash, int inLength)
 	if (inLength > 1 && inName[inLength-1] == '_') sym->flags |= sym_Setter;
 	sym->u.index = 0;
 	sym->classdep = NULL;
+	sym->cacheClass = NULL;
+	sym->cacheMethod = NULL;
 	return sym;
 }
 
 
 SymbolTable::SymbolTable(AllocPool *inPool, int inSize)
-	: mPool(inPool), mSpace(inPool), mMaxItems(inSize)
+	: mPool(inPool)
 {
 	assert(ISPOWEROFTWO(inSize));
+	assert(inSize >= kNumShards);
+
+	for (int i=0; i<kNumShards; ++i) {
+		Shard& shard = mShards[i];
+		shard.mSpace.Init(inPool, STRINGCHUNK/kNumShards, SYMBOLCHUNK/kNumShards);
+		shard.mTable.store(AllocShardTable(inSize/kNumShards), std::memory_order_relaxed);
+		shard.mNumItems = 0;
+	}
+}
 
-	AllocTable();
+int SymbolTable::NumItems()
+{
+	int numItems = 0;
+	for (int i=0; i<kNumShards; ++i) {
+		numItems += mShards[i].mNumItems;
+	}
+	return numItems;
 }
 
+int SymbolTable::TableSize()
+{
+	int tableSize = 0;
+	for (int i=0; i<kNumShards; ++i) {
+		ShardTable *table = mShards[i].mTable.load(std::memory_order_acquire);
+		tableSize += table->mMask + 1;
+	}
+	return tableSize;
+}
 
-void SymbolTable::CopyFrom(SymbolTable& inTable)
+PyrSymbol* SymbolTable::Get(int inIndex)
 {
-	MakeEmpty();
-	Rehash(inTable.mTable, inTable.mMaxItems);
+	// flat view over all shards, for the diagnostic table scans
+	for (int i=0; i<kNumShards; ++i) {
+		ShardTable *table = mShards[i].mTable.load(std::memory_order_acquire);
+		int size = table->mMask + 1;
+		if (inIndex < size) return table->mSlots[inIndex].load(std::memory_order_acquire);
+		inIndex -= size;
+	}
+	return NULL;
 }
 
 int SymbolTable::StrHash(const char *inName, size_t *outLength)
@@ -104,90 +142,99 @@ PyrSymbol* SymbolTable::Find(const char *inName)
 {
 	size_t length;
 	int hash = StrHash(inName, &length);
-	return Find(inName, hash);
+	Shard& shard = ShardFor(hash);
+	return FindIn(shard.mTable.load(std::memory_order_acquire), inName, hash);
 }
 
-PyrSymbol* SymbolTable::Find(const char *inName, int inHash)
+PyrSymbol* SymbolTable::FindIn(ShardTable *inTable, const char *inName, int inHash)
 {
-	int index = inHash & mMask;
-	PyrSymbol* sym = mTable[index];
+	int mask = inTable->mMask;
+	int index = inHash & mask;
+	PyrSymbol* sym = inTable->mSlots[index].load(std::memory_order_acquire);
 	while (sym && (sym->hash != inHash || strcmp(inName, sym->name)!=0)) {
-		index = (index+1) & mMask;
-		sym = mTable[index];
+		index = (index+1) & mask;
+		sym = inTable->mSlots[index].load(std::memory_order_acquire);
 	}
 	return sym;
 }
 
-void SymbolTable::Add(PyrSymbol* inSymbol)
+void SymbolTable::Insert(Shard& ioShard, PyrSymbol* inSymbol)
 {
-	if (mNumItems + 1 > (mMaxItems>>1)) Grow();
-
-	int index = inSymbol->hash & mMask;
-	PyrSymbol *testSymbol = mTable[index];
-	while (testSymbol && testSymbol != inSymbol) {
-		index = (index + 1) & mMask;
-		testSymbol = mTable[index];
-	}
-	if (!testSymbol) {	// if it is not already in the table.
-		mTable[index] = inSymbol;
-		mNumItems ++ ;
+	ShardTable *table = ioShard.mTable.load(std::memory_order_relaxed);
+	if (ioShard.mNumItems + 1 > ((table->mMask+1)>>1)) {
+		Grow(ioShard);
+		table = ioShard.mTable.load(std::memory_order_relaxed);
 	}
-}
-
-PyrSymbol* SymbolTable::MakeNew(const char *inName, int inHash, int inLength)
-{
-	PyrSymbol* symbol = mSpace.NewSymbol(inName, inHash, inLength);
-	Add(symbol);
 
-	return symbol;
+	int mask = table->mMask;
+	int index = inSymbol->hash & mask;
+	while (table->mSlots[index].load(std::memory_order_relaxed)) {
+		index = (index + 1) & mask;
+	}
+	// release store: the symbol is fully built, publish it to lock free readers
+	table->mSlots[index].store(inSymbol, std::memory_order_release);
+	ioShard.mNumItems ++ ;
 }
 
 PyrSymbol* SymbolTable::Make(const char *inName)
 {
 	size_t length;
 	int hash = StrHash(inName, &length);
-	PyrSymbol* symbol = Find(inName, hash);
-	if (!symbol) symbol = MakeNew(inName, hash, length);
-	return symbol;
-}
+	Shard& shard = ShardFor(hash);
 
-void SymbolTable::MakeEmpty()
-{
-	int size = mMaxItems * sizeof(PyrSymbol*);
-	memset(mTable, 0, size);
-	mNumItems = 0 ;
-}
+	PyrSymbol* symbol = FindIn(shard.mTable.load(std::memory_order_acquire), inName, hash);
+	if (symbol) return symbol;
 
-void SymbolTable::AllocTable()
-{
-	int size = mMaxItems * sizeof(PyrSymbol*);
-	mTable = (PyrSymbol**)mPool->Alloc(size);
-	MEMFAIL(mTable);
+	lock_guard<SC_Lock> lock(shard.mLock);
+	// re-probe under the lock: another thread may have interned the same
+	// name between the optimistic lookup and here
+	symbol = FindIn(shard.mTable.load(std::memory_order_relaxed), inName, hash);
+	if (symbol) return symbol;
 
-	MakeEmpty();
-	mMask = mMaxItems - 1;
+	symbol = shard.mSpace.NewSymbol(inName, hash, (int)length);
+	Insert(shard, symbol);
+	return symbol;
 }
 
-void SymbolTable::Rehash(PyrSymbol** inTable, int inSize)
+SymbolTable::ShardTable* SymbolTable::AllocShardTable(int inSize)
 {
-	// rehash all entries from inTable into the new table
+	assert(ISPOWEROFTWO(inSize));
+
+	size_t size = sizeof(ShardTable) + (inSize - 1) * sizeof(std::atomic<PyrSymbol*>);
+	ShardTable *table = (ShardTable*)mPool->Alloc(size);
+	MEMFAIL(table);
+
+	table->mMask = inSize - 1;
 	for (int i=0; i<inSize; ++i) {
-		if (inTable[i]) Add(inTable[i]);
+		new (&table->mSlots[i]) std::atomic<PyrSymbol*>(NULL);
 	}
+	return table;
 }
 
-void SymbolTable::Grow()
+void SymbolTable::Grow(Shard& ioShard)
 {
-	PyrSymbol **oldtable = mTable;
-	int oldsize = mMaxItems;
-
-	// create new table
-	mMaxItems += mMaxItems;
-	AllocTable();
-
-	Rehash(oldtable, oldsize);
+	ShardTable *oldTable = ioShard.mTable.load(std::memory_order_relaxed);
+	int oldSize = oldTable->mMask + 1;
+
+	ShardTable *newTable = AllocShardTable(oldSize << 1);
+	int mask = newTable->mMask;
+
+	// rehash into the unpublished table; plain stores suffice, the release
+	// store of the table pointer below publishes them all at once
+	for (int i=0; i<oldSize; ++i) {
+		PyrSymbol *sym = oldTable->mSlots[i].load(std::memory_order_relaxed);
+		if (!sym) continue;
+		int index = sym->hash & mask;
+		while (newTable->mSlots[index].load(std::memory_order_relaxed)) {
+			index = (index + 1) & mask;
+		}
+		newTable->mSlots[index].store(sym, std::memory_order_relaxed);
+	}
 
-	mPool->Free(oldtable);
+	ioShard.mTable.store(newTable, std::memory_order_release);
+	// the old table is retired but not freed: a reader that loaded the table
+	// pointer just before the swap may still be probing it. the retired
+	// tables add up to less than the size of the current one.
 }
 
 void SymbolTable::CheckSymbols()
@@ -24,6 +24,9 @@
 #include "PyrSymbol.h"
 #include "AdvancingAllocPool.h"
 #include "SC_Export.h"
+#include "SC_Lock.h"
+
+#include <atomic>
 
 #define STRINGCHUNK 32000
 #define SYMBOLCHUNK 32000
@@ -34,7 +37,8 @@ SCLANG_DLLEXPORT_C PyrSymbol* findsym(const char *name);
 class SymbolSpace
 {
 public:
-	SymbolSpace(AllocPool *inPool);
+	SymbolSpace();
+	void Init(AllocPool *inPool, size_t inStringChunk, size_t inSymbolChunk);
 	PyrSymbol* NewSymbol(const char *inName, int inHash, int inLength);
 
 private:
@@ -43,17 +47,23 @@ private:
 	AdvancingAllocPool mSymbolPool;
 };
 
+/* The symbol table is split into hash-selected shards so that interning does
+ * not serialize readers. Lookup is lock free: each shard publishes its probe
+ * array through an atomic pointer, and slots are filled with release stores
+ * once the symbol is fully built, so a reader following an acquire load can
+ * never see a half-constructed symbol. Insertion (and the occasional shard
+ * growth) happens under a per-shard lock; a lookup that misses while another
+ * thread is interning the same name simply re-probes under that lock.
+ */
 class SymbolTable
 {
 public:
 
 	SymbolTable(AllocPool *inPool, int inSize);
 
-	void CopyFrom(SymbolTable& inTable);
-
-	int NumItems() { return mNumItems; }
-	int TableSize() { return mMaxItems; }
-	PyrSymbol* Get(int inIndex) { return mTable[inIndex]; }
+	int NumItems();
+	int TableSize();
+	PyrSymbol* Get(int inIndex);
 
 	void CheckSymbols();
 
@@ -61,22 +71,37 @@ private:
 	friend PyrSymbol* getsym(const char *name);
 	friend PyrSymbol* findsym(const char *name);
 
+	static const int kNumShards = 16;
+	static const int kShardMask = kNumShards - 1;
+
+	// probe array of one shard. the mask travels with the slots so that a
+	// single acquire load of the table pointer yields a consistent pair.
+	struct ShardTable
+	{
+		int mMask;
+		std::atomic<PyrSymbol*> mSlots[1];	// allocated with mMask+1 slots
+	};
+
+	struct Shard
+	{
+		std::atomic<ShardTable*> mTable;
+		int mNumItems;
+		SC_Lock mLock;
+		SymbolSpace mSpace;
+	};
+
 	PyrSymbol* Find(const char *inName);
 	PyrSymbol* Make(const char *inName);
-	PyrSymbol* MakeNew(const char *inName, int inHash, int inLength);
 
 	int StrHash(const char *inName, size_t *outLength);
-	void AllocTable();
-	void Grow();
-	PyrSymbol* Find(const char *inName, int inHash);
-	void Add(PyrSymbol* inSymbol);
-	void Rehash(PyrSymbol** inTable, int inSize);
-	void MakeEmpty();
+	Shard& ShardFor(int inHash) { return mShards[(inHash >> 16) & kShardMask]; }
+	ShardTable* AllocShardTable(int inSize);
+	static PyrSymbol* FindIn(ShardTable *inTable, const char *inName, int inHash);
+	void Insert(Shard& ioShard, PyrSymbol *inSymbol);
+	void Grow(Shard& ioShard);
 
 	AllocPool *mPool;
-	SymbolSpace mSpace;
-	PyrSymbol **mTable;
-	int mNumItems, mMaxItems, mMask;
+	Shard mShards[kNumShards];
 };
 
 #endif
@@ -28,9 +28,11 @@
 #include <assert.h>
 #include <ctype.h>
 #include <string.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <sys/stat.h>
 #ifdef _WIN32
 # include "SC_Win32Utils.h"
 #else
@@ -240,6 +242,139 @@ bool SC_LanguageConfig::writeLibraryConfigYAML(const char* fileName)
 	return true;
 }
 
+// A parsed config reduces to plain path lists, so we keep a small binary
+// sidecar next to the config file ("<config>.cache") holding the resolved
+// standardized paths and the postInlineWarnings flag. It is validated against
+// the config file's mtime and size in a single stat at startup, which skips
+// the YAML parse and the per-path canonicalization on every launch. The cache
+// is machine local and stored in host byte order.
+
+static const int32_t kConfigCacheMagic = (('S'<<24)|('C'<<16)|('l'<<8)|'c'); /*'SClc'*/
+static const int32_t kConfigCacheVersion = 1;
+
+static bool configCacheStat(const char* fileName, int64_t& outMTime, int64_t& outSize)
+{
+	struct stat buf;
+	if (stat(fileName, &buf) != 0) return false;
+	outMTime = (int64_t)buf.st_mtime;
+	outSize = (int64_t)buf.st_size;
+	return true;
+}
+
+static bool readCacheInt32(FILE* file, int32_t& out)
+{
+	return fread(&out, sizeof(out), 1, file) == 1;
+}
+
+static bool readCacheInt64(FILE* file, int64_t& out)
+{
+	return fread(&out, sizeof(out), 1, file) == 1;
+}
+
+static bool readCacheDirVector(FILE* file, SC_LanguageConfig::DirVector& vec)
+{
+	int32_t count;
+	if (!readCacheInt32(file, count) || count < 0 || count > 65536)
+		return false;
+	vec.reserve(count);
+	for (int32_t i = 0; i < count; ++i) {
+		int32_t len;
+		if (!readCacheInt32(file, len) || len < 0 || len > PATH_MAX)
+			return false;
+		string path(len, '\0');
+		if (len > 0 && fread(&path[0], 1, len, file) != (size_t)len)
+			return false;
+		vec.push_back(path);
+	}
+	return true;
+}
+
+static bool writeCacheInt32(FILE* file, int32_t value)
+{
+	return fwrite(&value, sizeof(value), 1, file) == 1;
+}
+
+static bool writeCacheInt64(FILE* file, int64_t value)
+{
+	return fwrite(&value, sizeof(value), 1, file) == 1;
+}
+
+static bool writeCacheDirVector(FILE* file, const SC_LanguageConfig::DirVector& vec)
+{
+	if (!writeCacheInt32(file, (int32_t)vec.size()))
+		return false;
+	for (SC_LanguageConfig::DirVector::const_iterator it = vec.begin(); it != vec.end(); ++it) {
+		if (!writeCacheInt32(file, (int32_t)it->size()))
+			return false;
+		if (!it->empty() && fwrite(it->data(), 1, it->size(), file) != it->size())
+			return false;
+	}
+	return true;
+}
+
+bool SC_LanguageConfig::readLibraryConfigCache(const char* fileName, bool standalone)
+{
+	int64_t mtime, size;
+	if (!configCacheStat(fileName, mtime, size))
+		return false;
+
+	string cachePath = string(fileName) + ".cache";
+	FILE* file = fopen(cachePath.c_str(), "rb");
+	if (!file)
+		return false;
+
+	int32_t magic, version, inlineWarnings;
+	int64_t cachedMTime, cachedSize;
+	DirVector included, excluded;
+	bool valid = readCacheInt32(file, magic) && magic == kConfigCacheMagic
+		&& readCacheInt32(file, version) && version == kConfigCacheVersion
+		&& readCacheInt64(file, cachedMTime) && cachedMTime == mtime
+		&& readCacheInt64(file, cachedSize) && cachedSize == size
+		&& readCacheInt32(file, inlineWarnings)
+		&& readCacheDirVector(file, included)
+		&& readCacheDirVector(file, excluded);
+	fclose(file);
+	if (!valid)
+		return false;
+
+	freeLibraryConfig();
+	// the default class library directories depend on the environment and are
+	// cheap to compute, so they are always rebuilt rather than cached.
+	gLanguageConfig = new SC_LanguageConfig(standalone);
+	// cached paths were standardized before the cache was written, so they
+	// can bypass findPath.
+	gLanguageConfig->mIncludedDirectories.swap(included);
+	gLanguageConfig->mExcludedDirectories.swap(excluded);
+	gPostInlineWarnings = inlineWarnings != 0;
+	return true;
+}
+
+void SC_LanguageConfig::writeLibraryConfigCache(const char* fileName)
+{
+	if (!gLanguageConfig)
+		return;
+
+	int64_t mtime, size;
+	if (!configCacheStat(fileName, mtime, size))
+		return;
+
+	string cachePath = string(fileName) + ".cache";
+	FILE* file = fopen(cachePath.c_str(), "wb");
+	if (!file)
+		return; // read-only config dirs (e.g. /etc) are fine; just don't cache
+
+	bool ok = writeCacheInt32(file, kConfigCacheMagic)
+		&& writeCacheInt32(file, kConfigCacheVersion)
+		&& writeCacheInt64(file, mtime)
+		&& writeCacheInt64(file, size)
+		&& writeCacheInt32(file, gPostInlineWarnings ? 1 : 0)
+		&& writeCacheDirVector(file, gLanguageConfig->mIncludedDirectories)
+		&& writeCacheDirVector(file, gLanguageConfig->mExcludedDirectories);
+	fclose(file);
+	if (!ok)
+		remove(cachePath.c_str());
+}
+
 bool SC_LanguageConfig::defaultLibraryConfig(bool standalone)
 {
 	freeLibraryConfig();
@@ -266,9 +401,13 @@ bool SC_LanguageConfig::readLibraryConfig(bool standalone)
 	bool configured = false;
 
 	if (!gConfigFile.empty() && file_exists(gConfigFile)) {
+		if (readLibraryConfigCache(gConfigFile.c_str(), standalone))
+			return true;
 		configured = readLibraryConfigYAML(gConfigFile.c_str(), standalone);
-		if (configured)
+		if (configured) {
+			writeLibraryConfigCache(gConfigFile.c_str());
 			return true;
+		}
 	}
 
 	if( !standalone ) {
@@ -276,13 +415,25 @@ bool SC_LanguageConfig::readLibraryConfig(bool standalone)
 		sc_GetUserConfigDirectory(config_dir, PATH_MAX);
 
 		std::string user_yaml_config_file = std::string(config_dir) + SC_PATH_DELIMITER + "sclang_conf.yaml";
-		if (file_exists(user_yaml_config_file))
-			configured = readLibraryConfigYAML(user_yaml_config_file.c_str(), standalone);
+		if (file_exists(user_yaml_config_file)) {
+			configured = readLibraryConfigCache(user_yaml_config_file.c_str(), standalone);
+			if (!configured) {
+				configured = readLibraryConfigYAML(user_yaml_config_file.c_str(), standalone);
+				if (configured)
+					writeLibraryConfigCache(user_yaml_config_file.c_str());
+			}
+		}
 
 		if (!configured) {
 			char global_yaml_config_file[] = "/etc/sclang_conf.yaml";
-			if (file_exists(global_yaml_config_file))
-				configured = readLibraryConfigYAML(global_yaml_config_file, standalone);
+			if (file_exists(global_yaml_config_file)) {
+				configured = readLibraryConfigCache(global_yaml_config_file, standalone);
+				if (!configured) {
+					configured = readLibraryConfigYAML(global_yaml_config_file, standalone);
+					if (configured)
+						writeLibraryConfigCache(global_yaml_config_file);
+				}
+			}
 		}
 
 		if (configured)
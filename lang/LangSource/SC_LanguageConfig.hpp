@@ -54,6 +54,13 @@ public:
 
 	static bool readLibraryConfigYAML(const char* fileName, bool standalone);
 	static bool writeLibraryConfigYAML(const char* fileName);
+
+	// binary cache of a parsed config file, storing the resolved absolute
+	// paths so startup skips the YAML parse and path canonicalization.
+	// readLibraryConfigCache validates the cache against the config file's
+	// mtime and size in a single stat and returns false when it is stale.
+	static bool readLibraryConfigCache(const char* fileName, bool standalone);
+	static void writeLibraryConfigCache(const char* fileName);
 	static void freeLibraryConfig();
 	static bool defaultLibraryConfig(   bool standalone);
 	static bool readLibraryConfig(bool standalone);
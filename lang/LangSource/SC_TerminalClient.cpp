@@ -31,6 +31,8 @@
 
 #include <boost/bind.hpp>
 
+#include <cmath>
+
 #ifdef _WIN32
 # define __GNU_LIBRARY__
 # include "getopt.h"
@@ -62,42 +64,149 @@
 
 static FILE* gPostDest = stdout;
 
+// AppClock wakeups are aligned to this grid (one display frame at 60 Hz),
+// which batches all tasks due within the same frame into a single tick.
+const double SC_TerminalClient::kSchedFramePeriod = 1. / 60.;
+
 SC_TerminalClient::SC_TerminalClient(const char* name)
 	: SC_LanguageClient(name),
+	  mSchedNotifyPending(false),
 	  mReturnCode(0),
 	  mUseReadline(false),
       mWork(mIoService),
 	  mTimer(mIoService),
 #ifndef _WIN32
-	  mStdIn(mInputService, STDIN_FILENO)
+	  mStdIn(mInputService, STDIN_FILENO),
 #else
-	  mStdIn(mInputService, GetStdHandle(STD_INPUT_HANDLE))
+	  mStdIn(mInputService, GetStdHandle(STD_INPUT_HANDLE)),
 #endif
-{}
+	  mPostBuffer(new char[kPostBufferSize]),
+	  mPostHead(0),
+	  mPostTail(0),
+	  mPostDropped(0),
+	  mPostFlushRequest(false),
+	  mPostQuit(false)
+{
+	mPostThread = SC_Thread(&SC_TerminalClient::postWorker, this);
+}
 
 SC_TerminalClient::~SC_TerminalClient()
-{}
+{
+	mPostQuit.store(true, std::memory_order_release);
+	if (mPostThread.joinable())
+		mPostThread.join(); // drains the ring before returning
+	delete[] mPostBuffer;
+}
+
+// copy one message into the ring. never blocks on the console: a message
+// that does not fit is dropped and counted, except oversized ones (e.g. a
+// dumped object), which are pushed in chunks with a bounded wait so they
+// are not silently lost on an otherwise healthy console.
+void SC_TerminalClient::pushPost(const char* str, size_t len, bool flushNow)
+{
+	const size_t mask = kPostBufferSize - 1;
+
+	size_t head = mPostHead.load(std::memory_order_relaxed);
+	size_t tail = mPostTail.load(std::memory_order_acquire);
+
+	if (len > kPostBufferSize - (head - tail)) {
+		if (len <= kPostBufferSize / 2) {
+			mPostDropped.fetch_add(1, std::memory_order_relaxed);
+			if (flushNow) mPostFlushRequest.store(true, std::memory_order_relaxed);
+			return;
+		}
+		int patience = 2000; // ~2s; then the remainder is dropped
+		while (len) {
+			head = mPostHead.load(std::memory_order_relaxed);
+			tail = mPostTail.load(std::memory_order_acquire);
+			size_t free = kPostBufferSize - (head - tail);
+			size_t chunk = sc_min(len, free);
+			if (chunk == 0) {
+				if (--patience == 0) {
+					mPostDropped.fetch_add(1, std::memory_order_relaxed);
+					break;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				continue;
+			}
+			size_t pos = head & mask;
+			size_t first = sc_min(chunk, kPostBufferSize - pos);
+			memcpy(mPostBuffer + pos, str, first);
+			memcpy(mPostBuffer, str + first, chunk - first);
+			mPostHead.store(head + chunk, std::memory_order_release);
+			str += chunk;
+			len -= chunk;
+		}
+		if (flushNow) mPostFlushRequest.store(true, std::memory_order_relaxed);
+		return;
+	}
+
+	size_t pos = head & mask;
+	size_t first = sc_min(len, kPostBufferSize - pos);
+	memcpy(mPostBuffer + pos, str, first);
+	memcpy(mPostBuffer, str + first, len - first);
+	mPostHead.store(head + len, std::memory_order_release);
+	if (flushNow) mPostFlushRequest.store(true, std::memory_order_relaxed);
+}
+
+// console writer thread: drains the ring in contiguous spans and batches
+// fflush to the points where the ring runs empty or a flush was requested.
+void SC_TerminalClient::postWorker()
+{
+	const size_t mask = kPostBufferSize - 1;
+
+	for (;;) {
+		size_t tail = mPostTail.load(std::memory_order_relaxed);
+		size_t head = mPostHead.load(std::memory_order_acquire);
+
+		if (head == tail) {
+			if (mPostFlushRequest.exchange(false, std::memory_order_relaxed))
+				fflush(gPostDest);
+			int dropped = mPostDropped.exchange(0, std::memory_order_relaxed);
+			if (dropped) {
+				fprintf(gPostDest, "*** post: dropped %d messages (console overflow)\n", dropped);
+				fflush(gPostDest);
+			}
+			if (mPostQuit.load(std::memory_order_acquire))
+				break;
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			continue;
+		}
+
+		size_t pos = tail & mask;
+		size_t contiguous = sc_min(head - tail, kPostBufferSize - pos);
+		fwrite(mPostBuffer + pos, sizeof(char), contiguous, gPostDest);
+		mPostTail.store(tail + contiguous, std::memory_order_release);
+	}
+	fflush(gPostDest);
+}
 
 void SC_TerminalClient::postText(const char* str, size_t len)
 {
-	fwrite(str, sizeof(char), len, gPostDest);
+	pushPost(str, len, false);
 }
 
 void SC_TerminalClient::postFlush(const char* str, size_t len)
 {
-	fwrite(str, sizeof(char), len, gPostDest);
-	fflush(gPostDest);
+	pushPost(str, len, true);
 }
 
 void SC_TerminalClient::postError(const char* str, size_t len)
 {
-	fprintf(gPostDest, "ERROR: ");
-	fwrite(str, sizeof(char), len, gPostDest);
+	pushPost("ERROR: ", 7, false);
+	pushPost(str, len, true);
 }
 
 void SC_TerminalClient::flush()
 {
-	fflush(gPostDest);
+	mPostFlushRequest.store(true, std::memory_order_relaxed);
+	// bounded wait so interactive output lands before the next prompt,
+	// without letting a flooded console stall the interpreter for long
+	for (int i = 0; i < 100; ++i) {
+		if (mPostHead.load(std::memory_order_relaxed) == mPostTail.load(std::memory_order_relaxed))
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
 }
 
 void SC_TerminalClient::printUsage()
@@ -403,14 +512,19 @@ void SC_TerminalClient::tick( const boost::system::error_code& error )
 	double secs;
 	lock();
 	bool haveNext = tickLocked( &secs );
+	mSchedNotifyPending = false;
 	unlock();
 
 	flush();
 
-	std::chrono::system_clock::time_point nextAbsTime;
-	ElapsedTimeToChrono( secs, nextAbsTime );
-
 	if (haveNext) {
+		// wake on the frame grid rather than per deadline, so all tasks
+		// due within the same frame run in one interpreter entry.
+		secs = std::ceil(secs / kSchedFramePeriod) * kSchedFramePeriod;
+
+		std::chrono::system_clock::time_point nextAbsTime;
+		ElapsedTimeToChrono( secs, nextAbsTime );
+
 		mTimer.expires_at(nextAbsTime);
 		mTimer.async_wait(boost::bind(&SC_TerminalClient::tick, this, _1));
 	}
@@ -684,7 +798,13 @@ int SC_TerminalClient::prExit(struct VMGlobals* g, int)
 
 int SC_TerminalClient::prScheduleChanged( struct VMGlobals *g, int numArgsPushed)
 {
-	static_cast<SC_TerminalClient*>(instance())->sendSignal(sig_sched);
+	SC_TerminalClient *client = static_cast<SC_TerminalClient*>(instance());
+	// called with the language lock held; fold any number of schedule
+	// notifications between two ticks into a single main-thread wakeup.
+	if (!client->mSchedNotifyPending) {
+		client->mSchedNotifyPending = true;
+		client->sendSignal(sig_sched);
+	}
 	return errNone;
 }
 
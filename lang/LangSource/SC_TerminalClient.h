@@ -35,6 +35,8 @@
 #include <boost/asio.hpp>
 #include <boost/sync/semaphore.hpp>
 
+#include <atomic>
+
 // =====================================================================
 // SC_TerminalClient - command line sclang client.
 // =====================================================================
@@ -138,6 +140,15 @@ protected:
 
 	void tick(const boost::system::error_code& error);
 
+	// AppClock driver state. Both members are only accessed with the
+	// language lock held: prScheduleChanged runs from the interpreter,
+	// and tick() clears the flag before releasing the lock. Scheduling
+	// any number of tasks between two ticks therefore posts a single
+	// wakeup to the main thread, and tick() wakes on a frame grid so
+	// everything due within the same frame runs in one interpreter entry.
+	bool mSchedNotifyPending;
+	static const double kSchedFramePeriod;
+
 private:
 	// NOTE: called from input thread:
 #ifdef HAVE_READLINE
@@ -184,6 +195,23 @@ private:
 	// command input
 	bool mUseReadline;
 	boost::sync::semaphore mReadlineSem;
+
+	// post output ring. posts are copied into a bounded ring and written to
+	// the console by a worker thread, so a blocked or flooded console can
+	// never stall the interpreter. all entry points serialize on the
+	// instance lock, so there is a single producer; when the ring is full,
+	// whole messages are dropped and counted, and the worker reports the
+	// count once the console catches up.
+	enum { kPostBufferSize = 1 << 18 }; // bytes, power of two
+	char *mPostBuffer;
+	std::atomic<size_t> mPostHead;	// monotonic write position (producer)
+	std::atomic<size_t> mPostTail;	// monotonic read position (worker)
+	std::atomic<int> mPostDropped;
+	std::atomic<bool> mPostFlushRequest;
+	std::atomic<bool> mPostQuit;
+	SC_Thread mPostThread;
+	void pushPost(const char *str, size_t len, bool flushNow);
+	void postWorker();
 };
 
 #endif // SC_TERMINALCLIENT_H_INCLUDED
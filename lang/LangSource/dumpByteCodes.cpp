@@ -206,6 +206,16 @@ unsigned char* dumpOneByteCode(PyrBlock *theBlock, PyrClass* theClass, unsigned
 					post(" %02X    opgFunctionDef\n", op1, op2); break;
 				case opgFunction : // push thisClosure
 					post(" %02X    opgFunction\n", op1, op2); break;
+				case opgFusedPushTempZeroVarBinaryOp :
+					op3 = *ip++; // (temp var index << 4) | binary operator
+					post(" %02X %02X PushTempZeroVar %d; '%s'\n", op2, op3, op3 >> 4,
+						gSpecialBinarySelectors[op3 & 15]->name);
+					break;
+				case opgFusedPushConstantBinaryOp :
+					op3 = *ip++; // (constant index << 4) | binary operator
+					post(" %02X %02X PushConstant %d; '%s'\n", op2, op3, op3 >> 4,
+						gSpecialBinarySelectors[op3 & 15]->name);
+					break;
 			}
 			break;
 
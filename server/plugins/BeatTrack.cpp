@@ -55,7 +55,7 @@ static float g_mg[257]= {0.00000000,0.00000000,0.00000000,0.00000000,0.00000000,
 
 //other functions
 static void BeatTrack_dofft(BeatTrack *unit, uint32);
-static void complexdf(BeatTrack *unit);
+static void complexdf(BeatTrack *unit, const float *mags);
 static void finaldecision(BeatTrack *unit);
 
 //amortisation
@@ -412,13 +412,18 @@ void BeatTrack_dofft(BeatTrack *unit, uint32 ibufnum)
 
 	unit->m_FFTBuf = buf->data; //just assign it!
 
+	// bin magnitudes are shared between all listeners on this chain
+	const float * binmags = ML_GetBinMags((Unit*)unit, buf, ibufnum);
+	if (binmags && ((buf->samples - 2) >> 1) < NOVER2 - 1)
+		binmags = 0; // frame smaller than the fixed analysis range
+
 	//transfer data to fftbuf in the format expected by this plugin
 
 	//ideally, should do this part separate to plug-in as well, so can compare different detection functions;
 	//also, can run multiple in parallel with own autocorrelations; committee? Committee.ar(period1, phase1, period2, phase2, period3, phase3)...
 	//chooses predominant estimate?
 	//feature detection function
-	complexdf(unit);
+	complexdf(unit, binmags);
 
 	if (unit->m_frame%SKIP==0) {
 
@@ -792,7 +797,7 @@ void finaldecision(BeatTrack *unit)
 //Now the format is standardised for the SC FFT UGen as
 //dc, nyquist and then real/imag pairs for each bin going up successively in frequency
 
-void complexdf(BeatTrack *unit)
+void complexdf(BeatTrack *unit, const float *mags)
 {
 	float * fftbuf= unit->m_FFTBuf;
 
@@ -814,7 +819,7 @@ void complexdf(BeatTrack *unit)
 			//N=1024 conventionally here
 			float imag=fftbuf[index+1]; //fftbuf[N-index];
 
-			float mag= sqrt(real*real+ imag*imag); // was  0.5*sqrt(real*real+ imag*imag); reduce by factor of 2 because of altivec side effect
+			float mag= mags ? mags[k] : sqrt(real*real+ imag*imag); // was  0.5*sqrt(...); reduce by factor of 2 because of altivec side effect
 			float qmag= prevmag[k];
 
 			prevmag[k]=mag;
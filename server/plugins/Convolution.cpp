@@ -844,20 +844,18 @@ void StereoConvolution2L_next(StereoConvolution2L *unit, int wrongNumSamples)
 			LOCK_SNDBUF2_SHARED(bufL, bufR);
 			memcpy(unit->m_fftbuf2[0], bufL->data, framesize_f);
 			memset(unit->m_fftbuf2[0]+unit->m_framesize, 0, framesize_f);
-			scfft_dofft(unit->m_scfft2[0]);
 			memcpy(unit->m_fftbuf2[1], bufR->data, framesize_f);
 			memset(unit->m_fftbuf2[1]+unit->m_framesize, 0, framesize_f);
-			scfft_dofft(unit->m_scfft2[1]);
+			scfft_dofft_batch(unit->m_scfft2, 2);
 		}
 		else if ( unit->m_curbuf == 0 )
 		{
 			LOCK_SNDBUF2_SHARED(bufL, bufR);
 			memcpy(unit->m_fftbuf3[0], bufL->data, framesize_f);
 			memset(unit->m_fftbuf3[0]+unit->m_framesize, 0, framesize_f);
-			scfft_dofft(unit->m_scfft3[0]);
 			memcpy(unit->m_fftbuf3[1], bufR->data, framesize_f);
 			memset(unit->m_fftbuf3[1]+unit->m_framesize, 0, framesize_f);
-			scfft_dofft(unit->m_scfft3[1]);
+			scfft_dofft_batch(unit->m_scfft3, 2);
 		}
 	}
 
@@ -909,10 +907,9 @@ void StereoConvolution2L_next(StereoConvolution2L *unit, int wrongNumSamples)
 			memcpy(unit->m_overlapbuf[i], unit->m_outbuf[i]+unit->m_framesize, unit->m_framesize * sizeof(float));
 			//inverse fft into outbuf
 			memcpy(unit->m_outbuf[i], unit->m_tempbuf[i], unit->m_fftsize * sizeof(float));
-			//in place
-			scfft_doifft(unit->m_scfftR[i]);
-
 		}
+		//in place
+		scfft_doifft_batch(unit->m_scfftR, 2);
 
 
 		if ( unit->m_cfpos < unit->m_cflength )	// do crossfade
@@ -942,8 +939,7 @@ void StereoConvolution2L_next(StereoConvolution2L *unit, int wrongNumSamples)
 				p3R[imagind] = imagR;
 			}
 
-			scfft_doifft(unit->m_scfftR2[0]);
-			scfft_doifft(unit->m_scfftR2[1]);
+			scfft_doifft_batch(unit->m_scfftR2, 2);
 
 			// now crossfade between outbuf and tempbuf
 			float fact1 = (float) unit->m_cfpos/unit->m_cflength;  // crossfade amount startpoint
@@ -690,7 +690,7 @@ static void LocalBuf_allocBuffer(LocalBuf *unit, SndBuf *buf, int numChannels, i
 
 	if (!unit->chunk) {
 		if(unit->mWorld->mVerbosity > -2){
-			Print("failed to allocate memory for LocalBuffer\n");
+			RTPrint(unit->mWorld, "failed to allocate memory for LocalBuffer\n");
 		}
 		return;
 	}
@@ -771,7 +771,7 @@ void SetBuf_Ctor(SetBuf *unit)
 	CTOR_GET_BUF
 	if (!buf || !buf->data) {
 		if(unit->mWorld->mVerbosity > -2){
-			Print("SetBuf: no valid buffer\n");
+			RTPrint(unit->mWorld, "SetBuf: no valid buffer\n");
 		}
 		return;
 	}
@@ -796,7 +796,7 @@ void ClearBuf_Ctor(ClearBuf *unit)
 
 	if (!buf || !buf->data) {
 		if(unit->mWorld->mVerbosity > -2){
-			Print("ClearBuf: no valid buffer\n");
+			RTPrint(unit->mWorld, "ClearBuf: no valid buffer\n");
 		}
 		return;
 	}
@@ -844,7 +844,7 @@ static inline bool checkBuffer(Unit * unit, const float * bufData, uint32 bufCha
 
 	if (expectedChannels > bufChannels) {
 		if(unit->mWorld->mVerbosity > -1 && !unit->mDone)
-			Print("Buffer UGen channel mismatch: expected %i, yet buffer has %i channels\n",
+			RTPrint(unit->mWorld, "Buffer UGen channel mismatch: expected %i, yet buffer has %i channels\n",
 				  expectedChannels, bufChannels);
 		goto handle_failure;
 	}
@@ -1022,6 +1022,24 @@ handle_failure:
 
 
 
+// Fast kernel for the common in-bounds case: the caller guarantees that
+// 1 <= iphase < guardFrame and numOutputs == bufChannels, so the wrap and
+// guard-frame logic of LOOP_BODY_4 drops out entirely and the four taps are
+// contiguous frames. The remaining loop is branch-free and the compiler can
+// vectorize the weight computation across channels.
+#define LOOP_BODY_4_INBOUNDS(SAMPLE_INDEX) \
+		int32 iphase = (int32)phase; \
+		const float* table1 = bufData + iphase * bufChannels; \
+		const float* table0 = table1 - bufChannels; \
+		const float* table2 = table1 + bufChannels; \
+		const float* table3 = table2 + bufChannels; \
+		float fracphase = phase - (double)iphase; \
+		for (uint32 channel=0; channel<(uint32)numOutputs; ++channel) { \
+			OUT(channel)[SAMPLE_INDEX] = cubicinterp(fracphase, \
+				table0[channel], table1[channel], table2[channel], table3[channel]); \
+		} \
+
+
 #define CHECK_BUFFER_DATA \
 if (!bufData) { \
 	if(unit->mWorld->mVerbosity > -1 && !unit->mDone && (unit->m_failedBufNum != fbufnum)) { \
@@ -1069,8 +1087,6 @@ void PlayBuf_Ctor(PlayBuf *unit)
 
 void PlayBuf_next_aa(PlayBuf *unit, int inNumSamples)
 {
-	float *ratein  = ZIN(1);
-	float *trigin  = ZIN(2);
 	int32 loop     = (int32)ZIN0(4);
 
 	float fbufnum  = ZIN0(0);
@@ -1098,17 +1114,56 @@ void PlayBuf_next_aa(PlayBuf *unit, int inNumSamples)
 	double phase = unit->m_phase;
 	float prevtrig = unit->m_prevtrig;
 
-	for (int i=0; i<inNumSamples; ++i) {
-		float trig = ZXP(trigin);
-		if (trig > 0.f && prevtrig <= 0.f) {
-			unit->mDone = false;
-			phase = ZIN0(3);
+	const float *rateArr = IN(1);
+	const float *trigArr = IN(2);
+
+	// One pass over the block's rates bounds how far the phase can travel per
+	// sample, so whole chunks of the block can run the in-bounds kernel with
+	// the wrap and guard logic hoisted out. The scan itself vectorizes.
+	float maxAbsRate = 0.f;
+	for (int j=0; j<inNumSamples; ++j) {
+		float r = std::abs(rateArr[j]);
+		if (r > maxAbsRate) maxAbsRate = r;
+	}
+
+	double guardPhase = (double)guardFrame;
+	int i = 0;
+	while (i < inNumSamples) {
+		int chunk = 0;
+		if (numOutputs == (int)bufChannels && phase >= 1. && phase < guardPhase) {
+			double headroom = sc_min(guardPhase - phase, phase - 1.);
+			if (maxAbsRate > 0.f)
+				chunk = (int)(headroom / maxAbsRate);
+			else
+				chunk = inNumSamples - i;
+			chunk = sc_min(chunk, inNumSamples - i);
+		}
+		if (chunk > 0) {
+			for (int j=0; j<chunk; ++j) {
+				float trig = trigArr[i];
+				if (trig > 0.f && prevtrig <= 0.f) {
+					unit->mDone = false;
+					phase = ZIN0(3);
+					prevtrig = trig;
+					break; // phase jumped: re-chunk from here
+				}
+				prevtrig = trig;
+				LOOP_BODY_4_INBOUNDS(i)
+				phase += rateArr[i];
+				++i;
+			}
+		} else {
+			// scalar edge path: boundary crossings, wrap and channel fanout
+			float trig = trigArr[i];
+			if (trig > 0.f && prevtrig <= 0.f) {
+				unit->mDone = false;
+				phase = ZIN0(3);
+			}
+			prevtrig = trig;
+			LOOP_BODY_4(i)
+			phase += rateArr[i];
+			++i;
 		}
-		prevtrig = trig;
-
-		LOOP_BODY_4(i)
-
-		phase += ZXP(ratein);
 	}
 	RELEASE_SNDBUF_SHARED(buf);
 
@@ -1183,10 +1238,34 @@ void PlayBuf_next_kk(PlayBuf *unit, int inNumSamples)
 		phase = ZIN0(3);
 	}
 	unit->m_prevtrig = trig;
-	for (int i=0; i<inNumSamples; ++i) {
-		LOOP_BODY_4(i)
 
-		phase += rate;
+	// constant rate: the distance to the nearest loop boundary tells how many
+	// samples can run the in-bounds kernel before any wrap or guard handling
+	double guardPhase = (double)guardFrame;
+	double absRate = std::abs((double)rate);
+	int i = 0;
+	while (i < inNumSamples) {
+		int chunk = 0;
+		if (numOutputs == (int)bufChannels && phase >= 1. && phase < guardPhase) {
+			double headroom = rate >= 0.f ? guardPhase - phase : phase - 1.;
+			if (absRate > 0.)
+				chunk = (int)(headroom / absRate);
+			else
+				chunk = inNumSamples - i;
+			chunk = sc_min(chunk, inNumSamples - i);
+		}
+		if (chunk > 0) {
+			for (int j=0; j<chunk; ++j) {
+				LOOP_BODY_4_INBOUNDS(i)
+				phase += rate;
+				++i;
+			}
+		} else {
+			// scalar edge path: boundary crossings, wrap and channel fanout
+			LOOP_BODY_4(i)
+			phase += rate;
+			++i;
+		}
 	}
 	if(unit->mDone)
 		DoneAction((int)ZIN0(5), unit);
@@ -1256,9 +1335,17 @@ void BufRd_next_4(BufRd *unit, int inNumSamples)
 
 	double loopMax = (double)(loop ? bufFrames : bufFrames - 1);
 
+	// phase arrives per sample, so chunking doesn't apply; but one predictable
+	// in-bounds test replaces the wrap and guard logic for the common case
+	double guardPhase = (double)guardFrame;
+	bool chanMatch = (numOutputs == bufChannels);
 	for (int i=0; i<inNumSamples; ++i) {
 		double phase = ZXP(phasein);
-		LOOP_BODY_4(i)
+		if (chanMatch && phase >= 1. && phase < guardPhase) {
+			LOOP_BODY_4_INBOUNDS(i)
+		} else {
+			LOOP_BODY_4(i)
+		}
 	}
 }
 
@@ -2292,6 +2379,31 @@ static void BufFeedbackDelay_Reset(Unit *unit)
 
 namespace {
 
+/* catmull-rom weights for a fixed fractional phase. cubicinterp() rebuilds its
+ * hermite coefficients from the four taps on every call; when the delay time
+ * input is scalar-rate the fractional phase is constant over the whole block,
+ * so the weights can be computed once and each sample costs four multiply-adds.
+ */
+struct CubicInterpWeights
+{
+	float w0, w1, w2, w3;
+
+	explicit CubicInterpWeights(float frac)
+	{
+		float frac2 = frac * frac;
+		float frac3 = frac2 * frac;
+		w0 = -0.5f * frac3 +       frac2 - 0.5f * frac;
+		w1 =  1.5f * frac3 - 2.5f * frac2 + 1.f;
+		w2 = -1.5f * frac3 + 2.f * frac2 + 0.5f * frac;
+		w3 =  0.5f * frac3 - 0.5f * frac2;
+	}
+
+	inline float interp(float d0, float d1, float d2, float d3) const
+	{
+		return w0 * d0 + w1 * d1 + w2 * d2 + w3 * d3;
+	}
+};
+
 /* helper classes for delay functionality */
 template <bool Checked = false>
 struct DelayN_helper
@@ -2313,6 +2425,15 @@ struct DelayN_helper
 	{
 		perform(in, out, bufData, iwrphase, idsamp, mask);
 	}
+
+	/* the constant-delay loops pass precomputed cubic weights. only the cubic
+	 * helpers use them; everyone else forwards to the generic sample kernel */
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, mask);
+	}
 };
 
 template <>
@@ -2339,6 +2460,13 @@ struct DelayN_helper<true>
 	{
 		perform(in, out, bufData, iwrphase, idsamp, mask);
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, mask);
+	}
 };
 
 template <bool initializing>
@@ -2440,6 +2568,13 @@ struct DelayL_helper
 		ZXP(out) = lininterp(frac, d1, d2);
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, frac, mask);
+	}
 };
 
 template <>
@@ -2466,6 +2601,13 @@ struct DelayL_helper<true>
 		}
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, frac, mask);
+	}
 };
 
 template <bool Checked = false>
@@ -2488,6 +2630,23 @@ struct DelayC_helper
 		ZXP(out) = cubicinterp(frac, d0, d1, d2, d3);
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask)
+	{
+		bufData[iwrphase & mask] = ZXP(in);
+		long irdphase1 = iwrphase - idsamp;
+		long irdphase2 = irdphase1 - 1;
+		long irdphase3 = irdphase1 - 2;
+		long irdphase0 = irdphase1 + 1;
+		float d0 = bufData[irdphase0 & mask];
+		float d1 = bufData[irdphase1 & mask];
+		float d2 = bufData[irdphase2 & mask];
+		float d3 = bufData[irdphase3 & mask];
+		ZXP(out) = weights.interp(d0, d1, d2, d3);
+		iwrphase++;
+	}
 };
 
 template <>
@@ -2530,6 +2689,13 @@ struct DelayC_helper<true>
 		}
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, frac, mask);
+	}
 };
 
 template <bool Checked = false>
@@ -2553,6 +2719,13 @@ struct CombN_helper
 	{
 		perform(in, out, bufData, iwrphase, idsamp, mask, feedbk);
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, mask, feedbk);
+	}
 };
 
 template <>
@@ -2582,6 +2755,13 @@ struct CombN_helper<true>
 	{
 		perform(in, out, bufData, iwrphase, idsamp, mask, feedbk);
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, mask, feedbk);
+	}
 };
 
 template <bool Checked = false>
@@ -2601,6 +2781,13 @@ struct CombL_helper
 		ZXP(out) = value;
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, frac, mask, feedbk);
+	}
 };
 
 template <>
@@ -2632,6 +2819,13 @@ struct CombL_helper<true>
 		}
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, frac, mask, feedbk);
+	}
 };
 
 template <bool Checked = false>
@@ -2655,6 +2849,24 @@ struct CombC_helper
 		ZXP(out) = value;
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		long irdphase1 = iwrphase - idsamp;
+		long irdphase2 = irdphase1 - 1;
+		long irdphase3 = irdphase1 - 2;
+		long irdphase0 = irdphase1 + 1;
+		float d0 = bufData[irdphase0 & mask];
+		float d1 = bufData[irdphase1 & mask];
+		float d2 = bufData[irdphase2 & mask];
+		float d3 = bufData[irdphase3 & mask];
+		float value = weights.interp(d0, d1, d2, d3);
+		bufData[iwrphase & mask] = ZXP(in) + feedbk * value;
+		ZXP(out) = value;
+		iwrphase++;
+	}
 };
 
 template <>
@@ -2699,6 +2911,13 @@ struct CombC_helper<true>
 		}
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, frac, mask, feedbk);
+	}
 };
 
 template <bool Checked = false>
@@ -2723,6 +2942,13 @@ struct AllpassN_helper
 	{
 		perform(in, out, bufData, iwrphase, idsamp, mask, feedbk);
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, mask, feedbk);
+	}
 };
 
 template <>
@@ -2753,6 +2979,13 @@ struct AllpassN_helper<true>
 	{
 		perform(in, out, bufData, iwrphase, idsamp, mask, feedbk);
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, mask, feedbk);
+	}
 };
 
 template <bool Checked = false>
@@ -2773,6 +3006,13 @@ struct AllpassL_helper
 		ZXP(out) = value - feedbk * dwr;
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, frac, mask, feedbk);
+	}
 };
 
 template <>
@@ -2806,6 +3046,13 @@ struct AllpassL_helper<true>
 		}
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, frac, mask, feedbk);
+	}
 };
 
 template <bool Checked = false>
@@ -2830,6 +3077,25 @@ struct AllpassC_helper
 		ZXP(out) = value - feedbk * dwr;
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		long irdphase1 = iwrphase - idsamp;
+		long irdphase2 = irdphase1 - 1;
+		long irdphase3 = irdphase1 - 2;
+		long irdphase0 = irdphase1 + 1;
+		float d0 = bufData[irdphase0 & mask];
+		float d1 = bufData[irdphase1 & mask];
+		float d2 = bufData[irdphase2 & mask];
+		float d3 = bufData[irdphase3 & mask];
+		float value = weights.interp(d0, d1, d2, d3);
+		float dwr = ZXP(in) + feedbk * value;
+		bufData[iwrphase & mask] = dwr;
+		ZXP(out) = value - feedbk * dwr;
+		iwrphase++;
+	}
 };
 
 template <>
@@ -2875,6 +3141,13 @@ struct AllpassC_helper<true>
 		}
 		iwrphase++;
 	}
+
+	static inline void perform_const(const float *& in, float *& out, float * bufData,
+							   long & iwrphase, long idsamp, float frac,
+							   const CubicInterpWeights & weights, long mask, float feedbk)
+	{
+		perform(in, out, bufData, iwrphase, idsamp, frac, mask, feedbk);
+	}
 };
 
 }
@@ -2899,8 +3172,9 @@ inline void BufDelayX_perform(BufDelayX *unit, int inNumSamples, UnitCalcFunc re
 	if (delaytime == unit->m_delaytime) {
 		long idsamp = (long)dsamp;
 		float frac = dsamp - idsamp;
+		const CubicInterpWeights weights(frac);
 		LOOP1(inNumSamples,
-			PerformClass::perform(in, out, bufData, iwrphase, idsamp, frac, mask);
+			PerformClass::perform_const(in, out, bufData, iwrphase, idsamp, frac, weights, mask);
 		);
 	} else {
 		float next_dsamp = BufCalcDelay(unit, bufSamples, delaytime);
@@ -3161,8 +3435,9 @@ inline void BufFilterX_perform(BufCombX *unit, int inNumSamples, UnitCalcFunc re
 	if (delaytime == unit->m_delaytime && decaytime == unit->m_decaytime) {
 		long idsamp = (long)dsamp;
 		float frac = dsamp - idsamp;
+		const CubicInterpWeights weights(frac);
 		LOOP1(inNumSamples,
-			PerformClass::perform(in, out, bufData, iwrphase, idsamp, frac, mask, feedbk);
+			PerformClass::perform_const(in, out, bufData, iwrphase, idsamp, frac, weights, mask, feedbk);
 		);
 	} else {
 		float next_dsamp = BufCalcDelay(unit, bufSamples, delaytime);
@@ -3940,8 +4215,9 @@ inline void DelayX_perform(DelayX *unit, int inNumSamples, UnitCalcFunc resetFun
 	if (delaytime == unit->m_delaytime) {
 		long idsamp = (long)dsamp;
 		float frac = dsamp - idsamp;
+		const CubicInterpWeights weights(frac);
 		LOOP1(inNumSamples,
-			PerformClass::perform(in, out, dlybuf, iwrphase, idsamp, frac, mask);
+			PerformClass::perform_const(in, out, dlybuf, iwrphase, idsamp, frac, weights, mask);
 		);
 	} else {
 		float next_dsamp = CalcDelay(unit, delaytime);
@@ -4264,8 +4540,9 @@ inline void FilterX_perform(BufCombX *unit, int inNumSamples, UnitCalcFunc reset
 	if (delaytime == unit->m_delaytime && decaytime == unit->m_decaytime) {
 		long idsamp = (long)dsamp;
 		float frac = dsamp - idsamp;
+		const CubicInterpWeights weights(frac);
 		LOOP1(inNumSamples,
-			PerformClass::perform(in, out, dlybuf, iwrphase, idsamp, frac, mask, feedbk);
+			PerformClass::perform_const(in, out, dlybuf, iwrphase, idsamp, frac, weights, mask, feedbk);
 		);
 	} else {
 		float next_dsamp = CalcDelay(unit, delaytime);
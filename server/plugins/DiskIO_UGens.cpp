@@ -33,6 +33,18 @@
 #include <boost/lockfree/queue.hpp>
 #include <boost/lockfree/spsc_queue.hpp>
 
+#include "SC_Endian.h"
+
+#if !defined(_WIN32) && (BYTE_ORDER == LITTLE_ENDIAN)
+	#define SC_DISKIO_MMAP
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <map>
+	#include <string>
+#endif
+
 static InterfaceTable *ft;
 
 enum {
@@ -115,6 +127,188 @@ struct DiskIOMsg
 	void Perform();
 };
 
+#ifdef SC_DISKIO_MMAP
+
+// Memory-mapped fast path for uncompressed wav files. sf_readf_float decodes
+// through libsndfile's internal staging buffer for every chunk; for plain pcm
+// data we can map the file once and convert straight from the mapping into the
+// SndBuf, with madvise() driving kernel readahead. The copy into the SndBuf
+// itself stays: the mapping is only ever touched on the disk io thread, so a
+// page fault stalls disk io and never the audio callback.
+
+struct DiskFileMap
+{
+	std::string mPath;
+	void *mBase;             // NULL marks a file we know we cannot map
+	size_t mMapLength;
+	const char *mData;       // start of sample data within the mapping
+	sf_count_t mFrames;
+	size_t mFrameBytes;
+	int mSubFormat;          // SF_FORMAT_FLOAT, SF_FORMAT_PCM_16 or SF_FORMAT_PCM_32
+	int mChannels;
+};
+
+// keyed by the SNDFILE handle stored in the SndBuf. only the disk io thread
+// reads or writes this map, so no locking is required.
+std::map<SNDFILE*, DiskFileMap> gFileMaps;
+
+bool sndfileGetPath(SNDFILE *sf, std::string & outPath)
+{
+	// libsndfile does not expose the path or descriptor of an open handle, but
+	// its parse log starts with a "File : <path>" line.
+	char log[2048];
+	int count = sf_command(sf, SFC_GET_LOG_INFO, log, sizeof(log));
+	if (count <= 0) return false;
+	log[sizeof(log) - 1] = 0;
+	const char *start = strstr(log, "File : ");
+	if (!start) return false;
+	start += 7;
+	const char *end = strchr(start, '\n');
+	if (!end || end == start) return false;
+	outPath.assign(start, end - start);
+	return true;
+}
+
+bool findWavDataChunk(const char *data, size_t length, size_t & outOffset, size_t & outBytes)
+{
+	if (length < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+		return false;
+	size_t pos = 12;
+	while (pos + 8 <= length) {
+		const unsigned char *sizeBytes = (const unsigned char*)data + pos + 4;
+		size_t chunkSize = sizeBytes[0] | (sizeBytes[1] << 8) | (sizeBytes[2] << 16)
+							| ((size_t)sizeBytes[3] << 24);
+		if (memcmp(data + pos, "data", 4) == 0) {
+			outOffset = pos + 8;
+			outBytes = sc_min(chunkSize, length - outOffset);
+			return true;
+		}
+		pos += 8 + chunkSize + (chunkSize & 1);
+	}
+	return false;
+}
+
+DiskFileMap* getFileMap(SNDFILE *sf)
+{
+	std::string path;
+	if (!sndfileGetPath(sf, path)) return NULL;
+
+	std::map<SNDFILE*, DiskFileMap>::iterator it = gFileMaps.find(sf);
+	if (it != gFileMaps.end()) {
+		// the server may close a handle and reuse its address for another
+		// file; the path tells us which file the mapping actually covers.
+		if (it->second.mPath == path)
+			return it->second.mBase ? &it->second : NULL;
+		if (it->second.mBase)
+			munmap(it->second.mBase, it->second.mMapLength);
+		gFileMaps.erase(it);
+	}
+
+	DiskFileMap & fileMap = gFileMaps[sf];
+	fileMap.mPath = path;
+	fileMap.mBase = NULL;
+
+	SF_INFO info;
+	memset(&info, 0, sizeof(info));
+	sf_command(sf, SFC_GET_CURRENT_SF_INFO, &info, sizeof(info));
+
+	int majorFormat = info.format & SF_FORMAT_TYPEMASK;
+	int subFormat = info.format & SF_FORMAT_SUBMASK;
+	if (majorFormat != SF_FORMAT_WAV && majorFormat != SF_FORMAT_WAVEX) return NULL;
+	if (subFormat != SF_FORMAT_FLOAT && subFormat != SF_FORMAT_PCM_16 && subFormat != SF_FORMAT_PCM_32)
+		return NULL;
+	if (info.channels < 1) return NULL;
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1) return NULL;
+	struct stat statBuf;
+	if (fstat(fd, &statBuf) == -1 || statBuf.st_size <= 0) {
+		close(fd);
+		return NULL;
+	}
+
+	size_t length = (size_t)statBuf.st_size;
+	void *base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd); // the mapping holds its own reference
+	if (base == MAP_FAILED) return NULL;
+
+	size_t dataOffset, dataBytes;
+	size_t sampleBytes = (subFormat == SF_FORMAT_PCM_16) ? 2 : 4;
+	if (!findWavDataChunk((const char*)base, length, dataOffset, dataBytes)
+			|| (dataOffset & (sampleBytes - 1)) != 0) {
+		munmap(base, length);
+		return NULL;
+	}
+
+	madvise(base, length, MADV_SEQUENTIAL);
+
+	fileMap.mBase = base;
+	fileMap.mMapLength = length;
+	fileMap.mData = (const char*)base + dataOffset;
+	fileMap.mFrameBytes = sampleBytes * info.channels;
+	fileMap.mFrames = sc_min((sf_count_t)(dataBytes / fileMap.mFrameBytes), info.frames);
+	fileMap.mSubFormat = subFormat;
+	fileMap.mChannels = info.channels;
+	return &fileMap;
+}
+
+sf_count_t mapReadFrames(DiskFileMap *fileMap, SNDFILE *sf, float *dest, sf_count_t frames)
+{
+	// stay in sync with libsndfile's read position so seeks made elsewhere
+	// (looping, /b_read offsets) keep working.
+	sf_count_t pos = sf_seek(sf, 0, SEEK_CUR);
+	if (pos < 0) return 0;
+	sf_count_t count = sc_clip(fileMap->mFrames - pos, (sf_count_t)0, frames);
+	if (count == 0) return 0;
+
+	const char *src = fileMap->mData + pos * fileMap->mFrameBytes;
+	size_t numSamples = (size_t)count * fileMap->mChannels;
+
+	switch (fileMap->mSubFormat) {
+		case SF_FORMAT_FLOAT :
+			memcpy(dest, src, (size_t)count * fileMap->mFrameBytes);
+		break;
+		case SF_FORMAT_PCM_16 : {
+			const int16 *samples = (const int16*)src;
+			for (size_t i = 0; i < numSamples; ++i)
+				dest[i] = samples[i] * (1.f / 32768.f);
+		} break;
+		case SF_FORMAT_PCM_32 : {
+			const int32 *samples = (const int32*)src;
+			for (size_t i = 0; i < numSamples; ++i)
+				dest[i] = samples[i] * (float)(1.0 / 2147483648.0);
+		} break;
+	}
+
+	sf_seek(sf, pos + count, SEEK_SET);
+
+	// ask the kernel to start fetching the next chunk while we go back to sleep
+	size_t nextOffset = (fileMap->mData - (const char*)fileMap->mBase)
+						+ (size_t)((pos + count) * fileMap->mFrameBytes);
+	if (nextOffset < fileMap->mMapLength) {
+		static const size_t pageMask = sysconf(_SC_PAGESIZE) - 1;
+		size_t advStart = nextOffset & ~pageMask;
+		size_t advBytes = sc_min((size_t)(frames * fileMap->mFrameBytes) + pageMask + 1,
+								 fileMap->mMapLength - advStart);
+		madvise((char*)fileMap->mBase + advStart, advBytes, MADV_WILLNEED);
+	}
+	return count;
+}
+
+#endif // SC_DISKIO_MMAP
+
+// read frames from an open handle into the staging buffer, via the file
+// mapping when the format allows it.
+sf_count_t diskReadFrames(SNDFILE *sf, float *dest, sf_count_t frames)
+{
+#ifdef SC_DISKIO_MMAP
+	DiskFileMap *fileMap = getFileMap(sf);
+	if (fileMap)
+		return mapReadFrames(fileMap, sf, dest, frames);
+#endif
+	return sf_readf_float(sf, dest, frames);
+}
+
 void DiskIOMsg::Perform()
 {
 	NRTLock(mWorld);
@@ -125,7 +319,7 @@ void DiskIOMsg::Perform()
 	sf_count_t count;
 	switch (mCommand) {
 		case kDiskCmd_Read :
-			count = buf->sndfile ? sf_readf_float(buf->sndfile, buf->data + mPos * buf->channels, mFrames) : 0;
+			count = buf->sndfile ? diskReadFrames(buf->sndfile, buf->data + mPos * buf->channels, mFrames) : 0;
 			if (count < mFrames) {
 				memset(buf->data + (mPos + count) * buf->channels, 0, (mFrames - count) * buf->channels * sizeof(float));
 				World_GetBuf(mWorld, mBufNum)->mask = mPos + count;
@@ -140,10 +334,10 @@ void DiskIOMsg::Perform()
 				memset(buf->data + mPos * buf->channels, 0, mFrames * buf->channels * sizeof(float));
 				goto leave;
 			}
-			count = sf_readf_float(buf->sndfile, buf->data + mPos * buf->channels, mFrames);
+			count = diskReadFrames(buf->sndfile, buf->data + mPos * buf->channels, mFrames);
 			while (mFrames -= count) {
 				sf_seek(buf->sndfile, 0, SEEK_SET);
-				count = sf_readf_float(buf->sndfile, buf->data + (mPos + count) * buf->channels, mFrames);
+				count = diskReadFrames(buf->sndfile, buf->data + (mPos + count) * buf->channels, mFrames);
 			}
 		break;
 		case kDiskCmd_Write :
@@ -642,7 +836,14 @@ void VDiskIn_next_rate1(VDiskIn *unit, int inNumSamples)
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 C_LINKAGE SC_API_EXPORT void unload(InterfaceTable *inTable)
 {
-	delete gDiskIO;
+	delete gDiskIO; // joins the io thread, so the file maps are quiescent now
+#ifdef SC_DISKIO_MMAP
+	for (std::map<SNDFILE*, DiskFileMap>::iterator it = gFileMaps.begin(); it != gFileMaps.end(); ++it) {
+		if (it->second.mBase)
+			munmap(it->second.mBase, it->second.mMapLength);
+	}
+	gFileMaps.clear();
+#endif
 }
 
 PluginLoad(DiskIO)
@@ -33,11 +33,13 @@ static InterfaceTable *ft;
 
 struct LFDNoise0 : public Unit
 {
+	RGen mRGen;
 	float mLevel;
 	float mPhase;
 };
 struct LFDNoise1 : public Unit
 {
+	RGen mRGen;
 	float mPhase;
 	float mPrevLevel;
 	float mNextLevel;
@@ -46,12 +48,14 @@ struct LFDNoise1 : public Unit
 
 struct LFDNoise3 : public Unit
 {
+	RGen mRGen;
 	float mPhase;
 	float mLevelA, mLevelB, mLevelC, mLevelD;
 };
 
 struct LFDClipNoise : public Unit
 {
+	RGen mRGen;
 	float mLevel;
 	float mPhase;
 };
@@ -88,7 +92,7 @@ void LFDNoise0_next(LFDNoise0 *unit, int inNumSamples)
 	float level = unit->mLevel;
 	float phase = unit->mPhase;
 	float smpdur = SAMPLEDUR;
-	RGET
+	RGET_UNIT
 
 	LOOP1(inNumSamples,
 		phase -= ZXP(freq) * smpdur;
@@ -113,7 +117,7 @@ void LFDNoise0_next_k(LFDNoise0 *unit, int inNumSamples)
 	float smpdur = SAMPLEDUR;
 	float dphase = smpdur * freq;
 
-	RGET
+	RGET_UNIT
 
 	LOOP1(inNumSamples,
 		phase -= dphase;
@@ -131,6 +135,8 @@ void LFDNoise0_next_k(LFDNoise0 *unit, int inNumSamples)
 
 void LFDNoise0_Ctor(LFDNoise0* unit)
 {
+	InitUnitRGen(unit, &unit->mRGen);
+
 	if (INRATE(0) == calc_FullRate) {
 		SETCALC(LFDNoise0_next);
 	} else {
@@ -154,7 +160,7 @@ void LFDNoise1_next(LFDNoise1 *unit, int inNumSamples)
 	float phase = unit->mPhase;
 	float smpdur = SAMPLEDUR;
 
-	RGET
+	RGET_UNIT
 
 	LOOP1(inNumSamples,
 		phase -= ZXP(freq) * smpdur;
@@ -181,7 +187,7 @@ void LFDNoise1_next_k(LFDNoise1 *unit, int inNumSamples)
 	float smpdur = SAMPLEDUR;
 	float dphase = freq * smpdur;
 
-	RGET
+	RGET_UNIT
 
 	LOOP1(inNumSamples,
 		phase -= dphase;
@@ -200,6 +206,8 @@ void LFDNoise1_next_k(LFDNoise1 *unit, int inNumSamples)
 
 void LFDNoise1_Ctor(LFDNoise1* unit)
 {
+	InitUnitRGen(unit, &unit->mRGen);
+
 	if (INRATE(0) == calc_FullRate) {
 		SETCALC(LFDNoise1_next);
 	} else {
@@ -208,7 +216,7 @@ void LFDNoise1_Ctor(LFDNoise1* unit)
 
 	unit->mPhase = 0.f;
 	unit->mPrevLevel = 0.f;
-	unit->mNextLevel = unit->mParent->mRGen->frand2();
+	unit->mNextLevel = unit->mRGen.frand2();
 
 	LFDNoise1_next(unit, 1);
 }
@@ -226,7 +234,7 @@ void LFDNoise3_next(LFDNoise3 *unit, int inNumSamples)
 	float phase = unit->mPhase;
 	float smpdur = SAMPLEDUR;
 
-	RGET
+	RGET_UNIT
 
 	LOOP1(inNumSamples,
 		phase -= ZXP(freq) * smpdur;
@@ -258,7 +266,7 @@ void LFDNoise3_next_k(LFDNoise3 *unit, int inNumSamples)
 	float phase = unit->mPhase;
 	float dphase = freq * SAMPLEDUR;
 
-	RGET
+	RGET_UNIT
 
 	LOOP1(inNumSamples,
 		phase -= dphase;
@@ -281,13 +289,15 @@ void LFDNoise3_next_k(LFDNoise3 *unit, int inNumSamples)
 
 void LFDNoise3_Ctor(LFDNoise3* unit)
 {
+	InitUnitRGen(unit, &unit->mRGen);
+
 	if (INRATE(0) == calc_FullRate) {
 		SETCALC(LFDNoise3_next);
 	} else {
 		SETCALC(LFDNoise3_next_k);
 	}
 
-	RGET
+	RGET_UNIT
 	unit->mPhase = 0.f;
 	unit->mLevelA = frand2(s1, s2, s3) * 0.8f;	// limits max interpol. overshoot to 1.
 	unit->mLevelB = frand2(s1, s2, s3) * 0.8f;
@@ -306,7 +316,7 @@ void LFDClipNoise_next(LFDClipNoise *unit, int inNumSamples)
 	float level = unit->mLevel;
 	float phase = unit->mPhase;
 	float smpdur = SAMPLEDUR;
-	RGET
+	RGET_UNIT
 
 	LOOP1(inNumSamples,
 		phase -= ZXP(freq) * smpdur;
@@ -332,7 +342,7 @@ void LFDClipNoise_next_k(LFDClipNoise *unit, int inNumSamples)
 	float smpdur = SAMPLEDUR;
 	float dphase = smpdur * freq;
 
-	RGET
+	RGET_UNIT
 
 	LOOP1(inNumSamples,
 		phase -= dphase;
@@ -350,6 +360,8 @@ void LFDClipNoise_next_k(LFDClipNoise *unit, int inNumSamples)
 
 void LFDClipNoise_Ctor(LFDClipNoise* unit)
 {
+	InitUnitRGen(unit, &unit->mRGen);
+
 	if (INRATE(0) == calc_FullRate) {
 		SETCALC(LFDClipNoise_next);
 	} else {
@@ -42,6 +42,62 @@ using namespace std; // for math functions
 
 static InterfaceTable *ft;
 
+/* On x86 the fixed-coefficient one pole recurrence can be blocked four
+ * samples at a time: within a block the prefix is built with two shifted
+ * multiply-adds, and only a single multiply-add chains one block to the
+ * next, so the loop is no longer bound by the per-sample dependency chain.
+ * Dispatched at runtime, so generic builds still run on machines without
+ * AVX2. The blocked form associates the arithmetic differently, but with
+ * |b1| < 1 the rounding difference is contractive and stays at ulp level.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(__AVX2__)
+#define SC_FILTER_AVX2_DISPATCH
+#endif
+
+#ifdef SC_FILTER_AVX2_DISPATCH
+
+#include <immintrin.h>
+
+static bool cpu_has_avx2(void)
+{
+	static const bool result = __builtin_cpu_supports("avx2");
+	return result;
+}
+
+/* runs the recurrence y[n] = xcoef * x[n] + b1 * y[n-1], returns the final y */
+__attribute__((target("avx2")))
+static double OnePole_loop_avx2(float *out, const float *in, double y1, double b1, double xcoef,
+	int inNumSamples)
+{
+	const __m256d vb     = _mm256_set1_pd(b1);
+	const __m256d vb2    = _mm256_set1_pd(b1 * b1);
+	const __m256d vbpow  = _mm256_setr_pd(b1, b1 * b1, b1 * b1 * b1, b1 * b1 * b1 * b1);
+	const __m256d vxcoef = _mm256_set1_pd(xcoef);
+	const __m256d vzero  = _mm256_setzero_pd();
+
+	const int n4 = inNumSamples & ~3;
+	for (int i = 0; i != n4; i += 4) {
+		__m256d acc = _mm256_mul_pd(vxcoef, _mm256_cvtps_pd(_mm_loadu_ps(in + i)));
+
+		/* inclusive scan: acc[j] = sum of b1^(j-k) * xcoef * x[k] for k <= j */
+		__m256d s1 = _mm256_blend_pd(_mm256_permute4x64_pd(acc, _MM_SHUFFLE(2,1,0,0)), vzero, 0x1);
+		acc = _mm256_add_pd(acc, _mm256_mul_pd(vb, s1));
+		__m256d s2 = _mm256_blend_pd(_mm256_permute4x64_pd(acc, _MM_SHUFFLE(1,0,0,0)), vzero, 0x3);
+		acc = _mm256_add_pd(acc, _mm256_mul_pd(vb2, s2));
+
+		__m256d y = _mm256_add_pd(acc, _mm256_mul_pd(vbpow, _mm256_set1_pd(y1)));
+		_mm_storeu_ps(out + i, _mm256_cvtpd_ps(y));
+		y1 = _mm256_cvtsd_f64(_mm256_permute4x64_pd(y, _MM_SHUFFLE(3,3,3,3)));
+	}
+	for (int i = n4; i != inNumSamples; ++i) {
+		double y0 = in[i];
+		out[i] = y1 = xcoef * y0 + b1 * y1;
+	}
+	return y1;
+}
+
+#endif /* SC_FILTER_AVX2_DISPATCH */
+
 struct Ramp : public Unit
 {
 	double m_level, m_slope;
@@ -593,6 +649,11 @@ void Lag_next(Lag *unit, int inNumSamples)
 	double b1 = unit->m_b1;
 
 	if (lag == unit->m_lag) {
+#ifdef SC_FILTER_AVX2_DISPATCH
+		if (cpu_has_avx2())
+			y1 = OnePole_loop_avx2(OUT(0), IN(0), y1, b1, 1. - b1, inNumSamples);
+		else
+#endif
 		LOOP1(inNumSamples,
 			double y0 = ZXP(in);
 			ZXP(out) = y1 = y0 + b1 * (y1 - y0);
@@ -1148,11 +1209,21 @@ void OnePole_next_k(OnePole *unit, int inNumSamples)
 
 	if (b1 == unit->m_b1) {
 		if (b1 >= 0.f) {
+#ifdef SC_FILTER_AVX2_DISPATCH
+			if (cpu_has_avx2())
+				y1 = OnePole_loop_avx2(OUT(0), IN(0), y1, b1, 1. - b1, inNumSamples);
+			else
+#endif
 			LOOP1(inNumSamples,
 				double y0 = ZXP(in);
 				ZXP(out) = y1 = y0 + b1 * (y1 - y0);
 			);
 		} else {
+#ifdef SC_FILTER_AVX2_DISPATCH
+			if (cpu_has_avx2())
+				y1 = OnePole_loop_avx2(OUT(0), IN(0), y1, b1, 1. + b1, inNumSamples);
+			else
+#endif
 			LOOP1(inNumSamples,
 				double y0 = ZXP(in);
 				ZXP(out) = y1 = y0 + b1 * (y1 + y0);
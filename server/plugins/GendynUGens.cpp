@@ -31,6 +31,7 @@ struct Gendy1 : public Unit   // Iannis Xenakis/Marie-Helene Serra GENDYN simula
 	int mMemorySize, mIndex;
 	float* mMemoryAmp; 	//could hard code as 12
 	float* mMemoryDur;
+	RGen4 mRGen4;
 };
 
 //following Hoffmann paper from CMJ- primary and secondary random walks
@@ -57,6 +58,7 @@ struct Gendy3 : public Unit
 	float* mMemoryDur;
 	double* mPhaseList;
 	float* mAmpList;
+	RGen4 mRGen4;
 };
 
 extern "C" {
@@ -101,6 +103,8 @@ void Gendy1_Ctor( Gendy1* unit )
 		unit->mMemoryDur[i] = rgen.frand();
 	}
 
+	unit->mRGen4.init(rgen);
+
 	// compute one sample of output to avoid sending garbage memory downstream to other Ctor functions
 	// first sample of the _next output will be the current amplitude (which is 0)
 	OUT0(0) = 0.0f;
@@ -205,7 +209,7 @@ static float Gendyn_distribution( int which, float a, float f)
 
 void Gendy1_next_k( Gendy1 *unit, int inNumSamples )
 {
-	float *out = ZOUT(0);
+	float *out = OUT(0);
 
 	//distribution choices for amp and dur and constants of distribution
 	int whichamp = (int)ZIN0(0);
@@ -227,11 +231,14 @@ void Gendy1_next_k( Gendy1 *unit, int inNumSamples )
 
 	float speed = unit->mSpeed;
 
-	RGen& rgen = *unit->mParent->mRGen;
-	//linear distribution 0.0 to 1.0 using rgen.frand()
+	RGen4& rgen4 = unit->mRGen4;
 
-	LOOP1(inNumSamples,
-		float z;
+	//the random walk only runs at phase wraps; everything between two wraps
+	//is one linear ramp. working out the span length up front keeps the wrap
+	//test out of the sample loop, so the ramp fill below is branch-free and
+	//vectorizable.
+	int i = 0;
+	while (i < inNumSamples) {
 
 		if (phase >= 1.0) {
 			phase -= 1.0;
@@ -246,9 +253,14 @@ void Gendy1_next_k( Gendy1 *unit, int inNumSamples )
 
 			unit->mIndex = index;
 
+			//both perturbations for this breakpoint from one batched draw
+			//(lanes 2 and 3 are spare)
+			float rand[4];
+			rgen4.frand(rand);
+
 			//Gendy dist gives value [-1,1], then use scaleamp
 			//first term was amp before, now must check new memory slot
-			nextamp = (unit->mMemoryAmp[index])+(scaleamp*Gendyn_distribution(whichamp, aamp,rgen.frand()));
+			nextamp = (unit->mMemoryAmp[index])+(scaleamp*Gendyn_distribution(whichamp, aamp, rand[0]));
 
 			//mirroring for bounds- safe version
 			if(nextamp>1.0f || nextamp<-1.0f) {
@@ -273,7 +285,7 @@ void Gendy1_next_k( Gendy1 *unit, int inNumSamples )
 			unit->mMemoryAmp[index] = nextamp;
 
 			//Gendy dist gives value [-1,1]
-			rate= (unit->mMemoryDur[index]) + (scaledur*Gendyn_distribution(whichdur, adur, rgen.frand()));
+			rate= (unit->mMemoryDur[index]) + (scaledur*Gendyn_distribution(whichdur, adur, rand[1]));
 
 			if(rate>1.0f || rate<0.0f)
 			{
@@ -296,12 +308,21 @@ void Gendy1_next_k( Gendy1 *unit, int inNumSamples )
 			speed *= num;
 		}
 
+		//samples until the next wrap, or the end of the block
+		int span = inNumSamples - i;
+		if (speed > 0.f) {
+			double towrap = ceil((1.0 - phase) / speed);
+			if (towrap < (double)span) span = (int)towrap;
+		}
+
 		//linear interpolation could be changed
-		z = ((1.0-phase)*amp) + (phase*nextamp);
+		float slope = nextamp - amp;
+		for (int j=0; j<span; ++j)
+			out[i+j] = amp + (float)(phase + j*(double)speed)*slope;
 
-		phase +=  speed;
-		ZXP(out) = z;
-	);
+		phase += span*(double)speed;
+		i += span;
+	}
 
 	unit->mPhase = phase;
 	unit->mAmp =  amp;
@@ -513,6 +534,8 @@ void Gendy3_Ctor( Gendy3* unit )
 
 	unit->mMemoryAmp[0] = 0.0f;	//always zeroed first BP
 
+	unit->mRGen4.init(rgen);
+
 	// compute one sample of output to avoid sending garbage memory downstream to other Ctor functions
 	// first sample of the _next output will be the current amplitude (which is 0)
 	OUT0(0) = 0.0f;
@@ -528,7 +551,7 @@ void Gendy3_Dtor(Gendy3 *unit)
 
 void Gendy3_next_k( Gendy3 *unit, int inNumSamples )
 {
-	float *out = ZOUT(0);
+	float *out = OUT(0);
 
 	//distribution choices for amp and dur and constants of distribution
 	int whichamp = (int)ZIN0(0);
@@ -548,13 +571,16 @@ void Gendy3_next_k( Gendy3 *unit, int inNumSamples )
 	double lastphase = unit->mLastPhase;
 	double nextphase = unit->mNextPhase;
 
-	RGen& rgen = *unit->mParent->mRGen;
+	RGen4& rgen4 = unit->mRGen4;
 
 	float * amplist = unit->mAmpList;
 	double * phaselist = unit->mPhaseList;
 
-	LOOP1(inNumSamples,
-		float z;
+	//as for Gendy1: the walk only runs at breakpoints, so work a span at a
+	//time — everything up to the next breakpoint (or period end) is one
+	//linear ramp, filled by a branch-free vectorizable loop.
+	int i = 0;
+	while (i < inNumSamples) {
 
 		if (phase >= 1.) { //calculate all targets for new period
 			phase -= 1.;
@@ -567,15 +593,26 @@ void Gendy3_next_k( Gendy3 *unit, int inNumSamples )
 			float * memoryamp = unit->mMemoryAmp;
 			float * memorydur = unit->mMemoryDur;
 
+			//all control-point perturbations for the period are drawn in
+			//batches of four; the unused j==0 amp lane is cheaper than
+			//breaking the batch
+			float randamp[4], randdur[4];
+
 			for(int j = 0; j<num; ++j) {
 
+				int lane = j & 3;
+				if(lane == 0) {
+					rgen4.frand(randamp);
+					rgen4.frand(randdur);
+				}
+
 				if(j>0) {   //first BP always stays at 0
-					float amp = (memoryamp[j])+ (scaleamp*Gendyn_distribution(whichamp, aamp, rgen.frand()));
+					float amp = (memoryamp[j])+ (scaleamp*Gendyn_distribution(whichamp, aamp, randamp[lane]));
 					amp = Gendyn_mirroring(-1.0f,1.0f,amp);
 					memoryamp[j] = amp;
 				}
 
-				float dur = (memorydur[j])+ (scaledur*Gendyn_distribution(whichdur, adur, rgen.frand()));
+				float dur = (memorydur[j])+ (scaledur*Gendyn_distribution(whichdur, adur, randdur[lane]));
 				dur = Gendyn_mirroring(0.01f,1.0f,dur);	//will get normalised in a moment, don't allow zeroes
 				memorydur[j] = dur;
 				dursum += dur;
@@ -636,14 +673,26 @@ void Gendy3_next_k( Gendy3 *unit, int inNumSamples )
 			interpmult = (int)(1.0/(nextphase-lastphase));
 		}
 
-		float interp = (phase-lastphase)*interpmult;
+		//samples until the region end or the period wrap, whichever is
+		//first, or the end of the block
+		int span = inNumSamples - i;
+		if (speed > 0.f) {
+			double limit = nextphase < 1.0 ? nextphase : 1.0;
+			double tonext = ceil((limit - phase) / speed);
+			if (tonext < (double)span) span = (int)tonext;
+			if (span < 1) span = 1;
+		}
 
 		//linear interpolation could be changed
-		z = ((1.0f-interp)*amp) + (interp*nextamp);
+		float slope = nextamp - amp;
+		for (int j=0; j<span; ++j) {
+			float interp = (float)((phase - lastphase) + j*(double)speed)*interpmult;
+			out[i+j] = amp + interp*slope;
+		}
 
-		phase +=  speed;
-		ZXP(out) = z;
-	);
+		phase += span*(double)speed;
+		i += span;
+	}
 
 	unit->mPhase = phase;
 	unit->mSpeed = speed;
@@ -54,11 +54,12 @@ struct GrainIn : public Unit
 
 struct GrainSinG
 {
+	// per-sample state first, so the inner loop stays within one cache line
 	double b1, y1, y2, curamp, winPos, winInc; // envelope
-	int counter, chan;
-	float pan1, pan2, winType;
 	int32 oscphase; // the phase of the osc inside this grain
 	int32 freq; // the freq of the osc inside this grain in phase inc
+	int counter, chan;
+	float pan1, pan2, winType;
 };
 
 struct GrainSin : public Unit
@@ -120,7 +121,10 @@ struct Warp1 : public Unit
 	SndBuf* m_buf;
 	int mNumActive[16];
 	int mNextGrain[16];
-	WarpWinGrain mGrains[16][kMaxGrains];
+	// one dense pool per used output channel; the old inline
+	// [16][kMaxGrains] array cost ~90KB of RT memory per unit
+	// whether or not the channels existed
+	WarpWinGrain *mGrains[16];
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -148,6 +152,7 @@ extern "C"
 
 	void Warp1_next(Warp1 *unit, int inNumSamples);
 	void Warp1_Ctor(Warp1* unit);
+	void Warp1_Dtor(Warp1* unit);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1503,15 +1508,24 @@ void Warp1_Ctor(Warp1 *unit)
 {
 	SETCALC(Warp1_next);
 
+	const int numOutputs = sc_min((int)unit->mNumOutputs, 16);
 	for(int i = 0; i < 16; i++){
 		unit->mNumActive[i] = 0;
 		unit->mNextGrain[i] = 1;
+		unit->mGrains[i] = i < numOutputs ?
+			(WarpWinGrain*)RTAlloc(unit->mWorld, kMaxGrains * sizeof(WarpWinGrain)) : NULL;
 	}
 
 	ClearUnitOutputs(unit, 1);
 	unit->m_fbufnum = -1e9f;
 }
 
+void Warp1_Dtor(Warp1 *unit)
+{
+	for(int i = 0; i < 16; i++)
+		if (unit->mGrains[i]) RTFree(unit->mWorld, unit->mGrains[i]);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -1523,5 +1537,5 @@ PluginLoad(Grain)
 	DefineDtorCantAliasUnit(GrainSin);
 	DefineDtorCantAliasUnit(GrainFM);
 	DefineDtorCantAliasUnit(GrainBuf);
-	DefineSimpleCantAliasUnit(Warp1);
+	DefineDtorCantAliasUnit(Warp1);
 }
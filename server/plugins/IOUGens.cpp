@@ -52,6 +52,7 @@ struct IOUnit : public Unit
 	int32* m_busTouched;
 	float m_fbusChannel;
 	float *m_bus;
+	float m_fwatchedChannel; // last bus reported to the parent graph's auto-bypass watch list
 };
 
 struct XOut : public IOUnit
@@ -157,18 +158,20 @@ extern "C"
 void Control_next_k(Unit *unit, int inNumSamples)
 {
 	uint32 numChannels = unit->mNumOutputs;
-	float **mapin = unit->mParent->mMapControls + unit->mSpecialIndex;
-	for (uint32 i=0; i<numChannels; ++i, mapin++) {
+	// mapped bus values were gathered into the contiguous per-graph snapshot
+	// at the top of the block (Graph_SnapshotControls)
+	float *mapin = unit->mParent->mControlSnapshot + unit->mSpecialIndex;
+	for (uint32 i=0; i<numChannels; ++i) {
 		float *out = OUT(i);
-		*out = **mapin;
+		*out = mapin[i];
 	}
 }
 
 void Control_next_1(Unit *unit, int inNumSamples)
 {
-	float **mapin = unit->mParent->mMapControls + unit->mSpecialIndex;
+	float *mapin = unit->mParent->mControlSnapshot + unit->mSpecialIndex;
 	float *out = OUT(0);
-	*out = **mapin;
+	*out = *mapin;
 }
 
 void Control_Ctor(Unit* unit)
@@ -189,6 +192,7 @@ void AudioControl_next_k(AudioControl *unit, int inNumSamples)
 	uint32 numChannels = unit->mNumOutputs;
 	float *prevVal = unit->prevVal;
 	float **mapin = unit->mParent->mMapControls + unit->mSpecialIndex;
+	float *snapshot = unit->mParent->mControlSnapshot + unit->mSpecialIndex;
 	for(uint32 i = 0; i < numChannels; ++i, mapin++){
 		float *out = OUT(i);
 		int *mapRatep;
@@ -199,11 +203,11 @@ void AudioControl_next_k(AudioControl *unit, int inNumSamples)
 		switch (mapRate) {
 			case 0 : {
 				for(int j = 0; j < inNumSamples; j++){
-					out[j] = *mapin[0];
+					out[j] = snapshot[i];
 				}
 			} break;
 			case 1 : {
-				nextVal = *mapin[0];
+				nextVal = snapshot[i];
 				curVal = prevVal[i];
 				valSlope = CALCSLOPE(nextVal, curVal);
 				for(int j = 0; j < inNumSamples; j++){
@@ -221,6 +225,7 @@ void AudioControl_next_k(AudioControl *unit, int inNumSamples)
 void AudioControl_next_1(AudioControl *unit, int inNumSamples)
 {
 	float **mapin = unit->mParent->mMapControls + unit->mSpecialIndex;
+	float *snapshot = unit->mParent->mControlSnapshot + unit->mSpecialIndex;
 	float *out = OUT(0);
 	int *mapRatep;
 	int mapRate;
@@ -234,11 +239,11 @@ void AudioControl_next_1(AudioControl *unit, int inNumSamples)
 	switch (mapRate) {
 		case 0 : {
 			for(int i = 0; i < inNumSamples; i++){
-				out[i] = *mapin[0];
+				out[i] = snapshot[0];
 			}
 		} break;
 		case 1 : {
-			nextVal = *mapin[0];
+			nextVal = snapshot[0];
 			valSlope = CALCSLOPE(nextVal, curVal);
 			for(int i = 0; i < inNumSamples; i++){
 				out[i] = curVal;
@@ -333,10 +338,12 @@ void TrigControl_Ctor(Unit* unit)
 void LagControl_next_k(LagControl *unit, int inNumSamples)
 {
 	uint32 numChannels = unit->mNumOutputs;
-	float **mapin = unit->mParent->mMapControls + unit->mSpecialIndex;
-	for (uint32 i=0; i<numChannels; ++i, mapin++) {
+	// sequential reads from the per-graph control snapshot: the smoothing
+	// loop vectorizes over channels
+	float *mapin = unit->mParent->mControlSnapshot + unit->mSpecialIndex;
+	for (uint32 i=0; i<numChannels; ++i) {
 		float *out = OUT(i);
-		float z = **mapin;
+		float z = mapin[i];
 		float x = z + unit->m_b1[i] * (unit->m_y1[i] - z);
 		*out = unit->m_y1[i] = zapgremlins(x);
 	}
@@ -344,9 +351,9 @@ void LagControl_next_k(LagControl *unit, int inNumSamples)
 
 void LagControl_next_1(LagControl *unit, int inNumSamples)
 {
-	float **mapin = unit->mParent->mMapControls + unit->mSpecialIndex;
+	float *mapin = unit->mParent->mControlSnapshot + unit->mSpecialIndex;
 	float *out = OUT(0);
-	float z = **mapin;
+	float z = *mapin;
 	float x = z + unit->m_b1[0] * (unit->m_y1[0] - z);
 	*out = unit->m_y1[0] = zapgremlins(x);
 }
@@ -354,14 +361,14 @@ void LagControl_next_1(LagControl *unit, int inNumSamples)
 void LagControl_Ctor(LagControl* unit)
 {
 	int numChannels = unit->mNumInputs;
-	float **mapin = unit->mParent->mMapControls + unit->mSpecialIndex;
+	float *mapin = unit->mParent->mControlSnapshot + unit->mSpecialIndex;
 
 	char * chunk = (char*)RTAlloc(unit->mWorld, numChannels * 2 * sizeof(float));
 	unit->m_y1 = (float*)chunk;
 	unit->m_b1 = unit->m_y1 + numChannels;
 
-	for (int i=0; i<numChannels; ++i, mapin++) {
-		unit->m_y1[i] = **mapin;
+	for (int i=0; i<numChannels; ++i) {
+		unit->m_y1[i] = mapin[i];
 		float lag = ZIN0(i);
 		unit->m_b1[i] = lag == 0.f ? 0.f : (float)exp(log001 / (lag * unit->mRate->mSampleRate));
 	}
@@ -398,6 +405,20 @@ static inline void IO_a_update_channels(IOUnit * unit, World * world, float fbus
 	}
 }
 
+// auto-bypass support (/n_run with run == 2): record the bus range an audio
+// input unit reads on its parent graph, so the server can skip the graph
+// while those buses stay untouched. only re-reports when the bus changes.
+static inline void IO_a_watch_input(IOUnit * unit, float fbusChannel, int numChannels)
+{
+	Graph *parent = unit->mParent;
+	if (!parent->mAutoBypass || fbusChannel == unit->m_fwatchedChannel)
+		return;
+	unit->m_fwatchedChannel = fbusChannel;
+	int busChannel = (int)fbusChannel;
+	if (busChannel >= 0 && busChannel + numChannels <= (int)unit->mWorld->mNumAudioBusChannels)
+		Graph_WatchAudioInput(parent, busChannel, numChannels);
+}
+
 template <bool UpdateTouched>
 static inline void IO_k_update_channels(IOUnit * unit, World * world, float fbusChannel,
 										int numChannels)
@@ -415,6 +436,58 @@ static inline void IO_k_update_channels(IOUnit * unit, World * world, float fbus
 	}
 }
 
+#ifdef SUPERNOVA
+
+// fold per-thread shadow mixes pending on an audio bus (--bus-shadows mode)
+// into the bus proper, under the bus write lock. called before a bus is read
+// or exclusively written; graph ordering guarantees that the writers which
+// produced the shadows have finished. shadows left pending by parallel
+// branches a reader never follows are folded at the end of the tick.
+static void IO_CollectBusShadows(World *world, int32 channel)
+{
+	const uint32 numThreads = world->mNumDspThreads;
+	const uint32 numChannels = world->mNumAudioBusChannels;
+	const int32 bufCounter = world->mBufCounter;
+	int32 *tags = world->mAudioBusShadowTouched;
+
+	bool pending = false;
+	for (uint32 t = 0; t != numThreads; ++t) {
+		if (tags[t * numChannels + channel] == bufCounter) {
+			pending = true;
+			break;
+		}
+	}
+	if (!pending)
+		return;
+
+	const int bufLength = world->mBufLength;
+	float *bus = world->mAudioBus + channel * bufLength;
+
+	world->mAudioBusLocks[channel].lock();
+	for (uint32 t = 0; t != numThreads; ++t) {
+		int32 & tag = tags[t * numChannels + channel];
+		if (tag != bufCounter)
+			continue;
+		tag = bufCounter - 1; // consumed
+
+		float *shadow = world->mAudioBusShadows + (t * numChannels + channel) * bufLength;
+		if (world->mAudioBusTouched[channel] == bufCounter) {
+#ifdef NOVA_SIMD
+			if (!(bufLength & 15))
+				nova::addvec_simd(bus, shadow, bufLength);
+			else
+#endif
+			Accum(bufLength, bus, shadow);
+		} else {
+			Copy(bufLength, bus, shadow);
+			world->mAudioBusTouched[channel] = bufCounter;
+		}
+	}
+	world->mAudioBusLocks[channel].unlock();
+}
+
+#endif /* SUPERNOVA */
+
 template <bool LockShared>
 struct AudioBusGuard
 {
@@ -423,8 +496,13 @@ struct AudioBusGuard
 		mCurrentChannel(currentChannel),
 		isValid(currentChannel < maxChannel)
 	{
-		if (isValid)
+		if (isValid) {
+#ifdef SUPERNOVA
+			if (unit->mWorld->mAudioBusShadows)
+				IO_CollectBusShadows(unit->mWorld, currentChannel);
+#endif
 			lock();
+		}
 	}
 
 	~AudioBusGuard()
@@ -454,6 +532,100 @@ struct AudioBusGuard
 	const bool isValid;
 };
 
+#ifndef SUPERNOVA
+
+/* one-pass kernels over all channels of a unit. the audio bus is a flat array
+ * with bufLength samples per channel, so whenever the unit's wire buffers are
+ * laid out back to back the whole channel range can be copied or mixed as a
+ * single wide vector, with one scan of mAudioBusTouched instead of
+ * per-channel bookkeeping. supernova needs its per-channel bus locks, so
+ * there the units keep the channel-at-a-time loops. */
+
+static inline bool In_next_a_wide(IOUnit *unit, int numChannels, int bufLength,
+								  int maxChannel, int32 bufCounter, int inNumSamples)
+{
+	int firstChannel = (int)unit->m_fbusChannel;
+	if (numChannels <= 1 || inNumSamples != bufLength
+		|| firstChannel < 0 || firstChannel + numChannels > maxChannel)
+		return false;
+
+	for (int i=1; i<numChannels; ++i)
+		if (unit->mOutBuf[i] != unit->mOutBuf[i-1] + bufLength)
+			return false;
+
+	const int32 *touched = unit->m_busTouched;
+	int numTouched = 0;
+	for (int i=0; i<numChannels; ++i)
+		if (touched[i] == bufCounter)
+			++numTouched;
+	if (numTouched != 0 && numTouched != numChannels)
+		return false;
+
+	float *out = unit->mOutBuf[0];
+	int wideLength = numChannels * bufLength;
+	if (numTouched) {
+#ifdef NOVA_SIMD
+		if ((wideLength & 15) == 0)
+			nova::copyvec_simd(out, unit->m_bus, wideLength);
+		else
+#endif
+			Copy(wideLength, out, unit->m_bus);
+	} else {
+#ifdef NOVA_SIMD
+		if ((wideLength & 15) == 0)
+			nova::zerovec_simd(out, wideLength);
+		else
+#endif
+			Fill(wideLength, out, 0.f);
+	}
+	return true;
+}
+
+static inline bool Out_next_a_wide(IOUnit *unit, int numChannels, int bufLength,
+								   int maxChannel, int32 bufCounter, int inNumSamples)
+{
+	int firstChannel = (int)unit->m_fbusChannel;
+	if (numChannels <= 1 || inNumSamples != bufLength
+		|| firstChannel < 0 || firstChannel + numChannels > maxChannel)
+		return false;
+
+	for (int i=1; i<numChannels; ++i)
+		if (unit->mInBuf[i+1] != unit->mInBuf[i] + bufLength)
+			return false;
+
+	int32 *touched = unit->m_busTouched;
+	int numTouched = 0;
+	for (int i=0; i<numChannels; ++i)
+		if (touched[i] == bufCounter)
+			++numTouched;
+	if (numTouched != 0 && numTouched != numChannels)
+		return false;
+
+	float *out = unit->m_bus;
+	float *in = unit->mInBuf[1];
+	int wideLength = numChannels * bufLength;
+	if (numTouched) {
+#ifdef NOVA_SIMD
+		if ((wideLength & 15) == 0)
+			nova::addvec_simd(out, in, wideLength);
+		else
+#endif
+			Accum(wideLength, out, in);
+	} else {
+#ifdef NOVA_SIMD
+		if ((wideLength & 15) == 0)
+			nova::copyvec_simd(out, in, wideLength);
+		else
+#endif
+			Copy(wideLength, out, in);
+		for (int i=0; i<numChannels; ++i)
+			touched[i] = bufCounter;
+	}
+	return true;
+}
+
+#endif /* !SUPERNOVA */
+
 #ifdef NOVA_SIMD
 FLATTEN void In_next_a_nova(IOUnit *unit, int inNumSamples)
 {
@@ -463,12 +635,18 @@ FLATTEN void In_next_a_nova(IOUnit *unit, int inNumSamples)
 
 	float fbusChannel = ZIN0(0);
 	IO_a_update_channels(unit, world, fbusChannel, numChannels, bufLength);
+	IO_a_watch_input(unit, fbusChannel, numChannels);
 
 	float *in = unit->m_bus;
 	int32 *touched = unit->m_busTouched;
 	const int32 bufCounter = unit->mWorld->mBufCounter;
 	const int32 maxChannel = world->mNumAudioBusChannels;
 
+#ifndef SUPERNOVA
+	if (In_next_a_wide(unit, numChannels, bufLength, maxChannel, bufCounter, inNumSamples))
+		return;
+#endif
+
 	for (int i=0; i<numChannels; ++i, in += bufLength) {
 		AudioBusGuard<true> guard (unit, fbusChannel + i, maxChannel);
 
@@ -489,12 +667,18 @@ FLATTEN void In_next_a_nova_64(IOUnit *unit, int inNumSamples)
 
 	float fbusChannel = ZIN0(0);
 	IO_a_update_channels(unit, world, fbusChannel, numChannels, bufLength);
+	IO_a_watch_input(unit, fbusChannel, numChannels);
 
 	float *in = unit->m_bus;
 	int32 *touched = unit->m_busTouched;
 	const int32 bufCounter = unit->mWorld->mBufCounter;
 	const int32 maxChannel = world->mNumAudioBusChannels;
 
+#ifndef SUPERNOVA
+	if (In_next_a_wide(unit, numChannels, bufLength, maxChannel, bufCounter, inNumSamples))
+		return;
+#endif
+
 	for (int i=0; i<numChannels; ++i, in += bufLength) {
 		AudioBusGuard<true> guard (unit, fbusChannel + i, maxChannel);
 
@@ -516,12 +700,18 @@ void In_next_a(IOUnit *unit, int inNumSamples)
 
 	float fbusChannel = ZIN0(0);
 	IO_a_update_channels(unit, world, fbusChannel, numChannels, bufLength);
+	IO_a_watch_input(unit, fbusChannel, numChannels);
 
 	float *in = unit->m_bus;
 	int32 *touched = unit->m_busTouched;
 	const int32 bufCounter = unit->mWorld->mBufCounter;
 	const int32 maxChannel = world->mNumAudioBusChannels;
 
+#ifndef SUPERNOVA
+	if (In_next_a_wide(unit, numChannels, bufLength, maxChannel, bufCounter, inNumSamples))
+		return;
+#endif
+
 	for (int i=0; i<numChannels; ++i, in += bufLength) {
 		AudioBusGuard<true> guard (unit, fbusChannel + i, maxChannel);
 
@@ -540,6 +730,7 @@ void vIn_next_a(IOUnit *unit, int inNumSamples)
 
 	float fbusChannel = ZIN0(0);
 	IO_a_update_channels(unit, world, fbusChannel, numChannels, bufLength);
+	IO_a_watch_input(unit, fbusChannel, numChannels);
 
 	float *in = unit->m_bus;
 	int32 *touched = unit->m_busTouched;
@@ -586,6 +777,7 @@ void In_Ctor(IOUnit* unit)
 //Print("->In_Ctor\n");
 	World *world = unit->mWorld;
 	unit->m_fbusChannel = std::numeric_limits<float>::quiet_NaN();
+	unit->m_fwatchedChannel = std::numeric_limits<float>::quiet_NaN();
 
 	if (unit->mCalcRate == calc_FullRate) {
 #ifdef NOVA_SIMD
@@ -671,6 +863,7 @@ void InFeedback_next_a(IOUnit *unit, int inNumSamples)
 
 	float fbusChannel = ZIN0(0);
 	IO_a_update_channels(unit, world, fbusChannel, numChannels, bufLength);
+	IO_a_watch_input(unit, fbusChannel, numChannels);
 
 	float *in = unit->m_bus;
 	int32 *touched = unit->m_busTouched;
@@ -695,6 +888,7 @@ void InFeedback_Ctor(IOUnit* unit)
 //Print("->InFeedback_Ctor\n");
 	World *world = unit->mWorld;
 	unit->m_fbusChannel = -1.;
+	unit->m_fwatchedChannel = std::numeric_limits<float>::quiet_NaN();
 
 	SETCALC(InFeedback_next_a);
 	unit->m_bus = world->mAudioBus;
@@ -886,6 +1080,11 @@ void Out_next_a(IOUnit *unit, int inNumSamples)
 	const int32 bufCounter = unit->mWorld->mBufCounter;
 	const int32 maxChannel = world->mNumAudioBusChannels;
 
+#ifndef SUPERNOVA
+	if (Out_next_a_wide(unit, numChannels, bufLength, maxChannel, bufCounter, inNumSamples))
+		return;
+#endif
+
 	for (int i=0; i<numChannels; ++i, out+=bufLength) {
 		AudioBusGuard<false> guard (unit, fbusChannel + i, maxChannel);
 
@@ -948,6 +1147,11 @@ FLATTEN void Out_next_a_nova(IOUnit *unit, int inNumSamples)
 	const int32 bufCounter = unit->mWorld->mBufCounter;
 	const int32 maxChannel = world->mNumAudioBusChannels;
 
+#ifndef SUPERNOVA
+	if (Out_next_a_wide(unit, numChannels, bufLength, maxChannel, bufCounter, inNumSamples))
+		return;
+#endif
+
 	for (int i=0; i<numChannels; ++i, out+=bufLength) {
 		AudioBusGuard<false> guard (unit, fbusChannel + i, maxChannel);
 
@@ -978,6 +1182,11 @@ FLATTEN void Out_next_a_nova_64(IOUnit *unit, int inNumSamples)
 	const int32 bufCounter = unit->mWorld->mBufCounter;
 	const int32 maxChannel = world->mNumAudioBusChannels;
 
+#ifndef SUPERNOVA
+	if (Out_next_a_wide(unit, numChannels, bufLength, maxChannel, bufCounter, inNumSamples))
+		return;
+#endif
+
 	for (int i=0; i<numChannels; ++i, out+=bufLength) {
 		AudioBusGuard<false> guard (unit, fbusChannel + i, maxChannel);
 
@@ -995,6 +1204,50 @@ FLATTEN void Out_next_a_nova_64(IOUnit *unit, int inNumSamples)
 #endif
 
 
+#ifdef SUPERNOVA
+
+// --bus-shadows mode: mix into this dsp thread's shadow of the bus, wait-free.
+// whoever reads the bus next (or the end-of-tick pass) folds the shadow in.
+void Out_next_a_shadow(IOUnit *unit, int inNumSamples)
+{
+	World *world = unit->mWorld;
+	int bufLength = world->mBufLength;
+	int numChannels = unit->mNumInputs - 1;
+
+	float fbusChannel = ZIN0(0);
+	IO_a_update_channels(unit, world, fbusChannel, numChannels, bufLength);
+
+	const int32 bufCounter = world->mBufCounter;
+	const int32 maxChannel = world->mNumAudioBusChannels;
+	const int32 busChannel = (int32)fbusChannel;
+
+	const uint32 thread = (uint32)unit->mParent->mDspThreadIndex;
+	int32 *tags = world->mAudioBusShadowTouched + thread * maxChannel;
+	float *shadowBase = world->mAudioBusShadows + (size_t)thread * maxChannel * bufLength;
+
+	for (int i=0; i<numChannels; ++i) {
+		int32 channel = busChannel + i;
+		if (channel >= maxChannel)
+			continue;
+
+		float *in = IN(i+1);
+		float *shadow = shadowBase + channel * bufLength;
+		if (tags[channel] == bufCounter) {
+#ifdef NOVA_SIMD
+			if (!(inNumSamples & 15))
+				nova::addvec_simd(shadow, in, inNumSamples);
+			else
+#endif
+			Accum(inNumSamples, shadow, in);
+		} else {
+			Copy(inNumSamples, shadow, in);
+			tags[channel] = bufCounter;
+		}
+	}
+}
+
+#endif /* SUPERNOVA */
+
 void Out_next_k(IOUnit *unit, int inNumSamples)
 {
 	World *world = unit->mWorld;
@@ -1031,6 +1284,15 @@ void Out_Ctor(IOUnit* unit)
 
 	if (unit->mCalcRate == calc_FullRate) {
 
+#ifdef SUPERNOVA
+		if (world->mAudioBusShadows) {
+			SETCALC(Out_next_a_shadow);
+			unit->m_bus = world->mAudioBus;
+			unit->m_busTouched = world->mAudioBusTouched;
+			return;
+		}
+#endif
+
 #if defined(NOVA_SIMD)
 		if (BUFLENGTH == 64)
 			SETCALC(Out_next_a_nova_64);
@@ -3059,6 +3059,38 @@ static inline void EnvGen_perform(EnvGen * unit, float *& out, double & level, i
 	EnvGen_perform<false>( unit, out, level, nsmps, [](int i) { return true;});
 }
 
+#ifdef NOVA_SIMD
+// run one span with a shape-specialised kernel. the three shapes that
+// dominate real defs write the whole span at once even when a segment
+// boundary falls inside the block; the remaining shapes are recursive
+// filters and keep the scalar loop.
+static inline void EnvGen_perform_vec(EnvGen * unit, float *& out, double & level, int nsmps)
+{
+	switch (unit->m_shape) {
+	case shape_Step :
+	case shape_Hold :
+	case shape_Sustain :
+		nova::setvec(out + 1, (float)level, nsmps);
+		out += nsmps;
+		break;
+	case shape_Linear : {
+		double slope = unit->m_grow;
+		nova::set_slope_vec(out + 1, (float)level, (float)slope, nsmps);
+		level += nsmps * slope;
+		out += nsmps;
+	} break;
+	case shape_Exponential : {
+		double grow = unit->m_grow;
+		nova::set_exp_vec(out + 1, (float)level, (float)grow, nsmps);
+		level *= sc_powi(grow, nsmps);
+		out += nsmps;
+	} break;
+	default :
+		EnvGen_perform(unit, out, level, nsmps);
+	}
+}
+#endif
+
 
 void EnvGen_next_k(EnvGen *unit, int inNumSamples)
 {
@@ -3168,7 +3200,7 @@ FLATTEN void EnvGen_next_ak_nova(EnvGen *unit, int inNumSamples)
 		}
 
 		int nsmps = sc_min(remain, counter);
-		EnvGen_perform( unit, out, level, nsmps );
+		EnvGen_perform_vec( unit, out, level, nsmps );
 
 		remain -= nsmps;
 		counter -= nsmps;
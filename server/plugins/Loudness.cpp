@@ -107,6 +107,10 @@ void Loudness_dofft(Loudness *unit, uint32 ibufnum)
 	LOCK_SNDBUF(buf);
 
 	float * data= buf->data;
+	int numbins = (buf->samples - 2) >> 1;
+
+	// bin powers are shared between all listeners on this chain
+	const float * binpowers= ML_GetBinPowers((Unit*)unit, buf, ibufnum);
 
 	float loudsum=0.0;
 
@@ -126,11 +130,15 @@ void Loudness_dofft(Loudness *unit, uint32 ibufnum)
 		float lastpower=0.0;
 
 		for (int h=bandstart; h<bandend;++h) {
-			index = 2*h;
-			real= data[index];
-			imag= data[index+1];
-
-			power = (real*real) + (imag*imag);
+			if(binpowers && h<=numbins) {
+				power = binpowers[h];
+			} else {
+				index = 2*h;
+				real= data[index];
+				imag= data[index+1];
+
+				power = (real*real) + (imag*imag);
+			}
 
 
 			//would involve spectral masking here
@@ -57,7 +57,7 @@ float dct[1764]=  {0.9993007047884, 0.99371220989324, 0.98256647323329, 0.965925
 //other functions
 static void MFCC_dofft(MFCC *, uint32);
 
-static float MFCC_prepareMel(MFCC *, float *);
+static float MFCC_prepareMel(MFCC *, float *, const float *);
 //float MFCC_prepareERB(MFCC *, float *);
 
 
@@ -166,7 +166,13 @@ void MFCC_dofft(MFCC *unit, uint32 ibufnum)
 
 	float * data= buf->data;
 
-	float mult= MFCC_prepareMel(unit, data);
+	// bin powers are shared between all listeners on this chain
+	const float * binpowers= ML_GetBinPowers((Unit*)unit, buf, ibufnum);
+	int numbins = (buf->samples - 2) >> 1;
+	if (binpowers && unit->m_endbin[unit->m_numbands-1] - 1 > numbins)
+		binpowers = 0; // band tables reach past this frame; compute privately
+
+	float mult= MFCC_prepareMel(unit, data, binpowers);
 	//MFCC_prepareERB
 
 	float * pbands= unit->m_bands;
@@ -192,7 +198,7 @@ void MFCC_dofft(MFCC *unit, uint32 ibufnum)
 }
 
 
-float MFCC_prepareMel(MFCC * unit, float * data)
+float MFCC_prepareMel(MFCC * unit, float * data, const float * binpowers)
 {
 	float * pbands= unit->m_bands;
 
@@ -213,14 +219,18 @@ float MFCC_prepareMel(MFCC * unit, float * data)
 		index2= cumulindex[k] - bandstart;
 
 		for (int j=bandstart; j < bandend; ++j) {
-			index = j+j;
-			real= data[index];
-			imag= data[index+1];
-
-			if(j==0)
-				power= real*real; //sc_abs(real); //dc
-			else
-				power = real*real + imag*imag; //sqrt((real*real) + (imag*imag));
+			if(binpowers) {
+				power = binpowers[j];
+			} else {
+				index = j+j;
+				real= data[index];
+				imag= data[index+1];
+
+				if(j==0)
+					power= real*real; //sc_abs(real); //dc
+				else
+					power = real*real + imag*imag; //sqrt((real*real) + (imag*imag));
+			}
 
 			float multiplier = weights[index2 + j]; //[cumulindex[k] + (j-bandstart)]
 
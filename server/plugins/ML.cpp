@@ -25,6 +25,125 @@
 
 InterfaceTable *ft;
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+// shared spectral frame cache: see the comment in ML.h. entries are keyed by
+// (world, buffer number) and valid for the control block in which the hop
+// arrived, which is when every listener on a chain runs. the arrays grow to
+// the largest FFT size seen for a buffer and are never returned to the pool;
+// the table is bounded, so this is a few hundred KB at worst.
+
+struct MLSpectralFrame
+{
+	World *mWorld;
+	uint32 m_bufnum;
+	int m_bufcounter;	// World::mBufCounter when the frame was computed
+	int m_numbins;
+	int m_maxbins;		// capacity of the arrays, in bins + 1
+	bool m_hasMags;
+	float *m_powers;
+	float *m_mags;
+};
+
+const int kMaxSpectralFrames = 32;
+static MLSpectralFrame gSpectralFrames[kMaxSpectralFrames];
+static int gNumSpectralFrames = 0;
+
+static MLSpectralFrame* ML_GetFrame(Unit *unit, SndBuf *buf, uint32 ibufnum)
+{
+#ifdef SUPERNOVA
+	// graphs evaluate in parallel; no shared frame cache
+	return 0;
+#else
+	World *world = unit->mWorld;
+	int numbins = (buf->samples - 2) >> 1;
+	if (numbins < 1)
+		return 0;
+
+	MLSpectralFrame *entry = 0;
+	for (int i = 0; i < gNumSpectralFrames; ++i) {
+		MLSpectralFrame *candidate = gSpectralFrames + i;
+		if (candidate->mWorld == world && candidate->m_bufnum == ibufnum) {
+			entry = candidate;
+			break;
+		}
+	}
+	if (!entry) {
+		if (gNumSpectralFrames == kMaxSpectralFrames)
+			return 0; // table full: callers compute privately
+		entry = gSpectralFrames + gNumSpectralFrames++;
+		memset(entry, 0, sizeof(MLSpectralFrame));
+		entry->mWorld = world;
+		entry->m_bufnum = ibufnum;
+		entry->m_bufcounter = -1;
+	}
+
+	if (entry->m_maxbins < numbins + 1) {
+		float *data = (float*)RTAlloc(world, 2 * (numbins + 1) * sizeof(float));
+		if (!data)
+			return 0;
+		if (entry->m_powers)
+			RTFree(world, entry->m_powers);
+		entry->m_powers = data;
+		entry->m_mags = data + numbins + 1;
+		entry->m_maxbins = numbins + 1;
+		entry->m_bufcounter = -1;
+	}
+
+	if (entry->m_bufcounter != (int)world->mBufCounter || entry->m_numbins != numbins) {
+		entry->m_numbins = numbins;
+		entry->m_bufcounter = (int)world->mBufCounter;
+		float *powers = entry->m_powers;
+		// derive from whichever representation the chain is currently in, so
+		// the cache never forces a complex<->polar round trip
+		if (buf->coord == coord_Polar) {
+			SCPolarBuf *p = (SCPolarBuf*)buf->data;
+			powers[0] = p->dc * p->dc;
+			float *mags = entry->m_mags;
+			mags[0] = sc_abs(p->dc);
+			for (int h = 0; h < numbins; ++h) {
+				float mag = sc_abs(p->bin[h].mag);
+				mags[h+1] = mag;
+				powers[h+1] = mag * mag;
+			}
+			entry->m_hasMags = true;
+		} else {
+			SCComplexBuf *p = ToComplexApx(buf);
+			powers[0] = p->dc * p->dc;
+			for (int h = 0; h < numbins; ++h) {
+				float real = p->bin[h].real;
+				float imag = p->bin[h].imag;
+				powers[h+1] = real*real + imag*imag;
+			}
+			entry->m_hasMags = false;
+		}
+	}
+
+	return entry;
+#endif
+}
+
+const float* ML_GetBinPowers(Unit *unit, SndBuf *buf, uint32 ibufnum)
+{
+	MLSpectralFrame *entry = ML_GetFrame(unit, buf, ibufnum);
+	return entry ? entry->m_powers : 0;
+}
+
+const float* ML_GetBinMags(Unit *unit, SndBuf *buf, uint32 ibufnum)
+{
+	MLSpectralFrame *entry = ML_GetFrame(unit, buf, ibufnum);
+	if (!entry)
+		return 0;
+	if (!entry->m_hasMags) {
+		for (int h = 0; h < entry->m_numbins + 1; ++h)
+			entry->m_mags[h] = std::sqrt(entry->m_powers[h]);
+		entry->m_hasMags = true;
+	}
+	return entry->m_mags;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 PluginLoad(ML_UGens)
 {
 	ft = inTable;
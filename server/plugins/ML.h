@@ -34,6 +34,19 @@ extern int eqlbandsizes[42];
 extern float contours[42][11];
 extern double phons[11];
 
+// shared spectral frame cache (ML.cpp). several listeners commonly watch the
+// same FFT chain, and each used to derive bin magnitudes from the raw frame
+// privately; these getters compute them once per hop and share the result
+// between all units reading that buffer in the same control block.
+//
+// indexing matches how the analyzers address SCComplexBuf data by pair:
+// powers[0] is the squared dc component and powers[h] (1 <= h <= numbins) the
+// squared magnitude of bin h-1; mags[] holds the square roots of powers[].
+// both return NULL when the cache is unavailable, in which case the caller
+// computes privately as before.
+const float* ML_GetBinPowers(Unit *unit, SndBuf *buf, uint32 ibufnum);
+const float* ML_GetBinMags(Unit *unit, SndBuf *buf, uint32 ibufnum);
+
 //#include "KeyTrack.h"
 #include "BeatTrack.h"
 //#include "Loudness.h"
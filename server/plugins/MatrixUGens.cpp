@@ -0,0 +1,197 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+
+#include "SC_PlugIn.h"
+#include "function_attributes.h"
+
+#ifdef NOVA_SIMD
+#include "simd_memory.hpp"
+#include "simd_binary_arithmetic.hpp"
+using nova::slope_argument;
+
+#endif
+
+static InterfaceTable *ft;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+	MatrixMix - a dense matrix mixer.
+
+	Multichannel transforms like ambisonic rotations and decodes are dense
+	matrix products, and building them from networks of *, + and MulAdd ugens
+	pays graph dispatch and wire buffer traffic for every coefficient. This
+	ugen computes all of (out_m = sum_n coef[m][n] * in_n) in one pass over
+	the inputs.
+
+	The coefficients live in a buffer (rows = outputs, columns = inputs,
+	read flat as coef[m * numInputs + n]) so a 64 x 64 matrix is a single
+	input, not 4096 of them, and can be rewritten on the fly with b_setn or
+	from another ugen. Coefficients that changed since the previous block
+	ramp linearly across the block; coefficients that are zero and stay zero
+	are skipped entirely, so sparse matrices cost only what they use.
+*/
+
+struct MatrixMix : public Unit
+{
+	float m_fbufnum;
+	SndBuf *m_buf;
+	int m_numInputs;
+	float *m_prevCoefs;	// mNumOutputs * m_numInputs, matrix state of the previous block
+	float *m_inputs;	// m_numInputs contiguous blocks of gathered input samples
+	bool m_coefsInit;
+};
+
+extern "C"
+{
+	void MatrixMix_next(MatrixMix *unit, int inNumSamples);
+	void MatrixMix_Ctor(MatrixMix* unit);
+	void MatrixMix_Dtor(MatrixMix* unit);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MatrixMix_Ctor(MatrixMix* unit)
+{
+	int numInputs = unit->mNumInputs - 1;
+	int numCoefs = unit->mNumOutputs * numInputs;
+
+	unit->m_fbufnum = -1e9f;
+	unit->m_numInputs = numInputs;
+	unit->m_coefsInit = false;
+	unit->m_prevCoefs = (float*)RTAlloc(unit->mWorld, numCoefs * sizeof(float));
+	unit->m_inputs = (float*)RTAlloc(unit->mWorld, numInputs * unit->mWorld->mBufLength * sizeof(float));
+
+	if (!unit->m_prevCoefs || !unit->m_inputs) {
+		Print("MatrixMix: RT memory allocation failed\n");
+		SETCALC(ClearUnitOutputs);
+		ClearUnitOutputs(unit, 1);
+		return;
+	}
+
+	SETCALC(MatrixMix_next);
+	ClearUnitOutputs(unit, 1);
+}
+
+void MatrixMix_Dtor(MatrixMix* unit)
+{
+	RTFree(unit->mWorld, unit->m_prevCoefs);
+	RTFree(unit->mWorld, unit->m_inputs);
+}
+
+void MatrixMix_next(MatrixMix *unit, int inNumSamples)
+{
+	GET_BUF_SHARED
+
+	int numInputs = unit->m_numInputs;
+	int numOutputs = unit->mNumOutputs;
+	float *prevCoefs = unit->m_prevCoefs;
+	float slopeFactor = unit->mRate->mSlopeFactor;
+
+	// gather the inputs into one contiguous block. this keeps the inner
+	// kernel streaming through cache lines in order, and decouples the
+	// outputs from input wire buffers the graph may have recycled for them.
+	float *gathered = unit->m_inputs;
+	for (int n = 0; n < numInputs; ++n) {
+#ifdef NOVA_SIMD
+		if (!(inNumSamples & 15))
+			nova::copyvec_simd(gathered + n * inNumSamples, IN(1 + n), inNumSamples);
+		else
+#endif
+		Copy(inNumSamples, gathered + n * inNumSamples, IN(1 + n));
+	}
+
+	if (!unit->m_coefsInit) {
+		// first block: start every coefficient at its current value
+		for (int i = 0; i < numOutputs * numInputs; ++i)
+			prevCoefs[i] = (uint32)i < bufSamples ? bufData[i] : 0.f;
+		unit->m_coefsInit = true;
+	}
+
+	for (int m = 0; m < numOutputs; ++m) {
+		float *out = OUT(m);
+		bool wrote = false;
+
+		for (int n = 0; n < numInputs; ++n) {
+			int ci = m * numInputs + n;
+			float coef = (uint32)ci < bufSamples ? bufData[ci] : 0.f;
+			float prev = prevCoefs[ci];
+			if (coef == 0.f && prev == 0.f)
+				continue;	// silent entries of a sparse matrix cost nothing
+			prevCoefs[ci] = coef;
+
+			const float *in = gathered + n * inNumSamples;
+			float slope = (coef - prev) * slopeFactor;
+
+			if (!wrote) {
+				wrote = true;
+#ifdef NOVA_SIMD
+				if (!(inNumSamples & 15)) {
+					if (slope == 0.f)
+						nova::times_vec_simd(out, in, coef, inNumSamples);
+					else
+						nova::times_vec_simd(out, in, slope_argument(prev, slope), inNumSamples);
+					continue;
+				}
+#endif
+				if (slope == 0.f) {
+					for (int k = 0; k < inNumSamples; ++k)
+						out[k] = coef * in[k];
+				} else {
+					float c = prev;
+					for (int k = 0; k < inNumSamples; ++k) {
+						out[k] = c * in[k];
+						c += slope;
+					}
+				}
+			} else {
+				if (slope == 0.f) {
+					for (int k = 0; k < inNumSamples; ++k)
+						out[k] += coef * in[k];
+				} else {
+					float c = prev;
+					for (int k = 0; k < inNumSamples; ++k) {
+						out[k] += c * in[k];
+						c += slope;
+					}
+				}
+			}
+		}
+
+		if (!wrote) {
+#ifdef NOVA_SIMD
+			if (!(inNumSamples & 15))
+				nova::zerovec_simd(out, inNumSamples);
+			else
+#endif
+			Clear(inNumSamples, out);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PluginLoad(Matrix)
+{
+	ft = inTable;
+
+	DefineDtorUnit(MatrixMix);
+}
@@ -25,10 +25,12 @@ static InterfaceTable *ft;
 
 struct WhiteNoise : public Unit
 {
+	RGen4 mRGen4;
 };
 
 struct ClipNoise : public Unit
 {
+	RGen4 mRGen4;
 };
 
 struct BrownNoise : public Unit
@@ -38,6 +40,7 @@ struct BrownNoise : public Unit
 
 struct PinkNoise : public Unit
 {
+	RGen4 mRGen4;
 	uint32 mDice[16];
 	int32 mTotal;
 };
@@ -237,17 +240,28 @@ extern "C"
 void ClipNoise_next(ClipNoise *unit, int inNumSamples)
 {
 	float *out = ZOUT(0);
-
-	RGET
-	LOOP1(inNumSamples,
-		ZXP(out) = fcoin(s1, s2, s3);
+	RGen4 & rgen = unit->mRGen4;
+
+	float val[4];
+	LOOP(inNumSamples >> 2,
+		rgen.fcoin(val);
+		ZXP(out) = val[0];
+		ZXP(out) = val[1];
+		ZXP(out) = val[2];
+		ZXP(out) = val[3];
 	);
-	RPUT
+	int remain = inNumSamples & 3;
+	if (remain) {
+		rgen.fcoin(val);
+		for (int i=0; i<remain; ++i)
+			ZXP(out) = val[i];
+	}
 }
 
 void ClipNoise_Ctor(ClipNoise* unit)
 {
 	SETCALC(ClipNoise_next);
+	unit->mRGen4.init(*unit->mParent->mRGen);
 
 	ClipNoise_next(unit, 1);
 }
@@ -282,17 +296,28 @@ void GrayNoise_Ctor(GrayNoise* unit)
 void WhiteNoise_next(WhiteNoise *unit, int inNumSamples)
 {
 	float *out = ZOUT(0);
-
-	RGET
-	LOOP1(inNumSamples,
-		ZXP(out) = frand2(s1, s2, s3);
+	RGen4 & rgen = unit->mRGen4;
+
+	float val[4];
+	LOOP(inNumSamples >> 2,
+		rgen.frand2(val);
+		ZXP(out) = val[0];
+		ZXP(out) = val[1];
+		ZXP(out) = val[2];
+		ZXP(out) = val[3];
 	);
-	RPUT
+	int remain = inNumSamples & 3;
+	if (remain) {
+		rgen.frand2(val);
+		for (int i=0; i<remain; ++i)
+			ZXP(out) = val[i];
+	}
 }
 
 void WhiteNoise_Ctor(WhiteNoise* unit)
 {
 	SETCALC(WhiteNoise_next);
+	unit->mRGen4.init(*unit->mParent->mRGen);
 
 	WhiteNoise_next(unit, 1);
 }
@@ -300,34 +325,49 @@ void WhiteNoise_Ctor(WhiteNoise* unit)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+static inline float PinkNoise_step(uint32 counter, uint32 newrand, uint32 & total, uint32 * dice)
+{
+	// Magnus Jonsson's suggestion.
+	uint32 diceroll = counter >> 13;
+	int k = (CTZ(counter)) & 15;
+	uint32 prevrand = dice[k];
+	dice[k] = diceroll;
+	total += (diceroll - prevrand);
+	elem32 val; // ensure write before read <sk>
+	val.u = (total + (newrand >> 13)) | 0x40000000;
+	return val.f - 3.0f;
+}
+
 void PinkNoise_next(PinkNoise *unit, int inNumSamples)
 {
 	float *out = ZOUT(0);
-
-	RGET
+	RGen4 & rgen = unit->mRGen4;
 
 	uint32 total = unit->mTotal;
 	uint32 *dice = unit->mDice;
-	LOOP1(inNumSamples,
-		uint32 counter = trand(s1,s2,s3); // Magnus Jonsson's suggestion.
-		uint32 newrand = counter >> 13;
-		int k = (CTZ(counter)) & 15;
-		uint32 prevrand = dice[k];
-		dice[k] = newrand;
-		total += (newrand - prevrand);
-		newrand = trand(s1,s2,s3) >> 13;
-		elem32 val; // ensure write before read <sk>
-		val.u = (total + newrand) | 0x40000000;
-		ZXP(out) = val.f - 3.0f;
-		counter ++;
+
+	uint32 counter[4], newrand[4];
+	LOOP(inNumSamples >> 2,
+		// the variates come four at a time; the dice table update stays scalar
+		rgen.trand(counter);
+		rgen.trand(newrand);
+		for (int i=0; i<4; ++i)
+			ZXP(out) = PinkNoise_step(counter[i], newrand[i], total, dice);
 	);
+	int remain = inNumSamples & 3;
+	if (remain) {
+		rgen.trand(counter);
+		rgen.trand(newrand);
+		for (int i=0; i<remain; ++i)
+			ZXP(out) = PinkNoise_step(counter[i], newrand[i], total, dice);
+	}
 	unit->mTotal = total;
-	RPUT
 }
 
 void PinkNoise_Ctor(PinkNoise* unit)
 {
 	SETCALC(PinkNoise_next);
+	unit->mRGen4.init(*unit->mParent->mRGen);
 
 	RGET
 	uint32 *dice = unit->mDice;
@@ -1402,6 +1402,92 @@ void SinOsc_next_ikk(SinOsc *unit, int inNumSamples)
 	Osc_ikk_perform<SinOsc, 0>(unit, table0, table1, inNumSamples);
 }
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(__AVX2__)
+#define SC_OSC_AVX2_DISPATCH
+
+/* AVX2 kernel for the ikk oscillators, selected at runtime.
+ *
+ * With fixed freq and phase inputs the phase increment is constant over the
+ * block, so eight phases can be computed at once and the wavetable pairs
+ * fetched with a gather; the interpolation itself is the same bit-level
+ * arithmetic as lookupi1. This is the steady state of additive patches built
+ * from thousands of SinOscs, where the serial phase/lookup chain dominates.
+ * The audio-rate variants keep the scalar loops: their phase offsets depend
+ * on the input signal and gain nothing from batching.
+ */
+
+#include <immintrin.h>
+
+static bool cpu_has_avx2(void)
+{
+	static const bool result = __builtin_cpu_supports("avx2");
+	return result;
+}
+
+__attribute__((target("avx2")))
+static void Osc_ikk_loop_avx2(float *out, const float * table0, const float * table1,
+							  int32 & ioPhase, int32 phaseinc, int32 lomask, int inNumSamples)
+{
+	int32 phase = ioPhase;
+	int i = 0;
+
+	const __m256i vstep = _mm256_set1_epi32((int32)((uint32)phaseinc * 8u));
+	const __m256i vfracmask = _mm256_set1_epi32(0x007FFF80);
+	const __m256i vfracone = _mm256_set1_epi32(0x3F800000);
+	const __m256i vlomask = _mm256_set1_epi32(lomask);
+	__m256i vphase = _mm256_add_epi32(_mm256_set1_epi32(phase),
+		_mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+						   _mm256_set1_epi32(phaseinc)));
+
+	for (; i <= inNumSamples - 8; i += 8) {
+		// PhaseFrac1 on 8 lanes
+		__m256 vfrac = _mm256_castsi256_ps(_mm256_or_si256(vfracone,
+			_mm256_and_si256(_mm256_slli_epi32(vphase, 7), vfracmask)));
+		// lomask is a byte offset mask, so gather with scale 1
+		__m256i vindex = _mm256_and_si256(_mm256_srli_epi32(vphase, xlobits1), vlomask);
+		__m256 val1 = _mm256_i32gather_ps(table0, vindex, 1);
+		__m256 val2 = _mm256_i32gather_ps(table1, vindex, 1);
+		_mm256_storeu_ps(out + i, _mm256_add_ps(val1, _mm256_mul_ps(val2, vfrac)));
+		vphase = _mm256_add_epi32(vphase, vstep);
+	}
+
+	phase = (int32)((uint32)phase + (uint32)phaseinc * (uint32)i);
+	for (; i < inNumSamples; ++i) {
+		out[i] = lookupi1(table0, table1, phase, lomask);
+		phase = (int32)((uint32)phase + (uint32)phaseinc);
+	}
+	ioPhase = phase;
+}
+
+template <typename OscType, int FreqInputIndex>
+force_inline void Osc_ikk_perform_avx2(OscType *unit, const float * table0, const float * table1, int inNumSamples)
+{
+	float *out = OUT(0);
+	float freqin = ZIN0(FreqInputIndex);
+	float phasein = ZIN0(FreqInputIndex + 1);
+
+	int32 phase = unit->m_phase;
+	int32 lomask = unit->m_lomask;
+
+	int32 freq = (int32)(unit->m_cpstoinc * freqin);
+	int32 phaseinc = freq + (int32)(CALCSLOPE(phasein, unit->m_phasein) * unit->m_radtoinc);
+	unit->m_phasein = phasein;
+
+	Osc_ikk_loop_avx2(out, table0, table1, phase, phaseinc, lomask, inNumSamples);
+	unit->m_phase = phase;
+}
+
+void SinOsc_next_ikk_avx2(SinOsc *unit, int inNumSamples)
+{
+	float *table0 = ft->mSineWavetable;
+	float *table1 = table0 + 1;
+
+	Osc_ikk_perform_avx2<SinOsc, 0>(unit, table0, table1, inNumSamples);
+}
+
+void Osc_next_ikk_avx2(Osc *unit, int inNumSamples);
+
+#endif /* SC_OSC_AVX2_DISPATCH */
 
 template <typename OscType, int FreqInputIndex>
 force_inline void Osc_ika_perform(OscType *unit, const float * table0, const float * table1, int inNumSamples)
@@ -1561,7 +1647,14 @@ void SinOsc_Ctor(SinOsc *unit)
 			SETCALC(SinOsc_next_ika);
 			unit->m_phase = 0;
 		} else {
+#ifdef SC_OSC_AVX2_DISPATCH
+			if (cpu_has_avx2())
+				SETCALC(SinOsc_next_ikk_avx2);
+			else
+				SETCALC(SinOsc_next_ikk);
+#else
 			SETCALC(SinOsc_next_ikk);
+#endif
 			unit->m_phase = (int32)(unit->m_phasein * unit->m_radtoinc);
 		}
 	}
@@ -1669,7 +1762,14 @@ void Osc_Ctor(Osc *unit)
 			unit->m_phase = 0;
 		} else {
 			//Print("next_ikk\n");
+#ifdef SC_OSC_AVX2_DISPATCH
+			if (cpu_has_avx2())
+				SETCALC(Osc_next_ikk_avx2);
+			else
+				SETCALC(Osc_next_ikk);
+#else
 			SETCALC(Osc_next_ikk);
+#endif
 			unit->m_phase = (int32)(unit->m_phasein * unit->m_radtoinc);
 		}
 	}
@@ -1711,6 +1811,18 @@ void Osc_next_ikk(Osc *unit, int inNumSamples)
 	Osc_ikk_perform<Osc, 1>(unit, table0, table1, inNumSamples);
 }
 
+#ifdef SC_OSC_AVX2_DISPATCH
+void Osc_next_ikk_avx2(Osc *unit, int inNumSamples)
+{
+	const float * table0;
+	const float * table1;
+	bool tableValid = Osc_get_table(unit, table0, table1, inNumSamples);
+	if (!tableValid) return;
+
+	Osc_ikk_perform_avx2<Osc, 1>(unit, table0, table1, inNumSamples);
+}
+#endif
+
 void Osc_next_ika(Osc *unit, int inNumSamples)
 {
 	const float * table0;
@@ -3539,12 +3651,30 @@ static void normalize_wsamples(int size, float* data, float peak)
 	}
 }
 
+// the sine fills advance by the recurrence
+//     sin(p + (i+1)w) = 2 cos(w) sin(p + iw) - sin(p + (i-1)w)
+// so a table point costs one multiply-add instead of a libm sin(). double
+// precision drift grows with the table, so the recurrence is reseeded from
+// sin() every kSineReseedInterval points: a 64k fill makes a few dozen
+// transcendental calls instead of 64k.
+static const int kSineReseedInterval = 4096;
+
 static void add_partial(int size, float *data, double partial, double amp, double phase)
 {
 	if (amp == 0.0) return;
 	double w = (partial * 2.0 * 3.1415926535897932384626433832795) / (double)size;
+	double c = 2.0 * cos(w);
+	double y1 = amp * sin(phase - w);
+	double y0 = amp * sin(phase);
 	for (int i=0; i<size; ++i) {
-		data[i] += amp * sin(phase);
+		if (i && (i & (kSineReseedInterval-1)) == 0) {
+			y1 = amp * sin(phase - w);
+			y0 = amp * sin(phase);
+		}
+		data[i] += y0;
+		double y2 = y1;
+		y1 = y0;
+		y0 = c * y1 - y2;
 		phase += w;
 	}
 }
@@ -3554,44 +3684,80 @@ static void add_wpartial(int size, float *data, double partial, double amp, doub
 	if (amp == 0.0) return;
 	int size2 = size >> 1;
 	double w = (partial * 2.0 * 3.1415926535897932384626433832795) / (double)size2;
+	double c = 2.0 * cos(w);
+	double prev = amp * sin(phase - w);
 	double cur = amp * sin(phase);
 	phase += w;
+	int n = 0;
 	for (int i=0; i<size; i+=2) {
-		double next = amp * sin(phase);
+		double next;
+		if ((++n & (kSineReseedInterval-1)) == 0)
+			next = amp * sin(phase);
+		else
+			next = c * cur - prev;
 		data[i] += 2 * cur - next;
 		data[i+1] += next - cur;
+		prev = cur;
 		cur = next;
 		phase += w;
 	}
 }
 
-static void add_chebyshev(int size, float *data, double partial, double amp)
+// sum of all requested Chebyshev partials at one point, by the recurrence
+// T_k(x) = 2x T_{k-1}(x) - T_{k-2}(x). amps[k] weights T_{k+1}; the offset
+// (precomputed by the callers) keeps the table zero at x = 0 as the old
+// cos(partial * acos(x)) form did.
+static inline double chebyshev_sum(double x, int npartials, const double *amps, double offset)
 {
-	if (amp == 0.0) return;
+	double sum = offset;
+	double tkm1 = 1.0;
+	double tk = x;
+	for (int k=0; k<npartials; ++k) {
+		sum += amps[k] * tk;
+		double tkp1 = 2.0 * x * tk - tkm1;
+		tkm1 = tk;
+		tk = tkp1;
+	}
+	return sum;
+}
+
+static double chebyshev_offset(int npartials, const double *amps)
+{
+	double offset = 0.0;
+	for (int k=0; k<npartials; ++k)
+		offset -= amps[k] * cos((k+1) * pi2);
+	return offset;
+}
+
+// all partials in a single pass over the table; polynomial recurrence per
+// point instead of an acos/cos pair per partial per point
+static void add_chebyshevs(int size, float *data, int npartials, const double *amps)
+{
+	if (npartials <= 0) return;
 	double w = 2.0 / (double)size;
-	double phase = -1.0;
-	double offset = -amp * cos (partial * pi2);
+	double offset = chebyshev_offset(npartials, amps);
+	double x = -1.0;
 	for (int i=0; i<size; ++i) {
-		data[i] += amp * cos (partial * acos (phase)) + offset;
-		phase += w;
+		data[i] += chebyshev_sum(x, npartials, amps, offset);
+		x += w;
 	}
 }
 
-static void add_wchebyshev(int size, float *data, double partial, double amp)
+static void add_wchebyshevs(int size, float *data, int npartials, const double *amps)
 {
-	if (amp == 0.0) return;
+	if (npartials <= 0) return;
 	int size2 = size >> 1;
 	double w = 2.0 / (double)size2;
-	double phase = -1.0;
-	double offset = -amp * cos (partial * pi2);
-	double cur = amp * cos (partial * acos (phase)) + offset;
-	phase += w;
+	double offset = chebyshev_offset(npartials, amps);
+	double x = -1.0;
+	double cur = chebyshev_sum(x, npartials, amps, offset);
+	x += w;
 	for (int i=0; i<size; i+=2) {
-		double next = amp * cos (partial * acos (phase)) + offset;
+		double next = chebyshev_sum(x, npartials, amps, offset);
 		data[i] += 2 * cur - next;
 		data[i+1] += next - cur;
 		cur = next;
-		phase += w;
+		x += w;
 	}
 }
 
@@ -3629,12 +3795,18 @@ void ChebyFill(World *world, struct SndBuf *buf, struct sc_msg_iter *msg)
 	if (flags & flag_Clear) Fill(size, data, 0.);
 	else memcpy(data, buf->data, byteSize);
 
-	for (int partial=1; msg->remain(); partial++) {
-		double amp = msg->getf();
-		if (flags & flag_Wavetable) add_wchebyshev(size, data, partial, amp);
-		else add_chebyshev(size, data, partial, amp);
+	int maxpartials = msg->remain() / sizeof(float) + 1;
+	double *amps = (double*)malloc(maxpartials * sizeof(double));
+	int npartials = 0;
+	while (msg->remain() && npartials < maxpartials) {
+		amps[npartials++] = msg->getf();
 	}
 
+	if (flags & flag_Wavetable) add_wchebyshevs(size, data, npartials, amps);
+	else add_chebyshevs(size, data, npartials, amps);
+
+	free(amps);
+
 	if (flags & flag_Normalize) {
 		if (flags & flag_Wavetable) normalize_wsamples(size, data, 1.);
 		else normalize_samples(size, data, 1.);
@@ -3796,6 +3968,36 @@ void CopyBuf(World *world, struct SndBuf *buf, struct sc_msg_iter *msg)
 	}
 }
 
+// crossfades two source buffers into the target:
+//     target = (1 - fraction) * bufA + fraction * bufB
+// the wavetable encoding is linear in the samples, so morphing works the
+// same for plain and wavetable-format tables. with the partials cached in
+// two tables, a live morph costs one pass of multiply-adds instead of a
+// full transcendental refill.
+void MorphBuf(World *world, struct SndBuf *buf, struct sc_msg_iter *msg)
+{
+	uint32 bufnumA = msg->geti();
+	uint32 bufnumB = msg->geti();
+	float fraction = msg->getf();
+
+	if (bufnumA >= world->mNumSndBufs || bufnumB >= world->mNumSndBufs) return;
+
+	SndBuf *bufA = world->mSndBufs + bufnumA;
+	SndBuf *bufB = world->mSndBufs + bufnumB;
+	if (!bufA->data || !bufB->data) return;
+
+	int size = sc_min(buf->samples, sc_min(bufA->samples, bufB->samples));
+	float ampB = sc_clip(fraction, 0.f, 1.f);
+	float ampA = 1.f - ampB;
+
+	float *data = buf->data;
+	float *a = bufA->data;
+	float *b = bufB->data;
+	for (int i=0; i<size; ++i) {
+		data[i] = ampA * a[i] + ampB * b[i];
+	}
+}
+
 void CantorFill(World *world, struct SndBuf *buf, struct sc_msg_iter *msg)
 {
 	float *data = buf->data;
@@ -3847,6 +4049,7 @@ PluginLoad(Osc)
 	DefineBufGen("normalize", NormalizeBuf);
 	DefineBufGen("wnormalize", NormalizeWaveBuf);
 	DefineBufGen("copy", CopyBuf);
+	DefineBufGen("morph", MorphBuf);
 	DefineBufGen("cantorFill", CantorFill);
 }
 
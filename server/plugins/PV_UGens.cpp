@@ -21,6 +21,14 @@
 
 #include "FFT_UGens.h"
 
+#ifdef NOVA_SIMD
+#include "simd_binary_arithmetic.hpp"
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define TWOPI 6.28318530717952646f
 
 struct PV_OutOfPlace : Unit
@@ -236,6 +244,26 @@ SCComplexBuf* ToComplexApx(SndBuf *buf)
 }
 */
 
+#ifdef __SSE2__
+// multiply the magnitude lanes of interleaved (mag, phase) bins by the
+// magnitude lanes of another bin array, two bins per step. the phase lanes
+// ride along through a multiply by one, which is exact. returns the number
+// of bins handled; the caller finishes the remainder in scalar code.
+static inline int PV_MagMulBins_SSE(SCPolar *p, const SCPolar *q, int numbins)
+{
+	const __m128 magMask = _mm_castsi128_ps(_mm_setr_epi32(~0, 0, ~0, 0));
+	const __m128 phaseOne = _mm_setr_ps(0.f, 1.f, 0.f, 1.f);
+	int i = 0;
+	for (; i + 1 < numbins; i += 2) {
+		float *pf = (float*)(p + i);
+		const float *qf = (const float*)(q + i);
+		__m128 factor = _mm_or_ps(_mm_and_ps(_mm_loadu_ps(qf), magMask), phaseOne);
+		_mm_storeu_ps(pf, _mm_mul_ps(_mm_loadu_ps(pf), factor));
+	}
+	return i;
+}
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 
 void PV_MagAbove_next(PV_Unit *unit, int inNumSamples)
@@ -588,7 +616,11 @@ void PV_MagSquared_next(PV_Unit *unit, int inNumSamples)
 
 	p->dc  = p->dc  * p->dc;
 	p->nyq = p->nyq * p->nyq;
-	for (int i=0; i<numbins; ++i) {
+	int i = 0;
+#ifdef __SSE2__
+	i = PV_MagMulBins_SSE(p->bin, p->bin, numbins);
+#endif
+	for (; i<numbins; ++i) {
 		float mag = p->bin[i].mag;
 		p->bin[i].mag = mag * mag;
 	}
@@ -670,7 +702,11 @@ void PV_MagMul_next(PV_Unit *unit, int inNumSamples)
 
 	p->dc *= q->dc;
 	p->nyq *= q->nyq;
-	for (int i=0; i<numbins; ++i) {
+	int i = 0;
+#ifdef __SSE2__
+	i = PV_MagMulBins_SSE(p->bin, q->bin, numbins);
+#endif
+	for (; i<numbins; ++i) {
 		p->bin[i].mag *= q->bin[i].mag;
 	}
 }
@@ -782,7 +818,30 @@ void PV_Mul_next(PV_Unit *unit, int inNumSamples)
 
 	p->dc *= q->dc;
 	p->nyq *= q->nyq;
-	for (int i=0; i<numbins; ++i) {
+	int i = 0;
+#ifdef __SSE2__
+	// same three-multiply formula as the scalar loop, four bins per step:
+	// deinterleave (real, imag) pairs with shuffles, do the elementwise
+	// arithmetic in the same order, interleave the results back.
+	for (; i + 3 < numbins; i += 4) {
+		float *pf = (float*)(p->bin + i);
+		const float *qf = (const float*)(q->bin + i);
+		__m128 p01 = _mm_loadu_ps(pf),  p23 = _mm_loadu_ps(pf + 4);
+		__m128 q01 = _mm_loadu_ps(qf),  q23 = _mm_loadu_ps(qf + 4);
+		__m128 vpreal = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2,0,2,0));
+		__m128 vpimag = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3,1,3,1));
+		__m128 vqreal = _mm_shuffle_ps(q01, q23, _MM_SHUFFLE(2,0,2,0));
+		__m128 vqimag = _mm_shuffle_ps(q01, q23, _MM_SHUFFLE(3,1,3,1));
+		__m128 vrealmul = _mm_mul_ps(vpreal, vqreal);
+		__m128 vimagmul = _mm_mul_ps(vpimag, vqimag);
+		__m128 newreal = _mm_sub_ps(vrealmul, vimagmul);
+		__m128 newimag = _mm_sub_ps(_mm_sub_ps(
+			_mm_mul_ps(_mm_add_ps(vpreal, vpimag), _mm_add_ps(vqreal, vqimag)), vrealmul), vimagmul);
+		_mm_storeu_ps(pf,     _mm_unpacklo_ps(newreal, newimag));
+		_mm_storeu_ps(pf + 4, _mm_unpackhi_ps(newreal, newimag));
+	}
+#endif
+	for (; i<numbins; ++i) {
 		preal = p->bin[i].real;
 		// Complex multiply using only 3 multiplications rather than 4. http://mathworld.wolfram.com/ComplexMultiplication.html
 		realmul = (preal * q->bin[i].real);
@@ -832,6 +891,14 @@ void PV_Add_next(PV_Unit *unit, int inNumSamples)
 	SCComplexBuf *p = ToComplexApx(buf1);
 	SCComplexBuf *q = ToComplexApx(buf2);
 
+#ifdef NOVA_SIMD
+	// dc, nyq and the interleaved bins form one contiguous float array of
+	// buf->samples elements, so the whole sum is a flat vector add
+	if (!(buf1->samples & 15)) {
+		nova::plus_vec_simd((float*)p, (float*)p, (float*)q, buf1->samples);
+		return;
+	}
+#endif
 	p->dc += q->dc;
 	p->nyq += q->nyq;
 	for (int i=0; i<numbins; ++i) {
@@ -1617,6 +1617,37 @@ void PanAz_next_aa(PanAz *unit, int inNumSamples)
 	float *zin0 = ZIN(0);
 	float *pos = ZIN(1);
 
+	// at any position only the speakers within one width-window are audible.
+	// when that window is smaller than the rig, write just those channels
+	// per sample instead of evaluating the gain of every speaker: on large
+	// rigs this replaces numOutputs table lookups per sample with about
+	// width of them.
+	if (width + 1.f < (float)numOutputs) {
+		for (int i=0; i<numOutputs; ++i)
+			ZClear(inNumSamples, ZOUT(i));
+
+		const float *in = IN(0);
+		const float *posIn = IN(1);
+		for (int j=0; j<inNumSamples; ++j) {
+			float posBase = posIn[j] * alignedPosFac + alignedPosConst;
+			// candidate channels i with 0 <= posBase*width - i <= width,
+			// padded by one on each side against float rounding; the gain
+			// itself is computed exactly as in the channel-major loop
+			float posj = posBase * width;
+			int hi = (int)sc_floor(posj) + 1;
+			int lo = (int)sc_ceil(posj - width) - 1;
+			for (int i=lo; i<=hi; ++i) {
+				int channel = sc_mod(i, numOutputs);
+				float chanpos = posBase - channel * rwidth;
+				chanpos = chanpos - range * std::floor(rrange * chanpos);
+				if (chanpos > 1.f) continue;
+				float chanamp = level * ft->mSine[(long)(4096.f * chanpos)];
+				OUT(channel)[j] = in[j] * chanamp;
+			}
+		}
+		return;
+	}
+
 	for (int i=0; i<numOutputs; ++i) {
 		float *out = ZOUT(i);
 
@@ -49,6 +49,21 @@ struct TBall : public Unit
 	double m_prev;
 };
 
+// a bank of independent springs in one unit. state is kept as structure of
+// arrays so the per-sample update loops over the voices, which vectorizes
+// across the bank; integrating a single spring is a serial recurrence and
+// cannot use the vector width along time. the voice count is padded to a
+// multiple of kSpringBankLanes; padding lanes keep zero coefficients and
+// zero gain so they stay silent.
+const int kSpringBankLanes = 4;
+
+struct SpringBank : public Unit
+{
+	int m_numVoices;
+	int m_paddedVoices;
+	float *m_data; // pos, vel, spring, damping, gain: five arrays of m_paddedVoices
+};
+
 
 
 extern "C"
@@ -65,6 +80,10 @@ extern "C"
 
 	void TBall_Ctor(TBall *unit);
 	void TBall_next(TBall *unit, int inNumSamples);
+
+	void SpringBank_Ctor(SpringBank *unit);
+	void SpringBank_Dtor(SpringBank *unit);
+	void SpringBank_next(SpringBank *unit, int inNumSamples);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -245,6 +264,74 @@ void TBall_next(TBall *unit, int inNumSamples)
 
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+
+// in, spring1, damping1, spring2, damping2, ...
+
+void SpringBank_Ctor(SpringBank *unit)
+{
+	int numVoices = ((int)unit->mNumInputs - 1) >> 1;
+	int padded = (numVoices + kSpringBankLanes - 1) & ~(kSpringBankLanes - 1);
+	unit->m_numVoices = numVoices;
+	unit->m_paddedVoices = padded;
+	unit->m_data = (float*)RTAlloc(unit->mWorld, 5 * padded * sizeof(float));
+	if (!unit->m_data) {
+		if (unit->mWorld->mVerbosity > -2) {
+			Print("failed to allocate memory for SpringBank\n");
+		}
+		SETCALC(ClearUnitOutputs);
+		return;
+	}
+	memset(unit->m_data, 0, 5 * padded * sizeof(float));
+	float *gain = unit->m_data + 4 * padded;
+	for (int i = 0; i < numVoices; ++i) gain[i] = 1.f;
+	SETCALC(SpringBank_next);
+	SpringBank_next(unit, 1);
+}
+
+void SpringBank_Dtor(SpringBank *unit)
+{
+	RTFree(unit->mWorld, unit->m_data);
+}
+
+void SpringBank_next(SpringBank *unit, int inNumSamples)
+{
+	float *out = OUT(0);
+	float *in = IN(0);			// in force, shared by all voices
+	int padded = unit->m_paddedVoices;
+	float *pos = unit->m_data;
+	float *vel = pos + padded;
+	float *spring = vel + padded;
+	float *damping = spring + padded;
+	float *gain = damping + padded;
+
+	float c = SAMPLEDUR;
+	float rc = SAMPLERATE;
+
+	// the coefficients are control rate; refresh them once per block
+	int numVoices = unit->m_numVoices;
+	for (int j = 0; j < numVoices; ++j) {
+		spring[j] = IN0(1 + 2*j) * c;
+		damping[j] = 1.f - IN0(2 + 2*j);
+	}
+
+	for (int i = 0; i < inNumSamples; ++i) {
+		float inforce = in[i] * c;
+		float sum = 0.f;
+		// batch integration kernel: the voices are independent, so this
+		// loop vectorizes across the bank
+		for (int j = 0; j < padded; ++j) {
+			float force = inforce - pos[j] * spring[j];
+			float v = (force + vel[j]) * damping[j];
+			vel[j] = v;
+			pos[j] += v;
+			sum += force * gain[j];
+		}
+		out[i] = sum * rc;
+	}
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 PluginLoad(PhysicalModeling)
@@ -254,4 +341,5 @@ PluginLoad(PhysicalModeling)
 	DefineSimpleUnit(Spring);
 	DefineSimpleUnit(Ball);
 	DefineSimpleUnit(TBall);
+	DefineDtorUnit(SpringBank);
 }
@@ -25,45 +25,30 @@
 
 static InterfaceTable *ft;
 
+/*  FreeVerb delay line lengths; row 0 is the left (and mono) bank, row 1 the
+    right bank of FreeVerb2. the per-line state is packed into small per-lane
+    arrays rather than the scalar-per-line layout the faust code generator
+    emitted, so the comb bank can be advanced by one fixed-length fused loop
+    per sample (see FreeVerb_combs below). */
+static const int freeverb_comblens[2][8] = {
+    { 1617, 1557, 1491, 1422, 1277, 1116, 1188, 1356 },
+    { 1640, 1580, 1514, 1445, 1300, 1139, 1211, 1379 },
+};
+static const int freeverb_aplens[2][4] = {
+    { 225, 341, 441, 556 },
+    { 248, 364, 464, 579 },
+};
+
 struct FreeVerb : public Unit
 {
-	int 	iota0;
-	int 	iota1;
-	int 	iota2;
-	int 	iota3;
-	int 	iota4;
-	int 	iota5;
-	int 	iota6;
-	int 	iota7;
-	int 	iota8;
-	int 	iota9;
-	int 	iota10;
-	int 	iota11;
-
-	float 	R0_1;
-	float 	R1_1;
-	float 	R2_1;
-	float 	R3_1;
-	float 	R0_0;
-	float 	R1_0;
-	float 	R2_0;
-	float 	R3_0;
-	float 	R4_0;
-	float 	R5_0;
-	float 	R6_0;
-	float 	R7_0;
-	float 	R8_0;
-	float 	R9_0;
-	float 	R10_0;
-	float 	R11_0;
-	float 	R12_0;
-	float 	R13_0;
-	float 	R14_0;
-	float 	R15_0;
-	float 	R16_0;
-	float 	R17_0;
-	float 	R18_0;
-	float 	R19_0;
+	int 	combidx[8];
+	float 	combout[8];	// last delayed sample read per comb
+	float 	comblp[8];	// one-pole damping state per comb
+	int 	apidx[4];
+	float 	apout[4];	// last delayed sample read per allpass
+	float*	combbuf[8];
+	float*	apbuf[4];
+	float*	scratch;	// one block: comb sum / allpass chain values
 
 	float 	dline0[225];
 	float 	dline1[341];
@@ -79,6 +64,59 @@ struct FreeVerb : public Unit
 	float 	dline11[1356];
 };
 
+/*  fused comb bank: all eight lines advance together each sample. with the
+    states interleaved in per-lane arrays the inner loop has a fixed trip
+    count and no branches (the index wrap is a select), so the damping and
+    feedback arithmetic vectorizes; only the delay line loads/stores stay
+    scalar. in[] is the raw (unscaled) input. */
+static void FreeVerb_combs(const float* in, float* out, int inNumSamples,
+	float* const* bufs, const int* lens, int* idxs, float* outs, float* lps,
+	float fb, float damp, float damp1)
+{
+    for (int i=0; i<inNumSamples; i++) {
+	    float x = 1.500000e-02f * in[i];
+	    float sum = 0.f;
+	    for (int j=0; j<8; j++) {
+		    int idx = idxs[j] + 1;
+		    idx = (idx == lens[j]) ? 0 : idx;
+		    idxs[j] = idx;
+		    float* dline = bufs[j];
+		    float T = dline[idx];
+		    float lp = (damp1 * outs[j]) + (damp * lps[j]);
+		    lps[j] = lp;
+		    dline[idx] = x + (fb * lp);
+		    outs[j] = T;
+		    sum += T;
+	    }
+	    out[i] = sum;
+    }
+}
+
+/*  allpass cascade, blockwise and in place: each stage runs over the whole
+    block before the next, so one delay line at a time stays hot in cache
+    instead of touching all four every sample. same sample ordering as the
+    generated code: the feedback term is the delayed sample read one sample
+    earlier. */
+static void FreeVerb_allpasses(float* buf, int inNumSamples,
+	float* const* bufs, const int* lens, int* idxs, float* outs)
+{
+    for (int j=3; j>=0; j--) {
+	    float* dline = bufs[j];
+	    int len = lens[j];
+	    int idx = idxs[j];
+	    float R = outs[j];
+	    for (int i=0; i<inNumSamples; i++) {
+		    if (++idx == len) idx = 0;
+		    float T = dline[idx];
+		    dline[idx] = (0.500000f * R) + buf[i];
+		    R = T;
+		    buf[i] = T - buf[i];
+	    }
+	    idxs[j] = idx;
+	    outs[j] = R;
+    }
+}
+
 
 /*  GVerb work */
 #define FDNORDER 4
@@ -101,6 +139,34 @@ typedef struct {
     float delay;
     } g_damper;
 
+/*  half-band filter for the optional downsampled reverb core. long tails do
+    not need the full sample rate: with the downsample input set, the input is
+    decimated by 2 or 4, the whole FDN runs at the reduced rate (delay lengths
+    and decay constants are derived from it), and the two outputs are
+    interpolated back up. an 11-tap linear-phase half-band FIR per octave
+    keeps the transition artifacts ~50dB down, far below a reverb tail. */
+#define GVERB_HB_TAPS 11
+static const float ghalfbandtaps[GVERB_HB_TAPS] = {
+    0.0105f, 0.f, -0.0529f, 0.f, 0.2973f, 0.5f, 0.2973f, 0.f, -0.0529f, 0.f, 0.0105f
+};
+
+typedef struct {
+    float buf[GVERB_HB_TAPS];
+    int idx;
+    } g_halfband;
+
+static inline float halfband_do(g_halfband *p, float x)
+{
+    p->buf[p->idx] = x;
+    if (++p->idx == GVERB_HB_TAPS) p->idx = 0;
+    float sum = 0.f;
+    int j = p->idx;
+    for (int i = GVERB_HB_TAPS - 1; i >= 0; --i) {
+	sum += ghalfbandtaps[i] * p->buf[j];
+	if (++j == GVERB_HB_TAPS) j = 0;
+    }
+    return sum;
+}
 
 
 struct GVerb : public Unit
@@ -125,17 +191,26 @@ struct GVerb : public Unit
     // make the CALCSLOPE values part of the struct
     // calculate changes first, store them
     // grab values and use in the sample loop
+
+    // downsampled core (see ghalfbandtaps above)
+    int downsample;		// 1, 2 or 4; the core runs at SAMPLERATE/downsample
+    float coresamplerate;
+    float *corebuf;		// scratch for the decimated input and core outputs
+    g_halfband decim[2];	// one stage per octave, mono input
+    g_halfband interp[2][2];	// [channel][stage]
 };
 
 extern "C"
 {
     void FreeVerb_Ctor(FreeVerb *unit);
+    void FreeVerb_Dtor(FreeVerb *unit);
     void FreeVerb_next(FreeVerb *unit, int inNumSamples);
 
 
     void GVerb_Ctor(GVerb *unit);
     void GVerb_Dtor(GVerb *unit);
     void GVerb_next(GVerb* unit, int inNumSamples);
+    void GVerb_next_downsampled(GVerb* unit, int inNumSamples);
 };
 
 
@@ -143,66 +218,52 @@ void FreeVerb_Ctor(FreeVerb *unit)
 {
     SETCALC(FreeVerb_next);
 
-    unit->iota0 = 0;
-    unit->iota1 = 0;
-    unit->iota2 = 0;
-    unit->iota3 = 0;
-    unit->iota4 = 0;
-    unit->iota5 = 0;
-    unit->iota6 = 0;
-    unit->iota7 = 0;
-    unit->iota8 = 0;
-    unit->iota9 = 0;
-    unit->iota10 = 0;
-    unit->iota11 = 0;
-
-    unit->R0_0 = 0.0;
-    unit->R1_0 = 0.0;
-    unit->R2_0 = 0.0;
-    unit->R3_0 = 0.0;
-    unit->R4_0 = 0.0;
-    unit->R5_0 = 0.0;
-    unit->R6_0 = 0.0;
-    unit->R7_0 = 0.0;
-    unit->R8_0 = 0.0;
-    unit->R9_0 = 0.0;
-    unit->R10_0 = 0.0;
-    unit->R11_0 = 0.0;
-    unit->R12_0 = 0.0;
-    unit->R13_0 = 0.0;
-    unit->R14_0 = 0.0;
-    unit->R15_0 = 0.0;
-    unit->R16_0 = 0.0;
-    unit->R17_0 = 0.0;
-    unit->R18_0 = 0.0;
-    unit->R19_0 = 0.0;
-
-    unit->R0_1 = 0.0;
-    unit->R1_1 = 0.0;
-    unit->R2_1 = 0.0;
-    unit->R3_1 = 0.0;
-
-    for(int i=0; i<225;  i++) unit->dline0[i] = 0.0;
-    for(int i=0; i<341;  i++) unit->dline1[i] = 0.0;
-    for(int i=0; i<441;  i++) unit->dline2[i] = 0.0;
-    for(int i=0; i<556;  i++) unit->dline3[i] = 0.0;
-    for(int i=0; i<1617; i++) unit->dline4[i] = 0.0;
-    for(int i=0; i<1557; i++) unit->dline5[i] = 0.0;
-    for(int i=0; i<1491; i++) unit->dline6[i] = 0.0;
-    for(int i=0; i<1422; i++) unit->dline7[i] = 0.0;
-    for(int i=0; i<1277; i++) unit->dline8[i] = 0.0;
-    for(int i=0; i<1116; i++) unit->dline9[i] = 0.0;
-    for(int i=0; i<1188; i++) unit->dline10[i] = 0.0;
-    for(int i=0; i<1356; i++) unit->dline11[i] = 0.0;
+    unit->apbuf[0] = unit->dline0;
+    unit->apbuf[1] = unit->dline1;
+    unit->apbuf[2] = unit->dline2;
+    unit->apbuf[3] = unit->dline3;
+    unit->combbuf[0] = unit->dline4;
+    unit->combbuf[1] = unit->dline5;
+    unit->combbuf[2] = unit->dline6;
+    unit->combbuf[3] = unit->dline7;
+    unit->combbuf[4] = unit->dline8;
+    unit->combbuf[5] = unit->dline9;
+    unit->combbuf[6] = unit->dline10;
+    unit->combbuf[7] = unit->dline11;
+
+    for (int j=0; j<8; j++) {
+	    unit->combidx[j] = 0;
+	    unit->combout[j] = 0.f;
+	    unit->comblp[j] = 0.f;
+	    Clear(freeverb_comblens[0][j], unit->combbuf[j]);
+    }
+    for (int j=0; j<4; j++) {
+	    unit->apidx[j] = 0;
+	    unit->apout[j] = 0.f;
+	    Clear(freeverb_aplens[0][j], unit->apbuf[j]);
+    }
+
+    unit->scratch = (float*)RTAlloc(unit->mWorld, unit->mWorld->mFullRate.mBufLength * sizeof(float));
+    if (!unit->scratch) {
+	    if (unit->mWorld->mVerbosity > -2)
+		Print("FreeVerb: RT memory allocation failed\n");
+	    SETCALC(ClearUnitOutputs);
+	    return;
+    }
 
     FreeVerb_next(unit, 1);
 }
 
+void FreeVerb_Dtor(FreeVerb *unit)
+{
+    if (unit->scratch) RTFree(unit->mWorld, unit->scratch);
+}
+
 void FreeVerb_next(FreeVerb *unit, int inNumSamples)
 {
     float* input0  = IN(0);
     float* output0 = OUT(0);
-
+    float* wet = unit->scratch;
 
     float ftemp0 = IN0(1); // mix
     if (ftemp0 > 1.) ftemp0 = 1.;
@@ -220,262 +281,28 @@ void FreeVerb_next(FreeVerb *unit, int inNumSamples)
     float ftemp6 = (0.400000f * damp);
     float ftemp7 = (1 - ftemp6);
 
-    int iota0 = unit->iota0;
-    int iota1 = unit->iota1;
-    int iota2 = unit->iota2;
-    int iota3 = unit->iota3;
-    int iota4 = unit->iota4;
-    int iota5 = unit->iota5;
-    int iota6 = unit->iota6;
-    int iota7 = unit->iota7;
-    int iota8 = unit->iota8;
-    int iota9 = unit->iota9;
-    int iota10 = unit->iota10;
-    int iota11 = unit->iota11;
-
-    float R0_1 = unit->R0_1;
-    float R1_1 = unit->R1_1;
-    float R2_1 = unit->R2_1;
-    float R3_1 = unit->R3_1;
-
-    float R0_0 = unit->R0_0;
-    float R1_0 = unit->R1_0;
-    float R2_0 = unit->R2_0;
-    float R3_0 = unit->R3_0;
-    float R4_0 = unit->R4_0;
-    float R5_0 = unit->R5_0;
-    float R6_0 = unit->R6_0;
-    float R7_0 = unit->R7_0;
-    float R8_0 = unit->R8_0;
-    float R9_0 = unit->R9_0;
-    float R10_0 = unit->R10_0;
-    float R11_0 = unit->R11_0;
-    float R12_0 = unit->R12_0;
-    float R13_0 = unit->R13_0;
-    float R14_0 = unit->R14_0;
-    float R15_0 = unit->R15_0;
-    float R16_0 = unit->R16_0;
-    float R17_0 = unit->R17_0;
-    float R18_0 = unit->R18_0;
-    float R19_0 = unit->R19_0;
-
-    float *dline0 = unit->dline0;
-    float *dline1 = unit->dline1;
-    float *dline2 = unit->dline2;
-    float *dline3 = unit->dline3;
-    float *dline4 = unit->dline4;
-    float *dline5 = unit->dline5;
-    float *dline6 = unit->dline6;
-    float *dline7 = unit->dline7;
-    float *dline8 = unit->dline8;
-    float *dline9 = unit->dline9;
-    float *dline10 = unit->dline10;
-    float *dline11 = unit->dline11;
-
-    for (int i=0; i<inNumSamples; i++) {
-	    float ftemp2 = input0[i];
-	    float ftemp4 = (1.500000e-02f * ftemp2);
-
-
-
-	    if (++iota0 == 225) iota0=0;
-	    float T0 = dline0[iota0];
+    FreeVerb_combs(input0, wet, inNumSamples, unit->combbuf, freeverb_comblens[0],
+	unit->combidx, unit->combout, unit->comblp, ftemp5, ftemp6, ftemp7);
+    FreeVerb_allpasses(wet, inNumSamples, unit->apbuf, freeverb_aplens[0],
+	unit->apidx, unit->apout);
 
-	    if (++iota1 == 341) iota1=0;
-	    float T1 = dline1[iota1];
-
-	    if (++iota2 == 441) iota2=0;
-	    float T2 = dline2[iota2];
-
-	    if (++iota3 == 556) iota3=0;
-	    float T3 = dline3[iota3];
-
-
-	    if (++iota4 == 1617) iota4=0;
-	    float T4 = dline4[iota4];
-	    R5_0 = ((ftemp7 * R4_0) + (ftemp6 * R5_0));
-	    dline4[iota4] = (ftemp4 + (ftemp5 * R5_0));
-	    R4_0 = T4;
-
-	    if (++iota5 == 1557) iota5=0;
-	    float T5 = dline5[iota5];
-	    R7_0 = ((ftemp7 * R6_0) + (ftemp6 * R7_0));
-	    dline5[iota5] = (ftemp4 + (ftemp5 * R7_0));
-	    R6_0 = T5;
-
-	    if (++iota6 == 1491) iota6=0;
-	    float T6 = dline6[iota6];
-	    R9_0 = ((ftemp7 * R8_0) + (ftemp6 * R9_0));
-	    dline6[iota6] = (ftemp4 + (ftemp5 * R9_0));
-	    R8_0 = T6;
-
-	    if (++iota7 == 1422) iota7=0;
-	    float T7 = dline7[iota7];
-	    R11_0 = ((ftemp7 * R10_0) + (ftemp6 * R11_0));
-	    dline7[iota7] = (ftemp4 + (ftemp5 * R11_0));
-	    R10_0 = T7;
-
-	    if (++iota8 == 1277) iota8=0;
-	    float T8 = dline8[iota8];
-	    R13_0 = ((ftemp7 * R12_0) + (ftemp6 * R13_0));
-	    dline8[iota8] = (ftemp4 + (ftemp5 * R13_0));
-	    R12_0 = T8;
-
-	    if (++iota9 == 1116) iota9=0;
-	    float T9 = dline9[iota9];
-	    R15_0 = ((ftemp7 * R14_0) + (ftemp6 * R15_0));
-	    dline9[iota9] = (ftemp4 + (ftemp5 * R15_0));
-	    R14_0 = T9;
-
-	    if (++iota10 == 1188) iota10=0;
-	    float T10 = dline10[iota10];
-	    R17_0 = ((ftemp7 * R16_0) + (ftemp6 * R17_0));
-	    dline10[iota10] = (ftemp4 + (ftemp5 * R17_0));
-	    R16_0 = T10;
-
-	    if (++iota11 == 1356) iota11=0;
-	    float T11 = dline11[iota11];
-	    R19_0 = ((ftemp7 * R18_0) + (ftemp6 * R19_0));
-	    dline11[iota11] = (ftemp4 + (ftemp5 * R19_0));
-	    R18_0 = T11;
-
-	    float ftemp8 = (R16_0 + R18_0);
-
-	    dline3[iota3] = ((((0.500000f * R3_0) + R4_0) + (R6_0 + R8_0)) + ((R10_0 + R12_0) + (R14_0 + ftemp8)));
-	    R3_0 = T3;
-
-	    R3_1 = (R3_0 - (((R4_0 + R6_0) + (R8_0 + R10_0)) + ((R12_0 + R14_0) + ftemp8)));
-	    dline2[iota2] = ((0.500000f * R2_0) + R3_1);
-	    R2_0 = T2;
-
-	    R2_1 = (R2_0 - R3_1);
-	    dline1[iota1] = ((0.500000f * R1_0) + R2_1);
-	    R1_0 = T1;
-
-	    R1_1 = (R1_0 - R2_1);
-	    dline0[iota0] = ((0.500000f * R0_0) + R1_1);
-	    R0_0 = T0;
-
-	    R0_1 = (R0_0 - R1_1);
-	    output0[i] = ((ftemp1 * ftemp2) + (ftemp0 * R0_1));
-
-    }
-
-    unit->iota0 = iota0;
-    unit->iota1 = iota1;
-    unit->iota2 = iota2;
-    unit->iota3 = iota3;
-    unit->iota4 = iota4;
-    unit->iota5 = iota5;
-    unit->iota6 = iota6;
-    unit->iota7 = iota7;
-    unit->iota8 = iota8;
-    unit->iota9 = iota9;
-    unit->iota10 = iota10;
-    unit->iota11 = iota11;
-
-    unit->R0_1 = R0_1;
-    unit->R1_1 = R1_1;
-    unit->R2_1 = R2_1;
-    unit->R3_1 = R3_1;
-
-    unit->R0_0 = R0_0;
-    unit->R1_0 = R1_0;
-    unit->R2_0 = R2_0;
-    unit->R3_0 = R3_0;
-    unit->R4_0 = R4_0;
-    unit->R5_0 = R5_0;
-    unit->R6_0 = R6_0;
-    unit->R7_0 = R7_0;
-    unit->R8_0 = R8_0;
-    unit->R9_0 = R9_0;
-    unit->R10_0 = R10_0;
-    unit->R11_0 = R11_0;
-    unit->R12_0 = R12_0;
-    unit->R13_0 = R13_0;
-    unit->R14_0 = R14_0;
-    unit->R15_0 = R15_0;
-    unit->R16_0 = R16_0;
-    unit->R17_0 = R17_0;
-    unit->R18_0 = R18_0;
-    unit->R19_0 = R19_0;
+    // the dry input is only read here, so running in place is still safe
+    for (int i=0; i<inNumSamples; i++)
+	    output0[i] = (ftemp1 * input0[i]) + (ftemp0 * wet[i]);
 }
 
 // FreeVerb2
 struct FreeVerb2 : public Unit
 {
-	int 	iota0;
-	int 	iota1;
-	int 	iota2;
-	int 	iota3;
-	int 	iota4;
-	int 	iota5;
-	int 	iota6;
-	int 	iota7;
-	int 	iota8;
-	int 	iota9;
-	int 	iota10;
-	int 	iota11;
-	int 	iota12;
-	int 	iota13;
-	int 	iota14;
-	int 	iota15;
-	int 	iota16;
-	int 	iota17;
-	int 	iota18;
-	int 	iota19;
-	int 	iota20;
-	int 	iota21;
-	int 	iota22;
-	int 	iota23;
-	float 	R0_1;
-	float 	R1_1;
-	float 	R2_1;
-	float 	R3_1;
-	float 	R0_0;
-	float 	R1_0;
-	float 	R2_0;
-	float 	R3_0;
-	float 	R4_0;
-	float 	R5_0;
-	float 	R6_0;
-	float 	R7_0;
-	float 	R8_0;
-	float 	R9_0;
-	float 	R10_0;
-	float 	R11_0;
-	float 	R12_0;
-	float 	R13_0;
-	float 	R14_0;
-	float 	R15_0;
-	float 	R16_0;
-	float 	R17_0;
-	float 	R18_0;
-	float 	R19_0;
-	float 	R20_0;
-	float 	R21_0;
-	float 	R22_0;
-	float 	R23_0;
-	float 	R24_0;
-	float 	R25_0;
-	float 	R26_0;
-	float 	R27_0;
-	float 	R28_0;
-	float 	R29_0;
-	float 	R30_0;
-	float 	R31_0;
-	float 	R32_0;
-	float 	R33_0;
-	float 	R34_0;
-	float 	R35_0;
-	float 	R36_0;
-	float 	R37_0;
-	float 	R38_0;
-	float 	R39_0;
-	float 	R20_1;
-	float 	R21_1;
-	float 	R22_1;
-	float 	R23_1;
+	int 	combidx[2][8];
+	float 	combout[2][8];	// last delayed sample read per comb
+	float 	comblp[2][8];	// one-pole damping state per comb
+	int 	apidx[2][4];
+	float 	apout[2][4];	// last delayed sample read per allpass
+	float*	combbuf[2][8];
+	float*	apbuf[2][4];
+	float*	scratch;	// three blocks: summed input, wet left, wet right
+
 	float 	dline0[225];
 	float 	dline1[341];
 	float 	dline2[441];
@@ -505,6 +332,7 @@ struct FreeVerb2 : public Unit
 extern "C"
 {
     void FreeVerb2_Ctor(FreeVerb2 *unit);
+    void FreeVerb2_Dtor(FreeVerb2 *unit);
     void FreeVerb2_next(FreeVerb2 *unit, int inNumSamples);
 };
 
@@ -513,110 +341,61 @@ void FreeVerb2_Ctor(FreeVerb2 *unit)
 {
     SETCALC(FreeVerb2_next);
 
-    unit->iota0 = 0;
-    unit->iota1 = 0;
-    unit->iota2 = 0;
-    unit->iota3 = 0;
-    unit->iota4 = 0;
-    unit->iota5 = 0;
-    unit->iota6 = 0;
-    unit->iota7 = 0;
-    unit->iota8 = 0;
-    unit->iota9 = 0;
-    unit->iota10 = 0;
-    unit->iota11 = 0;
-    unit->iota12 = 0;
-    unit->iota13 = 0;
-    unit->iota14 = 0;
-    unit->iota15 = 0;
-    unit->iota16 = 0;
-    unit->iota17 = 0;
-    unit->iota18 = 0;
-    unit->iota19 = 0;
-    unit->iota20 = 0;
-    unit->iota21 = 0;
-    unit->iota22 = 0;
-    unit->iota23 = 0;
-
-    unit->R0_0 = 0.0;
-    unit->R1_0 = 0.0;
-    unit->R2_0 = 0.0;
-    unit->R3_0 = 0.0;
-    unit->R4_0 = 0.0;
-    unit->R5_0 = 0.0;
-    unit->R6_0 = 0.0;
-    unit->R7_0 = 0.0;
-    unit->R8_0 = 0.0;
-    unit->R9_0 = 0.0;
-    unit->R10_0 = 0.0;
-    unit->R11_0 = 0.0;
-    unit->R12_0 = 0.0;
-    unit->R13_0 = 0.0;
-    unit->R14_0 = 0.0;
-    unit->R15_0 = 0.0;
-    unit->R16_0 = 0.0;
-    unit->R17_0 = 0.0;
-    unit->R18_0 = 0.0;
-    unit->R19_0 = 0.0;
-    unit->R20_0 = 0.0;
-    unit->R21_0 = 0.0;
-    unit->R22_0 = 0.0;
-    unit->R23_0 = 0.0;
-    unit->R24_0 = 0.0;
-    unit->R25_0 = 0.0;
-    unit->R26_0 = 0.0;
-    unit->R27_0 = 0.0;
-    unit->R28_0 = 0.0;
-    unit->R29_0 = 0.0;
-    unit->R30_0 = 0.0;
-    unit->R31_0 = 0.0;
-    unit->R32_0 = 0.0;
-    unit->R33_0 = 0.0;
-    unit->R34_0 = 0.0;
-    unit->R35_0 = 0.0;
-    unit->R36_0 = 0.0;
-    unit->R37_0 = 0.0;
-    unit->R38_0 = 0.0;
-    unit->R39_0 = 0.0;
-
-    unit->R0_1 = 0.0;
-    unit->R1_1 = 0.0;
-    unit->R2_1 = 0.0;
-    unit->R3_1 = 0.0;
-
-    unit->R23_1 = 0.0;
-    unit->R22_1 = 0.0;
-    unit->R21_1 = 0.0;
-    unit->R20_1 = 0.0;
-
-    for(int i=0; i<225; i++) unit->dline0[i] = 0.0;
-    for(int i=0; i<341; i++) unit->dline1[i] = 0.0;
-    for(int i=0; i<441; i++) unit->dline2[i] = 0.0;
-    for(int i=0; i<556; i++) unit->dline3[i] = 0.0;
-    for(int i=0; i<1617; i++) unit->dline4[i] = 0.0;
-    for(int i=0; i<1557; i++) unit->dline5[i] = 0.0;
-    for(int i=0; i<1491; i++) unit->dline6[i] = 0.0;
-    for(int i=0; i<1422; i++) unit->dline7[i] = 0.0;
-    for(int i=0; i<1277; i++) unit->dline8[i] = 0.0;
-    for(int i=0; i<1116; i++) unit->dline9[i] = 0.0;
-    for(int i=0; i<1188; i++) unit->dline10[i] = 0.0;
-    for(int i=0; i<1356; i++) unit->dline11[i] = 0.0;
-    for(int i=0; i<248; i++) unit->dline12[i] = 0.0;
-    for(int i=0; i<364; i++) unit->dline13[i] = 0.0;
-    for(int i=0; i<464; i++) unit->dline14[i] = 0.0;
-    for(int i=0; i<579; i++) unit->dline15[i] = 0.0;
-    for(int i=0; i<1640; i++) unit->dline16[i] = 0.0;
-    for(int i=0; i<1580; i++) unit->dline17[i] = 0.0;
-    for(int i=0; i<1514; i++) unit->dline18[i] = 0.0;
-    for(int i=0; i<1445; i++) unit->dline19[i] = 0.0;
-    for(int i=0; i<1300; i++) unit->dline20[i] = 0.0;
-    for(int i=0; i<1139; i++) unit->dline21[i] = 0.0;
-    for(int i=0; i<1211; i++) unit->dline22[i] = 0.0;
-    for(int i=0; i<1379; i++) unit->dline23[i] = 0.0;
+    unit->apbuf[0][0] = unit->dline0;
+    unit->apbuf[0][1] = unit->dline1;
+    unit->apbuf[0][2] = unit->dline2;
+    unit->apbuf[0][3] = unit->dline3;
+    unit->combbuf[0][0] = unit->dline4;
+    unit->combbuf[0][1] = unit->dline5;
+    unit->combbuf[0][2] = unit->dline6;
+    unit->combbuf[0][3] = unit->dline7;
+    unit->combbuf[0][4] = unit->dline8;
+    unit->combbuf[0][5] = unit->dline9;
+    unit->combbuf[0][6] = unit->dline10;
+    unit->combbuf[0][7] = unit->dline11;
+    unit->apbuf[1][0] = unit->dline12;
+    unit->apbuf[1][1] = unit->dline13;
+    unit->apbuf[1][2] = unit->dline14;
+    unit->apbuf[1][3] = unit->dline15;
+    unit->combbuf[1][0] = unit->dline16;
+    unit->combbuf[1][1] = unit->dline17;
+    unit->combbuf[1][2] = unit->dline18;
+    unit->combbuf[1][3] = unit->dline19;
+    unit->combbuf[1][4] = unit->dline20;
+    unit->combbuf[1][5] = unit->dline21;
+    unit->combbuf[1][6] = unit->dline22;
+    unit->combbuf[1][7] = unit->dline23;
+
+    for (int ch=0; ch<2; ch++) {
+	    for (int j=0; j<8; j++) {
+		    unit->combidx[ch][j] = 0;
+		    unit->combout[ch][j] = 0.f;
+		    unit->comblp[ch][j] = 0.f;
+		    Clear(freeverb_comblens[ch][j], unit->combbuf[ch][j]);
+	    }
+	    for (int j=0; j<4; j++) {
+		    unit->apidx[ch][j] = 0;
+		    unit->apout[ch][j] = 0.f;
+		    Clear(freeverb_aplens[ch][j], unit->apbuf[ch][j]);
+	    }
+    }
+
+    unit->scratch = (float*)RTAlloc(unit->mWorld, 3 * unit->mWorld->mFullRate.mBufLength * sizeof(float));
+    if (!unit->scratch) {
+	    if (unit->mWorld->mVerbosity > -2)
+		Print("FreeVerb2: RT memory allocation failed\n");
+	    SETCALC(ClearUnitOutputs);
+	    return;
+    }
 
     FreeVerb2_next(unit, 1);
 }
 
+void FreeVerb2_Dtor(FreeVerb2 *unit)
+{
+    if (unit->scratch) RTFree(unit->mWorld, unit->scratch);
+}
+
 void FreeVerb2_next(FreeVerb2 *unit, int inNumSamples)
 {
     float* input0  = IN(0);
@@ -640,316 +419,31 @@ void FreeVerb2_next(FreeVerb2 *unit, int inNumSamples)
     float ftemp6 = (0.400000f * damp);
     float ftemp7 = (1 - ftemp6);
 
-    float R0_0 = unit->R0_0;
-    float R1_0 = unit->R1_0;
-    float R2_0 = unit->R2_0;
-    float R3_0 = unit->R3_0;
-    float R4_0 = unit->R4_0;
-    float R5_0 = unit->R5_0;
-    float R6_0 = unit->R6_0;
-    float R7_0 = unit->R7_0;
-    float R8_0 = unit->R8_0;
-    float R9_0 = unit->R9_0;
-    float R10_0 = unit->R10_0;
-    float R11_0 = unit->R11_0;
-    float R12_0 = unit->R12_0;
-    float R13_0 = unit->R13_0;
-    float R14_0 = unit->R14_0;
-    float R15_0 = unit->R15_0;
-    float R16_0 = unit->R16_0;
-    float R17_0 = unit->R17_0;
-    float R18_0 = unit->R18_0;
-    float R19_0 = unit->R19_0;
-    float R20_0 = unit->R20_0;
-    float R21_0 = unit->R21_0;
-    float R22_0 = unit->R22_0;
-    float R23_0 = unit->R23_0;
-    float R24_0 = unit->R24_0;
-    float R25_0 = unit->R25_0;
-    float R26_0 = unit->R26_0;
-    float R27_0 = unit->R27_0;
-    float R28_0 = unit->R28_0;
-    float R29_0 = unit->R29_0;
-    float R30_0 = unit->R30_0;
-    float R31_0 = unit->R31_0;
-    float R32_0 = unit->R32_0;
-    float R33_0 = unit->R33_0;
-    float R34_0 = unit->R34_0;
-    float R35_0 = unit->R35_0;
-    float R36_0 = unit->R36_0;
-    float R37_0 = unit->R37_0;
-    float R38_0 = unit->R38_0;
-    float R39_0 = unit->R39_0;
-
-    float R0_1 = unit->R0_1;
-    float R1_1 = unit->R1_1;
-    float R2_1 = unit->R2_1;
-    float R3_1 = unit->R3_1;
-
-    float R23_1 = unit->R23_1;
-    float R22_1 = unit->R22_1;
-    float R21_1 = unit->R21_1;
-    float R20_1 = unit->R20_1;
-
-    int iota0 = unit->iota0;
-    int iota1 = unit->iota1;
-    int iota2 = unit->iota2;
-    int iota3 = unit->iota3;
-    int iota4 = unit->iota4;
-    int iota5 = unit->iota5;
-    int iota6 = unit->iota6;
-    int iota7 = unit->iota7;
-    int iota8 = unit->iota8;
-    int iota9 = unit->iota9;
-    int iota10 = unit->iota10;
-    int iota11 = unit->iota11;
-    int iota12 = unit->iota12;
-    int iota13 = unit->iota13;
-    int iota14 = unit->iota14;
-    int iota15 = unit->iota15;
-    int iota16 = unit->iota16;
-    int iota17 = unit->iota17;
-    int iota18 = unit->iota18;
-    int iota19 = unit->iota19;
-    int iota20 = unit->iota20;
-    int iota21 = unit->iota21;
-    int iota22 = unit->iota22;
-    int iota23 = unit->iota23;
-
-    float *dline0 = unit->dline0;
-    float *dline1 = unit->dline1;
-    float *dline2 = unit->dline2;
-    float *dline3 = unit->dline3;
-    float *dline4 = unit->dline4;
-    float *dline5 = unit->dline5;
-    float *dline6 = unit->dline6;
-    float *dline7 = unit->dline7;
-    float *dline8 = unit->dline8;
-    float *dline9 = unit->dline9;
-    float *dline10 = unit->dline10;
-    float *dline11 = unit->dline11;
-    float *dline12 = unit->dline12;
-    float *dline13 = unit->dline13;
-    float *dline14 = unit->dline14;
-    float *dline15 = unit->dline15;
-    float *dline16 = unit->dline16;
-    float *dline17 = unit->dline17;
-    float *dline18 = unit->dline18;
-    float *dline19 = unit->dline19;
-    float *dline20 = unit->dline20;
-    float *dline21 = unit->dline21;
-    float *dline22 = unit->dline22;
-    float *dline23 = unit->dline23;
+    int bufLength = unit->mWorld->mFullRate.mBufLength;
+    float* mix = unit->scratch;
+    float* wetl = mix + bufLength;
+    float* wetr = wetl + bufLength;
+
+    // both banks are fed the summed input
+    for (int i=0; i<inNumSamples; i++)
+	    mix[i] = input0[i] + input1[i];
+
+    for (int ch=0; ch<2; ch++) {
+	    float* wet = ch ? wetr : wetl;
+	    FreeVerb_combs(mix, wet, inNumSamples, unit->combbuf[ch], freeverb_comblens[ch],
+		unit->combidx[ch], unit->combout[ch], unit->comblp[ch], ftemp5, ftemp6, ftemp7);
+	    FreeVerb_allpasses(wet, inNumSamples, unit->apbuf[ch], freeverb_aplens[ch],
+		unit->apidx[ch], unit->apout[ch]);
+    }
 
+    // reads precede the writes within each iteration, so in-place buffer
+    // sharing behaves as before
     for (int i=0; i<inNumSamples; i++) {
-
-	    float ftemp2 = input0[i];
-	    if (++iota0 == 225) iota0=0;
-	    float T0 = dline0[iota0];
-	    if (++iota1 == 341) iota1=0;
-	    float T1 = dline1[iota1];
-	    if (++iota2 == 441) iota2=0;
-	    float T2 = dline2[iota2];
-	    if (++iota3 == 556) iota3=0;
-	    float T3 = dline3[iota3];
-	    if (++iota4 == 1617) iota4=0;
-	    float T4 = dline4[iota4];
-	    float ftemp3 = input1[i];
-	    float ftemp4 = (1.500000e-02f * (ftemp2 + ftemp3));
-	    R5_0 = ((ftemp7 * R4_0) + (ftemp6 * R5_0));
-	    dline4[iota4] = (ftemp4 + (ftemp5 * R5_0));
-	    R4_0 = T4;
-	    if (++iota5 == 1557) iota5=0;
-	    float T5 = dline5[iota5];
-	    R7_0 = ((ftemp7 * R6_0) + (ftemp6 * R7_0));
-	    dline5[iota5] = (ftemp4 + (ftemp5 * R7_0));
-	    R6_0 = T5;
-	    if (++iota6 == 1491) iota6=0;
-	    float T6 = dline6[iota6];
-	    R9_0 = ((ftemp7 * R8_0) + (ftemp6 * R9_0));
-	    dline6[iota6] = (ftemp4 + (ftemp5 * R9_0));
-	    R8_0 = T6;
-	    if (++iota7 == 1422) iota7=0;
-	    float T7 = dline7[iota7];
-	    R11_0 = ((ftemp7 * R10_0) + (ftemp6 * R11_0));
-	    dline7[iota7] = (ftemp4 + (ftemp5 * R11_0));
-	    R10_0 = T7;
-	    if (++iota8 == 1277) iota8=0;
-	    float T8 = dline8[iota8];
-	    R13_0 = ((ftemp7 * R12_0) + (ftemp6 * R13_0));
-	    dline8[iota8] = (ftemp4 + (ftemp5 * R13_0));
-	    R12_0 = T8;
-	    if (++iota9 == 1116) iota9=0;
-	    float T9 = dline9[iota9];
-	    R15_0 = ((ftemp7 * R14_0) + (ftemp6 * R15_0));
-	    dline9[iota9] = (ftemp4 + (ftemp5 * R15_0));
-	    R14_0 = T9;
-	    if (++iota10 == 1188) iota10=0;
-	    float T10 = dline10[iota10];
-	    R17_0 = ((ftemp7 * R16_0) + (ftemp6 * R17_0));
-	    dline10[iota10] = (ftemp4 + (ftemp5 * R17_0));
-	    R16_0 = T10;
-	    if (++iota11 == 1356) iota11=0;
-	    float T11 = dline11[iota11];
-	    R19_0 = ((ftemp7 * R18_0) + (ftemp6 * R19_0));
-	    dline11[iota11] = (ftemp4 + (ftemp5 * R19_0));
-	    R18_0 = T11;
-	    float ftemp8 = (R16_0 + R18_0);
-	    dline3[iota3] = ((((0.500000f * R3_0) + R4_0) + (R6_0 + R8_0)) + ((R10_0 + R12_0) + (R14_0 + ftemp8)));
-	    R3_0 = T3;
-	    R3_1 = (R3_0 - (((R4_0 + R6_0) + (R8_0 + R10_0)) + ((R12_0 + R14_0) + ftemp8)));
-	    dline2[iota2] = ((0.500000f * R2_0) + R3_1);
-	    R2_0 = T2;
-	    R2_1 = (R2_0 - R3_1);
-	    dline1[iota1] = ((0.500000f * R1_0) + R2_1);
-	    R1_0 = T1;
-	    R1_1 = (R1_0 - R2_1);
-	    dline0[iota0] = ((0.500000f * R0_0) + R1_1);
-	    R0_0 = T0;
-	    R0_1 = (R0_0 - R1_1);
-	    output0[i] = ((ftemp1 * ftemp2) + (ftemp0 * R0_1));
-
-// right chn
-	    if (++iota12 == 248) iota12=0;
-	    float T12 = dline12[iota12];
-	    if (++iota13 == 364) iota13=0;
-	    float T13 = dline13[iota13];
-	    if (++iota14 == 464) iota14=0;
-	    float T14 = dline14[iota14];
-	    if (++iota15 == 579) iota15=0;
-	    float T15 = dline15[iota15];
-	    if (++iota16 == 1640) iota16=0;
-	    float T16 = dline16[iota16];
-	    R25_0 = ((ftemp7 * R24_0) + (ftemp6 * R25_0));
-	    dline16[iota16] = (ftemp4 + (ftemp5 * R25_0));
-	    R24_0 = T16;
-	    if (++iota17 == 1580) iota17=0;
-	    float T17 = dline17[iota17];
-	    R27_0 = ((ftemp7 * R26_0) + (ftemp6 * R27_0));
-	    dline17[iota17] = (ftemp4 + (ftemp5 * R27_0));
-	    R26_0 = T17;
-	    if (++iota18 == 1514) iota18=0;
-	    float T18 = dline18[iota18];
-	    R29_0 = ((ftemp7 * R28_0) + (ftemp6 * R29_0));
-	    dline18[iota18] = (ftemp4 + (ftemp5 * R29_0));
-	    R28_0 = T18;
-	    if (++iota19 == 1445) iota19=0;
-	    float T19 = dline19[iota19];
-	    R31_0 = ((ftemp7 * R30_0) + (ftemp6 * R31_0));
-	    dline19[iota19] = (ftemp4 + (ftemp5 * R31_0));
-	    R30_0 = T19;
-	    if (++iota20 == 1300) iota20=0;
-	    float T20 = dline20[iota20];
-	    R33_0 = ((ftemp7 * R32_0) + (ftemp6 * R33_0));
-	    dline20[iota20] = (ftemp4 + (ftemp5 * R33_0));
-	    R32_0 = T20;
-	    if (++iota21 == 1139) iota21=0;
-	    float T21 = dline21[iota21];
-	    R35_0 = ((ftemp7 * R34_0) + (ftemp6 * R35_0));
-	    dline21[iota21] = (ftemp4 + (ftemp5 * R35_0));
-	    R34_0 = T21;
-	    if (++iota22 == 1211) iota22=0;
-	    float T22 = dline22[iota22];
-	    R37_0 = ((ftemp7 * R36_0) + (ftemp6 * R37_0));
-	    dline22[iota22] = (ftemp4 + (ftemp5 * R37_0));
-	    R36_0 = T22;
-	    if (++iota23 == 1379) iota23=0;
-	    float T23 = dline23[iota23];
-	    R39_0 = ((ftemp7 * R38_0) + (ftemp6 * R39_0));
-	    dline23[iota23] = (ftemp4 + (ftemp5 * R39_0));
-	    R38_0 = T23;
-	    float ftemp9 = (R36_0 + R38_0);
-	    dline15[iota15] = ((((0.500000f * R23_0) + R24_0) + (R26_0 + R28_0)) + ((R30_0 + R32_0) +
-		(R34_0 + ftemp9)));
-	    R23_0 = T15;
-	    R23_1 = (R23_0 - (((R24_0 + R26_0) + (R28_0 + R30_0)) + ((R32_0 + R34_0) + ftemp9)));
-	    dline14[iota14] = ((0.500000f * R22_0) + R23_1);
-	    R22_0 = T14;
-	    R22_1 = (R22_0 - R23_1);
-	    dline13[iota13] = ((0.500000f * R21_0) + R22_1);
-	    R21_0 = T13;
-	    R21_1 = (R21_0 - R22_1);
-	    dline12[iota12] = ((0.500000f * R20_0) + R21_1);
-	    R20_0 = T12;
-	    R20_1 = (R20_0 - R21_1);
-	    output1[i] = ((ftemp1 * ftemp3) + (ftemp0 * R20_1));
+	    float l = (ftemp1 * input0[i]) + (ftemp0 * wetl[i]);
+	    float r = (ftemp1 * input1[i]) + (ftemp0 * wetr[i]);
+	    output0[i] = l;
+	    output1[i] = r;
     }
-
-    unit->iota0 = iota0;
-    unit->iota1 = iota1;
-    unit->iota2 = iota2;
-    unit->iota3 = iota3;
-    unit->iota4 = iota4;
-    unit->iota5 = iota5;
-    unit->iota6 = iota6;
-    unit->iota7 = iota7;
-    unit->iota8 = iota8;
-    unit->iota9 = iota9;
-    unit->iota10 = iota10;
-    unit->iota11 = iota11;
-    unit->iota12 = iota12;
-    unit->iota13 = iota13;
-    unit->iota14 = iota14;
-    unit->iota15 = iota15;
-    unit->iota16 = iota16;
-    unit->iota17 = iota17;
-    unit->iota18 = iota18;
-    unit->iota19 = iota19;
-    unit->iota20 = iota20;
-    unit->iota21 = iota21;
-    unit->iota22 = iota22;
-    unit->iota23 = iota23;
-
-    unit->R0_1 = R0_1;
-    unit->R1_1 = R1_1;
-    unit->R2_1 = R2_1;
-    unit->R3_1 = R3_1;
-
-    unit->R20_1 = R20_1;
-    unit->R21_1 = R21_1;
-    unit->R22_1 = R22_1;
-    unit->R23_1 = R23_1;
-
-    unit->R0_0 = R0_0;
-    unit->R1_0 = R1_0;
-    unit->R2_0 = R2_0;
-    unit->R3_0 = R3_0;
-    unit->R4_0 = R4_0;
-    unit->R5_0 = R5_0;
-    unit->R6_0 = R6_0;
-    unit->R7_0 = R7_0;
-    unit->R8_0 = R8_0;
-    unit->R9_0 = R9_0;
-    unit->R10_0 = R10_0;
-    unit->R11_0 = R11_0;
-    unit->R12_0 = R12_0;
-    unit->R13_0 = R13_0;
-    unit->R14_0 = R14_0;
-    unit->R15_0 = R15_0;
-    unit->R16_0 = R16_0;
-    unit->R17_0 = R17_0;
-    unit->R18_0 = R18_0;
-    unit->R19_0 = R19_0;
-    unit->R20_0 = R20_0;
-    unit->R21_0 = R21_0;
-    unit->R22_0 = R22_0;
-    unit->R23_0 = R23_0;
-    unit->R24_0 = R24_0;
-    unit->R25_0 = R25_0;
-    unit->R26_0 = R26_0;
-    unit->R27_0 = R27_0;
-    unit->R28_0 = R28_0;
-    unit->R29_0 = R29_0;
-    unit->R30_0 = R30_0;
-    unit->R31_0 = R31_0;
-    unit->R32_0 = R32_0;
-    unit->R33_0 = R33_0;
-    unit->R34_0 = R34_0;
-    unit->R35_0 = R35_0;
-    unit->R36_0 = R36_0;
-    unit->R37_0 = R37_0;
-    unit->R38_0 = R38_0;
-    unit->R39_0 = R39_0;
 }
 
 
@@ -1105,7 +599,7 @@ static inline void gverb_set_roomsize(GVerb *unit, const float a)
 	    unit->roomsize = a;
 	    };
 
-  unit->largestdelay = SAMPLERATE * unit->roomsize / 340.0; // * 0.00294f;
+  unit->largestdelay = unit->coresamplerate * unit->roomsize / 340.0; // * 0.00294f;
 
 // the line below causes everything to blow up.... why?????
 //  unit->fdnlens[0] = nearestprime((int)(unit->largestdelay), 0.5);
@@ -1141,7 +635,7 @@ static inline void gverb_set_revtime(GVerb *unit, float a)
   unit->revtime = a;
 
   ga = 0.001;
-  n = SAMPLERATE * a;
+  n = unit->coresamplerate * a;
   unit->alpha = (double)powf(ga,(float)(1.f/n));
 
   for(i = 0; i < FDNORDER; i++) {
@@ -1194,7 +688,31 @@ static inline float gverb_set_drylevel(GVerb *unit, float a)
 
 void GVerb_Ctor(GVerb *unit)
 {
-    SETCALC(GVerb_next);
+    // optional trailing input (old synthdefs simply lack it):
+    // 0 = full rate, 1 = core at sr/2, 2 = core at sr/4
+    int downsample = (unit->mNumInputs > 10) ? (int)IN0(10) : 0;
+    int factor = (downsample >= 2) ? 4 : ((downsample == 1) ? 2 : 1);
+    int bufLength = unit->mWorld->mFullRate.mBufLength;
+    if (factor > 1 && (bufLength % factor) != 0)
+	factor = 1;	// block too small to split
+
+    if (factor > 1) {
+	// scratch: decimated input + core L + core R, plus a half-block for
+	// the intermediate stage of the by-4 cascades
+	int m = bufLength / factor;
+	unit->corebuf = (float*)RTAlloc(unit->mWorld, (3 * m + bufLength / 2) * sizeof(float));
+	if (!unit->corebuf) factor = 1;
+    } else
+	unit->corebuf = 0;
+
+    unit->downsample = factor;
+    memset(unit->decim, 0, sizeof(unit->decim));
+    memset(unit->interp, 0, sizeof(unit->interp));
+    if (factor > 1)
+	SETCALC(GVerb_next_downsampled);
+    else
+	SETCALC(GVerb_next);
+
     float roomsize = unit->roomsize = IN0(1);
     float revtime = unit->revtime =  IN0(2);
     float damping = unit->damping = IN0(3);
@@ -1206,15 +724,19 @@ void GVerb_Ctor(GVerb *unit)
 
     float maxroomsize = unit->maxroomsize = IN0(9);
 
-    float maxdelay = unit->maxdelay = SAMPLERATE*maxroomsize/340.f;
-    float largestdelay = unit->largestdelay = SAMPLERATE*roomsize/340.f;
+    // every length and decay constant below derives from the rate the core
+    // actually runs at
+    float coresr = unit->coresamplerate = SAMPLERATE / (float)factor;
+
+    float maxdelay = unit->maxdelay = coresr*maxroomsize/340.f;
+    float largestdelay = unit->largestdelay = coresr*roomsize/340.f;
 
     // make the inputdamper
     unit->inputdamper = make_damper(unit, 1. - inputbandwidth);
 
     //float ga = powf(10.f, -60.f/20.f);
     float ga = 0.001f;
-    float n = SAMPLERATE * revtime;
+    float n = coresr * revtime;
     double alpha = unit->alpha = pow((double)ga, 1./(double)n);
     float gbmul[4] = {1.000, 0.816490, 0.707100, 0.632450};
     for(int i = 0; i < FDNORDER; ++i){
@@ -1286,6 +808,7 @@ void GVerb_Ctor(GVerb *unit)
 
 void GVerb_Dtor(GVerb *unit)
 {
+   if (unit->corebuf) RTFree(unit->mWorld, unit->corebuf);
    free_damper(unit, unit->inputdamper);
    free_fixeddelay(unit, unit->tapdelay);
 
@@ -1297,22 +820,15 @@ void GVerb_Dtor(GVerb *unit)
    }
 }
 
-void GVerb_next(GVerb* unit, int inNumSamples)
+/*	the FDN core, shared by the full-rate and downsampled calc functions.
+	slopemul rescales the per-sample parameter slopes (computed for a full
+	block of full-rate samples) to the number of samples actually run. */
+static void GVerb_process(GVerb* unit, const float* in, float* outl, float* outr,
+	int inNumSamples, float drylevel, float earlylevel, float taillevel, float slopemul)
 {
-    float* in = IN(0);
-    float* outl = OUT(0);
-    float* outr = OUT(1);
-    float roomsize = IN0(1);
-    float revtime = IN0(2);
-    float damping = IN0(3);
-    float inputbandwidth = IN0(4);
-    //float spread = IN0(5); // spread can only be set at inittime
-    float drylevel = IN0(6);
-    float earlylevel = IN0(7);
-    float taillevel = IN0(8);
     float earlylevelslope, taillevelslope, drylevelslope;
-    float* fdngainslopes;
-    float* tapgainslopes;
+    float fdngainslopes[FDNORDER];
+    float tapgainslopes[FDNORDER];
     g_diffuser** ldifs = unit->ldifs;
     g_diffuser** rdifs = unit->rdifs;
     float* u = unit->u;
@@ -1327,25 +843,14 @@ void GVerb_next(GVerb* unit, int inNumSamples)
     float* fdngains = unit->fdngains;
     int* fdnlens = unit->fdnlens;
 
-    if((roomsize != unit->roomsize) || (revtime != unit->revtime) || (damping != unit->damping) ||
-	    (inputbandwidth != unit->inputbandwidth) || (drylevel != unit->drylevel) ||
-	    (earlylevel != unit->earlylevel) || (taillevel != unit->taillevel)) {
-	// these should calc slopes for k-rate interpolation
-	gverb_set_roomsize(unit, roomsize);
-	gverb_set_revtime(unit, revtime);
-	gverb_set_damping(unit, damping);
-	gverb_set_inputbandwidth(unit, inputbandwidth);
-	drylevel = gverb_set_drylevel(unit, drylevel);
-	earlylevel = gverb_set_earlylevel(unit, earlylevel);
-	taillevel = gverb_set_taillevel(unit, taillevel);
+    earlylevelslope = unit->earlylevelslope * slopemul;
+    taillevelslope = unit->taillevelslope * slopemul;
+    drylevelslope = unit->drylevelslope * slopemul;
+    for(int i = 0; i < FDNORDER; i++){
+	fdngainslopes[i] = unit->fdngainslopes[i] * slopemul;
+	tapgainslopes[i] = unit->tapgainslopes[i] * slopemul;
 	}
 
-    earlylevelslope = unit->earlylevelslope;
-    taillevelslope = unit->taillevelslope;
-    drylevelslope = unit->drylevelslope;
-    fdngainslopes = unit->fdngainslopes;
-    tapgainslopes = unit->tapgainslopes;
-
 
     for(int i = 0; i < inNumSamples; i++){
 	float sign, sum, lsum, rsum, x;
@@ -1403,33 +908,137 @@ void GVerb_next(GVerb* unit, int inNumSamples)
 	    }
 	}
 
-    // store vals back to the struct
+    // clear the slopes
     for(int i = 0; i < FDNORDER; i++){
-	unit->ldifs[i] = ldifs[i];
-	unit->rdifs[i] = rdifs[i];
-	unit->u[i] = u[i];
-	unit->f[i] = f[i];
-	unit->d[i] = d[i];
-	unit->tapgains[i] = tapgains[i];
-	unit->taps[i] = taps[i];
-	unit->fdndamps[i] = fdndamps[i];
-	unit->fdndels[i] = fdndels[i];
-	unit->fdngains[i] = fdngains[i];
-	unit->fdnlens[i] = fdnlens[i];
 	unit->fdngainslopes[i] = 0.f;
 	unit->tapgainslopes[i] = 0.f;
 	}
-    unit->inputdamper = inputdamper;
-    unit->tapdelay = tapdelay;
-    // clear the slopes
     unit->earlylevelslope = unit->taillevelslope = unit->drylevelslope = 0.f;
 }
 
+/*	parameter handling shared by both calc functions; leaves the possibly
+	updated level values in the passed slots. */
+static void GVerb_handleParams(GVerb* unit, float roomsize, float revtime, float damping,
+	float inputbandwidth, float* drylevel, float* earlylevel, float* taillevel)
+{
+    if((roomsize != unit->roomsize) || (revtime != unit->revtime) || (damping != unit->damping) ||
+	    (inputbandwidth != unit->inputbandwidth) || (*drylevel != unit->drylevel) ||
+	    (*earlylevel != unit->earlylevel) || (*taillevel != unit->taillevel)) {
+	// these should calc slopes for k-rate interpolation
+	gverb_set_roomsize(unit, roomsize);
+	gverb_set_revtime(unit, revtime);
+	gverb_set_damping(unit, damping);
+	gverb_set_inputbandwidth(unit, inputbandwidth);
+	*drylevel = gverb_set_drylevel(unit, *drylevel);
+	*earlylevel = gverb_set_earlylevel(unit, *earlylevel);
+	*taillevel = gverb_set_taillevel(unit, *taillevel);
+	}
+}
+
+void GVerb_next(GVerb* unit, int inNumSamples)
+{
+    float* in = IN(0);
+    float* outl = OUT(0);
+    float* outr = OUT(1);
+    float roomsize = IN0(1);
+    float revtime = IN0(2);
+    float damping = IN0(3);
+    float inputbandwidth = IN0(4);
+    //float spread = IN0(5); // spread can only be set at inittime
+    float drylevel = IN0(6);
+    float earlylevel = IN0(7);
+    float taillevel = IN0(8);
+
+    GVerb_handleParams(unit, roomsize, revtime, damping, inputbandwidth,
+	&drylevel, &earlylevel, &taillevel);
+
+    GVerb_process(unit, in, outl, outr, inNumSamples, drylevel, earlylevel, taillevel, 1.f);
+}
+
+void GVerb_next_downsampled(GVerb* unit, int inNumSamples)
+{
+    float* in = IN(0);
+    float* outl = OUT(0);
+    float* outr = OUT(1);
+    float roomsize = IN0(1);
+    float revtime = IN0(2);
+    float damping = IN0(3);
+    float inputbandwidth = IN0(4);
+    //float spread = IN0(5); // spread can only be set at inittime
+    float drylevel = IN0(6);
+    float earlylevel = IN0(7);
+    float taillevel = IN0(8);
+
+    GVerb_handleParams(unit, roomsize, revtime, damping, inputbandwidth,
+	&drylevel, &earlylevel, &taillevel);
+
+    const int factor = unit->downsample;
+    const int m = inNumSamples / factor;
+    float* corein = unit->corebuf;
+    float* corel = corein + m;
+    float* corer = corel + m;
+    float* scratch = corer + m;	// inNumSamples/2 floats, used by the by-4 cascades
+
+    // decimate the input to the core rate. NaNs are zapped before they can
+    // lodge in the filter history (the core guards again, harmlessly).
+    if (factor == 2) {
+	for (int i = 0; i < m; i++) {
+	    float x0 = in[2*i], x1 = in[2*i+1];
+	    if (sc_isnan(x0)) x0 = 0.f;
+	    if (sc_isnan(x1)) x1 = 0.f;
+	    halfband_do(&unit->decim[0], x0);
+	    corein[i] = halfband_do(&unit->decim[0], x1);
+	}
+    } else {
+	const int h = inNumSamples / 2;
+	for (int i = 0; i < h; i++) {
+	    float x0 = in[2*i], x1 = in[2*i+1];
+	    if (sc_isnan(x0)) x0 = 0.f;
+	    if (sc_isnan(x1)) x1 = 0.f;
+	    halfband_do(&unit->decim[0], x0);
+	    scratch[i] = halfband_do(&unit->decim[0], x1);
+	}
+	for (int i = 0; i < m; i++) {
+	    halfband_do(&unit->decim[1], scratch[2*i]);
+	    corein[i] = halfband_do(&unit->decim[1], scratch[2*i+1]);
+	}
+    }
+
+    // the slopes were computed for a full block of full-rate samples; scale
+    // them so the sweep still completes within this block
+    GVerb_process(unit, corein, corel, corer, m, drylevel, earlylevel, taillevel, (float)factor);
+
+    // interpolate both outputs back up: zero-stuff then the same half-band
+    // filter, with 6dB of gain per octave to restore the level
+    float* const coreouts[2] = { corel, corer };
+    float* const outs[2] = { outl, outr };
+    for (int ch = 0; ch < 2; ch++) {
+	const float* src = coreouts[ch];
+	float* dst = outs[ch];
+	if (factor == 2) {
+	    for (int i = 0; i < m; i++) {
+		dst[2*i]   = 2.f * halfband_do(&unit->interp[ch][0], src[i]);
+		dst[2*i+1] = 2.f * halfband_do(&unit->interp[ch][0], 0.f);
+	    }
+	} else {
+	    for (int i = 0; i < m; i++) {
+		scratch[2*i]   = 2.f * halfband_do(&unit->interp[ch][0], src[i]);
+		scratch[2*i+1] = 2.f * halfband_do(&unit->interp[ch][0], 0.f);
+	    }
+	    const int h = inNumSamples / 2;
+	    for (int i = 0; i < h; i++) {
+		dst[2*i]   = 2.f * halfband_do(&unit->interp[ch][1], scratch[i]);
+		dst[2*i+1] = 2.f * halfband_do(&unit->interp[ch][1], 0.f);
+	    }
+	}
+    }
+}
+
 PluginLoad(Reverb)
 {
 	ft = inTable;
-	DefineSimpleUnit(FreeVerb);
-	DefineSimpleUnit(FreeVerb2);
+	DefineDtorUnit(FreeVerb);
+	DefineDtorUnit(FreeVerb2);
 	DefineDtorUnit(GVerb);
 }
 
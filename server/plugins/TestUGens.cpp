@@ -25,6 +25,7 @@
 
 #include "SC_PlugIn.h"
 #include <cstdio>
+#include <cstring>
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -34,6 +35,23 @@ inline int sc_fpclassify(float x)
 	return std::fpclassify(x);
 }
 
+// branch-free scan over a block: returns nonzero iff any sample is NaN,
+// Inf or denormal. classifying on the bit pattern keeps the loop free of
+// branches and calls, so the compiler vectorizes it; the common all-clean
+// block costs a single pass and the per-sample reporting loops below only
+// run when something is actually wrong.
+static inline int32 scanBadValues(const float *in, int numSamples)
+{
+	const int32 *bits = (const int32*)in;
+	int32 any = 0;
+	for (int i = 0; i < numSamples; ++i) {
+		int32 sampbits = bits[i];
+		int32 expbits = sampbits & 0x7f800000;
+		any |= (expbits == 0x7f800000) | ((expbits == 0) & ((sampbits & 0x007fffff) != 0));
+	}
+	return any;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 static InterfaceTable *ft;
@@ -79,6 +97,22 @@ void CheckBadValues_next(CheckBadValues* unit, int inNumSamples)
 	float samp;
 	int classification;
 
+	// fast path: nothing bad in the block
+	if (!scanBadValues(IN(0), inNumSamples)) {
+		switch(post) {
+		case 2:
+			if (unit->prevclass != FP_NORMAL) {
+				// report the transition back to normal through the slow loop
+				break;
+			}
+			unit->sameCount += inNumSamples;
+			// fall through
+		default:
+			Clear(inNumSamples, OUT(0));
+			return;
+		}
+	}
+
 	switch(post) {
 	case 1:		// post a line on every bad value
 		LOOP1(inNumSamples,
@@ -212,6 +246,12 @@ void Sanitize_next_aa(Sanitize* unit, int inNumSamples)
 	float *replace = IN(1);
 	float *out = OUT(0);
 
+	// fast path: nothing to replace in the block
+	if (!scanBadValues(in, inNumSamples)) {
+		if (out != in) memcpy(out, in, inNumSamples * sizeof(float));
+		return;
+	}
+
 	float samp;
 	for (int i = 0; i < inNumSamples; i++)
 	{
@@ -235,6 +275,12 @@ void Sanitize_next_ak(Sanitize* unit, int inNumSamples)
 	float replace = IN0(1);
 	float *out = OUT(0);
 
+	// fast path: nothing to replace in the block
+	if (!scanBadValues(in, inNumSamples)) {
+		if (out != in) memcpy(out, in, inNumSamples * sizeof(float));
+		return;
+	}
+
 	float samp;
 	for (int i = 0; i < inNumSamples; i++)
 	{
@@ -363,6 +363,10 @@ DEFINE_UNARY_OP_FUNCS(sinh, sinh)
 DEFINE_UNARY_OP_FUNCS(cosh, cosh)
 DEFINE_UNARY_OP_FUNCS(tanh, tanh)
 
+// selected instead of tanh when the server runs with fast math (-F). the
+// approximation is branch-free, so the sample loop vectorizes.
+DEFINE_UNARY_OP_FUNCS(tanh_fast, sc_tanh_fast)
+
 
 #ifdef NOVA_SIMD
 NOVA_WRAPPER(sin, sin)
@@ -608,7 +612,7 @@ static UnaryOpFunc ChooseNormalFunc(UnaryOpUGen *unit)
 		case opArcTan : func = &atan_a; break;
 		case opSinH : func = &sinh_a; break;
 		case opCosH : func = &cosh_a; break;
-		case opTanH : func = &tanh_a; break;
+		case opTanH : func = unit->mWorld->mFastMath ? &tanh_fast_a : &tanh_a; break;
 			
 		case opRand : func = &rand_a; break;
 		case opRand2 : func = &rand2_a; break;
@@ -673,7 +677,7 @@ static UnaryOpFunc ChooseOneFunc(UnaryOpUGen *unit)
 		case opArcTan : func = &atan_1; break;
 		case opSinH : func = &sinh_1; break;
 		case opCosH : func = &cosh_1; break;
-		case opTanH : func = &tanh_1; break;
+		case opTanH : func = unit->mWorld->mFastMath ? &tanh_fast_1 : &tanh_1; break;
 			
 		case opRand : func = &rand_1; break;
 		case opRand2 : func = &rand2_1; break;
@@ -739,7 +743,7 @@ static UnaryOpFunc ChooseDemandFunc(UnaryOpUGen *unit)
 		case opArcTan : func = &atan_d; break;
 		case opSinH : func = &sinh_d; break;
 		case opCosH : func = &cosh_d; break;
-		case opTanH : func = &tanh_d; break;
+		case opTanH : func = unit->mWorld->mFastMath ? &tanh_fast_d : &tanh_d; break;
 		
 		case opRand : func = &rand_d; break;
 		case opRand2 : func = &rand2_d; break;
@@ -807,7 +811,7 @@ static UnaryOpFunc ChooseNovaSimdFunc(UnaryOpUGen *unit)
 		case opArcTan : func = &atan_nova; break;
 		case opSinH : func = &sinh_a; break;
 		case opCosH : func = &cosh_a; break;
-		case opTanH : func = &tanh_nova; break;
+		case opTanH : func = unit->mWorld->mFastMath ? &tanh_fast_a : &tanh_nova; break;
 
 		case opRand : func = &rand_a; break;
 		case opRand2 : func = &rand2_a; break;
@@ -866,7 +870,7 @@ static UnaryOpFunc ChooseNovaSimdFunc(UnaryOpUGen *unit)
 		case opArcTan : func = &atan_nova; break;
 		case opSinH : func = &sinh_a; break;
 		case opCosH : func = &cosh_a; break;
-		case opTanH : func = &tanh_nova; break;
+		case opTanH : func = unit->mWorld->mFastMath ? &tanh_fast_a : &tanh_nova; break;
 
 		case opRand : func = &rand_a; break;
 		case opRand2 : func = &rand2_a; break;
@@ -187,12 +187,31 @@ private:
 };
 
 
+/* open addressing hash table with Robin Hood probing.
+ *
+ * On every collision the entry that is further from its home slot keeps its
+ * place, so probe sequence lengths stay short and uniform even when the table
+ * approaches its load limit - lookups no longer degrade with long collision
+ * runs the way plain linear probing does. Deletion is done by backward shift
+ * instead of tombstones.
+ *
+ * inMaxItems is a hard cap on the number of entries. With inCanResize true
+ * the table starts small and doubles towards its final size as it fills;
+ * the old table is drained a few entries per Add/Remove, so a resize never
+ * causes an O(table) rehash inside one real-time command.
+ */
 template<class T, class Allocator>
 class IntHashTable
 {
+	static const int32 kInitialTableSize = 2048;
+	static const int32 kMigrateChunkSize = 4;
+
 	Allocator *mPool;
 	int32 mNumItems, mMaxItems, mTableSize, mHashMask;
 	T** mItems;
+	// previous table while an incremental resize is in flight
+	T** mOldItems;
+	int32 mOldTableSize, mOldHashMask, mOldNumItems, mMigrateIndex;
 	bool mCanResize;
 
 public:
@@ -203,12 +222,16 @@ public:
 		mNumItems = 0;
 		mMaxItems = inMaxItems;
 		mTableSize = mMaxItems << 1;
+		if (inCanResize && mTableSize > kInitialTableSize) mTableSize = kInitialTableSize;
 		mItems = AllocTable(mTableSize);
 		mHashMask = mTableSize - 1;
+		mOldItems = 0;
+		mOldTableSize = mOldHashMask = mOldNumItems = mMigrateIndex = 0;
 		mCanResize = inCanResize;
 	}
 
 	~IntHashTable() {
+		if (mOldItems) mPool->Free(mOldItems);
 		mPool->Free(mItems);
 	}
 
@@ -226,55 +249,55 @@ public:
 		return items;
 	}
 
-	void Resize()
-	{
-		int32 newSize = sc_max(mTableSize << 1, 32);
-		T** oldItems = mItems;
-		mItems = AllocTable(newSize);
-		for (int i=0; i<mTableSize; ++i) {
-			T* item = oldItems[i];
-			if (item) Add(item);
-		}
-		mTableSize = newSize;
-		mMaxItems = mTableSize >> 1;
-		mHashMask = mTableSize - 1;
-		mPool->Free(oldItems);
-		//printf("mMaxItems %d   mTableSize %d   newSize %d\n", mMaxItems, mTableSize, newSize);
-	}
-
 	bool Add(T* inItem)
 	{
-		//printf("mNumItems %d\n", mNumItems);
-		//printf("mMaxItems %d\n", mMaxItems);
-		//printf("mCanResize %d\n", mCanResize);
-		if (mNumItems >= mMaxItems) {
-			if (!mCanResize) return false;
-			Resize();
+		MigrateSome(kMigrateChunkSize);
+
+		int32 hash = GetHash(inItem);
+		int32 key = GetKey(inItem);
+
+		int32 index = FindIndex(mItems, mHashMask, hash, key);
+		if (index >= 0) return mItems[index] == inItem;
+		if (mOldItems) {
+			index = FindIndex(mOldItems, mOldHashMask, hash, key);
+			if (index >= 0) return mOldItems[index] == inItem;
 		}
 
-		//printf("GetHash(inItem) %d\n", GetHash(inItem));
-		//printf("GetKey(inItem) %d\n", GetKey(inItem));
-		int32 index = IndexFor(GetHash(inItem), GetKey(inItem));
-		//printf("index %d\n", index);
+		if (mNumItems >= mMaxItems) return false;
 
-		T *item = mItems[index];
-		if (item) return item == inItem;
+		if (mCanResize && !mOldItems && mNumItems >= (mTableSize >> 1) && mTableSize < (mMaxItems << 1))
+			StartGrow();
 
-		mItems[index] = inItem;
+		Insert(mItems, mHashMask, inItem);
 		mNumItems++;
 		return true;
 	}
 
 	bool Remove(T* inItem)
 	{
-		int32 index = IndexFor(GetHash(inItem), GetKey(inItem));
-		//printf("rmv index %d hash %d key %d\n", index, GetHash(inItem), GetKey(inItem));
-		if (mItems[index] != inItem) return false;
-		mItems[index] = 0;
+		MigrateSome(1);
 
-		FixCollisionsFrom(index);
-		mNumItems--;
-		return true;
+		int32 hash = GetHash(inItem);
+		int32 key = GetKey(inItem);
+
+		int32 index = FindIndex(mItems, mHashMask, hash, key);
+		if (index >= 0) {
+			if (mItems[index] != inItem) return false;
+			RemoveAt(mItems, mHashMask, index);
+			mNumItems--;
+			return true;
+		}
+		if (mOldItems) {
+			index = FindIndex(mOldItems, mOldHashMask, hash, key);
+			if (index >= 0) {
+				if (mOldItems[index] != inItem) return false;
+				RemoveAt(mOldItems, mOldHashMask, index);
+				mOldNumItems--;
+				mNumItems--;
+				return true;
+			}
+		}
+		return false;
 	}
 
 	bool RemoveKey(int32 inKey)
@@ -284,28 +307,20 @@ public:
 		return Remove(item);
 	}
 
-	int32 IndexFor(int32 inHashID, int32 inKey) const
-	{
-		int index = inHashID & mHashMask;
-		for(;;) {
-			T *item = mItems[index];
-			if (!item) return index;
-			if (GetHash(item) == inHashID && inKey == GetKey(item)) return index;
-			index = (index + 1) & mHashMask;
-		}
-	}
-
 	T* Get(int32 inKey) const
 	{
-		//printf("Get key %d\n", inKey);
 		return Get(Hash(inKey), inKey);
 	}
 
 	T* Get(int32 inHashID, int32 inKey) const
 	{
-		int32 index = IndexFor(inHashID, inKey);
-		//printf("Get index %d  hash %d  key %d\n", index, inHashID, inKey);
-		return mItems[index];
+		int32 index = FindIndex(mItems, mHashMask, inHashID, inKey);
+		if (index >= 0) return mItems[index];
+		if (mOldItems) {
+			index = FindIndex(mOldItems, mOldHashMask, inHashID, inKey);
+			if (index >= 0) return mOldItems[index];
+		}
+		return 0;
 	}
 
 	bool Includes(T* inItem) const
@@ -326,23 +341,103 @@ public:
 				printf("%4d %4d %08X %08X\n", i, GetKey(item), GetHash(item), item);
 			}
 		}
+		if (mOldItems) {
+			printf("migrating, %d items left in old table:\n", mOldNumItems);
+			for (int i=0; i<mOldTableSize; ++i) {
+				T* item = mOldItems[i];
+				if (item) {
+					printf("%4d %4d %08X %08X\n", i, GetKey(item), GetHash(item), item);
+				}
+			}
+		}
 	}
 
 private:
-	void FixCollisionsFrom(int32 inIndex)
+	// how far a slot's occupant has been pushed from its home slot
+	static int32 ProbeDistance(int32 inHash, int32 inIndex, int32 inMask)
 	{
-		//printf("FixCollisionsFrom %d\n", inIndex);
-		int oldIndex = inIndex;
+		return (inIndex - inHash) & inMask;
+	}
+
+	static int32 FindIndex(T** items, int32 inMask, int32 inHashID, int32 inKey)
+	{
+		int32 index = inHashID & inMask;
+		int32 dist = 0;
 		for (;;) {
-			oldIndex = (oldIndex + 1) & mHashMask;
-			T *oldItem = mItems[oldIndex];
-			if (!oldItem) break;
-			int newIndex = IndexFor(GetHash(oldItem), GetKey(oldItem));
-			if (oldIndex != newIndex) {
-				//printf("swap %d %d\n", oldIndex, newIndex);
-				mItems[oldIndex] = mItems[newIndex];
-				mItems[newIndex] = oldItem;
+			T *item = items[index];
+			if (!item) return -1;
+			if (GetHash(item) == inHashID && inKey == GetKey(item)) return index;
+			// an occupant closer to home than we are proves the key is absent
+			if (ProbeDistance(GetHash(item), index, inMask) < dist) return -1;
+			index = (index + 1) & inMask;
+			++dist;
+		}
+	}
+
+	static void Insert(T** items, int32 inMask, T* inItem)
+	{
+		T *elem = inItem;
+		int32 index = GetHash(elem) & inMask;
+		int32 dist = 0;
+		for (;;) {
+			T *item = items[index];
+			if (!item) {
+				items[index] = elem;
+				return;
+			}
+			int32 itemDist = ProbeDistance(GetHash(item), index, inMask);
+			if (itemDist < dist) {
+				// rob the rich: displace the occupant that is closer to home
+				items[index] = elem;
+				elem = item;
+				dist = itemDist;
+			}
+			index = (index + 1) & inMask;
+			++dist;
+		}
+	}
+
+	static void RemoveAt(T** items, int32 inMask, int32 inIndex)
+	{
+		int32 index = inIndex;
+		for (;;) {
+			int32 next = (index + 1) & inMask;
+			T *nextItem = items[next];
+			if (!nextItem || ProbeDistance(GetHash(nextItem), next, inMask) == 0) break;
+			items[index] = nextItem;
+			index = next;
+		}
+		items[index] = 0;
+	}
+
+	void StartGrow()
+	{
+		mOldItems = mItems;
+		mOldTableSize = mTableSize;
+		mOldHashMask = mHashMask;
+		mOldNumItems = mNumItems;
+		mMigrateIndex = 0;
+
+		mTableSize = mTableSize << 1;
+		mItems = AllocTable(mTableSize);
+		mHashMask = mTableSize - 1;
+	}
+
+	void MigrateSome(int32 inCount)
+	{
+		if (!mOldItems) return;
+		while (inCount--) {
+			if (mOldNumItems == 0) {
+				mPool->Free(mOldItems);
+				mOldItems = 0;
+				return;
 			}
+			while (!mOldItems[mMigrateIndex])
+				mMigrateIndex = (mMigrateIndex + 1) & mOldHashMask;
+			T *item = mOldItems[mMigrateIndex];
+			RemoveAt(mOldItems, mOldHashMask, mMigrateIndex);
+			mOldNumItems--;
+			Insert(mItems, mHashMask, item);
 		}
 	}
 };
@@ -36,6 +36,7 @@ struct OSC_Packet
 {
 	char *mData;
 	int32 mSize;
+	int32 mCapacity; // payload bytes in the block; see RecycleOSCPacket
 	bool mIsBundle;
 
 	ReplyAddress mReplyAddr;
@@ -61,7 +61,9 @@ public:
 	}
 	void Perform(int64 inTime)
 	{
-		while (NextTime() <= inTime) {
+		// mSize guards Flush(): the empty-queue sentinel time compares
+		// equal to kMaxInt64 and would underflow Remove()
+		while (mSize && NextTime() <= inTime) {
 			Event event = Remove();
 			event.Perform();
 		}
@@ -123,4 +125,129 @@ private:
 	int64 mStabilityCounter;
 };
 
+
+/*	A timing-wheel front end for PriorityQueueT.
+
+	Scheduled events land unsorted in a wheel of kNumSlots buckets, each
+	kSlotWidth of OSC time wide (with the defaults: 512 slots of ~2ms, one
+	second of horizon), so insertion is O(1) instead of a heap sift. Once per
+	callback Advance() dumps the slots that have come due into the heap,
+	which restores the exact (time, stability count) order before the driver
+	drains events with NextTime()/Remove(). Events due immediately, beyond
+	the horizon, or arriving when the wheel pool is full bypass the wheel and
+	go straight into the heap, so the heap doubles as the overflow level and
+	total capacity is twice the old queue's.
+
+	NextTime(), Ready() and Remove() only see events released by the last
+	Advance(inTime); the driver must advance to the end of the current
+	callback interval before draining, and must not drain past it.
+*/
+template <class Event, int N, int SlotShiftBits = 23, int WheelBits = 9>
+class EventWheelQueueT
+{
+public:
+	static const int32 kNumSlots = 1 << WheelBits;
+	static const int32 kWheelMask = kNumSlots - 1;
+	static const int64 kSlotWidth = 1ll << SlotShiftBits;
+	static const int64 kHorizon = kSlotWidth << WheelBits;
+
+	EventWheelQueueT()
+	{
+		Empty();
+	}
+
+	bool Add(Event& inEvent)
+	{
+		int64 time = inEvent.mTime;
+		if (time < mAdvanceTime + kSlotWidth || time >= mAdvanceTime + kHorizon || mFreeHead < 0)
+			return mHeap.Add(inEvent);	// due now, beyond the horizon, or the pool is full
+
+		int32 slot = (int32)((time >> SlotShiftBits) & kWheelMask);
+		int32 node = mFreeHead;
+		mFreeHead = mNodes[node].mNext;
+		mNodes[node].mEvent = inEvent;
+		mNodes[node].mNext = -1;
+		if (mSlotTails[slot] < 0) mSlotHeads[slot] = node;	// keep arrival order within a slot
+		else mNodes[mSlotTails[slot]].mNext = node;
+		mSlotTails[slot] = node;
+		mWheelSize++;
+		return true;
+	}
+
+	/* release the wheel events due by inTime into the heap */
+	void Advance(int64 inTime)
+	{
+		if (inTime <= mAdvanceTime) return;
+		if (mWheelSize) {
+			int64 firstSlot = (mAdvanceTime >> SlotShiftBits) + 1;
+			int64 lastSlot = inTime >> SlotShiftBits;
+			if (lastSlot - firstSlot >= kNumSlots) lastSlot = firstSlot + kNumSlots - 1;
+			for (int64 i = firstSlot; i <= lastSlot && mWheelSize; ++i)
+				FlushSlot((int32)(i & kWheelMask));
+		}
+		mAdvanceTime = inTime;
+	}
+
+	void Perform(int64 inTime)
+	{
+		Advance(inTime);
+		mHeap.Perform(inTime);
+	}
+
+	int64 NextTime() { return mHeap.NextTime(); }
+	bool Ready(int64 inTime) { Advance(inTime); return mHeap.Ready(inTime); }
+	Event Remove() { return mHeap.Remove(); }
+
+	void Flush()
+	{
+		for (int32 i=0; i<kNumSlots && mWheelSize; ++i)
+			FlushSlot(i);
+		mHeap.Flush();
+	}
+
+	void Empty()
+	{
+		for (int32 i=0; i<kNumSlots; ++i)
+			mSlotHeads[i] = mSlotTails[i] = -1;
+		for (int32 i=0; i<N; ++i)
+			mNodes[i].mNext = i+1;
+		mNodes[N-1].mNext = -1;
+		mFreeHead = 0;
+		mWheelSize = 0;
+		mAdvanceTime = 0;
+		mHeap.Empty();
+	}
+
+	int Size() { return mHeap.Size() + mWheelSize; }
+
+private:
+	void FlushSlot(int32 inSlot)
+	{
+		int32 node = mSlotHeads[inSlot];
+		while (node >= 0) {
+			int32 next = mNodes[node].mNext;
+			mHeap.Add(mNodes[node].mEvent);	// a full heap drops the event, as before
+			mNodes[node].mNext = mFreeHead;
+			mFreeHead = node;
+			node = next;
+			mWheelSize--;
+		}
+		mSlotHeads[inSlot] = mSlotTails[inSlot] = -1;
+	}
+
+	struct Node
+	{
+		Event mEvent;
+		int32 mNext;
+	};
+
+	PriorityQueueT<Event, N> mHeap;
+	Node mNodes[N];
+	int32 mSlotHeads[kNumSlots];
+	int32 mSlotTails[kNumSlots];
+	int32 mFreeHead;
+	int32 mWheelSize;
+	int64 mAdvanceTime;
+};
+
 #endif
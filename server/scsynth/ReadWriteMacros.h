@@ -127,5 +127,31 @@ inline void readData(char *&buf, char *outData, size_t inLength)
 	buf += inLength;
 }
 
+inline int64 readInt64_be(char *&buf)
+{
+	int64 hi = readInt32_be(buf);
+	int64 lo = readInt32_be(buf);
+	return (hi << 32) | (lo & 0xFFFFFFFFLL);
+}
+
+inline void writeInt32_be(FILE *file, int32 inInt)
+{
+	fputc((inInt >> 24) & 255, file);
+	fputc((inInt >> 16) & 255, file);
+	fputc((inInt >> 8) & 255, file);
+	fputc(inInt & 255, file);
+}
+
+inline void writeInt64_be(FILE *file, int64 inInt)
+{
+	writeInt32_be(file, (int32)(inInt >> 32));
+	writeInt32_be(file, (int32)(inInt & 0xFFFFFFFFLL));
+}
+
+inline void writeData(FILE *file, const char *inData, size_t inLength)
+{
+	fwrite(inData, 1, inLength, file);
+}
+
 
 #endif
@@ -0,0 +1,340 @@
+/*
+    SuperCollider AAudio driver for Android
+    Copyright (c) 2017 SuperCollider contributors. All rights reserved.
+    Incorporating code from
+    SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "SC_CoreAudio.h"
+
+#if SC_AUDIO_API == SC_AUDIO_API_AAUDIO
+
+#include "SC_Prototypes.h"
+#include "SC_HiddenWorld.h"
+#include "SC_WorldOptions.h"
+#include "SC_BoundsMacros.h"
+#include "SC_Time.hpp"
+#include <sys/time.h>
+#include <math.h>
+#include <stdexcept>
+#include <stdlib.h>
+#include <string.h>
+
+void sc_SetDenormalFlags();
+
+int64 gOSCoffset = 0;
+
+static inline int64 GetCurrentOSCTime()
+{
+	struct timeval tv;
+	uint64 s, f;
+	gettimeofday(&tv, 0);
+	s = (uint64)tv.tv_sec + (uint64)kSECONDS_FROM_1900_to_1970;
+	f = (uint64)((double)tv.tv_usec * kMicrosToOSCunits);
+
+	return (s << 32) + f;
+}
+
+int64 oscTimeNow()
+{
+	return GetCurrentOSCTime();
+}
+
+int32 server_timeseed()
+{
+	int64 time = GetCurrentOSCTime();
+	return Hash((int32)(time >> 32) + Hash((int32)time));
+}
+
+void initializeScheduler()
+{
+	gOSCoffset = GetCurrentOSCTime();
+}
+
+static aaudio_data_callback_result_t SC_AAudioDataCallback(AAudioStream *stream,
+		void *userData, void *audioData, int32_t numFrames)
+{
+	SC_AAudioDriver *driver = (SC_AAudioDriver*)userData;
+	return driver->AAudioCallback(audioData, numFrames);
+}
+
+static void SC_AAudioErrorCallback(AAudioStream *stream, void *userData, aaudio_result_t error)
+{
+	// a disconnected stream (device change, headphone plug) stays dead; the
+	// host application is expected to stop and restart the server's driver.
+	scprintf("SC_AAudioDriver: stream error: %s\n", AAudio_convertResultToText(error));
+}
+
+SC_AAudioDriver::SC_AAudioDriver(struct World *inWorld)
+		: SC_AudioDriver(inWorld)
+		, mOutputStream(0)
+		, mInputStream(0)
+		, mInputBuffer(0)
+		, mInputChannelCount(0)
+		, mOutputChannelCount(0)
+{
+}
+
+SC_AAudioDriver::~SC_AAudioDriver()
+{
+	if (mOutputStream)
+		AAudioStream_close(mOutputStream);
+	if (mInputStream)
+		AAudioStream_close(mInputStream);
+	free(mInputBuffer);
+}
+
+bool SC_AAudioDriver::DriverSetup(int* outNumSamplesPerCallback, double* outSampleRate)
+{
+	AAudioStreamBuilder *builder;
+	aaudio_result_t result = AAudio_createStreamBuilder(&builder);
+	if (result != AAUDIO_OK) {
+		scprintf("SC_AAudioDriver: could not create stream builder: %s\n",
+				AAudio_convertResultToText(result));
+		return false;
+	}
+
+	// keep each callback a whole number of engine blocks
+	int numSamples = mPreferredHardwareBufferFrameSize
+			? mPreferredHardwareBufferFrameSize : mWorld->mBufLength;
+	numSamples = ((numSamples + mWorld->mBufLength - 1) / mWorld->mBufLength) * mWorld->mBufLength;
+
+	// exclusive mode bypasses the system mixer; AAudio falls back to shared
+	// by itself when the device is taken
+	AAudioStreamBuilder_setDirection(builder, AAUDIO_DIRECTION_OUTPUT);
+	AAudioStreamBuilder_setSharingMode(builder, AAUDIO_SHARING_MODE_EXCLUSIVE);
+	AAudioStreamBuilder_setPerformanceMode(builder, AAUDIO_PERFORMANCE_MODE_LOW_LATENCY);
+	AAudioStreamBuilder_setFormat(builder, AAUDIO_FORMAT_PCM_FLOAT);
+	AAudioStreamBuilder_setChannelCount(builder, mWorld->mNumOutputs);
+	if (mPreferredSampleRate)
+		AAudioStreamBuilder_setSampleRate(builder, mPreferredSampleRate);
+	AAudioStreamBuilder_setFramesPerDataCallback(builder, numSamples);
+	AAudioStreamBuilder_setDataCallback(builder, SC_AAudioDataCallback, this);
+	AAudioStreamBuilder_setErrorCallback(builder, SC_AAudioErrorCallback, this);
+
+	result = AAudioStreamBuilder_openStream(builder, &mOutputStream);
+	if (result != AAUDIO_OK) {
+		scprintf("SC_AAudioDriver: could not open output stream: %s\n",
+				AAudio_convertResultToText(result));
+		AAudioStreamBuilder_delete(builder);
+		return false;
+	}
+
+	mOutputChannelCount = AAudioStream_getChannelCount(mOutputStream);
+	int sampleRate = AAudioStream_getSampleRate(mOutputStream);
+
+	// double buffer: total latency tracks the burst size instead of the
+	// generous device default
+	int framesPerBurst = AAudioStream_getFramesPerBurst(mOutputStream);
+	AAudioStream_setBufferSizeInFrames(mOutputStream, 2 * framesPerBurst);
+
+	if (mWorld->mNumInputs) {
+		// no callback on the input stream: the output callback drives the
+		// engine and reads captured frames non-blocking
+		AAudioStreamBuilder_setDirection(builder, AAUDIO_DIRECTION_INPUT);
+		AAudioStreamBuilder_setChannelCount(builder, mWorld->mNumInputs);
+		AAudioStreamBuilder_setSampleRate(builder, sampleRate);
+		AAudioStreamBuilder_setFramesPerDataCallback(builder, AAUDIO_UNSPECIFIED);
+		AAudioStreamBuilder_setDataCallback(builder, 0, 0);
+
+		result = AAudioStreamBuilder_openStream(builder, &mInputStream);
+		if (result != AAUDIO_OK) {
+			scprintf("SC_AAudioDriver: could not open input stream, running without input: %s\n",
+					AAudio_convertResultToText(result));
+			mInputStream = 0;
+		} else {
+			mInputChannelCount = AAudioStream_getChannelCount(mInputStream);
+			mInputBuffer = (float*)malloc(numSamples * mInputChannelCount * sizeof(float));
+		}
+	}
+
+	AAudioStreamBuilder_delete(builder);
+
+	if (mWorld->mVerbosity >= 0) {
+		scprintf("SC_AAudioDriver: %d Hz, %d frames per callback, burst %d frames, %s mode\n",
+				sampleRate, numSamples, framesPerBurst,
+				AAudioStream_getSharingMode(mOutputStream) == AAUDIO_SHARING_MODE_EXCLUSIVE
+						? "exclusive" : "shared");
+	}
+
+	*outNumSamplesPerCallback = numSamples;
+	*outSampleRate = (double)sampleRate;
+	return true;
+}
+
+bool SC_AAudioDriver::DriverStart()
+{
+	if (mWorld->mVerbosity >= 1)
+		scprintf("->SC_AAudioDriver::DriverStart\n");
+
+	aaudio_result_t result;
+
+	// start the input first, so the first output callbacks find frames to read
+	if (mInputStream) {
+		result = AAudioStream_requestStart(mInputStream);
+		if (result != AAUDIO_OK) {
+			scprintf("SC_AAudioDriver: could not start input stream: %s\n",
+					AAudio_convertResultToText(result));
+			return false;
+		}
+	}
+
+	result = AAudioStream_requestStart(mOutputStream);
+	if (result != AAUDIO_OK) {
+		scprintf("SC_AAudioDriver: could not start output stream: %s\n",
+				AAudio_convertResultToText(result));
+		if (mInputStream)
+			AAudioStream_requestStop(mInputStream);
+		return false;
+	}
+
+	return true;
+}
+
+bool SC_AAudioDriver::DriverStop()
+{
+	if (mWorld->mVerbosity >= 1)
+		scprintf("->SC_AAudioDriver::DriverStop\n");
+
+	bool success = true;
+
+	if (AAudioStream_requestStop(mOutputStream) != AAUDIO_OK)
+		success = false;
+	if (mInputStream && AAudioStream_requestStop(mInputStream) != AAUDIO_OK)
+		success = false;
+
+	return success;
+}
+
+aaudio_data_callback_result_t SC_AAudioDriver::AAudioCallback(void *audioData, int32_t numFrames)
+{
+	sc_SetDenormalFlags();
+	World *world = mWorld;
+
+	try {
+		mFromEngine.Free();
+		mToEngine.PerformAll();
+		mOscPacketsToEngine.PerformAll();
+
+		float *outData = (float*)audioData;
+
+		int bufFrames = world->mBufLength;
+		int numBufs = numFrames / bufFrames;
+
+		float *inBuses = world->mAudioBus + world->mNumOutputs * bufFrames;
+		float *outBuses = world->mAudioBus;
+		int32 *inTouched = world->mAudioBusTouched + world->mNumOutputs;
+		int32 *outTouched = world->mAudioBusTouched;
+
+		int minInputs = sc_min(mInputChannelCount, (int)world->mNumInputs);
+		int minOutputs = sc_min(mOutputChannelCount, (int)world->mNumOutputs);
+
+		// pull what the input stream has captured so far; frames it has not
+		// delivered yet read as silence rather than blocking the callback
+		int framesRead = 0;
+		if (mInputStream) {
+			framesRead = AAudioStream_read(mInputStream, mInputBuffer, numFrames, 0);
+			if (framesRead < 0)
+				framesRead = 0;
+			if (framesRead < numFrames)
+				memset(mInputBuffer + framesRead * mInputChannelCount, 0,
+						(numFrames - framesRead) * mInputChannelCount * sizeof(float));
+		}
+
+		int64 oscTime = mOSCbuftime;
+		if (oscTime == 0)
+			oscTime = mOSCbuftime = GetCurrentOSCTime();
+		int64 oscInc = mOSCincrement;
+		double oscToSamples = mOSCtoSamples;
+
+		int bufFramePos = 0;
+
+		// main loop
+		for (int i = 0; i < numBufs; ++i, world->mBufCounter++, bufFramePos += bufFrames)
+		{
+			int32 bufCounter = world->mBufCounter;
+			int32 *tch;
+
+			// deinterleave+touch inputs
+			tch = inTouched;
+			for (int k = 0; k < minInputs; ++k) {
+				const float *src = mInputBuffer + bufFramePos * mInputChannelCount + k;
+				float *dst = inBuses + k * bufFrames;
+				for (int frame = 0; frame < bufFrames; ++frame, src += mInputChannelCount)
+					*dst++ = *src;
+				*tch++ = bufCounter;
+			}
+
+			// run engine
+			int64 schedTime;
+			int64 nextTime = oscTime + oscInc;
+			mScheduler.Advance(nextTime); // release due wheel events for draining
+			while ((schedTime = mScheduler.NextTime()) <= nextTime) {
+				float diffTime = (float)(schedTime - oscTime) * oscToSamples + 0.5;
+				float diffTimeFloor = floor(diffTime);
+				world->mSampleOffset = (int)diffTimeFloor;
+				world->mSubsampleOffset = diffTime - diffTimeFloor;
+
+				if (world->mSampleOffset < 0) world->mSampleOffset = 0;
+				else if (world->mSampleOffset >= world->mBufLength) world->mSampleOffset = world->mBufLength-1;
+
+				SC_ScheduledEvent event = mScheduler.Remove();
+				event.Perform();
+			}
+			world->mSampleOffset = 0;
+			world->mSubsampleOffset = 0.f;
+
+			World_Run(world);
+
+			// interleave touched outputs
+			tch = outTouched;
+			for (int k = 0; k < minOutputs; ++k) {
+				float *dst = outData + bufFramePos * mOutputChannelCount + k;
+				if (*tch++ == bufCounter) {
+					const float *src = outBuses + k * bufFrames;
+					for (int frame = 0; frame < bufFrames; ++frame, dst += mOutputChannelCount)
+						*dst = *src++;
+				} else {
+					for (int frame = 0; frame < bufFrames; ++frame, dst += mOutputChannelCount)
+						*dst = 0.f;
+				}
+			}
+
+			// update buffer time
+			oscTime = mOSCbuftime = nextTime;
+		}
+
+		// zero a partial tail, should the device ever ignore the requested
+		// fixed callback size
+		int tailFrames = numFrames - numBufs * bufFrames;
+		if (tailFrames > 0)
+			memset(outData + numBufs * bufFrames * mOutputChannelCount, 0,
+					tailFrames * mOutputChannelCount * sizeof(float));
+	} catch (std::exception& exc) {
+		scprintf("SC_AAudioDriver: exception in real time: %s\n", exc.what());
+	} catch (...) {
+		scprintf("SC_AAudioDriver: unknown exception in real time\n");
+	}
+
+	mAudioSync.Signal();
+
+	return AAUDIO_CALLBACK_RESULT_CONTINUE;
+}
+
+#endif // SC_AUDIO_API == SC_AUDIO_API_AAUDIO
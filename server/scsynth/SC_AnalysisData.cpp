@@ -0,0 +1,179 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "SC_AnalysisData.h"
+#include "SC_World.h"
+#include "SC_WorldOptions.h"
+#include "SC_HiddenWorld.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// read the whole file into malloc'd memory; fallback for platforms without
+// mmap and for files too small to be worth a mapping of their own.
+static char *AnalysisData_ReadFile(const char *inPath, size_t *outSize)
+{
+	FILE *file = fopen(inPath, "rb");
+	if (!file) return 0;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if (size <= 0) { fclose(file); return 0; }
+
+	char *data = (char*)malloc(size);
+	if (data && fread(data, 1, size, file) != (size_t)size) {
+		free(data);
+		data = 0;
+	}
+	fclose(file);
+	if (data) *outSize = (size_t)size;
+	return data;
+}
+
+static bool AnalysisData_Validate(const char *inPath, const char *inData, size_t inSize)
+{
+	if (inSize < sizeof(SC_AnalysisDataHeader)) {
+		scprintf("*** ERROR: analysis data file too short '%s'\n", inPath);
+		return false;
+	}
+	const SC_AnalysisDataHeader *header = (const SC_AnalysisDataHeader*)inData;
+	if (memcmp(header->mMagic, "SCAnData", 8) != 0) {
+		scprintf("*** ERROR: not an analysis data file '%s'\n", inPath);
+		return false;
+	}
+	if (header->mVersion != kAnalysisDataVersion) {
+		scprintf("*** ERROR: analysis data version mismatch '%s': file %d, server %d\n",
+			inPath, (int)header->mVersion, (int)kAnalysisDataVersion);
+		return false;
+	}
+	int32 numEntries = header->mNumEntries;
+	size_t tableEnd = sizeof(SC_AnalysisDataHeader) + (size_t)numEntries * sizeof(SC_AnalysisDataEntry);
+	if (numEntries < 0 || tableEnd > inSize) {
+		scprintf("*** ERROR: analysis data entry table out of range '%s'\n", inPath);
+		return false;
+	}
+	const SC_AnalysisDataEntry *entries =
+		(const SC_AnalysisDataEntry*)(inData + sizeof(SC_AnalysisDataHeader));
+	for (int32 i = 0; i < numEntries; ++i) {
+		const SC_AnalysisDataEntry *entry = entries + i;
+		if (!memchr(entry->mName, 0, kAnalysisDataNameLen)) {
+			scprintf("*** ERROR: analysis data entry name unterminated '%s'\n", inPath);
+			return false;
+		}
+		if (entry->mOffset < 0 || (entry->mOffset & 3) || entry->mNumFloats < 0
+				|| (size_t)entry->mOffset + (size_t)entry->mNumFloats * sizeof(float) > inSize) {
+			scprintf("*** ERROR: analysis data entry '%s' out of range '%s'\n",
+				entry->mName, inPath);
+			return false;
+		}
+	}
+	return true;
+}
+
+SC_AnalysisSegment *AnalysisData_Load(const char *inPath)
+{
+	char *data = 0;
+	size_t size = 0;
+	bool mapped = false;
+
+#ifndef _WIN32
+	int fd = open(inPath, O_RDONLY);
+	if (fd >= 0) {
+		struct stat status;
+		if (fstat(fd, &status) == 0 && status.st_size > 0) {
+			void *addr = mmap(0, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (addr != MAP_FAILED) {
+				data = (char*)addr;
+				size = status.st_size;
+				mapped = true;
+			}
+		}
+		close(fd);	// the mapping keeps the file alive
+	}
+#endif
+	if (!data)
+		data = AnalysisData_ReadFile(inPath, &size);
+	if (!data) {
+		scprintf("*** ERROR: could not open analysis data file '%s'\n", inPath);
+		return 0;
+	}
+
+	if (!AnalysisData_Validate(inPath, data, size)) {
+#ifndef _WIN32
+		if (mapped) { munmap(data, size); data = 0; }
+#endif
+		if (data) free(data);
+		return 0;
+	}
+
+	SC_AnalysisSegment *segment = (SC_AnalysisSegment*)malloc(sizeof(SC_AnalysisSegment));
+	if (!segment) return 0;
+	segment->mNext = 0;
+	segment->mName[0] = 0;
+	segment->mData = data;
+	segment->mSize = size;
+	segment->mMapped = mapped;
+	return segment;
+}
+
+void AnalysisData_Unmap(SC_AnalysisSegment *inSegment)
+{
+	if (!inSegment) return;
+#ifndef _WIN32
+	if (inSegment->mMapped)
+		munmap((void*)inSegment->mData, inSegment->mSize);
+	else
+#endif
+		free((void*)inSegment->mData);
+	free(inSegment);
+}
+
+const float *AnalysisData_Find(World *inWorld, const char *inSegmentName,
+	const char *inEntryName, uint32 *outNumFloats)
+{
+	if (outNumFloats) *outNumFloats = 0;
+	if (!inSegmentName || !inEntryName) return 0;
+
+	SC_AnalysisSegment *segment = inWorld->hw->mAnalysisData;
+	for (; segment; segment = segment->mNext) {
+		if (strcmp(segment->mName, inSegmentName) == 0) break;
+	}
+	if (!segment) return 0;
+
+	const SC_AnalysisDataHeader *header = (const SC_AnalysisDataHeader*)segment->mData;
+	const SC_AnalysisDataEntry *entries =
+		(const SC_AnalysisDataEntry*)(segment->mData + sizeof(SC_AnalysisDataHeader));
+	for (int32 i = 0; i < header->mNumEntries; ++i) {
+		if (strcmp(entries[i].mName, inEntryName) == 0) {
+			if (outNumFloats) *outNumFloats = (uint32)entries[i].mNumFloats;
+			return (const float*)(segment->mData + entries[i].mOffset);
+		}
+	}
+	return 0;
+}
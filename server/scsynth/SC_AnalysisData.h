@@ -0,0 +1,77 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#ifndef _SC_AnalysisData_
+#define _SC_AnalysisData_
+
+#include "SC_Types.h"
+#include <stddef.h>
+
+// Shared read-only analysis data segments (/ad_load, /ad_free).
+//
+// Machine-listening plugins often need large constant tables - chroma
+// templates, filterbanks, trained weights - that are identical for every
+// instance of a UGen. A segment is a memory-mapped file holding named float
+// arrays; it is loaded once per server and every instance reads the same
+// pages, instead of each constructor deriving or copying its own tables.
+// Plugins look entries up through ft->fGetAnalysisData.
+//
+// File layout: SC_AnalysisDataHeader, then mNumEntries SC_AnalysisDataEntry
+// records, then the float data the entries point into. All fields are host
+// byte order; the files are machine-local, like the plugin binaries.
+
+struct SC_AnalysisDataHeader {
+	char mMagic[8];		// "SCAnData"
+	int32 mVersion;		// kAnalysisDataVersion
+	int32 mNumEntries;	// entry records follow the header immediately
+};
+
+struct SC_AnalysisDataEntry {
+	char mName[64];		// zero terminated
+	int32 mOffset;		// byte offset of this entry's floats from file start; 4-aligned
+	int32 mNumFloats;
+};
+
+const int32 kAnalysisDataVersion = 1;
+const int kAnalysisDataNameLen = 64;
+
+// one loaded segment. the list head lives in HiddenWorld and is only ever
+// touched from the RT thread (command Stage3), so lookups from unit
+// constructors need no locking.
+struct SC_AnalysisSegment {
+	struct SC_AnalysisSegment *mNext;
+	char mName[kAnalysisDataNameLen];
+	const char *mData;	// mapped (or, on win32, read) file image
+	size_t mSize;
+	bool mMapped;		// false: mData is malloc'd, not mmap'd
+};
+
+// map and validate a file; NRT, may block. returns 0 after posting an error.
+// the segment's mName is left empty for the caller to fill in.
+SC_AnalysisSegment *AnalysisData_Load(const char *inPath);
+
+// unmap and free a segment that is no longer linked; NRT.
+void AnalysisData_Unmap(SC_AnalysisSegment *inSegment);
+
+// resolve an entry; RT safe, returns 0 when segment or entry is absent.
+const float *AnalysisData_Find(struct World *inWorld, const char *inSegmentName,
+	const char *inEntryName, uint32 *outNumFloats);
+
+#endif
@@ -84,8 +84,8 @@ void SC_AndroidJNIAudioDriver::genaudio(short* arri, int numSamplesPassed)
 	int numFramesPerCallback = NumSamplesPerCallback();
 	// mOSCbuftime = oscTime;   // TODO, how do we set this?
     mFromEngine.Free();
-    mToEngine.Perform();
-    mOscPacketsToEngine.Perform();
+    mToEngine.PerformAll();
+    mOscPacketsToEngine.PerformAll();
 
     int numInputs = world->mNumInputs;
     int numOutputs = world->mNumOutputs;
@@ -131,6 +131,7 @@ void SC_AndroidJNIAudioDriver::genaudio(short* arri, int numSamplesPassed)
         // run engine
         int64 schedTime;
         int64 nextTime = oscTime + oscInc;
+        mScheduler.Advance(nextTime); // release due wheel events for draining
         while ((schedTime = mScheduler.NextTime()) <= nextTime) {
             float diffTime = (float)(schedTime - oscTime) * oscToSamples + 0.5;
             float diffTimeFloor = floor(diffTime);
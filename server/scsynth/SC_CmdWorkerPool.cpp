@@ -0,0 +1,149 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "SC_CmdWorkerPool.h"
+#include "SC_SequencedCommand.h"
+#include "SC_World.h"
+#include "SC_HiddenWorld.h"
+
+SC_CmdWorkerPool::SC_CmdWorkerPool(World *inWorld)
+	: mWorld(inWorld), mHead(0), mTail(0), mNumActive(0), mRunning(true)
+{
+	for (int i = 0; i < kNumWorkers; ++i)
+		mWorkers[i] = SC_Thread([this]() { WorkerLoop(); });
+}
+
+SC_CmdWorkerPool::~SC_CmdWorkerPool()
+{
+	{
+		lock_guard<SC_Lock> lock(mLock);
+		mRunning = false;
+		mHasWork.notify_all();
+	}
+	for (int i = 0; i < kNumWorkers; ++i)
+		mWorkers[i].join();
+
+	// commands still queued at shutdown are not run; their memory goes away
+	// with the world's allocation pool.
+	Entry *entry = mHead;
+	while (entry) {
+		Entry *next = entry->mNext;
+		delete entry;
+		entry = next;
+	}
+}
+
+void SC_CmdWorkerPool::Enqueue(SC_SequencedCommand *inCmd)
+{
+	Entry *entry = new Entry;
+	entry->mCmd = inCmd;
+	entry->mNext = 0;
+	entry->mKey = inCmd->ResourceKey();
+	entry->mBarrier = entry->mKey == SC_SequencedCommand::kBarrierResource;
+	entry->mActive = false;
+
+	lock_guard<SC_Lock> lock(mLock);
+	if (mTail) mTail->mNext = entry;
+	else mHead = entry;
+	mTail = entry;
+	mHasWork.notify_one();
+}
+
+// find the oldest entry that may start now. an entry conflicts with every
+// older entry of the same key; a barrier entry conflicts with everything.
+// mLock held.
+SC_CmdWorkerPool::Entry* SC_CmdWorkerPool::PickRunnable()
+{
+	for (Entry *entry = mHead; entry; entry = entry->mNext) {
+		if (entry->mBarrier) {
+			if (!entry->mActive && entry == mHead && mNumActive == 0)
+				return entry;
+			return 0;	// nothing younger starts until the barrier is done
+		}
+		if (entry->mActive) continue;
+
+		bool conflict = false;
+		for (Entry *earlier = mHead; earlier != entry; earlier = earlier->mNext) {
+			if (earlier->mKey == entry->mKey) {
+				conflict = true;
+				break;
+			}
+		}
+		if (!conflict) return entry;
+	}
+	return 0;
+}
+
+void SC_CmdWorkerPool::WorkerLoop()
+{
+	unique_lock<SC_Lock> lock(mLock);
+	while (true) {
+		Entry *entry = PickRunnable();
+		if (!entry) {
+			if (!mRunning) return;
+			mHasWork.wait(lock);
+			continue;
+		}
+		entry->mActive = true;
+		mNumActive++;
+		SC_SequencedCommand *cmd = entry->mCmd;
+		int key = entry->mKey;
+		bool barrier = entry->mBarrier;
+		lock.unlock();
+
+		// the serial domain keeps the old exclusion against the driver's
+		// NRT task loop; per-buffer commands instead hold the stripe lock
+		// of their buffer, which orders them against World_CopySndBuf
+		// readers without contending across buffers. barriers may touch any
+		// buffer (/b_gen copy reads a second one), so they take every
+		// stripe. CallNextStage runs the stage and forwards the command to
+		// the RT thread or frees it, so it must not be touched afterwards.
+		SC_Lock *stripes = mWorld->hw->mSndBufStripeLocks;
+		if (barrier) {
+			SC_Lock *nrtLock = reinterpret_cast<SC_Lock*>(mWorld->mNRTLock);
+			lock_guard<SC_Lock> nrtGuard(*nrtLock);
+			for (int i = 0; i < kSndBufLockStripes; ++i) stripes[i].lock();
+			cmd->CallNextStage();
+			for (int i = kSndBufLockStripes - 1; i >= 0; --i) stripes[i].unlock();
+		} else if (key < 0) {
+			SC_Lock *nrtLock = reinterpret_cast<SC_Lock*>(mWorld->mNRTLock);
+			lock_guard<SC_Lock> nrtGuard(*nrtLock);
+			cmd->CallNextStage();
+		} else {
+			lock_guard<SC_Lock> stripeGuard(stripes[key % kSndBufLockStripes]);
+			cmd->CallNextStage();
+		}
+
+		lock.lock();
+		mNumActive--;
+		if (mHead == entry) mHead = entry->mNext;
+		else {
+			Entry *earlier = mHead;
+			while (earlier->mNext != entry) earlier = earlier->mNext;
+			earlier->mNext = entry->mNext;
+		}
+		if (mTail == entry) {
+			mTail = mHead;
+			while (mTail && mTail->mNext) mTail = mTail->mNext;
+		}
+		delete entry;
+		mHasWork.notify_all();
+	}
+}
@@ -0,0 +1,81 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#ifndef _SC_CmdWorkerPool_
+#define _SC_CmdWorkerPool_
+
+#include "SC_Lock.h"
+
+class SC_SequencedCommand;
+struct World;
+
+/*	Runs the non real time stages of sequenced commands on a small pool of
+	worker threads, so a slow disk command (/b_allocRead of a long file) no
+	longer delays unrelated commands behind it. Ordering is kept per
+	resource, not globally: two commands whose ResourceKey matches run in
+	arrival order, commands with different keys may run concurrently.
+
+	Commands with key kSerialResource form one mutually ordered domain and
+	run holding the world's NRT lock, which preserves the old serialization
+	against the driver's NRT task loop. Commands with a buffer index as key
+	touch only their own buffer's NRT state and run holding that buffer's
+	stripe lock (see kSndBufLockStripes), which orders them against
+	World_CopySndBuf readers of the same buffer. A kBarrierResource command
+	waits for everything enqueued before it, blocks everything after it,
+	and holds the NRT lock plus every stripe while it runs.
+
+	The real time stages are unaffected; commands still hop to the RT thread
+	through the audio driver FIFOs, and the pool only sees them between
+	those hops (see SC_SequencedCommand::Dispatch). */
+class SC_CmdWorkerPool
+{
+public:
+	enum { kNumWorkers = 2 };
+
+	SC_CmdWorkerPool(World *inWorld);
+	~SC_CmdWorkerPool();	// discards queued commands without running them
+
+	// called from the driver's NRT thread
+	void Enqueue(SC_SequencedCommand *inCmd);
+
+private:
+	struct Entry
+	{
+		SC_SequencedCommand *mCmd;
+		Entry *mNext;
+		int mKey;
+		bool mBarrier;
+		bool mActive;	// stays in the queue while running, so later
+						// same-key entries see the conflict
+	};
+
+	Entry* PickRunnable();	// mLock held
+	void WorkerLoop();
+
+	World *mWorld;
+	Entry *mHead, *mTail;
+	int mNumActive;
+	bool mRunning;
+	SC_Lock mLock;
+	condition_variable_any mHasWork;
+	SC_Thread mWorkers[kNumWorkers];
+};
+
+#endif
@@ -50,6 +50,58 @@
 
 bool ProcessOSCPacket(World *inWorld, OSC_Packet *inPacket);
 
+// recycle pool for network packet envelopes. Control surfaces can sustain
+// thousands of small messages per second; recycling the envelope+payload
+// block keeps steady-state command traffic from touching the allocator at
+// all and stops long runs from fragmenting the heap. Slots come in
+// power-of-two payload classes so a pooled block is never resized: small
+// control messages, /d_recv sized blobs and full UDP datagrams each reuse
+// blocks of their own class. Packets are allocated on the socket listener
+// threads (UDP and TCP share these paths) and released on the non real
+// time thread, never on the audio thread, so a lock is fine here.
+const int32 kPacketPoolMinPayload = 512;
+const int32 kPacketPoolMaxPayload = 65536;
+const int32 kPacketPoolNumClasses = 8; // 512, 1k, ... 64k
+
+// keep many free slots of the small classes, few of the big ones
+static const int32 kPacketPoolMaxFree[kPacketPoolNumClasses] = { 64, 64, 32, 32, 16, 8, 4, 2 };
+
+static SC_Lock gPacketPoolLock;
+static OSC_Packet *gPacketPoolFreeList[kPacketPoolNumClasses];
+static int32 gPacketPoolNumFree[kPacketPoolNumClasses];
+
+// payload capacity -> size class, or -1 if the block is not poolable
+static inline int32 PacketPoolClass(int32 inCapacity)
+{
+	int32 size = kPacketPoolMinPayload;
+	for (int32 i = 0; i < kPacketPoolNumClasses; ++i, size <<= 1) {
+		if (inCapacity == size) return i;
+	}
+	return -1;
+}
+
+// take a packet back if its block fits a pool class. Returns false when
+// the caller still owns the memory and has to free() it.
+bool RecycleOSCPacket(OSC_Packet *inPacket)
+{
+	if (inPacket->mData != (char*)inPacket + sizeof(OSC_Packet))
+		return false;
+	int32 classIndex = PacketPoolClass(inPacket->mCapacity);
+	if (classIndex < 0)
+		return false;
+	bool pooled = false;
+	gPacketPoolLock.lock();
+	if (gPacketPoolNumFree[classIndex] < kPacketPoolMaxFree[classIndex]) {
+		// free slots are linked through their payload
+		*(OSC_Packet**)(inPacket + 1) = gPacketPoolFreeList[classIndex];
+		gPacketPoolFreeList[classIndex] = inPacket;
+		gPacketPoolNumFree[classIndex]++;
+		pooled = true;
+	}
+	gPacketPoolLock.unlock();
+	return pooled;
+}
+
 namespace scsynth {
 
 const size_t kMaxUDPSize = 65535;
@@ -57,7 +109,42 @@ const size_t kMaxUDPSize = 65535;
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
-static bool UnrollOSCPacket(World *inWorld, int inSize, char *inData, OSC_Packet *inPacket)
+// allocate an OSC_Packet with its payload inline in the same block. one
+// allocation per incoming message instead of two, and FreeOSCPacket releases
+// envelope and payload with a single free(). small packets are served from
+// the recycle pool above when it has a slot.
+static OSC_Packet* AllocOSCPacket(int32 inDataSize, ReplyAddress *inReply)
+{
+	OSC_Packet *packet = 0;
+	int32 capacity = inDataSize;
+	if (inDataSize <= kPacketPoolMaxPayload) {
+		// round up to the size class, so the block recycles into its pool
+		int32 classIndex = 0;
+		capacity = kPacketPoolMinPayload;
+		while (capacity < inDataSize) {
+			capacity <<= 1;
+			classIndex++;
+		}
+		gPacketPoolLock.lock();
+		if (gPacketPoolFreeList[classIndex]) {
+			packet = gPacketPoolFreeList[classIndex];
+			gPacketPoolFreeList[classIndex] = *(OSC_Packet**)(packet + 1);
+			gPacketPoolNumFree[classIndex]--;
+		}
+		gPacketPoolLock.unlock();
+	}
+	if (!packet) {
+		packet = (OSC_Packet*)malloc(sizeof(OSC_Packet) + capacity);
+		if (!packet) return 0;
+	}
+	packet->mData = (char*)packet + sizeof(OSC_Packet);
+	packet->mSize = inDataSize;
+	packet->mCapacity = capacity;
+	packet->mReplyAddr = *inReply;
+	return packet;
+}
+
+static bool UnrollOSCPacket(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
 {
 	if (!strcmp(inData, "#bundle")) { // is a bundle
 		char *data;
@@ -79,26 +166,27 @@ static bool UnrollOSCPacket(World *inWorld, int inSize, char *inData, OSC_Packet
 
 		if (hasNestedBundle) {
 			if (len > 16) { // not an empty bundle
-				// add nested messages to bundle buffer
-				char *buf = (char*)malloc(len);
-				inPacket->mSize = len;
-				inPacket->mData = buf;
+				// rebuild the bundle without its nested bundle(s)
+				OSC_Packet *packet = AllocOSCPacket(len, inReply);
+				if (!packet) return false;
+				char *buf = packet->mData;
 
 				memcpy(buf, inData, 16); // copy bundle header
+				buf += 16;
 				data = inData + 16; // skip bundle header
 				while (data < dataEnd) {
 					int32 msgSize = OSCint(data);
 					data += sizeof(int32);
 					if (strcmp(data, "#bundle")) { // is a message
-						memcpy(buf, data-sizeof(int32), sizeof(int32) + msgSize);
-						buf += msgSize;
+						memcpy(buf, data - sizeof(int32), sizeof(int32) + msgSize);
+						buf += sizeof(int32) + msgSize;
 					}
 					data += msgSize;
 				}
 
 				// process this packet without its nested bundle(s)
-				if(!ProcessOSCPacket(inWorld, inPacket)) {
-					free(buf);
+				if (!ProcessOSCPacket(inWorld, packet)) {
+					if (!RecycleOSCPacket(packet)) free(packet);
 					return false;
 				}
 			}
@@ -109,35 +197,28 @@ static bool UnrollOSCPacket(World *inWorld, int inSize, char *inData, OSC_Packet
 				int32 msgSize = OSCint(data);
 				data += sizeof(int32);
 				if (!strcmp(data, "#bundle")) { // is a bundle
-					OSC_Packet* packet = (OSC_Packet*)malloc(sizeof(OSC_Packet));
-					memcpy(packet, inPacket, sizeof(OSC_Packet)); // clone inPacket
-
-					if(!UnrollOSCPacket(inWorld, msgSize, data, packet)) {
-						free(packet);
+					if (!UnrollOSCPacket(inWorld, msgSize, data, inReply))
 						return false;
-					}
 				}
 				data += msgSize;
 			}
 		} else { // !hasNestedBundle
-			char *buf = (char*)malloc(inSize);
-			inPacket->mSize = inSize;
-			inPacket->mData = buf;
-			memcpy(buf, inData, inSize);
+			OSC_Packet *packet = AllocOSCPacket(inSize, inReply);
+			if (!packet) return false;
+			memcpy(packet->mData, inData, inSize);
 
-			if(!ProcessOSCPacket(inWorld, inPacket)) {
-				free(buf);
+			if (!ProcessOSCPacket(inWorld, packet)) {
+				if (!RecycleOSCPacket(packet)) free(packet);
 				return false;
 			}
 		}
 	} else { // is a message
-		char *buf = (char*)malloc(inSize);
-		inPacket->mSize = inSize;
-		inPacket->mData = buf;
-		memcpy(buf, inData, inSize);
+		OSC_Packet *packet = AllocOSCPacket(inSize, inReply);
+		if (!packet) return false;
+		memcpy(packet->mData, inData, inSize);
 
-		if(!ProcessOSCPacket(inWorld, inPacket)) {
-			free(buf);
+		if (!ProcessOSCPacket(inWorld, packet)) {
+			if (!RecycleOSCPacket(packet)) free(packet);
 			return false;
 		}
 	}
@@ -152,6 +233,9 @@ boost::asio::io_service ioService;
 
 const int kTextBufSize = 65536;
 
+const size_t kTcpRecvBufSize = 65536;
+const int32 kMaxTcpPacketSize = 1 << 30;
+
 
 static void udp_reply_func(struct ReplyAddress *addr, char* msg, int size)
 {
@@ -167,6 +251,10 @@ static void udp_reply_func(struct ReplyAddress *addr, char* msg, int size)
 		printf("%s\n", errc.message().c_str());
 }
 
+// replies may now be sent from several command worker threads; the length
+// prefix and payload of one TCP reply must not interleave with another's
+static SC_Lock gTcpReplyLock;
+
 static void tcp_reply_func(struct ReplyAddress *addr, char* msg, int size)
 {
 	// Write size as 32bit unsigned network-order integer
@@ -185,6 +273,7 @@ static void tcp_reply_func(struct ReplyAddress *addr, char* msg, int size)
 #endif
 
 	boost::system::error_code errc;
+	lock_guard<SC_Lock> lock(gTcpReplyLock);
 	write( *socket, buffer(&u, sizeof(uint32) ), errc );
 	if (errc)
 		printf("%s\n", errc.message().c_str());
@@ -222,19 +311,15 @@ class SC_UdpInPort
 
 		if (mWorld->mDumpOSC) dumpOSC(mWorld->mDumpOSC, bytes_transferred, recvBuffer.data());
 
-		OSC_Packet * packet = (OSC_Packet*)malloc(sizeof(OSC_Packet));
-
-		packet->mReplyAddr.mProtocol = kUDP;
-		packet->mReplyAddr.mAddress  = remoteEndpoint.address();
-		packet->mReplyAddr.mPort     = remoteEndpoint.port();
-		packet->mReplyAddr.mSocket   = udpSocket.native_handle();
-		packet->mReplyAddr.mReplyFunc = udp_reply_func;
-		packet->mReplyAddr.mReplyData = (void*)&udpSocket;
-
-		packet->mSize = bytes_transferred;
+		ReplyAddress replyAddr;
+		replyAddr.mProtocol = kUDP;
+		replyAddr.mAddress  = remoteEndpoint.address();
+		replyAddr.mPort     = remoteEndpoint.port();
+		replyAddr.mSocket   = udpSocket.native_handle();
+		replyAddr.mReplyFunc = udp_reply_func;
+		replyAddr.mReplyData = (void*)&udpSocket;
 
-		if (!UnrollOSCPacket(mWorld, bytes_transferred, recvBuffer.data(), packet))
-			free(packet);
+		UnrollOSCPacket(mWorld, bytes_transferred, recvBuffer.data(), &replyAddr);
 
 		startReceiveUDP();
 	}
@@ -284,7 +369,10 @@ public:
 
 	SC_TcpConnection(struct World * world, boost::asio::io_service & ioService,
 	                 class SC_TcpInPort * parent):
-		mWorld(world), socket(ioService), mParent(parent)
+		mWorld(world), socket(ioService),
+		mRecvBuf((char*)malloc(kTcpRecvBufSize)),
+		mRecvCapacity(kTcpRecvBufSize), mRecvSize(0),
+		mParent(parent)
 	{}
 
 	~SC_TcpConnection();
@@ -324,70 +412,76 @@ public:
 	}
 
 private:
-	void startReceiveMessage()
-	{
-		namespace ba = boost::asio;
-		async_read(socket, ba::buffer(&OSCMsgLength, sizeof(OSCMsgLength)),
-		           boost::bind(&SC_TcpConnection::handleLengthReceived, shared_from_this(),
-		                       ba::placeholders::error,
-		                       ba::placeholders::bytes_transferred)
-		          );
-	}
-
-	int32 OSCMsgLength;
-	char * data;
+	// buffered framing: instead of two chained reads and two allocations per
+	// message, the socket is drained in large reads and every complete
+	// length-prefixed packet is sliced out of the receive buffer in place.
+	// a partial frame at the tail stays in the buffer for the next read.
+	char * mRecvBuf;
+	size_t mRecvCapacity;
+	size_t mRecvSize;
 	class SC_TcpInPort * mParent;
 
-	void handleLengthReceived(const boost::system::error_code& error,
-	                          size_t bytes_transferred)
+	void startReceiveMessage()
 	{
-		if (error) {
-			if (error == boost::asio::error::eof)
-				return; // connection closed
-
-			printf("handleLengthReceived: error %s", error.message().c_str());
-			return;
-		}
-
 		namespace ba = boost::asio;
-		// msglen is in network byte order
-		OSCMsgLength = sc_ntohl(OSCMsgLength);
-
-		data = (char*)malloc(OSCMsgLength);
-
-		async_read(socket, ba::buffer(data, OSCMsgLength),
-		           boost::bind(&SC_TcpConnection::handleMsgReceived, shared_from_this(),
+		if (mRecvSize == mRecvCapacity) {
+			// a single frame larger than the buffer; double until it fits
+			char *newBuf = (char*)realloc(mRecvBuf, mRecvCapacity * 2);
+			if (!newBuf) {
+				printf("SC_TcpConnection: out of memory, closing connection\n");
+				return;
+			}
+			mRecvBuf = newBuf;
+			mRecvCapacity *= 2;
+		}
+		socket.async_read_some(ba::buffer(mRecvBuf + mRecvSize, mRecvCapacity - mRecvSize),
+		           boost::bind(&SC_TcpConnection::handleDataReceived, shared_from_this(),
 		                       ba::placeholders::error,
 		                       ba::placeholders::bytes_transferred)
 		          );
 	}
 
-	void handleMsgReceived(const boost::system::error_code& error,
-	                       size_t bytes_transferred)
+	void handleDataReceived(const boost::system::error_code& error,
+	                        size_t bytes_transferred)
 	{
 		if (error) {
-			free(data);
 			if (error == boost::asio::error::eof)
 				return; // connection closed
 
-			printf("handleMsgReceived: error %s", error.message().c_str());
+			printf("handleDataReceived: error %s", error.message().c_str());
 			return;
 		}
 
-		assert(bytes_transferred == OSCMsgLength);
-
-		if (mWorld->mDumpOSC) dumpOSC(mWorld->mDumpOSC, bytes_transferred, data);
+		mRecvSize += bytes_transferred;
 
-		OSC_Packet * packet = (OSC_Packet*)malloc(sizeof(OSC_Packet));
+		ReplyAddress replyAddr;
+		replyAddr.mProtocol = kTCP;
+		replyAddr.mReplyFunc = tcp_reply_func;
+		replyAddr.mReplyData = (void*)&socket;
 
-		packet->mReplyAddr.mProtocol = kTCP;
-		packet->mReplyAddr.mReplyFunc = tcp_reply_func;
-		packet->mReplyAddr.mReplyData = (void*)&socket;
+		size_t pos = 0;
+		while (mRecvSize - pos >= sizeof(int32)) {
+			int32 msglen;
+			memcpy(&msglen, mRecvBuf + pos, sizeof(int32));
+			msglen = sc_ntohl(msglen);
+			if (msglen <= 0 || msglen > kMaxTcpPacketSize) {
+				// the stream cannot be resynchronized after a bad length
+				printf("SC_TcpConnection: malformed packet length %d, closing connection\n", (int)msglen);
+				return;
+			}
+			if (mRecvSize - pos - sizeof(int32) < (size_t)msglen)
+				break; // incomplete frame; read more first
 
-		packet->mSize = OSCMsgLength;
+			char *data = mRecvBuf + pos + sizeof(int32);
+			if (mWorld->mDumpOSC) dumpOSC(mWorld->mDumpOSC, msglen, data);
+			UnrollOSCPacket(mWorld, msglen, data, &replyAddr);
+			pos += sizeof(int32) + msglen;
+		}
 
-		if (!UnrollOSCPacket(mWorld, bytes_transferred, data, packet))
-			free(packet);
+		// keep the partial frame at the front of the buffer
+		if (pos > 0 && pos < mRecvSize)
+			memmove(mRecvBuf, mRecvBuf + pos, mRecvSize - pos);
+		mRecvSize -= pos;
 
 		startReceiveMessage();
 	}
@@ -454,6 +548,7 @@ public:
 
 SC_TcpConnection::~SC_TcpConnection()
 {
+	free(mRecvBuf);
 	mParent->connectionDestroyed();
 }
 
@@ -498,17 +593,13 @@ SCSYNTH_DLLEXPORT_C bool World_SendPacketWithContext(World *inWorld, int inSize,
 	if (inSize > 0) {
 		if (inWorld->mDumpOSC) dumpOSC(inWorld->mDumpOSC, inSize, inData);
 
-		OSC_Packet* packet = (OSC_Packet*)malloc(sizeof(OSC_Packet));
+		ReplyAddress replyAddr;
+		replyAddr.mAddress = boost::asio::ip::address();
+		replyAddr.mReplyFunc = inFunc;
+		replyAddr.mReplyData = inContext;
+		replyAddr.mSocket = 0;
 
-		packet->mReplyAddr.mAddress = boost::asio::ip::address();
-		packet->mReplyAddr.mReplyFunc = inFunc;
-		packet->mReplyAddr.mReplyData = inContext;
-		packet->mReplyAddr.mSocket = 0;
-
-		if(!UnrollOSCPacket(inWorld, inSize, inData, packet)) {
-			free(packet);
-			return false;
-		}
+		return UnrollOSCPacket(inWorld, inSize, inData, &replyAddr);
 	}
 	return true;
 }
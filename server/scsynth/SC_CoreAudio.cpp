@@ -23,6 +23,7 @@
 #include "SC_SequencedCommand.h"
 #include "SC_Prototypes.h"
 #include "SC_HiddenWorld.h"
+#include "SC_OscJournal.h"
 #include "SC_WorldOptions.h"
 #include "SC_Endian.h"
 #include "SC_Lib_Cintf.h"
@@ -191,6 +192,7 @@ PacketStatus PerformOSCPacket(World *world, OSC_Packet *packet, SC_ScheduledEven
 
 void Perform_ToEngine_Msg(FifoMsg *inMsg);
 void FreeOSCPacket(FifoMsg *inMsg);
+bool RecycleOSCPacket(OSC_Packet *inPacket); // see SC_ComPort.cpp
 
 struct IsBundle
 {
@@ -204,18 +206,19 @@ bool ProcessOSCPacket(World *inWorld, OSC_Packet *inPacket)
 {
 	//scprintf("ProcessOSCPacket %d, '%s'\n", inPacket->mSize, inPacket->mData);
 	if (!inPacket) return false;
-	bool result;
-	static_cast<SC_Lock*>(inWorld->mDriverLock)->lock();
-		SC_AudioDriver *driver = AudioDriver(inWorld);
-		if (!driver) {
-			static_cast<SC_Lock*>(inWorld->mDriverLock)->unlock();
-			return false;
-		}
-		inPacket->mIsBundle = gIsBundle.checkIsBundle((int32*)inPacket->mData);
-		FifoMsg fifoMsg;
-		fifoMsg.Set(inWorld, Perform_ToEngine_Msg, FreeOSCPacket, (void*)inPacket);
-		result = driver->SendOscPacketMsgToEngine(fifoMsg);
-	static_cast<SC_Lock*>(inWorld->mDriverLock)->unlock();
+	// lock-free: the packet fifo supports concurrent writers, so socket
+	// listener threads never contend on a mutex here. The listener threads
+	// are shut down before the driver is torn down, so the driver pointer
+	// is stable for the duration of this call.
+	SC_AudioDriver *driver = AudioDriver(inWorld);
+	if (!driver) return false;
+	inPacket->mIsBundle = gIsBundle.checkIsBundle((int32*)inPacket->mData);
+	SC_OscJournal *journal = inWorld->hw->mOscJournal;
+	if (journal)
+		journal->Record(driver->mOSCbuftime, inPacket->mIsBundle, inPacket->mData, inPacket->mSize);
+	FifoMsg fifoMsg;
+	fifoMsg.Set(inWorld, Perform_ToEngine_Msg, FreeOSCPacket, (void*)inPacket);
+	bool result = driver->SendOscPacketMsgToEngine(fifoMsg);
 	if (!result)
 		scprintf("command FIFO full\n");
 	return result;
@@ -233,7 +236,7 @@ int PerformOSCMessage(World *inWorld, int inSize, char *inData, ReplyAddress *in
 		else cmdObj = gCmdArray[index];
 	} else {
 		cmdNameLen = OSCstrlen(inData);
-		cmdObj = gCmdLib->Get((int32*)inData);
+		cmdObj = LookupCommand((int32*)inData);
 	}
 	if (!cmdObj) {
 		CallSendFailureCommand(inWorld, inData, "Command not found", inReply);
@@ -334,13 +337,18 @@ void FreeOSCPacket(FifoMsg *inMsg)
 	OSC_Packet *packet = (OSC_Packet*)inMsg->mData;
 	if (packet) {
 		inMsg->mData = 0;
+		if (RecycleOSCPacket(packet)) return;
+		// packets from the socket listeners carry their payload inline in
+		// the envelope allocation; only separately owned payloads are freed
+		if (packet->mData != (char*)packet + sizeof(OSC_Packet)) {
 #if _MSC_VER == 1310
 #pragma message("$$$todo fixme hack for the 'uninitialized packet->mData ptr when using MSVC 7.1 debug")
-	if (packet->mData != reinterpret_cast<char*>(0xcdcdcdcd))
-		free(packet->mData);
+			if (packet->mData != reinterpret_cast<char*>(0xcdcdcdcd))
+				free(packet->mData);
 #else //#ifdef _MSC_VER
-		free(packet->mData);
+			free(packet->mData);
 #endif //#ifdef _MSC_VER
+		}
 		free(packet);
 	}
 }
@@ -383,6 +391,7 @@ void SC_AudioDriver::RunThread()
 	NodeReplyFifo *nodereplyfifo = &mWorld->hw->mNodeMsgs;
 	NodeEndsFifo *nodeendfifo = &mWorld->hw->mNodeEnds;
 	DeleteGraphDefsFifo *deletegraphfifo = &mWorld->hw->mDeleteGraphDefs;
+	PrintFifo *printfifo = &mWorld->hw->mPrints;
 
 	while (mRunThreadFlag) {
 		// wait for sync
@@ -390,6 +399,9 @@ void SC_AudioDriver::RunThread()
 
 		reinterpret_cast<SC_Lock*>(mWorld->mNRTLock)->lock();
 
+		// print messages queued from the RT thread
+		printfifo->Perform();
+
 		// send /tr messages
 		trigfifo->Perform();
 
@@ -399,11 +411,14 @@ void SC_AudioDriver::RunThread()
 		// send node status messages
 		nodeendfifo->Perform();
 
+		// send the batched replies, one bundle per destination
+		mWorld->hw->mReplyBatcher.Flush();
+
 		// free GraphDefs
 		deletegraphfifo->Perform();
 
 		// perform messages
-		mFromEngine.Perform();
+		mFromEngine.PerformAll();
 
 		reinterpret_cast<SC_Lock*>(mWorld->mNRTLock)->unlock();
 	}
@@ -519,6 +534,9 @@ SC_AudioDriver* SC_NewAudioDriver(struct World *inWorld)
 SC_CoreAudioDriver::SC_CoreAudioDriver(struct World *inWorld)
 		: SC_AudioDriver(inWorld)
         , mInputBufList(0)
+#ifdef SC_AUDIO_WORKGROUP_AVAILABLE
+        , mAudioWorkgroup(NULL)
+#endif
 {
 }
 
@@ -1339,8 +1357,8 @@ void SC_CoreAudioDriver::Run(const AudioBufferList* inInputData,
 		/*if (mToEngine.HasData()) {
 			scprintf("oscTime %.9f %.9f\n", oscTime*kOSCtoSecs, CoreAudioHostTimeToOSC(AudioGetCurrentHostTime())*kOSCtoSecs);
 		}*/
-		mToEngine.Perform();
-		mOscPacketsToEngine.Perform();
+		mToEngine.PerformAll();
+		mOscPacketsToEngine.PerformAll();
 
 		int bufFrames = world->mBufLength;
 		int numBufs = numSamplesPerCallback / bufFrames;
@@ -1401,6 +1419,7 @@ void SC_CoreAudioDriver::Run(const AudioBufferList* inInputData,
 				scprintf("rdy %.9f %.9f %.9f\n", (mScheduler.NextTime()-gStartupOSCTime) * kOSCtoSecs, (mOSCbuftime-gStartupOSCTime)*kOSCtoSecs, diff);
 			}*/
 
+			mScheduler.Advance(nextTime); // release due wheel events for draining
 			while ((schedTime = mScheduler.NextTime()) <= nextTime) {
 				float diffTime = (float)(schedTime - oscTime) * oscToSamples + 0.5;
 				float diffTimeFloor = floor(diffTime);
@@ -1804,6 +1823,13 @@ bool SC_CoreAudioDriver::DriverStart()
 	//note that the number of listeners is stripped down to only one for now, to react to headphone swaps in the case of Built-in Output
 	AddDeviceListeners(mOutputDevice, this);
 
+#ifdef SC_AUDIO_WORKGROUP_AVAILABLE
+	// cache the IO thread workgroup of the running device, so auxiliary dsp
+	// threads can join it through AudioWorkgroup(). on separate IO only the
+	// output device's workgroup is published.
+	mAudioWorkgroup = sc_device_audio_workgroup(mOutputDevice);
+#endif
+
 	return true;
 }
 
@@ -1824,6 +1850,11 @@ bool SC_CoreAudioDriver::DriverStop()
 	}
 	OSStatus err = kAudioHardwareNoError;
 
+#ifdef SC_AUDIO_WORKGROUP_AVAILABLE
+	sc_release_audio_workgroup(mAudioWorkgroup);
+	mAudioWorkgroup = NULL;
+#endif
+
 	if (UseSeparateIO()) {
 		err = AudioDeviceStop(mOutputDevice, appIOProc);
 		if (err != kAudioHardwareNoError) {
@@ -2053,8 +2084,8 @@ void SC_iCoreAudioDriver::Run(const AudioBufferList* inInputData,
 
 		mFromEngine.Free();
 
-		mToEngine.Perform();
-		mOscPacketsToEngine.Perform();
+		mToEngine.PerformAll();
+		mOscPacketsToEngine.PerformAll();
 		//printf("mOscPacketsToEngine : %d micros\n", (int) (GetMicroseconds()-systemTimeBefore));
 
 		int bufFrames = world->mBufLength;
@@ -2117,6 +2148,7 @@ void SC_iCoreAudioDriver::Run(const AudioBufferList* inInputData,
 			int64 schedTime;
 			int64 nextTime = oscTime + oscInc;
 
+			mScheduler.Advance(nextTime); // release due wheel events for draining
 			while ((schedTime = mScheduler.NextTime()) <= nextTime) {
 				float diffTime = (float)(schedTime - oscTime) * oscToSamples + 0.5;
 				float diffTimeFloor = floor(diffTime);
@@ -37,6 +37,7 @@
 #define SC_AUDIO_API_AUDIOUNITS  4
 #define SC_AUDIO_API_COREAUDIOIPHONE	5
 #define SC_AUDIO_API_ANDROIDJNI 6
+#define SC_AUDIO_API_AAUDIO 7
 
 #ifdef SC_ANDROID
 #define SC_AUDIO_API SC_AUDIO_API_ANDROIDJNI
@@ -59,6 +60,7 @@
 #if SC_AUDIO_API == SC_AUDIO_API_COREAUDIO || SC_AUDIO_API == SC_AUDIO_API_AUDIOUNITS
 # include <CoreAudio/AudioHardware.h>
 # include <CoreAudio/HostTime.h>
+# include "SC_AudioWorkgroup.hpp"
 #endif
 
 #if SC_AUDIO_API == SC_AUDIO_API_COREAUDIOIPHONE
@@ -130,6 +132,12 @@ struct SC_ScheduledEvent
 };
 
 typedef MsgFifo<FifoMsg, 65536> EngineFifo;
+// OSC packets may arrive concurrently from several socket listener threads,
+// so their fifo has to support multiple writers without a mutex.
+typedef MsgFifoMultiWriter<FifoMsg, 65536> OscPacketFifo;
+// sequenced command NRT stages run on the command worker pool as well as the
+// driver thread, so the fifo into the engine has multiple producers too.
+typedef MsgFifoMultiWriter<FifoMsg, 65536> ToEngineFifo;
 
 // Functions to be implemented by the driver backend
 extern "C" {
@@ -165,13 +173,14 @@ protected:
 
 	// Common members
 	uint32	mHardwareBufferSize;	// bufferSize returned by kAudioDevicePropertyBufferSize
-	EngineFifo mFromEngine, mToEngine;
-	EngineFifo mOscPacketsToEngine;
+	EngineFifo mFromEngine;
+	ToEngineFifo mToEngine;
+	OscPacketFifo mOscPacketsToEngine;
 	SC_SyncCondition mAudioSync;
 	SC_Thread mThread;
 	bool mRunThreadFlag;
 	uint32 mSafetyOffset;
-	PriorityQueueT<SC_ScheduledEvent, 2048> mScheduler;
+	EventWheelQueueT<SC_ScheduledEvent, 8192> mScheduler;
 	int mNumSamplesPerCallback;
 	uint32 mPreferredHardwareBufferFrameSize;
 	uint32 mPreferredSampleRate;
@@ -234,9 +243,9 @@ public:
 		mPreferredSampleRate = inRate;
 	}
 
-	bool SendMsgToEngine(FifoMsg& inMsg);           // called by NRT thread
+	bool SendMsgToEngine(FifoMsg& inMsg);           // called by NRT and command worker threads
 	bool SendMsgFromEngine(FifoMsg& inMsg);
-	bool SendOscPacketMsgToEngine(FifoMsg& inMsg);  // called by OSC socket listener threads, protected by mWorld->mDriverLock
+	bool SendOscPacketMsgToEngine(FifoMsg& inMsg);  // called by OSC socket listener threads, lock-free
 
 	void AddEvent(SC_ScheduledEvent& event) { mScheduler.Add(event); }
 
@@ -258,6 +267,10 @@ class SC_CoreAudioDriver : public SC_AudioDriver
 	AudioDeviceID	mInputDevice;
 	AudioDeviceID	mOutputDevice;
 
+#ifdef SC_AUDIO_WORKGROUP_AVAILABLE
+	os_workgroup_t	mAudioWorkgroup;
+#endif
+
 	AudioStreamBasicDescription	inputStreamDesc;	// info about the default device
 	AudioStreamBasicDescription	outputStreamDesc;	// info about the default device
 
@@ -302,6 +315,14 @@ public:
 
 	void SetInputBufferList(AudioBufferList * inBufList) { mInputBufList = inBufList; }
 	AudioBufferList* GetInputBufferList() const { return mInputBufList; }
+
+#ifdef SC_AUDIO_WORKGROUP_AVAILABLE
+	// the IO thread workgroup of the output device, valid while the driver
+	// is started; NULL before macOS 11 or when the device has none. realtime
+	// threads doing dsp for this device should join it (the HAL IO thread
+	// itself is a member already).
+	os_workgroup_t AudioWorkgroup() const { return mAudioWorkgroup; }
+#endif
 };
 
 #endif
@@ -347,6 +368,43 @@ inline SC_AudioDriver* SC_NewAudioDriver(struct World *inWorld)
 #endif // SC_AUDIO_API_COREAUDIOIPHONE
 
 
+#if SC_AUDIO_API == SC_AUDIO_API_AAUDIO
+
+#include <aaudio/AAudio.h>
+
+// callback driven driver on top of AAudio (API level 26+). opens an
+// exclusive-mode low latency output stream whose data callback runs the
+// engine, like SC_PortAudioDriver; the input stream has no callback and is
+// read non-blocking from the output callback.
+class SC_AAudioDriver : public SC_AudioDriver
+{
+	AAudioStream *mOutputStream;
+	AAudioStream *mInputStream;
+	float *mInputBuffer;		// interleaved read scratch for the input stream
+	int mInputChannelCount;
+	int mOutputChannelCount;
+
+protected:
+
+	// Driver interface methods
+	virtual bool DriverSetup(int* outNumSamplesPerCallback, double* outSampleRate);
+	virtual bool DriverStart();
+	virtual bool DriverStop();
+
+public:
+	SC_AAudioDriver(struct World *inWorld);
+	virtual ~SC_AAudioDriver();
+
+	aaudio_data_callback_result_t AAudioCallback(void *audioData, int32_t numFrames);
+};
+
+inline SC_AudioDriver* SC_NewAudioDriver(struct World *inWorld)
+{
+	return new SC_AAudioDriver(inWorld);
+}
+
+#endif // SC_AUDIO_API == SC_AUDIO_API_AAUDIO
+
 #if SC_AUDIO_API == SC_AUDIO_API_ANDROIDJNI
 
 class SC_AndroidJNIAudioDriver : public SC_AudioDriver
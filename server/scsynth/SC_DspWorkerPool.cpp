@@ -0,0 +1,131 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "SC_DspWorkerPool.h"
+#include "SC_BoundsMacros.h"
+
+#include <functional>
+#include <stdlib.h>
+
+#include "nova-tt/thread_priority.hpp"
+
+SC_DspWorkerPool::SC_DspWorkerPool(World *inWorld, int inNumThreads, int inScratchCapacity)
+	: mScratchUsed(0), mWorld(inWorld), mRunning(true),
+	  mNodes(0), mOnlyFunc(0), mJob(0), mRemaining(0)
+{
+	mNumThreads = sc_clip(inNumThreads, 1, kMaxDspWorkers);
+
+	mScratchCapacity = inScratchCapacity;
+	mScratch = (Node**)malloc(mScratchCapacity * sizeof(Node*));
+
+	for (int i=0; i<mNumThreads; ++i)
+		mThreads[i] = SC_Thread(std::bind(&SC_DspWorkerPool::WorkerLoop, this, i));
+}
+
+SC_DspWorkerPool::~SC_DspWorkerPool()
+{
+	mRunning.store(false);
+	for (int i=0; i<mNumThreads; ++i)
+		mWake[i].post();
+	for (int i=0; i<mNumThreads; ++i)
+		mThreads[i].join();
+	free(mScratch);
+}
+
+void SC_DspWorkerPool::WorkerLoop(int inIndex)
+{
+	// same priority setup as the driver threads, one notch below the middle
+	// so a late worker cannot starve the audio callback itself
+#ifdef NOVA_TT_PRIORITY_RT
+	std::pair<int, int> priorities = nova::thread_priority_interval_rt();
+	nova::thread_set_priority_rt((priorities.first + priorities.second)/2);
+#else
+	std::pair<int, int> priorities = nova::thread_priority_interval();
+	nova::thread_set_priority(priorities.second);
+#endif
+
+	for (;;) {
+		mWake[inIndex].wait();
+		if (!mRunning.load(std::memory_order_relaxed))
+			return;
+		RunJob();
+	}
+}
+
+// field layout of the packed job word (see the header)
+static const int kJobCursorBits = 20;
+static const int kJobCountShift = kJobCursorBits;
+static const int kJobGenShift = 2 * kJobCursorBits;
+static const uint64_t kJobFieldMask = ((uint64_t)1 << kJobCursorBits) - 1;
+
+void SC_DspWorkerPool::RunJob()
+{
+	uint64_t job = mJob.load(std::memory_order_acquire);
+	for (;;) {
+		uint32_t cursor = (uint32_t)(job & kJobFieldMask);
+		uint32_t count = (uint32_t)((job >> kJobCountShift) & kJobFieldMask);
+		if (cursor >= count)
+			return;
+		// claim the cursor of exactly this job: generation, bound and index
+		// travel in one word, so a successful exchange cannot pair a stale
+		// cursor with a newer job's bound. the acquire pairs with the
+		// release publish in CalcNodes, making mNodes/mOnlyFunc of the
+		// claimed job visible; and until the claimed node has run and
+		// decremented mRemaining, the join below cannot complete, so the
+		// job state cannot be rewritten under us.
+		if (!mJob.compare_exchange_weak(job, job + 1, std::memory_order_acquire,
+				std::memory_order_acquire))
+			continue;
+		Node *node = mNodes[cursor];
+		// re-check the filter: a sibling may have ended or paused this node
+		// after it was collected. the caller gives skipped nodes their
+		// serial turn after the join.
+		if (node->mCalcFunc == mOnlyFunc)
+			(*node->mCalcFunc)(node);
+		mRemaining.fetch_sub(1, std::memory_order_release);
+		job = mJob.load(std::memory_order_acquire);
+	}
+}
+
+void SC_DspWorkerPool::CalcNodes(Node **inNodes, int inCount, NodeCalcFunc inOnlyFunc)
+{
+	mNodes = inNodes;
+	mOnlyFunc = inOnlyFunc;
+	mRemaining.store(inCount, std::memory_order_relaxed);
+
+	// publish the new job in one release store. inCount is bounded by the
+	// scratch capacity (mMaxNodes), far below the 20-bit field.
+	uint64_t gen = ((mJob.load(std::memory_order_relaxed) >> kJobGenShift) + 1)
+			& kJobFieldMask;
+	mJob.store((gen << kJobGenShift) | ((uint64_t)inCount << kJobCountShift),
+			std::memory_order_release);
+
+	int numToWake = sc_min(mNumThreads, inCount - 1);
+	for (int i=0; i<numToWake; ++i)
+		mWake[i].post();
+
+	RunJob();
+
+	// the cursor is exhausted but other workers may still be inside their
+	// last node; their release stores pair with this acquire loop so every
+	// bus and wire write is visible before downstream nodes run.
+	while (mRemaining.load(std::memory_order_acquire) != 0)
+		;
+}
@@ -0,0 +1,87 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#ifndef _SC_DspWorkerPool_
+#define _SC_DspWorkerPool_
+
+#include "SC_Types.h"
+#include "SC_Lock.h"
+#include "SC_Node.h"
+
+#include <atomic>
+
+#include "boost/sync/semaphore.hpp"
+
+struct World;
+
+const int kMaxDspWorkers = 16;
+
+// Pool of realtime-priority threads that execute the children of parallel
+// groups (/p_new, enabled with the -T server option). Group_Calc hands the
+// pool a dense array of steady-state graph nodes; the workers and the audio
+// thread pull from a shared cursor and CalcNodes returns when every node has
+// run. Idle workers sleep on their semaphores, so a server without parallel
+// groups pays nothing per block.
+class SC_DspWorkerPool
+{
+public:
+	SC_DspWorkerPool(struct World *inWorld, int inNumThreads, int inScratchCapacity);
+	~SC_DspWorkerPool();
+
+	// execute across the workers and the calling (audio) thread every node
+	// in inNodes[0..inCount) whose calc func still equals inOnlyFunc;
+	// returns when all of them have completed. the filter is re-checked at
+	// execution time because an earlier sibling may have ended or paused a
+	// node after it was collected; skipped nodes are the caller's business.
+	void CalcNodes(Node **inNodes, int inCount, NodeCalcFunc inOnlyFunc);
+
+	int NumThreads() const { return mNumThreads; }
+
+	// scratch space for Group_Calc to collect parallel children without
+	// touching the RT pool; mScratchUsed is a watermark so nested parallel
+	// groups compose. only the audio thread touches these.
+	Node **mScratch;
+	int mScratchCapacity;
+	int mScratchUsed;
+
+private:
+	void WorkerLoop(int inIndex);
+	void RunJob();
+
+	struct World *mWorld;
+	int mNumThreads;
+	std::atomic<bool> mRunning;
+
+	// current job; mNodes/mOnlyFunc are written by the audio thread before
+	// the job word is published
+	Node **mNodes;
+	NodeCalcFunc mOnlyFunc;
+	// packed as | generation:24 | count:20 | cursor:20 |. a worker claims an
+	// index and checks it against the bound of the same job in one atomic
+	// op, so a worker lingering in a finished job's claim loop can never
+	// pair a stale cursor with a newer job's state (see RunJob).
+	std::atomic<uint64_t> mJob;
+	std::atomic<int> mRemaining;
+
+	boost::sync::semaphore mWake[kMaxDspWorkers];
+	SC_Thread mThreads[kMaxDspWorkers];
+};
+
+#endif
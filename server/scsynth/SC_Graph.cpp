@@ -31,6 +31,7 @@
 #include "SC_WireSpec.h"
 #include <stdio.h>
 #include <string.h>
+#include <chrono>
 #include "SC_Prototypes.h"
 #include "SC_Errors.h"
 #include "Unroll.h"
@@ -40,10 +41,34 @@ void Unit_ChooseMulAddFunc(Unit* unit);
 ////////////////////////////////////////////////////////////////////////////////
 
 void Graph_FirstCalc(Graph *inGraph);
+void Graph_CalcProfile(Graph *inGraph);
+void Graph_CalcBatched(Graph *inGraph);
+void Graph_CalcAuto(Graph *inGraph);
+
+// select the steady-state calc func for a graph from its current modes
+NodeCalcFunc Graph_PickCalcFunc(Graph *inGraph)
+{
+	if (inGraph->mProfile) return (NodeCalcFunc)&Graph_CalcProfile;
+	if (inGraph->mAutoBypass) return (NodeCalcFunc)&Graph_CalcAuto;
+	if (inGraph->mControlBatchSize > 1) return (NodeCalcFunc)&Graph_CalcBatched;
+	return (NodeCalcFunc)&Graph_Calc;
+}
 
 void Graph_Dtor(Graph *inGraph)
 {
 	//scprintf("->Graph_Dtor %d\n", inGraph->mNode.mID);
+	Node_DtorDetachMemory(&inGraph->mNode);
+	Graph_Reclaim(inGraph);
+	//scprintf("<-Graph_Dtor\n");
+}
+
+// the expensive half of graph teardown: unit destructors, the def
+// refcount, and the memory block itself. the node must already be
+// detached (Node_DtorDetachMemory), either by Graph_Dtor above or by
+// Node_DeferDelete, which parks detached graphs on a pending list so
+// World_ReclaimPendingNodes can run this a bounded number per block.
+void Graph_Reclaim(Graph *inGraph)
+{
 	World *world = inGraph->mNode.mWorld;
 	uint32 numUnits = inGraph->mNumUnits;
 	Unit** graphUnits = inGraph->mUnits;
@@ -58,14 +83,28 @@ void Graph_Dtor(Graph *inGraph)
 	world->mNumUnits -= numUnits;
 	world->mNumGraphs --;
 
+	if (inGraph->mProfile) {
+		World_Free(world, inGraph->mProfile);
+		inGraph->mProfile = 0;
+	}
+
 	GraphDef* def = GRAPHDEF(inGraph);
 	if (--def->mRefCount <= 0) {
+		// last graph of this def: return the recycled blocks to the pool
+		GraphDef_PurgeGraphBlocks(world, def);
 		if (world->mRealTime) GraphDef_DeleteMsg(world, def);
 		else GraphDef_Free(def);
+		World_Free(world, inGraph);
+	} else if (def->mNumGraphBlocks < kGraphDefMaxGraphBlocks) {
+		// recycle the graph's single memory block for the next Graph_New
+		// of this def instead of handing it back to the allocator
+		Node* node = &inGraph->mNode;
+		*(void**)node = def->mGraphBlockFreeList;
+		def->mGraphBlockFreeList = node;
+		def->mNumGraphBlocks++;
+	} else {
+		World_Free(world, inGraph);
 	}
-
-	Node_Dtor(&inGraph->mNode);
-	//scprintf("<-Graph_Dtor\n");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -74,8 +113,24 @@ int Graph_New(struct World *inWorld, struct GraphDef *inGraphDef, int32 inID,
               struct sc_msg_iter* args, Graph** outGraph,bool argtype)//true for normal args , false for setn type args
 {
 	Graph* graph;
-	int err = Node_New(inWorld, &inGraphDef->mNodeDef, inID, (Node**)&graph);
-	if (err) return err;
+
+	// reuse a recycled block of this def if one is available; all graphs of
+	// a def share one allocation size
+	void* memory = inGraphDef->mGraphBlockFreeList;
+	if (memory) {
+		inGraphDef->mGraphBlockFreeList = *(void**)memory;
+		inGraphDef->mNumGraphBlocks--;
+	}
+
+	int err = Node_New(inWorld, &inGraphDef->mNodeDef, inID, (Node**)&graph, memory);
+	if (err) {
+		if (memory) {
+			*(void**)memory = inGraphDef->mGraphBlockFreeList;
+			inGraphDef->mGraphBlockFreeList = memory;
+			inGraphDef->mNumGraphBlocks++;
+		}
+		return err;
+	}
 	Graph_Ctor(inWorld, inGraphDef, graph, args,argtype);
 	*outGraph = graph;
 	return err;
@@ -122,15 +177,31 @@ void Graph_Ctor(World *inWorld, GraphDef *inGraphDef, Graph *graph, sc_msg_iter
 	graph->mControlRates = (int*)memory;
 	memory += inGraphDef->mMapControlRatesAllocSize;
 
+	graph->mControlSnapshot = (float*)memory;
+	memory += inGraphDef->mControlSnapshotAllocSize;
+
+	// with parallel group workers each graph carries its own wire buffer
+	// space; otherwise all graphs share the world's scratch block.
+	float *graphBufSpace;
+	if (inGraphDef->mWireBufSpaceAllocSize) {
+		memory = (char*)(((uintptr_t)memory + 63) & ~(uintptr_t)63);
+		graphBufSpace = (float*)memory;
+		memory += inGraphDef->mWireBufSpaceAllocSize;
+	} else {
+		graphBufSpace = inWorld->hw->mWireBufSpace;
+	}
+
 	{
 		float*  graphControls = graph->mControls;
 		float*  initialControlValues = inGraphDef->mInitialControlValues;
 		float** graphMapControls = graph->mMapControls;
+		float*  graphControlSnapshot = graph->mControlSnapshot;
 		/* add */
 		int* graphControlRates = graph->mControlRates;
 		for (uint32 i=0; i<numControls; ++i, ++graphControls) {
 			*graphControls = initialControlValues[i];
 			graphMapControls[i] = graphControls;
+			graphControlSnapshot[i] = initialControlValues[i];
 			/* add */
 			graphControlRates[i] = 0;  // init to 0 for now... control bus is 1, audio is 2
 		}
@@ -346,6 +417,7 @@ void Graph_Ctor(World *inWorld, GraphDef *inGraphDef, Graph *graph, sc_msg_iter
 			wire->mCalcRate = calc_ScalarRate;
 			wire->mBuffer = &wire->mScalarValue;
 			wire->mScalarValue = constants[i];
+			wire->mDemandStamp = -1;
 		}
 	}
 
@@ -359,13 +431,26 @@ void Graph_Ctor(World *inWorld, GraphDef *inGraphDef, Graph *graph, sc_msg_iter
 	graph->localBufNum = 0;
 	graph->localMaxBufNum = 0; // this is set from synth
 
+	graph->mProfile = 0;
+	graph->mProfileTicks = 0;
+
+	graph->mDspThreadIndex = 0;
+
+	graph->mControlBatchSize = inGraphDef->mControlBatchSize;
+	graph->mControlBatchPhase = 0;
+
+	graph->mNumWatchedInputs = 0;
+	graph->mQuietBlocks = 0;
+	graph->mAutoBypass = false;
+	graph->mBypassed = false;
+
 	// initialize units
 	//scprintf("initialize units\n");
 	Unit** calcUnits = graph->mCalcUnits;
 	Unit** graphUnits = graph->mUnits;
 	int calcCtr=0;
 
-	float *bufspace = inWorld->hw->mWireBufSpace;
+	float *bufspace = graphBufSpace;
 	uint32 wireCtr = numConstants; // never more than numConstants + numOutputs
 	UnitSpec *unitSpec = inGraphDef->mUnitSpecs;
 	for (uint32 i=0; i<numUnits; ++i, ++unitSpec) {
@@ -407,6 +492,7 @@ void Graph_Ctor(World *inWorld, GraphDef *inGraphDef, Graph *graph, sc_msg_iter
 					wire->mFromUnit = unit;
 					wire->mCalcRate = calc_FullRate;
 					wire->mBuffer = bufspace + outputSpec->mBufferIndex;
+					wire->mDemandStamp = -1;
 					unitOutput[j] = wire;
 					unitOutBuf[j] = wire->mBuffer;
 				}
@@ -416,6 +502,7 @@ void Graph_Ctor(World *inWorld, GraphDef *inGraphDef, Graph *graph, sc_msg_iter
 					wire->mFromUnit = unit;
 					wire->mCalcRate = unitCalcRate;
 					wire->mBuffer = &wire->mScalarValue;
+					wire->mDemandStamp = -1;
 					unitOutput[j] = wire;
 					unitOutBuf[j] = wire->mBuffer;
 				}
@@ -429,9 +516,23 @@ void Graph_Ctor(World *inWorld, GraphDef *inGraphDef, Graph *graph, sc_msg_iter
 	inGraphDef->mRefCount ++ ;
 }
 
+// gather all mapped control values into the contiguous snapshot array.
+// one pass per graph per block, instead of every control unit dereferencing
+// mMapControls per channel; the snapshot keeps multichannel control reads
+// sequential and lets the compiler vectorize the smoothing loops.
+inline void Graph_SnapshotControls(Graph *inGraph)
+{
+	uint32 numControls = inGraph->mNumControls;
+	float **mapControls = inGraph->mMapControls;
+	float *snapshot = inGraph->mControlSnapshot;
+	for (uint32 i=0; i<numControls; ++i)
+		snapshot[i] = *mapControls[i];
+}
+
 void Graph_FirstCalc(Graph *inGraph)
 {
 	//scprintf("->Graph_FirstCalc\n");
+	Graph_SnapshotControls(inGraph); // unit ctors read their initial control values from the snapshot
 	uint32 numUnits = inGraph->mNumUnits;
 	Unit **units = inGraph->mUnits;
 	for (uint32 i=0; i<numUnits; ++i) {
@@ -441,7 +542,7 @@ void Graph_FirstCalc(Graph *inGraph)
 	}
 	//scprintf("<-Graph_FirstCalc\n");
 
-	inGraph->mNode.mCalcFunc = (NodeCalcFunc)&Graph_Calc;
+	inGraph->mNode.mCalcFunc = Graph_PickCalcFunc(inGraph);
 	// now do actual graph calculation
 	Graph_Calc(inGraph);
 }
@@ -471,6 +572,7 @@ inline void Graph_Calc_unit(Unit * unit)
 void Graph_Calc(Graph *inGraph)
 {
 	//scprintf("->Graph_Calc\n");
+	Graph_SnapshotControls(inGraph);
 	uint32 numCalcUnits = inGraph->mNumCalcUnits;
 	Unit **calcUnits = inGraph->mCalcUnits;
 
@@ -513,11 +615,80 @@ void Graph_Calc(Graph *inGraph)
 	//scprintf("<-Graph_Calc\n");
 }
 
+// calc func for defs flagged at GraphDef_Read time as dominated by
+// control-rate units (world run with -k N). control-rate units only run on
+// every Nth block and their outputs hold in between, which cuts the per-unit
+// dispatch overhead that dominates modulation-heavy defs. consumers that
+// smooth their control inputs across the block ramp from the held value, so
+// the audible effect is a coarser modulation update, not a step.
+void Graph_CalcBatched(Graph *inGraph)
+{
+	if (inGraph->mControlBatchPhase == 0) {
+		Graph_Calc(inGraph);
+	} else {
+		Graph_SnapshotControls(inGraph);
+		uint32 numCalcUnits = inGraph->mNumCalcUnits;
+		Unit **calcUnits = inGraph->mCalcUnits;
+		for (uint32 i=0; i<numCalcUnits; ++i) {
+			Unit *unit = calcUnits[i];
+			if (unit->mCalcRate != calc_BufRate)
+				Graph_Calc_unit(unit);
+		}
+	}
+	if (++inGraph->mControlBatchPhase >= inGraph->mControlBatchSize)
+		inGraph->mControlBatchPhase = 0;
+}
+
+// calc func installed by /n_run with run == 2 (auto-bypass). the graph's
+// audio input units record the buses they read in mWatchedInputs; once all
+// of them have stayed untouched for about a second - long enough for
+// send/return tails to die away - the graph stops running. its own outputs
+// then stay untouched too, so downstream readers see silence and whole idle
+// chains drop out one node after another. the first write to a watched bus
+// wakes the graph again. graphs that record no inputs (sources) never
+// bypass.
+void Graph_CalcAuto(Graph *inGraph)
+{
+	World *world = inGraph->mNode.mWorld;
+	const int32 numWatched = inGraph->mNumWatchedInputs;
+
+	bool touched = numWatched <= 0;
+	if (!touched) {
+		const int32 bufCounter = world->mBufCounter;
+		const int32 *watch = inGraph->mWatchedInputs;
+		for (int32 i = 0; i < numWatched && !touched; ++i) {
+			const int32 *busTouched = world->mAudioBusTouched + watch[2*i];
+			const int32 numChannels = watch[2*i+1];
+			for (int32 c = 0; c < numChannels; ++c) {
+				if (busTouched[c] == bufCounter) {
+					touched = true;
+					break;
+				}
+			}
+		}
+	}
+
+	if (touched) {
+		inGraph->mQuietBlocks = 0;
+		inGraph->mBypassed = false;
+	} else if (!inGraph->mBypassed) {
+		int32 blocksPerSecond = (int32)(world->mSampleRate / world->mBufLength);
+		if (++inGraph->mQuietBlocks >= blocksPerSecond)
+			inGraph->mBypassed = true;
+	}
+
+	if (inGraph->mBypassed)
+		return;
+
+	Graph_Calc(inGraph);
+}
+
 void Graph_CalcTrace(Graph *inGraph);
 void Graph_CalcTrace(Graph *inGraph)
 {
 	uint32 numCalcUnits = inGraph->mNumCalcUnits;
 	Unit **calcUnits = inGraph->mCalcUnits;
+	Graph_SnapshotControls(inGraph);
 	scprintf("\nTRACE %d  %s    #units: %d\n", inGraph->mNode.mID, inGraph->mNode.mDef->mName, numCalcUnits);
 	for (uint32 i=0; i<numCalcUnits; ++i) {
 		Unit *unit = calcUnits[i];
@@ -533,16 +704,65 @@ void Graph_CalcTrace(Graph *inGraph)
 		}
 		scprintf("\n");
 	}
-	inGraph->mNode.mCalcFunc = (NodeCalcFunc)&Graph_Calc;
+	inGraph->mNode.mCalcFunc = Graph_PickCalcFunc(inGraph);
 }
 
 void Graph_Trace(Graph *inGraph)
 {
-	if (inGraph->mNode.mCalcFunc == (NodeCalcFunc)&Graph_Calc) {
+	if (inGraph->mNode.mCalcFunc == (NodeCalcFunc)&Graph_Calc
+			|| inGraph->mNode.mCalcFunc == (NodeCalcFunc)&Graph_CalcBatched
+			|| inGraph->mNode.mCalcFunc == (NodeCalcFunc)&Graph_CalcProfile) {
 		inGraph->mNode.mCalcFunc = (NodeCalcFunc)&Graph_CalcTrace;
 	}
 }
 
+void Graph_CalcProfile(Graph *inGraph)
+{
+	using namespace std::chrono;
+
+	uint32 numCalcUnits = inGraph->mNumCalcUnits;
+	Unit **calcUnits = inGraph->mCalcUnits;
+	UnitProfile *profile = inGraph->mProfile;
+	Graph_SnapshotControls(inGraph);
+	for (uint32 i=0; i<numCalcUnits; ++i) {
+		Unit *unit = calcUnits[i];
+		high_resolution_clock::time_point start = high_resolution_clock::now();
+		(unit->mCalcFunc)(unit, unit->mBufLength);
+		float elapsed = duration_cast<duration<float> >(high_resolution_clock::now() - start).count();
+		profile[i].mTotalSeconds += elapsed;
+		if (elapsed > profile[i].mPeakSeconds) profile[i].mPeakSeconds = elapsed;
+	}
+	inGraph->mProfileTicks++;
+}
+
+int Graph_Profile(Graph *inGraph, int inFlag)
+{
+	World *world = inGraph->mNode.mWorld;
+	if (inFlag) {
+		if (!inGraph->mProfile) {
+			UnitProfile *profile = (UnitProfile*)World_Alloc(world,
+					inGraph->mNumCalcUnits * sizeof(UnitProfile));
+			if (!profile) return kSCErr_OutOfRealTimeMemory;
+			inGraph->mProfile = profile;
+		}
+		memset(inGraph->mProfile, 0, inGraph->mNumCalcUnits * sizeof(UnitProfile));
+		inGraph->mProfileTicks = 0;
+		if (inGraph->mNode.mCalcFunc == (NodeCalcFunc)&Graph_Calc
+				|| inGraph->mNode.mCalcFunc == (NodeCalcFunc)&Graph_CalcBatched)
+			inGraph->mNode.mCalcFunc = (NodeCalcFunc)&Graph_CalcProfile;
+		// if the graph has not run yet, Graph_FirstCalc picks the profiled
+		// calc func; a traced graph picks it up after its trace tick.
+	} else {
+		if (inGraph->mProfile) {
+			World_Free(world, inGraph->mProfile);
+			inGraph->mProfile = 0;
+		}
+		if (inGraph->mNode.mCalcFunc == (NodeCalcFunc)&Graph_CalcProfile)
+			inGraph->mNode.mCalcFunc = Graph_PickCalcFunc(inGraph);
+	}
+	return kSCErr_None;
+}
+
 
 int Graph_GetControl(Graph* inGraph, uint32 inIndex, float& outValue)
 {
@@ -36,13 +36,17 @@
 #include "SC_Prototypes.h"
 #include "SC_CoreAudio.h"
 #include "SC_DirUtils.h"
+#include "SC_Lock.h"
 
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
+#include <sys/stat.h>
 
 extern Malloc gMalloc;
 
@@ -85,6 +89,78 @@ void ReadNodeDefName(char*& buffer, int32* name)
 	readData(buffer, (char*)name, namelen);
 }
 
+// Identical constant and initial control value vectors recur across nearly
+// every def (0, 1, 0.5, 440, ...), so instead of malloc'ing a private copy per
+// def they are interned into one shared refcounted segment. The returned
+// blocks are read only: Graph_New copies out of them, never writes. Defs are
+// read and freed on the non real time thread; the lock makes the table safe
+// when several worlds share the process.
+
+struct FloatVec
+{
+	FloatVec *mNext;
+	uint32 mRefCount;
+	uint32 mSize;
+	int32 mHash;
+	float32 mValues[1];	// allocated to mSize entries
+};
+
+const uint32 kFloatVecTableSize = 256;	// power of two
+static FloatVec *gFloatVecTable[kFloatVecTableSize];
+static SC_Lock gFloatVecLock;
+
+float32* GraphDef_InternFloatVec(const float32* inValues, uint32 inSize);
+float32* GraphDef_InternFloatVec(const float32* inValues, uint32 inSize)
+{
+	if (inSize == 0) return 0;
+	int32 hash = Hash((const char*)inValues, inSize * sizeof(float32));
+	uint32 bucket = (uint32)hash & (kFloatVecTableSize - 1);
+
+	lock_guard<SC_Lock> lock(gFloatVecLock);
+	for (FloatVec *vec = gFloatVecTable[bucket]; vec; vec = vec->mNext) {
+		if (vec->mHash == hash && vec->mSize == inSize
+				&& memcmp(vec->mValues, inValues, inSize * sizeof(float32)) == 0) {
+			vec->mRefCount++;
+			return vec->mValues;
+		}
+	}
+
+	FloatVec *vec = (FloatVec*)malloc(sizeof(FloatVec) + (inSize - 1) * sizeof(float32));
+	vec->mNext = gFloatVecTable[bucket];
+	vec->mRefCount = 1;
+	vec->mSize = inSize;
+	vec->mHash = hash;
+	memcpy(vec->mValues, inValues, inSize * sizeof(float32));
+	gFloatVecTable[bucket] = vec;
+	return vec->mValues;
+}
+
+void GraphDef_ReleaseFloatVec(float32* inValues);
+void GraphDef_ReleaseFloatVec(float32* inValues)
+{
+	if (!inValues) return;
+	FloatVec *vec = (FloatVec*)((char*)inValues - offsetof(FloatVec, mValues));
+	uint32 bucket = (uint32)vec->mHash & (kFloatVecTableSize - 1);
+
+	lock_guard<SC_Lock> lock(gFloatVecLock);
+	if (--vec->mRefCount != 0) return;
+	FloatVec **prev = &gFloatVecTable[bucket];
+	while (*prev != vec) prev = &(*prev)->mNext;
+	*prev = vec->mNext;
+	free(vec);
+}
+
+float32* ReadInternedFloatVec_be(char*& buffer, uint32 inSize);
+float32* ReadInternedFloatVec_be(char*& buffer, uint32 inSize)
+{
+	std::vector<float32> values(inSize);
+	for (uint32 i=0; i<inSize; ++i) {
+		values[i] = readFloat_be(buffer);
+	}
+	return GraphDef_InternFloatVec(inSize ? &values[0] : 0, inSize);
+}
+
+
 void ParamSpec_Read(ParamSpec* inParamSpec, char*& buffer);
 void ParamSpec_Read(ParamSpec* inParamSpec, char*& buffer)
 {
@@ -188,6 +264,209 @@ void UnitSpec_ReadVer1(UnitSpec* inUnitSpec, char*& buffer)
 	inUnitSpec->mAllocSize = inUnitSpec->mUnitDef->mAllocSize + numPorts * (sizeof(Wire*) +  sizeof(float*));
 }
 
+// special indices of BinaryOpUGen, mirrored from server/plugins/BinaryOpUGens.cpp
+// (the opcode enum lives in the plugin, not in a shared header)
+enum { kBinaryOpAdd = 0, kBinaryOpMul = 2 };
+
+void UnitSpec_Free(UnitSpec *inUnitSpec);
+
+static int GraphDef_InputCalcRate(GraphDef *graphDef, InputSpec *inputSpec)
+{
+	if (inputSpec->mFromUnitIndex < 0) return calc_ScalarRate;
+	UnitSpec *from = graphDef->mUnitSpecs + inputSpec->mFromUnitIndex;
+	return from->mOutputSpec[inputSpec->mFromOutputIndex].mCalcRate;
+}
+
+// fuse x*y -> +z chains into single MulAdd units at load time. the language
+// side optimizer already does this for defs it builds itself, but defs from
+// other producers (and hand written ones) arrive unoptimized; fusing here
+// saves one calc func dispatch and one wire buffer pass per chain.
+// a multiply is only absorbed when the adder is its sole consumer, and the
+// rate combination must be one MulAdd's calc table handles: an audio rate
+// result requires an audio rate first input (MulAdd_Ctor insists on it),
+// and demand rate operands are left alone. returns the number of fusions.
+static int GraphDef_FuseMulAdds(GraphDef *graphDef)
+{
+	int32 name[kSCNameLen];
+	memset(name, 0, kSCNameByteLen);
+	strcpy((char*)name, "BinaryOpUGen");
+	UnitDef *binaryOpDef = GetUnitDef(name);
+	memset(name, 0, kSCNameByteLen);
+	strcpy((char*)name, "MulAdd");
+	UnitDef *mulAddDef = GetUnitDef(name);
+	if (!binaryOpDef || !mulAddDef) return 0;
+
+	int numFused = 0;
+	for (uint32 j=0; j<graphDef->mNumUnitSpecs; ++j) {
+		UnitSpec *add = graphDef->mUnitSpecs + j;
+		if (add->mUnitDef != binaryOpDef || add->mSpecialIndex != kBinaryOpAdd
+				|| add->mNumInputs != 2) continue;
+		if (add->mCalcRate != calc_FullRate && add->mCalcRate != calc_BufRate) continue;
+
+		for (int side=0; side<2; ++side) {
+			int32 mulIndex = add->mInputSpec[side].mFromUnitIndex;
+			if (mulIndex < 0 || mulIndex >= (int32)j) continue;
+			UnitSpec *mul = graphDef->mUnitSpecs + mulIndex;
+			if (mul->mUnitDef != binaryOpDef || mul->mSpecialIndex != kBinaryOpMul
+					|| mul->mNumInputs != 2) continue;
+			if (mul->mCalcRate != calc_FullRate && mul->mCalcRate != calc_BufRate) continue;
+
+			int xRate = GraphDef_InputCalcRate(graphDef, mul->mInputSpec + 0);
+			int yRate = GraphDef_InputCalcRate(graphDef, mul->mInputSpec + 1);
+			int zRate = GraphDef_InputCalcRate(graphDef, add->mInputSpec + (1-side));
+			if (add->mCalcRate == calc_FullRate
+					&& (mul->mCalcRate != calc_FullRate || xRate != calc_FullRate)) continue;
+			if (xRate == calc_DemandRate || yRate == calc_DemandRate || zRate == calc_DemandRate)
+				continue;
+
+			// the multiply must feed nothing but this adder
+			uint32 numConsumers = 0;
+			for (uint32 k=0; k<graphDef->mNumUnitSpecs && numConsumers < 2; ++k) {
+				UnitSpec *other = graphDef->mUnitSpecs + k;
+				for (uint32 n=0; n<other->mNumInputs; ++n) {
+					if (other->mInputSpec[n].mFromUnitIndex == mulIndex) numConsumers++;
+				}
+			}
+			if (numConsumers != 1) continue;
+
+			// rewrite the adder as MulAdd(x, y, z)
+			InputSpec *newInputs = (InputSpec*)malloc(3 * sizeof(InputSpec));
+			newInputs[0] = mul->mInputSpec[0];
+			newInputs[1] = mul->mInputSpec[1];
+			newInputs[2] = add->mInputSpec[1-side];
+			free(add->mInputSpec);
+			add->mInputSpec = newInputs;
+			add->mNumInputs = 3;
+			add->mUnitDef = mulAddDef;
+			add->mSpecialIndex = 0;
+			uint64 numPorts = add->mNumInputs + add->mNumOutputs;
+			add->mAllocSize = mulAddDef->mAllocSize + numPorts * (sizeof(Wire*) + sizeof(float*));
+
+			// drop the multiply and renumber references to the units after it
+			UnitSpec_Free(mul);
+			memmove(graphDef->mUnitSpecs + mulIndex, graphDef->mUnitSpecs + mulIndex + 1,
+				(graphDef->mNumUnitSpecs - mulIndex - 1) * sizeof(UnitSpec));
+			graphDef->mNumUnitSpecs--;
+			for (uint32 k=0; k<graphDef->mNumUnitSpecs; ++k) {
+				UnitSpec *other = graphDef->mUnitSpecs + k;
+				for (uint32 n=0; n<other->mNumInputs; ++n) {
+					if (other->mInputSpec[n].mFromUnitIndex > mulIndex)
+						other->mInputSpec[n].mFromUnitIndex--;
+				}
+			}
+			numFused++;
+			j--;	// the fused unit moved down one slot
+			break;
+		}
+	}
+	return numFused;
+}
+
+// collapse runs of adjacent, parallel instances of the same vector-capable
+// UGen into one unit that processes all channels. a 32 channel oscillator
+// bank becomes one unit with 32 concatenated port groups instead of 32
+// dispatches through 32 calc funcs. a def opts in with the
+// kUnitDef_Vectorizable flag; its ctor derives the width from the port
+// counts and finds one copy of its per-instance state per channel after
+// the unit struct (the spec's alloc size is grown accordingly, and
+// Unit_New sizes the state block from the spec). only calc units are
+// collapsed, the run members must agree in rate, arity and special index,
+// and none of them may consume an output produced inside the run.
+// returns the number of collapsed runs.
+static int GraphDef_VectorizeUnits(GraphDef *graphDef)
+{
+	int numCollapsed = 0;
+	for (uint32 i=0; i<graphDef->mNumUnitSpecs; ++i) {
+		UnitSpec *first = graphDef->mUnitSpecs + i;
+		if (!(first->mUnitDef->mFlags & kUnitDef_Vectorizable)) continue;
+		if (first->mCalcRate != calc_FullRate && first->mCalcRate != calc_BufRate) continue;
+
+		uint32 n = 1;
+		while (i + n < graphDef->mNumUnitSpecs) {
+			UnitSpec *next = graphDef->mUnitSpecs + i + n;
+			if (next->mUnitDef != first->mUnitDef
+					|| next->mCalcRate != first->mCalcRate
+					|| next->mSpecialIndex != first->mSpecialIndex
+					|| next->mNumInputs != first->mNumInputs
+					|| next->mNumOutputs != first->mNumOutputs) break;
+			bool feedsFromRun = false;
+			for (uint32 k=0; k<next->mNumInputs; ++k) {
+				int32 from = next->mInputSpec[k].mFromUnitIndex;
+				if (from >= (int32)i && from < (int32)(i + n)) { feedsFromRun = true; break; }
+			}
+			if (feedsFromRun) break;
+			++n;
+		}
+		if (n < 2) continue;
+
+		uint32 numIns = first->mNumInputs;
+		uint32 numOuts = first->mNumOutputs;
+
+		// concatenate the run's ports instance-major on the first spec
+		InputSpec *newInputs = (InputSpec*)malloc(n * numIns * sizeof(InputSpec));
+		OutputSpec *newOutputs = (OutputSpec*)malloc(n * numOuts * sizeof(OutputSpec));
+		for (uint32 k=0; k<n; ++k) {
+			UnitSpec *spec = graphDef->mUnitSpecs + i + k;
+			memcpy(newInputs + k * numIns, spec->mInputSpec, numIns * sizeof(InputSpec));
+			memcpy(newOutputs + k * numOuts, spec->mOutputSpec, numOuts * sizeof(OutputSpec));
+			free(spec->mInputSpec);
+			free(spec->mOutputSpec);
+		}
+		first->mInputSpec = newInputs;
+		first->mOutputSpec = newOutputs;
+		first->mNumInputs = n * numIns;
+		first->mNumOutputs = n * numOuts;
+
+		// one unit header, one copy of the plugin state per instance
+		uint64 numPorts = first->mNumInputs + first->mNumOutputs;
+		first->mAllocSize = sizeof(Unit)
+			+ n * (first->mUnitDef->mAllocSize - sizeof(Unit))
+			+ numPorts * (sizeof(Wire*) + sizeof(float*));
+
+		// drop the absorbed instances, redirect their consumers to the
+		// matching port group of the collapsed unit, renumber the rest
+		memmove(graphDef->mUnitSpecs + i + 1, graphDef->mUnitSpecs + i + n,
+			(graphDef->mNumUnitSpecs - i - n) * sizeof(UnitSpec));
+		graphDef->mNumUnitSpecs -= n - 1;
+		for (uint32 k=0; k<graphDef->mNumUnitSpecs; ++k) {
+			UnitSpec *other = graphDef->mUnitSpecs + k;
+			for (uint32 m=0; m<other->mNumInputs; ++m) {
+				InputSpec *input = other->mInputSpec + m;
+				if (input->mFromUnitIndex > (int32)i) {
+					if (input->mFromUnitIndex < (int32)(i + n)) {
+						input->mFromOutputIndex += (input->mFromUnitIndex - i) * numOuts;
+						input->mFromUnitIndex = i;
+					} else {
+						input->mFromUnitIndex -= n - 1;
+					}
+				}
+			}
+		}
+		numCollapsed++;
+	}
+	return numCollapsed;
+}
+
+// recompute the per-unit tallies of the read loop after a fusion rewrite
+static void GraphDef_Retally(GraphDef *graphDef, uint32& outNumControlCalcUnits)
+{
+	graphDef->mNumWires = graphDef->mNumConstants;
+	graphDef->mNumCalcUnits = 0;
+	outNumControlCalcUnits = 0;
+	graphDef->mNodeDef.mAllocSize = sizeof(Graph);
+	for (uint32 i=0; i<graphDef->mNumUnitSpecs; ++i) {
+		UnitSpec *unitSpec = graphDef->mUnitSpecs + i;
+		if (unitSpec->mCalcRate == calc_BufRate) {
+			graphDef->mNumCalcUnits++;
+			outNumControlCalcUnits++;
+		} else if (unitSpec->mCalcRate == calc_FullRate) {
+			graphDef->mNumCalcUnits++;
+		}
+		graphDef->mNodeDef.mAllocSize += unitSpec->mAllocSize;
+		graphDef->mNumWires += unitSpec->mNumOutputs;
+	}
+}
+
 GraphDef* GraphDef_Read(World *inWorld, char*& buffer, GraphDef* inList, int32 inVersion);
 GraphDef* GraphDef_ReadVer1(World *inWorld, char*& buffer, GraphDef* inList, int32 inVersion);
 
@@ -230,6 +509,62 @@ GraphDef* GraphDefLib_Read(World *inWorld, char* buffer, GraphDef* inList)
 void ChooseMulAddFunc(GraphDef *graphDef, UnitSpec* unitSpec);
 void DoBufferColoring(World *inWorld, GraphDef *inGraphDef);
 
+// hot-swap fast path for live coding: a def replacing a same-named def every
+// few seconds usually only changes constants, control defaults or param specs.
+// none of those affect buffer coloring, which depends solely on the unit graph
+// structure, so when the structure matches we copy the previous def's colored
+// layout instead of re-running DoBufferColoring on the NRT thread. the layout
+// is only shared at whole-graph granularity: the color assigned to an early
+// unit's output depends on release counts contributed by every later consumer,
+// so a structural prefix of a changed graph cannot keep its old colors.
+static bool GraphDef_ReuseColoring(World *inWorld, GraphDef *graphDef)
+{
+	GraphDef *prev = World_GetGraphDef(inWorld, graphDef->mNodeDef.mName);
+	if (!prev) return false;
+
+	if (prev->mNumUnitSpecs != graphDef->mNumUnitSpecs) return false;
+	if (prev->mNumConstants != graphDef->mNumConstants) return false; // constants occupy the leading wire indices
+
+	// compare everything the coloring pass reads
+	for (uint32 j=0; j<graphDef->mNumUnitSpecs; ++j) {
+		UnitSpec *prevSpec = prev->mUnitSpecs + j;
+		UnitSpec *unitSpec = graphDef->mUnitSpecs + j;
+		if (prevSpec->mUnitDef != unitSpec->mUnitDef) return false;
+		if (prevSpec->mCalcRate != unitSpec->mCalcRate) return false;
+		if (prevSpec->mNumInputs != unitSpec->mNumInputs) return false;
+		if (prevSpec->mNumOutputs != unitSpec->mNumOutputs) return false;
+		for (uint32 i=0; i<unitSpec->mNumInputs; ++i) {
+			InputSpec *prevInput = prevSpec->mInputSpec + i;
+			InputSpec *input = unitSpec->mInputSpec + i;
+			if (prevInput->mFromUnitIndex != input->mFromUnitIndex) return false;
+			if (prevInput->mFromOutputIndex != input->mFromOutputIndex) return false;
+		}
+		for (uint32 i=0; i<unitSpec->mNumOutputs; ++i) {
+			if (prevSpec->mOutputSpec[i].mCalcRate != unitSpec->mOutputSpec[i].mCalcRate) return false;
+		}
+	}
+
+	// copy the computed layout. buffer indices are already scaled by the
+	// world's buffer length; both defs belong to the same world.
+	for (uint32 j=0; j<graphDef->mNumUnitSpecs; ++j) {
+		UnitSpec *prevSpec = prev->mUnitSpecs + j;
+		UnitSpec *unitSpec = graphDef->mUnitSpecs + j;
+		for (uint32 i=0; i<unitSpec->mNumInputs; ++i) {
+			unitSpec->mInputSpec[i].mWireIndex = prevSpec->mInputSpec[i].mWireIndex;
+		}
+		for (uint32 i=0; i<unitSpec->mNumOutputs; ++i) {
+			OutputSpec *prevOutput = prevSpec->mOutputSpec + i;
+			OutputSpec *output = unitSpec->mOutputSpec + i;
+			output->mWireIndex = prevOutput->mWireIndex;
+			output->mBufferIndex = prevOutput->mBufferIndex;
+			output->mNumConsumers = prevOutput->mNumConsumers;
+		}
+	}
+	graphDef->mNumWireBufs = prev->mNumWireBufs;
+
+	return true;
+}
+
 void GraphDef_ReadVariant(World *inWorld, char*& buffer, GraphDef* inGraphDef, GraphDef* inVariant)
 {
 	memcpy(inVariant, inGraphDef, sizeof(GraphDef));
@@ -240,10 +575,8 @@ void GraphDef_ReadVariant(World *inWorld, char*& buffer, GraphDef* inGraphDef, G
 	ReadName(buffer, inVariant->mNodeDef.mName);
 	inVariant->mNodeDef.mHash = Hash(inVariant->mNodeDef.mName);
 
-	inVariant->mInitialControlValues = (float32*)malloc(sizeof(float32) * inGraphDef->mNumControls);
-	for (uint32 i=0; i<inGraphDef->mNumControls; ++i) {
-		inVariant->mInitialControlValues[i] = readFloat_be(buffer);
-	}
+	// a variant that leaves the parent's defaults untouched shares its block
+	inVariant->mInitialControlValues = ReadInternedFloatVec_be(buffer, inGraphDef->mNumControls);
 }
 
 
@@ -261,6 +594,9 @@ static inline bool sortIndexMaps(IndexMap map1, IndexMap map2)
 inline static void calcParamSpecs(GraphDef* graphDef, char*& buffer)
 {
 	if (graphDef->mNumParamSpecs) {
+		// the table makes named control access (/n_set etc., see
+		// Graph_SetControl) a constant-time probe even for defs with
+		// hundreds of named controls. sized to keep the load factor <= 1/2.
 		int hashTableSize = NEXTPOWEROFTWO(graphDef->mNumParamSpecs);
 		graphDef->mParamSpecTable = new ParamSpecTable(&gMalloc, hashTableSize, false);
 		uint32 nSpecs = graphDef->mNumParamSpecs;
@@ -363,17 +699,10 @@ GraphDef* GraphDef_Read(World *inWorld, char*& buffer, GraphDef* inList, int32 i
 	graphDef->mNodeDef.mHash = Hash(graphDef->mNodeDef.mName);
 
 	graphDef->mNumConstants = readInt32_be(buffer);
-
-	graphDef->mConstants = (float*)malloc(graphDef->mNumConstants * sizeof(float));
-	for (uint32 i=0; i<graphDef->mNumConstants; ++i) {
-		graphDef->mConstants[i] = readFloat_be(buffer);
-	}
+	graphDef->mConstants = ReadInternedFloatVec_be(buffer, graphDef->mNumConstants);
 
 	graphDef->mNumControls = readInt32_be(buffer);
-	graphDef->mInitialControlValues = (float32*)malloc(sizeof(float32) * graphDef->mNumControls);
-	for (uint32 i=0; i<graphDef->mNumControls; ++i) {
-		graphDef->mInitialControlValues[i] = readFloat_be(buffer);
-	}
+	graphDef->mInitialControlValues = ReadInternedFloatVec_be(buffer, graphDef->mNumControls);
 
 	graphDef->mNumParamSpecs = readInt32_be(buffer);
 
@@ -383,6 +712,7 @@ GraphDef* GraphDef_Read(World *inWorld, char*& buffer, GraphDef* inList, int32 i
 	graphDef->mNumUnitSpecs = readInt32_be(buffer);
 	graphDef->mUnitSpecs = (UnitSpec*)malloc(sizeof(UnitSpec) * graphDef->mNumUnitSpecs);
 	graphDef->mNumCalcUnits = 0;
+	uint32 numControlCalcUnits = 0;
 	for (uint32 i=0; i<graphDef->mNumUnitSpecs; ++i) {
 		UnitSpec *unitSpec = graphDef->mUnitSpecs + i;
 		UnitSpec_Read(unitSpec, buffer);
@@ -394,6 +724,7 @@ GraphDef* GraphDef_Read(World *inWorld, char*& buffer, GraphDef* inList, int32 i
 				break;
 			case calc_BufRate :
 				graphDef->mNumCalcUnits++;
+				numControlCalcUnits++;
 				unitSpec->mRateInfo = &inWorld->mBufRate;
 				break;
 			case calc_FullRate :
@@ -409,7 +740,22 @@ GraphDef* GraphDef_Read(World *inWorld, char*& buffer, GraphDef* inList, int32 i
 		graphDef->mNumWires += unitSpec->mNumOutputs;
 	}
 
-	DoBufferColoring(inWorld, graphDef);
+	int numRewrites = GraphDef_FuseMulAdds(graphDef);
+	numRewrites += GraphDef_VectorizeUnits(graphDef);
+	if (numRewrites)
+		GraphDef_Retally(graphDef, numControlCalcUnits);
+
+	// modulation-heavy defs spend more time in per-unit dispatch than in the
+	// math itself. when the world runs with a control batch (-k), flag defs
+	// whose calc list is dominated by control-rate units to run those units
+	// at the larger internal block (see Graph_CalcBatched).
+	graphDef->mControlBatchSize = 1;
+	if (inWorld->hw->mControlBatchSize > 1
+			&& numControlCalcUnits > graphDef->mNumCalcUnits - numControlCalcUnits)
+		graphDef->mControlBatchSize = inWorld->hw->mControlBatchSize;
+
+	if (!GraphDef_ReuseColoring(inWorld, graphDef))
+		DoBufferColoring(inWorld, graphDef);
 
 	graphDef->mWiresAllocSize = graphDef->mNumWires * sizeof(Wire);
 	graphDef->mUnitsAllocSize = graphDef->mNumUnitSpecs * sizeof(Unit*);
@@ -428,9 +774,25 @@ GraphDef* GraphDef_Read(World *inWorld, char*& buffer, GraphDef* inList, int32 i
 	graphDef->mMapControlRatesAllocSize = graphDef->mNumControls * sizeof(int*);
 	graphDef->mNodeDef.mAllocSize += graphDef->mMapControlRatesAllocSize;
 
+	graphDef->mControlSnapshotAllocSize = graphDef->mNumControls * sizeof(float);
+	graphDef->mNodeDef.mAllocSize += graphDef->mControlSnapshotAllocSize;
+
+	// with parallel group workers every graph gets private wire buffer
+	// space; the shared hw->mWireBufSpace scratch would be clobbered by
+	// graphs running concurrently. the extra 64 bytes absorb alignment.
+	if (inWorld->hw->mNumParallelWorkers > 0) {
+		graphDef->mWireBufSpaceAllocSize =
+			graphDef->mNumWireBufs * inWorld->mBufLength * sizeof(float);
+		graphDef->mNodeDef.mAllocSize += graphDef->mWireBufSpaceAllocSize + 64;
+	} else {
+		graphDef->mWireBufSpaceAllocSize = 0;
+	}
+
 
 	graphDef->mNext = inList;
 	graphDef->mRefCount = 1;
+	graphDef->mGraphBlockFreeList = 0;
+	graphDef->mNumGraphBlocks = 0;
 
 	graphDef->mNumVariants = readInt16_be(buffer);
 	if (graphDef->mNumVariants) {
@@ -460,16 +822,10 @@ GraphDef* GraphDef_ReadVer1(World *inWorld, char*& buffer, GraphDef* inList, int
 	graphDef->mNodeDef.mHash = Hash(graphDef->mNodeDef.mName);
 
 	graphDef->mNumConstants = readInt16_be(buffer);
-	graphDef->mConstants = (float*)malloc(graphDef->mNumConstants * sizeof(float));
-	for (uint32 i=0; i<graphDef->mNumConstants; ++i) {
-		graphDef->mConstants[i] = readFloat_be(buffer);
-	}
+	graphDef->mConstants = ReadInternedFloatVec_be(buffer, graphDef->mNumConstants);
 
 	graphDef->mNumControls = readInt16_be(buffer);
-	graphDef->mInitialControlValues = (float32*)malloc(sizeof(float32) * graphDef->mNumControls);
-	for (uint32 i=0; i<graphDef->mNumControls; ++i) {
-		graphDef->mInitialControlValues[i] = readFloat_be(buffer);
-	}
+	graphDef->mInitialControlValues = ReadInternedFloatVec_be(buffer, graphDef->mNumControls);
 
 	graphDef->mNumParamSpecs = readInt16_be(buffer);
 	calcParamSpecs1(graphDef, buffer);
@@ -478,6 +834,7 @@ GraphDef* GraphDef_ReadVer1(World *inWorld, char*& buffer, GraphDef* inList, int
 	graphDef->mNumUnitSpecs = readInt16_be(buffer);
 	graphDef->mUnitSpecs = (UnitSpec*)malloc(sizeof(UnitSpec) * graphDef->mNumUnitSpecs);
 	graphDef->mNumCalcUnits = 0;
+	uint32 numControlCalcUnits = 0;
 	for (uint32 i=0; i<graphDef->mNumUnitSpecs; ++i) {
 		UnitSpec *unitSpec = graphDef->mUnitSpecs + i;
 		UnitSpec_ReadVer1(unitSpec, buffer);
@@ -489,6 +846,7 @@ GraphDef* GraphDef_ReadVer1(World *inWorld, char*& buffer, GraphDef* inList, int
 				break;
 			case calc_BufRate :
 				graphDef->mNumCalcUnits++;
+				numControlCalcUnits++;
 				unitSpec->mRateInfo = &inWorld->mBufRate;
 				break;
 			case calc_FullRate :
@@ -504,7 +862,19 @@ GraphDef* GraphDef_ReadVer1(World *inWorld, char*& buffer, GraphDef* inList, int
 		graphDef->mNumWires += unitSpec->mNumOutputs;
 	}
 
-	DoBufferColoring(inWorld, graphDef);
+	int numRewrites = GraphDef_FuseMulAdds(graphDef);
+	numRewrites += GraphDef_VectorizeUnits(graphDef);
+	if (numRewrites)
+		GraphDef_Retally(graphDef, numControlCalcUnits);
+
+	// same control batching rule as GraphDef_Read
+	graphDef->mControlBatchSize = 1;
+	if (inWorld->hw->mControlBatchSize > 1
+			&& numControlCalcUnits > graphDef->mNumCalcUnits - numControlCalcUnits)
+		graphDef->mControlBatchSize = inWorld->hw->mControlBatchSize;
+
+	if (!GraphDef_ReuseColoring(inWorld, graphDef))
+		DoBufferColoring(inWorld, graphDef);
 
 	graphDef->mWiresAllocSize = graphDef->mNumWires * sizeof(Wire);
 	graphDef->mUnitsAllocSize = graphDef->mNumUnitSpecs * sizeof(Unit*);
@@ -523,9 +893,25 @@ GraphDef* GraphDef_ReadVer1(World *inWorld, char*& buffer, GraphDef* inList, int
 	graphDef->mMapControlRatesAllocSize = graphDef->mNumControls * sizeof(int*);
 	graphDef->mNodeDef.mAllocSize += graphDef->mMapControlRatesAllocSize;
 
+	graphDef->mControlSnapshotAllocSize = graphDef->mNumControls * sizeof(float);
+	graphDef->mNodeDef.mAllocSize += graphDef->mControlSnapshotAllocSize;
+
+	// with parallel group workers every graph gets private wire buffer
+	// space; the shared hw->mWireBufSpace scratch would be clobbered by
+	// graphs running concurrently. the extra 64 bytes absorb alignment.
+	if (inWorld->hw->mNumParallelWorkers > 0) {
+		graphDef->mWireBufSpaceAllocSize =
+			graphDef->mNumWireBufs * inWorld->mBufLength * sizeof(float);
+		graphDef->mNodeDef.mAllocSize += graphDef->mWireBufSpaceAllocSize + 64;
+	} else {
+		graphDef->mWireBufSpaceAllocSize = 0;
+	}
+
 
 	graphDef->mNext = inList;
 	graphDef->mRefCount = 1;
+	graphDef->mGraphBlockFreeList = 0;
+	graphDef->mNumGraphBlocks = 0;
 
 	if (inVersion >= 1) {
 		graphDef->mNumVariants = readInt16_be(buffer);
@@ -690,32 +1076,216 @@ GraphDef* GraphDef_Load(World *inWorld, const char *filename, GraphDef *inList)
 	return inList;
 }
 
-GraphDef* GraphDef_LoadDir(World *inWorld, char *dirname, GraphDef *inList)
+// ----------------------------------------------------------------------------
+// packed synthdef directory cache
+//
+// /d_loadDir on a large synthdef library spends most of its time opening and
+// reading thousands of small files. We cannot serialize parsed GraphDef
+// structs directly (UnitSpecs hold UnitDef pointers resolved against the
+// plugins loaded in this process), but we can pack the raw .scsyndef images
+// of a directory into one cache file, validated per entry by mtime and size,
+// so repeated boots read a single file sequentially and parse from memory.
+
+const int32 kGraphDefCacheMagic = (('S'<<24)|('C'<<16)|('g'<<8)|'c'); /*'SCgc'*/
+const int32 kGraphDefCacheVersion = 1;
+const char* kGraphDefCacheFileName = ".scsyndef_cache";
+
+struct GraphDefCacheEntry
+{
+	std::string mPath;
+	int64 mMTime;
+	int32 mSize;
+};
+
+static bool GraphDef_StatFile(const char *filename, int64& outMTime, int32& outSize)
+{
+	struct stat buf;
+	if (stat(filename, &buf) != 0) return false;
+	outMTime = (int64)buf.st_mtime;
+	outSize = (int32)buf.st_size;
+	return true;
+}
+
+struct GraphDefCollectState
+{
+	SC_Lock mMutex;
+	std::vector<GraphDefCacheEntry> mEntries;
+};
+
+// walker callback; runs on the traversal worker threads, so the stat calls
+// overlap and the entry list is filled under a lock.
+static void GraphDef_CollectFile(const char *path, void *userData)
 {
-	SC_DirHandle *dir = sc_OpenDir(dirname);
-	if (!dir) {
+	int dnamelen = strlen(path);
+	if (dnamelen <= 9 || strncmp(path+dnamelen-9, ".scsyndef", 9) != 0)
+		return;
+
+	GraphDefCacheEntry entry;
+	entry.mPath = path;
+	if (!GraphDef_StatFile(path, entry.mMTime, entry.mSize))
+		return;
+
+	GraphDefCollectState *state = (GraphDefCollectState*)userData;
+	lock_guard<SC_Lock> lock(state->mMutex);
+	state->mEntries.push_back(entry);
+}
+
+// collect the .scsyndef files below dirname, sorted by path
+static bool GraphDef_CollectDir(char *dirname, std::vector<GraphDefCacheEntry>& entries)
+{
+	GraphDefCollectState state;
+	if (!sc_ParallelWalkDirectory(dirname, false, 0, GraphDef_CollectFile, &state)) {
 		scprintf("*** ERROR: open directory failed '%s'\n", dirname);
+		return false;
+	}
+
+	// the walk order depends on thread scheduling; the cache compares entries
+	// positionally, so give the list a stable order.
+	std::sort(state.mEntries.begin(), state.mEntries.end(),
+		[](const GraphDefCacheEntry& a, const GraphDefCacheEntry& b) { return a.mPath < b.mPath; });
+
+	entries.swap(state.mEntries);
+	return true;
+}
+
+// load all defs from the cache file, or return 0 if the cache is missing or stale.
+// the cache is only used when it describes exactly the entries found on disk.
+static GraphDef* GraphDef_LoadDirFromCache(World *inWorld, const char *cachePath,
+	const std::vector<GraphDefCacheEntry>& entries, GraphDef *inList, bool& outUsedCache)
+{
+	outUsedCache = false;
+
+	FILE *file = fopen(cachePath, "rb");
+	if (!file) return inList;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	char *data = (char*)malloc(size);
+	if (!data) {
+		fclose(file);
+		return inList;
+	}
+	fseek(file, 0, SEEK_SET);
+	size_t readSize = fread(data, 1, size, file);
+	fclose(file);
+	if (readSize != (size_t)size) {
+		free(data);
 		return inList;
 	}
 
-	for (;;) {
-		char diritem[MAXPATHLEN];
-		bool skipItem = false;
-		bool validItem = sc_ReadDir(dir, dirname, diritem, skipItem);
-		if (!validItem) break;
-		if (skipItem) continue;
+	char *buffer = data;
+	char *bufferEnd = data + size;
 
-		if (sc_DirectoryExists(diritem)) {
-			inList = GraphDef_LoadDir(inWorld, diritem, inList);
-		} else {
-			int dnamelen = strlen(diritem);
-			if (strncmp(diritem+dnamelen-9, ".scsyndef", 9) == 0) {
-				inList = GraphDef_Load(inWorld, diritem, inList);
-			}
+	if (size < 12
+		|| readInt32_be(buffer) != kGraphDefCacheMagic
+		|| readInt32_be(buffer) != kGraphDefCacheVersion
+		|| (uint32)readInt32_be(buffer) != entries.size()) {
+		free(data);
+		return inList;
+	}
+
+	// first pass: validate every entry against the directory contents
+	char *scan = buffer;
+	for (uint32 i = 0; i < entries.size(); ++i) {
+		if (scan + 16 > bufferEnd) { free(data); return inList; }
+		int32 pathLen = readInt32_be(scan);
+		// validate lengths in integer space: a negative or huge value from a
+		// corrupt cache would wrap the pointer arithmetic and pass the check
+		if (pathLen < 0 || (int64)pathLen + 12 > bufferEnd - scan) { free(data); return inList; }
+		bool pathMatches = pathLen == (int32)entries[i].mPath.size()
+			&& memcmp(scan, entries[i].mPath.data(), pathLen) == 0;
+		scan += pathLen;
+		int64 mtime = readInt64_be(scan);
+		int32 defSize = readInt32_be(scan);
+		if (!pathMatches || mtime != entries[i].mMTime || defSize != entries[i].mSize
+			|| defSize < 0 || defSize > bufferEnd - scan) {
+			free(data);
+			return inList;
+		}
+		scan += defSize;
+	}
+
+	// second pass: parse the defs out of the cache image
+	for (uint32 i = 0; i < entries.size(); ++i) {
+		int32 pathLen = readInt32_be(buffer);
+		buffer += pathLen;
+		readInt64_be(buffer); // mtime, validated above
+		int32 defSize = readInt32_be(buffer);
+		try {
+			inList = GraphDefLib_Read(inWorld, buffer, inList);
+		} catch (std::exception& exc) {
+			scprintf("exception in GraphDef_LoadDirFromCache: %s\n", exc.what());
+			scprintf("while reading cached '%s'\n", entries[i].mPath.c_str());
+		} catch (...) {
+			scprintf("unknown exception in GraphDef_LoadDirFromCache\n");
+			scprintf("while reading cached '%s'\n", entries[i].mPath.c_str());
 		}
+		buffer += defSize;
+	}
+
+	free(data);
+	outUsedCache = true;
+	return inList;
+}
+
+static void GraphDef_WriteDirCache(const char *cachePath,
+	const std::vector<GraphDefCacheEntry>& entries)
+{
+	FILE *file = fopen(cachePath, "wb");
+	if (!file) return; // read-only synthdef dirs are fine; just don't cache
+
+	writeInt32_be(file, kGraphDefCacheMagic);
+	writeInt32_be(file, kGraphDefCacheVersion);
+	writeInt32_be(file, (int32)entries.size());
+
+	for (uint32 i = 0; i < entries.size(); ++i) {
+		const GraphDefCacheEntry& entry = entries[i];
+		FILE *deffile = fopen(entry.mPath.c_str(), "rb");
+		if (!deffile) {
+			fclose(file);
+			remove(cachePath);
+			return;
+		}
+		char *defbuf = (char*)malloc(entry.mSize);
+		size_t readSize = defbuf ? fread(defbuf, 1, entry.mSize, deffile) : 0;
+		fclose(deffile);
+		if (readSize != (size_t)entry.mSize) {
+			free(defbuf);
+			fclose(file);
+			remove(cachePath);
+			return;
+		}
+		writeInt32_be(file, (int32)entry.mPath.size());
+		writeData(file, entry.mPath.data(), entry.mPath.size());
+		writeInt64_be(file, entry.mMTime);
+		writeInt32_be(file, entry.mSize);
+		writeData(file, defbuf, entry.mSize);
+		free(defbuf);
+	}
+
+	fclose(file);
+}
+
+GraphDef* GraphDef_LoadDir(World *inWorld, char *dirname, GraphDef *inList)
+{
+	std::vector<GraphDefCacheEntry> entries;
+	if (!GraphDef_CollectDir(dirname, entries))
+		return inList;
+
+	char cachePath[MAXPATHLEN];
+	snprintf(cachePath, MAXPATHLEN, "%s/%s", dirname, kGraphDefCacheFileName);
+
+	bool usedCache = false;
+	inList = GraphDef_LoadDirFromCache(inWorld, cachePath, entries, inList, usedCache);
+	if (usedCache) return inList;
+
+	for (uint32 i = 0; i < entries.size(); ++i) {
+		inList = GraphDef_Load(inWorld, entries[i].mPath.c_str(), inList);
 	}
 
-	sc_CloseDir(dir);
+	if (!entries.empty())
+		GraphDef_WriteDirCache(cachePath, entries);
+
 	return inList;
 }
 
@@ -726,6 +1296,20 @@ void UnitSpec_Free(UnitSpec *inUnitSpec)
 	free(inUnitSpec->mOutputSpec);
 }
 
+// hand the recycled graph blocks of a def back to the allocator.
+// called on the real time thread, which also allocated them.
+void GraphDef_PurgeGraphBlocks(World *inWorld, GraphDef *inGraphDef)
+{
+	void* block = inGraphDef->mGraphBlockFreeList;
+	while (block) {
+		void* next = *(void**)block;
+		World_Free(inWorld, block);
+		block = next;
+	}
+	inGraphDef->mGraphBlockFreeList = 0;
+	inGraphDef->mNumGraphBlocks = 0;
+}
+
 void GraphDef_Free(GraphDef *inGraphDef)
 {
 	if (inGraphDef != inGraphDef->mOriginal) return;
@@ -734,12 +1318,12 @@ void GraphDef_Free(GraphDef *inGraphDef)
 		UnitSpec_Free(inGraphDef->mUnitSpecs + i);
 	}
 	for (uint32 i=0; i<inGraphDef->mNumVariants; ++i) {
-		free(inGraphDef->mVariants[i].mInitialControlValues);
+		GraphDef_ReleaseFloatVec(inGraphDef->mVariants[i].mInitialControlValues);
 	}
 	delete inGraphDef->mParamSpecTable;
 	free(inGraphDef->mParamSpecs);
-	free(inGraphDef->mInitialControlValues);
-	free(inGraphDef->mConstants);
+	GraphDef_ReleaseFloatVec(inGraphDef->mInitialControlValues);
+	GraphDef_ReleaseFloatVec(inGraphDef->mConstants);
 	free(inGraphDef->mUnitSpecs);
 	free(inGraphDef->mVariants);
 	free(inGraphDef);
@@ -904,12 +1488,29 @@ static void AllocOutputBuffers(UnitSpec *unitSpec, BufColorAllocator& bufColor,
 		OutputSpec *outputSpec = unitSpec->mOutputSpec + i;
 		outputSpec->mWireIndex = wireIndexCtr++;
 		if (outputSpec->mCalcRate == calc_FullRate) {
-			uint32 bufIndex = bufColor.alloc(outputSpec->mNumConsumers);
+			// an output nothing reads is held by the unit itself, so its live
+			// range ends right after the unit runs (see ReleaseDeadOutputBuffers)
+			uint32 numRefs = outputSpec->mNumConsumers ? outputSpec->mNumConsumers : 1;
+			uint32 bufIndex = bufColor.alloc(numRefs);
 			outputSpec->mBufferIndex = bufIndex;
 		}
 	}
 }
 
+static void ReleaseDeadOutputBuffers(UnitSpec *unitSpec, BufColorAllocator& bufColor)
+{
+	// recycle buffers of outputs without consumers. the unit still needs them
+	// while it runs, but leaving them allocated for the rest of the def leaks
+	// one wire buffer per unused output, which adds up in large defs with
+	// multi-output units.
+	for (uint32 i=0; i<unitSpec->mNumOutputs; ++i) {
+		OutputSpec *outputSpec = unitSpec->mOutputSpec + i;
+		if (outputSpec->mCalcRate == calc_FullRate && outputSpec->mNumConsumers == 0) {
+			bufColor.release(outputSpec->mBufferIndex);
+		}
+	}
+}
+
 void DoBufferColoring(World *inWorld, GraphDef *inGraphDef)
 {
 	// count consumers of outputs
@@ -942,6 +1543,7 @@ void DoBufferColoring(World *inWorld, GraphDef *inGraphDef)
 				// set wire index, alloc outputs
 				AllocOutputBuffers(unitSpec, bufColor, wireIndexCtr);
 			}
+			ReleaseDeadOutputBuffers(unitSpec, bufColor);
 		}
 
 		inGraphDef->mNumWireBufs = bufColor.NumBufs();
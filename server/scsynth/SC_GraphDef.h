@@ -47,6 +47,7 @@ struct GraphDef
 	uint32 mNumUnitSpecs;
 	uint32 mNumWireBufs;
 	uint32 mNumCalcUnits;
+	uint32 mControlBatchSize;	// >1: this def's control-rate units run every Nth block (see Graph_CalcBatched)
 
 	float32 *mInitialControlValues;
 	float32 *mConstants;
@@ -55,6 +56,8 @@ struct GraphDef
 
 	size_t mWiresAllocSize, mUnitsAllocSize, mCalcUnitsAllocSize;
 	size_t mControlAllocSize, mMapControlsAllocSize, mMapControlRatesAllocSize;
+	size_t mControlSnapshotAllocSize;
+	size_t mWireBufSpaceAllocSize;	// nonzero with -T: each graph carries its own wire buffers
 
 	uint32 mNumParamSpecs;
 	ParamSpec *mParamSpecs;
@@ -63,6 +66,13 @@ struct GraphDef
 	int mRefCount;
 	struct GraphDef* mNext;
 
+	// free-list of recycled graph memory blocks. every graph of a def is
+	// carved out of one allocation of mNodeDef.mAllocSize bytes, so dead
+	// blocks can be handed directly to the next Graph_New of the same def
+	// without going through the allocator's free bins.
+	void* mGraphBlockFreeList;
+	uint32 mNumGraphBlocks;
+
 	struct GraphDef *mOriginal;
 
 	uint32 mNumVariants;
@@ -70,11 +80,14 @@ struct GraphDef
 };
 typedef struct GraphDef GraphDef;
 
+enum { kGraphDefMaxGraphBlocks = 32 }; // recycled blocks kept per def
+
 GraphDef* GraphDef_Recv(World *inWorld, char *buffer, GraphDef *inList);
 GraphDef* GraphDef_Load(struct World *inWorld, const char *filename, GraphDef* inList);
 GraphDef* GraphDef_LoadDir(struct World *inWorld, char *dirname, GraphDef* inList);
 GraphDef* GraphDef_LoadGlob(World *inWorld, const char *pattern, GraphDef *inList);
 SCErr GraphDef_Remove(World *inWorld, int32 *inName);
+void GraphDef_PurgeGraphBlocks(struct World *inWorld, GraphDef *inGraphDef);
 SCErr GraphDef_DeleteMsg(struct World *inWorld, GraphDef *inDef);
 void GraphDef_Dump(GraphDef *inGraphDef);
 int32 GetHash(ParamSpec* inParamSpec);
@@ -31,6 +31,8 @@
 #include "SC_WorldOptions.h"
 #include "SC_Errors.h"
 #include "scsynthsend.h"
+#include "SC_HiddenWorld.h"
+#include "SC_DspWorkerPool.h"
 
 NodeDef gGroupNodeDef;
 
@@ -38,6 +40,7 @@ void Group_Dtor(Group *inGroup)
 {
 	Group_DeleteAll(inGroup);
 	inGroup->mNode.mWorld->mNumGroups--;
+	if (inGroup->mCalcNodes) World_Free(inGroup->mNode.mWorld, inGroup->mCalcNodes);
 	Node_Dtor(&inGroup->mNode);
 }
 
@@ -48,7 +51,7 @@ void GroupNodeDef_Init()
 	gGroupNodeDef.mAllocSize = sizeof(Group);
 }
 
-int Group_New(World *inWorld, int32 inID, Group** outGroup)
+int Group_New(World *inWorld, int32 inID, Group** outGroup, bool inParallel)
 {
 	Group *group;
 	int err = Node_New(inWorld, &gGroupNodeDef, inID, (Node**)&group);
@@ -58,19 +61,131 @@ int Group_New(World *inWorld, int32 inID, Group** outGroup)
 	group->mNode.mIsGroup = true;
 	group->mHead = 0;
 	group->mTail = 0;
+	group->mCalcNodes = 0;
+	group->mNumCalcNodes = 0;
+	group->mMaxCalcNodes = 0;
+	group->mCalcNodesDirty = true;
+	group->mParallel = inParallel;
 	inWorld->mNumGroups++;
 	*outGroup = group;
 
 	return kSCErr_None;
 }
 
+static void Group_RebuildCalcNodes(Group *inGroup)
+{
+	int numChildren = 0;
+	for (Node *child = inGroup->mHead; child; child = child->mNext) numChildren++;
+
+	if (numChildren > inGroup->mMaxCalcNodes) {
+		World *world = inGroup->mNode.mWorld;
+		if (inGroup->mCalcNodes) World_Free(world, inGroup->mCalcNodes);
+		int newSize = sc_max(sc_max(numChildren, 2 * inGroup->mMaxCalcNodes), 8);
+		inGroup->mCalcNodes = (Node**)World_Alloc(world, newSize * sizeof(Node*));
+		inGroup->mMaxCalcNodes = inGroup->mCalcNodes ? newSize : 0;
+	}
+
+	Node **nodes = inGroup->mCalcNodes;
+	if (!nodes) {
+		inGroup->mNumCalcNodes = 0;
+		return;
+	}
+	int i = 0;
+	for (Node *child = inGroup->mHead; child; child = child->mNext) nodes[i++] = child;
+	inGroup->mNumCalcNodes = numChildren;
+	inGroup->mCalcNodesDirty = false;
+}
+
+// run a parallel group: graphs in their steady state fan out over the
+// worker pool, everything else (groups, first calcs, paused or ended
+// nodes) runs inline on the audio thread in list order. only Graph_Calc
+// is safe off the audio thread - first calcs construct units from the RT
+// pool and the other calc funcs mutate the tree.
+static void Group_CalcParallel(Group *inGroup, SC_DspWorkerPool *pool)
+{
+	Node **nodes = inGroup->mCalcNodes;
+	int numNodes = inGroup->mNumCalcNodes;
+
+	int base = pool->mScratchUsed;
+	Node **par = pool->mScratch + base;
+	int npar = 0;
+	int room = pool->mScratchCapacity - base;
+
+	for (int i = 0; i < numNodes; ++i) {
+		Node *child = nodes[i];
+		if (child->mCalcFunc == (NodeCalcFunc)&Graph_Calc && npar < room)
+			par[npar++] = child;
+	}
+	pool->mScratchUsed = base + npar;
+
+	// inline pass first: new synths get their first calc, groups (possibly
+	// parallel themselves) recurse, and anything that did not fit in the
+	// scratch space still runs here.
+	for (int i = 0, j = 0; i < numNodes; ++i) {
+		Node *child = nodes[i];
+		if (j < npar && child == par[j]) { j++; continue; }
+		(*child->mCalcFunc)(child);
+	}
+
+	if (npar == 1) {
+		Node *child = par[0];
+		if (child->mCalcFunc == (NodeCalcFunc)&Graph_Calc)
+			(*child->mCalcFunc)(child);
+	} else if (npar > 1) {
+		HiddenWorld *hw = inGroup->mNode.mWorld->hw;
+		hw->mParallelCalcActive = true;
+		pool->CalcNodes(par, npar, (NodeCalcFunc)&Graph_Calc);
+		hw->mParallelCalcActive = false;
+
+		// nodes whose calc func changed while the job was being set up or
+		// run (ended or paused by an inline sibling) were skipped by the
+		// workers; give them their serial turn so same-block deletion and
+		// pausing behave exactly as in a sequential group.
+		for (int i = 0; i < npar; ++i) {
+			Node *child = par[i];
+			if (child->mCalcFunc != (NodeCalcFunc)&Graph_Calc)
+				(*child->mCalcFunc)(child);
+		}
+
+		// done actions that restructure the tree were deferred during the
+		// fan-out; apply them now that every worker has joined.
+		hw->mDeferredDoneActions.Perform();
+	}
+
+	pool->mScratchUsed = base;
+}
+
 void Group_Calc(Group *inGroup)
 {
-	Node *child = inGroup->mHead;
-	while (child) {
-	Node *next = child->mNext;
+	if (inGroup->mCalcNodesDirty) Group_RebuildCalcNodes(inGroup);
+
+	Node **nodes = inGroup->mCalcNodes;
+	if (!nodes) {
+		// RT pool exhausted; chase the list like before
+		Node *child = inGroup->mHead;
+		while (child) {
+			Node *next = child->mNext;
+			(*child->mCalcFunc)(child);
+			child = next;
+		}
+		return;
+	}
+
+	if (inGroup->mParallel) {
+		SC_DspWorkerPool *pool = inGroup->mNode.mWorld->hw->mDspWorkers;
+		if (pool) {
+			Group_CalcParallel(inGroup, pool);
+			return;
+		}
+	}
+
+	// a node deleting itself at its own calc slot only marks the snapshot
+	// stale; the rest of this pass keeps scanning it, which is exactly the
+	// next-pointer snapshot the list walk used to take.
+	int numNodes = inGroup->mNumCalcNodes;
+	for (int i = 0; i < numNodes; ++i) {
+		Node *child = nodes[i];
 		(*child->mCalcFunc)(child);
-		child = next;
 	}
 }
 
@@ -375,6 +490,7 @@ void Group_DeleteAll(Group *inGroup)
 		child = next;
 	}
 	inGroup->mHead = inGroup->mTail = 0;
+	inGroup->mCalcNodesDirty = true;
 }
 
 void Group_DeepFreeGraphs(Group *inGroup)
@@ -400,6 +516,7 @@ void Group_AddHead (Group *s, Node *child)
 	if (s->mHead) { s->mHead->mPrev = child; s->mHead = child; }
 	else s->mHead = s->mTail = child;
 	child->mParent = s;
+	s->mCalcNodesDirty = true;
 }
 
 void Group_AddTail (Group *s, Node *child)
@@ -410,6 +527,7 @@ void Group_AddTail (Group *s, Node *child)
 	if (s->mTail) { s->mTail->mNext = child; s->mTail = child; }
 	else s->mHead = s->mTail = child;
 	child->mParent = s;
+	s->mCalcNodesDirty = true;
 }
 
 void Group_Insert(Group *s, Node *child, int index)
@@ -28,6 +28,18 @@ struct Group {
 	Node mNode;
 
 	Node *mHead, *mTail;
+
+	// dense snapshot of the children in execution order, so the per-block
+	// walk is a linear scan instead of chasing list pointers across the RT
+	// heap. list edits only mark it stale; Group_Calc rebuilds it lazily.
+	Node **mCalcNodes;
+	int mNumCalcNodes;
+	int mMaxCalcNodes;
+	bool mCalcNodesDirty;
+
+	// created by /p_new: steady-state synth children may run on the DSP
+	// worker pool. ignored (plain sequential group) when -T is not given.
+	bool mParallel;
 };
 typedef struct Group Group;
 
@@ -28,8 +28,12 @@
 #include "SC_RGen.h"
 #include "HashTable.h"
 #include "SC_World.h"
-#include "SC_Reply.h"
+#include "SC_ReplyImpl.hpp"
+#include "SC_SynthDef.h"
 #include "MsgFifo.h"
+#include "SC_Lock.h"
+#include "SC_RTAllocator.h"
+#include <atomic>
 #include <map>
 
 #include "boost/sync/semaphore.hpp"
@@ -72,6 +76,7 @@ struct NodeEndMsg {
 	int32 mHeadID;
 	int32 mTailID;
 	int32 mState;
+	int32 mDefName[kSCNodeDefNameLen];	// synths only; feeds the NRT node tree mirror
 
 	void Perform();
 };
@@ -82,19 +87,54 @@ struct DeleteGraphDefMsg {
 	void Perform();
 };
 
+// real time safe print message: formatted on the RT thread into a fixed
+// slot, handed to stdio from the NRT thread. longer messages are truncated.
+struct PrintMsg {
+	char mText[248];
 
-typedef MsgFifoNoFree<TriggerMsg, 1024> TriggersFifo;
-typedef MsgFifoNoFree<NodeReplyMsg, 1024> NodeReplyFifo;
-typedef MsgFifoNoFree<NodeEndMsg, 1024> NodeEndsFifo;
+	void Perform();
+};
+
+// done actions that delete nodes other than the unit's own are deferred
+// while a parallel group is mid fan-out and performed on the audio thread
+// after the join. the node is looked up by ID at perform time in case it
+// was deleted in the meantime.
+struct DoneActionMsg {
+	World *mWorld;
+	int32 mDoneAction;
+	int32 mNodeID;
+
+	void Perform();
+};
+
+
+// the RT-to-NRT fifos use the multi-writer variant because with parallel
+// group workers enabled (-T) triggers, node replies, state messages and
+// prints can be produced from several DSP threads in the same block.
+// triggers and node replies are sized for analysis patches that emit tens
+// of thousands of records per second: the NRT thread drains them in batches
+// into the reply batcher, but must ride out its scheduling jitter. drops
+// are counted (see Node_SendTrigger) and reported in /status.reply.
+typedef MsgFifoMultiWriter<TriggerMsg, 16384> TriggersFifo;
+typedef MsgFifoMultiWriter<NodeReplyMsg, 4096> NodeReplyFifo;
+typedef MsgFifoMultiWriter<NodeEndMsg, 1024> NodeEndsFifo;
 typedef MsgFifoNoFree<DeleteGraphDefMsg, 512> DeleteGraphDefsFifo;
+typedef MsgFifoMultiWriter<PrintMsg, 256> PrintFifo;
+typedef MsgFifoMultiWriter<DoneActionMsg, 256> DoneActionFifo;
 typedef HashTable<struct GraphDef, Malloc> GrafDefTable;
 
 typedef std::map<struct ReplyAddress, uint32> ClientIDDict;
 
+// buffer indices map onto this many locks guarding the NRT buffer mirror,
+// so commands working on one buffer never block World_CopySndBuf readers of
+// unrelated buffers. the RT thread stays lock free: it only reads mSndBufs,
+// which is mutated on the RT thread itself (command stage 3).
+enum { kSndBufLockStripes = 64 };
+
 struct HiddenWorld
 {
-	class AllocPool *mAllocPool;
-	IntHashTable<struct Node, AllocPool> *mNodeLib;
+	class SC_RTAllocator *mAllocPool;
+	IntHashTable<struct Node, SC_RTAllocator> *mNodeLib;
 	GrafDefTable *mGraphDefLib;
 	uint32 mNumUsers, mMaxUsers;
 	ReplyAddress *mUsers;
@@ -107,10 +147,26 @@ struct HiddenWorld
 	uint32 mMaxWireBufs;
 	float *mWireBufSpace;
 
+	// server-side bus registry: one bit per channel, set while a range is
+	// handed out. OSC commands execute on the RT thread, so no locking.
+	uint32 *mAudioBusAllocMap;
+	uint32 *mControlBusAllocMap;
+
 	TriggersFifo mTriggers;
 	NodeReplyFifo mNodeMsgs;
+	// records lost to full fifos, cumulative since boot; reported in
+	// /status.reply so clients can tell silence from drops
+	std::atomic<int32> mDroppedTriggers;
+	std::atomic<int32> mDroppedNodeMsgs;
 	NodeEndsFifo mNodeEnds;
 	DeleteGraphDefsFifo mDeleteGraphDefs;
+	PrintFifo mPrints;
+	DoneActionFifo mDeferredDoneActions;
+	// done graphs detached by Node_DeferDelete but not yet reclaimed,
+	// chained through Node::mNext; World_ReclaimPendingNodes runs their
+	// destructors a bounded number per block
+	struct Node *mPendingFreeNodes;
+	ReplyBatcher mReplyBatcher;	// owned by the NRT thread
 
 	boost::sync::semaphore * mQuitProgram;
 	bool mTerminating;
@@ -131,6 +187,21 @@ struct HiddenWorld
 	const char *mInDeviceName;
 	const char *mOutDeviceName;
 	class server_shared_memory_creator * mShmem;
+	bool mShmemMetering;	// write per-bus peak/rms into the shared memory each block
+	bool mSanitizeOutputs;	// scrub NaN/Inf/denormals from the hardware output buses each block
+	uint32 mControlBatchSize;	// control-rate-heavy defs run their control units every Nth block
+	class NodeTreeMirror *mNodeTreeMirror;	// NRT shadow of the node tree; 0 in NRT mode
+	class SC_CmdWorkerPool *mCmdWorkerPool;	// runs sequenced command NRT stages; 0 in NRT mode
+	uint32 mNumParallelWorkers;	// /p_new groups fan out over this many DSP threads; 0 = serial
+	bool mParallelCalcActive;	// true while a parallel group is mid fan-out
+	class SC_DspWorkerPool *mDspWorkers;	// 0 unless -T was given
+	bool mShareSndBufs;	// -s: /b_allocRead data comes from the machine-wide shared cache
+	struct SC_BufPeaks **mBufPeaks;	// per-buffer min/max/rms pyramids built by /b_peaks; NRT state
+	std::atomic_flag mAllocLock;	// guards mAllocPool when parallel workers run
+	class SC_OscJournal *mOscJournal;	// records incoming OSC packets as a score; 0 unless requested
+	struct SC_AnalysisSegment *mAnalysisData;	// read-only template segments from /ad_load; RT-thread owned list
+	class SC_RecordTap *mRecordTap;	// streamed bus capture (/rtap_start); 0 while no tap runs
+	SC_Lock *mSndBufStripeLocks;	// kSndBufLockStripes locks, indexed by buffer number modulo stripe count
 };
 
 typedef struct HiddenWorld HiddenWorld;
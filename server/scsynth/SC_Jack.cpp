@@ -76,6 +76,12 @@ static void sc_jack_shutdown_cb(void *arg);
 
 typedef jack_default_audio_sample_t sc_jack_sample_t;
 
+// when JACK's sample format matches the engine's, whole channels are moved
+// with memcpy/memset instead of converting loops. the bus channels cannot
+// alias JACK's port buffers outright: In/Out units index into the world's
+// single contiguous bus array, so a per-channel copy always remains.
+static const bool kJackSampleFormatMatches = sizeof(sc_jack_sample_t) == sizeof(float);
+
 struct SC_JackPortList
 {
 	int					mSize;
@@ -446,8 +452,8 @@ void SC_JackDriver::Run()
 
 	try {
 		mFromEngine.Free();
-		mToEngine.Perform();
-		mOscPacketsToEngine.Perform();
+		mToEngine.PerformAll();
+		mOscPacketsToEngine.PerformAll();
 
 		int numInputs = mInputList->mSize;
 		int numOutputs = mOutputList->mSize;
@@ -501,8 +507,12 @@ void SC_JackDriver::Run()
 			for (int k = 0; k < minInputs; ++k) {
 				sc_jack_sample_t *src = inBuffers[k] + bufFramePos;
 				float *dst = inBuses + k * bufFrames;
-				for (int n = 0; n < bufFrames; ++n) {
-					*dst++ = *src++;
+				if (kJackSampleFormatMatches) {
+					memcpy(dst, src, bufFrames * sizeof(float));
+				} else {
+					for (int n = 0; n < bufFrames; ++n) {
+						*dst++ = *src++;
+					}
 				}
 				*tch++ = bufCounter;
 			}
@@ -511,6 +521,7 @@ void SC_JackDriver::Run()
 			int64 schedTime;
 			int64 nextTime = oscTime + oscInc;
 
+			mScheduler.Advance(nextTime); // release due wheel events for draining
 			while ((schedTime = mScheduler.NextTime()) <= nextTime) {
 				float diffTime = (float)(schedTime - oscTime) * oscToSamples + 0.5;
 				float diffTimeFloor = floor(diffTime);
@@ -534,13 +545,15 @@ void SC_JackDriver::Run()
 				sc_jack_sample_t *dst = outBuffers[k] + bufFramePos;
 				if (*tch++ == bufCounter) {
 					float *src = outBuses + k * bufFrames;
-					for (int n = 0; n < bufFrames; ++n) {
-						*dst++ = *src++;
+					if (kJackSampleFormatMatches) {
+						memcpy(dst, src, bufFrames * sizeof(float));
+					} else {
+						for (int n = 0; n < bufFrames; ++n) {
+							*dst++ = *src++;
+						}
 					}
 				} else {
-					for (int n = 0; n < bufFrames; ++n) {
-						*dst++ = 0.0f;
-					}
+					memset(dst, 0, bufFrames * sizeof(sc_jack_sample_t));
 				}
 			}
 
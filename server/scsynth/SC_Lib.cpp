@@ -161,6 +161,12 @@ SCErr NewCommand(const char *inPath, uint32 inCommandNumber, SC_CommandFunc inFu
 	// support integer OSC commands
 	gCmdArray[inCommandNumber] = cmd;
 
+	// the one-probe dispatch table, if already laid out, must cover this too.
+	// (all commands are normally registered before the first layout.)
+	extern bool gCmdHashBuilt;
+	if (gCmdHashBuilt)
+		gCmdHashBuilt = BuildCmdHashTable();
+
 	return kSCErr_None;
 }
 
@@ -29,7 +29,11 @@
 #include "SC_StringParser.h"
 #include "SC_InterfaceTable.h"
 #include "SC_DirUtils.h"
+#include <atomic>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 #ifndef _MSC_VER
 #include <dirent.h>
 #endif //_MSC_VER
@@ -74,8 +78,116 @@ extern struct InterfaceTable gInterfaceTable;
 SC_LibCmd* gCmdArray[NUMBER_OF_COMMANDS];
 
 void initMiscCommands();
+
+// =====================================================================
+// one-probe dispatch of string-addressed commands.
+//
+// gCmdLib resolves a command name with a hash probe plus a name compare per
+// collision. The command set is fixed once initMiscCommands has run, so a
+// collision-free table can be laid out up front and string dispatch becomes
+// one displacement fetch, one slot fetch and one name verify per message.
+// Laid out with the classic hash-and-displace scheme: commands are grouped
+// into buckets by one hash of the name, and each bucket gets a displacement
+// chosen so that all of its commands land in empty slots of the final table.
+
+const int32 kCmdHashTableSize = 512;	// power of two, > 2x the command count
+const int32 kCmdHashNumBuckets = 128;	// power of two
+const int32 kCmdHashMaxDisp = 4096;
+
+static SC_LibCmd *gCmdHashTable[kCmdHashTableSize];
+static int32 gCmdHashDisp[kCmdHashNumBuckets];
+bool gCmdHashBuilt = false;
+
+static inline int32 CmdHashSlot(int32 inHash, int32 inDisp)
+{
+	return Hash(inHash + inDisp) & (kCmdHashTableSize - 1);
+}
+
+bool BuildCmdHashTable()
+{
+	SC_LibCmd *cmds[kCmdHashTableSize];
+	int32 numCmds = 0;
+	for (int32 i = 0; i < gCmdLib->TableSize(); ++i) {
+		SC_LibCmd *cmd = gCmdLib->AtIndex(i);
+		if (!cmd) continue;
+		if (numCmds == kCmdHashTableSize) return false;
+		cmds[numCmds++] = cmd;
+	}
+
+	int32 bucketSize[kCmdHashNumBuckets];
+	memset(bucketSize, 0, sizeof(bucketSize));
+	for (int32 i = 0; i < numCmds; ++i)
+		bucketSize[GetHash(cmds[i]) & (kCmdHashNumBuckets - 1)]++;
+
+	memset(gCmdHashTable, 0, sizeof(gCmdHashTable));
+	memset(gCmdHashDisp, 0, sizeof(gCmdHashDisp));
+
+	// place the fullest buckets first, while the table is emptiest
+	int32 remaining = numCmds;
+	while (remaining > 0) {
+		int32 bucket = -1;
+		for (int32 i = 0; i < kCmdHashNumBuckets; ++i)
+			if (bucketSize[i] > 0 && (bucket < 0 || bucketSize[i] > bucketSize[bucket]))
+				bucket = i;
+
+		SC_LibCmd *members[kCmdHashTableSize];
+		int32 numMembers = 0;
+		for (int32 i = 0; i < numCmds; ++i)
+			if ((GetHash(cmds[i]) & (kCmdHashNumBuckets - 1)) == bucket)
+				members[numMembers++] = cmds[i];
+
+		int32 disp = 0;
+		for (; disp < kCmdHashMaxDisp; ++disp) {
+			bool fits = true;
+			for (int32 i = 0; fits && i < numMembers; ++i) {
+				int32 slot = CmdHashSlot(GetHash(members[i]), disp);
+				if (gCmdHashTable[slot]) fits = false;
+				for (int32 j = 0; fits && j < i; ++j)
+					if (CmdHashSlot(GetHash(members[j]), disp) == slot) fits = false;
+			}
+			if (fits) break;
+		}
+		if (disp == kCmdHashMaxDisp) return false; // no layout found; keep probing gCmdLib
+
+		gCmdHashDisp[bucket] = disp;
+		for (int32 i = 0; i < numMembers; ++i)
+			gCmdHashTable[CmdHashSlot(GetHash(members[i]), disp)] = members[i];
+
+		remaining -= numMembers;
+		bucketSize[bucket] = 0;
+	}
+	return true;
+}
+
+SC_LibCmd* LookupCommand(int32 *inName)
+{
+	if (gCmdHashBuilt) {
+		int32 hash = Hash(inName);
+		int32 disp = gCmdHashDisp[hash & (kCmdHashNumBuckets - 1)];
+		SC_LibCmd *cmd = gCmdHashTable[CmdHashSlot(hash, disp)];
+		if (cmd && GetHash(cmd) == hash && str4eq(inName, cmd->Name()))
+			return cmd;
+		return 0;	// the table covers the whole command set; a miss is unknown
+	}
+	return gCmdLib->Get(inName);
+}
+
 static bool PlugIn_LoadDir(const char *dirname, bool reportError);
+static void PlugIn_LoadCollected();
 std::vector<void*> open_handles;
+
+/*	Plugins found during the directory walk. Opening a shared object and
+	resolving its entry points is the expensive part of plugin loading and is
+	safe to do from several threads at once, so the walk only collects paths
+	here; PlugIn_LoadCollected() then opens them in a small thread pool and
+	calls the "load" entries serially on the boot thread, in walk order, since
+	they register into the unit def hash tables which are not thread safe. */
+struct PlugInCandidate {
+	std::string mPath;
+	void *mHandle = nullptr;
+	LoadPlugInFunc mLoadFunc = nullptr;
+};
+static std::vector<PlugInCandidate> gPlugInCandidates;
 #ifdef __APPLE__
 void read_section(const struct mach_header *mhp, unsigned long slide, const char *segname, const char *sectname)
 {
@@ -93,27 +205,57 @@ void read_section(const struct mach_header *mhp, unsigned long slide, const char
 }
 #endif
 
-extern void IO_Load(InterfaceTable *table);
-extern void Osc_Load(InterfaceTable *table);
-extern void Delay_Load(InterfaceTable *table);
-extern void BinaryOp_Load(InterfaceTable *table);
-extern void Filter_Load(InterfaceTable *table);
-extern void Gendyn_Load(InterfaceTable *table);
-extern void LF_Load(InterfaceTable *table);
-extern void Noise_Load(InterfaceTable *table);
-extern void MulAdd_Load(InterfaceTable *table);
-extern void Grain_Load(InterfaceTable *table);
-extern void Pan_Load(InterfaceTable *table);
-extern void Reverb_Load(InterfaceTable *table);
-extern void Trigger_Load(InterfaceTable *table);
-extern void UnaryOp_Load(InterfaceTable *table);
-extern void DiskIO_Load(InterfaceTable *table);
-extern void Test_Load(InterfaceTable *table);
-extern void PhysicalModeling_Load(InterfaceTable *table);
-extern void Demand_Load(InterfaceTable *table);
-extern void DynNoise_Load(InterfaceTable *table);
-extern void FFT_UGens_Load(InterfaceTable *table);
-extern void iPhone_Load(InterfaceTable *table);
+#ifdef STATIC_PLUGINS
+/*	Entry points of the statically linked plugins. When STATIC_PLUGINS is
+	defined, PluginLoad(name) in each plugin source expands to name##_Load, so
+	the plugin files themselves are unchanged. The list below must mirror the
+	sources compiled into the scsynth_static_plugins library
+	(server/plugins/CMakeLists.txt); referencing the load functions here is
+	also what makes the linker pull each plugin's object out of that archive. */
+#define SC_STATIC_PLUGINS(def) \
+	def(BinaryOp) \
+	def(Chaos) \
+	def(Delay) \
+	def(Demand) \
+	def(DynNoise) \
+	def(FFT_UGens) \
+	def(Filter) \
+	def(Gendyn) \
+	def(Grain) \
+	def(IO) \
+	def(LF) \
+	def(Matrix) \
+	def(MulAdd) \
+	def(Noise) \
+	def(Osc) \
+	def(Pan) \
+	def(PhysicalModeling) \
+	def(Reverb) \
+	def(Test) \
+	def(Trigger) \
+	def(UnaryOp) \
+	def(UnpackFFTUGens)
+
+#define SC_DECLARE_PLUGIN_LOAD(name) extern void name##_Load(InterfaceTable *inTable);
+SC_STATIC_PLUGINS(SC_DECLARE_PLUGIN_LOAD)
+#ifndef NO_LIBSNDFILE
+extern void DiskIO_Load(InterfaceTable *inTable);
+#endif
+#if defined(SC_IPHONE) && !TARGET_IPHONE_SIMULATOR
+extern void iPhone_Load(InterfaceTable *inTable);
+#endif
+
+#define SC_PLUGIN_LOAD_ENTRY(name) name##_Load,
+static LoadPlugInFunc const gStaticPluginLoadTable[] = {
+	SC_STATIC_PLUGINS(SC_PLUGIN_LOAD_ENTRY)
+#ifndef NO_LIBSNDFILE
+	DiskIO_Load,
+#endif
+#if defined(SC_IPHONE) && !TARGET_IPHONE_SIMULATOR
+	iPhone_Load,
+#endif
+};
+#endif // STATIC_PLUGINS
 
 
 void deinitialize_library()
@@ -147,31 +289,13 @@ void initialize_library(const char *uGensPluginPath)
 	gPlugInCmds = new HashTable<PlugInCmd, Malloc>(&gMalloc, 64, true);
 
 	initMiscCommands();
+	gCmdHashBuilt = BuildCmdHashTable();
 
 #ifdef STATIC_PLUGINS
-	IO_Load(&gInterfaceTable);
-	Osc_Load(&gInterfaceTable);
-	Delay_Load(&gInterfaceTable);
-	BinaryOp_Load(&gInterfaceTable);
-	Filter_Load(&gInterfaceTable);
-	Gendyn_Load(&gInterfaceTable);
-	LF_Load(&gInterfaceTable);
-	Noise_Load(&gInterfaceTable);
-	MulAdd_Load(&gInterfaceTable);
-	Grain_Load(&gInterfaceTable);
-	Pan_Load(&gInterfaceTable);
-	Reverb_Load(&gInterfaceTable);
-	Trigger_Load(&gInterfaceTable);
-	UnaryOp_Load(&gInterfaceTable);
-	DiskIO_Load(&gInterfaceTable);
-	PhysicalModeling_Load(&gInterfaceTable);
-	Test_Load(&gInterfaceTable);
-	Demand_Load(&gInterfaceTable);
-	DynNoise_Load(&gInterfaceTable);
-#if defined(SC_IPHONE) && !TARGET_IPHONE_SIMULATOR
-	iPhone_Load(&gInterfaceTable);
-#endif
-	FFT_UGens_Load(&gInterfaceTable);
+	// no directory walk, no dlopen: just run the entry point of every plugin
+	// compiled into the binary.
+	for (size_t i = 0; i < sizeof(gStaticPluginLoadTable)/sizeof(gStaticPluginLoadTable[0]); ++i)
+		(*gStaticPluginLoadTable[i])(&gInterfaceTable);
 	return;
 #endif
 
@@ -219,6 +343,9 @@ void initialize_library(const char *uGensPluginPath)
 			PlugIn_LoadDir(const_cast<char *>(sp.NextToken()), true);
 		}
 	}
+
+	PlugIn_LoadCollected();
+
 #ifdef __APPLE__
 	/* on darwin plugins are lazily loaded (dlopen uses mmap internally), which can produce audible
 		glitches when UGens have to be paged-in. to work around this we preload all the plugins by
@@ -286,8 +413,11 @@ bool checkServerVersion(void * f, const char * filename)
 	return true;
 }
 
-static bool PlugIn_Load(const char *filename)
+/*	open a shared object and resolve its entry points; may run off the boot
+	thread. posts its own errors, which may interleave with other workers. */
+static bool PlugIn_Open(PlugInCandidate & candidate)
 {
+	const char *filename = candidate.mPath.c_str();
 #ifdef _WIN32
 
 	HINSTANCE hinstance = LoadLibrary( filename );
@@ -325,11 +455,8 @@ static bool PlugIn_Load(const char *filename)
 		return false;
 	}
 
-	LoadPlugInFunc loadFunc = (LoadPlugInFunc)ptr;
-	(*loadFunc)(&gInterfaceTable);
-
-	// FIXME: at the moment we never call FreeLibrary() on a loaded plugin
-	open_handles.push_back(hinstance);
+	candidate.mHandle = (void*)hinstance;
+	candidate.mLoadFunc = (LoadPlugInFunc)ptr;
 	return true;
 
 #else
@@ -361,15 +488,56 @@ static bool PlugIn_Load(const char *filename)
 		return false;
 	}
 
-	LoadPlugInFunc loadFunc = (LoadPlugInFunc)ptr;
-	(*loadFunc)(&gInterfaceTable);
-
-	open_handles.push_back(handle);
+	candidate.mHandle = handle;
+	candidate.mLoadFunc = (LoadPlugInFunc)ptr;
 	return true;
 
 #endif
 }
 
+/*	open the collected plugins in parallel, then run their "load" entries
+	serially in walk order so registration behaves exactly as the old
+	one-at-a-time loader did. */
+static void PlugIn_LoadCollected()
+{
+	size_t numCandidates = gPlugInCandidates.size();
+	if (!numCandidates) return;
+
+	std::vector<char> opened(numCandidates, 0);
+	std::atomic<size_t> nextCandidate(0);
+
+	size_t numThreads = std::thread::hardware_concurrency();
+	if (numThreads > numCandidates) numThreads = numCandidates;
+	if (numThreads > 8) numThreads = 8;
+
+	auto openWorker = [&]() {
+		for (;;) {
+			size_t i = nextCandidate.fetch_add(1);
+			if (i >= numCandidates) return;
+			opened[i] = PlugIn_Open(gPlugInCandidates[i]);
+		}
+	};
+
+	if (numThreads > 1) {
+		std::vector<std::thread> workers;
+		for (size_t i = 0; i < numThreads - 1; ++i)
+			workers.emplace_back(openWorker);
+		openWorker();
+		for (auto & worker : workers)
+			worker.join();
+	} else
+		openWorker();
+
+	// FIXME: at the moment we never call FreeLibrary()/dlclose() on a loaded plugin
+	for (size_t i = 0; i < numCandidates; ++i) {
+		if (!opened[i]) continue;
+		(*gPlugInCandidates[i].mLoadFunc)(&gInterfaceTable);
+		open_handles.push_back(gPlugInCandidates[i].mHandle);
+	}
+
+	gPlugInCandidates.clear();
+}
+
 static bool PlugIn_LoadDir(const char *dirname, bool reportError)
 {
 	bool success = true;
@@ -398,7 +566,8 @@ static bool PlugIn_LoadDir(const char *dirname, bool reportError)
 			int extlen = strlen(SC_PLUGIN_EXT);
 			char *extptr = diritem+dnamelen-extlen;
 			if (strncmp(extptr, SC_PLUGIN_EXT, extlen) == 0) {
-				success = PlugIn_Load(diritem);
+				gPlugInCandidates.push_back(PlugInCandidate());
+				gPlugInCandidates.back().mPath = diritem;
 			}
 	}
 
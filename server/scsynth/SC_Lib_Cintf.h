@@ -47,6 +47,14 @@ void initialize_library(const char *mUGensPluginPath);
 void deinitialize_library();
 SCErr NewCommand(const char *inPath, uint32 inCommandNumber, SC_CommandFunc inFunc);
 
+// one-probe lookup of a string-addressed server command. Falls back to
+// probing gCmdLib if no collision-free table could be laid out.
+SC_LibCmd* LookupCommand(int32 *inName);
+
+// (re)build the lookup table over the commands registered in gCmdLib.
+// Returns false when no collision-free layout was found.
+bool BuildCmdHashTable();
+
 extern SC_LibCmd* gCmdArray[NUMBER_OF_COMMANDS];
 
 
@@ -140,6 +140,14 @@ SCErr meth_b_allocRead(World *inWorld, int inSize, char *inData, ReplyAddress *i
 	return kSCErr_None;
 }
 
+SCErr meth_b_allocReadResample(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_b_allocReadResample(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	CallSequencedCommand(BufAllocReadResampleCmd, inWorld, inSize, inData, inReply);
+
+	return kSCErr_None;
+}
+
 SCErr meth_b_read(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
 SCErr meth_b_read(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
 {
@@ -179,6 +187,20 @@ SCErr meth_b_zero(World *inWorld, int inSize, char *inData, ReplyAddress *inRepl
 	return kSCErr_None;
 }
 
+SCErr meth_b_peaks(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_b_peaks(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	CallSequencedCommand(BufPeaksCmd, inWorld, inSize, inData, inReply);
+	return kSCErr_None;
+}
+
+SCErr meth_b_getPeaks(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_b_getPeaks(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	CallSequencedCommand(BufGetPeaksCmd, inWorld, inSize, inData, inReply);
+	return kSCErr_None;
+}
+
 
 SCErr meth_u_cmd(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
 SCErr meth_u_cmd(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
@@ -224,6 +246,53 @@ SCErr meth_n_trace(World *inWorld, int inSize, char *inData, ReplyAddress* /*inR
 	return kSCErr_None;
 }
 
+SCErr meth_n_profile(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_n_profile(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	sc_msg_iter msg(inSize, inData);
+	Node *node = Msg_GetNode(inWorld, msg);
+	if (!node) return kSCErr_NodeNotFound;
+	if (node->mIsGroup) return kSCErr_Failed;
+
+	Graph *graph = (Graph*)node;
+	int32 flag = msg.geti();
+
+	if (flag != 2)
+		return (SCErr)Graph_Profile(graph, flag);
+
+	// flag 2: report the accumulators gathered so far
+	if (!graph->mProfile) return kSCErr_Failed;
+
+	uint32 numCalcUnits = graph->mNumCalcUnits;
+	big_scpacket packet;
+	packet.adds("/n_profile.reply");
+	packet.maketags(4 + numCalcUnits * 3);
+	packet.addtag(',');
+	packet.addtag('i');
+	packet.addtag('i');
+	packet.addtag('i');
+	for (uint32 i=0; i<numCalcUnits; ++i) {
+		packet.addtag('s');
+		packet.addtag('f');
+		packet.addtag('f');
+	}
+	packet.addi(node->mID);
+	packet.addi((int)numCalcUnits);
+	packet.addi(graph->mProfileTicks);
+	UnitProfile *profile = graph->mProfile;
+	for (uint32 i=0; i<numCalcUnits; ++i) {
+		packet.adds((char*)graph->mCalcUnits[i]->mUnitDef->mUnitDefName);
+		packet.addf((float)profile[i].mTotalSeconds);
+		packet.addf(profile[i].mPeakSeconds);
+	}
+
+	if (packet.size()) {
+		CallSequencedCommand(SendReplyCmd, inWorld, packet.size(), packet.data(), inReply);
+	}
+
+	return kSCErr_None;
+}
+
 SCErr meth_g_dumpTree(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
 SCErr meth_g_dumpTree(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
 {
@@ -269,9 +338,44 @@ SCErr meth_g_dumpTree(World *inWorld, int inSize, char *inData, ReplyAddress* /*
 //	return kSCErr_None;
 //}
 
+/*	answer queries without controls from the NRT node tree mirror so polling
+	a large tree does not walk it on the audio thread. group addressing is
+	resolved here, against the live tree; the resolved IDs go to QueryTreeCmd.
+	sets outHandled when the query was deferred (or failed to resolve);
+	otherwise the caller falls back to the live tree walk. */
+static SCErr queryTreeFromMirror(World *inWorld, int inSize, char *inData, ReplyAddress *inReply, bool *outHandled)
+{
+	const int kMaxDeferredGroups = 64;
+	int32 groupIDs[kMaxDeferredGroups];
+	int numGroups = 0;
+
+	sc_msg_iter msg(inSize, inData);
+	while (msg.remain()) {
+		Group *group = Msg_GetGroup(inWorld, msg);
+		if (!group) {
+			*outHandled = true;
+			return kSCErr_GroupNotFound;
+		}
+		int32 flag = msg.geti();
+		if (flag || numGroups == kMaxDeferredGroups)
+			return kSCErr_None;	// control values need the live tree
+		groupIDs[numGroups++] = group->mNode.mID;
+	}
+
+	*outHandled = true;
+	CallSequencedCommand(QueryTreeCmd, inWorld, numGroups * (int)sizeof(int32), (char*)groupIDs, inReply);
+	return kSCErr_None;
+}
+
 SCErr meth_g_queryTree(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
 SCErr meth_g_queryTree(World *inWorld, int inSize, char *inData, ReplyAddress* inReply)
 {
+	if (inWorld->mRealTime && inWorld->hw->mNodeTreeMirror) {
+		bool handled = false;
+		SCErr err = queryTreeFromMirror(inWorld, inSize, inData, inReply, &handled);
+		if (handled) return err;
+	}
+
 	sc_msg_iter msg(inSize, inData);
 	while (msg.remain()) {
 		Group *group = Msg_GetGroup(inWorld, msg);
@@ -751,6 +855,51 @@ SCErr meth_d_recv(World *inWorld, int inSize, char *inData, ReplyAddress *inRepl
 
 }
 
+SCErr meth_d_recvSHM(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_d_recvSHM(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	CallSequencedCommand(RecvSynthDefShmCmd, inWorld, inSize, inData, inReply);
+
+	return kSCErr_None;
+
+}
+
+SCErr meth_ad_load(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_ad_load(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	CallSequencedCommand(AnalysisDataLoadCmd, inWorld, inSize, inData, inReply);
+
+	return kSCErr_None;
+
+}
+
+SCErr meth_ad_free(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_ad_free(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	CallSequencedCommand(AnalysisDataFreeCmd, inWorld, inSize, inData, inReply);
+
+	return kSCErr_None;
+
+}
+
+SCErr meth_rtap_start(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_rtap_start(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	CallSequencedCommand(RecordTapStartCmd, inWorld, inSize, inData, inReply);
+
+	return kSCErr_None;
+
+}
+
+SCErr meth_rtap_stop(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_rtap_stop(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	CallSequencedCommand(RecordTapStopCmd, inWorld, inSize, inData, inReply);
+
+	return kSCErr_None;
+
+}
+
 SCErr meth_d_loadDir(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
 SCErr meth_d_loadDir(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
 {
@@ -905,8 +1054,115 @@ SCErr meth_s_newargs(World *inWorld, int inSize, char *inData, ReplyAddress* /*i
 	return kSCErr_None;
 }
 
-SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
-SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
+/* batched synth creation:
+ *
+ *   /s_newBundle <defname> <addAction> <targetGroupID> <numSynths> <numControls>
+ *                <control>... (name or index, shared by all synths)
+ *                then per synth: <nodeID> <value>... (one float per control)
+ *
+ * creates numSynths synths of one def with a single GraphDef lookup and
+ * splices the whole run into the target group with one list operation.
+ * only the group add actions (0 = head, 1 = tail) are supported, and the
+ * control values are plain floats; mappings still go through /n_map.
+ */
+SCErr meth_s_newBundle(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_s_newBundle(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
+{
+	const int kMaxBundleControls = 128;
+	SCErr err;
+	sc_msg_iter msg(inSize, inData);
+	int32 *defname = msg.gets4();
+	if (!defname) return kSCErr_WrongArgType;
+
+	int32 addAction = msg.geti();
+
+	GraphDef *def = World_GetGraphDef(inWorld, defname);
+	if (!def) {
+		scprintf("*** ERROR: SynthDef %s not found\n", (char*)defname);
+		return kSCErr_SynthDefNotFound;
+	}
+
+	if (addAction != 0 && addAction != 1) return kSCErr_Failed;
+
+	Group *group = Msg_GetGroup(inWorld, msg);
+	if (!group) return kSCErr_GroupNotFound;
+
+	int32 numSynths = msg.geti();
+	int32 numControls = msg.geti();
+	if (numSynths <= 0) return kSCErr_WrongArgType;
+	if (numControls < 0 || numControls > kMaxBundleControls) return kSCErr_Failed;
+
+	// the control addresses are parsed once and shared by all synths
+	int32* ctlNames[kMaxBundleControls];
+	int32 ctlHashes[kMaxBundleControls];
+	int32 ctlIndices[kMaxBundleControls];
+	for (int32 i = 0; i < numControls; ++i) {
+		if (msg.nextTag('i') == 's') {
+			ctlNames[i] = msg.gets4();
+			ctlHashes[i] = Hash(ctlNames[i]);
+		} else {
+			ctlNames[i] = 0;
+			ctlIndices[i] = msg.geti();
+		}
+	}
+
+	// build the run of nodes as a detached chain, then splice it once
+	SCErr retErr = kSCErr_None;
+	Node *first = 0;
+	Node *last = 0;
+	for (int32 i = 0; i < numSynths; ++i) {
+		int32 nodeID = msg.geti();
+
+		sc_msg_iter noArgs(0, inData);
+		Graph *graph = 0;
+		err = Graph_New(inWorld, def, nodeID, &noArgs, &graph, true);
+		if (err || !graph) {
+			// keep the nodes created so far; they are spliced in below
+			retErr = err ? err : kSCErr_Failed;
+			break;
+		}
+
+		for (int32 j = 0; j < numControls; ++j) {
+			float32 value = msg.getf();
+			if (ctlNames[j])
+				Graph_SetControl(graph, ctlHashes[j], ctlNames[j], 0, value);
+			else
+				Graph_SetControl(graph, ctlIndices[j], value);
+		}
+
+		Node *node = &graph->mNode;
+		node->mParent = group;
+		if (!first) {
+			first = last = node;
+		} else {
+			last->mNext = node;
+			node->mPrev = last;
+			last = node;
+		}
+	}
+
+	if (!first) return retErr;
+
+	if (addAction == 0) {
+		last->mNext = group->mHead;
+		if (group->mHead) group->mHead->mPrev = last;
+		else group->mTail = last;
+		group->mHead = first;
+	} else {
+		first->mPrev = group->mTail;
+		if (group->mTail) group->mTail->mNext = first;
+		else group->mHead = first;
+		group->mTail = last;
+	}
+	group->mCalcNodesDirty = true;
+
+	for (Node *node = first; node; node = node == last ? 0 : node->mNext)
+		Node_StateMsg(node, kNode_Go);
+
+	return retErr;
+}
+
+static SCErr meth_g_new_impl(World *inWorld, int inSize, char *inData, bool inParallel)
 {
 	SCErr err;
 
@@ -920,7 +1176,7 @@ SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress* /*inRep
 			case 0 : {
 				Group *group = Msg_GetGroup(inWorld, msg);
 				if (!group) return kSCErr_GroupNotFound;
-				err = Group_New(inWorld, newGroupID, &newGroup);
+				err = Group_New(inWorld, newGroupID, &newGroup, inParallel);
 				if (err) {
 					if (err == kSCErr_DuplicateNodeID) {
 						newGroup = World_GetGroup(inWorld, newGroupID);
@@ -934,7 +1190,7 @@ SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress* /*inRep
 			case 1 : {
 				Group *group = Msg_GetGroup(inWorld, msg);
 				if (!group) return kSCErr_GroupNotFound;
-				err = Group_New(inWorld, newGroupID, &newGroup);
+				err = Group_New(inWorld, newGroupID, &newGroup, inParallel);
 				if (err) {
 					if (err == kSCErr_DuplicateNodeID) {
 						newGroup = World_GetGroup(inWorld, newGroupID);
@@ -948,7 +1204,7 @@ SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress* /*inRep
 			case 2 : {
 				Node *beforeThisNode = Msg_GetNode(inWorld, msg);
 				if (!beforeThisNode) return kSCErr_TargetNodeNotFound;
-				err = Group_New(inWorld, newGroupID, &newGroup);
+				err = Group_New(inWorld, newGroupID, &newGroup, inParallel);
 				if (err) {
 					if (err == kSCErr_DuplicateNodeID) {
 						newGroup = World_GetGroup(inWorld, newGroupID);
@@ -962,7 +1218,7 @@ SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress* /*inRep
 			case 3 : {
 				Node *afterThisNode = Msg_GetNode(inWorld, msg);
 				if (!afterThisNode) return kSCErr_TargetNodeNotFound;
-				err = Group_New(inWorld, newGroupID, &newGroup);
+				err = Group_New(inWorld, newGroupID, &newGroup, inParallel);
 				if (err) {
 					if (err == kSCErr_DuplicateNodeID) {
 						newGroup = World_GetGroup(inWorld, newGroupID);
@@ -979,7 +1235,7 @@ SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress* /*inRep
 				if (replaceThisNode->mID == 0) return kSCErr_ReplaceRootGroup;
 				Node_RemoveID(replaceThisNode);
 
-				err = Group_New(inWorld, newGroupID, &newGroup);
+				err = Group_New(inWorld, newGroupID, &newGroup, inParallel);
 				if (err) return err;
 				Node_Replace(&newGroup->mNode, replaceThisNode);
 			} break;
@@ -992,11 +1248,19 @@ SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress* /*inRep
 	return kSCErr_None;
 }
 
+SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_g_new(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
+{
+	return meth_g_new_impl(inWorld, inSize, inData, false);
+}
+
 SCErr meth_p_new(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
-SCErr meth_p_new(World *inWorld, int inSize, char *inData, ReplyAddress* inReply)
+SCErr meth_p_new(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
 {
-	/* we emulate the concept of parallel groups by using sequential groups */
-	return meth_g_new(inWorld, inSize, inData, inReply);
+	/* without the -T option parallel groups behave exactly like sequential
+	   groups; with it, Group_Calc fans their synth children out over the
+	   DSP worker pool */
+	return meth_g_new_impl(inWorld, inSize, inData, true);
 }
 
 SCErr meth_n_free(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
@@ -1192,6 +1456,81 @@ SCErr meth_n_order(World *inWorld, int inSize, char *inData, ReplyAddress* /*inR
 	return kSCErr_None;
 }
 
+static bool Node_IsAncestorOf(Node *node, Node *other)
+{
+	if (!node->mIsGroup) return false;
+	for (Group *parent = other->mParent; parent; parent = parent->mNode.mParent) {
+		if (&parent->mNode == node) return true;
+	}
+	return false;
+}
+
+SCErr meth_n_move(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_n_move(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
+{
+	// transactional bulk move: a list of [addAction, targetID, nodeID] edits.
+	// the whole list is validated before the tree is touched, so a bad entry
+	// cannot leave a large rearrangement half applied.
+	sc_msg_iter check(inSize, inData);
+	while (check.remain()) {
+		int32 addAction = check.geti();
+		switch (addAction) {
+			case 0 :
+			case 1 : {
+				Group *group = Msg_GetGroup(inWorld, check);
+				if (!group) return kSCErr_GroupNotFound;
+				Node *node = Msg_GetNode(inWorld, check);
+				if (!node) return kSCErr_NodeNotFound;
+				if (!node->mParent) return kSCErr_Failed; // can't move the root group
+				if (node == &group->mNode || Node_IsAncestorOf(node, &group->mNode))
+					return kSCErr_Failed; // group can't be moved into itself
+			} break;
+			case 2 :
+			case 3 : {
+				Node *target = Msg_GetNode(inWorld, check);
+				if (!target) return kSCErr_TargetNodeNotFound;
+				Node *node = Msg_GetNode(inWorld, check);
+				if (!node) return kSCErr_NodeNotFound;
+				if (!node->mParent) return kSCErr_Failed;
+				if (node == target || Node_IsAncestorOf(node, target))
+					return kSCErr_Failed;
+			} break;
+			default : return kSCErr_Failed;
+		}
+	}
+
+	sc_msg_iter msg(inSize, inData);
+	while (msg.remain()) {
+		int32 addAction = msg.geti();
+		switch (addAction) {
+			case 0 :
+			case 1 : {
+				Group *group = Msg_GetGroup(inWorld, msg);
+				Node *node = Msg_GetNode(inWorld, msg);
+				// relative addressing can resolve differently once earlier
+				// edits have been applied; guard against that here
+				if (!group || !node) continue;
+				Node_Remove(node);
+				if (addAction == 0) Group_AddHead(group, node);
+				else Group_AddTail(group, node);
+				Node_StateMsg(node, kNode_Move);
+			} break;
+			case 2 :
+			case 3 : {
+				Node *target = Msg_GetNode(inWorld, msg);
+				Node *node = Msg_GetNode(inWorld, msg);
+				if (!target || !node) continue;
+				Node_Remove(node);
+				if (addAction == 2) Node_AddBefore(node, target);
+				else Node_AddAfter(node, target);
+				Node_StateMsg(node, kNode_Move);
+			} break;
+		}
+	}
+
+	return kSCErr_None;
+}
+
 SCErr meth_g_head(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
 SCErr meth_g_head(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
 {
@@ -1404,6 +1743,38 @@ SCErr meth_b_setn(World *inWorld, int inSize, char *inData, ReplyAddress* /*inRe
 	return kSCErr_None;
 }
 
+/*	like /b_setn, but the samples arrive as one blob of network order float32,
+	so a big fill is one conversion pass instead of a tag dispatched getf()
+	per sample. args: bufnum, start index, blob. */
+SCErr meth_b_setb(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_b_setb(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
+{
+	sc_msg_iter msg(inSize, inData);
+	int bufindex = msg.geti();
+	SndBuf* buf = World_GetBuf(inWorld, bufindex);
+	if (!buf) return kSCErr_Failed;
+
+	int32 start = msg.geti();
+	size_t blobSize = msg.getbsize();
+	int32 n = blobSize / sizeof(float32);
+	if (n <= 0) return kSCErr_WrongArgType;
+	if (start < 0 || start + n > buf->samples) return kSCErr_IndexOutOfRange;
+
+	const int32* src = (const int32*)(msg.rdpos + sizeof(int32));	// skip the blob length
+	float32* dst = buf->data + start;
+#if BYTE_ORDER == BIG_ENDIAN
+	memcpy(dst, src, n * sizeof(float32));
+#else
+	for (int i=0; i<n; ++i) {
+		union { int32 i; float32 f; } u;
+		u.i = sc_ntohl(src[i]);
+		dst[i] = u.f;
+	}
+#endif
+
+	return kSCErr_None;
+}
+
 
 SCErr meth_b_fill(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
 SCErr meth_b_fill(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
@@ -1614,6 +1985,108 @@ SCErr meth_c_fill(World *inWorld, int inSize, char *inData, ReplyAddress* /*inRe
 }
 
 
+// server-side bus registry. these commands execute on the RT thread like all
+// others, so the bitmaps in HiddenWorld need no locking; a first fit scan over
+// one-bit-per-channel words is cheap enough at command rate.
+
+static inline bool BusAllocMap_IsSet(const uint32 *map, uint32 index)
+{
+	return (map[index >> 5] & (1 << (index & 31))) != 0;
+}
+
+static int BusAllocMap_Alloc(uint32 *map, uint32 numChannels, uint32 numBusses)
+{
+	if (numBusses == 0 || numBusses > numChannels) return -1;
+	uint32 start = 0;
+	while (start + numBusses <= numChannels) {
+		uint32 run = 0;
+		while (run < numBusses && !BusAllocMap_IsSet(map, start + run)) run++;
+		if (run == numBusses) {
+			for (uint32 i = 0; i < numBusses; ++i)
+				map[(start + i) >> 5] |= 1 << ((start + i) & 31);
+			return (int)start;
+		}
+		start += run + 1; // skip past the taken bus that broke the run
+	}
+	return -1;
+}
+
+static void BusAllocMap_Free(uint32 *map, uint32 numChannels, uint32 index, uint32 numBusses)
+{
+	uint32 end = sc_min(index + numBusses, numChannels);
+	for (uint32 i = index; i < end; ++i)
+		map[i >> 5] &= ~(1 << (i & 31));
+}
+
+static SCErr BusRegistry_AllocRange(World *inWorld, const char *replyName, uint32 *map, uint32 numChannels,
+	int inSize, char *inData, ReplyAddress *inReply)
+{
+	sc_msg_iter msg(inSize, inData);
+
+	int numBusses = msg.geti(1);
+	if (numBusses < 1) return kSCErr_IndexOutOfRange;
+
+	// index is -1 when no contiguous range is left
+	int index = BusAllocMap_Alloc(map, numChannels, numBusses);
+
+	small_scpacket packet;
+	packet.adds(replyName);
+	packet.maketags(3);
+	packet.addtag(',');
+	packet.addtag('i');
+	packet.addtag('i');
+	packet.addi(index);
+	packet.addi(numBusses);
+
+	CallSequencedCommand(SendReplyCmd, inWorld, packet.size(), packet.data(), inReply);
+
+	return kSCErr_None;
+}
+
+static SCErr BusRegistry_FreeRange(World *inWorld, uint32 *map, uint32 numChannels,
+	int inSize, char *inData)
+{
+	sc_msg_iter msg(inSize, inData);
+
+	while (msg.remain() >= 8) {
+		int index = msg.geti();
+		int numBusses = msg.geti();
+		if (index < 0 || numBusses < 1 || (uint32)index >= numChannels)
+			return kSCErr_IndexOutOfRange;
+		BusAllocMap_Free(map, numChannels, index, numBusses);
+	}
+
+	return kSCErr_None;
+}
+
+SCErr meth_c_allocRange(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_c_allocRange(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	return BusRegistry_AllocRange(inWorld, "/c_allocRange", inWorld->hw->mControlBusAllocMap,
+		inWorld->mNumControlBusChannels, inSize, inData, inReply);
+}
+
+SCErr meth_c_freeRange(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_c_freeRange(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
+{
+	return BusRegistry_FreeRange(inWorld, inWorld->hw->mControlBusAllocMap,
+		inWorld->mNumControlBusChannels, inSize, inData);
+}
+
+SCErr meth_a_allocRange(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_a_allocRange(World *inWorld, int inSize, char *inData, ReplyAddress *inReply)
+{
+	return BusRegistry_AllocRange(inWorld, "/a_allocRange", inWorld->hw->mAudioBusAllocMap,
+		inWorld->mNumAudioBusChannels, inSize, inData, inReply);
+}
+
+SCErr meth_a_freeRange(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_a_freeRange(World *inWorld, int inSize, char *inData, ReplyAddress* /*inReply*/)
+{
+	return BusRegistry_FreeRange(inWorld, inWorld->hw->mAudioBusAllocMap,
+		inWorld->mNumAudioBusChannels, inSize, inData);
+}
+
 
 SCErr meth_b_get(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
 SCErr meth_b_get(World *inWorld, int inSize, char *inData, ReplyAddress* inReply)
@@ -1713,6 +2186,50 @@ SCErr meth_b_getn(World *inWorld, int inSize, char *inData, ReplyAddress* inRepl
 }
 
 
+/*	like /b_getn, but replies with one /b_setb carrying the samples as a blob
+	of network order float32. args: bufnum, start index, num samples. */
+SCErr meth_b_getb(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+SCErr meth_b_getb(World *inWorld, int inSize, char *inData, ReplyAddress* inReply)
+{
+	sc_msg_iter msg(inSize, inData);
+	int bufindex = msg.geti();
+	SndBuf* buf = World_GetBuf(inWorld, bufindex);
+	if (!buf) return kSCErr_Failed;
+
+	int32 start = msg.geti();
+	int32 n = msg.geti();
+	if (n <= 0) return kSCErr_WrongArgType;
+	if (start < 0 || start + n > buf->samples) return kSCErr_IndexOutOfRange;
+	// the blob has to fit in one reply packet
+	if (n * sizeof(float32) > 65000) return kSCErr_Failed;
+
+	big_scpacket packet;
+	packet.adds("/b_setb");
+	packet.maketags(4);
+	packet.addtag(',');
+	packet.addtag('i');
+	packet.addtag('i');
+	packet.addtag('b');
+	packet.addi(bufindex);
+	packet.addi(start);
+#if BYTE_ORDER == BIG_ENDIAN
+	packet.addb((uint8*)(buf->data + start), n * sizeof(float32));
+#else
+	{
+		packet.addi(n * sizeof(float32));
+		const float32* src = buf->data + start;
+		for (int i=0; i<n; ++i)
+			packet.addf(src[i]);
+	}
+#endif
+
+	if (packet.size()) {
+		CallSequencedCommand(SendReplyCmd, inWorld, packet.size(), packet.data(), inReply);
+	}
+
+	return kSCErr_None;
+}
+
 SCErr meth_s_get(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
 SCErr meth_s_get(World *inWorld, int inSize, char *inData, ReplyAddress* inReply)
 {
@@ -1896,8 +2413,10 @@ void initMiscCommands()
 
 	NEW_COMMAND(s_new);
 	NEW_COMMAND(s_newargs);
+	NEW_COMMAND(s_newBundle);
 
 	NEW_COMMAND(n_trace);
+	NEW_COMMAND(n_profile);
 	NEW_COMMAND(n_free);
 	NEW_COMMAND(n_run);
 
@@ -1916,6 +2435,7 @@ void initMiscCommands()
 	NEW_COMMAND(n_before);
 	NEW_COMMAND(n_after);
 	NEW_COMMAND(n_order);
+	NEW_COMMAND(n_move);
 
 	NEW_COMMAND(g_new);
 	NEW_COMMAND(g_head);
@@ -1928,6 +2448,12 @@ void initMiscCommands()
 	NEW_COMMAND(b_alloc);
 	NEW_COMMAND(b_allocRead);
 	NEW_COMMAND(b_allocReadChannel);
+	NEW_COMMAND(b_allocReadResample);
+	NEW_COMMAND(d_recvSHM);
+	NEW_COMMAND(ad_load);
+	NEW_COMMAND(rtap_start);
+	NEW_COMMAND(rtap_stop);
+	NEW_COMMAND(ad_free);
 
 	NEW_COMMAND(b_read);
 	NEW_COMMAND(b_readChannel);
@@ -1939,13 +2465,22 @@ void initMiscCommands()
 	NEW_COMMAND(b_zero);
 	NEW_COMMAND(b_set);
 	NEW_COMMAND(b_setn);
+	NEW_COMMAND(b_setb);
+	NEW_COMMAND(b_getb);
 	NEW_COMMAND(b_fill);
 	NEW_COMMAND(b_gen);
+	NEW_COMMAND(b_peaks);
+	NEW_COMMAND(b_getPeaks);
 
 	NEW_COMMAND(c_set);
 	NEW_COMMAND(c_setn);
 	NEW_COMMAND(c_fill);
 
+	NEW_COMMAND(c_allocRange);
+	NEW_COMMAND(c_freeRange);
+	NEW_COMMAND(a_allocRange);
+	NEW_COMMAND(a_freeRange);
+
 	NEW_COMMAND(dumpOSC);
 
 	NEW_COMMAND(c_get);
@@ -33,8 +33,9 @@
 
 void Node_StateMsg(Node* inNode, int inState);
 
-// create a new node
-int Node_New(World *inWorld, NodeDef *def, int32 inID, Node** outNode)
+// create a new node. inMemory, if given, is a recycled block of
+// def->mAllocSize bytes whose ownership stays with the caller on failure.
+int Node_New(World *inWorld, NodeDef *def, int32 inID, Node** outNode, void *inMemory)
 {
 	if (inID < 0) {
 		if (inID == -1) { // -1 means generate an id for the event
@@ -49,7 +50,8 @@ int Node_New(World *inWorld, NodeDef *def, int32 inID, Node** outNode)
 		return kSCErr_DuplicateNodeID;
 	}
 
-	Node* node = (Node*)World_Alloc(inWorld, def->mAllocSize);
+	Node* node = inMemory ? (Node*)inMemory
+	                      : (Node*)World_Alloc(inWorld, def->mAllocSize);
 
 	node->mWorld = inWorld;
 	node->mDef = def;
@@ -61,7 +63,7 @@ int Node_New(World *inWorld, NodeDef *def, int32 inID, Node** outNode)
 	node->mID = inID;
 	node->mHash = Hash(inID);
 	if (!World_AddNode(inWorld, node)) {
-		World_Free(inWorld, node);
+		if (!inMemory) World_Free(inWorld, node);
 		return kSCErr_TooManyNodes;
 	}
 
@@ -72,13 +74,20 @@ int Node_New(World *inWorld, NodeDef *def, int32 inID, Node** outNode)
 	return kSCErr_None;
 }
 
-// node destructor
-void Node_Dtor(Node *inNode)
+// node destructor, leaving ownership of the node's memory block with the
+// caller (used for graph block recycling)
+void Node_DtorDetachMemory(Node *inNode)
 {
 	Node_StateMsg(inNode, kNode_End);
 	Node_Remove(inNode);
+	inNode->mWorld->hw->mNodeLib->Remove(inNode);
+}
+
+// node destructor
+void Node_Dtor(Node *inNode)
+{
 	World *world = inNode->mWorld;
-	world->hw->mNodeLib->Remove(inNode);
+	Node_DtorDetachMemory(inNode);
 	World_Free(world, inNode);
 }
 
@@ -93,6 +102,8 @@ void Node_Remove(Node* s)
 	if (s->mNext) s->mNext->mPrev = s->mPrev;
 	else if (group) group->mTail = s->mPrev;
 
+	if (group) group->mCalcNodesDirty = true;
+
 	s->mPrev = s->mNext = 0;
 	s->mParent = 0;
 }
@@ -130,6 +141,21 @@ void Node_Delete(Node* inNode)
 	else Graph_Dtor((Graph*)inNode);
 }
 
+// calc func installed by Node_End for graphs. everything the client can
+// see happens now -- /n_end goes out, the node leaves the tree and the
+// node library, its id can be reused -- but the unit destructors and pool
+// frees are parked on a pending list instead of running here. when
+// thousands of grains end in the same block this turns one huge teardown
+// into a bounded trickle (World_ReclaimPendingNodes).
+void Node_DeferDelete(Node* inNode)
+{
+	if (inNode->mID == 0) return; // failed
+	HiddenWorld *hw = inNode->mWorld->hw;
+	Node_DtorDetachMemory(inNode);
+	inNode->mNext = hw->mPendingFreeNodes;
+	hw->mPendingFreeNodes = inNode;
+}
+
 // add a node after another one
 void Node_AddAfter(Node* s, Node *afterThisOne)
 {
@@ -142,6 +168,7 @@ void Node_AddAfter(Node* s, Node *afterThisOne)
 	if (afterThisOne->mNext) afterThisOne->mNext->mPrev = s;
 	else s->mParent->mTail = s;
 	afterThisOne->mNext = s;
+	s->mParent->mCalcNodesDirty = true;
 }
 
 // add a node before another one
@@ -156,6 +183,7 @@ void Node_AddBefore(Node* s, Node *beforeThisOne)
 	if (beforeThisOne->mPrev) beforeThisOne->mPrev->mNext = s;
 	else s->mParent->mHead = s;
 	beforeThisOne->mPrev = s;
+	s->mParent->mCalcNodesDirty = true;
 }
 
 void Node_Replace(Node* s, Node *replaceThisOne)
@@ -175,6 +203,8 @@ void Node_Replace(Node* s, Node *replaceThisOne)
 	if (s->mNext) s->mNext->mPrev = s;
 	else group->mTail = s;
 
+	group->mCalcNodesDirty = true;
+
 	replaceThisOne->mPrev = replaceThisOne->mNext = 0;
 	replaceThisOne->mParent = 0;
 
@@ -250,17 +280,55 @@ void Node_NullCalc(struct Node* /*inNode*/)
 
 void Graph_FirstCalc(Graph *inGraph);
 void Graph_NullFirstCalc(Graph *inGraph);
+void Graph_CalcBatched(Graph *inGraph);
+void Graph_CalcAuto(Graph *inGraph);
+NodeCalcFunc Graph_PickCalcFunc(Graph *inGraph);
 
 // if inRun is zero then the node's calc function is set to Node_NullCalc,
-// otherwise its normal calc function is installed.
+// otherwise its normal calc function is installed. a run value of 2 turns
+// on auto-bypass: the synth keeps running but drops out while the audio
+// buses it reads stay untouched (see Graph_CalcAuto); on a group it is
+// applied to every node of the subtree.
 void Node_SetRun(Node* inNode, int inRun)
 {
-	if (inRun) {
+	if (inRun >= 2) {
+		if (inNode->mIsGroup) {
+			Group *group = (Group*)inNode;
+			for (Node *child = group->mHead; child; child = child->mNext)
+				Node_SetRun(child, inRun);
+			return;
+		}
+		Graph *graph = (Graph*)inNode;
+		if (!graph->mAutoBypass) {
+			// the watch list is kept across enable/disable: input units only
+			// re-report their bus when it changes.
+			graph->mAutoBypass = true;
+			graph->mBypassed = false;
+			graph->mQuietBlocks = 0;
+			if (inNode->mCalcFunc == (NodeCalcFunc)&Graph_Calc
+					|| inNode->mCalcFunc == (NodeCalcFunc)&Graph_CalcBatched)
+				inNode->mCalcFunc = (NodeCalcFunc)&Graph_CalcAuto;
+			// Graph_FirstCalc and resume pick it up via Graph_PickCalcFunc
+		}
+		if (inNode->mCalcFunc == &Node_NullCalc) {
+			inNode->mCalcFunc = (NodeCalcFunc)&Graph_CalcAuto;
+			Node_StateMsg(inNode, kNode_On);
+		}
+	} else if (inRun) {
+		if (!inNode->mIsGroup) {
+			Graph *graph = (Graph*)inNode;
+			if (graph->mAutoBypass) {
+				graph->mAutoBypass = false;
+				graph->mBypassed = false;
+				if (inNode->mCalcFunc == (NodeCalcFunc)&Graph_CalcAuto)
+					inNode->mCalcFunc = Graph_PickCalcFunc(graph);
+			}
+		}
 		if (inNode->mCalcFunc == &Node_NullCalc) {
 			if (inNode->mIsGroup) {
 				inNode->mCalcFunc = (NodeCalcFunc)&Group_Calc;
 			} else {
-				inNode->mCalcFunc = (NodeCalcFunc)&Graph_Calc;
+				inNode->mCalcFunc = Graph_PickCalcFunc((Graph*)inNode);
 			}
 			Node_StateMsg(inNode, kNode_On);
 		}
@@ -288,7 +356,10 @@ void Node_Trace(Node *inNode)
 
 void Node_End(Node* inNode)
 {
-	inNode->mCalcFunc = (NodeCalcFunc)&Node_Delete;
+	// groups tear down their whole subtree and stay synchronous; ended
+	// graphs are detached and reclaimed incrementally
+	if (inNode->mIsGroup) inNode->mCalcFunc = (NodeCalcFunc)&Node_Delete;
+	else inNode->mCalcFunc = (NodeCalcFunc)&Node_DeferDelete;
 }
 
 
@@ -305,7 +376,8 @@ void Node_SendTrigger(Node* inNode, int triggerID, float value)
 	msg.mNodeID = inNode->mID;
 	msg.mTriggerID = triggerID;
 	msg.mValue = value;
-	world->hw->mTriggers.Write(msg);
+	if (!world->hw->mTriggers.Write(msg))
+		world->hw->mDroppedTriggers.fetch_add(1, std::memory_order_relaxed);
 }
 
 // Send a reply from a node to a client program.
@@ -335,7 +407,11 @@ void Node_SendReply(Node* inNode, int replyID, const char* cmdName, int numArgs,
 	memcpy(msg.mCmdName, cmdName, cmdNameSize);
 	msg.mCmdNameSize = cmdNameSize;
 	msg.mRTMemory = mem;
-	world->hw->mNodeMsgs.Write(msg);
+	if (!world->hw->mNodeMsgs.Write(msg)) {
+		// the NRT side never sees the message, so free its memory here
+		World_Free(world, mem);
+		world->hw->mDroppedNodeMsgs.fetch_add(1, std::memory_order_relaxed);
+	}
 }
 
 void Node_SendReply(Node* inNode, int replyID, const char* cmdName, float value)
@@ -364,10 +440,12 @@ void Node_StateMsg(Node* inNode, int inState)
 		msg.mIsGroup = 1;
 		msg.mHeadID = group->mHead ? group->mHead->mID : -1;
 		msg.mTailID = group->mTail ? group->mTail->mID : -1;
+		msg.mDefName[0] = 0;
 	} else {
 		msg.mIsGroup = 0;
 		msg.mHeadID = -1;
 		msg.mTailID = -1;
+		memcpy(msg.mDefName, inNode->mDef->mName, sizeof(msg.mDefName));
 	}
 	msg.mState = inState;
 	world->hw->mNodeEnds.Write(msg);
@@ -375,47 +453,49 @@ void Node_StateMsg(Node* inNode, int inState)
 
 #include "SC_Unit.h"
 
-void Unit_DoneAction(int doneAction, Unit *unit)
+// the common switch behind doneAction handling; inNode is the node the
+// done action is "about" (the unit's enclosing graph).
+static void Node_DoneAction(int doneAction, Node *inNode)
 {
 	switch (doneAction)
 	{
 		case 1 :
-			Node_SetRun(&unit->mParent->mNode, 0);
+			Node_SetRun(inNode, 0);
 			break;
 		case 2 :
-			Node_End(&unit->mParent->mNode);
+			Node_End(inNode);
 			break;
 		case 3 :
 		{
-			Node_End(&unit->mParent->mNode);
-			Node* prev = unit->mParent->mNode.mPrev;
+			Node_End(inNode);
+			Node* prev = inNode->mPrev;
 			if (prev) Node_End(prev);
 		} break;
 		case 4 :
 		{
-			Node_End(&unit->mParent->mNode);
-			Node* next = unit->mParent->mNode.mNext;
+			Node_End(inNode);
+			Node* next = inNode->mNext;
 			if (next) Node_End(next);
 		} break;
 		case 5 :
 		{
-			Node_End(&unit->mParent->mNode);
-			Node* prev = unit->mParent->mNode.mPrev;
+			Node_End(inNode);
+			Node* prev = inNode->mPrev;
 			if (!prev) break;
 			if (prev && prev->mIsGroup) Group_DeleteAll((Group*)prev);
 			else Node_End(prev);
 		} break;
 		case 6 :
 		{
-			Node_End(&unit->mParent->mNode);
-			Node* next = unit->mParent->mNode.mNext;
+			Node_End(inNode);
+			Node* next = inNode->mNext;
 			if (!next) break;
 			if (next->mIsGroup) Group_DeleteAll((Group*)next);
 			else Node_End(next);
 		} break;
 		case 7 :
 		{
-			Node* node = &unit->mParent->mNode;
+			Node* node = inNode;
 			while (node) {
 				Node *prev = node->mPrev;
 				Node_End(node);
@@ -424,7 +504,7 @@ void Unit_DoneAction(int doneAction, Unit *unit)
 		} break;
 		case 8 :
 		{
-			Node* node = &unit->mParent->mNode;
+			Node* node = inNode;
 			while (node) {
 				Node *next = node->mNext;
 				Node_End(node);
@@ -433,35 +513,35 @@ void Unit_DoneAction(int doneAction, Unit *unit)
 		} break;
 		case 9 :
 		{
-			Node_End(&unit->mParent->mNode);
-			Node* prev = unit->mParent->mNode.mPrev;
+			Node_End(inNode);
+			Node* prev = inNode->mPrev;
 			if (prev) Node_SetRun(prev, 0);
 		} break;
 		case 10 :
 		{
-			Node_End(&unit->mParent->mNode);
-			Node* next = unit->mParent->mNode.mNext;
+			Node_End(inNode);
+			Node* next = inNode->mNext;
 			if (next) Node_SetRun(next, 0);
 		} break;
 		case 11 :
 		{
-			Node_End(&unit->mParent->mNode);
-			Node* prev = unit->mParent->mNode.mPrev;
+			Node_End(inNode);
+			Node* prev = inNode->mPrev;
 			if (!prev) break;
 			if (prev->mIsGroup) Group_DeepFreeGraphs((Group*)prev);
 			else Node_End(prev);
 		} break;
 		case 12 :
 		{
-			Node_End(&unit->mParent->mNode);
-			Node* next = unit->mParent->mNode.mNext;
+			Node_End(inNode);
+			Node* next = inNode->mNext;
 			if (!next) break;
 			if (next->mIsGroup) Group_DeepFreeGraphs((Group*)next);
 			else Node_End(next);
 		} break;
 		case 13 :
 		{
-			Node* node = unit->mParent->mNode.mParent->mHead;
+			Node* node = inNode->mParent->mHead;
 			while (node) {
 				Node *next = node->mNext;
 				Node_End(node);
@@ -469,7 +549,44 @@ void Unit_DoneAction(int doneAction, Unit *unit)
 			}
 		} break;
 		case 14 :
-			Node_End(&unit->mParent->mNode.mParent->mNode);
+			Node_End(&inNode->mParent->mNode);
 			break;
 	}
 }
+
+void Unit_DoneAction(int doneAction, Unit *unit)
+{
+	Node *node = &unit->mParent->mNode;
+	World *world = node->mWorld;
+
+	// done actions that immediately delete whole neighbouring groups cannot
+	// run while siblings are being calculated on the worker pool; queue them
+	// and let the parallel group drain the fifo after its join. the other
+	// actions only swap calc funcs and post fifo messages, which is safe
+	// from a worker.
+	switch (doneAction) {
+		case 5 : case 6 : case 11 : case 12 :
+			if (world->hw->mParallelCalcActive) {
+				DoneActionMsg msg;
+				msg.mWorld = world;
+				msg.mDoneAction = doneAction;
+				msg.mNodeID = node->mID;
+				world->hw->mDeferredDoneActions.Write(msg);
+				return;
+			}
+			break;
+		default:
+			break;
+	}
+
+	Node_DoneAction(doneAction, node);
+}
+
+void DoneActionMsg::Perform()
+{
+	// the node may have been deleted between the fan-out and the join;
+	// look it up again and drop the action if it is gone.
+	Node *node = World_GetNode(mWorld, mNodeID);
+	if (!node) return;
+	Node_DoneAction(mDoneAction, node);
+}
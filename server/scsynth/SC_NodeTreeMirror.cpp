@@ -0,0 +1,186 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "SC_NodeTreeMirror.h"
+#include "scsynthsend.h"
+#include <string.h>
+
+NodeTreeMirror::NodeTreeMirror()
+{
+	// the top group exists before the audio thread runs and never gets a /n_go
+	MirrorNode* root = new MirrorNode();
+	memset(root, 0, sizeof(MirrorNode));
+	root->mIsGroup = true;
+	mNodes[0] = root;
+}
+
+NodeTreeMirror::~NodeTreeMirror()
+{
+	for (std::map<int32, MirrorNode*>::iterator it = mNodes.begin(); it != mNodes.end(); ++it)
+		delete it->second;
+}
+
+NodeTreeMirror::MirrorNode* NodeTreeMirror::Find(int32 inID)
+{
+	std::map<int32, MirrorNode*>::iterator it = mNodes.find(inID);
+	return it == mNodes.end() ? 0 : it->second;
+}
+
+void NodeTreeMirror::Link(MirrorNode* node, int32 inParentID, int32 inPrevID, int32 inNextID)
+{
+	MirrorNode* parent = Find(inParentID);
+	node->mParent = parent;
+	node->mPrev = node->mNext = 0;
+	if (!parent) return;
+
+	MirrorNode* prev = Find(inPrevID);
+	MirrorNode* next = Find(inNextID);
+	if (prev && prev->mParent == parent) {
+		node->mPrev = prev;
+		node->mNext = prev->mNext;
+		if (prev->mNext) prev->mNext->mPrev = node;
+		else parent->mTail = node;
+		prev->mNext = node;
+	} else if (next && next->mParent == parent) {
+		node->mNext = next;
+		node->mPrev = next->mPrev;
+		if (next->mPrev) next->mPrev->mNext = node;
+		else parent->mHead = node;
+		next->mPrev = node;
+	} else {
+		// sole child, or the reference sibling was never mirrored
+		node->mPrev = parent->mTail;
+		if (parent->mTail) parent->mTail->mNext = node;
+		else parent->mHead = node;
+		parent->mTail = node;
+	}
+}
+
+void NodeTreeMirror::Unlink(MirrorNode* node)
+{
+	MirrorNode* parent = node->mParent;
+	if (node->mPrev) node->mPrev->mNext = node->mNext;
+	else if (parent) parent->mHead = node->mNext;
+	if (node->mNext) node->mNext->mPrev = node->mPrev;
+	else if (parent) parent->mTail = node->mPrev;
+	node->mParent = node->mPrev = node->mNext = 0;
+}
+
+void NodeTreeMirror::DeleteChildren(MirrorNode* group)
+{
+	MirrorNode* child = group->mHead;
+	while (child) {
+		MirrorNode* next = child->mNext;
+		if (child->mIsGroup) DeleteChildren(child);
+		mNodes.erase(child->mID);
+		delete child;
+		child = next;
+	}
+	group->mHead = group->mTail = 0;
+}
+
+void NodeTreeMirror::AddNode(int32 inID, int32 inParentID, int32 inPrevID, int32 inNextID,
+							bool inIsGroup, const int32* inDefName)
+{
+	MirrorNode* node = Find(inID);
+	if (node) {
+		// replaced in place (e.g. /s_new reusing an ID); treat as a move
+		Unlink(node);
+	} else {
+		node = new MirrorNode();
+		memset(node, 0, sizeof(MirrorNode));
+		node->mID = inID;
+		mNodes[inID] = node;
+	}
+	node->mIsGroup = inIsGroup;
+	if (!inIsGroup && inDefName)
+		memcpy(node->mDefName, inDefName, sizeof(node->mDefName));
+	Link(node, inParentID, inPrevID, inNextID);
+}
+
+void NodeTreeMirror::RemoveNode(int32 inID)
+{
+	MirrorNode* node = Find(inID);
+	if (!node) return;
+	if (node->mIsGroup) DeleteChildren(node);
+	Unlink(node);
+	if (inID == 0) return;	// the top group stays, emptied
+	mNodes.erase(inID);
+	delete node;
+}
+
+void NodeTreeMirror::MoveNode(int32 inID, int32 inParentID, int32 inPrevID, int32 inNextID)
+{
+	MirrorNode* node = Find(inID);
+	if (!node) return;
+	Unlink(node);
+	Link(node, inParentID, inPrevID, inNextID);
+}
+
+// count tags the same way Group_CountNodeTags does on the live tree
+void NodeTreeMirror::CountNodeTags(MirrorNode* group, int* count)
+{
+	for (MirrorNode* child = group->mHead; child; child = child->mNext) {
+		(*count) += 2;
+		if (child->mIsGroup) CountNodeTags(child, count);
+		else (*count)++;	// for the defname
+	}
+}
+
+void NodeTreeMirror::QueryGroup(MirrorNode* group, big_scpacket* packet)
+{
+	packet->addtag('i');
+	packet->addi(group->mID);
+
+	int count = 0;
+	for (MirrorNode* child = group->mHead; child; child = child->mNext)
+		count++;
+	packet->addtag('i');
+	packet->addi(count);
+
+	for (MirrorNode* child = group->mHead; child; child = child->mNext) {
+		if (child->mIsGroup) {
+			QueryGroup(child, packet);
+		} else {
+			packet->addtag('i');	// nodeID
+			packet->addtag('i');	// numChildren
+			packet->addtag('s');	// defname
+			packet->addi(child->mID);
+			packet->addi(-1);
+			packet->adds((char*)child->mDefName);
+		}
+	}
+}
+
+bool NodeTreeMirror::QueryTree(int32 inGroupID, big_scpacket& packet)
+{
+	MirrorNode* group = Find(inGroupID);
+	if (!group || !group->mIsGroup) return false;
+
+	packet.adds("/g_queryTree.reply");
+	int numNodeTags = 2;	// the queried group itself
+	CountNodeTags(group, &numNodeTags);
+	packet.maketags(numNodeTags + 2);
+	packet.addtag(',');
+	packet.addtag('i');
+	packet.addi(0);	// include controls flag
+	QueryGroup(group, &packet);
+	return true;
+}
@@ -0,0 +1,73 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#ifndef _SC_NodeTreeMirror_
+#define _SC_NodeTreeMirror_
+
+#include "SC_Types.h"
+#include "SC_SynthDef.h"
+#include "scsynthsend.h"
+#include <map>
+
+/*	A shadow copy of the node tree, maintained on the NRT thread by replaying
+	the node lifecycle messages that the audio thread already pushes through
+	the NodeEnds FIFO for /n_go, /n_end and /n_move notifications. /g_queryTree
+	without controls is answered from here, so polling a large tree no longer
+	walks it on the audio thread.
+
+	The mirror lags the live tree by at most one FIFO drain and never sees
+	nodes with negative IDs, which are excluded from state messages.
+	All methods must be called from the NRT thread. */
+class NodeTreeMirror
+{
+public:
+	NodeTreeMirror();
+	~NodeTreeMirror();
+
+	void AddNode(int32 inID, int32 inParentID, int32 inPrevID, int32 inNextID,
+				bool inIsGroup, const int32* inDefName);
+	void RemoveNode(int32 inID);
+	void MoveNode(int32 inID, int32 inParentID, int32 inPrevID, int32 inNextID);
+
+	// write a complete /g_queryTree.reply (without controls) for inGroupID.
+	// returns false if the group is not in the mirror.
+	bool QueryTree(int32 inGroupID, big_scpacket& packet);
+
+private:
+	struct MirrorNode
+	{
+		int32 mID;
+		bool mIsGroup;
+		int32 mDefName[kSCNodeDefNameLen];	// synths only
+		MirrorNode *mParent, *mPrev, *mNext;
+		MirrorNode *mHead, *mTail;			// groups only
+	};
+
+	MirrorNode* Find(int32 inID);
+	void Link(MirrorNode* node, int32 inParentID, int32 inPrevID, int32 inNextID);
+	void Unlink(MirrorNode* node);
+	void DeleteChildren(MirrorNode* group);
+	void CountNodeTags(MirrorNode* group, int* count);
+	void QueryGroup(MirrorNode* group, big_scpacket* packet);
+
+	std::map<int32, MirrorNode*> mNodes;
+};
+
+#endif
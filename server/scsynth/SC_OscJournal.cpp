@@ -0,0 +1,149 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "SC_OscJournal.h"
+#include "sc_msg_iter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int scprintf(const char *fmt, ...);
+
+static void writeBE32(FILE *file, int32 value)
+{
+	unsigned char bytes[4];
+	bytes[0] = (unsigned char)(value >> 24);
+	bytes[1] = (unsigned char)(value >> 16);
+	bytes[2] = (unsigned char)(value >> 8);
+	bytes[3] = (unsigned char)value;
+	fwrite(bytes, 1, 4, file);
+}
+
+static void writeBE64(FILE *file, int64 value)
+{
+	writeBE32(file, (int32)(value >> 32));
+	writeBE32(file, (int32)value);
+}
+
+void SC_OscJournalMsg::Perform()
+{
+	mJournal->WriteEntry(*this);
+}
+
+void SC_OscJournalMsg::Free()
+{
+	free(mData);
+}
+
+SC_OscJournal::SC_OscJournal(const char *inPath)
+	: mStartTime(-1), mPrevTime(0), mRunning(true)
+{
+	mFile = fopen(inPath, "wb");
+	if (!mFile) {
+		scprintf("ERROR: could not open OSC journal file '%s'.\n", inPath);
+		mRunning = false;
+		return;
+	}
+	mThread = SC_Thread([this]() { FlushLoop(); });
+}
+
+SC_OscJournal::~SC_OscJournal()
+{
+	if (!mFile) return;
+	{
+		lock_guard<SC_Lock> guard(mLock);
+		mRunning = false;
+	}
+	mHasData.notify_all();
+	mThread.join();
+	// the listener threads are gone by now; drain what the flush thread
+	// did not get to before it was stopped.
+	mFifo.Perform();
+	mFifo.Free();
+	fclose(mFile);
+}
+
+void SC_OscJournal::Record(int64 inArrivalTime, bool inIsBundle, const char *inData, int32 inSize)
+{
+	if (!mFile || inSize < (inIsBundle ? 16 : 4)) return;
+
+	// journal at the time the server performs the packet: the timetag for
+	// bundles scheduled in the future, the arrival time for messages and
+	// for immediate or late bundles.
+	int64 time = inArrivalTime;
+	if (inIsBundle) {
+		int64 timetag = OSCtime(inData + 8);
+		if (timetag != 0 && timetag != 1 && timetag > time) time = timetag;
+	}
+
+	SC_OscJournalMsg msg;
+	msg.mJournal = this;
+	msg.mTime = time;
+	msg.mSize = inSize;
+	msg.mIsBundle = inIsBundle;
+	msg.mData = (char*)malloc(inSize);
+	if (!msg.mData) return;
+	memcpy(msg.mData, inData, inSize);
+
+	if (!mFifo.Write(msg)) {
+		free(msg.mData);
+		scprintf("WARNING: OSC journal fifo full, packet not journaled.\n");
+		return;
+	}
+	mHasData.notify_one();
+}
+
+void SC_OscJournal::FlushLoop()
+{
+	unique_lock<SC_Lock> lock(mLock);
+	while (true) {
+		while (mRunning && !mFifo.HasData())
+			mHasData.wait(lock);
+		if (!mRunning) return;
+		lock.unlock();
+		mFifo.Perform();
+		mFifo.Free();
+		fflush(mFile);
+		lock.lock();
+	}
+}
+
+void SC_OscJournal::WriteEntry(const SC_OscJournalMsg& inMsg)
+{
+	if (mStartTime == -1) mStartTime = inMsg.mTime;
+	int64 time = inMsg.mTime - mStartTime;
+	// the non real time driver requires monotonic timestamps
+	if (time < mPrevTime) time = mPrevTime;
+	mPrevTime = time;
+
+	if (inMsg.mIsBundle) {
+		writeBE32(mFile, inMsg.mSize);
+		fwrite(inMsg.mData, 1, 8, mFile);	// "#bundle"
+		writeBE64(mFile, time);
+		fwrite(inMsg.mData + 16, 1, inMsg.mSize - 16, mFile);
+	} else {
+		// wrap the bare message in a bundle stamped with its arrival time
+		writeBE32(mFile, 20 + inMsg.mSize);
+		fwrite("#bundle", 1, 8, mFile);
+		writeBE64(mFile, time);
+		writeBE32(mFile, inMsg.mSize);
+		fwrite(inMsg.mData, 1, inMsg.mSize, mFile);
+	}
+}
@@ -0,0 +1,88 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#ifndef _SC_OscJournal_
+#define _SC_OscJournal_
+
+#include "SC_Types.h"
+#include "SC_Lock.h"
+#include "MsgFifo.h"
+
+#include <stdio.h>
+
+/*
+An OSC journal records every packet the server receives, in the non real
+time command file format: an int32 big endian length followed by a
+timestamped bundle. A journal therefore replays through the existing non
+real time path without any new machinery:
+
+	scsynth -N <journal-file> _ <output-file> <sample-rate> <header> <format>
+
+Socket listener threads hand packets to the journal through the lock free
+multi writer fifo, so journaling adds no locking to ProcessOSCPacket. A
+background thread rebases the timestamps to start at zero, forces them
+monotonic (a late or immediate packet is journaled at its arrival time,
+which is when the server performed it) and appends the records to disk.
+*/
+
+class SC_OscJournal;
+
+struct SC_OscJournalMsg
+{
+	SC_OscJournal *mJournal;
+	int64 mTime;	// arrival time for immediate packets, the timetag for scheduled bundles
+	int32 mSize;
+	char *mData;
+	bool mIsBundle;
+
+	void Perform();
+	void Free();
+};
+
+class SC_OscJournal
+{
+public:
+	SC_OscJournal(const char *inPath);
+	~SC_OscJournal();
+
+	bool IsOpen() const { return mFile != 0; }
+
+	// called from the socket listener threads; copies the packet.
+	void Record(int64 inArrivalTime, bool inIsBundle, const char *inData, int32 inSize);
+
+private:
+	friend struct SC_OscJournalMsg;
+
+	void FlushLoop();
+	void WriteEntry(const SC_OscJournalMsg& inMsg);
+
+	typedef MsgFifoMultiWriter<SC_OscJournalMsg, 2048> JournalFifo;
+	JournalFifo mFifo;
+
+	FILE *mFile;
+	int64 mStartTime;	// time of the first record; subtracted so the score starts at zero
+	int64 mPrevTime;
+	bool mRunning;
+	SC_Lock mLock;		// guards the wakeup only; the fifo needs no lock
+	condition_variable_any mHasData;
+	SC_Thread mThread;
+};
+
+#endif
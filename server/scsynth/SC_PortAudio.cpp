@@ -25,6 +25,7 @@
 #include "SC_Time.hpp"
 #include <math.h>
 #include <stdlib.h>
+#include <atomic>
 
 #include "portaudio.h"
 #define SC_PA_USE_DLL
@@ -88,16 +89,113 @@ void initializeScheduler()
 #endif //SC_PA_USE_DLL
 
 
+// single-writer single-reader ring carrying captured frames from a separate
+// input device's callback into the callback that runs the engine. the indices
+// only ever advance (apart from single-frame drift slips on the reader side),
+// so acquire/release atomics are all the synchronisation needed.
+struct SC_PaAggregateRing
+{
+	float *mFrames;		// frame-major: frame * mChannels + channel
+	uint32 mChannels;
+	uint32 mCapacity;	// frames, power of two
+	uint32 mMask;
+	std::atomic<uint32_t> mWritePos;
+	std::atomic<uint32_t> mReadPos;
+
+	SC_PaAggregateRing() : mFrames(0), mChannels(0), mCapacity(0), mMask(0), mWritePos(0), mReadPos(0) {}
+	~SC_PaAggregateRing() { free(mFrames); }
+
+	void Init(uint32 channels, uint32 minFrames)
+	{
+		mChannels = channels;
+		mCapacity = 1;
+		while (mCapacity < minFrames) mCapacity <<= 1;
+		mMask = mCapacity - 1;
+		free(mFrames);
+		mFrames = (float*)calloc(mCapacity * channels, sizeof(float));
+		mWritePos.store(0);
+		mReadPos.store(0);
+	}
+
+	// leave a cushion of already-readable silence; the reader stays this far
+	// behind the writer, which is the latency the aggregation adds
+	void Prime(uint32 frames)
+	{
+		mReadPos.store(0);
+		mWritePos.store(frames);
+	}
+
+	uint32 ReadAvailable() const
+	{
+		return mWritePos.load(std::memory_order_acquire) - mReadPos.load(std::memory_order_relaxed);
+	}
+
+	// producer side: non-interleaved device buffers in; excess frames are
+	// dropped when the reader has stalled
+	void Write(const float **src, uint32 numFrames)
+	{
+		uint32 w = mWritePos.load(std::memory_order_relaxed);
+		uint32 r = mReadPos.load(std::memory_order_acquire);
+		uint32 space = mCapacity - (w - r);
+		if (numFrames > space) numFrames = space;
+		for (uint32 n = 0; n < numFrames; ++n) {
+			float *frame = mFrames + ((w + n) & mMask) * mChannels;
+			for (uint32 k = 0; k < mChannels; ++k)
+				frame[k] = src[k][n];
+		}
+		mWritePos.store(w + numFrames, std::memory_order_release);
+	}
+
+	// consumer side: deinterleave into the engine's bus layout (channel-major,
+	// dstStride frames per channel), zero-padding frames the producer has not
+	// delivered yet
+	void Read(float *dst, uint32 dstStride, uint32 numFrames)
+	{
+		uint32 r = mReadPos.load(std::memory_order_relaxed);
+		uint32 have = mWritePos.load(std::memory_order_acquire) - r;
+		uint32 n = 0;
+		for (; n < numFrames && n < have; ++n) {
+			const float *frame = mFrames + ((r + n) & mMask) * mChannels;
+			for (uint32 k = 0; k < mChannels; ++k)
+				dst[k * dstStride + n] = frame[k];
+		}
+		for (; n < numFrames; ++n) {
+			for (uint32 k = 0; k < mChannels; ++k)
+				dst[k * dstStride + n] = 0.f;
+		}
+		uint32 consumed = numFrames < have ? numFrames : have;
+		mReadPos.store(r + consumed, std::memory_order_release);
+	}
+
+	void AdvanceRead(uint32 numFrames)
+	{
+		mReadPos.store(mReadPos.load(std::memory_order_relaxed) + numFrames, std::memory_order_release);
+	}
+
+	bool RewindRead(uint32 numFrames)
+	{
+		uint32 r = mReadPos.load(std::memory_order_relaxed);
+		uint32 w = mWritePos.load(std::memory_order_acquire);
+		if (mCapacity - (w - r) < numFrames) return false; // already overwritten
+		mReadPos.store(r - numFrames, std::memory_order_release);
+		return true;
+	}
+};
+
 class SC_PortAudioDriver : public SC_AudioDriver
 {
 
 	int mInputChannelCount, mOutputChannelCount;
 	PaStream *mStream;
+	PaStream *mInputStream;	// non-zero when aggregating separate in/out devices
+	SC_PaAggregateRing mInputRing;
 	PaTime mPaStreamStartupTime;
 	int64 mPaStreamStartupTimeOSC;
 #ifdef SC_PA_USE_DLL
 	double mMaxOutputLatency;
 	SC_TimeDLL			mDLL;
+	SC_TimeDLL			mInputDLL;	// tracks the input device's clock in aggregate mode
+	double mDriftAccum;
 #endif
 protected:
 	// Driver interface methods
@@ -112,6 +210,7 @@ public:
 	int PortAudioCallback( const void *input, void *output,
 			unsigned long frameCount, const PaStreamCallbackTimeInfo* timeInfo,
 			PaStreamCallbackFlags statusFlags );
+	int PortAudioInputCallback( const void *input, unsigned long frameCount );
 private:
 	void GetPaDeviceFromName(const char* device, int* mInOut);
 };
@@ -128,8 +227,10 @@ SC_AudioDriver* SC_NewAudioDriver(struct World *inWorld)
 SC_PortAudioDriver::SC_PortAudioDriver(struct World *inWorld)
 		: SC_AudioDriver(inWorld)
 		, mStream(0)
+		, mInputStream(0)
 #ifdef SC_PA_USE_DLL
 		,mMaxOutputLatency(0.)
+		,mDriftAccum(0.)
 #endif
 {
 	PaError paerror = Pa_Initialize();
@@ -144,6 +245,11 @@ SC_PortAudioDriver::~SC_PortAudioDriver()
 		if( paerror != paNoError )
 			PRINT_PORTAUDIO_ERROR( Pa_CloseStream, paerror );
 	}
+	if( mInputStream ){
+		PaError paerror = Pa_CloseStream( mInputStream );
+		if( paerror != paNoError )
+			PRINT_PORTAUDIO_ERROR( Pa_CloseStream, paerror );
+	}
 	Pa_Terminate();
 }
 
@@ -155,6 +261,26 @@ static int SC_PortAudioStreamCallback( const void *input, void *output,
 
 	return driver->PortAudioCallback( input, output, frameCount, timeInfo, statusFlags );
 }
+
+static int SC_PortAudioInputStreamCallback( const void *input, void *output,
+	unsigned long frameCount, const PaStreamCallbackTimeInfo* timeInfo,
+	PaStreamCallbackFlags statusFlags, void *userData )
+{
+	SC_PortAudioDriver *driver = (SC_PortAudioDriver*)userData;
+
+	return driver->PortAudioInputCallback( input, frameCount );
+}
+
+// aggregate mode: the input device's callback only captures into the ring;
+// the engine runs in the output device's callback
+int SC_PortAudioDriver::PortAudioInputCallback( const void *input, unsigned long frameCount )
+{
+#ifdef SC_PA_USE_DLL
+	mInputDLL.Update(sc_PAOSCTimeSeconds());
+#endif
+	mInputRing.Write((const float**)input, (uint32)frameCount);
+	return paContinue;
+}
 void sc_SetDenormalFlags();
 int SC_PortAudioDriver::PortAudioCallback( const void *input, void *output,
 			unsigned long frameCount, const PaStreamCallbackTimeInfo* timeInfo,
@@ -189,8 +315,8 @@ int SC_PortAudioDriver::PortAudioCallback( const void *input, void *output,
 #endif
 
 		mFromEngine.Free();
-		mToEngine.Perform();
-		mOscPacketsToEngine.Perform();
+		mToEngine.PerformAll();
+		mOscPacketsToEngine.PerformAll();
 
 		const float **inBuffers = (const float**)input;
 		float **outBuffers = (float**)output;
@@ -215,6 +341,25 @@ int SC_PortAudioDriver::PortAudioCallback( const void *input, void *output,
 		int64 oscTime = mOSCbuftime;
 		int64 oscInc = mOSCincrement;
 		double oscToSamples = mOSCtoSamples;
+#endif
+#ifdef SC_PA_USE_DLL
+		if (mInputStream) {
+			// both device clocks are measured by their DLLs; consume the
+			// measured rate ratio so the ring neither fills nor drains as the
+			// clocks drift apart, slipping single frames instead of waiting
+			// for a whole buffer of drift to accumulate.
+			mDriftAccum += (mInputDLL.SampleRate() / mDLL.SampleRate() - 1.) * numSamples;
+			int slip = (int)mDriftAccum;
+			if (slip > 0) {
+				if (mInputRing.ReadAvailable() > (uint32)(numSamples + slip)) {
+					mInputRing.AdvanceRead(slip);
+					mDriftAccum -= slip;
+				}
+			} else if (slip < 0) {
+				if (mInputRing.RewindRead(-slip))
+					mDriftAccum -= slip;
+			}
+		}
 #endif
 		// main loop
 		for (int i = 0; i < numBufs; ++i, mWorld->mBufCounter++, bufFramePos += bufFrames)
@@ -224,12 +369,20 @@ int SC_PortAudioDriver::PortAudioCallback( const void *input, void *output,
 
 			// copy+touch inputs
 			tch = inTouched;
-			for (int k = 0; k < mInputChannelCount; ++k)
-			{
-				const float *src = inBuffers[k] + bufFramePos;
-				float *dst = inBuses + k * bufFrames;
-				memcpy(dst, src, bufFrames * sizeof(float));
-				*tch++ = bufCounter;
+			if (mInputStream) {
+				// inputs come from the other device through the ring; frames
+				// its callback has not delivered yet read as silence
+				mInputRing.Read(inBuses, bufFrames, bufFrames);
+				for (int k = 0; k < mInputChannelCount; ++k)
+					*tch++ = bufCounter;
+			} else {
+				for (int k = 0; k < mInputChannelCount; ++k)
+				{
+					const float *src = inBuffers[k] + bufFramePos;
+					float *dst = inBuses + k * bufFrames;
+					memcpy(dst, src, bufFrames * sizeof(float));
+					*tch++ = bufCounter;
+				}
 			}
 
 			// run engine
@@ -242,6 +395,7 @@ int SC_PortAudioDriver::PortAudioCallback( const void *input, void *output,
 				scprintf("rdy %.6f %.6f %.6f %.6f \n", (mScheduler.NextTime()-gStartupOSCTime) * kOSCtoSecs, (mOSCbuftime-gStartupOSCTime)*kOSCtoSecs, diff, (nextTime-gStartupOSCTime)*kOSCtoSecs);
 			}
 			*/
+			mScheduler.Advance(nextTime); // release due wheel events for draining
 			while ((schedTime = mScheduler.NextTime()) <= nextTime) {
 				float diffTime = (float)(schedTime - oscTime) * oscToSamples + 0.5;
 				float diffTimeFloor = floor(diffTime);
@@ -342,6 +496,13 @@ bool SC_PortAudioDriver::DriverSetup(int* outNumSamples, double* outSampleRate)
 	mDeviceInOut[1] = paNoDevice;
 	if (mWorld->hw->mInDeviceName)
 		GetPaDeviceFromName(mWorld->hw->mInDeviceName, mDeviceInOut);
+	if (mWorld->hw->mOutDeviceName && (!mWorld->hw->mInDeviceName
+			|| strcmp(mWorld->hw->mOutDeviceName, mWorld->hw->mInDeviceName) != 0)) {
+		// a second device name selects a separate output device
+		int outDeviceInOut[2];
+		GetPaDeviceFromName(mWorld->hw->mOutDeviceName, outDeviceInOut);
+		mDeviceInOut[1] = outDeviceInOut[1];
+	}
 	if (mDeviceInOut[0] == paNoDevice) mDeviceInOut[0] = Pa_GetDefaultInputDevice();
 	if (mDeviceInOut[1] == paNoDevice) mDeviceInOut[1] = Pa_GetDefaultOutputDevice();
 
@@ -414,6 +575,29 @@ bool SC_PortAudioDriver::DriverSetup(int* outNumSamples, double* outSampleRate)
 
 		paerror = Pa_OpenStream(&mStream, inStreamParams_p, outStreamParams_p, *outSampleRate, *outNumSamples, paNoFlag, SC_PortAudioStreamCallback, this );
 
+		if( paerror != paNoError && inStreamParams_p && outStreamParams_p
+				&& inStreamParams.device != outStreamParams.device ) {
+			// host APIs like ASIO cannot open one duplex stream across two
+			// devices. aggregate instead: the output stream runs the engine
+			// and a separate input stream feeds it through a lock-free ring,
+			// with clock drift between the devices consumed by single-frame
+			// slips (see PortAudioCallback).
+			scprintf("SC_PortAudioDriver: duplex stream across devices failed, aggregating separate input and output streams\n");
+			paerror = Pa_OpenStream(&mStream, NULL, outStreamParams_p, *outSampleRate, *outNumSamples, paNoFlag, SC_PortAudioStreamCallback, this );
+			if( paerror == paNoError ) {
+				paerror = Pa_OpenStream(&mInputStream, inStreamParams_p, NULL, *outSampleRate, *outNumSamples, paNoFlag, SC_PortAudioInputStreamCallback, this );
+				if( paerror == paNoError )
+					// capacity leaves headroom for drift and scheduling
+					// jitter; the added latency is the one-callback cushion
+					// set up in DriverStart, not the ring size
+					mInputRing.Init(mInputChannelCount, 8 * *outNumSamples);
+				else {
+					Pa_CloseStream(mStream);
+					mStream = 0;
+				}
+			}
+		}
+
 		if( paerror != paNoError )
 			PRINT_PORTAUDIO_ERROR( Pa_OpenStream, paerror );
 		else {
@@ -446,7 +630,25 @@ bool SC_PortAudioDriver::DriverStart()
 	if (!mStream)
 		return false;
 
-	PaError paerror = Pa_StartStream( mStream );
+	PaError paerror;
+	if (mInputStream) {
+		// one callback of silence keeps the reader behind the writer; start
+		// the input side first so frames are flowing when the engine runs
+		mInputRing.Prime(mNumSamplesPerCallback);
+#ifdef SC_PA_USE_DLL
+		mDriftAccum = 0.;
+		mInputDLL.Reset(
+			mSampleRate,
+			mNumSamplesPerCallback,
+			SC_TIME_DLL_BW,
+			sc_PAOSCTimeSeconds());
+#endif
+		paerror = Pa_StartStream( mInputStream );
+		if( paerror != paNoError )
+			PRINT_PORTAUDIO_ERROR( Pa_StartStream, paerror );
+	}
+
+	paerror = Pa_StartStream( mStream );
 	if( paerror != paNoError )
 		PRINT_PORTAUDIO_ERROR( Pa_StartStream, paerror );
 
@@ -475,5 +677,13 @@ bool SC_PortAudioDriver::DriverStop()
 	if( paerror != paNoError )
 		PRINT_PORTAUDIO_ERROR( Pa_StopStream, paerror );
 
+	if (mInputStream) {
+		PaError inerror = Pa_StopStream(mInputStream);
+		if( inerror != paNoError ) {
+			PRINT_PORTAUDIO_ERROR( Pa_StopStream, inerror );
+			paerror = inerror;
+		}
+	}
+
 	return paerror == paNoError;
 }
@@ -39,6 +39,7 @@ void zfree(void* ptr);
 ////////////////////////////////////////////////////////////////////////
 
 void World_Run(struct World *inWorld);
+void World_ReclaimPendingNodes(struct World *inWorld);
 void World_Start(World *inWorld);
 void World_SetSampleRate(struct World *inWorld, double inSampleRate);
 
@@ -109,6 +110,7 @@ void Rate_Init(struct Rate *inRate, double inSampleRate, int inBufLength);
 int Graph_New(struct World *inWorld, struct GraphDef *def, int32 inID, struct sc_msg_iter* args, struct Graph** outGraph,bool argtype=true);
 void Graph_Ctor(struct World *inWorld, struct GraphDef *inGraphDef, struct Graph *graph, struct sc_msg_iter *msg,bool argtype);
 void Graph_Dtor(struct Graph *inGraph);
+void Graph_Reclaim(struct Graph *inGraph);
 int  Graph_GetControl(struct Graph* inGraph, uint32 inIndex, float& outValue);
 int  Graph_GetControl(struct Graph* inGraph, int32 inHash, int32 *inName, uint32 inIndex, float& outValue);
 void Graph_SetControl(struct Graph* inGraph, uint32 inIndex, float inValue);
@@ -118,14 +120,17 @@ void Graph_MapControl(Graph* inGraph, int32 inHash, int32 *inName, uint32 inInde
 void Graph_MapAudioControl(Graph* inGraph, uint32 inIndex, uint32 inBus);
 void Graph_MapAudioControl(Graph* inGraph, int32 inHash, int32 *inName, uint32 inIndex, uint32 inBus);
 void Graph_Trace(Graph *inGraph);
+int Graph_Profile(Graph *inGraph, int inFlag);
 
 ////////////////////////////////////////////////////////////////////////
 
-int Node_New(struct World *inWorld, struct NodeDef *def, int32 inID, struct Node **outNode);
+int Node_New(struct World *inWorld, struct NodeDef *def, int32 inID, struct Node **outNode, void *inMemory = 0);
 void Node_Dtor(struct Node *inNode);
+void Node_DtorDetachMemory(struct Node *inNode);
 void Node_Remove(struct Node* s);
 void Node_RemoveID(Node *inNode);
 void Node_Delete(struct Node* inNode);
+void Node_DeferDelete(struct Node* inNode);
 void Node_AddAfter(struct Node* s, struct Node *afterThisOne);
 void Node_AddBefore(struct Node* s, struct Node *beforeThisOne);
 void Node_Replace(struct Node* s, struct Node *replaceThisOne);
@@ -155,7 +160,7 @@ void Group_Calc(Group *inGroup);
 void Graph_Calc(struct Graph *inGraph);
 }
 
-int Group_New(World *inWorld, int32 inID, Group** outGroup);
+int Group_New(World *inWorld, int32 inID, Group** outGroup, bool inParallel = false);
 void Group_Dtor(Group *inGroup);
 void Group_DeleteAll(Group *inGroup);
 void Group_DeepFreeGraphs(Group *inGroup);
@@ -186,6 +191,7 @@ void Unit_Dtor(struct Unit *inUnit);
 
 extern "C" {
 void Unit_ZeroOutputs(struct Unit *inUnit, int inNumSamples);
+void Unit_InitRGen(struct Unit *inUnit, struct RGen *inRGen);
 }
 
 ////////////////////////////////////////////////////////////////////////
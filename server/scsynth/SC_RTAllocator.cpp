@@ -0,0 +1,119 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "SC_RTAllocator.h"
+#include "SC_AllocPool.h"
+
+extern "C"
+{
+#include "../../external_libraries/TLSF-2.4.6/src/tlsf.h"
+}
+
+#include <stdlib.h>
+#include <stdexcept>
+
+namespace {
+
+class SC_BinnedRTAllocator : public SC_RTAllocator
+{
+public:
+	SC_BinnedRTAllocator(size_t inPoolSize, NewAreaFunc inAreaAlloc, FreeAreaFunc inAreaFree)
+		: mPool(inAreaAlloc, inAreaFree, inPoolSize, 0)
+	{}
+
+	virtual void* Alloc(size_t inReqSize) { return mPool.Alloc(inReqSize); }
+	virtual void* Realloc(void *inPtr, size_t inReqSize) { return mPool.Realloc(inPtr, inReqSize); }
+	virtual void Free(void *inPtr) { mPool.Free(inPtr); }
+
+	virtual size_t TotalFree() { return mPool.TotalFree(); }
+	virtual size_t LargestFreeChunk() { return mPool.LargestFreeChunk(); }
+
+private:
+	AllocPool mPool;
+};
+
+class SC_TLSFRTAllocator : public SC_RTAllocator
+{
+public:
+	SC_TLSFRTAllocator(size_t inPoolSize, NewAreaFunc inAreaAlloc, FreeAreaFunc inAreaFree)
+		: mFreeArea(inAreaFree)
+	{
+		mArea = (*inAreaAlloc)(inPoolSize);
+		if (!mArea)
+			throw std::runtime_error(std::string("Could not allocate new area"));
+		mUsableSize = init_memory_pool(inPoolSize, mArea);
+	}
+
+	virtual ~SC_TLSFRTAllocator()
+	{
+		destroy_memory_pool(mArea);
+		(*mFreeArea)(mArea);
+	}
+
+	virtual void* Alloc(size_t inReqSize)
+	{
+		void *ptr = malloc_ex(inReqSize, mArea);
+		if (!ptr)
+			throw std::runtime_error(std::string("alloc failed, increase server's memory allocation (e.g. via ServerOptions)"));
+		return ptr;
+	}
+
+	virtual void* Realloc(void *inPtr, size_t inReqSize)
+	{
+		void *ptr = realloc_ex(inPtr, inReqSize, mArea);
+		if (!ptr && inReqSize)
+			throw std::runtime_error(std::string("realloc failed, increase server's memory allocation (e.g. via ServerOptions)"));
+		return ptr;
+	}
+
+	virtual void Free(void *inPtr)
+	{
+		if (inPtr) free_ex(inPtr, mArea);
+	}
+
+	virtual size_t TotalFree()
+	{
+		return mUsableSize - get_used_size(mArea);
+	}
+
+	virtual size_t LargestFreeChunk()
+	{
+		// TLSF does not track the largest free block; report the total so
+		// /status.reply stays meaningful.
+		return TotalFree();
+	}
+
+private:
+	void *mArea;
+	size_t mUsableSize;
+	FreeAreaFunc mFreeArea;
+};
+
+} // namespace
+
+SC_RTAllocator* SC_NewRTAllocator(bool inUseTLSF, size_t inPoolSize,
+		void* (*inAreaAlloc)(size_t), void (*inAreaFree)(void*))
+{
+	if (!inAreaAlloc) inAreaAlloc = malloc;
+	if (!inAreaFree) inAreaFree = free;
+	if (inUseTLSF)
+		return new SC_TLSFRTAllocator(inPoolSize, inAreaAlloc, inAreaFree);
+	return new SC_BinnedRTAllocator(inPoolSize, inAreaAlloc, inAreaFree);
+}
@@ -0,0 +1,51 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#ifndef _SC_RTAllocator_
+#define _SC_RTAllocator_
+
+#include <stddef.h>
+
+/*	The pool behind World_Alloc. Two implementations exist: the classic
+	binned free list pool (SC_AllocPool), whose worst case degrades under
+	fragmentation, and a TLSF pool (external_libraries/TLSF-2.4.6) with
+	O(1) bounded alloc/free, selectable with WorldOptions::mTLSFMemory
+	(scsynth -A tlsf). Alloc and Realloc throw std::runtime_error when the
+	pool is exhausted, like AllocPool always did. */
+class SC_RTAllocator
+{
+public:
+	virtual ~SC_RTAllocator() {}
+
+	virtual void* Alloc(size_t inReqSize) = 0;
+	virtual void* Realloc(void *inPtr, size_t inReqSize) = 0;
+	virtual void Free(void *inPtr) = 0;
+
+	virtual size_t TotalFree() = 0;
+	virtual size_t LargestFreeChunk() = 0;
+};
+
+/*	The optional area hooks allocate and release the pool's backing memory
+	(used for hugepage/mlock-backed pools, WorldOptions::mHugePages); when
+	absent the pool sits in plain malloc memory. */
+SC_RTAllocator* SC_NewRTAllocator(bool inUseTLSF, size_t inPoolSize,
+		void* (*inAreaAlloc)(size_t) = 0, void (*inAreaFree)(void*) = 0);
+
+#endif
@@ -0,0 +1,271 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "SC_RecordTap.h"
+#include "SC_World.h"
+#include "SC_BoundsMacros.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef NO_LIBSNDFILE
+	#ifdef _WIN32
+		#include <sndfile-win.h>
+	#else
+		#include <sndfile.h>
+	#endif
+#endif
+
+int scprintf(const char *fmt, ...);
+
+SC_RecordTap::SC_RecordTap()
+	: mNumEntries(0), mNumChannels(0), mBufLength(0), mSampleRate(0.),
+	  mPath(0), mFileIndex(0), mFramesPerFile(0), mFileFrames(0), mFile(0),
+	  mRing(0), mRingFrames(0), mWritePos(0), mReadPos(0), mDropped(0),
+	  mRunning(false)
+{
+}
+
+SC_RecordTap::~SC_RecordTap()
+{
+#ifndef NO_LIBSNDFILE
+	if (mFile) sf_close(mFile);	// only still open if the tap was never installed
+#endif
+	free(mPath);
+	free(mRing);
+}
+
+static int64 NextPowerOfTwo(int64 x)
+{
+	int64 n = 1;
+	while (n < x) n <<= 1;
+	return n;
+}
+
+bool SC_RecordTap::Setup(struct World *inWorld, const char *inPath, int inRingFrames,
+	int inFramesPerFile, const SC_RecordTapEntry *inEntries, int inNumEntries)
+{
+#ifdef NO_LIBSNDFILE
+	scprintf("/rtap_start: scsynth was built without libsndfile.\n");
+	return false;
+#else
+	if (inNumEntries < 1 || inNumEntries > kRecordTapMaxEntries) {
+		scprintf("/rtap_start: bad number of tap entries (%d).\n", inNumEntries);
+		return false;
+	}
+
+	mNumChannels = 0;
+	for (int i = 0; i < inNumEntries; ++i) {
+		int32 bus = inEntries[i].mBus;
+		int32 nchan = inEntries[i].mNumChannels;
+		if (nchan < 1 || bus < 0 || uint32(bus + nchan) > inWorld->mNumAudioBusChannels) {
+			scprintf("/rtap_start: tap %d (bus %d, %d channels) out of range.\n", i, bus, nchan);
+			return false;
+		}
+		mEntries[i] = inEntries[i];
+		mNumChannels += nchan;
+	}
+	mNumEntries = inNumEntries;
+	mBufLength = inWorld->mBufLength;
+	mSampleRate = inWorld->mFullRate.mSampleRate;
+
+	mPath = strdup(inPath);
+	mFramesPerFile = inFramesPerFile > 0 ? inFramesPerFile : 0;
+
+	mRingFrames = NextPowerOfTwo(sc_max((int64)inRingFrames, (int64)mBufLength * 4));
+	mRing = (float*)malloc(mRingFrames * mNumChannels * sizeof(float));
+	if (!mRing) {
+		scprintf("/rtap_start: could not allocate a %lld frame ring.\n", (long long)mRingFrames);
+		return false;
+	}
+
+	return OpenNextFile();
+#endif
+}
+
+bool SC_RecordTap::OpenNextFile()
+{
+#ifdef NO_LIBSNDFILE
+	return false;
+#else
+	char filename[1024];
+	const char *dot = strrchr(mPath, '.');
+
+	if (mFramesPerFile == 0)
+		snprintf(filename, sizeof(filename), "%s", mPath);
+	else if (dot && dot != mPath)
+		snprintf(filename, sizeof(filename), "%.*s_%03d%s", (int)(dot - mPath), mPath, mFileIndex, dot);
+	else
+		snprintf(filename, sizeof(filename), "%s_%03d", mPath, mFileIndex);
+
+	// header type follows the extension; samples are always 32 bit float.
+	// wav tops out at 4 GB, which is what the rotation limit is for.
+	int format = SF_FORMAT_WAV;
+	if (dot) {
+		if (strcmp(dot, ".aiff") == 0 || strcmp(dot, ".aif") == 0) format = SF_FORMAT_AIFF;
+		else if (strcmp(dot, ".caf") == 0) format = SF_FORMAT_CAF;
+		else if (strcmp(dot, ".w64") == 0) format = SF_FORMAT_W64;
+	}
+
+	SF_INFO info;
+	memset(&info, 0, sizeof(info));
+	info.samplerate = (int)(mSampleRate + 0.5);
+	info.channels = mNumChannels;
+	info.format = format | SF_FORMAT_FLOAT;
+
+	mFile = sf_open(filename, SFM_WRITE, &info);
+	if (!mFile) {
+		scprintf("/rtap_start: could not open '%s' (%s).\n", filename, sf_strerror(0));
+		return false;
+	}
+	mFileFrames = 0;
+	return true;
+#endif
+}
+
+void SC_RecordTap::StartWriter()
+{
+	mRunning = true;
+	mThread = SC_Thread([this]() { WriteLoop(); });
+}
+
+void SC_RecordTap::Capture(struct World *inWorld)
+{
+	int bufLength = mBufLength;
+	int64 writePos = mWritePos.load(std::memory_order_relaxed);
+	int64 readPos = mReadPos.load(std::memory_order_acquire);
+
+	if (writePos - readPos + bufLength > mRingFrames) {
+		// never wait for the disk on the real time thread
+		mDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	int32 bufCounter = inWorld->mBufCounter;
+	int64 mask = mRingFrames - 1;
+	int numChannels = mNumChannels;
+	int outChan = 0;
+
+	for (int e = 0; e < mNumEntries; ++e) {
+		int32 bus = mEntries[e].mBus;
+		for (int32 j = 0; j < mEntries[e].mNumChannels; ++j, ++outChan) {
+			float *dst = mRing + outChan;
+			if (inWorld->mAudioBusTouched[bus + j] == bufCounter) {
+				const float *src = inWorld->mAudioBus + (bus + j) * bufLength;
+				for (int k = 0; k < bufLength; ++k)
+					dst[((writePos + k) & mask) * numChannels] = src[k];
+			} else {
+				for (int k = 0; k < bufLength; ++k)
+					dst[((writePos + k) & mask) * numChannels] = 0.f;
+			}
+		}
+	}
+
+	mWritePos.store(writePos + bufLength, std::memory_order_release);
+}
+
+bool SC_RecordTap::WriteFrames(const float *inFrames, int inNumFrames)
+{
+#ifdef NO_LIBSNDFILE
+	return false;
+#else
+	sf_count_t written = sf_writef_float(mFile, (float*)inFrames, inNumFrames);
+	mFileFrames += written;
+	if (written != inNumFrames) {
+		scprintf("recording tap: disk write failed (%s), capture stopped.\n", sf_strerror(mFile));
+		return false;
+	}
+	return true;
+#endif
+}
+
+void SC_RecordTap::Drain()
+{
+	int64 mask = mRingFrames - 1;
+	for (;;) {
+		int64 readPos = mReadPos.load(std::memory_order_relaxed);
+		int64 avail = mWritePos.load(std::memory_order_acquire) - readPos;
+		if (avail == 0) return;
+
+		// write a contiguous run, stopping at the ring edge and at the
+		// rotation boundary
+		int64 start = readPos & mask;
+		int64 run = sc_min(avail, mRingFrames - start);
+		if (mFramesPerFile > 0)
+			run = sc_min(run, mFramesPerFile - mFileFrames);
+
+		if (!WriteFrames(mRing + start * mNumChannels, (int)run)) {
+			// consume without writing so the real time thread keeps counting
+			// drops instead of stalling on a full ring
+			mReadPos.store(readPos + avail, std::memory_order_release);
+			return;
+		}
+		mReadPos.store(readPos + run, std::memory_order_release);
+
+		if (mFramesPerFile > 0 && mFileFrames >= mFramesPerFile) {
+#ifndef NO_LIBSNDFILE
+			sf_close(mFile);
+			mFile = 0;
+#endif
+			++mFileIndex;
+			if (!OpenNextFile()) return;
+		}
+	}
+}
+
+void SC_RecordTap::WriteLoop()
+{
+	unique_lock<SC_Lock> lock(mLock);
+	while (mRunning) {
+		lock.unlock();
+		Drain();
+		lock.lock();
+		// the real time thread never signals; poll at a rate that keeps the
+		// ring occupancy low and lets Stop() wake us immediately
+		if (mRunning)
+			mWake.wait_for(lock, std::chrono::milliseconds(5));
+	}
+}
+
+void SC_RecordTap::Stop()
+{
+	if (!mRunning) return;
+	{
+		lock_guard<SC_Lock> guard(mLock);
+		mRunning = false;
+	}
+	mWake.notify_all();
+	mThread.join();
+
+	// the tap is unhooked, so the ring can no longer grow
+	Drain();
+
+#ifndef NO_LIBSNDFILE
+	if (mFile) {
+		sf_close(mFile);
+		mFile = 0;
+	}
+#endif
+
+	int64 dropped = DroppedBlocks();
+	if (dropped)
+		scprintf("recording tap: dropped %lld blocks (ring full).\n", (long long)dropped);
+}
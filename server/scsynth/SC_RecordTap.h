@@ -0,0 +1,104 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#ifndef _SC_RecordTap_
+#define _SC_RecordTap_
+
+#include "SC_Types.h"
+#include "SC_Lock.h"
+
+#include <atomic>
+
+/*
+A recording tap (/rtap_start, /rtap_stop) captures chosen audio bus ranges
+into one large single producer / single consumer ring after each graph
+computation, and a dedicated writer thread streams the interleaved frames
+to disk with optional multi file rotation.
+
+Unlike a DiskOut synth, whose per synth fifo is sized for a few channels,
+the ring is dimensioned when the tap is started, the copy on the real time
+thread never blocks or allocates, and a disk that cannot keep up shows up
+as counted dropped blocks instead of silently lost samples.
+*/
+
+struct SC_RecordTapEntry
+{
+	int32 mBus;			// first audio bus channel
+	int32 mNumChannels;
+};
+
+const int kRecordTapMaxEntries = 64;
+
+class SC_RecordTap
+{
+public:
+	SC_RecordTap();
+	~SC_RecordTap();
+
+	// non real time: validate the tap list, allocate the ring and open the
+	// first file. inRingFrames is rounded up to a power of two;
+	// inFramesPerFile <= 0 disables rotation.
+	bool Setup(struct World *inWorld, const char *inPath, int inRingFrames,
+		int inFramesPerFile, const SC_RecordTapEntry *inEntries, int inNumEntries);
+
+	// non real time: spawn the writer thread. separate from Setup so a tap
+	// that failed to install on the real time thread is never started.
+	void StartWriter();
+
+	// real time thread, once per block after the graph has run
+	void Capture(struct World *inWorld);
+
+	// non real time: stop the writer, drain the ring, close the file. the
+	// tap must already be unhooked from the real time thread.
+	void Stop();
+
+	int64 DroppedBlocks() const { return mDropped.load(std::memory_order_relaxed); }
+
+private:
+	void WriteLoop();
+	bool OpenNextFile();
+	bool WriteFrames(const float *inFrames, int inNumFrames);
+	void Drain();
+
+	SC_RecordTapEntry mEntries[kRecordTapMaxEntries];
+	int mNumEntries;
+	int mNumChannels;		// sum over the entries
+	int mBufLength;
+	double mSampleRate;
+
+	char *mPath;			// base path; the rotation index goes before the extension
+	int mFileIndex;
+	int64 mFramesPerFile;	// 0: single file, no rotation
+	int64 mFileFrames;		// frames written into the current file
+	struct SNDFILE_tag *mFile;
+
+	float *mRing;			// mRingFrames * mNumChannels interleaved floats
+	int64 mRingFrames;		// power of two
+	std::atomic<int64> mWritePos;	// frames produced; only the real time thread stores
+	std::atomic<int64> mReadPos;	// frames consumed; only the writer thread stores
+	std::atomic<int64> mDropped;	// blocks skipped because the ring was full
+
+	bool mRunning;
+	SC_Lock mLock;			// guards the shutdown wakeup only; the ring needs no lock
+	condition_variable_any mWake;
+	SC_Thread mThread;
+};
+
+#endif
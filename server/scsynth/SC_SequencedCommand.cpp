@@ -20,15 +20,23 @@
 
 
 #include "SC_SequencedCommand.h"
+#include "SC_CmdWorkerPool.h"
 #include "SC_CoreAudio.h"
 #include "SC_Errors.h"
 #include "scsynthsend.h"
 #include "SC_Prototypes.h"
 #include "SC_HiddenWorld.h"
+#include "SC_NodeTreeMirror.h"
+#include "SC_SharedBufCache.h"
 #include "SC_DirUtils.h"
 #include "SC_StringParser.h"
 #include "../../common/SC_SndFileHelpers.hpp"
+#include "../../common/SC_SampleRateConverter.hpp"
 #include "SC_WorldOptions.h"
+#include "clz.h"
+#include "server_shm.hpp"
+#include "SC_AnalysisData.h"
+#include "SC_RecordTap.h"
 
 #define GET_COMPLETION_MSG(msg) \
 	mMsgSize = msg.getbsize(); \
@@ -65,6 +73,25 @@ void SndBuf_Init(SndBuf *buf)
 	buf->sndfile = 0;
 }
 
+inline int32 BUFMASK(int32 x)
+{
+	return (1 << (31 - CLZ(x))) - 1;
+}
+
+// set up a SndBuf over data owned by the shared buffer cache; mirrors
+// what bufAlloc computes, minus the allocation.
+static void SndBuf_InitShared(SndBuf *buf, float *data, int numChannels, int numFrames, double sampleRate)
+{
+	buf->data = data;
+	buf->channels = numChannels;
+	buf->frames   = numFrames;
+	buf->samples  = numFrames * numChannels;
+	buf->mask     = BUFMASK(buf->samples); // for delay lines
+	buf->mask1    = buf->mask - 1;	// for oscillators
+	buf->samplerate = sampleRate;
+	buf->sampledur = 1. / sampleRate;
+}
+
 char* allocAndRestrictPath(World *mWorld, const char* inPath, const char* restrictBase);
 char* allocAndRestrictPath(World *mWorld, const char* inPath, const char* restrictBase){
 	char strbuf[PATH_MAX];
@@ -109,7 +136,7 @@ char* allocAndRestrictPath(World *mWorld, const char* inPath, const char* restri
 }
 
 SC_SequencedCommand::SC_SequencedCommand(World *inWorld, ReplyAddress *inReplyAddress)
-	: mNextStage(1), mWorld(inWorld),
+	: mNextStage(1), mRepeatStage(false), mWorld(inWorld),
 	mMsgSize(0), mMsgData(0)
 {
 	if (inReplyAddress) mReplyAddress = *inReplyAddress;
@@ -151,7 +178,7 @@ void DoSequencedCommand(FifoMsg *inMsg);
 void DoSequencedCommand(FifoMsg *inMsg)
 {
 	SC_SequencedCommand *cmd = (SC_SequencedCommand*)inMsg->mData;
-	cmd->CallNextStage();
+	cmd->Dispatch();
 }
 
 void FreeSequencedCommand(FifoMsg *inMsg);
@@ -161,6 +188,17 @@ void FreeSequencedCommand(FifoMsg *inMsg)
 	cmd->Delete();
 }
 
+// trampoline for repeated non real time stages: runs on the RT thread and
+// immediately hands the command back to the NRT thread. commands that were
+// queued behind it get their turn in between.
+void BounceSequencedCommand(FifoMsg *inMsg);
+void BounceSequencedCommand(FifoMsg *inMsg)
+{
+	FifoMsg msg;
+	msg.Set(inMsg->mWorld, DoSequencedCommand, 0, inMsg->mData);
+	AudioDriver(inMsg->mWorld)->SendMsgFromEngine(msg);
+}
+
 
 void SC_SequencedCommand::CallNextStage()
 {
@@ -168,6 +206,7 @@ void SC_SequencedCommand::CallNextStage()
 	FifoMsg msg;
 
 	int isRealTime = mNextStage & 1;
+	mRepeatStage = false;
 	switch (mNextStage) {
 		case 1 :
 			sendAgain = Stage1(); // RT
@@ -182,10 +221,15 @@ void SC_SequencedCommand::CallNextStage()
 			Stage4(); 			// NRT
 			break;
 	}
-	mNextStage++;
+	// only non real time stages may ask to repeat
+	bool repeatStage = sendAgain && mRepeatStage && !isRealTime;
+	if (!repeatStage) mNextStage++;
 	SC_AudioDriver *driver = AudioDriver(mWorld);
 	if (sendAgain) {
-		msg.Set(mWorld, DoSequencedCommand, 0, (void*)this);
+		if (repeatStage)
+			msg.Set(mWorld, BounceSequencedCommand, 0, (void*)this);
+		else
+			msg.Set(mWorld, DoSequencedCommand, 0, (void*)this);
 		// send this to next time.
 		if (isRealTime) {
 			// send to NRT
@@ -205,6 +249,24 @@ void SC_SequencedCommand::CallNextStage()
 	}
 }
 
+// this is the fifo performer for both directions of the RT/NRT hop, so it
+// must run real time stages inline; only non real time stages may be handed
+// to the worker pool (which exists in real time mode only).
+void SC_SequencedCommand::Dispatch()
+{
+	SC_CmdWorkerPool *pool = mWorld->hw->mCmdWorkerPool;
+	if (pool && !(mNextStage & 1))
+		pool->Enqueue(this);
+	else
+		CallNextStage();
+}
+
+// commands not audited for concurrent execution stay in the serial domain.
+int SC_SequencedCommand::ResourceKey()
+{
+	return kSerialResource;
+}
+
 void SC_SequencedCommand::Delete()
 {
 	CallDestructor();
@@ -253,6 +315,11 @@ void SyncCmd::CallDestructor()
 	this->~SyncCmd();
 }
 
+int SyncCmd::ResourceKey()
+{
+	return kBarrierResource;
+}
+
 bool SyncCmd::Stage2()
 {
 	return true;
@@ -300,8 +367,14 @@ void BufAllocCmd::CallDestructor()
 	this->~BufAllocCmd();
 }
 
+int BufAllocCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
 bool BufAllocCmd::Stage2()
 {
+	SC_BufPeaks_Invalidate(mWorld, mBufIndex);
 	SndBuf *buf = World_GetNRTBuf(mWorld, mBufIndex);
 	mFreeData = buf->data;
 	bufAlloc(buf, mNumChannels, mNumFrames, mWorld->mFullRate.mSampleRate);
@@ -365,8 +438,14 @@ void BufGenCmd::CallDestructor()
 	this->~BufGenCmd();
 }
 
+int BufGenCmd::ResourceKey()
+{
+	return kBarrierResource;
+}
+
 bool BufGenCmd::Stage2()
 {
+	SC_BufPeaks_Invalidate(mWorld, mBufIndex);
 	SndBuf *buf = World_GetNRTBuf(mWorld, mBufIndex);
 
 	mFreeData = buf->data;
@@ -417,8 +496,14 @@ void BufFreeCmd::CallDestructor()
 	this->~BufFreeCmd();
 }
 
+int BufFreeCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
 bool BufFreeCmd::Stage2()
 {
+	SC_BufPeaks_Invalidate(mWorld, mBufIndex);
 	SndBuf *buf = World_GetNRTBuf(mWorld, mBufIndex);
 	mFreeData = buf->data;
 #ifndef NO_LIBSNDFILE
@@ -467,8 +552,14 @@ void BufZeroCmd::CallDestructor()
 	this->~BufZeroCmd();
 }
 
+int BufZeroCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
 bool BufZeroCmd::Stage2()
 {
+	SC_BufPeaks_Invalidate(mWorld, mBufIndex);
 	SndBuf *buf = World_GetNRTBuf(mWorld, mBufIndex);
 	memset(buf->data, 0, buf->samples * sizeof(float));
 	return true;
@@ -488,6 +579,271 @@ void BufZeroCmd::Stage4()
 
 ///////////////////////////////////////////////////////////////////////////
 
+// bins one level up from inNumBins
+static inline int BufPeaks_ParentBins(int inNumBins)
+{
+	return (inNumBins + kBufPeaksBranch - 1) / kBufPeaksBranch;
+}
+
+void SC_BufPeaks_Invalidate(World *inWorld, int inBufIndex)
+{
+	if (inBufIndex < 0 || inBufIndex >= (int)inWorld->mNumSndBufs) return;
+	SC_BufPeaks *peaks = inWorld->hw->mBufPeaks[inBufIndex];
+	if (!peaks) return;
+	inWorld->hw->mBufPeaks[inBufIndex] = 0;
+	free(peaks->mData);
+	free(peaks);
+}
+
+// recompute the finest-level bins [inBinLo, inBinHi) from the sample data,
+// then fold the dirty range up through the coarser levels. the rms of a
+// coarse bin averages the squares of its children, which weights the
+// (shorter) edge bins slightly high - irrelevant for display purposes.
+static void BufPeaks_Compute(SC_BufPeaks *peaks, const float *data, int inBinLo, int inBinHi)
+{
+	const int nch = peaks->mNumChannels;
+	for (int b = inBinLo; b < inBinHi; ++b) {
+		int frame = b * kBufPeaksBinSize;
+		int end = sc_min(frame + kBufPeaksBinSize, peaks->mNumFrames);
+		float *bin = peaks->mData + b * nch * 3;
+		for (int ch = 0; ch < nch; ++ch) {
+			const float *samp = data + frame * nch + ch;
+			float vmin = *samp, vmax = *samp;
+			double sumsq = 0.;
+			for (int j = frame; j < end; ++j, samp += nch) {
+				float x = *samp;
+				if (x < vmin) vmin = x;
+				if (x > vmax) vmax = x;
+				sumsq += x * x;
+			}
+			bin[0] = vmin;
+			bin[1] = vmax;
+			bin[2] = (float)sqrt(sumsq / (end - frame));
+			bin += 3;
+		}
+	}
+
+	float *child = peaks->mData;
+	int childBins = peaks->mNumBins;
+	int lo = inBinLo, hi = inBinHi;
+	for (int level = 1; level < peaks->mNumLevels; ++level) {
+		int parentBins = BufPeaks_ParentBins(childBins);
+		float *parent = child + childBins * nch * 3;
+		lo = lo / kBufPeaksBranch;
+		hi = sc_min(BufPeaks_ParentBins(hi), parentBins);
+		for (int b = lo; b < hi; ++b) {
+			int cLo = b * kBufPeaksBranch;
+			int cHi = sc_min(cLo + kBufPeaksBranch, childBins);
+			float *out = parent + b * nch * 3;
+			for (int ch = 0; ch < nch; ++ch) {
+				const float *c0 = child + (cLo * nch + ch) * 3;
+				float vmin = c0[0], vmax = c0[1];
+				float sumsq = c0[2] * c0[2];
+				for (int c = cLo + 1; c < cHi; ++c) {
+					const float *cc = child + (c * nch + ch) * 3;
+					if (cc[0] < vmin) vmin = cc[0];
+					if (cc[1] > vmax) vmax = cc[1];
+					sumsq += cc[2] * cc[2];
+				}
+				out[0] = vmin;
+				out[1] = vmax;
+				out[2] = (float)sqrt(sumsq / (cHi - cLo));
+				out += 3;
+			}
+		}
+		child = parent;
+		childBins = parentBins;
+	}
+}
+
+BufPeaksCmd::BufPeaksCmd(World *inWorld, ReplyAddress *inReplyAddress)
+	: SC_SequencedCommand(inWorld, inReplyAddress)
+{
+}
+
+int BufPeaksCmd::Init(char *inData, int inSize)
+{
+	sc_msg_iter msg(inSize, inData);
+	mBufIndex = msg.geti();
+	mStart = msg.geti(0);
+	mNumFrames = msg.geti(-1);
+	return kSCErr_None;
+}
+
+void BufPeaksCmd::CallDestructor()
+{
+	this->~BufPeaksCmd();
+}
+
+int BufPeaksCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
+bool BufPeaksCmd::Stage2()
+{
+	if (mBufIndex < 0 || mBufIndex >= (int)mWorld->mNumSndBufs) {
+		SendFailureWithIntValue(&mReplyAddress, "/b_peaks", "index out of range", mBufIndex);
+		return false;
+	}
+	SndBuf *buf = World_GetNRTBuf(mWorld, mBufIndex);
+	if (!buf->data || !buf->frames) {
+		SC_BufPeaks_Invalidate(mWorld, mBufIndex);
+		SendFailureWithIntValue(&mReplyAddress, "/b_peaks", "empty buffer", mBufIndex);
+		return false;
+	}
+
+	SC_BufPeaks *peaks = mWorld->hw->mBufPeaks[mBufIndex];
+	if (peaks && (peaks->mNumFrames != buf->frames || peaks->mNumChannels != buf->channels)) {
+		// buffer shape changed since the last build: start over
+		SC_BufPeaks_Invalidate(mWorld, mBufIndex);
+		peaks = 0;
+	}
+
+	bool fresh = !peaks;
+	if (fresh) {
+		peaks = (SC_BufPeaks*)malloc(sizeof(SC_BufPeaks));
+		if (!peaks) return false;
+		peaks->mNumFrames = buf->frames;
+		peaks->mNumChannels = buf->channels;
+		peaks->mNumBins = (buf->frames + kBufPeaksBinSize - 1) / kBufPeaksBinSize;
+		int totalBins = 0;
+		int bins = peaks->mNumBins;
+		int levels = 0;
+		for (;;) {
+			totalBins += bins;
+			levels++;
+			if (bins == 1) break;
+			bins = BufPeaks_ParentBins(bins);
+		}
+		peaks->mNumLevels = levels;
+		peaks->mData = (float*)malloc(totalBins * peaks->mNumChannels * 3 * sizeof(float));
+		if (!peaks->mData) {
+			free(peaks);
+			return false;
+		}
+		mWorld->hw->mBufPeaks[mBufIndex] = peaks;
+	}
+
+	// a fresh pyramid is computed whole; otherwise only the bins the
+	// requested region dirties are refreshed
+	int binLo = 0, binHi = peaks->mNumBins;
+	if (!fresh) {
+		int start = sc_clip(mStart, 0, peaks->mNumFrames - 1);
+		int end = mNumFrames < 0 ? peaks->mNumFrames
+					: sc_min(start + mNumFrames, peaks->mNumFrames);
+		if (end <= start) {
+			SendDoneWithIntValue("/b_peaks", mBufIndex);
+			return false;
+		}
+		binLo = start / kBufPeaksBinSize;
+		binHi = (end + kBufPeaksBinSize - 1) / kBufPeaksBinSize;
+	}
+	BufPeaks_Compute(peaks, buf->data, binLo, binHi);
+
+	SendDoneWithIntValue("/b_peaks", mBufIndex);
+	return false;
+}
+
+BufGetPeaksCmd::BufGetPeaksCmd(World *inWorld, ReplyAddress *inReplyAddress)
+	: SC_SequencedCommand(inWorld, inReplyAddress)
+{
+}
+
+int BufGetPeaksCmd::Init(char *inData, int inSize)
+{
+	sc_msg_iter msg(inSize, inData);
+	mBufIndex = msg.geti();
+	mStart = msg.geti(0);
+	mNumFrames = msg.geti(-1);
+	mNumBins = msg.geti(512);
+	return kSCErr_None;
+}
+
+void BufGetPeaksCmd::CallDestructor()
+{
+	this->~BufGetPeaksCmd();
+}
+
+int BufGetPeaksCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
+bool BufGetPeaksCmd::Stage2()
+{
+	if (mBufIndex < 0 || mBufIndex >= (int)mWorld->mNumSndBufs) {
+		SendFailureWithIntValue(&mReplyAddress, "/b_getPeaks", "index out of range", mBufIndex);
+		return false;
+	}
+	SC_BufPeaks *peaks = mWorld->hw->mBufPeaks[mBufIndex];
+	if (!peaks) {
+		SendFailureWithIntValue(&mReplyAddress, "/b_getPeaks", "no peaks - send /b_peaks first", mBufIndex);
+		return false;
+	}
+
+	int nch = peaks->mNumChannels;
+	int start = sc_clip(mStart, 0, peaks->mNumFrames - 1);
+	int end = mNumFrames < 0 ? peaks->mNumFrames
+				: sc_min(start + mNumFrames, peaks->mNumFrames);
+	if (end <= start) {
+		SendFailureWithIntValue(&mReplyAddress, "/b_getPeaks", "empty region", mBufIndex);
+		return false;
+	}
+
+	// the blob has to fit in one reply packet
+	int maxBins = (int)(65000 / (nch * 3 * sizeof(float32)));
+	int wantBins = sc_min(mNumBins < 1 ? 1 : mNumBins, maxBins);
+
+	// walk up to the coarsest level that still has at least the requested
+	// resolution over the region
+	float *level = peaks->mData;
+	int levelBins = peaks->mNumBins;
+	int binSize = kBufPeaksBinSize;
+	int lo = start / binSize;
+	int hi = sc_min((end + binSize - 1) / binSize, levelBins);
+	for (int i = 1; i < peaks->mNumLevels && (hi - lo) > wantBins; ++i) {
+		level += levelBins * nch * 3;
+		levelBins = BufPeaks_ParentBins(levelBins);
+		binSize *= kBufPeaksBranch;
+		lo = start / binSize;
+		hi = sc_min((end + binSize - 1) / binSize, levelBins);
+	}
+	int numBins = hi - lo;
+
+	big_scpacket packet;
+	packet.adds("/b_peaksData");
+	packet.maketags(7);
+	packet.addtag(',');
+	packet.addtag('i');
+	packet.addtag('i');
+	packet.addtag('i');
+	packet.addtag('i');
+	packet.addtag('i');
+	packet.addtag('b');
+	packet.addi(mBufIndex);
+	packet.addi(lo * binSize);		// first frame covered
+	packet.addi(binSize);			// frames per bin
+	packet.addi(numBins);
+	packet.addi(nch);
+	const float32* src = level + lo * nch * 3;
+#if BYTE_ORDER == BIG_ENDIAN
+	packet.addb((uint8*)src, numBins * nch * 3 * sizeof(float32));
+#else
+	{
+		packet.addi(numBins * nch * 3 * sizeof(float32));
+		for (int i=0; i<numBins * nch * 3; ++i)
+			packet.addf(src[i]);
+	}
+#endif
+
+	if (packet.size())
+		SendReply(&mReplyAddress, packet.data(), packet.size());
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 BufAllocReadCmd::BufAllocReadCmd(World *inWorld, ReplyAddress *inReplyAddress)
 	: SC_SequencedCommand(inWorld, inReplyAddress), mFreeData(0), mFilename(0)
 {
@@ -526,8 +882,14 @@ void BufAllocReadCmd::CallDestructor()
 	this->~BufAllocReadCmd();
 }
 
+int BufAllocReadCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
 bool BufAllocReadCmd::Stage2()
 {
+	SC_BufPeaks_Invalidate(mWorld, mBufIndex);
 #ifdef NO_LIBSNDFILE
 	SendFailure(&mReplyAddress, "/b_allocRead", "scsynth compiled without libsndfile\n");
 	scprintf("scsynth compiled without libsndfile\n");
@@ -550,11 +912,30 @@ bool BufAllocReadCmd::Stage2()
 
 	// alloc data size
 	mFreeData = buf->data;
-	SCErr err = bufAlloc(buf, fileinfo.channels, mNumFrames, fileinfo.samplerate);
-	if (err) goto leave;
+	{
+		float *shared = 0;
+		bool needsFill = false;
+		if (mWorld->hw->mShareSndBufs)
+			shared = SharedBufCache_Acquire(mFilename, mFileOffset, mNumFrames, 0, 0,
+				mNumFrames * fileinfo.channels, &needsFill);
+		if (shared) {
+			SndBuf_InitShared(buf, shared, fileinfo.channels, mNumFrames, fileinfo.samplerate);
+			if (needsFill) {
+				// first server on the machine to want this region decodes it
+				sf_seek(sf, mFileOffset, SEEK_SET);
+				sf_readf_float(sf, buf->data, mNumFrames);
+				SharedBufCache_Publish(buf->data);
+			}
+			goto leave;
+		}
+	}
+	{
+		SCErr err = bufAlloc(buf, fileinfo.channels, mNumFrames, fileinfo.samplerate);
+		if (err) goto leave;
 
-	sf_seek(sf, mFileOffset, SEEK_SET);
-	sf_readf_float(sf, buf->data, mNumFrames);
+		sf_seek(sf, mFileOffset, SEEK_SET);
+		sf_readf_float(sf, buf->data, mNumFrames);
+	}
 
 leave:
 	mSndBuf = *buf;
@@ -582,6 +963,109 @@ void BufAllocReadCmd::Stage4()
 
 ///////////////////////////////////////////////////////////////////////////
 
+BufAllocReadResampleCmd::BufAllocReadResampleCmd(World *inWorld, ReplyAddress *inReplyAddress)
+	: BufAllocReadCmd(inWorld, inReplyAddress), mQuality(kResampleBest)
+{
+}
+
+int BufAllocReadResampleCmd::Init(char *inData, int inSize)
+{
+	sc_msg_iter msg(inSize, inData);
+	mBufIndex = msg.geti();
+
+	const char *filename = msg.gets();
+	if (!filename) return kSCErr_WrongArgType;
+
+	if(mWorld->mRestrictedPath){
+		mFilename = allocAndRestrictPath(mWorld, filename, mWorld->mRestrictedPath);
+	}else{
+		mFilename = (char*)World_Alloc(mWorld, strlen(filename)+1);
+		strcpy(mFilename, filename);
+	}
+
+	mFileOffset = msg.geti();
+	mNumFrames = msg.geti();
+	mQuality = msg.geti(kResampleBest);
+
+	GET_COMPLETION_MSG(msg);
+
+	return kSCErr_None;
+}
+
+void BufAllocReadResampleCmd::CallDestructor()
+{
+	this->~BufAllocReadResampleCmd();
+}
+
+bool BufAllocReadResampleCmd::Stage2()
+{
+	SC_BufPeaks_Invalidate(mWorld, mBufIndex);
+#ifdef NO_LIBSNDFILE
+	SendFailure(&mReplyAddress, "/b_allocReadResample", "scsynth compiled without libsndfile\n");
+	scprintf("scsynth compiled without libsndfile\n");
+	return false;
+#else
+	SndBuf *buf = World_GetNRTBuf(mWorld, mBufIndex);
+	SF_INFO fileinfo;
+	memset(&fileinfo, 0, sizeof(fileinfo));
+	SNDFILE* sf = sf_open(mFilename, SFM_READ, &fileinfo);
+	if (!sf) {
+		char str[512];
+		sprintf(str, "File '%s' could not be opened: %s\n", mFilename, sf_strerror(NULL));
+		SendFailureWithIntValue(&mReplyAddress, "/b_allocReadResample", str, mBufIndex);
+		scprintf(str);
+		return false;
+	}
+	if (mFileOffset < 0) mFileOffset = 0;
+	else if (mFileOffset > fileinfo.frames) mFileOffset = fileinfo.frames;
+	if (mNumFrames <= 0 || mNumFrames + mFileOffset > fileinfo.frames) mNumFrames = fileinfo.frames - mFileOffset;
+
+	// note: the shared buffer cache is keyed by file region at the file's
+	// own rate; servers running at different rates must not share the
+	// converted data, so this command always decodes privately.
+	mFreeData = buf->data;
+	{
+		double serverRate = mWorld->mFullRate.mSampleRate;
+		if ((double)fileinfo.samplerate == serverRate) {
+			// already at the server rate: behave exactly like /b_allocRead
+			SCErr err = bufAlloc(buf, fileinfo.channels, mNumFrames, fileinfo.samplerate);
+			if (err) goto leave;
+			sf_seek(sf, mFileOffset, SEEK_SET);
+			sf_readf_float(sf, buf->data, mNumFrames);
+		} else {
+			long outFrames = SC_ResampledFrames(mNumFrames, fileinfo.samplerate, serverRate);
+			if (outFrames < 1) outFrames = 1;
+			float *raw = (float*)malloc((size_t)mNumFrames * fileinfo.channels * sizeof(float));
+			if (!raw) goto leave;
+			sf_seek(sf, mFileOffset, SEEK_SET);
+			sf_readf_float(sf, raw, mNumFrames);
+			SCErr err = bufAlloc(buf, fileinfo.channels, outFrames, serverRate);
+			if (err) {
+				free(raw);
+				goto leave;
+			}
+			SC_ResampleBuffer(raw, mNumFrames, fileinfo.channels, fileinfo.samplerate,
+				buf->data, outFrames, serverRate, mQuality);
+			free(raw);
+		}
+	}
+
+leave:
+	mSndBuf = *buf;
+	sf_close(sf);
+
+	return true;
+#endif
+}
+
+void BufAllocReadResampleCmd::Stage4()
+{
+	zfree(mFreeData);
+	SendDoneWithIntValue("/b_allocReadResample", mBufIndex);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 BufReadCmd::BufReadCmd(World *inWorld, ReplyAddress *inReplyAddress)
 	: SC_SequencedCommand(inWorld, inReplyAddress),
 	mFilename(0)
@@ -623,8 +1107,14 @@ void BufReadCmd::CallDestructor()
 	this->~BufReadCmd();
 }
 
+int BufReadCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
 bool BufReadCmd::Stage2()
 {
+	SC_BufPeaks_Invalidate(mWorld, mBufIndex);
 #ifdef NO_LIBSNDFILE
 	SendFailure(&mReplyAddress, "/b_read", "scsynth compiled without libsndfile\n");
 	scprintf("scsynth compiled without libsndfile\n");
@@ -789,8 +1279,14 @@ void BufAllocReadChannelCmd::CallDestructor()
 	this->~BufAllocReadChannelCmd();
 }
 
+int BufAllocReadChannelCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
 bool BufAllocReadChannelCmd::Stage2()
 {
+	SC_BufPeaks_Invalidate(mWorld, mBufIndex);
 #ifdef NO_LIBSNDFILE
 	SendFailure(&mReplyAddress, "/b_allocReadChannel", "scsynth compiled without libsndfile\n");
 	scprintf("scsynth compiled without libsndfile\n");
@@ -815,6 +1311,20 @@ bool BufAllocReadChannelCmd::Stage2()
 	if (mNumChannels == 0) {
 		// alloc data size
 		mFreeData = buf->data;
+		float *shared = 0;
+		bool needsFill = false;
+		if (mWorld->hw->mShareSndBufs)
+			shared = SharedBufCache_Acquire(mFilename, mFileOffset, mNumFrames, 0, 0,
+				mNumFrames * fileinfo.channels, &needsFill);
+		if (shared) {
+			SndBuf_InitShared(buf, shared, fileinfo.channels, mNumFrames, fileinfo.samplerate);
+			if (needsFill) {
+				sf_seek(sf, mFileOffset, SEEK_SET);
+				sf_readf_float(sf, buf->data, mNumFrames);
+				SharedBufCache_Publish(buf->data);
+			}
+			goto leave;
+		}
 		SCErr err = bufAlloc(buf, fileinfo.channels, mNumFrames, fileinfo.samplerate);
 		if (err) goto leave;
 		// read all channels
@@ -831,17 +1341,30 @@ bool BufAllocReadChannelCmd::Stage2()
 		}
 		// alloc data size
 		mFreeData = buf->data;
-		SCErr err = bufAlloc(buf, mNumChannels, mNumFrames, fileinfo.samplerate);
-		if (err) goto leave;
-		// alloc temp buffer
-		float* data = (float*)malloc(mNumFrames*fileinfo.channels*sizeof(float));
-		if (data == 0) goto leave;
-		// read some channels
-		sf_seek(sf, mFileOffset, SEEK_SET);
-		sf_readf_float(sf, data, mNumFrames);
-		CopyChannels(buf->data, data, fileinfo.channels, mNumFrames);
-		// free temp buffer
-		free(data);
+		float *shared = 0;
+		bool needsFill = false;
+		if (mWorld->hw->mShareSndBufs)
+			shared = SharedBufCache_Acquire(mFilename, mFileOffset, mNumFrames,
+				mChannels, mNumChannels, mNumFrames * mNumChannels, &needsFill);
+		if (shared) {
+			SndBuf_InitShared(buf, shared, mNumChannels, mNumFrames, fileinfo.samplerate);
+			if (!needsFill) goto leave;
+		} else {
+			SCErr err = bufAlloc(buf, mNumChannels, mNumFrames, fileinfo.samplerate);
+			if (err) goto leave;
+		}
+		{
+			// alloc temp buffer
+			float* data = (float*)malloc(mNumFrames*fileinfo.channels*sizeof(float));
+			if (data == 0) goto leave;
+			// read some channels
+			sf_seek(sf, mFileOffset, SEEK_SET);
+			sf_readf_float(sf, data, mNumFrames);
+			CopyChannels(buf->data, data, fileinfo.channels, mNumFrames);
+			// free temp buffer
+			free(data);
+			if (shared) SharedBufCache_Publish(buf->data);
+		}
 	}
 
 leave:
@@ -913,8 +1436,14 @@ void BufReadChannelCmd::CallDestructor()
 	this->~BufReadChannelCmd();
 }
 
+int BufReadChannelCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
 bool BufReadChannelCmd::Stage2()
 {
+	SC_BufPeaks_Invalidate(mWorld, mBufIndex);
 #ifdef NO_LIBSNDFILE
 	SendFailure(&mReplyAddress, "/b_readChannel", "scsynth compiled without libsndfile\n");
 	scprintf("scsynth compiled without libsndfile\n");
@@ -1015,8 +1544,12 @@ void BufReadChannelCmd::Stage4()
 ///////////////////////////////////////////////////////////////////////////
 
 BufWriteCmd::BufWriteCmd(World *inWorld, ReplyAddress *inReplyAddress)
-	: SC_SequencedCommand(inWorld, inReplyAddress), mFilename(0)
+	: SC_SequencedCommand(inWorld, inReplyAddress), mFilename(0), mFramesWritten(0),
+	mBufData(0), mBufChannels(0)
 {
+#ifndef NO_LIBSNDFILE
+	mSndFile = 0;
+#endif
 }
 
 #ifdef NO_LIBSNDFILE
@@ -1059,6 +1592,9 @@ int BufWriteCmd::Init(char *inData, int inSize)
 
 BufWriteCmd::~BufWriteCmd()
 {
+#ifndef NO_LIBSNDFILE
+	if (mSndFile) sf_close(mSndFile);
+#endif
 	World_Free(mWorld, mFilename);
 }
 
@@ -1067,45 +1603,95 @@ void BufWriteCmd::CallDestructor()
 	this->~BufWriteCmd();
 }
 
+int BufWriteCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
+// frames encoded and written per Stage2 round in real time mode. writing in
+// rounds keeps the NRT command queue responsive: a long write (e.g. a large
+// multichannel buffer to FLAC) no longer stalls every other async command
+// until it finishes.
+const int kBufWriteChunkFrames = 65536;
+
 bool BufWriteCmd::Stage2()
 {
 #ifdef NO_LIBSNDFILE
 	return false;
 #else
 	SndBuf *buf = World_GetNRTBuf(mWorld, mBufIndex);
-	int framesToEnd = buf->frames - mBufOffset;
-	if (framesToEnd < 0) framesToEnd = 0;
-	mFileInfo.samplerate = (int)buf->samplerate;
-	mFileInfo.channels = buf->channels;
 
-	SNDFILE* sf = sf_open(mFilename, SFM_WRITE, &mFileInfo);
-	if (!sf) {
-		char str[512];
-		sprintf(str, "File '%s' could not be opened: %s\n", mFilename, sf_strerror(NULL));
-		SendFailureWithIntValue(&mReplyAddress, "/b_write", str, mBufIndex); //SendFailure(&mReplyAddress, "/b_write", str);
-		scprintf(str);
-		return false;
-	}
+	if (!mSndFile) {
+		// first round: open the file and clamp the frame count
+		int framesToEnd = buf->frames - mBufOffset;
+		if (framesToEnd < 0) framesToEnd = 0;
+		mFileInfo.samplerate = (int)buf->samplerate;
+		mFileInfo.channels = buf->channels;
+
+		SNDFILE* sf = sf_open(mFilename, SFM_WRITE, &mFileInfo);
+		if (!sf) {
+			char str[512];
+			sprintf(str, "File '%s' could not be opened: %s\n", mFilename, sf_strerror(NULL));
+			SendFailureWithIntValue(&mReplyAddress, "/b_write", str, mBufIndex); //SendFailure(&mReplyAddress, "/b_write", str);
+			scprintf(str);
+			return false;
+		}
 
-	if (mNumFrames < 0 || mNumFrames > buf->frames) mNumFrames = buf->frames;
+		if (mNumFrames < 0 || mNumFrames > buf->frames) mNumFrames = buf->frames;
 
-	if (mNumFrames > framesToEnd) mNumFrames = framesToEnd;
+		if (mNumFrames > framesToEnd) mNumFrames = framesToEnd;
 
-	sf_command(sf, SFC_SET_CLIPPING, NULL, SF_TRUE); // choose clipping rather than wraparound for integer-format files
+		sf_command(sf, SFC_SET_CLIPPING, NULL, SF_TRUE); // choose clipping rather than wraparound for integer-format files
 
-	if (mNumFrames > 0) {
-		sf_writef_float(sf, buf->data + (mBufOffset * buf->channels), mNumFrames);
+		mSndFile = sf;
+		mFramesWritten = 0;
+		mBufData = buf->data;
+		mBufChannels = buf->channels;
+	} else if (buf->data != mBufData || buf->channels != mBufChannels) {
+		// the buffer was freed or reallocated by a command that ran between
+		// two rounds; abandon the file rather than read freed memory
+		sf_close(mSndFile);
+		mSndFile = 0;
+		SendFailureWithIntValue(&mReplyAddress, "/b_write", "buffer changed while writing\n", mBufIndex);
+		scprintf("/b_write: buffer %d changed while writing '%s'\n", mBufIndex, mFilename);
+		return false;
+	}
+
+	int framesLeft = mNumFrames - mFramesWritten;
+	if (framesLeft > 0) {
+		// in non real time mode there is no command queue to keep responsive
+		int chunk = mWorld->mRealTime ? sc_min(framesLeft, kBufWriteChunkFrames) : framesLeft;
+		sf_writef_float(mSndFile, mBufData + ((mBufOffset + mFramesWritten) * mBufChannels), chunk);
+		mFramesWritten += chunk;
+
+		if (mFramesWritten < mNumFrames) {
+			small_scpacket packet;
+			packet.adds("/b_writeProgress");
+			packet.maketags(4);
+			packet.addtag(',');
+			packet.addtag('i');
+			packet.addtag('i');
+			packet.addtag('i');
+			packet.addi(mBufIndex);
+			packet.addi(mFramesWritten);
+			packet.addi(mNumFrames);
+			SendReply(&mReplyAddress, packet.data(), packet.size());
+
+			mRepeatStage = true;
+			return true;
+		}
 	}
 
 	if(buf->sndfile)
 		sf_close(buf->sndfile);
 
 	if (mLeaveFileOpen) {
-		buf->sndfile = sf;
+		buf->sndfile = mSndFile;
 	} else {
-		sf_close(sf);
+		sf_close(mSndFile);
 		buf->sndfile = 0;
 	}
+	mSndFile = 0;
 
 	return true;
 #endif
@@ -1144,6 +1730,11 @@ void BufCloseCmd::CallDestructor()
 	this->~BufCloseCmd();
 }
 
+int BufCloseCmd::ResourceKey()
+{
+	return mBufIndex;
+}
+
 bool BufCloseCmd::Stage2()
 {
 #ifdef NO_LIBSNDFILE
@@ -1183,6 +1774,11 @@ void AudioQuitCmd::CallDestructor()
 	this->~AudioQuitCmd();
 }
 
+int AudioQuitCmd::ResourceKey()
+{
+	return kBarrierResource;
+}
+
 bool AudioQuitCmd::Stage2()
 {
 	mWorld->hw->mTerminating = true;
@@ -1228,7 +1824,7 @@ bool AudioStatusCmd::Stage2()
 
 	small_scpacket packet;
 	packet.adds("/status.reply");
-	packet.maketags(10);
+	packet.maketags(12);
 	packet.addtag(',');
 	packet.addtag('i');
 	packet.addtag('i');
@@ -1239,6 +1835,8 @@ bool AudioStatusCmd::Stage2()
 	packet.addtag('f');
 	packet.addtag('d');
 	packet.addtag('d');
+	packet.addtag('i');
+	packet.addtag('i');
 
 	packet.addi(1); // audio is always active now.
 	packet.addi(mWorld->mNumUnits);
@@ -1252,6 +1850,11 @@ bool AudioStatusCmd::Stage2()
 	packet.addd(driver->GetSampleRate());
 	packet.addd(driver->GetActualSampleRate());
 
+	// trailing fields so older clients that index the first nine keep working:
+	// triggers and node replies dropped because their fifo was full
+	packet.addi(mWorld->hw->mDroppedTriggers.load(std::memory_order_relaxed));
+	packet.addi(mWorld->hw->mDroppedNodeMsgs.load(std::memory_order_relaxed));
+
 	SendReply(&mReplyAddress, packet.data(), packet.size());
 
 	return false;
@@ -1409,6 +2012,344 @@ void RecvSynthDefCmd::Stage4()
 
 ///////////////////////////////////////////////////////////////////////////
 
+RecvSynthDefShmCmd::RecvSynthDefShmCmd(World *inWorld, ReplyAddress *inReplyAddress)
+	: SC_SequencedCommand(inWorld, inReplyAddress)
+{
+}
+
+int RecvSynthDefShmCmd::Init(char *inData, int inSize)
+{
+	sc_msg_iter msg(inSize, inData);
+
+	mSlotIndex = msg.geti();
+
+	GET_COMPLETION_MSG(msg);
+
+	mDefs = 0;
+	return kSCErr_None;
+}
+
+void RecvSynthDefShmCmd::CallDestructor()
+{
+	this->~RecvSynthDefShmCmd();
+}
+
+bool RecvSynthDefShmCmd::Stage2()
+{
+	server_shared_memory_creator *shmem = mWorld->hw->mShmem;
+	if (!shmem) {
+		SendFailure(&mReplyAddress, "/d_recvSHM", "no shared memory segment\n");
+		return false;
+	}
+
+	def_transfer_slot *slot = shmem->get_def_slot(mSlotIndex);
+	if (!slot || slot->state != def_transfer_slot::slot_filled) {
+		SendFailure(&mReplyAddress, "/d_recvSHM", "empty synthdef transfer slot\n");
+		return false;
+	}
+
+	// parse directly from the mapping; GraphDef_Recv copies everything it
+	// keeps, so the slot can go back to the client right away.
+	mDefs = GraphDef_Recv(mWorld, slot->data, mDefs);
+	slot->state = def_transfer_slot::slot_free;
+
+	return true;
+}
+
+bool RecvSynthDefShmCmd::Stage3()
+{
+	GraphDef_Define(mWorld, mDefs);
+	SEND_COMPLETION_MSG;
+	return true;
+}
+
+void RecvSynthDefShmCmd::Stage4()
+{
+	SendDone("/d_recvSHM");
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+AnalysisDataLoadCmd::AnalysisDataLoadCmd(World *inWorld, ReplyAddress *inReplyAddress)
+	: SC_SequencedCommand(inWorld, inReplyAddress), mName(0), mFilename(0),
+	  mSegment(0), mReplaced(0)
+{
+}
+
+int AnalysisDataLoadCmd::Init(char *inData, int inSize)
+{
+	sc_msg_iter msg(inSize, inData);
+
+	const char *name = msg.gets();
+	if (!name) return kSCErr_WrongArgType;
+	if (strlen(name) >= kAnalysisDataNameLen) return kSCErr_Failed;
+
+	const char *filename = msg.gets();
+	if (!filename) return kSCErr_WrongArgType;
+
+	mName = (char*)World_Alloc(mWorld, strlen(name)+1);
+	strcpy(mName, name);
+
+	if(mWorld->mRestrictedPath){
+		mFilename = allocAndRestrictPath(mWorld, filename, mWorld->mRestrictedPath);
+	}else{
+		mFilename = (char*)World_Alloc(mWorld, strlen(filename)+1);
+		strcpy(mFilename, filename);
+	}
+
+	GET_COMPLETION_MSG(msg);
+
+	return kSCErr_None;
+}
+
+AnalysisDataLoadCmd::~AnalysisDataLoadCmd()
+{
+	AnalysisData_Unmap(mSegment);	// only set if the sequence aborted early
+	World_Free(mWorld, mName);
+	World_Free(mWorld, mFilename);
+}
+
+void AnalysisDataLoadCmd::CallDestructor()
+{
+	this->~AnalysisDataLoadCmd();
+}
+
+bool AnalysisDataLoadCmd::Stage2()
+{
+	mSegment = AnalysisData_Load(mFilename);
+	if (!mSegment) {
+		SendFailure(&mReplyAddress, "/ad_load", "could not load analysis data file\n");
+		return false;
+	}
+	strcpy(mSegment->mName, mName);
+	return true;
+}
+
+bool AnalysisDataLoadCmd::Stage3()
+{
+	// unlink any previous segment of the same name; it is unmapped in Stage4
+	// so units already pointing into it keep valid memory until after this
+	// cycle. (a unit holding entry pointers across an /ad_load replacing its
+	// segment is a client-side sequencing error, as with buffer reallocation.)
+	SC_AnalysisSegment **prev = &mWorld->hw->mAnalysisData;
+	for (SC_AnalysisSegment *seg = *prev; seg; prev = &seg->mNext, seg = seg->mNext) {
+		if (strcmp(seg->mName, mSegment->mName) == 0) {
+			*prev = seg->mNext;
+			mReplaced = seg;
+			break;
+		}
+	}
+	mSegment->mNext = mWorld->hw->mAnalysisData;
+	mWorld->hw->mAnalysisData = mSegment;
+	mSegment = 0;	// now owned by the world
+	SEND_COMPLETION_MSG;
+	return true;
+}
+
+void AnalysisDataLoadCmd::Stage4()
+{
+	AnalysisData_Unmap(mReplaced);
+	mReplaced = 0;
+	SendDone("/ad_load");
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+AnalysisDataFreeCmd::AnalysisDataFreeCmd(World *inWorld, ReplyAddress *inReplyAddress)
+	: SC_SequencedCommand(inWorld, inReplyAddress), mName(0), mSegment(0)
+{
+}
+
+int AnalysisDataFreeCmd::Init(char *inData, int inSize)
+{
+	sc_msg_iter msg(inSize, inData);
+
+	const char *name = msg.gets();
+	if (!name) return kSCErr_WrongArgType;
+
+	mName = (char*)World_Alloc(mWorld, strlen(name)+1);
+	strcpy(mName, name);
+
+	GET_COMPLETION_MSG(msg);
+
+	return kSCErr_None;
+}
+
+AnalysisDataFreeCmd::~AnalysisDataFreeCmd()
+{
+	World_Free(mWorld, mName);
+}
+
+void AnalysisDataFreeCmd::CallDestructor()
+{
+	this->~AnalysisDataFreeCmd();
+}
+
+bool AnalysisDataFreeCmd::Stage2()
+{
+	return true;
+}
+
+bool AnalysisDataFreeCmd::Stage3()
+{
+	SC_AnalysisSegment **prev = &mWorld->hw->mAnalysisData;
+	for (SC_AnalysisSegment *seg = *prev; seg; prev = &seg->mNext, seg = seg->mNext) {
+		if (strcmp(seg->mName, mName) == 0) {
+			*prev = seg->mNext;
+			mSegment = seg;
+			break;
+		}
+	}
+	SEND_COMPLETION_MSG;
+	return true;
+}
+
+void AnalysisDataFreeCmd::Stage4()
+{
+	AnalysisData_Unmap(mSegment);
+	mSegment = 0;
+	SendDone("/ad_free");
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+RecordTapStartCmd::RecordTapStartCmd(World *inWorld, ReplyAddress *inReplyAddress)
+	: SC_SequencedCommand(inWorld, inReplyAddress), mFilename(0), mRingFrames(0),
+	  mFramesPerFile(0), mEntries(0), mNumEntries(0), mTap(0), mReplaced(0),
+	  mInstalled(false)
+{
+}
+
+int RecordTapStartCmd::Init(char *inData, int inSize)
+{
+	sc_msg_iter msg(inSize, inData);
+
+	const char *filename = msg.gets();
+	if (!filename) return kSCErr_WrongArgType;
+
+	if(mWorld->mRestrictedPath){
+		mFilename = allocAndRestrictPath(mWorld, filename, mWorld->mRestrictedPath);
+	}else{
+		mFilename = (char*)World_Alloc(mWorld, strlen(filename)+1);
+		strcpy(mFilename, filename);
+	}
+
+	mRingFrames = msg.geti(262144);
+	mFramesPerFile = msg.geti(0);
+
+	SC_RecordTapEntry entries[kRecordTapMaxEntries];
+	int numEntries = 0;
+	while (msg.remain() && numEntries < kRecordTapMaxEntries) {
+		entries[numEntries].mBus = msg.geti();
+		entries[numEntries].mNumChannels = msg.geti(1);
+		++numEntries;
+	}
+	if (numEntries == 0) return kSCErr_WrongArgType;
+
+	mEntries = (SC_RecordTapEntry*)World_Alloc(mWorld, numEntries * sizeof(SC_RecordTapEntry));
+	memcpy(mEntries, entries, numEntries * sizeof(SC_RecordTapEntry));
+	mNumEntries = numEntries;
+
+	return kSCErr_None;
+}
+
+RecordTapStartCmd::~RecordTapStartCmd()
+{
+	delete mTap;	// only set if the sequence aborted before Stage3
+	World_Free(mWorld, mFilename);
+	World_Free(mWorld, mEntries);
+}
+
+void RecordTapStartCmd::CallDestructor()
+{
+	this->~RecordTapStartCmd();
+}
+
+bool RecordTapStartCmd::Stage2()
+{
+	mTap = new SC_RecordTap();
+	if (!mTap->Setup(mWorld, mFilename, mRingFrames, mFramesPerFile, mEntries, mNumEntries)) {
+		delete mTap;
+		mTap = 0;
+		SendFailure(&mReplyAddress, "/rtap_start", "could not start recording tap\n");
+		return false;
+	}
+	return true;
+}
+
+bool RecordTapStartCmd::Stage3()
+{
+	// a new tap replaces a running one; the old tap is drained in Stage4,
+	// after the real time thread can no longer touch it
+	mReplaced = mWorld->hw->mRecordTap;
+	mWorld->hw->mRecordTap = mTap;
+	mTap = 0;	// now owned by the world
+	mInstalled = true;
+	return true;
+}
+
+void RecordTapStartCmd::Stage4()
+{
+	if (mReplaced) {
+		mReplaced->Stop();
+		delete mReplaced;
+		mReplaced = 0;
+	}
+	// the writer only starts once the tap is installed; until then the ring
+	// simply buffers what the real time thread captures
+	if (mInstalled)
+		mWorld->hw->mRecordTap->StartWriter();
+	SendDone("/rtap_start");
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+RecordTapStopCmd::RecordTapStopCmd(World *inWorld, ReplyAddress *inReplyAddress)
+	: SC_SequencedCommand(inWorld, inReplyAddress), mTap(0)
+{
+}
+
+int RecordTapStopCmd::Init(char *inData, int inSize)
+{
+	sc_msg_iter msg(inSize, inData);
+	GET_COMPLETION_MSG(msg);
+	return kSCErr_None;
+}
+
+RecordTapStopCmd::~RecordTapStopCmd()
+{
+}
+
+void RecordTapStopCmd::CallDestructor()
+{
+	this->~RecordTapStopCmd();
+}
+
+bool RecordTapStopCmd::Stage2()
+{
+	return true;
+}
+
+bool RecordTapStopCmd::Stage3()
+{
+	mTap = mWorld->hw->mRecordTap;
+	mWorld->hw->mRecordTap = 0;
+	SEND_COMPLETION_MSG;
+	return true;
+}
+
+void RecordTapStopCmd::Stage4()
+{
+	if (mTap) {
+		mTap->Stop();
+		delete mTap;
+		mTap = 0;
+	}
+	SendDone("/rtap_stop");
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 LoadSynthDefCmd::LoadSynthDefCmd(World *inWorld, ReplyAddress *inReplyAddress)
 	: SC_SequencedCommand(inWorld, inReplyAddress), mFilename(0)
 {
@@ -1547,6 +2488,42 @@ bool SendReplyCmd::Stage2()
 
 ///////////////////////////////////////////////////////////////////////////
 
+QueryTreeCmd::QueryTreeCmd(World *inWorld, ReplyAddress *inReplyAddress)
+	: SC_SequencedCommand(inWorld, inReplyAddress)
+{
+}
+
+int QueryTreeCmd::Init(char *inData, int inSize)
+{
+	mMsgSize = inSize;
+	mMsgData = (char*)World_Alloc(mWorld, mMsgSize);
+	memcpy(mMsgData, inData, inSize);
+	return kSCErr_None;
+}
+
+void QueryTreeCmd::CallDestructor()
+{
+	this->~QueryTreeCmd();
+}
+
+bool QueryTreeCmd::Stage2()
+{
+	NodeTreeMirror *mirror = mWorld->hw->mNodeTreeMirror;
+	const int32 *groupIDs = (const int32*)mMsgData;
+	int numGroups = mMsgSize / sizeof(int32);
+	for (int i=0; i<numGroups; ++i) {
+		big_scpacket packet;
+		if (mirror->QueryTree(groupIDs[i], packet)) {
+			if (packet.size())
+				SendReply(&mReplyAddress, packet.data(), packet.size());
+		} else
+			SendFailure(&mReplyAddress, "/g_queryTree", "Group not found");
+	}
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 int PerformAsynchronousCommand(
 			World *inWorld,
 			void* replyAddr,
@@ -62,6 +62,16 @@ public:
 
 	void CallEveryStage();
 	void CallNextStage();
+	void Dispatch();	// run the next stage here, or hand a non real time
+						// stage to the command worker pool
+
+	// which resource the non real time stages touch, for per-resource
+	// ordering in the worker pool (see SC_CmdWorkerPool.h)
+	enum {
+		kSerialResource = -1,	// ordered with every other serial command
+		kBarrierResource = -2	// ordered with everything
+	};
+	virtual int ResourceKey();
 
 	virtual int Init(char *inData, int inSize);
 
@@ -76,6 +86,8 @@ public:
 
 protected:
 	int mNextStage;
+	bool mRepeatStage;	// set by a non real time stage to run again after
+						// queued commands have had a turn (see CallNextStage)
 	ReplyAddress mReplyAddress;
 	World *mWorld;
 
@@ -98,6 +110,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();	// barrier: /sync waits for everything before it
+
 protected:
 	virtual void CallDestructor();
 	int mID;
@@ -117,6 +131,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();	// barrier: "copy" gens read a second buffer
+
 protected:
 	int mBufIndex;
 	BufGen *mBufGen;
@@ -143,6 +159,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();
+
 protected:
 	int mBufIndex;
 	SndBuf mSndBuf;
@@ -167,6 +185,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();
+
 protected:
 	int mBufIndex;
 	float *mFreeData;
@@ -189,6 +209,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();
+
 protected:
 	int mBufIndex;
 
@@ -210,8 +232,76 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();
+
+protected:
+	int mBufIndex;
+
+	virtual void CallDestructor();
+};
+
+///////////////////////////////////////////////////////////////////////////
+
+// min/max/rms decimation pyramid over a buffer, built by /b_peaks and read
+// back by /b_getPeaks, so waveform displays can fetch one zoom level
+// instead of round-tripping the sample data through /b_getn floods.
+// NRT-thread state, kept per buffer index in HiddenWorld::mBufPeaks;
+// commands keyed on the buffer index serialize in the worker pool, so no
+// further locking is needed. Content-changing buffer commands invalidate
+// the pyramid; after RT writes (/b_set etc.) the client refreshes the
+// changed region with another /b_peaks.
+struct SC_BufPeaks
+{
+	float *mData;		// levels back to back, finest first; per bin and
+						// channel: min, max, rms
+	int mNumFrames;		// buffer shape the pyramid was computed for
+	int mNumChannels;
+	int mNumLevels;
+	int mNumBins;		// bins in the finest level
+};
+
+const int kBufPeaksBinSize = 64;	// frames per finest-level bin
+const int kBufPeaksBranch = 4;		// bins merged into one coarser bin
+
+// free the pyramid of a buffer whose contents are about to change.
+// call from Stage2 of a command keyed on the same buffer index.
+void SC_BufPeaks_Invalidate(World *inWorld, int inBufIndex);
+
+class BufPeaksCmd : public SC_SequencedCommand
+{
+public:
+	BufPeaksCmd(World *inWorld, ReplyAddress *inReplyAddress);
+
+	virtual int Init(char *inData, int inSize);
+
+	virtual bool Stage2();	// non real time
+
+	virtual int ResourceKey();
+
+protected:
+	int mBufIndex;
+	int mStart;		// region to refresh; whole buffer when no pyramid
+	int mNumFrames;	// exists yet or the buffer shape changed. -1: all
+
+	virtual void CallDestructor();
+};
+
+class BufGetPeaksCmd : public SC_SequencedCommand
+{
+public:
+	BufGetPeaksCmd(World *inWorld, ReplyAddress *inReplyAddress);
+
+	virtual int Init(char *inData, int inSize);
+
+	virtual bool Stage2();	// non real time
+
+	virtual int ResourceKey();
+
 protected:
 	int mBufIndex;
+	int mStart;
+	int mNumFrames;	// -1: to the end of the buffer
+	int mNumBins;	// upper bound on returned bins; picks the zoom level
 
 	virtual void CallDestructor();
 };
@@ -230,6 +320,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();
+
 protected:
 	int mBufIndex;
 	float *mFreeData;
@@ -242,6 +334,28 @@ protected:
 
 ///////////////////////////////////////////////////////////////////////////
 
+// /b_allocRead variant that converts the file to the server's sample rate
+// while loading, so content at mismatched rates plays back without a
+// runtime interpolation cost. quality selects a preset of the polyphase
+// converter (see SC_SampleRateConverter.hpp).
+class BufAllocReadResampleCmd : public BufAllocReadCmd
+{
+public:
+	BufAllocReadResampleCmd(World *inWorld, ReplyAddress *inReplyAddress);
+
+	virtual int Init(char *inData, int inSize);
+
+	virtual bool Stage2();	// non real time
+	virtual void Stage4();	// non real time
+
+protected:
+	int mQuality;
+
+	virtual void CallDestructor();
+};
+
+///////////////////////////////////////////////////////////////////////////
+
 class BufReadCmd : public SC_SequencedCommand
 {
 public:
@@ -254,6 +368,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();
+
 protected:
 	int mBufIndex;
 	char *mFilename;
@@ -299,6 +415,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();
+
 protected:
 	int mBufIndex;
 	float *mFreeData;
@@ -322,6 +440,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();
+
 protected:
 	int mBufIndex;
 	char *mFilename;
@@ -345,14 +465,20 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();
+
 protected:
 	int mBufIndex;
 	char *mFilename;
 #ifndef NO_LIBSNDFILE
 	SF_INFO mFileInfo;
+	SNDFILE *mSndFile;	// open across chunked Stage2 rounds
 #endif
 	int mNumFrames, mBufOffset;
 	bool mLeaveFileOpen;
+	int mFramesWritten;
+	float *mBufData;	// snapshot to detect the buffer changing between rounds
+	int mBufChannels;
 
 	virtual void CallDestructor();
 };
@@ -368,6 +494,8 @@ public:
 	virtual bool Stage3();	//     real time
 	virtual void Stage4();	// non real time
 
+	virtual int ResourceKey();	// barrier: everything finishes before /quit
+
 protected:
 
 	virtual void CallDestructor();
@@ -481,6 +609,120 @@ protected:
 
 ///////////////////////////////////////////////////////////////////////////
 
+// like RecvSynthDefCmd, but the def bytes come from a shared memory transfer
+// slot a local client filled (see def_transfer_slot in server_shm.hpp), so
+// the defs never cross the socket.
+class RecvSynthDefShmCmd : public SC_SequencedCommand
+{
+public:
+	RecvSynthDefShmCmd(World *inWorld, ReplyAddress *inReplyAddress);
+
+	virtual int Init(char *inData, int inSize);
+
+	virtual bool Stage2();	// non real time
+	virtual bool Stage3();	//     real time
+	virtual void Stage4();	// non real time
+
+protected:
+	int mSlotIndex;
+	GraphDef *mDefs;
+
+	virtual void CallDestructor();
+};
+
+///////////////////////////////////////////////////////////////////////////
+
+class AnalysisDataLoadCmd : public SC_SequencedCommand
+{
+public:
+	AnalysisDataLoadCmd(World *inWorld, ReplyAddress *inReplyAddress);
+	virtual ~AnalysisDataLoadCmd();
+
+	virtual int Init(char *inData, int inSize);
+
+	virtual bool Stage2();	// non real time
+	virtual bool Stage3();	//     real time
+	virtual void Stage4();	// non real time
+
+protected:
+	char *mName;
+	char *mFilename;
+	struct SC_AnalysisSegment *mSegment;	// built in Stage2, linked in Stage3
+	struct SC_AnalysisSegment *mReplaced;	// same-name segment unlinked in Stage3
+
+	virtual void CallDestructor();
+};
+
+///////////////////////////////////////////////////////////////////////////
+
+class AnalysisDataFreeCmd : public SC_SequencedCommand
+{
+public:
+	AnalysisDataFreeCmd(World *inWorld, ReplyAddress *inReplyAddress);
+	virtual ~AnalysisDataFreeCmd();
+
+	virtual int Init(char *inData, int inSize);
+
+	virtual bool Stage2();	// non real time
+	virtual bool Stage3();	//     real time
+	virtual void Stage4();	// non real time
+
+protected:
+	char *mName;
+	struct SC_AnalysisSegment *mSegment;	// unlinked in Stage3, unmapped in Stage4
+
+	virtual void CallDestructor();
+};
+
+///////////////////////////////////////////////////////////////////////////
+
+class RecordTapStartCmd : public SC_SequencedCommand
+{
+public:
+	RecordTapStartCmd(World *inWorld, ReplyAddress *inReplyAddress);
+	virtual ~RecordTapStartCmd();
+
+	virtual int Init(char *inData, int inSize);
+
+	virtual bool Stage2();	// non real time
+	virtual bool Stage3();	//     real time
+	virtual void Stage4();	// non real time
+
+protected:
+	char *mFilename;
+	int mRingFrames;
+	int mFramesPerFile;
+	struct SC_RecordTapEntry *mEntries;
+	int mNumEntries;
+	class SC_RecordTap *mTap;	// built in Stage2, installed in Stage3
+	class SC_RecordTap *mReplaced;	// previous tap unhooked in Stage3, stopped in Stage4
+	bool mInstalled;
+
+	virtual void CallDestructor();
+};
+
+///////////////////////////////////////////////////////////////////////////
+
+class RecordTapStopCmd : public SC_SequencedCommand
+{
+public:
+	RecordTapStopCmd(World *inWorld, ReplyAddress *inReplyAddress);
+	virtual ~RecordTapStopCmd();
+
+	virtual int Init(char *inData, int inSize);
+
+	virtual bool Stage2();	// non real time
+	virtual bool Stage3();	//     real time
+	virtual void Stage4();	// non real time
+
+protected:
+	class SC_RecordTap *mTap;	// unhooked in Stage3, drained and freed in Stage4
+
+	virtual void CallDestructor();
+};
+
+///////////////////////////////////////////////////////////////////////////
+
 class LoadSynthDefDirCmd : public SC_SequencedCommand
 {
 public:
@@ -518,6 +760,24 @@ protected:
 
 ///////////////////////////////////////////////////////////////////////////
 
+// answers /g_queryTree (without controls) from the NRT node tree mirror.
+// Init receives the group IDs already resolved on the real time thread.
+class QueryTreeCmd : public SC_SequencedCommand
+{
+public:
+	QueryTreeCmd(World *inWorld, ReplyAddress *inReplyAddress);
+
+	virtual int Init(char *inData, int inSize);
+
+	virtual bool Stage2();	// non real time
+
+protected:
+
+	virtual void CallDestructor();
+};
+
+///////////////////////////////////////////////////////////////////////////
+
 
 typedef bool (*AsyncStageFn)(World *inWorld, void* cmdData);
 typedef void (*AsyncFreeFn)(World *inWorld, void* cmdData);
@@ -0,0 +1,268 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "SC_SharedBufCache.h"
+
+#ifdef _WIN32
+
+// named file mappings would work on Windows as well, but nobody runs the
+// multi-server farms this exists for on it; the callers fall back to
+// private allocations.
+float *SharedBufCache_Acquire(const char *, int64, uint32, const int *, uint32, uint32, bool *)
+{
+	return 0;
+}
+void SharedBufCache_Publish(float *) {}
+bool SharedBufCache_Release(void *) { return false; }
+
+#else
+
+#include "SC_Lock.h"
+
+#include <atomic>
+#include <map>
+#include <new>
+#include <string>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const int32 kSharedBufMagic = ('S'<<24) | ('C'<<16) | ('b'<<8) | 'f';
+
+// how long an opener waits for another server to finish decoding the
+// file into a fresh segment. loading big content from spinning disks is
+// slow, so this errs on the generous side; on timeout the caller just
+// loads a private copy.
+const int kSharedBufFillTimeoutSeconds = 120;
+
+enum { kSharedBufFilling = 0, kSharedBufReady = 1 };
+
+// first page of the segment; the sample data starts at the next page
+// boundary so it can be mapped with its own protection.
+struct SharedBufHeader
+{
+	int32 mMagic;
+	std::atomic<int32> mState;
+	std::atomic<int32> mRefCount;
+	uint32 mNumSamples;
+};
+
+struct SharedBufMapping
+{
+	std::string mName;
+	SharedBufHeader *mHeader;
+	float *mPayload;
+	size_t mPayloadBytes;
+	int mFd;
+};
+
+static SC_Lock gSharedBufLock;
+static std::map<void*, SharedBufMapping> gSharedBufMappings;
+
+static size_t sharedBufPageSize()
+{
+	static size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	return pageSize;
+}
+
+// identity of one decoded file region: canonical path, file mtime and
+// size (so a rewritten file gets a new segment), region and channel
+// selection. FNV-1a, folded into the segment name.
+static uint64 sharedBufKey(const char *inRealPath, const struct stat &inStat,
+	int64 inFileOffset, uint32 inNumFrames, const int *inChannels, uint32 inNumChannels)
+{
+	uint64 hash = 14695981039346656037ULL;
+	#define FNV_BYTES(ptr, len) \
+		for (size_t i_ = 0; i_ < (size_t)(len); ++i_) { \
+			hash ^= ((const unsigned char*)(ptr))[i_]; \
+			hash *= 1099511628211ULL; \
+		}
+	FNV_BYTES(inRealPath, strlen(inRealPath));
+	int64 scalars[4];
+	scalars[0] = (int64)inStat.st_mtime;
+	scalars[1] = (int64)inStat.st_size;
+	scalars[2] = inFileOffset;
+	scalars[3] = (int64)inNumFrames;
+	FNV_BYTES(scalars, sizeof(scalars));
+	if (inNumChannels)
+		FNV_BYTES(inChannels, inNumChannels * sizeof(int));
+	#undef FNV_BYTES
+	return hash;
+}
+
+float *SharedBufCache_Acquire(const char *inPath, int64 inFileOffset, uint32 inNumFrames,
+	const int *inChannels, uint32 inNumChannels, uint32 inNumSamples, bool *outNeedsFill)
+{
+	*outNeedsFill = false;
+	if (inNumSamples == 0) return 0;
+
+	struct stat statbuf;
+	if (stat(inPath, &statbuf)) return 0;
+	char realPath[PATH_MAX];
+	if (!realpath(inPath, realPath)) return 0;
+
+	uint64 key = sharedBufKey(realPath, statbuf, inFileOffset, inNumFrames, inChannels, inNumChannels);
+	char name[64];
+	snprintf(name, sizeof(name), "/scsynth_buf_%016llx", (unsigned long long)key);
+
+	size_t pageSize = sharedBufPageSize();
+	size_t payloadBytes = (size_t)inNumSamples * sizeof(float);
+	size_t totalBytes = pageSize + ((payloadBytes + pageSize - 1) & ~(pageSize - 1));
+
+	SharedBufMapping mapping;
+	mapping.mName = name;
+	mapping.mPayloadBytes = payloadBytes;
+
+	bool creator = false;
+	int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666);
+	if (fd >= 0) {
+		creator = true;
+		if (ftruncate(fd, totalBytes)) {
+			close(fd);
+			shm_unlink(name);
+			return 0;
+		}
+	} else {
+		if (errno != EEXIST) return 0;
+		fd = shm_open(name, O_RDWR, 0);
+		if (fd < 0) return 0;
+		struct stat shmstat;
+		if (fstat(fd, &shmstat) || (size_t)shmstat.st_size < totalBytes) {
+			close(fd);
+			return 0;
+		}
+	}
+	mapping.mFd = fd;
+
+	void *header = mmap(0, pageSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (header == MAP_FAILED) {
+		close(fd);
+		if (creator) shm_unlink(name);
+		return 0;
+	}
+	mapping.mHeader = (SharedBufHeader*)header;
+
+	if (creator) {
+		new (mapping.mHeader) SharedBufHeader;
+		mapping.mHeader->mMagic = kSharedBufMagic;
+		mapping.mHeader->mNumSamples = inNumSamples;
+		mapping.mHeader->mRefCount.store(1, std::memory_order_relaxed);
+		mapping.mHeader->mState.store(kSharedBufFilling, std::memory_order_release);
+
+		// the creator decodes through a shared writable view; Publish
+		// swaps it for a copy-on-write view at the same address.
+		void *payload = mmap(0, payloadBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, pageSize);
+		if (payload == MAP_FAILED) {
+			munmap(header, pageSize);
+			close(fd);
+			shm_unlink(name);
+			return 0;
+		}
+		mapping.mPayload = (float*)payload;
+		*outNeedsFill = true;
+	} else {
+		if (mapping.mHeader->mMagic != kSharedBufMagic
+				|| mapping.mHeader->mNumSamples != inNumSamples) {
+			munmap(header, pageSize);
+			close(fd);
+			return 0;
+		}
+
+		// take a reference before waiting so the creator cannot release
+		// and unlink the segment under us
+		mapping.mHeader->mRefCount.fetch_add(1, std::memory_order_relaxed);
+
+		// wait for the creator to finish decoding. a segment left behind
+		// by a crashed server never becomes ready; the timeout turns
+		// that into an ordinary private load.
+		int waited = 0;
+		while (mapping.mHeader->mState.load(std::memory_order_acquire) != kSharedBufReady) {
+			if (waited >= kSharedBufFillTimeoutSeconds * 1000) {
+				mapping.mHeader->mRefCount.fetch_sub(1, std::memory_order_relaxed);
+				munmap(header, pageSize);
+				close(fd);
+				return 0;
+			}
+			usleep(1000);
+			waited++;
+		}
+
+		void *payload = mmap(0, payloadBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, pageSize);
+		if (payload == MAP_FAILED) {
+			mapping.mHeader->mRefCount.fetch_sub(1, std::memory_order_relaxed);
+			munmap(header, pageSize);
+			close(fd);
+			return 0;
+		}
+		mapping.mPayload = (float*)payload;
+	}
+
+	lock_guard<SC_Lock> lock(gSharedBufLock);
+	gSharedBufMappings[mapping.mPayload] = mapping;
+	return mapping.mPayload;
+}
+
+void SharedBufCache_Publish(float *inData)
+{
+	lock_guard<SC_Lock> lock(gSharedBufLock);
+	std::map<void*, SharedBufMapping>::iterator it = gSharedBufMappings.find(inData);
+	if (it == gSharedBufMappings.end()) return;
+	SharedBufMapping &mapping = it->second;
+
+	// replace the shared writable view with a copy-on-write one at the
+	// same address, so the creator's later buffer writes stay private
+	// like everyone else's. MAP_FIXED keeps the pointer stable.
+	mmap(mapping.mPayload, mapping.mPayloadBytes, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_FIXED, mapping.mFd, sharedBufPageSize());
+
+	mapping.mHeader->mState.store(kSharedBufReady, std::memory_order_release);
+}
+
+bool SharedBufCache_Release(void *inData)
+{
+	if (!inData) return false;
+
+	lock_guard<SC_Lock> lock(gSharedBufLock);
+	std::map<void*, SharedBufMapping>::iterator it = gSharedBufMappings.find(inData);
+	if (it == gSharedBufMappings.end()) return false;
+	SharedBufMapping mapping = it->second;
+	gSharedBufMappings.erase(it);
+
+	munmap(mapping.mPayload, mapping.mPayloadBytes);
+
+	// the last server out turns off the lights. a server that opens the
+	// segment between this decrement and the unlink keeps a working
+	// private mapping; only the name goes away.
+	if (mapping.mHeader->mRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		shm_unlink(mapping.mName.c_str());
+
+	munmap(mapping.mHeader, sharedBufPageSize());
+	close(mapping.mFd);
+	return true;
+}
+
+#endif // _WIN32
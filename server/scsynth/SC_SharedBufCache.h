@@ -0,0 +1,56 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#ifndef _SC_SharedBufCache_
+#define _SC_SharedBufCache_
+
+#include "SC_Types.h"
+
+// Machine-wide cache of sample data loaded by /b_allocRead and
+// /b_allocReadChannel (enabled with the -s server option). The decoded
+// float data of a file region is kept in a named POSIX shared memory
+// segment keyed by the file's identity and the requested region, so
+// several servers on one host loading the same content map one copy
+// instead of each holding their own. Every server maps the payload
+// copy-on-write: buffer writes (/b_set, /b_write, ...) only ever touch
+// private pages, so sharing is invisible to the client.
+//
+// All of these run on NRT command threads and may block.
+
+// look up or create the segment for one file region. returns the mapped
+// payload (inNumSamples floats) or 0 if the cache cannot serve the
+// request (unsupported platform, stale segment, shm exhausted); the
+// caller then falls back to a private allocation. if *outNeedsFill is
+// true this call created the segment: the caller must decode the file
+// into the returned memory and then call SharedBufCache_Publish.
+float *SharedBufCache_Acquire(const char *inPath, int64 inFileOffset, uint32 inNumFrames,
+	const int *inChannels, uint32 inNumChannels, uint32 inNumSamples, bool *outNeedsFill);
+
+// mark a freshly created segment as filled so other servers may map it,
+// and switch the creator's own mapping to copy-on-write. the pointer
+// stays valid and unchanged.
+void SharedBufCache_Publish(float *inData);
+
+// release a mapping obtained from SharedBufCache_Acquire. returns false
+// if the pointer is not a cache mapping (the caller frees it itself).
+// the last server on the machine to release a segment unlinks it.
+bool SharedBufCache_Release(void *inData);
+
+#endif
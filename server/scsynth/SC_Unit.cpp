@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include "SC_Endian.h"
 #include "SC_Unit.h"
+#include "SC_Graph.h"
 #include "SC_UnitSpec.h"
 #include "SC_UnitDef.h"
 #include "SC_World.h"
@@ -35,17 +36,20 @@ Unit* Unit_New(World *inWorld, UnitSpec *inUnitSpec, char*& memory)
 {
 	UnitDef *def = inUnitSpec->mUnitDef;
 
+	uint32 numInputs = inUnitSpec->mNumInputs;
+	uint32 numOutputs = inUnitSpec->mNumOutputs;
+	uint64 numPorts = numInputs + numOutputs;
+
 	Unit *unit = (Unit*)memory;
-	memory += def->mAllocSize;
+	// the state block is sized from the spec, not the def: a vectorized
+	// spec carries one copy of the plugin state per collapsed instance
+	// (see GraphDef_VectorizeUnits). normally the two sizes are equal.
+	memory += inUnitSpec->mAllocSize - numPorts * (sizeof(Wire*) + sizeof(float*));
 
 	unit->mWorld = inWorld;
 	unit->mUnitDef = def;
-
-	uint32 numInputs = inUnitSpec->mNumInputs;
-	uint32 numOutputs = inUnitSpec->mNumOutputs;
 	unit->mNumInputs = numInputs;
 	unit->mNumOutputs = numOutputs;
-	uint64 numPorts = numInputs + numOutputs;
 
 	unit->mInput = (Wire**)memory;
 	memory += numPorts * sizeof(Wire*);
@@ -81,6 +85,14 @@ void Unit_ZeroOutputs(Unit *unit, int inNumSamples)
 
 }
 
+void Unit_InitRGen(Unit *inUnit, RGen *inRGen)
+{
+	// deterministic per-unit stream: the same graph rendered with the same
+	// world seed produces the same noise, independent of dsp parallelism
+	inRGen->init_stream(inUnit->mWorld->mRandSeed,
+		(uint32)inUnit->mParent->mNode.mID, (uint32)inUnit->mParentIndex);
+}
+
 void Unit_EndCalc(Unit *inUnit, int inNumSamples)
 {
 	inUnit->mDone = true;
@@ -30,6 +30,13 @@
 #include "SC_World.h"
 #include "SC_WorldOptions.h"
 #include "SC_HiddenWorld.h"
+#include "SC_NodeTreeMirror.h"
+#include "SC_CmdWorkerPool.h"
+#include "SC_OscJournal.h"
+#include "SC_AnalysisData.h"
+#include "SC_RecordTap.h"
+#include "SC_DspWorkerPool.h"
+#include "SC_SharedBufCache.h"
 #include "SC_InterfaceTable.h"
 #include "SC_AllocPool.h"
 #include "SC_GraphDef.h"
@@ -47,10 +54,15 @@
 #include "../../common/SC_SndFileHelpers.hpp"
 #include "../../common/Samp.hpp"
 #include "SC_StringParser.h"
+#include <new>
 #ifdef _WIN32
 # include <direct.h>
 #else
 # include <sys/param.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
 #endif
 
 #include "../supernova/utilities/malloc_aligned.hpp"
@@ -59,6 +71,8 @@
 #undef scfft_create
 #undef scfft_dofft
 #undef scfft_doifft
+#undef scfft_dofft_batch
+#undef scfft_doifft_batch
 #undef scfft_destroy
 
 #if (_POSIX_MEMLOCK - 0) >=  200112L
@@ -76,6 +90,8 @@ extern HashTable<struct UnitDef, Malloc> *gUnitDefLib;
 extern HashTable<struct BufGen, Malloc> *gBufGenLib;
 extern HashTable<PlugInCmd, Malloc> *gPlugInCmds;
 
+void SC_BufPeaks_Invalidate(World *inWorld, int inBufIndex);	// SC_SequencedCommand.cpp
+
 extern "C" {
 
 #ifdef NO_LIBSNDFILE
@@ -153,8 +169,82 @@ void* zalloc(size_t n, size_t size)
 	return zalloc_(n, size);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+// hugepage/mlock-backed regions for the long lived bulk allocations: the
+// real time pool and the bus memory (WorldOptions::mHugePages). explicit
+// hugepages cut TLB pressure on large working sets, locking keeps the pages
+// from ever being swapped out under the audio thread. degrades step by step:
+// no hugetlb pages configured -> transparent hugepages via madvise, mmap
+// failure -> plain allocation, mlock failure -> warning only. regions are
+// always returned zeroed. World_New/World_Cleanup time only, not RT safe.
+
+struct LockedRegion
+{
+	void *mPtr;
+	size_t mSize;
+	LockedRegion *mNext;
+};
+static LockedRegion *gLockedRegions = 0;
+static bool gUseLockedRegions = false;
+
+static void* sc_region_alloc(size_t size)
+{
+#ifdef __linux__
+	if (gUseLockedRegions) {
+		const size_t hugeSize = 2 * 1024 * 1024;
+		size_t mapSize = (size + hugeSize - 1) & ~(hugeSize - 1);
+		void *ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+		ptr = mmap(0, mapSize, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+		if (ptr == MAP_FAILED) {
+			// no preallocated hugetlb pages: ask for transparent hugepages
+			ptr = mmap(0, mapSize, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+			if (ptr != MAP_FAILED)
+				madvise(ptr, mapSize, MADV_HUGEPAGE);
+#endif
+		}
+		if (ptr != MAP_FAILED) {
+			if (mlock(ptr, mapSize) != 0)
+				scprintf("warning: could not lock %zu bytes in core\n", mapSize);
+			LockedRegion *region = (LockedRegion*)malloc(sizeof(LockedRegion));
+			region->mPtr = ptr;
+			region->mSize = mapSize;
+			region->mNext = gLockedRegions;
+			gLockedRegions = region;
+			return ptr; // anonymous mappings are zero filled
+		}
+		scprintf("warning: could not mmap %zu bytes, falling back to plain allocation\n", mapSize);
+	}
+#endif
+	return zalloc_(size, 1);
+}
+
+static void sc_region_free(void *ptr)
+{
+	if (!ptr) return;
+	for (LockedRegion **prev = &gLockedRegions; *prev; prev = &(*prev)->mNext) {
+		LockedRegion *region = *prev;
+		if (region->mPtr == ptr) {
+			*prev = region->mNext;
+#ifdef __linux__
+			munmap(region->mPtr, region->mSize);
+#endif
+			free(region);
+			return;
+		}
+	}
+	free_alig(ptr);
+}
+
 void zfree(void * ptr)
 {
+	// buffer data may be a shared cache mapping rather than heap memory
+	if (SharedBufCache_Release(ptr)) return;
 	return free_alig(ptr);
 }
 
@@ -194,6 +284,8 @@ void sc_SetDenormalFlags()
 static bool getScopeBuffer(World *inWorld, int index, int channels, int maxFrames, ScopeBufferHnd &hnd);
 static void pushScopeBuffer(World *inWorld, ScopeBufferHnd &hnd, int frames);
 static void releaseScopeBuffer(World *inWorld, ScopeBufferHnd &hnd);
+int World_RTPrint(World *inWorld, const char *fmt, ...);
+void* World_ScratchAlloc(World *inWorld, size_t inNumBytes);
 
 void InterfaceTable_Init()
 {
@@ -255,10 +347,20 @@ void InterfaceTable_Init()
 	ft->fSCfftDestroy = &scfft_destroy;
 	ft->fSCfftDoFFT = &scfft_dofft;
 	ft->fSCfftDoIFFT = &scfft_doifft;
+	ft->fSCfftDoFFTBatch = &scfft_dofft_batch;
+	ft->fSCfftDoIFFTBatch = &scfft_doifft_batch;
 
 	ft->fGetScopeBuffer = &getScopeBuffer;
 	ft->fPushScopeBuffer = &pushScopeBuffer;
 	ft->fReleaseScopeBuffer = &releaseScopeBuffer;
+
+	ft->fRTPrint = &World_RTPrint;
+
+	ft->fGetAnalysisData = &AnalysisData_Find;
+
+	ft->fInitUnitRGen = &Unit_InitRGen;
+
+	ft->fScratchAlloc = &World_ScratchAlloc;
 }
 
 void initialize_library(const char *mUGensPluginPath);
@@ -331,6 +433,8 @@ World* World_New(WorldOptions *inOptions)
 
 	World *world = 0;
 
+	gUseLockedRegions = inOptions->mHugePages && inOptions->mRealTime;
+
 	try {
 		static bool gLibInitted = false;
 		if (!gLibInitted) {
@@ -342,15 +446,20 @@ World* World_New(WorldOptions *inOptions)
 
 		world = (World*)zalloc(1, sizeof(World));
 
-		world->hw = (HiddenWorld*)zalloc(1, sizeof(HiddenWorld));
+		// placement value-init: zeroes the plain members as zalloc used to, but
+		// also runs the constructors of the fifos (mSequence init) and the
+		// reply batcher's map, which plain zalloc left unconstructed.
+		world->hw = new (zalloc(1, sizeof(HiddenWorld))) HiddenWorld();
 
-		world->hw->mAllocPool = new AllocPool(malloc, free, inOptions->mRealTimeMemorySize * 1024, 0);
+		world->hw->mAllocPool = SC_NewRTAllocator(inOptions->mTLSFMemory, inOptions->mRealTimeMemorySize * 1024,
+				&sc_region_alloc, &sc_region_free);
 		world->hw->mQuitProgram = new boost::sync::semaphore(0);
 		world->hw->mTerminating = false;
 
 		HiddenWorld *hw = world->hw;
 		hw->mGraphDefLib = new HashTable<struct GraphDef, Malloc>(&gMalloc, inOptions->mMaxGraphDefs, false);
-		hw->mNodeLib = new IntHashTable<Node, AllocPool>(hw->mAllocPool, inOptions->mMaxNodes, false);
+		// grows incrementally from the RT pool up to mMaxNodes, which stays the hard cap
+		hw->mNodeLib = new IntHashTable<Node, SC_RTAllocator>(hw->mAllocPool, inOptions->mMaxNodes, true);
 		hw->mUsers = (ReplyAddress*)zalloc(inOptions->mMaxLogins, sizeof(ReplyAddress));
 		hw->mNumUsers = 0;
 		hw->mMaxUsers = inOptions->mMaxLogins;
@@ -381,28 +490,75 @@ World* World_New(WorldOptions *inOptions)
 		world->mErrorNotification = 1;  // i.e., 0x01 | 0x02
 		world->mLocalErrorNotification = 0;
 
+		hw->mControlBatchSize = sc_max(1u, inOptions->mControlBatchSize);
+		hw->mSanitizeOutputs = inOptions->mSanitizeOutputs;
+
+		hw->mShmem = 0;
+		hw->mShmemMetering = false;
 		if (inOptions->mSharedMemoryID) {
-			server_shared_memory_creator::cleanup(inOptions->mSharedMemoryID);
-			hw->mShmem = new server_shared_memory_creator(inOptions->mSharedMemoryID, inOptions->mNumControlBusChannels);
-			world->mControlBus = hw->mShmem->get_control_busses();
-		} else {
-			hw->mShmem = 0;
-			world->mControlBus = (float*)zalloc(world->mNumControlBusChannels, sizeof(float));
+			try {
+				server_shared_memory_creator::cleanup(inOptions->mSharedMemoryID);
+				hw->mShmem = new server_shared_memory_creator(inOptions->mSharedMemoryID, inOptions->mNumControlBusChannels,
+																inOptions->mNumAudioBusChannels);
+				world->mControlBus = hw->mShmem->get_control_busses();
+				hw->mShmemMetering = inOptions->mSharedMemoryMetering;
+			} catch (std::exception & exc) {
+				// clients fall back to /c_get; no reason to refuse to boot
+				scprintf("Cannot create shared memory: %s\n", exc.what());
+			}
+		}
+		if (!hw->mShmem)
+			world->mControlBus = (float*)sc_region_alloc(world->mNumControlBusChannels * sizeof(float));
+
+		// the node tree mirror only sees events in real time mode
+		hw->mNodeTreeMirror = inOptions->mRealTime ? new NodeTreeMirror() : 0;
+
+		// in non real time mode sequenced commands run all stages inline,
+		// so there is nothing for the worker pool to do
+		hw->mCmdWorkerPool = inOptions->mRealTime ? new SC_CmdWorkerPool(world) : 0;
+
+		// parallel groups need the worker pool and are a real time feature;
+		// in non real time mode /p_new groups just run sequentially
+		hw->mNumParallelWorkers = inOptions->mRealTime ? inOptions->mNumParallelWorkers : 0;
+		hw->mParallelCalcActive = false;
+		hw->mAllocLock.clear();
+		hw->mShareSndBufs = inOptions->mSharedBufCache;
+		hw->mDspWorkers = hw->mNumParallelWorkers > 0
+			? new SC_DspWorkerPool(world, hw->mNumParallelWorkers, inOptions->mMaxNodes)
+			: 0;
+
+		// journaling only makes sense in real time mode; in non real time
+		// mode the command file already is the journal
+		hw->mOscJournal = 0;
+		if (inOptions->mRealTime && inOptions->mOscJournalFilename) {
+			SC_OscJournal *journal = new SC_OscJournal(inOptions->mOscJournalFilename);
+			if (journal->IsOpen()) hw->mOscJournal = journal;
+			else delete journal;
 		}
 
+		hw->mRecordTap = 0;
+
 		world->mNumSharedControls = 0;
 		world->mSharedControls = inOptions->mSharedControls;
 
 		int numsamples = world->mBufLength * world->mNumAudioBusChannels;
-		world->mAudioBus = (float*)zalloc(numsamples, sizeof(float));
+		world->mAudioBus = (float*)sc_region_alloc(numsamples * sizeof(float));
 
 		world->mAudioBusTouched = (int32*)zalloc(inOptions->mNumAudioBusChannels, sizeof(int32));
 		world->mControlBusTouched = (int32*)zalloc(inOptions->mNumControlBusChannels, sizeof(int32));
 
+		hw->mAudioBusAllocMap = (uint32*)zalloc((world->mNumAudioBusChannels + 31) >> 5, sizeof(uint32));
+		hw->mControlBusAllocMap = (uint32*)zalloc((world->mNumControlBusChannels + 31) >> 5, sizeof(uint32));
+		// hardware input/output channels are never handed out dynamically
+		for (uint32 i = 0; i < world->mNumInputs + world->mNumOutputs; ++i)
+			hw->mAudioBusAllocMap[i >> 5] |= 1 << (i & 31);
+
 		world->mNumSndBufs = inOptions->mNumBuffers;
 		world->mSndBufs = (SndBuf*)zalloc(world->mNumSndBufs, sizeof(SndBuf));
 		world->mSndBufsNonRealTimeMirror = (SndBuf*)zalloc(world->mNumSndBufs, sizeof(SndBuf));
 		world->mSndBufUpdates = (SndBufUpdates*)zalloc(world->mNumSndBufs, sizeof(SndBufUpdates));
+		hw->mBufPeaks = (SC_BufPeaks**)zalloc(world->mNumSndBufs, sizeof(SC_BufPeaks*));
+		hw->mSndBufStripeLocks = new SC_Lock[kSndBufLockStripes];
 
 		GroupNodeDef_Init();
 
@@ -419,6 +575,10 @@ World* World_New(WorldOptions *inOptions)
 			world->mRGen[i].init(server_timeseed());
 		}
 
+		// base seed for per-unit random streams. fixed in non real time
+		// mode so offline renders are bit-for-bit reproducible.
+		world->mRandSeed = inOptions->mRealTime ? server_timeseed() : 0;
+
 		world->mNRTLock = new SC_Lock();
 		world->mDriverLock = new SC_Lock();
 
@@ -442,6 +602,8 @@ World* World_New(WorldOptions *inOptions)
 
 		world->mRestrictedPath = inOptions->mRestrictedPath;
 
+		world->mFastMath = inOptions->mFastMath;
+
 		sc_SetDenormalFlags();
 
 		if (world->mRealTime) {
@@ -494,8 +656,11 @@ int World_CopySndBuf(World *world, uint32 index, SndBuf *outBuf, bool onlyIfChan
 
 	if (!onlyIfChanged || didChange)
 	{
-
-		reinterpret_cast<SC_Lock*>(world->mNRTLock)->lock();
+		// the stripe lock orders this copy against the NRT stages of commands
+		// working on the same buffer; churn on other buffers maps to other
+		// stripes and does not stall us.
+		SC_Lock *stripeLock = world->hw->mSndBufStripeLocks + (index % kSndBufLockStripes);
+		stripeLock->lock();
 
 		SndBuf *buf = world->mSndBufsNonRealTimeMirror + index;
 
@@ -532,7 +697,7 @@ int World_CopySndBuf(World *world, uint32 index, SndBuf *outBuf, bool onlyIfChan
 
 		updates->reads = updates->writes;
 
-		reinterpret_cast<SC_Lock*>(world->mNRTLock)->unlock();
+		stripeLock->unlock();
 	}
 
 	if (outDidChange) *outDidChange = didChange;
@@ -566,6 +731,125 @@ bool nextOSCPacket(FILE *file, OSC_Packet *packet, int64& outTime)
 	return false;
 }
 
+// streaming reader for NRT score files. regular files are memory mapped and
+// parsed in place - packets point straight into the mapping, so the render
+// starts immediately and the resident set stays bounded by the readahead
+// window no matter how large the score grows. the kernel prefetches ahead of
+// the render cursor via madvise. stdin (and platforms without mmap) falls
+// back to packet-at-a-time reads through nextOSCPacket.
+struct ScoreReader
+{
+	FILE *mFile;			// fallback stream; zero when memory mapped
+	char *mPacketData;		// malloc'd packet buffer for the stream path
+	char *mMapBase;
+	size_t mMapSize;
+	size_t mMapPos;
+	size_t mMapPrefetched;	// offset up to which readahead has been requested
+};
+
+const size_t kScorePrefetchBytes = 8 * 1024 * 1024;
+
+static void ScoreReader_Open(ScoreReader *reader, const char *inFilename)
+{
+	memset(reader, 0, sizeof(ScoreReader));
+
+	if (!inFilename) {
+		reader->mFile = stdin;
+		reader->mPacketData = (char *)malloc(8192);
+		return;
+	}
+
+#ifndef _WIN32
+	int fd = open(inFilename, O_RDONLY);
+	if (fd >= 0) {
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+			// PROT_WRITE + MAP_PRIVATE: command handlers get copy-on-write
+			// pages if they scribble on their arguments, and the file on disk
+			// is never touched.
+			void *base = mmap(0, fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			if (base != MAP_FAILED) {
+				close(fd);
+				reader->mMapBase = (char *)base;
+				reader->mMapSize = (size_t)fileStat.st_size;
+				madvise(base, reader->mMapSize, MADV_SEQUENTIAL);
+				size_t prefetch = sc_min(reader->mMapSize, kScorePrefetchBytes);
+				madvise(base, prefetch, MADV_WILLNEED);
+				reader->mMapPrefetched = prefetch;
+				return;
+			}
+		}
+		close(fd);
+	}
+#endif
+
+#ifdef _WIN32
+	reader->mFile = fopen(inFilename, "rb");
+#else
+	reader->mFile = fopen(inFilename, "r");
+#endif
+	if (!reader->mFile)
+		throw std::runtime_error("Couldn't open non real time command file.\n");
+	reader->mPacketData = (char *)malloc(8192);
+}
+
+// returns true at end of score, like nextOSCPacket.
+static bool ScoreReader_NextPacket(ScoreReader *reader, OSC_Packet *packet, int64& outTime)
+{
+	if (reader->mFile) {
+		packet->mData = reader->mPacketData;
+		bool done = nextOSCPacket(reader->mFile, packet, outTime);
+		reader->mPacketData = packet->mData; // nextOSCPacket may realloc
+		return done;
+	}
+
+#ifndef _WIN32
+	// keep a readahead window in flight ahead of the render cursor, so the
+	// kernel fetches score pages while the audio for earlier packets renders.
+	while (reader->mMapPrefetched < reader->mMapSize
+			&& reader->mMapPos + kScorePrefetchBytes/2 > reader->mMapPrefetched) {
+		size_t prefetch = sc_min(reader->mMapSize - reader->mMapPrefetched, kScorePrefetchBytes);
+		madvise(reader->mMapBase + reader->mMapPrefetched, prefetch, MADV_WILLNEED);
+		reader->mMapPrefetched += prefetch;
+	}
+#endif
+
+	if (reader->mMapPos + sizeof(int32) > reader->mMapSize)
+		return true;
+
+	// msglen is in network byte order
+	int32 msglen = OSCint(reader->mMapBase + reader->mMapPos);
+	if (msglen > 1073741824)
+		throw std::runtime_error("OSC packet too long. > 2^30 bytes\n");
+	// a bundle is at least "#bundle\0" plus a timetag
+	if (msglen < 16 || reader->mMapPos + sizeof(int32) + (size_t)msglen > reader->mMapSize)
+		throw std::runtime_error("ScoreReader_NextPacket: invalid read of OSC packet\n");
+
+	char *data = reader->mMapBase + reader->mMapPos + sizeof(int32);
+	reader->mMapPos += sizeof(int32) + (size_t)msglen;
+
+	if (strcmp(data, "#bundle")!=0)
+		throw std::runtime_error("OSC packet not a bundle\n");
+
+	packet->mData = data;
+	packet->mSize = msglen;
+
+	outTime = OSCtime(data+8);
+	return false;
+}
+
+static void ScoreReader_Close(ScoreReader *reader)
+{
+#ifndef _WIN32
+	if (reader->mMapBase)
+		munmap(reader->mMapBase, reader->mMapSize);
+#endif
+	if (reader->mFile && reader->mFile != stdin)
+		fclose(reader->mFile);
+	free(reader->mPacketData);
+	memset(reader, 0, sizeof(ScoreReader));
+}
+
 void PerformOSCBundle(World *inWorld, OSC_Packet *inPacket);
 
 #ifndef NO_LIBSNDFILE
@@ -622,25 +906,16 @@ void World_NonRealTimeSynthesis(struct World *world, WorldOptions *inOptions)
 		world->hw->mNRTInputFile = 0;
 	}
 
-	FILE *cmdFile;
-	if (inOptions->mNonRealTimeCmdFilename) {
-#ifdef _WIN32
-		cmdFile = fopen(inOptions->mNonRealTimeCmdFilename, "rb");
-#else
-		cmdFile = fopen(inOptions->mNonRealTimeCmdFilename, "r");
-#endif
-	} else cmdFile = stdin;
-	if (!cmdFile)
-		throw std::runtime_error("Couldn't open non real time command file.\n");
+	ScoreReader scoreReader;
+	ScoreReader_Open(&scoreReader, inOptions->mNonRealTimeCmdFilename);
 
 	OSC_Packet packet;
 	memset(&packet, 0, sizeof(packet));
-	packet.mData = (char *)malloc(8192);
 	packet.mIsBundle = true;
 	packet.mReplyAddr.mReplyFunc = null_reply_func;
 
 	int64 schedTime;
-	if (nextOSCPacket(cmdFile, &packet, schedTime))
+	if (ScoreReader_NextPacket(&scoreReader, &packet, schedTime))
 		throw std::runtime_error("command file empty.\n");
 	int64 prevTime = schedTime;
 
@@ -706,7 +981,7 @@ void World_NonRealTimeSynthesis(struct World *world, WorldOptions *inOptions)
 
 
 				PerformOSCBundle(world, &packet);
-				if (nextOSCPacket(cmdFile, &packet, schedTime)) { run = false; break; }
+				if (ScoreReader_NextPacket(&scoreReader, &packet, schedTime)) { run = false; break; }
 				if(inOptions->mVerbosity >= 0) {
 					printf("nextOSCPacket %g\n", schedTime * oscToSeconds);
 				}
@@ -748,7 +1023,7 @@ Bail:
 		sf_writef_float(world->hw->mNRTOutputFile, outputFileBuf, bufFramesCalculated);
 	}
 
-	if (cmdFile != stdin) fclose(cmdFile);
+	ScoreReader_Close(&scoreReader);
 	sf_close(world->hw->mNRTOutputFile);
 	world->hw->mNRTOutputFile = 0;
 
@@ -757,7 +1032,6 @@ Bail:
 		world->hw->mNRTInputFile = 0;
 	}
 
-	free(packet.mData);
 	World_Cleanup(world,true);
 }
 #endif   // !NO_LIBSNDFILE
@@ -782,28 +1056,52 @@ void World_SetSampleRate(World *inWorld, double inSampleRate)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// with parallel group workers (-T) the RT pool can be hit from several DSP
+// threads at once (Node_SendReply, LocalBuf, ...). a spinlock is the right
+// tool here: holders only run a handful of pointer operations, and when -T
+// is off the flag is uncontended and costs one test-and-set.
+struct AllocLockGuard
+{
+	AllocLockGuard(World *inWorld) : mHw(inWorld->hw)
+	{
+		if (mHw->mNumParallelWorkers == 0) { mHw = 0; return; }
+		while (mHw->mAllocLock.test_and_set(std::memory_order_acquire))
+			;
+	}
+	~AllocLockGuard()
+	{
+		if (mHw) mHw->mAllocLock.clear(std::memory_order_release);
+	}
+	HiddenWorld *mHw;
+};
+
 void* World_Alloc(World *inWorld, size_t inByteSize)
 {
+	AllocLockGuard lock(inWorld);
 	return inWorld->hw->mAllocPool->Alloc(inByteSize);
 }
 
 void* World_Realloc(World *inWorld, void *inPtr, size_t inByteSize)
 {
+	AllocLockGuard lock(inWorld);
 	return inWorld->hw->mAllocPool->Realloc(inPtr, inByteSize);
 }
 
 size_t World_TotalFree(World *inWorld)
 {
+	AllocLockGuard lock(inWorld);
 	return inWorld->hw->mAllocPool->TotalFree();
 }
 
 size_t World_LargestFreeChunk(World *inWorld)
 {
+	AllocLockGuard lock(inWorld);
 	return inWorld->hw->mAllocPool->LargestFreeChunk();
 }
 
 void World_Free(World *inWorld, void *inPtr)
 {
+	AllocLockGuard lock(inWorld);
 	inWorld->hw->mAllocPool->Free(inPtr);
 }
 
@@ -981,11 +1279,95 @@ Group* World_GetGroup(World *inWorld, int32 inID)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// write per-bus peak/rms into the shared memory meter slots (see
+// server_shm.hpp), so local clients read meters without any OSC traffic.
+// one pass over the touched audio busses per block; the per-bus loop is a
+// straight reduction the compiler vectorizes. each block also pushes its
+// peak into the per-bus overview ring, a decimated mip-map level for
+// waveform overviews.
+static void World_UpdateBusMeters(World *inWorld)
+{
+	bus_meter *meters = inWorld->hw->mShmem->get_bus_meters();
+	int bufLength = inWorld->mBufLength;
+	float rscale = 1.f / bufLength;
+	int32 bufCounter = inWorld->mBufCounter;
+
+	for (uint32 i = 0; i < inWorld->mNumAudioBusChannels; ++i) {
+		bus_meter *meter = meters + i;
+		float peak = 0.f;
+		float rms = 0.f;
+		if (inWorld->mAudioBusTouched[i] == bufCounter) {
+			const float *samples = inWorld->mAudioBus + i * bufLength;
+			float sum = 0.f;
+			for (int j = 0; j < bufLength; ++j) {
+				float x = samples[j];
+				float mag = std::fabs(x);
+				if (mag > peak) peak = mag;
+				sum += x * x;
+			}
+			rms = std::sqrt(sum * rscale);
+		}
+		// untouched busses fall through as silence without scanning samples
+		meter->peak = peak;
+		meter->rms = rms;
+		meter->overview[meter->overview_index] = peak;
+		meter->overview_index = (meter->overview_index + 1) & (bus_meter::overview_frames - 1);
+	}
+}
+
+// graphs ended by Node_DeferDelete wait on hw->mPendingFreeNodes with
+// their destructors unrun. reclaim only a handful per block: when an
+// end-of-grain storm kills thousands of synths at once, the teardown cost
+// is smoothed over the following blocks instead of landing in one
+// callback. NRT renders have no deadline and drain the list completely.
+const int kNodeReclaimsPerBlock = 64;
+
+void World_ReclaimPendingNodes(World *inWorld)
+{
+	HiddenWorld *hw = inWorld->hw;
+	Node *node = hw->mPendingFreeNodes;
+	int budget = kNodeReclaimsPerBlock;
+	while (node && (!inWorld->mRealTime || budget-- > 0)) {
+		Node *next = node->mNext;
+		Graph_Reclaim((Graph*)node);
+		node = next;
+	}
+	hw->mPendingFreeNodes = node;
+}
+
+// scrub NaN, Inf and denormal samples from the hardware output buses
+// (WorldOptions::mSanitizeOutputs), replacing them with zero. classification
+// is branch free on the bit pattern so the loop vectorizes; one pass over
+// numOutputs * bufLength floats per block is far cheaper than running a
+// CheckBadValues/Sanitize pair on every output bus.
+static void World_ScrubOutputBuses(World *inWorld)
+{
+	int32 *bus = (int32*)inWorld->mAudioBus;
+	int numSamples = (int)(inWorld->mNumOutputs * inWorld->mBufLength);
+	for (int i = 0; i < numSamples; ++i) {
+		int32 bits = bus[i];
+		int32 expbits = bits & 0x7f800000;
+		bool bad = (expbits == 0x7f800000) | ((expbits == 0) & ((bits & 0x007fffff) != 0));
+		bus[i] = bad ? 0 : bits;
+	}
+}
+
 void World_Run(World *inWorld)
 {
 	// run top group
 	Node *node = (Node*)inWorld->mTopGroup;
 	(*node->mCalcFunc)(node);
+
+	World_ReclaimPendingNodes(inWorld);
+
+	if (inWorld->hw->mSanitizeOutputs)
+		World_ScrubOutputBuses(inWorld);
+
+	if (inWorld->hw->mShmemMetering)
+		World_UpdateBusMeters(inWorld);
+
+	if (inWorld->hw->mRecordTap)
+		inWorld->hw->mRecordTap->Capture(inWorld);
 }
 
 void World_Start(World *inWorld)
@@ -999,6 +1381,8 @@ void World_Start(World *inWorld)
 	inWorld->hw->mTriggers.MakeEmpty();
 	inWorld->hw->mNodeMsgs.MakeEmpty();
 	inWorld->hw->mNodeEnds.MakeEmpty();
+	inWorld->hw->mPrints.MakeEmpty();
+	inWorld->hw->mDeferredDoneActions.MakeEmpty();
 	inWorld->mRunning = true;
 }
 
@@ -1015,10 +1399,48 @@ void World_Cleanup(World *world, bool unload_plugins)
 
 	if (hw && world->mRealTime) hw->mAudioDriver->Stop();
 
+	// join the command workers before tearing anything else down; an
+	// in-flight command may still touch the driver fifos and the NRT lock
+	if (hw) {
+		delete hw->mCmdWorkerPool;
+		hw->mCmdWorkerPool = 0;
+	}
+
+	// the driver is stopped, so no job can be in flight; this just wakes
+	// the sleeping workers and joins them
+	if (hw) {
+		delete hw->mDspWorkers;
+		hw->mDspWorkers = 0;
+	}
+
+	// the socket listeners are already gone, so no more packets can arrive;
+	// stopping the journal flushes its fifo to disk
+	if (hw) {
+		delete hw->mOscJournal;
+		hw->mOscJournal = 0;
+	}
+
+	// the driver is stopped, so nothing feeds the tap ring; drain it to disk
+	if (hw && hw->mRecordTap) {
+		hw->mRecordTap->Stop();
+		delete hw->mRecordTap;
+		hw->mRecordTap = 0;
+	}
+
 	world->mRunning = false;
 
 	if (world->mTopGroup) Group_DeleteAll(world->mTopGroup);
 
+	// the driver is stopped, so the per-block budget no longer applies;
+	// reclaim every pending node before the pool goes away
+	if (hw) {
+		while (hw->mPendingFreeNodes) {
+			Node *node = hw->mPendingFreeNodes;
+			hw->mPendingFreeNodes = node->mNext;
+			Graph_Reclaim((Graph*)node);
+		}
+	}
+
 	reinterpret_cast<SC_Lock*>(world->mDriverLock)->lock();
 	if (hw) {
 		sc_free(hw->mWireBufSpace);
@@ -1034,8 +1456,8 @@ void World_Cleanup(World *world, bool unload_plugins)
 		SndBuf *nrtbuf = world->mSndBufsNonRealTimeMirror + i;
 		SndBuf * rtbuf = world->mSndBufs + i;
 
-		if (nrtbuf->data) free_alig(nrtbuf->data);
-		if (rtbuf->data && rtbuf->data != nrtbuf->data) free_alig(rtbuf->data);
+		if (nrtbuf->data) zfree(nrtbuf->data);
+		if (rtbuf->data && rtbuf->data != nrtbuf->data) zfree(rtbuf->data);
 
 #ifndef NO_LIBSNDFILE
 		if (nrtbuf->sndfile) sf_close(nrtbuf->sndfile);
@@ -1046,13 +1468,18 @@ void World_Cleanup(World *world, bool unload_plugins)
 	free_alig(world->mSndBufsNonRealTimeMirror);
 	free_alig(world->mSndBufs);
 
+	for (uint32 i=0; i<world->mNumSndBufs; ++i)
+		SC_BufPeaks_Invalidate(world, i);
+	free_alig(hw->mBufPeaks);
+
 	free_alig(world->mControlBusTouched);
 	free_alig(world->mAudioBusTouched);
+	delete hw->mNodeTreeMirror;
 	if (hw->mShmem) {
 		delete hw->mShmem;
 	} else
-		free_alig(world->mControlBus);
-	free_alig(world->mAudioBus);
+		sc_region_free(world->mControlBus);
+	sc_region_free(world->mAudioBus);
 	delete [] world->mRGen;
 	if (hw) {
 
@@ -1061,6 +1488,8 @@ void World_Cleanup(World *world, bool unload_plugins)
 		if (hw->mNRTOutputFile) sf_close(hw->mNRTOutputFile);
 		if (hw->mNRTCmdFile) fclose(hw->mNRTCmdFile);
 #endif
+		free_alig(hw->mAudioBusAllocMap);
+		free_alig(hw->mControlBusAllocMap);
 		free_alig(hw->mUsers);
 		free_alig(hw->mClientIDs);
 		delete hw->mClientIDdict;
@@ -1068,6 +1497,13 @@ void World_Cleanup(World *world, bool unload_plugins)
 		delete hw->mGraphDefLib;
 		delete hw->mQuitProgram;
 		delete hw->mAllocPool;
+		delete[] hw->mSndBufStripeLocks;
+		while (hw->mAnalysisData) {
+			SC_AnalysisSegment *segment = hw->mAnalysisData;
+			hw->mAnalysisData = segment->mNext;
+			AnalysisData_Unmap(segment);
+		}
+		hw->~HiddenWorld();	// matches the placement new in World_New
 		free_alig(hw);
 	}
 	free_alig(world);
@@ -1163,7 +1599,7 @@ void TriggerMsg::Perform()
 	ReplyAddress *users = mWorld->hw->mUsers;
 	int numUsers = mWorld->hw->mNumUsers;
 	for (int i=0; i<numUsers; ++i) {
-		SendReply(users+i, packet.data(), packet.size());
+		mWorld->hw->mReplyBatcher.Add(users+i, packet.data(), packet.size());
 	}
 }
 
@@ -1191,7 +1627,7 @@ void NodeReplyMsg::Perform()
 	ReplyAddress *users = mWorld->hw->mUsers;
 	int numUsers = mWorld->hw->mNumUsers;
 	for (int i=0; i<numUsers; ++i) {
-		SendReply(users+i, packet.data(), packet.size());
+		mWorld->hw->mReplyBatcher.Add(users+i, packet.data(), packet.size());
 	}
 
 	// Free memory in realtime thread
@@ -1203,6 +1639,22 @@ void NodeReplyMsg::Perform()
 
 void NodeEndMsg::Perform()
 {
+	// keep the NRT shadow tree in step before notifying clients
+	NodeTreeMirror *mirror = mWorld->hw->mNodeTreeMirror;
+	if (mirror) {
+		switch (mState) {
+			case kNode_Go :
+				mirror->AddNode(mNodeID, mGroupID, mPrevNodeID, mNextNodeID, mIsGroup, mDefName);
+				break;
+			case kNode_End :
+				mirror->RemoveNode(mNodeID);
+				break;
+			case kNode_Move :
+				mirror->MoveNode(mNodeID, mGroupID, mPrevNodeID, mNextNodeID);
+				break;
+		}
+	}
+
 	small_scpacket packet;
 	switch (mState) {
 		case kNode_Go :
@@ -1259,7 +1711,7 @@ void NodeEndMsg::Perform()
 	ReplyAddress *users = mWorld->hw->mUsers;
 	int numUsers = mWorld->hw->mNumUsers;
 	for (int i=0; i<numUsers; ++i) {
-		SendReply(users+i, packet.data(), packet.size());
+		mWorld->hw->mReplyBatcher.Add(users+i, packet.data(), packet.size());
 	}
 }
 
@@ -1306,3 +1758,77 @@ int scprintf(const char *fmt, ...)
 	if (gPrint) return (*gPrint)(fmt, vargs);
 	else return vprintf(fmt, vargs);
 }
+
+// real time safe print. formats into a fixed fifo slot on the RT thread;
+// the NRT thread hands the text to scprintf. never touches stdio or the
+// heap from the calling thread. drops the message (returning -1) when the
+// fifo is full rather than blocking the audio callback.
+int World_RTPrint(World *inWorld, const char *fmt, ...)
+{
+	va_list vargs;
+	va_start(vargs, fmt);
+
+	if (!inWorld->mRealTime) {
+		// NRT mode has no audio callback to protect; print directly.
+		int result;
+		if (gPrint) result = (*gPrint)(fmt, vargs);
+		else result = vprintf(fmt, vargs);
+		va_end(vargs);
+		return result;
+	}
+
+	PrintMsg msg;
+	int len = vsnprintf(msg.mText, sizeof(msg.mText), fmt, vargs);
+	va_end(vargs);
+	if (len < 0) return -1;
+
+	if (!inWorld->hw->mPrints.Write(msg)) return -1;
+	return len;
+}
+
+void PrintMsg::Perform()
+{
+	scprintf("%s", mText);
+}
+
+// per-thread arena backing ft->fScratchAlloc. allocation is a pointer bump;
+// the whole arena is reclaimed lazily when mBufCounter advances, so nothing
+// is ever freed explicitly. the arena grows (at most a handful of times,
+// while no scratch pointers are outstanding) until it covers the server's
+// steady-state demand, after which no allocator is touched at all.
+const size_t kScratchArenaInitialSize = 1 << 16;
+
+struct ScratchArena
+{
+	char *mData;
+	size_t mCapacity;
+	size_t mUsed;
+	int mBufEpoch;
+};
+
+static thread_local ScratchArena gScratchArena = { 0, 0, 0, -1 };
+
+void* World_ScratchAlloc(World *inWorld, size_t inNumBytes)
+{
+	ScratchArena& arena = gScratchArena;
+	if (arena.mBufEpoch != inWorld->mBufCounter) {
+		// first request this block: everything handed out last block is dead.
+		arena.mBufEpoch = inWorld->mBufCounter;
+		arena.mUsed = 0;
+	}
+	inNumBytes = (inNumBytes + 15) & ~(size_t)15; // keep every piece 16 byte aligned
+	if (arena.mUsed + inNumBytes > arena.mCapacity) {
+		if (arena.mUsed != 0)
+			return 0; // exhausted mid-block; the caller falls back to RTAlloc
+		size_t newSize = sc_max(2 * arena.mCapacity, kScratchArenaInitialSize);
+		while (newSize < inNumBytes) newSize <<= 1;
+		char *data = (char*)malloc(newSize);
+		if (!data) return 0;
+		free(arena.mData);
+		arena.mData = data;
+		arena.mCapacity = newSize;
+	}
+	void *ptr = arena.mData + arena.mUsed;
+	arena.mUsed += inNumBytes;
+	return ptr;
+}
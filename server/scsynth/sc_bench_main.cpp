@@ -0,0 +1,249 @@
+/*
+	SuperCollider real time audio synthesis system
+    Copyright (c) 2002 James McCartney. All rights reserved.
+	http://www.audiosynth.com
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+// sc_bench - offline cost measurement for server plugins.
+//
+// Boots a non realtime World, loads a compiled synthdef, spawns a number of
+// nodes from it and times repeated World_Run calls, reporting nanoseconds per
+// output sample. Build with `make sc_bench` (the target is excluded from the
+// default build) and run e.g.
+//
+//     sc_bench default.scsyndef -n 64 -b 2000 -r 10
+//
+// to catch dsp regressions before deploying, instead of eyeballing
+// Server.avgCPU on a live server.
+
+#include "SC_World.h"
+#include "SC_WorldOptions.h"
+#include "SC_Prototypes.h"
+#include "SC_ReplyImpl.hpp"
+#include "scsynthsend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+int PerformOSCMessage(World *inWorld, int inSize, char *inData, ReplyAddress *inReply);
+
+namespace {
+
+void Usage()
+{
+	scprintf(
+		"usage:\n"
+		"   sc_bench <synthdef-file> [options...]\n"
+		"options:\n"
+		"   -d <defname>      synthdef to instantiate (default: file basename)\n"
+		"   -n <nodes>        number of nodes to run (default 16)\n"
+		"   -b <blocks>       control blocks per repetition (default 2000)\n"
+		"   -r <repeats>      timed repetitions (default 10)\n"
+		"   -s <sample-rate>  sample rate in Hz (default 48000)\n"
+		"   -z <block-size>   control block size in frames (default 64)\n"
+		"   -U <paths>        a list of paths of ugen plugins, separated by `:`\n"
+		);
+	exit(1);
+}
+
+// the largest synthdef a single /d_recv packet can carry
+const size_t kMaxSynthDefSize = 60000;
+
+std::vector<char> readSynthDefFile(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file)
+		throw std::runtime_error("could not open synthdef file");
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (size <= 0 || (size_t)size > kMaxSynthDefSize) {
+		fclose(file);
+		throw std::runtime_error("synthdef file empty or too large");
+	}
+
+	std::vector<char> data(size);
+	size_t read = fread(data.data(), 1, size, file);
+	fclose(file);
+
+	if (read != (size_t)size)
+		throw std::runtime_error("could not read synthdef file");
+
+	return data;
+}
+
+void perform(World *world, char *data, int size)
+{
+	ReplyAddress replyAddress;
+	memset(&replyAddress, 0, sizeof(replyAddress));
+	replyAddress.mReplyFunc = null_reply_func;
+
+	int err = PerformOSCMessage(world, size, data, &replyAddress);
+	if (err)
+		throw std::runtime_error("server command failed");
+}
+
+// strip directory and extension: "synthdefs/default.scsyndef" -> "default"
+std::vector<char> defNameFromPath(const char *path)
+{
+	const char *base = strrchr(path, '/');
+#ifdef _WIN32
+	const char *backslash = strrchr(path, '\\');
+	if (backslash > base) base = backslash;
+#endif
+	base = base ? base + 1 : path;
+
+	const char *dot = strrchr(base, '.');
+	size_t len = dot ? (size_t)(dot - base) : strlen(base);
+
+	std::vector<char> name(base, base + len);
+	name.push_back(0);
+	return name;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2 || argv[1][0] == '-')
+		Usage();
+
+	const char *synthDefPath = argv[1];
+	const char *defName = 0;
+	int numNodes = 16;
+	int numBlocks = 2000;
+	int numRepeats = 10;
+	uint32 sampleRate = 48000;
+	uint32 blockSize = 64;
+	const char *pluginsPath = 0;
+
+	for (int i = 2; i < argc; i += 2) {
+		if (argv[i][0] != '-' || i + 1 >= argc)
+			Usage();
+		switch (argv[i][1]) {
+			case 'd': defName = argv[i+1]; break;
+			case 'n': numNodes = atoi(argv[i+1]); break;
+			case 'b': numBlocks = atoi(argv[i+1]); break;
+			case 'r': numRepeats = atoi(argv[i+1]); break;
+			case 's': sampleRate = atoi(argv[i+1]); break;
+			case 'z': blockSize = atoi(argv[i+1]); break;
+			case 'U': pluginsPath = argv[i+1]; break;
+			default: Usage();
+		}
+	}
+	if (numNodes < 1 || numBlocks < 1 || numRepeats < 1 || sampleRate < 1 || blockSize < 1)
+		Usage();
+
+	std::vector<char> name;
+	if (!defName) {
+		name = defNameFromPath(synthDefPath);
+		defName = name.data();
+	}
+
+	try {
+		std::vector<char> synthDef = readSynthDefFile(synthDefPath);
+
+		WorldOptions options = kDefaultWorldOptions;
+		options.mRealTime = false;
+		options.mLoadGraphDefs = 0;
+		options.mBufLength = blockSize;
+		options.mPreferredSampleRate = sampleRate;
+		if (pluginsPath)
+			options.mUGensPluginPath = pluginsPath;
+
+		World *world = World_New(&options);
+		if (!world)
+			throw std::runtime_error("could not create world");
+
+		World_SetSampleRate(world, sampleRate);
+		World_Start(world);
+
+		{
+			big_scpacket packet;
+			packet.adds("/d_recv");
+			packet.maketags(2);
+			packet.addtag(',');
+			packet.addtag('b');
+			packet.addb((uint8*)synthDef.data(), synthDef.size());
+			perform(world, packet.data(), packet.size());
+		}
+
+		for (int i = 0; i < numNodes; ++i) {
+			small_scpacket packet;
+			packet.adds("/s_new");
+			packet.maketags(5);
+			packet.addtag(',');
+			packet.addtag('s');
+			packet.addtag('i');
+			packet.addtag('i');
+			packet.addtag('i');
+			packet.adds(defName);
+			packet.addi(1000 + i);
+			packet.addi(0);	// add to head
+			packet.addi(0);	// of the root group
+			perform(world, packet.data(), packet.size());
+		}
+
+		// warm caches and let ramping envelopes settle before timing
+		for (int i = 0; i < numBlocks / 10 + 1; ++i)
+			World_Run(world);
+
+		std::vector<double> nsPerSample(numRepeats);
+		int64 samplesPerRun = (int64)numBlocks * world->mBufLength;
+
+		for (int i = 0; i < numRepeats; ++i) {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			for (int j = 0; j < numBlocks; ++j)
+				World_Run(world);
+
+			std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+			nsPerSample[i] =
+				std::chrono::duration_cast<std::chrono::duration<double, std::nano> >(elapsed).count()
+				/ (double)samplesPerRun;
+		}
+
+		std::sort(nsPerSample.begin(), nsPerSample.end());
+		double minimum = nsPerSample.front();
+		double median = nsPerSample[numRepeats / 2];
+		double maximum = nsPerSample.back();
+
+		scprintf("\n%s: %d node(s), %d blocks of %d frames at %d Hz, %d repetitions\n",
+				 defName, numNodes, numBlocks, (int)world->mBufLength, (int)sampleRate, numRepeats);
+		scprintf("ns/sample          min %10.2f   median %10.2f   max %10.2f\n",
+				 minimum, median, maximum);
+		scprintf("ns/sample/node     min %10.2f   median %10.2f   max %10.2f\n",
+				 minimum / numNodes, median / numNodes, maximum / numNodes);
+		// fraction of the realtime budget of 1e9/sampleRate ns per sample
+		scprintf("realtime load      %.2f%% (median)\n",
+				 100. * median * (double)sampleRate / 1e9);
+
+		World_Cleanup(world, true);
+	} catch (std::exception & exc) {
+		scprintf("sc_bench: %s\n", exc.what());
+		return 1;
+	}
+
+	return 0;
+}
@@ -86,6 +86,29 @@ void Usage()
 		"   -L enable memory locking\n"
 #endif
 		"   -H <hardware-device-name>\n"
+		"   -K write per-bus peak/rms meters into the shared memory interface\n"
+		"   -k <control-batch-size> run control-rate units of modulation-heavy defs\n"
+		"          every Nth block (default 1: every block)\n"
+		"   -F fast math: unary saturation ops (tanh) use bounded-error\n"
+		"          rational approximations instead of libm\n"
+		"   -x scrub NaN/Inf/denormal samples from the hardware output buses\n"
+		"          once per block, replacing them with zero\n"
+		"   -G back the realtime pool and bus memory with hugepages and lock\n"
+		"          them in core (falls back to transparent hugepages, then plain\n"
+		"          allocation, when none are configured)\n"
+		"   -A <realtime-allocator>  'pool' or 'tlsf'  (default pool)\n"
+		"          tlsf keeps alloc/free O(1) under fragmentation, at slightly\n"
+		"          higher per-allocation overhead\n"
+		"   -s share /b_allocRead sample data between servers on this machine\n"
+		"          (named shared memory, copy-on-write; identical reads are\n"
+		"          mapped once per machine)\n"
+		"   -T <num-parallel-workers>\n"
+		"          run steady-state synths inside parallel groups (/p_new) on this\n"
+		"          many extra realtime threads (default 0: parallel groups run\n"
+		"          sequentially)\n"
+		"   -J <journal-filename>\n"
+		"          record all incoming OSC packets to a file in the non realtime\n"
+		"          command file format, replayable with -N <journal-filename>\n"
 		"   -V <verbosity>\n"
 		"          0 is normal behaviour.\n"
 		"          -1 suppresses informational messages.\n"
@@ -149,7 +172,8 @@ int main(int argc, char* argv[])
 	WorldOptions options = kDefaultWorldOptions;
 
 	for (int i=1; i<argc;) {
-		if (argv[i][0] != '-' || argv[i][1] == 0 || strchr("utBaioczblndpmwZrCNSDIOMHvVRUhPL", argv[i][1]) == 0) {
+		// must list every letter handled by the switch below
+		if (argv[i][0] != '-' || argv[i][1] == 0 || strchr("utBaioczblndpmwZrCNSDIOMHvVRUhPLKkJTsFAGx", argv[i][1]) == 0) {
 			scprintf("ERROR: Invalid option %s\n", argv[i]);
 			Usage();
 		}
@@ -260,7 +284,6 @@ int main(int argc, char* argv[])
 			case 'H' :
 				checkNumArgs(2);
 				options.mInDeviceName = argv[j+1];
-#ifdef __APPLE__
 				if (i+1>argc || argv[j+2][0]=='-')
 				{
 					options.mOutDeviceName = options.mInDeviceName;
@@ -271,9 +294,6 @@ int main(int argc, char* argv[])
 					options.mOutDeviceName = argv[j+2];
 					++i;
 				}
-#else
-				options.mOutDeviceName = options.mInDeviceName; // Non-Mac platforms always use same device
-#endif
 				break;
 			case 'L' :
 				checkNumArgs(1);
@@ -283,6 +303,30 @@ int main(int argc, char* argv[])
 				options.mMemoryLocking = false;
 #endif
 				break;
+			case 'G' :
+				checkNumArgs(1);
+				options.mHugePages = true;
+				break;
+			case 'K' :
+				checkNumArgs(1);
+				options.mSharedMemoryMetering = true;
+				break;
+			case 'k' :
+				checkNumArgs(2);
+				options.mControlBatchSize = atoi(argv[j+1]);
+				break;
+			case 'J' :
+				checkNumArgs(2);
+				options.mOscJournalFilename = argv[j+1];
+				break;
+			case 'T' :
+				checkNumArgs(2);
+				options.mNumParallelWorkers = atoi(argv[j+1]);
+				break;
+			case 's' :
+				checkNumArgs(1);
+				options.mSharedBufCache = true;
+				break;
 			case 'V' :
 				checkNumArgs(2);
 				options.mVerbosity = atoi(argv[j+1]);
@@ -303,6 +347,23 @@ int main(int argc, char* argv[])
 				checkNumArgs(2);
 				options.mRestrictedPath = argv[j+1];
 				break;
+			case 'F' :
+				checkNumArgs(1);
+				options.mFastMath = true;
+				break;
+			case 'x' :
+				checkNumArgs(1);
+				options.mSanitizeOutputs = true;
+				break;
+			case 'A' :
+				checkNumArgs(2);
+				if (strcmp(argv[j+1], "tlsf") == 0) options.mTLSFMemory = true;
+				else if (strcmp(argv[j+1], "pool") == 0) options.mTLSFMemory = false;
+				else {
+					scprintf("ERROR: unknown realtime allocator '%s' (expected 'pool' or 'tlsf').\n", argv[j+1]);
+					Usage();
+				}
+				break;
 			case 'C' :
 				checkNumArgs(2);
 				break;
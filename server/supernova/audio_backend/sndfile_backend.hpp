@@ -259,20 +259,29 @@ private:
         nova::name_thread("sndfile writer");
 
         const size_t frames_per_tick = get_audio_blocksize();
-        const size_t deque_per_tick  = output_channels * frames_per_tick * 64;
-        aligned_storage_ptr<sample_type> data_to_write(deque_per_tick);
+
+        /* writes are batched: samples accumulate in an aligned buffer and
+         * libsndfile is only called with full batches (plus a final flush), so
+         * one large write replaces hundreds of small ones. on network storage
+         * the per-call latency dominates, and the render thread keeps filling
+         * the fifo while the batch is on its way to disk. */
+        const size_t batch_samples = output_channels * frames_per_tick * 256;
+        aligned_storage_ptr<sample_type> data_to_write(batch_samples);
 
         size_t pending_samples = 0;
 
         for (;;) {
             write_semaphore.wait();
-            poll_writer_queue(data_to_write.get(), deque_per_tick, pending_samples);
+            poll_writer_queue(data_to_write.get(), batch_samples, pending_samples);
             if (unlikely(writer_running.load(std::memory_order_acquire) == false))
                 break;
         }
 
-        while (poll_writer_queue(data_to_write.get(), deque_per_tick, pending_samples))
+        while (poll_writer_queue(data_to_write.get(), batch_samples, pending_samples))
         {}
+
+        if (pending_samples)
+            write_batch(data_to_write.get(), pending_samples);
     }
 
     bool poll_writer_queue(sample_type * data_to_write, const size_t buffer_samples, size_t & pending_samples)
@@ -280,38 +289,48 @@ private:
         bool consumed_item = false;
         for (;;) {
             const size_t available_samples = write_frames.read_available();
-            const size_t available_frames  = available_samples / output_channels;
 
-            if (available_frames == 0)
+            if (available_samples == 0)
                 return consumed_item;
 
-            const size_t buffer_frames = buffer_samples / output_channels;
-            const size_t frames_to_read = std::min(available_frames, buffer_frames);
-
-            const size_t samples_to_read = frames_to_read * output_channels;
-            const size_t dequeued = write_frames.pop(data_to_write, samples_to_read);
+            const size_t samples_to_read = std::min(available_samples, buffer_samples - pending_samples);
+            const size_t dequeued = write_frames.pop(data_to_write + pending_samples, samples_to_read);
 
             assert(dequeued == samples_to_read);
 
+            pending_samples += dequeued;
             consumed_item = true;
 
-            const sf_count_t written_frames = output_file.writef(data_to_write, frames_to_read);
-            assert(frames_to_read == written_frames);
-            if (written_frames == -1)
-                throw std::runtime_error(std::string("sndfile write failed: ") + output_file.strError());
+            if (pending_samples == buffer_samples) {
+                write_batch(data_to_write, pending_samples);
+                pending_samples = 0;
+            }
+        }
+
+        return consumed_item;
+    }
+
+    void write_batch(sample_type * data_to_write, const size_t samples)
+    {
+        /* the rt context only enqueues whole frames, so every batch boundary
+         * falls on a frame boundary */
+        assert(samples % output_channels == 0);
+        const size_t frames = samples / output_channels;
 
-            for (size_t frame = 0; frame != frames_to_read; ++frame) {
-                for (size_t channel = 0; channel != output_channels; ++channel) {
-                    const sample_type current_sample = data_to_write[frame * output_channels + channel];
+        const sf_count_t written_frames = output_file.writef(data_to_write, frames);
+        assert(frames == (size_t)written_frames);
+        if (written_frames == -1)
+            throw std::runtime_error(std::string("sndfile write failed: ") + output_file.strError());
 
-                    sample_type current_peak = max_peaks[channel];
+        for (size_t frame = 0; frame != frames; ++frame) {
+            for (size_t channel = 0; channel != output_channels; ++channel) {
+                const sample_type current_sample = data_to_write[frame * output_channels + channel];
 
-                    max_peaks[channel] = std::max(current_peak, std::abs(current_sample));
-                }
+                sample_type current_peak = max_peaks[channel];
+
+                max_peaks[channel] = std::max(current_peak, std::abs(current_sample));
             }
         }
-
-        return consumed_item;
     }
 
 public:
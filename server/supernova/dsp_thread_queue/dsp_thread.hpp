@@ -25,9 +25,8 @@
 #include <thread>
 #include <vector>
 
-#include <boost/sync/semaphore.hpp>
-
 #include "dsp_thread_queue.hpp"
+#include "thread_gate.hpp"
 #include "../utilities/malloc_aligned.hpp"
 #include "nova-tt/mlock.hpp"
 
@@ -68,9 +67,9 @@ class dsp_thread:
     typedef nova::dsp_queue_interpreter<runnable, Alloc> dsp_queue_interpreter;
 
 public:
-    dsp_thread(dsp_queue_interpreter & interpreter, uint16_t index,
+    dsp_thread(dsp_queue_interpreter & interpreter, thread_gate & gate, uint16_t index,
                thread_init_functor const & thread_init = thread_init_functor()):
-        thread_init_functor(thread_init), interpreter(interpreter), index(index)
+        thread_init_functor(thread_init), gate(gate), interpreter(interpreter), index(index)
     {
 #ifdef SUPERNOVA_USE_PTHREAD
         if (stack_size) {
@@ -119,7 +118,7 @@ public:
     void join()
     {
         stop.store( true, std::memory_order_relaxed );
-        wake_thread();
+        gate.wake_all();
 
 #ifdef SUPERNOVA_USE_PTHREAD
         void * ret;
@@ -131,11 +130,6 @@ public:
 #endif
     }
 
-    void wake_thread(void)
-    {
-        cycle_sem.post();
-    }
-
 private:
     /** thread function
      * */
@@ -143,11 +137,16 @@ private:
     {
         thread_init_functor::operator()(index);
 
+        thread_gate::wait_state wait_state;
+
         for (;;) {
-            cycle_sem.wait();
+            gate.wait(wait_state);
             if (unlikely(stop.load(std::memory_order_relaxed)))
                 return;
 
+            /* a helper can be woken without being needed this cycle (the gate
+             * wakes any n parked threads); the interpreter returns immediately
+             * when no nodes are pending */
             interpreter.tick(index);
         }
     }
@@ -160,7 +159,7 @@ private:
     }
 
 private:
-    boost::sync::semaphore cycle_sem;
+    thread_gate & gate;
     dsp_queue_interpreter & interpreter;
     std::atomic<bool> stop = {false};
     uint16_t index;
@@ -196,9 +195,10 @@ public:
 
     typedef std::unique_ptr<dsp_thread_queue<runnable, Alloc> > dsp_thread_queue_ptr;
 
-    dsp_thread_pool( thread_count_t count, bool yield_if_busy = false,
+    dsp_thread_pool( thread_count_t count, bool yield_if_busy = false, bool work_stealing = false,
                      thread_init_functor const & init_functor = thread_init_functor() ):
-        interpreter(std::min(count, (thread_count_t)std::thread::hardware_concurrency()), yield_if_busy)
+        interpreter(std::min(count, (thread_count_t)std::thread::hardware_concurrency()), yield_if_busy,
+                    work_stealing)
     {
         set_dsp_thread_count(interpreter.get_thread_count(), init_functor);
     }
@@ -207,7 +207,7 @@ public:
     {
         const bool run_tick = interpreter.init_tick();
         if( likely(run_tick) ) {
-            wake_threads();
+            wake_threads(interpreter.get_threads_to_wake());
             interpreter.tick_master();
         }
     }
@@ -247,17 +247,24 @@ private:
     void set_dsp_thread_count(thread_count_t count, thread_init_functor const & init_functor)
     {
         for (thread_count_t i = 1; i != count; ++i)
-            threads.emplace_back( new dsp_thread( interpreter, i, init_functor ) );
+            threads.emplace_back( new dsp_thread( interpreter, gate, i, init_functor ) );
     }
 
-    /** wake dsp threads */
-    void wake_threads(void)
+    /** wake dsp threads
+     *
+     *  only as many helpers as the current graph can keep busy are woken, via
+     *  a single batched wake on the shared gate; the remaining threads stay
+     *  parked for this tick
+     * */
+    void wake_threads(thread_count_t count)
     {
-        for (thread_count_t i = 0; i != interpreter.get_used_helper_threads(); ++i)
-            threads[i]->wake_thread();
+        assert( count <= interpreter.get_used_helper_threads() );
+        if (count)
+            gate.wake(count);
     }
 
     dsp_queue_interpreter interpreter;
+    thread_gate gate;
 
     std::vector<std::unique_ptr<dsp_thread>> threads;
 };
@@ -20,6 +20,7 @@
 #define DSP_THREAD_QUEUE_DSP_THREAD_QUEUE_HPP
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -146,7 +147,7 @@ public:
 
         job(thread_index);
 
-        dsp_thread_queue_item * next = update_dependencies(interpreter);
+        dsp_thread_queue_item * next = update_dependencies(interpreter, thread_index);
         reset_activation_count();
         return next;
     }
@@ -158,6 +159,25 @@ public:
         activation_count.store(activation_limit, std::memory_order_release);
     }
 
+    /** true when all predecessors have completed. used by the schedule
+     *  replay mode, which waits for dependencies instead of being scheduled. */
+    bool ready(void) const
+    {
+        return activation_count.load(std::memory_order_acquire) == 0;
+    }
+
+    /** run the item without feeding the scheduler: successors are
+     *  decremented but never queued, as every thread replays its own
+     *  pinned item order. */
+    void run_pinned(std::uint8_t thread_index)
+    {
+        assert(activation_count == 0);
+        job(thread_index);
+        for (std::size_t i = 0; i != successors.size(); ++i)
+            successors[i]->decrement_activation_count();
+        reset_activation_count();
+    }
+
     runnable const & get_job(void) const
     {
         return job;
@@ -187,7 +207,7 @@ public:
 
 private:
     /** \brief update all successors and possibly mark them as runnable */
-    dsp_thread_queue_item * update_dependencies(dsp_queue_interpreter & interpreter)
+    dsp_thread_queue_item * update_dependencies(dsp_queue_interpreter & interpreter, std::uint8_t thread_index)
     {
         dsp_thread_queue_item * next_item_to_run;
         std::size_t i = 0;
@@ -204,7 +224,7 @@ private:
         while( i != successors.size() ) {
             dsp_thread_queue_item * next = successors[i++]->decrement_activation_count();
             if (next)
-                interpreter.mark_as_runnable(next);
+                interpreter.mark_as_runnable(next, thread_index);
         }
 
         return next_item_to_run;
@@ -279,6 +299,93 @@ private:
     size_t size_           = 0;
 };
 
+/** bounded lock-free work-stealing deque (chase-lev)
+ *
+ *  the owning thread pushes and pops at the bottom, thieves steal single
+ *  items from the top via cas. capacity is fixed; overflow is left to the
+ *  caller, which falls back to the central scheduler queue.
+ */
+template <typename T, std::size_t capacity = 32768>
+class work_stealing_deque
+{
+    static_assert((capacity & (capacity - 1)) == 0, "work_stealing_deque capacity must be a power of two");
+
+public:
+    work_stealing_deque(void):
+        top_(0), bottom_(0)
+    {}
+
+    work_stealing_deque(work_stealing_deque const &)            = delete;
+    work_stealing_deque& operator=(work_stealing_deque const &) = delete;
+
+    /** called by the owning thread only */
+    bool push_bottom(T const & element)
+    {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        if (bottom - top >= (int64_t)capacity)
+            return false; // deque is full
+        array_[bottom & mask] = element;
+        bottom_.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** called by the owning thread only */
+    bool pop_bottom(T & out)
+    {
+        /* indices are signed as in the original chase-lev formulation:
+         * decrementing an empty deque yields bottom == -1, which the
+         * emptiness check below handles, where an unsigned index would
+         * wrap and read garbage */
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = array_[bottom & mask];
+        if (top == bottom) {
+            /* last element: race against thieves for it */
+            bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /** called by any thread */
+    bool steal_top(T & out)
+    {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return false;
+        out = array_[top & mask];
+        return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    }
+
+    /** approximate: both ends may move concurrently */
+    std::size_t size(void) const
+    {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? std::size_t(bottom - top) : 0;
+    }
+
+private:
+    static const int64_t mask = capacity - 1;
+
+    std::atomic<int64_t> top_, bottom_;
+    std::array<T, capacity> array_;
+};
+
 template <typename runnable, typename Alloc = std::allocator<void*> >
 class dsp_thread_queue
 {
@@ -352,6 +459,21 @@ private:
     raw_vector<dsp_thread_queue_item, item_allocator> items;
 };
 
+/** one scheduling decision of a dsp tick
+ *
+ *  the record/replay machinery fills one record per executed queue item, so
+ *  a pathological tick can be replayed with the exact thread assignment and
+ *  per-thread order that produced it.
+ */
+struct schedule_record
+{
+    uint32_t tick;    /* tick serial, wraps */
+    uint16_t item;    /* index of the item within its dsp_thread_queue */
+    uint8_t  thread;  /* dsp thread that executed the item */
+    uint8_t  padding;
+    uint32_t time_ns; /* execution start, relative to the start of the tick */
+};
+
 template <typename runnable,
           typename Alloc = std::allocator<void*> >
 class dsp_queue_interpreter
@@ -368,8 +490,8 @@ public:
 
     typedef std::unique_ptr<dsp_thread_queue> dsp_thread_queue_ptr;
 
-    dsp_queue_interpreter(thread_count_t tc, bool yield_if_busy = false):
-        yield_if_busy(yield_if_busy)
+    dsp_queue_interpreter(thread_count_t tc, bool yield_if_busy = false, bool use_work_stealing = false):
+        yield_if_busy(yield_if_busy), work_stealing(use_work_stealing)
     {
         if (!runnable_items.is_lock_free())
             std::cout << "Warning: scheduler queue is not lockfree!" << std::endl;
@@ -393,12 +515,53 @@ public:
         assert(runnable_items.empty());
         node_count.store(queue->total_node_count(), std::memory_order_release);
 
-        for( auto * item : queue->initially_runnable_items )
-            mark_as_runnable( item );
+        if (unlikely(trace_active.load(std::memory_order_relaxed))) {
+            tick_serial += 1;
+            tick_start = std::chrono::high_resolution_clock::now();
+        }
+
+        if (unlikely(replay_active)) {
+            /* every thread walks its pinned item list, nothing is queued.
+             * wake all threads: the recorded schedule decides who works. */
+            initial_parallelism = node_count_t(used_helper_threads + 1);
+            return true;
+        }
+
+        if (work_stealing) {
+            /* helper threads are not awake yet, so seeding their deques is safe.
+             * distributing round-robin spreads wide graphs before any stealing
+             * has to happen. */
+            const thread_count_t used_threads = used_helper_threads + 1;
+            thread_count_t current = 0;
+            for( auto * item : queue->initially_runnable_items ) {
+                if (!thread_queues[current].push_bottom(item))
+                    runnable_items.push(item);
+                current = (current + 1) % used_threads;
+            }
+        } else {
+            for( auto * item : queue->initially_runnable_items )
+                mark_as_runnable( item );
+        }
+
+        initial_parallelism = node_count_t(queue->initially_runnable_items.size());
 
         return true;
     }
 
+    /** number of helper threads worth waking for this tick
+     *
+     *  a graph with few independent roots cannot keep all helpers busy at the
+     *  start of the tick, so only as many threads as there are runnable items
+     *  are woken. narrow graphs that widen later still get one helper, which
+     *  picks up new work as dependencies resolve.
+     */
+    thread_count_t get_threads_to_wake(void) const
+    {
+        /* the master thread handles one of the initial items itself */
+        const node_count_t helpers_needed = std::max(node_count_t(initial_parallelism - 1), node_count_t(1));
+        return std::min(used_helper_threads, thread_count_t(helpers_needed));
+    }
+
     dsp_thread_queue_ptr release_queue(void)
     {
         dsp_thread_queue_ptr ret(queue.release());
@@ -441,6 +604,8 @@ public:
         assert (i < std::numeric_limits<thread_count_t>::max());
         i = std::max(thread_count_t(1u), i);
         thread_count = i;
+        if (work_stealing)
+            thread_queues.reset(new thread_deque[thread_count]);
     }
 
     thread_count_t get_thread_count(void) const
@@ -453,8 +618,72 @@ public:
         return used_helper_threads;
     }
 
+    /** start recording one schedule_record per executed queue item into a
+     *  preallocated ring. cheap enough to leave running while hunting an
+     *  intermittent overrun; the ring keeps the most recent ticks. */
+    void start_schedule_recording(void)
+    {
+        if (!trace_buffer)
+            trace_buffer.reset(new schedule_record[trace_capacity]);
+        trace_cursor.store(0, std::memory_order_relaxed);
+        trace_active.store(true, std::memory_order_release);
+    }
+
+    void stop_schedule_recording(void)
+    {
+        trace_active.store(false, std::memory_order_release);
+    }
+
+    /** copy the recorded ring in chronological order. call after recording
+     *  has been stopped. */
+    std::size_t get_schedule_recording(schedule_record * out, std::size_t max_records) const
+    {
+        if (!trace_buffer)
+            return 0;
+        uint64_t end = trace_cursor.load(std::memory_order_acquire);
+        uint64_t begin = end > trace_capacity ? end - trace_capacity : 0;
+        std::size_t to_copy = std::min(std::size_t(end - begin), max_records);
+        uint64_t first = end - to_copy;
+        for (std::size_t i = 0; i != to_copy; ++i)
+            out[i] = trace_buffer[(first + i) & (trace_capacity - 1)];
+        return to_copy;
+    }
+
+    /** pin the schedule of one recorded tick: thread assignment and
+     *  per-thread order are taken from the records, dependencies are still
+     *  honoured by waiting. meant for offline (non real time) profiling of a
+     *  pathological schedule; the records must cover exactly the current
+     *  queue, one per item. */
+    bool load_replay_schedule(const schedule_record * records, std::size_t count)
+    {
+        if (!queue || count != total_node_count())
+            return false;
+
+        std::vector<std::vector<node_count_t>> schedule(thread_count);
+        for (std::size_t i = 0; i != count; ++i) {
+            schedule_record const & record = records[i];
+            if (record.item >= total_node_count() || record.thread >= thread_count)
+                return false;
+            schedule[record.thread].push_back(record.item);
+        }
+
+        replay_schedule = std::move(schedule);
+        replay_active = true;
+        return true;
+    }
+
+    void clear_replay_schedule(void)
+    {
+        replay_active = false;
+        replay_schedule.clear();
+    }
+
     void tick(thread_count_t thread_index)
     {
+        if (unlikely(replay_active)) {
+            run_replay(thread_index);
+            return;
+        }
         if (yield_if_busy)
             run_item<true>(thread_index);
         else
@@ -463,6 +692,7 @@ public:
 
 private:
     static const int max_backup_loops = 16384;
+    static const node_count_t park_threshold = 2; /* helpers park when at most this many nodes remain */
 
     struct backoff
     {
@@ -551,6 +781,14 @@ private:
             case no_remaining_items:
                 return;
             case fifo_empty:
+                /* elastic parking: at the tail of the tick the few remaining
+                 * nodes are already running on other threads, so helpers go
+                 * back to sleep on their semaphore instead of spinning until
+                 * the last node retires. the master cannot park - it has to
+                 * observe the end of the tick in wait_for_end. */
+                if (index != 0 &&
+                    node_count.load(std::memory_order_relaxed) <= park_threshold)
+                    return;
                 b.run();
                 ++poll_counts;
                 break;
@@ -578,6 +816,11 @@ private:
 public:
     void tick_master(void)
     {
+        if (unlikely(replay_active)) {
+            run_replay(0);
+            wait_for_end<false>();
+            return;
+        }
         if (yield_if_busy)
             run_item_master<true>();
         else
@@ -613,7 +856,7 @@ private:
     HOT int run_next_item(thread_count_t index)
     {
         dsp_thread_queue_item * item;
-        bool success = runnable_items.pop(item);
+        bool success = pop_runnable_item(item, index);
 
         if (!success)
             return fifo_empty;
@@ -621,6 +864,8 @@ private:
         node_count_t consumed = 0;
 
         do {
+            if (unlikely(trace_active.load(std::memory_order_relaxed)))
+                record_schedule(item, index);
             item = item->run(*this, index);
             consumed += 1;
         } while (item != nullptr);
@@ -635,11 +880,92 @@ private:
             return remaining_items;
     }
 
+    bool pop_runnable_item(dsp_thread_queue_item *& item, thread_count_t index)
+    {
+        if (!work_stealing)
+            return runnable_items.pop(item);
+
+        if (thread_queues[index].pop_bottom(item))
+            return true;
+        if (runnable_items.pop(item)) /* deque overflow ends up in the central queue */
+            return true;
+        return steal_work(item, index);
+    }
+
+    bool steal_work(dsp_thread_queue_item *& item, thread_count_t index)
+    {
+        const thread_count_t used_threads = used_helper_threads + 1;
+        for (thread_count_t offset = 1; offset < used_threads; ++offset) {
+            thread_deque & victim = thread_queues[(index + offset) % used_threads];
+            if (!victim.steal_top(item))
+                continue;
+
+            /* steal-half: migrate up to half of the victim's remaining items,
+             * so the next round of stealing is spread over both deques */
+            std::size_t steal_count = victim.size() / 2;
+            for (std::size_t i = 0; i != steal_count; ++i) {
+                dsp_thread_queue_item * extra;
+                if (!victim.steal_top(extra))
+                    break;
+                if (!thread_queues[index].push_bottom(extra)) {
+                    runnable_items.push(extra);
+                    break;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void record_schedule(dsp_thread_queue_item * item, thread_count_t index)
+    {
+        using namespace std::chrono;
+        uint64_t slot = trace_cursor.fetch_add(1, std::memory_order_relaxed);
+        schedule_record & record = trace_buffer[slot & (trace_capacity - 1)];
+        record.tick = tick_serial;
+        record.item = uint16_t(item - queue->items.begin());
+        record.thread = uint8_t(index);
+        record.time_ns = uint32_t(duration_cast<nanoseconds>(high_resolution_clock::now() - tick_start).count());
+    }
+
+    void run_replay(thread_count_t index)
+    {
+        if (index >= replay_schedule.size())
+            return;
+
+        backoff b(8, max_backup_loops);
+        for (node_count_t item_index : replay_schedule[index]) {
+            dsp_thread_queue_item * item = &queue->items[item_index];
+
+            int poll_counts = 0;
+            while (!item->ready()) {
+                b.run();
+                if (++poll_counts == watchdog_iterations) {
+                    std::printf("nova::dsp_queue_interpreter::run_replay: replayed schedule does not satisfy dependencies\n");
+                    return;
+                }
+            }
+            b.reset();
+
+            item->run_pinned(index);
+            node_count.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
     void mark_as_runnable(dsp_thread_queue_item * item)
     {
         runnable_items.push(item);
     }
 
+    void mark_as_runnable(dsp_thread_queue_item * item, thread_count_t thread_index)
+    {
+        if (work_stealing) {
+            if (!thread_queues[thread_index].push_bottom(item))
+                runnable_items.push(item); /* overflow to the central queue */
+        } else
+            runnable_items.push(item);
+    }
+
     friend class nova::dsp_thread_queue_item<runnable, Alloc>;
 
 private:
@@ -655,9 +981,26 @@ private:
     thread_count_t used_helper_threads; /* number of helper threads, which are actually used */
 
     boost::lockfree::stack<dsp_thread_queue_item*,  boost::lockfree::capacity<32768> > runnable_items;
+
+    typedef work_stealing_deque<dsp_thread_queue_item*> thread_deque;
+    std::unique_ptr<thread_deque[]> thread_queues; /* one deque per dsp thread, work-stealing mode only */
+
     std::atomic<node_count_t> node_count = {0}; /* number of nodes, that need to be processed during this tick */
+    node_count_t initial_parallelism = 0;       /* number of initially runnable items of the current tick */
     int watchdog_iterations;
     bool yield_if_busy;
+    bool work_stealing;
+
+    /* schedule record/replay, for performance debugging */
+    static const std::size_t trace_capacity = 65536; /* power of two */
+    std::unique_ptr<schedule_record[]> trace_buffer; /* allocated on first use */
+    std::atomic<uint64_t> trace_cursor = {0};
+    std::atomic<bool> trace_active = {false};
+    uint32_t tick_serial = 0;
+    std::chrono::high_resolution_clock::time_point tick_start;
+
+    bool replay_active = false;
+    std::vector<std::vector<node_count_t>> replay_schedule; /* per-thread item indices, in run order */
 };
 
 } /* namespace nova */
@@ -0,0 +1,141 @@
+//  dsp thread wakeup gate
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; see the file COPYING.  If not, write to
+//  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+//  Boston, MA 02111-1307, USA.
+
+#ifndef DSP_THREAD_QUEUE_THREAD_GATE_HPP
+#define DSP_THREAD_QUEUE_THREAD_GATE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#include "nova-tt/pause.hpp"
+
+namespace nova {
+
+/** wakeup gate for the dsp helper threads
+ *
+ *  replaces one semaphore per helper thread. the master bumps a generation
+ *  counter and issues a single wake for all helpers needed this cycle - one
+ *  futex syscall on linux, one broadcast elsewhere - instead of a cascade of
+ *  per-thread posts at every dsp tick.
+ *
+ *  before parking, helpers spin on the generation counter. the spin budget
+ *  adapts per thread: while wakeups keep arriving within the spin window (a
+ *  consistently loaded graph running at audio rate), the budget grows so the
+ *  helper is already running when work appears; once a thread had to park
+ *  anyway, the budget shrinks again so an idle server does not burn cpu.
+ */
+class thread_gate
+{
+public:
+    /** per-waiter state, owned by the helper thread */
+    struct wait_state
+    {
+        uint32_t generation = 0;
+        int spin_budget     = initial_spin;
+    };
+
+    thread_gate(void)               = default;
+    thread_gate(thread_gate const &)            = delete;
+    thread_gate & operator=(thread_gate const &) = delete;
+
+    /** wake up to \a count parked helpers. called by the master thread */
+    void wake(unsigned int count)
+    {
+        generation_.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+        syscall(SYS_futex, &generation_, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+        {
+            /* taking the mutex orders the generation bump against the
+             * predicate check in wait(), so no wakeup can be lost */
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        if (count == 1)
+            condition_.notify_one();
+        else
+            condition_.notify_all();
+#endif
+    }
+
+    /** wake every parked helper, used for thread shutdown */
+    void wake_all(void)
+    {
+#ifdef __linux__
+        wake(INT_MAX);
+#else
+        wake(UINT_MAX);
+#endif
+    }
+
+    /** block until the generation counter moves past \a state */
+    void wait(wait_state & state)
+    {
+        for (int i = 0; i != state.spin_budget; ++i) {
+            if (try_consume(state)) {
+                state.spin_budget = std::min(std::max(state.spin_budget * 2, initial_spin), max_spin);
+                return;
+            }
+            nova::detail::pause();
+        }
+        state.spin_budget = std::max(state.spin_budget / 2, 0);
+
+#ifdef __linux__
+        while (!try_consume(state)) {
+            const uint32_t expected = state.generation;
+            syscall(SYS_futex, &generation_, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+        }
+#else
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [&] { return try_consume(state); });
+#endif
+    }
+
+private:
+    bool try_consume(wait_state & state)
+    {
+        const uint32_t current = generation_.load(std::memory_order_acquire);
+        if (current == state.generation)
+            return false;
+        state.generation = current;
+        return true;
+    }
+
+    static const int initial_spin = 64;
+    static const int max_spin     = 16384;
+
+    std::atomic<uint32_t> generation_ = {0};
+
+#ifndef __linux__
+    std::mutex mutex_;
+    std::condition_variable condition_;
+#endif
+};
+
+} /* namespace nova */
+
+#endif /* DSP_THREAD_QUEUE_THREAD_GATE_HPP */
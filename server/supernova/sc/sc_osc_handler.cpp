@@ -33,11 +33,18 @@
 
 #include "SC_OSC_Commands.h"
 #include "SC_Version.hpp"
+#include "../../common/SC_SampleRateConverter.hpp"	// for the quality presets
 
 #ifdef _WIN32
 #include "malloc.h" // for alloca
 #endif
 
+#ifdef __linux__
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
 namespace nova {
 
 using namespace std;
@@ -443,6 +450,18 @@ struct cmd_dispatcher:
     {
         instance->add_sync_callback( new fn_sync_callback<Functor>( std::forward<Functor>(f) ) );
     }
+
+    template <typename Functor>
+    static void fire_disk_callback(int buffer_index, Functor const & f)
+    {
+        instance->add_disk_callback(new fn_system_callback<Functor>(f), buffer_index);
+    }
+
+    template <typename Functor>
+    static void fire_disk_callback(int buffer_index, Functor && f)
+    {
+        instance->add_disk_callback( new fn_system_callback<Functor>( std::forward<Functor>(f) ), buffer_index );
+    }
 };
 
 
@@ -488,6 +507,19 @@ struct cmd_dispatcher<false>:
         Functor fn ( std::forward<Functor>(f) );
         fn();
     }
+
+    template <typename Functor>
+    static void fire_disk_callback(int buffer_index, Functor const & f)
+    {
+        f();
+    }
+
+    template <typename Functor>
+    static void fire_disk_callback(int buffer_index, Functor && f)
+    {
+        Functor fn ( std::forward<Functor>(f) );
+        fn();
+    }
 };
 
 void report_failure(endpoint_ptr const & endpoint, std::exception const & error, const char * command)
@@ -713,14 +745,25 @@ void sc_scheduled_bundles::bundle_node::run(void)
 void sc_scheduled_bundles::insert_bundle(time_tag const & timeout, const char * data, size_t length,
                                          endpoint_ptr const & endpoint)
 {
-    /* allocate chunk from realtime pool */
-    void * chunk = rt_pool.malloc(sizeof(bundle_node) + length+4);
+    const size_t required = sizeof(bundle_node) + length+4;
+    const bool pooled = required <= pooled_chunk_size;
+
+    void * chunk;
+    if (pooled && node_cache) {
+        /* reuse a cached chunk */
+        chunk = node_cache;
+        node_cache = node_cache->next;
+        --node_cache_size;
+    } else
+        /* allocate chunk from realtime pool */
+        chunk = rt_pool.malloc(pooled ? pooled_chunk_size : required);
+
     bundle_node * node = (bundle_node*)chunk;
     char * cpy = (char*)chunk + sizeof(bundle_node);
 
     memcpy(cpy, data - 4, length+4);
 
-    new(node) bundle_node(timeout, cpy, endpoint);
+    new(node) bundle_node(timeout, cpy, endpoint, pooled);
 
     bundle_q.insert(*node);
 }
@@ -730,8 +773,7 @@ void sc_scheduled_bundles::execute_bundles(time_tag const & last, time_tag const
     World * world = &sc_factory->world;
 
     while(!bundle_q.empty()) {
-        bundle_node & front = *bundle_q.top();
-        time_tag const & next_timestamp = front.timeout_;
+        const time_tag next_timestamp = bundle_q.top()->timeout_;
 
         if (now < next_timestamp)
             break;
@@ -749,8 +791,11 @@ void sc_scheduled_bundles::execute_bundles(time_tag const & last, time_tag const
         } else
             world->mSampleOffset = world->mSubsampleOffset = 0;
 
-        front.run();
-        bundle_q.erase_and_dispose(bundle_q.top(), &dispose_bundle);
+        // run every bundle scheduled for this timestamp before touching the offsets again
+        do {
+            bundle_q.top()->run();
+            bundle_q.erase_and_dispose(bundle_q.top(), [this](bundle_node * node) { dispose_bundle(node); });
+        } while (!bundle_q.empty() && bundle_q.top()->timeout_ == next_timestamp);
     }
 
     world->mSampleOffset = world->mSubsampleOffset = 0;
@@ -804,6 +849,9 @@ bool sc_osc_handler::open_socket(int family, int type, int protocol, unsigned in
     return false;
 }
 
+sc_osc_handler::~sc_osc_handler()
+{}
+
 void sc_osc_handler::start_receive_udp()
 {
     using namespace boost;
@@ -813,6 +861,77 @@ void sc_osc_handler::start_receive_udp()
                      asio::placeholders::error, asio::placeholders::bytes_transferred));
 }
 
+#ifdef __linux__
+
+/* fixed pool of datagram buffers for batched receives, allocated on first use */
+struct sc_osc_handler::udp_receive_batch
+{
+    static const int capacity = 64;
+    static const int datagram_size = 1 << 15;
+
+    char buffers[capacity][datagram_size];
+    sockaddr_storage addresses[capacity];
+    iovec iov[capacity];
+    mmsghdr messages[capacity];
+};
+
+void sc_osc_handler::udp_receive_batch_deleter::operator()(udp_receive_batch * batch) const
+{
+    delete batch;
+}
+
+namespace {
+
+udp::endpoint endpoint_from_sockaddr(sockaddr_storage const & addr)
+{
+    using namespace boost::asio;
+    if (addr.ss_family == AF_INET) {
+        sockaddr_in const & in = reinterpret_cast<sockaddr_in const &>(addr);
+        return udp::endpoint(ip::address_v4(ntohl(in.sin_addr.s_addr)), ntohs(in.sin_port));
+    } else {
+        sockaddr_in6 const & in6 = reinterpret_cast<sockaddr_in6 const &>(addr);
+        ip::address_v6::bytes_type bytes;
+        memcpy(bytes.data(), in6.sin6_addr.s6_addr, 16);
+        return udp::endpoint(ip::address_v6(bytes, in6.sin6_scope_id), ntohs(in6.sin6_port));
+    }
+}
+
+} /* namespace */
+
+void sc_osc_handler::drain_received_udp()
+{
+    if (!udp_batch_)
+        udp_batch_.reset(new udp_receive_batch());
+    udp_receive_batch & batch = *udp_batch_;
+
+    const int fd = sc_notify_observers::udp_socket.native_handle();
+    for (;;) {
+        /* the kernel updates msg_namelen and msg_len, so rebuild each round */
+        for (int i = 0; i != udp_receive_batch::capacity; ++i) {
+            batch.iov[i].iov_base = batch.buffers[i];
+            batch.iov[i].iov_len = udp_receive_batch::datagram_size;
+            memset(&batch.messages[i].msg_hdr, 0, sizeof(msghdr));
+            batch.messages[i].msg_hdr.msg_iov = &batch.iov[i];
+            batch.messages[i].msg_hdr.msg_iovlen = 1;
+            batch.messages[i].msg_hdr.msg_name = &batch.addresses[i];
+            batch.messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        }
+
+        int received = recvmmsg(fd, batch.messages, udp_receive_batch::capacity, MSG_DONTWAIT, nullptr);
+        if (received <= 0)
+            return;
+
+        for (int i = 0; i != received; ++i)
+            handle_packet_async(batch.buffers[i], batch.messages[i].msg_len,
+                                std::make_shared<udp_endpoint>(endpoint_from_sockaddr(batch.addresses[i])));
+
+        if (received != udp_receive_batch::capacity)
+            return;
+    }
+}
+
+#endif /* __linux__ */
+
 void sc_osc_handler::handle_receive_udp(const boost::system::error_code& error,
                                         std::size_t bytes_transferred)
 {
@@ -827,6 +946,13 @@ void sc_osc_handler::handle_receive_udp(const boost::system::error_code& error,
 
     handle_packet_async(recv_buffer_.begin(), bytes_transferred, make_shared<udp_endpoint>(udp_remote_endpoint_));
 
+#ifdef __linux__
+    /* asio dispatches one datagram per handler invocation; under load the
+     * socket queue holds many more, so drain them now in batches instead of
+     * paying the handler round trip per message */
+    drain_received_udp();
+#endif
+
     start_receive_udp();
     return;
 }
@@ -1162,6 +1288,7 @@ void handle_sync(ReceivedMessage const & message, endpoint_ptr const & endpoint)
 
     // ping pong: we go through the nrt->rt channel to ensure that earlier messages have been completely dispatched
     cmd_dispatcher<realtime>::fire_system_callback([=, endpoint=endpoint_ptr(endpoint)]() {
+        instance->wait_for_disk_callbacks(); // barrier for buffer commands, which run concurrently
         cmd_dispatcher<realtime>::fire_rt_callback([=, endpoint=endpoint_ptr(endpoint)]() {
             cmd_dispatcher<realtime>::fire_io_callback([=, endpoint=endpoint_ptr(endpoint)]() {
                 char buffer[128];
@@ -1941,6 +2068,81 @@ void handle_n_order(ReceivedMessage const & msg)
     instance->request_dsp_queue_update();
 }
 
+bool node_is_ancestor_of(server_node * node, server_node * other)
+{
+    for (abstract_group * parent = other->get_parent(); parent; parent = parent->get_parent()) {
+        if (parent == node)
+            return true;
+    }
+    return false;
+}
+
+void handle_n_move(ReceivedMessage const & msg)
+{
+    /* transactional bulk move: every [action, target, node] triple is
+     * validated against the current tree before any edit is applied, so a bad
+     * entry cannot leave a scene change half done. all moves share the single
+     * deferred dsp queue rebuild. */
+    osc::ReceivedMessageArgumentStream check = msg.ArgumentStream();
+
+    while (!check.Eos()) {
+        osc::int32 action, target_id, node_id;
+        check >> action >> target_id >> node_id;
+
+        server_node * target = find_node(target_id);
+        if (target == nullptr)
+            throw std::runtime_error("n_move: target node not found");
+
+        server_node * node = find_node(node_id);
+        if (node == nullptr)
+            throw std::runtime_error("n_move: node not found");
+
+        if (node->get_parent() == nullptr)
+            throw std::runtime_error("n_move: cannot move the root group");
+
+        if (action == head || action == tail) {
+            if (target->is_synth())
+                throw std::runtime_error("n_move: target is no group");
+        } else if (action != before && action != after)
+            throw std::runtime_error("n_move: invalid add action");
+
+        if (node == target || node_is_ancestor_of(node, target))
+            throw std::runtime_error("n_move: group cannot be moved into itself");
+    }
+
+    osc::ReceivedMessageArgumentStream args = msg.ArgumentStream();
+
+    while (!args.Eos()) {
+        osc::int32 action, target_id, node_id;
+        args >> action >> target_id >> node_id;
+
+        server_node * node = find_node(node_id);
+        server_node * target = find_node(target_id);
+
+        switch (action) {
+        case head:
+            abstract_group::move_to_head_or_tail<head>(node, static_cast<abstract_group*>(target));
+            break;
+
+        case tail:
+            abstract_group::move_to_head_or_tail<tail>(node, static_cast<abstract_group*>(target));
+            break;
+
+        case before:
+            abstract_group::move_before_or_after<before>(node, target);
+            break;
+
+        case after:
+            abstract_group::move_before_or_after<after>(node, target);
+            break;
+        }
+
+        instance->notification_node_moved(node);
+    }
+
+    instance->request_dsp_queue_update();
+}
+
 
 void handle_n_run(ReceivedMessage const & msg)
 {
@@ -2233,7 +2435,7 @@ void handle_b_alloc(ReceivedMessage const & msg, endpoint_ptr endpoint)
 
     completion_message message = extract_completion_message(args);
 
-    cmd_dispatcher<realtime>::fire_system_callback( [=, message = std::move(message) ] () mutable {
+    cmd_dispatcher<realtime>::fire_disk_callback( bufferIndex, [=, message = std::move(message) ] () mutable {
         sc_ugen_factory::buffer_lock_t buffer_lock(sc_factory->buffer_guard( bufferIndex ));
         try {
             sample * free_buf = sc_factory->get_nrt_mirror_buffer(bufferIndex);
@@ -2244,7 +2446,7 @@ void handle_b_alloc(ReceivedMessage const & msg, endpoint_ptr endpoint)
                 handle_completion_message( std::move(message), endpoint );
 
                 cmd_dispatcher<realtime>::fire_system_callback( [=]{
-                    free_aligned(free_buf);
+                    sc_factory->free_buffer_payload(free_buf);
                     send_done_message(endpoint, "/b_alloc", bufferIndex);
                 });
             });
@@ -2266,7 +2468,7 @@ void handle_b_free(ReceivedMessage const & msg, endpoint_ptr endpoint)
 
     completion_message message = extract_completion_message(args);
 
-    cmd_dispatcher<realtime>::fire_system_callback( [=, message = std::move(message) ] () mutable {
+    cmd_dispatcher<realtime>::fire_disk_callback( index, [=, message = std::move(message) ] () mutable {
         sc_ugen_factory::buffer_lock_t buffer_lock(sc_factory->buffer_guard(index));
         sample * free_buf = sc_factory->get_nrt_mirror_buffer(index);
         sc_factory->free_buffer(index);
@@ -2277,7 +2479,7 @@ void handle_b_free(ReceivedMessage const & msg, endpoint_ptr endpoint)
             handle_completion_message( std::move(message), endpoint );
 
             cmd_dispatcher<realtime>::fire_system_callback( [=] {
-                free_aligned(free_buf);
+                sc_factory->free_buffer_payload(free_buf);
                 send_done_message(endpoint, "/b_free", index);
             });
         });
@@ -2307,7 +2509,7 @@ void handle_b_allocRead(ReceivedMessage const & msg, endpoint_ptr endpoint)
     completion_message message = extract_completion_message(args);
     movable_string filename( filenameString );
 
-    cmd_dispatcher<realtime>::fire_system_callback([ =,
+    cmd_dispatcher<realtime>::fire_disk_callback(bufferIndex, [ =,
                                                      filename = std::move(filename),
                                                      message  = std::move(message)
                                                    ] () mutable {
@@ -2326,7 +2528,7 @@ void handle_b_allocRead(ReceivedMessage const & msg, endpoint_ptr endpoint)
                 consume( std::move(filename) );
 
                 cmd_dispatcher<realtime>::fire_system_callback( [=] {
-                    free_aligned(free_buf);
+                    sc_factory->free_buffer_payload(free_buf);
                     send_done_message(endpoint, "/b_allocRead", bufferIndex);
                 });
             });
@@ -2339,6 +2541,64 @@ void handle_b_allocRead(ReceivedMessage const & msg, endpoint_ptr endpoint)
 }
 
 
+template <bool realtime>
+void handle_b_allocReadResample(ReceivedMessage const & msg, endpoint_ptr endpoint)
+{
+    osc::ReceivedMessageArgumentStream args = msg.ArgumentStream();
+
+    osc::int32 bufferIndex;
+    const char * filenameString;
+
+    osc::int32 start = 0;
+    osc::int32 frames = 0;
+    osc::int32 quality = kResampleBest;
+
+    args >> bufferIndex >> filenameString;
+
+    if (!args.Eos())
+        args >> start;
+
+    if (!args.Eos())
+        args >> frames;
+
+    if (!args.Eos())
+        args >> quality;
+
+    completion_message message = extract_completion_message(args);
+    movable_string filename( filenameString );
+
+    cmd_dispatcher<realtime>::fire_disk_callback(bufferIndex, [ =,
+                                                     filename = std::move(filename),
+                                                     message  = std::move(message)
+                                                   ] () mutable {
+        sc_ugen_factory::buffer_lock_t buffer_lock(sc_factory->buffer_guard( bufferIndex ));
+        sample * free_buf = sc_factory->get_nrt_mirror_buffer(bufferIndex);
+        try {
+            sc_factory->buffer_read_alloc_resample(bufferIndex, filename.c_str(), start, frames, quality);
+
+            cmd_dispatcher<realtime>::fire_rt_callback( [ =,
+                                                          filename = std::move(filename),
+                                                          message  = std::move(message)
+                                                        ] () mutable {
+                sc_factory->buffer_sync(bufferIndex);
+
+                handle_completion_message( std::move(message), endpoint );
+                consume( std::move(filename) );
+
+                cmd_dispatcher<realtime>::fire_system_callback( [=] {
+                    sc_factory->free_buffer_payload(free_buf);
+                    send_done_message(endpoint, "/b_allocReadResample", bufferIndex);
+                });
+            });
+
+        } catch (std::exception const & error) {
+            cmd_dispatcher<realtime>::free_in_rt_thread( std::move( message ), std::move( filename ) );
+            report_failure(endpoint, error, "/b_allocReadResample", bufferIndex);
+        }
+    });
+}
+
+
 template <bool realtime>
 void handle_b_allocReadChannel(ReceivedMessage const & msg, endpoint_ptr endpoint)
 {
@@ -2369,7 +2629,7 @@ void handle_b_allocReadChannel(ReceivedMessage const & msg, endpoint_ptr endpoin
     movable_array<uint32_t> channel_mapping(channel_count, channels.c_array());
     movable_string filename(filenameString);
 
-    cmd_dispatcher<realtime>::fire_system_callback( [ =, message=std::move(message),
+    cmd_dispatcher<realtime>::fire_disk_callback( bufnum, [ =, message=std::move(message),
                                                     channel_mapping=std::move(channel_mapping), filename=std::move(filename) ] () mutable {
         sc_ugen_factory::buffer_lock_t buffer_lock(sc_factory->buffer_guard(bufnum));
         sample * free_buf = sc_factory->get_nrt_mirror_buffer(bufnum);
@@ -2386,7 +2646,7 @@ void handle_b_allocReadChannel(ReceivedMessage const & msg, endpoint_ptr endpoin
                 handle_completion_message( std::move(message), endpoint );
 
                 cmd_dispatcher<realtime>::fire_system_callback( [=] {
-                    free_aligned(free_buf);
+                    sc_factory->free_buffer_payload(free_buf);
                     send_done_message(endpoint, "/b_allocReadChannel", bufnum);
                 });
             });
@@ -2452,7 +2712,7 @@ fire_callback:
     movable_string headerString(header_format);
     movable_string sampleString(sample_format);
 
-    cmd_dispatcher<realtime>::fire_system_callback( [=, message = std::move(message),       filenameString = std::move(filenameString),
+    cmd_dispatcher<realtime>::fire_disk_callback( bufnum, [=, message = std::move(message), filenameString = std::move(filenameString),
                                                     headerString = std::move(headerString), sampleString = std::move(sampleString)
                                                     ] () mutable {
 
@@ -2529,7 +2789,7 @@ void handle_b_read(ReceivedMessage const & msg, endpoint_ptr endpoint)
 fire_callback:
     movable_string fname(filename);
 
-    cmd_dispatcher<realtime>::fire_system_callback( [=, filename = std::move(fname),
+    cmd_dispatcher<realtime>::fire_disk_callback( bufnum, [=, filename = std::move(fname),
                                                         message = std::move(message) ] () mutable {
 
         sc_ugen_factory::buffer_lock_t buffer_lock( sc_factory->buffer_guard(bufnum) );
@@ -2632,7 +2892,7 @@ fire_callback:
 
     movable_array<uint32_t> channel_map(channel_count, channel_mapping.c_array());
 
-    cmd_dispatcher<realtime>::fire_system_callback( [ =, message=std::move(message),
+    cmd_dispatcher<realtime>::fire_disk_callback( bufnum, [ =, message=std::move(message),
                                                     filename = std::move(fname), channel_map = std::move( channel_map ) ] () mutable {
         try {
             sc_factory->buffer_read_channel(bufnum, filename.c_str(), start_file, frames, start_buffer, leave_open,
@@ -2666,7 +2926,7 @@ void handle_b_zero(ReceivedMessage const & msg, endpoint_ptr endpoint)
     args >> index;
     completion_message message = extract_completion_message(args);
 
-    cmd_dispatcher<realtime>::fire_system_callback( [ =, message = std::move(message) ] () mutable {
+    cmd_dispatcher<realtime>::fire_disk_callback( index, [ =, message = std::move(message) ] () mutable {
         sc_factory->buffer_zero(index);
         cmd_dispatcher<realtime>::fire_rt_callback( [ =, message = std::move(message) ] () mutable {
             sc_factory->increment_write_updates(index);
@@ -2789,7 +3049,7 @@ void handle_b_close(ReceivedMessage const & msg, endpoint_ptr endpoint)
     args >> index;
 
     completion_message message = extract_completion_message(args);
-    cmd_dispatcher<realtime>::fire_system_callback( [ =, message = std::move(message) ] () mutable {
+    cmd_dispatcher<realtime>::fire_disk_callback( index, [ =, message = std::move(message) ] () mutable {
         sc_factory->buffer_close(index);
 
         cmd_dispatcher<realtime>::fire_rt_callback( [ =, message = std::move(message) ] () mutable {
@@ -2916,7 +3176,11 @@ void handle_b_gen(ReceivedMessage const & msg, size_t msg_size, endpoint_ptr end
 {
     movable_array<char> cmd (msg_size, msg.AddressPattern());
 
-    cmd_dispatcher<realtime>::fire_system_callback( [=, message=std::move(cmd)] () mutable {
+    // peek at the buffer index, so the command is sequenced with the other
+    // commands for this buffer; the full validation happens in the callback
+    osc::int32 bufferIndex = msg.ArgumentsBegin()->AsInt32();
+
+    cmd_dispatcher<realtime>::fire_disk_callback( bufferIndex, [=, message=std::move(cmd)] () mutable {
 
         const char * data = (char*)message.data();
         const char * msg_data = OSCstrskip(data); // skip address
@@ -2946,7 +3210,7 @@ void handle_b_gen(ReceivedMessage const & msg, size_t msg_size, endpoint_ptr end
             sc_factory->buffer_sync(index);
 
             cmd_dispatcher<realtime>::fire_system_callback([=] {
-                free_aligned(free_buf);
+                sc_factory->free_buffer_payload(free_buf);
                 send_done_message(endpoint, "/b_gen", index);
             });
         });
@@ -3368,6 +3632,10 @@ void sc_osc_handler::handle_message_int_address(ReceivedMessage const & message,
         handle_n_order(message);
         break;
 
+    case cmd_n_move:
+        handle_n_move(message);
+        break;
+
     case cmd_n_run:
         handle_n_run(message);
         break;
@@ -3404,6 +3672,10 @@ void sc_osc_handler::handle_message_int_address(ReceivedMessage const & message,
         handle_b_allocReadChannel<realtime>(message, endpoint);
         break;
 
+    case cmd_b_allocReadResample:
+        handle_b_allocReadResample<realtime>(message, endpoint);
+        break;
+
     case cmd_b_read:
         handle_b_read<realtime>(message, endpoint);
         break;
@@ -3613,6 +3885,11 @@ void dispatch_node_commands(const char * address, ReceivedMessage const & messag
         return;
     }
 
+    if (strcmp(address+3, "move") == 0) {
+        handle_n_move(message);
+        return;
+    }
+
     if (strcmp(address+3, "query") == 0) {
         handle_n_query<realtime>(message, endpoint);
         return;
@@ -3649,6 +3926,10 @@ void dispatch_buffer_commands(const char * address, ReceivedMessage const & mess
         handle_b_allocReadChannel<realtime>(message, endpoint);
         return;
     }
+    if (strcmp(address+3, "allocReadResample") == 0) {
+        handle_b_allocReadResample<realtime>(message, endpoint);
+        return;
+    }
 
     if (strcmp(address+3, "read") == 0) {
         handle_b_read<realtime>(message, endpoint);
@@ -20,6 +20,7 @@
 #define SERVER_SC_OSC_HANDLER_HPP
 
 #include <algorithm>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -163,8 +164,8 @@ public:
     struct bundle_node:
         public boost::intrusive::bs_set_base_hook<>
     {
-        bundle_node(time_tag const & timeout, const char * data, endpoint_ptr const & endpoint):
-            timeout_(timeout), data_(data), endpoint_(endpoint)
+        bundle_node(time_tag const & timeout, const char * data, endpoint_ptr const & endpoint, bool pooled):
+            timeout_(timeout), data_(data), endpoint_(endpoint), pooled_(pooled)
         {}
 
         void run(void);
@@ -172,6 +173,7 @@ public:
         const time_tag timeout_;
         const char * const data_;
         endpoint_ptr endpoint_;
+        const bool pooled_; // chunk came from the node cache, not straight from rt_pool
 
         friend bool operator< (const bundle_node & lhs, const bundle_node & rhs)
         {
@@ -186,6 +188,20 @@ public:
 
     typedef boost::intrusive::treap_multiset<bundle_node> bundle_queue_t;
 
+    sc_scheduled_bundles(void):
+        node_cache(nullptr), node_cache_size(0)
+    {}
+
+    ~sc_scheduled_bundles(void)
+    {
+        clear_bundles();
+        while (node_cache) {
+            cached_chunk * chunk = node_cache;
+            node_cache = chunk->next;
+            rt_pool.free(chunk);
+        }
+    }
+
     void insert_bundle(time_tag const & timeout, const char * data, size_t length,
                        endpoint_ptr const & endpoint);
 
@@ -193,17 +209,37 @@ public:
 
     void clear_bundles(void)
     {
-        bundle_q.clear_and_dispose(dispose_bundle);
+        bundle_q.clear_and_dispose([this](bundle_node * node) { dispose_bundle(node); });
     }
 
-    static void dispose_bundle(bundle_node * node)
+    void dispose_bundle(bundle_node * node)
     {
+        const bool pooled = node->pooled_;
         node->~bundle_node();
-        rt_pool.free(node);
+        if (pooled && node_cache_size < max_cached_chunks) {
+            cached_chunk * chunk = (cached_chunk*)node;
+            chunk->next = node_cache;
+            node_cache = chunk;
+            ++node_cache_size;
+        } else
+            rt_pool.free(node);
     }
 
 private:
+    /* slab cache of fixed-size node chunks. bundle allocation and disposal happen on the
+     * dsp thread only, so a plain intrusive list suffices. chunks large enough for the
+     * typical scheduled message are recycled here instead of cycling through rt_pool. */
+    static const size_t pooled_chunk_size = 256;
+    static const size_t max_cached_chunks = 512;
+
+    struct cached_chunk
+    {
+        cached_chunk * next;
+    };
+
     bundle_queue_t bundle_q;
+    cached_chunk * node_cache;
+    size_t node_cache_size;
 };
 
 class sc_osc_handler:
@@ -231,6 +267,8 @@ public:
         }
     }
 
+    ~sc_osc_handler();
+
     void start_receive_thread(void)
     {
         detail::network_thread::start_receive();
@@ -268,6 +306,19 @@ private:
     /** udp socket handling */
     void start_receive_udp();
     void handle_receive_udp(const boost::system::error_code& error, std::size_t bytes_transferred);
+#ifdef __linux__
+    /** once asio reports one datagram, pull everything else queued on the
+     *  socket in batches of one recvmmsg syscall */
+    void drain_received_udp();
+    struct udp_receive_batch;
+    /* out-of-line deleter: the batch struct is only complete in the .cpp, and
+     * the inline constructor above can throw, which would otherwise instantiate
+     * a default_delete of the incomplete type in every including translation unit */
+    struct udp_receive_batch_deleter {
+        void operator()(udp_receive_batch * batch) const;
+    };
+    std::unique_ptr<udp_receive_batch, udp_receive_batch_deleter> udp_batch_;
+#endif
     /* @} */
 
     /* @{ */
@@ -40,6 +40,7 @@
 #include "SC_fftlib.h"
 #include "SC_Lock.h"
 #include "../../common/Samp.hpp"
+#include "../../common/SC_SampleRateConverter.hpp"
 #include "../../common/SC_SndFileHelpers.hpp"
 
 #include <boost/math/constants/constants.hpp>
@@ -48,6 +49,8 @@
 #undef scfft_create
 #undef scfft_dofft
 #undef scfft_doifft
+#undef scfft_dofft_batch
+#undef scfft_doifft_batch
 #undef scfft_destroy
 
 namespace nova {
@@ -473,6 +476,71 @@ int print(const char *fmt, ...)
     return (status == true) ? 0 : -1;
 }
 
+// fPrint already routes through the asynchronous log, so the real time safe
+// variant only differs in signature (the world argument is unused here).
+int rt_print(World *world, const char *fmt, ...)
+{
+    va_list vargs;
+    va_start(vargs, fmt);
+
+    nova::log_guard.lock();
+    bool status = nova::instance->log_printf(fmt, vargs);
+    nova::log_guard.unlock();
+
+    va_end(vargs);
+    return (status == true) ? 0 : -1;
+}
+
+/* per-thread scratch arena backing fScratchAlloc. each dsp helper thread owns
+ * one through thread-local storage (the same idea as utilities/tl_allocator.hpp,
+ * but a plain bump pointer: block-scoped lifetimes need no free list). the
+ * arena is reclaimed lazily when mBufCounter advances and only grows while no
+ * scratch pointers are outstanding. */
+struct scratch_arena
+{
+    char * data;
+    size_t capacity;
+    size_t used;
+    int buf_epoch;
+};
+
+static thread_local scratch_arena thread_scratch = { nullptr, 0, 0, -1 };
+
+void * scratch_alloc(World * world, size_t bytes)
+{
+    const size_t initial_size = 1 << 16;
+    scratch_arena & arena = thread_scratch;
+    if (arena.buf_epoch != world->mBufCounter) {
+        arena.buf_epoch = world->mBufCounter;
+        arena.used = 0;
+    }
+    bytes = (bytes + 15) & ~size_t(15);
+    if (arena.used + bytes > arena.capacity) {
+        if (arena.used != 0)
+            return nullptr; /* exhausted mid-block: caller falls back to RTAlloc */
+        size_t new_size = std::max(2 * arena.capacity, initial_size);
+        while (new_size < bytes)
+            new_size <<= 1;
+        char * data = (char*)nova::malloc_aligned(new_size);
+        if (data == nullptr)
+            return nullptr;
+        nova::free_aligned(arena.data);
+        arena.data = data;
+        arena.capacity = new_size;
+    }
+    void * ptr = arena.data + arena.used;
+    arena.used += bytes;
+    return ptr;
+}
+
+void init_unit_rgen(struct Unit *unit, struct RGen *rgen)
+{
+    /* deterministic per-unit stream: the same graph rendered with the same
+     * world seed produces the same noise, independent of dsp parallelism */
+    rgen->init_stream(unit->mWorld->mRandSeed,
+                      uint32_t(unit->mParent->mNode.mID), uint32_t(unit->mParentIndex));
+}
+
 /* todo: we need to implement most of the done actions */
 void done_action(int done_action, struct Unit *unit)
 {
@@ -657,7 +725,10 @@ void sc_plugin_interface::initialize(server_arguments const & args, float * cont
     sc_interface.fGetNode = &get_node;
     sc_interface.fNodeRun = &node_set_run;
     sc_interface.fPrint = &print;
+    sc_interface.fRTPrint = &rt_print;
     sc_interface.fDoneAction = &done_action;
+    sc_interface.fInitUnitRGen = &init_unit_rgen;
+    sc_interface.fScratchAlloc = &scratch_alloc;
 
     /* sndfile functions */
 #ifdef NO_LIBSNDFILE
@@ -707,6 +778,8 @@ void sc_plugin_interface::initialize(server_arguments const & args, float * cont
     sc_interface.fSCfftDestroy = &scfft_destroy;
     sc_interface.fSCfftDoFFT = &scfft_dofft;
     sc_interface.fSCfftDoIFFT = &scfft_doifft;
+    sc_interface.fSCfftDoFFTBatch = &scfft_dofft_batch;
+    sc_interface.fSCfftDoIFFTBatch = &scfft_doifft_batch;
 
     /* scope API */
     sc_interface.fGetScopeBuffer = &get_scope_buffer;
@@ -733,6 +806,17 @@ void sc_plugin_interface::initialize(server_arguments const & args, float * cont
     world.mControlBusLock = new spin_lock();
     std::fill(world.mAudioBusTouched, world.mAudioBusTouched + args.audio_busses, -1);
 
+    if (args.bus_shadows && args.threads > 1) {
+        audio_busses.init_shadows(args.threads);
+        world.mAudioBusShadows = audio_busses.shadows;
+        world.mAudioBusShadowTouched = audio_busses.shadow_tags;
+        world.mNumDspThreads = args.threads;
+    } else {
+        world.mAudioBusShadows = nullptr;
+        world.mAudioBusShadowTouched = nullptr;
+        world.mNumDspThreads = 1;
+    }
+
     /* audio buffers */
     world.mNumSndBufs = args.buffers;
     world.mSndBufs = new SndBuf[world.mNumSndBufs];
@@ -778,6 +862,10 @@ void sc_plugin_interface::initialize(server_arguments const & args, float * cont
 
     for (int i=0; i<world.mNumRGens; ++i)
         world.mRGen[i].init(seeds[i]);
+
+    /* base seed for per-unit random streams. fixed in non real time mode so
+     * offline renders are bit-for-bit reproducible. */
+    world.mRandSeed = nrt_mode ? 0 : seeds[0];
 }
 
 void sc_plugin_interface::reset_sampling_rate(int sr)
@@ -825,15 +913,6 @@ sc_plugin_interface::~sc_plugin_interface(void)
 
 namespace {
 
-sample * allocate_buffer(size_t samples)
-{
-    const size_t alloc_size = samples * sizeof(sample);
-    sample * ret = (sample*)calloc_aligned(alloc_size);
-    if (ret)
-        mlock(ret, alloc_size);
-    return ret;
-}
-
 inline int32 bufmask(int32 x)
 {
     return (1 << (31 - CLZ(x))) - 1;
@@ -918,9 +997,11 @@ void sc_plugin_interface::allocate_buffer(SndBuf * buf, uint32_t frames, uint32_
     if (samples == 0)
         throw std::runtime_error( "invalid buffer size" );
 
-    sample * data = nova::allocate_buffer(samples);
+    const size_t alloc_size = samples * sizeof(sample);
+    sample * data = (sample*)payload_pool.allocate(alloc_size);
     if (data == nullptr)
         throw std::runtime_error( "could not allocate memory" );
+    mlock(data, alloc_size);
 
     buf->data       = data;
     buf->channels   = channels;
@@ -961,6 +1042,48 @@ void sc_plugin_interface::buffer_read_alloc(uint32_t index, const char * filenam
     f.readf(buf->data, frames);
 }
 
+void sc_plugin_interface::buffer_read_alloc_resample(uint32_t index, const char * filename, uint32_t start,
+                                                     uint32_t frames, int quality)
+{
+    SndfileHandle f(filename);
+    if (f.rawHandle() == nullptr)
+        throw std::runtime_error(f.strError());
+
+    const size_t sf_frames = f.frames();
+
+    if (start > sf_frames)
+        start = sf_frames;
+
+    if (frames == 0 || frames > sf_frames - start)
+        frames = sf_frames - start;
+
+    const double server_rate = world.mFullRate.mSampleRate;
+
+    SndBuf * buf = World_GetNRTBuf(&world, index);
+
+    if (double(f.samplerate()) == server_rate) {
+        // already at the server rate: behave exactly like /b_allocRead
+        allocate_buffer(buf, frames, f.channels(), f.samplerate());
+        f.seek(start, SEEK_SET);
+        f.readf(buf->data, frames);
+        return;
+    }
+
+    long out_frames = SC_ResampledFrames(frames, f.samplerate(), server_rate);
+    if (out_frames < 1)
+        out_frames = 1;
+
+    std::vector<float> raw(size_t(frames) * f.channels());
+    f.seek(start, SEEK_SET);
+    f.readf(raw.data(), frames);
+
+    allocate_buffer(buf, out_frames, f.channels(), server_rate);
+
+    if (!SC_ResampleBuffer(raw.data(), frames, f.channels(), f.samplerate(),
+                           buf->data, out_frames, server_rate, quality))
+        throw std::runtime_error("could not allocate resampling filter");
+}
+
 
 void sc_plugin_interface::buffer_alloc_read_channels(uint32_t index, const char * filename, uint32_t start,
                                                      uint32_t frames, uint32_t channel_count,
@@ -26,6 +26,7 @@
 #include "../server/node_types.hpp"
 #include "../server/synth.hpp"
 #include "../server/memory_pool.hpp"
+#include "../utilities/buffer_pool.hpp"
 
 #include "SC_InterfaceTable.h"
 #include "SC_World.h"
@@ -113,6 +114,8 @@ public:
     SndBuf* allocate_buffer(uint32_t index, uint32_t frames, uint32_t channels);
     void allocate_buffer(SndBuf * buf, uint32_t frames, uint32_t channels, double samplerate);
     void buffer_read_alloc(uint32_t index, const char * filename, uint32_t start, uint32_t frames);
+    void buffer_read_alloc_resample(uint32_t index, const char * filename, uint32_t start, uint32_t frames,
+                                    int quality);
     void buffer_alloc_read_channels(uint32_t index, const char * filename, uint32_t start, uint32_t frames, uint32_t channel_count,
                                     const uint32_t * channel_data);
     void buffer_read(uint32_t index, const char * filename, uint32_t start_file, uint32_t frames, uint32_t start_buffer,
@@ -150,6 +153,12 @@ public:
 
     void free_buffer(uint32_t index);
 
+    /** hand a detached SndBuf payload back to the recycling pool */
+    void free_buffer_payload(sample * data)
+    {
+        payload_pool.free(data);
+    }
+
     typedef std::lock_guard<std::mutex> buffer_lock_t;
 
     std::mutex & buffer_guard(size_t index)
@@ -164,6 +173,7 @@ public:
 
 private:
     boost::scoped_array<std::mutex> async_buffer_guards;
+    buffer_pool payload_pool;
     /* @} */
 
 public:
@@ -41,6 +41,7 @@ sc_synth::sc_synth(int node_id, sc_synth_definition_ptr const & prototype):
     mSampleOffset = world.mSampleOffset;
     mLocalAudioBusUnit = nullptr;
     mLocalControlBusUnit = nullptr;
+    mDspThreadIndex = 0;
 
     localBufNum = 0;
     localMaxBufNum = 0;
@@ -56,10 +57,17 @@ sc_synth::sc_synth(int node_id, sc_synth_definition_ptr const & prototype):
     const size_t wire_buffer_alignment = 64 * 8; // align to cache line boundaries
     const size_t alloc_size = prototype->memory_requirement();
 
-    const size_t sample_alloc_size = world.mBufLength * synthdef.buffer_count
+    /* individual wire buffers are padded to whole cache lines, so the audio
+     * buffers of parallel synths never share a line (matters for block sizes
+     * below 16 samples) */
+    wire_buffer_samples = pad_to_cache_line(world.mBufLength * sizeof(sample)) / sizeof(sample);
+
+    const size_t sample_alloc_size = wire_buffer_samples * synthdef.buffer_count
         + wire_buffer_alignment /* for alignment */;
 
-    const size_t total_alloc_size = alloc_size + sample_alloc_size*sizeof(sample);
+    /* the chunk is padded to a cache line multiple, so the trailing line is
+     * not shared with a neighboring pool allocation */
+    const size_t total_alloc_size = pad_to_cache_line(alloc_size + sample_alloc_size*sizeof(sample));
 
     char * raw_chunk = rt_synthesis ? (char*)rt_pool.malloc(total_alloc_size)
                                     : (char*)malloc(total_alloc_size);
@@ -90,6 +98,7 @@ sc_synth::sc_synth(int node_id, sc_synth_definition_ptr const & prototype):
         wire->mCalcRate = 0;
         wire->mBuffer = nullptr;
         wire->mScalarValue = get_constant(i);
+        wire->mDemandStamp = -1;
     }
 
     unit_count = prototype->unit_count();
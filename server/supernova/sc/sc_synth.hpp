@@ -227,6 +227,7 @@ private:
     int_fast8_t trace = 0;
     Unit ** calc_units;
     sample * unit_buffers = nullptr;
+    size_t wire_buffer_samples = 0;  /* stride between wire buffers, cache-line padded */
     int32_t calc_unit_count, unit_count;
 
     RGen rgen;
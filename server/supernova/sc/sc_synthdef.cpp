@@ -50,19 +50,21 @@ void verify_synthdef_buffer(const char * buffer, const char *buffer_end)
         throw std::runtime_error("corrupted synthdef");
 }
 
-std::string read_pstring(const char *& buffer, const char *buffer_end)
+/* reads a pascal string directly into the symbol table, without an
+ * intermediate std::string allocation */
+symbol read_symbol(const char *& buffer, const char *buffer_end)
 {
     verify_synthdef_buffer(buffer, buffer_end);
 
     char str[256+1];
-    char name_size = *buffer++;
+    unsigned char name_size = (unsigned char)*buffer++;
     verify_synthdef_buffer(buffer + name_size, buffer_end);
 
     memcpy(str, buffer, name_size);
     str[int(name_size)] = 0;
 
     buffer += name_size;
-    return std::string(str);
+    return symbol(str, name_size);
 }
 
 float read_float(const char *& buffer, const char *buffer_end)
@@ -136,7 +138,7 @@ std::vector<sc_synthdef> read_synthdefs(const char * buffer, const char * buffer
 #ifdef __clang__
             // clang does not like to emplace_back
             sc_synthdef def(buffer, buffer_end, version);
-            ret.push_back(def);
+            ret.push_back(std::move(def));
 #else
             ret.emplace_back(buffer, buffer_end, version);
 #endif
@@ -175,12 +177,15 @@ sc_synthdef::unit_spec_t::unit_spec_t(const char *& buffer, const char * buffer_
 {
     const int short_int_size = (version == 1) ? 16 : 32;
 
-    name = symbol(read_pstring(buffer, buffer_end));
+    name = read_symbol(buffer, buffer_end);
     rate = read_int8(buffer, buffer_end);
     int32_t input_count = read_int(buffer, buffer_end, short_int_size);
     int32_t output_count = read_int(buffer, buffer_end, short_int_size);
     special_index = read_int16(buffer, buffer_end);
 
+    input_specs.reserve(input_count);
+    output_specs.reserve(output_count);
+
     for (int i = 0; i != input_count; ++i) {
         int32_t source = read_int(buffer, buffer_end, short_int_size);
         int32_t index = read_int(buffer, buffer_end, short_int_size);
@@ -205,7 +210,7 @@ void sc_synthdef::read_synthdef(const char *& buffer, const char* buffer_end, in
     const int short_int_size = (version == 1) ? 16 : 32;
 
     /* read name */
-    name_ = symbol(read_pstring(buffer, buffer_end));
+    name_ = read_symbol(buffer, buffer_end);
 
     /* read constants */
     int32_t constant_count = read_int(buffer, buffer_end, short_int_size);
@@ -229,7 +234,7 @@ void sc_synthdef::read_synthdef(const char *& buffer, const char* buffer_end, in
     int32_t parameter_names_count = read_int(buffer, buffer_end, short_int_size);
 
     for (int i = 0; i != parameter_names_count; ++i) {
-        symbol data = symbol(read_pstring(buffer, buffer_end));
+        symbol data = read_symbol(buffer, buffer_end);
         int32_t index = read_int(buffer, buffer_end, short_int_size);
 
         parameter_map[data] = index;
@@ -240,7 +245,7 @@ void sc_synthdef::read_synthdef(const char *& buffer, const char* buffer_end, in
 
     for (int i = 0; i != ugen_count; ++i) {
         unit_spec_t data(buffer, buffer_end, version);
-        graph.push_back(data);
+        graph.push_back(std::move(data));
     }
 
     prepare();
@@ -343,7 +348,13 @@ void sc_synthdef::prepare(void)
 
         current_ugen_spec.buffer_mapping.resize(current_ugen_spec.output_specs.size());
 
-        sc_ugen_def * ugen = sc_factory->find_ugen(current_ugen_spec.name);
+        /* resolved once per def: synth instantiation goes through the cached
+         * prototype pointer and never touches the factory again. defs repeat
+         * few distinct ugens many times, so runs of the same name skip the
+         * factory probe. */
+        sc_ugen_def * ugen = (ugen_index && graph[ugen_index - 1].name == current_ugen_spec.name)
+                           ? graph[ugen_index - 1].prototype
+                           : sc_factory->find_ugen(current_ugen_spec.name);
         if (unlikely(ugen == nullptr)) {
             /* we cannot prepare the synthdef, if the ugens are not installed */
             boost::format frmt("Cannot load synth %1%: Unit generator %2% not installed");
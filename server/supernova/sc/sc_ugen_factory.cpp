@@ -38,7 +38,7 @@ std::unique_ptr<sc_ugen_factory> sc_factory;
 
 Unit * sc_ugen_def::construct(sc_synthdef::unit_spec_t const & unit_spec, sc_synth * s, World * world, linear_allocator & allocator)
 {
-    const int buffer_length = world->mBufLength;
+    const size_t buffer_stride = s->wire_buffer_samples; /* cache-line padded */
 
     const size_t output_count = unit_spec.output_specs.size();
 
@@ -83,12 +83,13 @@ Unit * sc_ugen_def::construct(sc_synthdef::unit_spec_t const & unit_spec, sc_syn
 
         w->mBuffer = nullptr;
         w->mScalarValue = 0;
+        w->mDemandStamp = -1;
 
         if (unit->mCalcRate == 2) {
             /* allocate a new buffer */
             assert(unit_spec.buffer_mapping[i] >= 0);
             std::size_t buffer_id = unit_spec.buffer_mapping[i];
-            unit->mOutBuf[i] = buffer_base + buffer_length * buffer_id;
+            unit->mOutBuf[i] = buffer_base + buffer_stride * buffer_id;
             w->mBuffer = unit->mOutBuf[i];
         }
         else
@@ -174,7 +175,7 @@ bool sc_plugin_container::register_ugen_command_function(const char * ugen_name,
                                                      UnitCmdFunc func)
 {
     sc_ugen_def * def = find_ugen(symbol(ugen_name));
-    if (def)
+    if (!def)
         return false;
     return def->add_command(cmd_name, func);
 }
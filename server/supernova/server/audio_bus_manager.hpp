@@ -19,10 +19,12 @@
 #ifndef SERVER_AUDIO_BUS_MANAGER_HPP
 #define SERVER_AUDIO_BUS_MANAGER_HPP
 
+#include <algorithm>
 #include <cstdint>
 #include "sample_types.hpp"
 
 #include "../utilities/malloc_aligned.hpp"
+#include "nova-simd/simd_memory.hpp"
 #include "nova-tt/rw_spinlock.hpp"
 
 namespace nova {
@@ -44,10 +46,26 @@ public:
         locks = new padded_rw_spinlock[count];
     }
 
+    /* accumulate-and-combine mode: each dsp thread gets a shadow of every bus.
+     *  audio-rate writers mix into their thread's shadow without taking the bus
+     *  write lock, tagging the shadow with the current tick. pending shadows
+     *  are folded back into the bus by the first reader (under the bus write
+     *  lock) or by combine_pending() after the dsp queue has drained. */
+    void init_shadows(uint16_t thread_count)
+    {
+        shadow_threads = thread_count;
+        shadows = calloc_aligned<sample>(std::size_t(shadow_threads) * count * blocksize);
+        shadow_tags = new std::int32_t[std::size_t(shadow_threads) * count];
+        std::fill(shadow_tags, shadow_tags + std::size_t(shadow_threads) * count, -1);
+    }
+
     ~audio_bus_manager(void)
     {
         free_aligned(buffers);
         delete[] locks;
+        if (shadows)
+            free_aligned(shadows);
+        delete[] shadow_tags;
     }
 
     sample * acquire_bus(uint16_t index)
@@ -67,6 +85,45 @@ public:
         locks[index].unlock();
     }
 
+    /** fold shadows still tagged for this tick into their busses.
+     *
+     *  runs on the driver thread after the dsp queue has completed, so the
+     *  writers that produced the shadows are done and no locks are needed.
+     *  busses a reader already collected carry stale tags and are skipped.
+     */
+    void combine_pending(std::int32_t current_tick, std::int32_t * touched)
+    {
+        if (!shadows)
+            return;
+
+        const bool vectorized = !(blocksize & 15);
+        for (uint16_t t = 0; t != shadow_threads; ++t) {
+            std::int32_t * tags = shadow_tags + std::size_t(t) * count;
+            sample * base = shadows + std::size_t(t) * count * blocksize;
+
+            for (uint16_t index = 0; index != count; ++index) {
+                if (tags[index] != current_tick)
+                    continue;
+                tags[index] = current_tick - 1;
+
+                sample * bus = get_bus(index);
+                sample * shadow = base + std::size_t(index) * blocksize;
+                if (touched[index] == current_tick) {
+                    if (vectorized)
+                        addvec_simd(bus, shadow, blocksize);
+                    else
+                        addvec(bus, shadow, blocksize);
+                } else {
+                    touched[index] = current_tick;
+                    if (vectorized)
+                        copyvec_simd(bus, shadow, blocksize);
+                    else
+                        copyvec(bus, shadow, blocksize);
+                }
+            }
+        }
+    }
+
 private:
     friend class sc_plugin_interface;
 
@@ -74,6 +131,10 @@ private:
     uint16_t blocksize         = 0;
     sample * buffers           = nullptr;
     padded_rw_spinlock * locks = nullptr;
+
+    uint16_t shadow_threads    = 0;
+    sample * shadows           = nullptr;
+    std::int32_t * shadow_tags = nullptr;
 };
 
 } /* namespace nova */
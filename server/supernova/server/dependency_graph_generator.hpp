@@ -84,10 +84,47 @@ private:
             return fill_queue_recursive(static_cast<group&>(grp), successors, activation_limit);
     }
 
+    /** fast path for sequential groups without child groups.
+     *
+     *  such a group maps to exactly one queue item, so we can replay the
+     *  group's cached flat child sequence instead of re-walking the intrusive
+     *  child list. the cache survives queue rebuilds, so only groups whose
+     *  children changed since the previous generation pay a list traversal.
+     */
+    HOT successor_container fill_queue_flat(group & g, successor_container const & successors_from_parent, size_t previous_activation_limit)
+    {
+        abstract_group::flat_child_vector const & flat_children = g.flat_children();
+        assert(!flat_children.empty());
+        assert(flat_children.size() == g.child_synth_count);
+
+        auto it = flat_children.begin();
+
+        thread_queue_item * q_item =
+            q->allocate_queue_item(queue_node(std::move(queue_node_data(static_cast<abstract_synth*>(*it++))), flat_children.size()),
+                                    successors_from_parent, previous_activation_limit);
+
+        queue_node & q_node = q_item->get_job();
+
+        for (; it != flat_children.end(); ++it)
+            q_node.add_node(static_cast<abstract_synth*>(*it));
+
+        assert(q_node.size() == flat_children.size());
+
+        if (previous_activation_limit == 0)
+            q->add_initially_runnable(q_item);
+
+        successor_container ret(1);
+        ret[0] = q_item;
+        return ret;
+    }
+
     HOT successor_container fill_queue_recursive(group & g, successor_container const & successors_from_parent, size_t previous_activation_limit)
     {
         assert (g.has_synth_children());
 
+        if (g.child_group_count == 0)
+            return fill_queue_flat(g, successors_from_parent, previous_activation_limit);
+
         typedef server_node_list::reverse_iterator r_iterator;
 
         successor_container successors(successors_from_parent);
@@ -47,6 +47,7 @@ public:
     {
         if (unlikely(!node->is_running()))
             return;
+        node->mDspThreadIndex = index;
         node->perform();
     }
 
@@ -19,6 +19,8 @@
 #ifndef SERVER_GROUP_HPP
 #define SERVER_GROUP_HPP
 
+#include <vector>
+
 #include "memory_pool.hpp"
 #include "node_types.hpp"
 #include "dsp_thread_queue_node.hpp"
@@ -93,6 +95,36 @@ public:
         return child_nodes.empty();
     }
 
+    /* @{ */
+    /** flattened play-order child sequence, cached across dsp queue rebuilds.
+     *
+     *  only used for groups without child groups (the common leaf case): the
+     *  dependency graph generator replays the cached sequence instead of
+     *  walking the intrusive child list, so an unchanged group costs one
+     *  contiguous copy per rebuild and only groups edited since the previous
+     *  generation pay a traversal. any change to the direct child list
+     *  invalidates the cache.
+     */
+    typedef std::vector<server_node*, rt_pool_allocator<server_node*> > flat_child_vector;
+
+    flat_child_vector const & flat_children(void) const
+    {
+        if (!flat_children_valid) {
+            flat_child_cache.clear();
+            flat_child_cache.reserve(child_nodes.size());
+            for (server_node const & node : child_nodes)
+                flat_child_cache.push_back(const_cast<server_node*>(&node));
+            flat_children_valid = true;
+        }
+        return flat_child_cache;
+    }
+
+    void invalidate_flat_children(void)
+    {
+        flat_children_valid = false;
+    }
+    /* @} */
+
     /* returns true, if this or any of the child group has synth children */
     bool has_synth_children(void) const
     {
@@ -234,6 +266,8 @@ public:
         server_node_list::const_iterator node_iterator = server_node_list::s_iterator_to(*node);
 
         abstract_group * node_parent = node->get_parent();
+        node_parent->invalidate_flat_children();
+        target->invalidate_flat_children();
         if (node_parent != target) {
             if (node->is_synth()) {
                 node_parent->child_synth_count -= 1;
@@ -274,6 +308,8 @@ public:
         server_node_list::const_iterator node_iterator = server_node_list::s_iterator_to(*node);
 
         abstract_group * node_parent = node->get_parent();
+        node_parent->invalidate_flat_children();
+        target_parent->invalidate_flat_children();
         if (node_parent != target_parent) {
             if (node->is_synth()) {
                 node_parent->child_synth_count -= 1;
@@ -295,11 +331,17 @@ public:
 
     friend class node_graph;
     std::size_t child_synth_count = 0, child_group_count = 0;
+
+private:
+    mutable flat_child_vector flat_child_cache;
+    mutable bool flat_children_valid = false;
 };
 
 
 inline void server_node::clear_parent(void)
 {
+    parent_->invalidate_flat_children();
+
     if (is_synth())
         --parent_->child_synth_count;
     else {
@@ -316,6 +358,7 @@ inline void server_node::set_parent(abstract_group * parent)
     add_ref();
     assert(parent_ == 0);
     parent_ = parent;
+    parent->invalidate_flat_children();
 
     if (is_synth())
         ++parent->child_synth_count;
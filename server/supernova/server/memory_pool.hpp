@@ -26,6 +26,16 @@ namespace nova
 
 extern simple_pool<false> rt_pool;   /* real-time memory pool */
 
+/* cache line geometry of the dsp working set. synths in different pargroup
+ * branches run on different dsp threads, so per-synth buffers are padded to
+ * multiples of this to avoid false sharing between cores */
+static const size_t cache_line_size = 64;
+
+inline size_t pad_to_cache_line(size_t bytes)
+{
+    return (bytes + cache_line_size - 1) & ~(cache_line_size - 1);
+}
+
 /** stl-compliant allocator class, using the rt_pool */
 template <class T>
 class rt_pool_allocator {
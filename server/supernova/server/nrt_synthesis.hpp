@@ -68,6 +68,7 @@ struct non_realtime_synthesis_engine
         command_stream.open(args.command_file.c_str(), std::fstream::in | std::fstream::binary);
 
         has_inputs = !input_file.empty();
+        dsp_threads = args.threads;
         samples_per_block = args.blocksize;
         prepare_backend(args.blocksize, args.input_channels, args.output_channels);
     }
@@ -94,7 +95,7 @@ struct non_realtime_synthesis_engine
         const int reserved_packed_size = 16384;
         std::vector <char> packet_vector(reserved_packed_size, 0);
 
-        printf("\nPerforming non-rt synthesis:\n");
+        printf("\nPerforming non-rt synthesis (%d dsp threads):\n", dsp_threads);
         backend.activate_audio();
 
         auto start_time = steady_clock::now();
@@ -172,6 +173,7 @@ private:
     sndfile_backend<non_rt_functor, float, true> backend;
     std::fstream command_stream;
     int samples_per_block;
+    int dsp_threads;
     bool has_inputs;
 };
 
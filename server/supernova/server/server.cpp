@@ -34,6 +34,15 @@
 #include <AvailabilityMacros.h>
 #include <CoreAudio/HostTime.h>
 #include <CoreAudio/CoreAudioTypes.h>
+#include "../../common/SC_AudioWorkgroup.hpp"
+#endif
+
+#ifdef __linux__
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
 #endif
 
 namespace nova
@@ -42,8 +51,8 @@ namespace nova
 class nova_server * instance = nullptr;
 
 nova_server::nova_server(server_arguments const & args):
-    server_shared_memory_creator(args.port(), args.control_busses),
-    scheduler<thread_init_functor>(args.threads, !args.non_rt),
+    server_shared_memory_creator(args.port(), args.control_busses, args.audio_busses),
+    scheduler<thread_init_functor>(args.threads, !args.non_rt, args.work_stealing),
     buffer_manager(args.buffers), sc_osc_handler(args)
 {
     assert(instance == 0);
@@ -51,9 +60,14 @@ nova_server::nova_server(server_arguments const & args):
     
     use_system_clock = (args.use_system_clock == 1);
     smooth_samplerate = args.samplerate;
+    shm_metering = args.shm_metering;
     
-    if (!args.non_rt)
+    if (!args.non_rt) {
         io_interpreter.start_thread();
+        for (auto & interpreter : disk_interpreters)
+            interpreter.start_thread();
+        disk_threads_started = true;
+    }
 
     sc_factory.reset( new sc_ugen_factory );
     sc_factory->initialize(args, server_shared_memory_creator::shm->get_control_busses());
@@ -98,6 +112,8 @@ nova_server::~nova_server(void)
 
     scheduler<thread_init_functor>::terminate();
     io_interpreter.join_thread();
+    for (auto & interpreter : disk_interpreters)
+        interpreter.join_thread();
 
     sc_factory.reset();
     instance = nullptr;
@@ -236,6 +252,80 @@ static void set_daz_ftz(void)
 #endif
 }
 
+#ifdef __linux__
+
+/** topology-aware cpu pinning
+ *
+ *  candidates are taken from the affinity mask the process was started with,
+ *  so cpus reserved via isolcpus, cpusets or taskset are never claimed.
+ *  among the allowed cpus, one logical cpu per physical core is preferred:
+ *  only when there are more dsp threads than cores do we start placing
+ *  threads on smt siblings.
+ */
+static bool thread_set_affinity_topology(int thread_index)
+{
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return false;
+
+    std::vector<int> primary_cpus;  /* first logical cpu of each physical core */
+    std::vector<int> sibling_cpus;  /* remaining smt siblings */
+    std::vector<long> seen_cores;
+
+    for (int cpu = 0; cpu != CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed))
+            continue;
+
+        long core_id = -1, package_id = -1;
+        char path[128];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+        if (FILE * f = fopen(path, "r")) {
+            if (fscanf(f, "%ld", &core_id) != 1)
+                core_id = -1;
+            fclose(f);
+        }
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        if (FILE * f = fopen(path, "r")) {
+            if (fscanf(f, "%ld", &package_id) != 1)
+                package_id = -1;
+            fclose(f);
+        }
+
+        if (core_id < 0) {
+            /* no topology information: treat every logical cpu as a core */
+            primary_cpus.push_back(cpu);
+            continue;
+        }
+
+        const long core_key = (package_id << 16) | core_id;
+        if (std::find(seen_cores.begin(), seen_cores.end(), core_key) == seen_cores.end()) {
+            seen_cores.push_back(core_key);
+            primary_cpus.push_back(cpu);
+        } else
+            sibling_cpus.push_back(cpu);
+    }
+
+    if (primary_cpus.empty())
+        return false;
+
+    primary_cpus.insert(primary_cpus.end(), sibling_cpus.begin(), sibling_cpus.end());
+    const int target = primary_cpus[thread_index % primary_cpus.size()];
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(target, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+#else
+
+static bool thread_set_affinity_topology(int thread_index)
+{
+    return thread_set_affinity(thread_index);
+}
+
+#endif
+
 static bool set_realtime_priority(int thread_index)
 {
     bool success = false;
@@ -294,18 +384,41 @@ static bool set_realtime_priority(int thread_index)
 }
 
 
+#ifdef SC_AUDIO_WORKGROUP_AVAILABLE
+/* join the calling helper thread to the IO thread workgroup of the default
+ * output device. without this the scheduler treats the helpers as unrelated
+ * background work and power-throttles them on asymmetric cores, causing
+ * dropouts at small buffer sizes. the device id is not exposed through the
+ * backend abstraction, so the default output device is queried directly;
+ * that is the device the realtime backends open. */
+static void join_audio_workgroup(void)
+{
+    static os_workgroup_t workgroup = sc_default_output_audio_workgroup();
+    static thread_local SC_AudioWorkgroupMembership membership(workgroup);
+    if (workgroup && !membership.Joined())
+        std::cout << "Warning: cannot join audio workgroup" << std::endl;
+}
+#endif
+
 void thread_init_functor::operator()(int thread_index)
 {
     set_daz_ftz();
     name_current_thread(thread_index);
 
-    if (rt)
+    if (rt) {
         set_realtime_priority(thread_index);
 
+#ifdef SC_AUDIO_WORKGROUP_AVAILABLE
+        join_audio_workgroup();
+#endif
+
 #ifndef __APPLE__
-    if (!thread_set_affinity(thread_index))
-        std::cout << "Warning: cannot set thread affinity of audio helper thread" << std::endl;
+        // pinning only pays off for the realtime case. offline renders should
+        // leave placement to the kernel, so several of them can share a machine.
+        if (!thread_set_affinity_topology(thread_index))
+            std::cout << "Warning: cannot set thread affinity of audio helper thread" << std::endl;
 #endif
+    }
 }
 
 void io_thread_init_functor::operator()() const
@@ -334,7 +447,7 @@ void realtime_engine_functor::init_thread(void)
     set_daz_ftz();
 
 #ifndef __APPLE__
-    if (!thread_set_affinity(0))
+    if (!thread_set_affinity_topology(0))
         std::cout << "Warning: cannot set thread affinity of main audio thread" << std::endl;
 #endif
 
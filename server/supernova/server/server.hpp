@@ -19,7 +19,12 @@
 #ifndef SERVER_NOVA_SERVER_HPP
 #define SERVER_NOVA_SERVER_HPP
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cmath>
+
+#include <boost/sync/semaphore.hpp>
 
 #include "buffer_manager.hpp"
 #include "memory_pool.hpp"
@@ -94,6 +99,24 @@ private:
     const T * const ptr_;
 };
 
+/** system_callback to signal a semaphore. used as barrier for the disk interpreters */
+class semaphore_callback:
+    public system_callback
+{
+public:
+    semaphore_callback (boost::sync::semaphore & sem):
+        sem_(sem)
+    {}
+
+private:
+    virtual void run(void) override
+    {
+        sem_.post();
+    }
+
+    boost::sync::semaphore & sem_;
+};
+
 
 /** dsp thread init functor
  *
@@ -160,6 +183,32 @@ public:
     }
     /* @} */
 
+    /* @{ */
+    /** disk interpreters
+     *
+     *  blocking buffer commands are dispatched by buffer index, so commands for
+     *  the same buffer keep their order, while different buffers stream from
+     *  disk concurrently without stalling the system interpreter
+     */
+    void add_disk_callback(system_callback * cb, int buffer_index)
+    {
+        disk_interpreters[size_t(buffer_index) % disk_thread_count].add_callback(cb);
+    }
+
+    /** block until every disk callback enqueued so far has completed */
+    void wait_for_disk_callbacks(void)
+    {
+        if (!disk_threads_started)
+            return;
+
+        boost::sync::semaphore sem;
+        for (auto & interpreter : disk_interpreters)
+            interpreter.add_callback(new semaphore_callback(sem));
+        for (size_t i = 0; i != disk_thread_count; ++i)
+            sem.wait();
+    }
+    /* @} */
+
     /* @{ */
     /** system interpreter
       * \note: should only be called from the main audio thread
@@ -243,6 +292,41 @@ public:
             rebuild_dsp_queue();
 
         compute_audio();
+
+        if (shm_metering)
+            update_bus_meters();
+    }
+
+    /** write per-bus peak/rms and a block-peak overview ring into the shared
+     *  memory meter slots (see server_shm.hpp), so local clients read meters
+     *  without any osc traffic. untouched busses report silence without
+     *  scanning samples. */
+    void update_bus_meters(void)
+    {
+        bus_meter * meters = server_shared_memory_creator::shm->get_bus_meters();
+        World const & world = sc_factory->world;
+        const int blocksize = world.mBufLength;
+        const float rscale = 1.f / blocksize;
+
+        for (uint32_t i = 0; i != world.mNumAudioBusChannels; ++i) {
+            bus_meter & meter = meters[i];
+            float peak = 0.f;
+            float rms = 0.f;
+            if (world.mAudioBusTouched[i] == world.mBufCounter) {
+                const float * samples = world.mAudioBus + i * blocksize;
+                float sum = 0.f;
+                for (int j = 0; j != blocksize; ++j) {
+                    float x = samples[j];
+                    peak = std::max(peak, std::fabs(x));
+                    sum += x * x;
+                }
+                rms = std::sqrt(sum * rscale);
+            }
+            meter.peak = peak;
+            meter.rms = rms;
+            meter.overview[meter.overview_index] = peak;
+            meter.overview_index = (meter.overview_index + 1) & (bus_meter::overview_frames - 1);
+        }
     }
 
     void rebuild_dsp_queue(void);
@@ -262,9 +346,14 @@ private:
     void finalize_node(server_node & node);
     std::atomic<bool> quit_requested_ = {false};
     bool dsp_queue_dirty = false;
+    bool shm_metering = false;
 
     callback_interpreter<system_callback, false> system_interpreter; // rt to system thread
     threaded_callback_interpreter<system_callback, io_thread_init_functor> io_interpreter; // for network IO
+
+    static const size_t disk_thread_count = 4;
+    std::array<threaded_callback_interpreter<system_callback>, disk_thread_count> disk_interpreters; // for buffer disk jobs
+    bool disk_threads_started = false;
 };
 
 inline void run_scheduler_tick(void)
@@ -280,6 +369,10 @@ inline void run_scheduler_tick(void)
 
     instance->tick();
 
+    /* fold bus shadows no reader consumed during this tick, so the hardware
+     * outputs and next-tick readers (InFeedback) see them */
+    sc_factory->audio_busses.combine_pending(buf_counter, sc_factory->world.mAudioBusTouched);
+
     /* wipe all untouched output buffers */
     for (int channel = 0; channel != output_channels; ++channel) {
         if (sc_factory->world.mAudioBusTouched[channel] != buf_counter)
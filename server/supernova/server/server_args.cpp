@@ -69,6 +69,12 @@ server_arguments::server_arguments(int argc, char * argv[])
                                                                     "if -U is specified, the standard paths are NOT searched for plugins.")
         ("restricted-path,P", value<vector<string> >(&restrict_paths), "if specified, prevents file-accessing OSC commands from accessing files outside <restricted-path>")
         ("threads,T", value<uint16_t>(&threads)->default_value(boost::thread::physical_concurrency()), "number of audio threads")
+        ("work-stealing", "schedule dsp nodes via per-thread work-stealing deques\n"
+                          "instead of one central queue (helps wide parallel graphs)")
+        ("bus-shadows", "audio-rate bus writers mix into per-thread bus shadows,\n"
+                        "combined on first read (avoids write-lock contention on\n"
+                        "busses shared by parallel groups)")
+        ("shm-metering,K", "write per-bus peak/rms meters into the shared memory interface")
         ;
 
     options_description audio_options("audio options");
@@ -102,6 +108,9 @@ server_arguments::server_arguments(int argc, char * argv[])
 
     dump_version = vm.count("version");
     memory_locking = vm.count("memory-locking");
+    work_stealing = vm.count("work-stealing");
+    bus_shadows = vm.count("bus-shadows");
+    shm_metering = vm.count("shm-metering");
 
     if (vm.count("help")) {
         cout << cmdline_options << endl;
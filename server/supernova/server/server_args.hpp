@@ -72,6 +72,9 @@ public:
     std::vector<std::string> hw_name;
     bool memory_locking;
     uint16_t threads;
+    bool work_stealing;
+    bool bus_shadows;
+    bool shm_metering;
 
     std::vector<std::string> ugen_paths, restrict_paths;
 
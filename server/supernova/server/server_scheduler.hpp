@@ -93,8 +93,8 @@ protected:
 
 public:
     /* start thread_count - 1 scheduler threads */
-    scheduler(thread_count_t thread_count = 1, bool realtime = false):
-        threads(thread_count, !realtime, thread_init_functor(realtime))
+    scheduler(thread_count_t thread_count = 1, bool realtime = false, bool work_stealing = false):
+        threads(thread_count, !realtime, work_stealing, thread_init_functor(realtime))
     {}
 
     void start_dsp_threads(void)
@@ -0,0 +1,163 @@
+//  size-classed recycling pool for buffer payloads
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; see the file COPYING.  If not, write to
+//  the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+//  Boston, MA 02111-1307, USA.
+
+#ifndef UTILITIES_BUFFER_POOL_HPP
+#define UTILITIES_BUFFER_POOL_HPP
+
+#include <cstring>
+#include <mutex>
+
+#include "malloc_aligned.hpp"
+
+namespace nova {
+
+/** size-classed recycling pool for SndBuf payloads.
+ *
+ *  rapid \b_alloc / \b_free cycles (grain buffers in live-sampling sets)
+ *  otherwise round-trip through the system allocator, which hands large
+ *  blocks back to the OS on free and repays the page faults on the next
+ *  allocation. payloads are rounded up to power-of-two size classes and kept
+ *  on bounded per-class free lists instead. cached blocks keep their pages
+ *  resident (the payloads are mlocked for real-time use, which also rules
+ *  out madvise-style trimming), so the cache is bounded both per class and
+ *  in total; blocks beyond the bounds and oversized blocks go straight back
+ *  to the system.
+ *
+ *  all calls are made from the non-real-time threads; a mutex guards the
+ *  free lists. returned payloads are zeroed and aligned like malloc_aligned.
+ */
+class buffer_pool
+{
+    /* each block carries one alignment unit of header in front of the
+     * payload, recording the size class for the free path */
+    static const std::size_t header_size = malloc_memory_alignment;
+
+    static const int smallest_class = 12;           /* 4 kb  */
+    static const int largest_class = 24;            /* 16 mb */
+    static const int class_count = largest_class - smallest_class + 1;
+
+    static const std::size_t max_blocks_per_class = 32;
+    static const std::size_t max_cached_bytes = std::size_t(1) << 26; /* 64 mb */
+
+    struct block_header
+    {
+        block_header * next;
+        int size_class;                             /* -1: not pooled */
+    };
+
+public:
+    buffer_pool(void)
+    {
+        for (int i = 0; i != class_count; ++i) {
+            free_lists[i] = nullptr;
+            cached_blocks[i] = 0;
+        }
+    }
+
+    ~buffer_pool(void)
+    {
+        for (int i = 0; i != class_count; ++i) {
+            block_header * block = free_lists[i];
+            while (block) {
+                block_header * next = block->next;
+                free_aligned(block);
+                block = next;
+            }
+        }
+    }
+
+    buffer_pool(buffer_pool const &) = delete;
+    buffer_pool & operator=(buffer_pool const &) = delete;
+
+    void * allocate(std::size_t bytes)
+    {
+        const int size_class = class_for_size(bytes);
+        if (size_class >= 0) {
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                block_header *& head = free_lists[size_class - smallest_class];
+                if (head) {
+                    block_header * block = head;
+                    head = block->next;
+                    cached_bytes -= std::size_t(1) << size_class;
+                    --cached_blocks[size_class - smallest_class];
+
+                    /* recycled pages are resident, zeroing them is cheap */
+                    void * payload = (char*)block + header_size;
+                    std::memset(payload, 0, bytes);
+                    return payload;
+                }
+            }
+            return allocate_block(std::size_t(1) << size_class, size_class);
+        }
+        return allocate_block(bytes, -1);
+    }
+
+    void free(void * payload)
+    {
+        if (!payload)
+            return;
+
+        block_header * block = (block_header*)((char*)payload - header_size);
+        const int size_class = block->size_class;
+
+        if (size_class >= 0) {
+            std::lock_guard<std::mutex> lock(guard);
+            const std::size_t block_bytes = std::size_t(1) << size_class;
+            if (cached_blocks[size_class - smallest_class] < max_blocks_per_class
+                && cached_bytes + block_bytes <= max_cached_bytes) {
+                block->next = free_lists[size_class - smallest_class];
+                free_lists[size_class - smallest_class] = block;
+                cached_bytes += block_bytes;
+                ++cached_blocks[size_class - smallest_class];
+                return;
+            }
+        }
+        free_aligned(block);
+    }
+
+private:
+    static int class_for_size(std::size_t bytes)
+    {
+        if (bytes > (std::size_t(1) << largest_class))
+            return -1;
+        int size_class = smallest_class;
+        while ((std::size_t(1) << size_class) < bytes)
+            ++size_class;
+        return size_class;
+    }
+
+    void * allocate_block(std::size_t payload_bytes, int size_class)
+    {
+        void * raw = calloc_aligned(header_size + payload_bytes);
+        if (!raw)
+            return nullptr;
+
+        block_header * block = (block_header*)raw;
+        block->size_class = size_class;
+        return (char*)raw + header_size;
+    }
+
+    std::mutex guard;
+    block_header * free_lists[class_count];
+    std::size_t cached_blocks[class_count];
+    std::size_t cached_bytes = 0;
+};
+
+} /* namespace nova */
+
+#endif /* UTILITIES_BUFFER_POOL_HPP */
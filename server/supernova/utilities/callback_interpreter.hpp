@@ -55,13 +55,23 @@ class callback_interpreter:
 
 public:
     callback_interpreter(void):
-        sem(0), running(false)
+        sem(0), pending(0), single_consumer(true), running(false)
     {}
 
     void add_callback(callback_type * cb)
     {
         super_t::add_callback(cb);
-        sem.post();
+        if (!single_consumer) {
+            sem.post();
+            return;
+        }
+        /* eventcount: only the transition from empty needs a wakeup. the
+         * interpreter claims the whole batch per wakeup and drains the queue
+         * outside any lock, so a burst of callbacks (say, a preset load
+         * completing dozens of async commands) costs one semaphore syscall
+         * instead of one per item. */
+        if (pending.fetch_add(1, std::memory_order_release) == 0)
+            sem.post();
     }
 
     void run(void)
@@ -90,12 +100,21 @@ private:
         do
         {
             sem.wait();
+            if (single_consumer)
+                /* claim everything queued so far; pushes ordered before the
+                 * counter increments are visible to run_callbacks, and an
+                 * add racing with the claim reposts the semaphore itself */
+                pending.exchange(0, std::memory_order_acquire);
             super_t::run_callbacks();
         } while(likely(running.load(std::memory_order_relaxed)));
     }
 
 protected:
     boost::sync::semaphore sem;
+    std::atomic<size_t> pending;
+    /* thread pools wake one worker per item; the batched wakeup protocol
+     * above is only valid with a single consumer thread */
+    bool single_consumer;
     std::atomic<bool> running;
 };
 
@@ -161,6 +180,8 @@ public:
     callback_interpreter_threadpool(uint16_t worker_thread_count, bool rt, uint16_t priority):
         worker_thread_count_(worker_thread_count), priority(priority), rt(rt)
     {
+        super::single_consumer = false; // wake one worker per item
+
         semaphore sync_sem;
         using namespace std;
 
@@ -45,10 +45,14 @@ namespace nova {
  *         from the freelist to avoid (default: dispose all objects
  *         of freelist)
  *
- * \todo   we could allocate one word more and store the size of the
- *         chunk just before the object. if a disposed object is large
- *         enough for a request, it wouldn't need to be added to the
- *         memory pool.
+ * chunks of the common small sizes are segregated into power-of-two
+ * size classes and recycled through per-class freelists: the class
+ * index is stored in a header word just before the object, so a
+ * disposed chunk can serve the next same-class request directly
+ * without a round trip through the memory pool. in steady state
+ * (e.g. a constant stream of sync commands) allocation is therefore
+ * just a freelist pop. oversized chunks and pool exhaustion fall back
+ * to the original pool path.
  *
  * */
 template <typename tag,
@@ -112,12 +116,62 @@ private:
                                      disposing_allocator
                                      >::type allocator;
 
+    /* chunk layout: one header word carrying the size class index, padded to
+     * preserve alignment, followed by the object itself. the header doubles
+     * as freelist link storage while the chunk sits on a recycle list. */
+    static const std::size_t recycle_header_size = 2 * sizeof(void*);
+    static const int num_size_classes = 4;
+    static const std::size_t smallest_size_class = 32;
+
+    static inline int size_class(std::size_t chunk_size)
+    {
+        std::size_t class_size = smallest_size_class;
+        for (int i = 0; i != num_size_classes; ++i, class_size <<= 1)
+            if (chunk_size <= class_size)
+                return i;
+        return -1;
+    }
+
+    /** hand all recycled chunks back to the pool (pool exhaustion path) */
+    static inline void drain_recycled_objects(void)
+    {
+        for (int i = 0; i != num_size_classes; ++i) {
+            for (;;) {
+                void * chunk = recycled_objects[i].pop();
+                if (chunk == nullptr)
+                    break;
+                object_pool.free(chunk);
+            }
+        }
+    }
+
 public:
     static inline void * allocate(std::size_t size)
     {
 #ifndef NOVA_MEMORY_DEBUGGING
         size = std::max(2*sizeof(void*), size); /* size requirement for lockfree freelist */
-        return allocator::allocate(size);
+
+        std::size_t chunk_size = size + recycle_header_size;
+        const int cls = size_class(chunk_size);
+        if (cls >= 0) {
+            void * recycled = recycled_objects[cls].pop();
+            if (recycled) {
+                /* the freelist link clobbered the header word */
+                *(std::size_t*)recycled = (std::size_t)cls;
+                return (char*)recycled + recycle_header_size;
+            }
+            chunk_size = smallest_size_class << cls;
+        }
+
+        void * chunk = allocator::allocate(chunk_size);
+        if (chunk == nullptr) {
+            drain_recycled_objects();
+            chunk = allocator::allocate(chunk_size);
+            if (chunk == nullptr)
+                return nullptr;
+        }
+        *(std::size_t*)chunk = (std::size_t)(cls >= 0 ? cls : num_size_classes);
+        return (char*)chunk + recycle_header_size;
 #else
         return malloc(size);
 #endif
@@ -139,7 +193,12 @@ public:
     static inline void deallocate(void * p)
     {
 #ifndef NOVA_MEMORY_DEBUGGING
-        disposed_objects.push(p);
+        void * chunk = (char*)p - recycle_header_size;
+        const std::size_t cls = *(std::size_t*)chunk;
+        if (cls < (std::size_t)num_size_classes)
+            recycled_objects[cls].push(chunk);  /* reused directly, same size class */
+        else
+            disposed_objects.push(chunk);       /* oversized: back to the pool */
 #else
         free(p);
 #endif
@@ -154,6 +213,7 @@ public:
 
     static object_pool_type object_pool;
     static freelist disposed_objects;
+    static freelist recycled_objects[num_size_classes];
 };
 
 template <typename tag,
@@ -169,6 +229,13 @@ template <typename tag,
           unsigned int recover_count>
 freelist static_pooled_class<tag, pool_size, pool_locking, recover_count>::disposed_objects;
 
+template <typename tag,
+          std::size_t pool_size,
+          bool pool_locking,
+          unsigned int recover_count>
+freelist static_pooled_class<tag, pool_size, pool_locking, recover_count>::recycled_objects[
+    static_pooled_class<tag, pool_size, pool_locking, recover_count>::num_size_classes];
+
 
 } /* namespace nova */
 
@@ -0,0 +1,233 @@
+#!/usr/bin/env python
+# End-to-end server benchmark suite. Generates OSC command files for a few
+# synthetic workloads, renders them with scsynth (and supernova when given)
+# in NRT mode, and writes the wall-clock timings as JSON. Run with
+# --compare <baseline.json> to fail when a workload got noticeably slower
+# than a previously recorded baseline.
+
+import json
+import optparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+
+#############################################################################
+# OSC command file generation
+#
+# NRT command files are a sequence of [int32 size][#bundle ...] records.
+# Timetags count seconds from the start of the render (* 2^32).
+
+def osc_string(s):
+    s = s.encode('ascii') if not isinstance(s, bytes) else s
+    return s + b'\0' * (4 - len(s) % 4)
+
+def osc_message(address, *args):
+    tags = b','
+    data = b''
+    for arg in args:
+        if isinstance(arg, int):
+            tags += b'i'
+            data += struct.pack('>i', arg)
+        elif isinstance(arg, float):
+            tags += b'f'
+            data += struct.pack('>f', arg)
+        else:
+            tags += b's'
+            data += osc_string(arg)
+    return osc_string(address) + osc_string(tags) + data
+
+def osc_bundle(seconds, messages):
+    timetag = struct.pack('>Q', int(seconds * 4294967296.0))
+    body = b'#bundle\0' + timetag
+    for msg in messages:
+        body += struct.pack('>i', len(msg)) + msg
+    return body
+
+def write_score(path, bundles):
+    # bundles: list of (seconds, [message, ...]), already sorted by time
+    f = open(path, 'wb')
+    for seconds, messages in bundles:
+        bundle = osc_bundle(seconds, messages)
+        f.write(struct.pack('>i', len(bundle)) + bundle)
+    f.close()
+
+
+#############################################################################
+# workloads
+#
+# Every workload starts by loading the default synthdef and ends with a
+# dummy /c_set bundle so the servers know the render duration. Node IDs
+# start at 1000 to stay clear of the root node.
+
+def score_node_churn(synthdef):
+    # /s_new + /n_free storms: 20 synths spawned and freed every 10 ms
+    # for 10 seconds, stressing the node tree and command dispatch.
+    bundles = [(0.0, [osc_message('/d_load', synthdef)])]
+    node = 1000
+    for step in range(1000):
+        t = 0.01 * step
+        spawn = []
+        free = []
+        for i in range(20):
+            spawn.append(osc_message('/s_new', 'default', node, 0, 0,
+                                     'freq', 200.0 + (node % 400)))
+            free.append(osc_message('/n_free', node))
+            node += 1
+        bundles.append((t, spawn))
+        bundles.append((t + 0.005, free))
+    bundles.append((10.0, [osc_message('/c_set', 0, 0.0)]))
+    return bundles
+
+def score_wide_groups(synthdef, group_cmd):
+    # 16 wide groups of 64 sustaining synths each, rendered for 5 seconds.
+    # On supernova the groups are ParGroups (/p_new), so this exercises the
+    # parallel dsp thread queue; on scsynth plain groups measure the serial
+    # baseline over the same node graph.
+    setup = [osc_message('/d_load', synthdef)]
+    node = 1000
+    for g in range(16):
+        setup.append(osc_message(group_cmd, 2 + g, 0, 0))
+    spawn = []
+    for g in range(16):
+        for i in range(64):
+            spawn.append(osc_message('/s_new', 'default', node, 0, 2 + g,
+                                     'freq', 100.0 + node % 800))
+            node += 1
+    return [(0.0, setup), (0.05, spawn),
+            (5.0, [osc_message('/c_set', 0, 0.0)])]
+
+def score_buffer_flood(synthdef):
+    # buffer command floods: allocate, fill, zero and free 200 buffers in
+    # overlapping waves, stressing the sequenced (async) command machinery.
+    bundles = [(0.0, [osc_message('/d_load', synthdef)])]
+    for step in range(100):
+        t = 0.02 * step
+        msgs = []
+        for b in range(200):
+            msgs.append(osc_message('/b_alloc', b, 16384, 1))
+        bundles.append((t, msgs))
+        msgs = []
+        for b in range(200):
+            msgs.append(osc_message('/b_gen', b, 'sine1', 0, 1.0, 0.5, 0.25))
+            msgs.append(osc_message('/b_zero', b))
+        bundles.append((t + 0.005, msgs))
+        msgs = []
+        for b in range(200):
+            msgs.append(osc_message('/b_free', b))
+        bundles.append((t + 0.01, msgs))
+    bundles.append((2.0, [osc_message('/c_set', 0, 0.0)]))
+    return bundles
+
+
+#############################################################################
+# runner
+
+def run_once(server, extra_args, score_path, out_path, samplerate, env):
+    cmd = [server] + extra_args + \
+          ['-i', '0', '-o', '2',
+           '-N', score_path, '_', out_path, str(samplerate), 'WAV', 'int16']
+    start = time.time()
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT, env=env)
+    output = proc.communicate()[0]
+    elapsed = time.time() - start
+    if proc.returncode != 0:
+        sys.stderr.write(output.decode('ascii', 'replace'))
+        sys.exit("%s exited with %d" % (cmd[0], proc.returncode))
+    return elapsed
+
+def median(values):
+    values = sorted(values)
+    mid = len(values) // 2
+    if len(values) % 2:
+        return values[mid]
+    return 0.5 * (values[mid - 1] + values[mid])
+
+def main():
+    parser = optparse.OptionParser()
+    parser.add_option('--scsynth', help='path to the scsynth binary')
+    parser.add_option('--supernova', help='path to the supernova binary')
+    parser.add_option('--synthdef', help='path to default.scsyndef')
+    parser.add_option('--plugin-path', help='UGen plugin directory (-U)')
+    parser.add_option('--output', default='perf_baseline.json',
+                      help='where to write the timing baseline')
+    parser.add_option('--compare', help='baseline JSON to compare against')
+    parser.add_option('--tolerance', type='float', default=0.1,
+                      help='allowed slowdown vs. baseline (default 10%)')
+    parser.add_option('--runs', type='int', default=3)
+    parser.add_option('--samplerate', type='int', default=44100)
+    options, args = parser.parse_args()
+
+    if not options.synthdef or not os.path.exists(options.synthdef):
+        sys.exit("--synthdef must point at default.scsyndef")
+
+    servers = []
+    if options.scsynth:
+        servers.append(('scsynth', options.scsynth, '/g_new'))
+    if options.supernova:
+        servers.append(('supernova', options.supernova, '/p_new'))
+    if not servers:
+        sys.exit("no server binaries given (--scsynth / --supernova)")
+
+    env = dict(os.environ)
+    extra_args = []
+    if options.plugin_path:
+        extra_args = ['-U', options.plugin_path]
+
+    workdir = tempfile.mkdtemp(prefix='sc_perf_')
+    results = []
+    for server_name, server_path, group_cmd in servers:
+        workloads = [
+            ('node_churn', score_node_churn(options.synthdef)),
+            ('wide_groups', score_wide_groups(options.synthdef, group_cmd)),
+            ('buffer_flood', score_buffer_flood(options.synthdef)),
+        ]
+        for workload_name, bundles in workloads:
+            score_path = os.path.join(workdir, workload_name + '.osc')
+            out_path = os.path.join(workdir, workload_name + '.wav')
+            write_score(score_path, bundles)
+            seconds = []
+            for run in range(options.runs):
+                seconds.append(run_once(server_path, extra_args, score_path,
+                                        out_path, options.samplerate, env))
+            results.append({'server': server_name,
+                            'workload': workload_name,
+                            'seconds': seconds,
+                            'median': median(seconds)})
+            print("%-10s %-13s median %.3fs  (%s)" %
+                  (server_name, workload_name, median(seconds),
+                   ' '.join('%.3f' % s for s in seconds)))
+
+    baseline = {'samplerate': options.samplerate,
+                'runs': options.runs,
+                'results': results}
+    f = open(options.output, 'w')
+    json.dump(baseline, f, indent=2, sort_keys=True)
+    f.write('\n')
+    f.close()
+    print("wrote %s" % options.output)
+
+    if options.compare:
+        old = json.load(open(options.compare))
+        old_medians = dict(((r['server'], r['workload']), r['median'])
+                           for r in old['results'])
+        failed = False
+        for r in results:
+            key = (r['server'], r['workload'])
+            if key not in old_medians:
+                continue
+            ratio = r['median'] / old_medians[key]
+            if ratio > 1.0 + options.tolerance:
+                print("REGRESSION: %s %s is %.1f%% slower than baseline" %
+                      (key[0], key[1], 100.0 * (ratio - 1.0)))
+                failed = True
+        if failed:
+            sys.exit(1)
+        print("no regressions vs. %s" % options.compare)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python
+# Interpreter benchmark suite. Runs each bench_*.scd in the corpus with
+# sclang several times, collects the in-process timings the scripts print
+# as "SCLANG-BENCH <name> <seconds>" (so class library compilation stays
+# out of the numbers), and writes the medians as JSON. Run with
+# --compare <baseline.json> to fail when a workload got noticeably slower
+# than a previously recorded baseline. If sclang was built with
+# -DSC_VM_COUNTERS=ON, every run also rewrites the "bcstat" opcode/send
+# dump in the working directory.
+
+import glob
+import json
+import optparse
+import os
+import re
+import subprocess
+import sys
+
+RESULT_RE = re.compile(r'^SCLANG-BENCH (\S+) ([0-9.e+-]+)\s*$', re.MULTILINE)
+
+
+def run_once(sclang, config, script):
+    cmd = [sclang]
+    if config:
+        cmd += ['-l', config]
+    cmd.append(script)
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT)
+    output = proc.communicate()[0].decode('ascii', 'replace')
+    if proc.returncode != 0:
+        sys.stderr.write(output)
+        sys.exit("%s exited with %d" % (cmd[0], proc.returncode))
+    match = RESULT_RE.search(output)
+    if not match:
+        sys.stderr.write(output)
+        sys.exit("no SCLANG-BENCH line in the output of %s" % script)
+    return match.group(1), float(match.group(2))
+
+def median(values):
+    values = sorted(values)
+    mid = len(values) // 2
+    if len(values) % 2:
+        return values[mid]
+    return 0.5 * (values[mid - 1] + values[mid])
+
+def main():
+    parser = optparse.OptionParser()
+    parser.add_option('--sclang', help='path to the sclang binary')
+    parser.add_option('--config', help='library config passed as -l')
+    parser.add_option('--corpus', default=os.path.dirname(__file__) or '.',
+                      help='directory containing bench_*.scd')
+    parser.add_option('--output', default='sclang_bench_baseline.json',
+                      help='where to write the timing baseline')
+    parser.add_option('--compare', help='baseline JSON to compare against')
+    parser.add_option('--tolerance', type='float', default=0.1,
+                      help='allowed slowdown vs. baseline (default 10%)')
+    parser.add_option('--runs', type='int', default=5)
+    options, args = parser.parse_args()
+
+    if not options.sclang or not os.path.exists(options.sclang):
+        sys.exit("--sclang must point at the sclang binary")
+
+    scripts = sorted(glob.glob(os.path.join(options.corpus, 'bench_*.scd')))
+    if not scripts:
+        sys.exit("no bench_*.scd in %s" % options.corpus)
+
+    results = []
+    for script in scripts:
+        seconds = []
+        name = None
+        for run in range(options.runs):
+            name, elapsed = run_once(options.sclang, options.config, script)
+            seconds.append(elapsed)
+        results.append({'workload': name,
+                        'seconds': seconds,
+                        'median': median(seconds)})
+        print("%-13s median %.3fs  (%s)" %
+              (name, median(seconds),
+               ' '.join('%.3f' % s for s in seconds)))
+
+    baseline = {'runs': options.runs, 'results': results}
+    f = open(options.output, 'w')
+    json.dump(baseline, f, indent=2, sort_keys=True)
+    f.write('\n')
+    f.close()
+    print("wrote %s" % options.output)
+
+    if options.compare:
+        old = json.load(open(options.compare))
+        old_medians = dict((r['workload'], r['median'])
+                           for r in old['results'])
+        failed = False
+        for r in results:
+            if r['workload'] not in old_medians:
+                continue
+            ratio = r['median'] / old_medians[r['workload']]
+            if ratio > 1.0 + options.tolerance:
+                print("REGRESSION: %s is %.1f%% slower than baseline" %
+                      (r['workload'], 100.0 * (ratio - 1.0)))
+                failed = True
+        if failed:
+            sys.exit(1)
+        print("no regressions vs. %s" % options.compare)
+
+if __name__ == '__main__':
+    main()